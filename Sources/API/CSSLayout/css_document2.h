@@ -47,6 +47,9 @@ public:
 	CL_CSSPropertyList2 select(CL_CSSSelectNode2 *node, const CL_String &pseudo_element = CL_String());
 	static CL_CSSPropertyList2 get_style_properties(const CL_String &style_string, const CL_String &base_uri = CL_String());
 
+	/// \brief Enables the selector index (the default). When disabled, every selector chain is tried against each node.
+	void set_selector_index_enabled(bool enable);
+
 private:
 	CL_SharedPtr<CL_CSSDocument2_Impl> impl;
 };
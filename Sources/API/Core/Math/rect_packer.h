@@ -34,6 +34,7 @@
 #include "../api_core.h"
 #include "../System/sharedptr.h"
 #include "rect.h"
+#include <vector>
 
 class CL_Size;
 class CL_RectPacker_Impl;
@@ -54,6 +55,19 @@ public:
 		fail_if_full
 	};
 
+	/// \brief Packing algorithm used within a group.
+	enum PackingAlgorithm
+	{
+		/// \brief Splits the free space into a binary tree, placing rects in the first node they fit
+		guillotine,
+
+		/// \brief Keeps the top edge of the packed rects, placing rects where their bottom ends up highest. Fast, and good for rects of similar height such as glyphs.
+		skyline,
+
+		/// \brief Tracks every maximal free rectangle, placing rects where they leave the shortest leftover side. Slowest, but packs the tightest.
+		max_rects
+	};
+
 	struct AllocatedRect
 	{
 	public:
@@ -70,7 +84,7 @@ public:
 	CL_RectPacker();
 
 	/// \brief Constructs a rect group.
-	CL_RectPacker(const CL_Size &max_group_size, AllocationPolicy policy = create_new_group);
+	CL_RectPacker(const CL_Size &max_group_size, AllocationPolicy policy = create_new_group, PackingAlgorithm algorithm = guillotine);
 
 	~CL_RectPacker();
 
@@ -87,6 +101,9 @@ public:
 	/// \brief Returns the allocation policy.
 	AllocationPolicy get_allocation_policy() const;
 
+	/// \brief Returns the packing algorithm.
+	PackingAlgorithm get_packing_algorithm() const;
+
 	/// \brief Returns the max group size.
 	CL_Size get_max_group_size() const;
 
@@ -106,9 +123,38 @@ public:
 	/// \brief Set the allocation policy.
 	void set_allocation_policy(AllocationPolicy policy);
 
+	/// \brief Set the packing algorithm.
+	///
+	/// Groups keep the algorithm they were created with.
+	void set_packing_algorithm(PackingAlgorithm algorithm);
+
 	/// \brief Allocate space for another rect.
 	AllocatedRect add(const CL_Size &size);
 
+	/// \brief Allocate space for a batch of rects.
+	///
+	/// The rects are packed largest first, which packs tighter than adding them one by one in any order.
+	/// If a rect can not be allocated, the rects of the batch allocated so far are removed again and an exception is thrown.
+	/// \return Allocated rects, in the same order as sizes.
+	std::vector<AllocatedRect> add(const std::vector<CL_Size> &sizes);
+
+	/// \brief Adds a group covering an area, and makes it the group rects are added to first.
+	///
+	/// \param area = Free space the rects of the group are placed in. It may be larger than the max group size.
+	/// \return Index of the new group.
+	int add_group(const CL_Rect &area);
+
+	/// \brief Release the space of a rect, so it can be allocated again.
+	///
+	/// Removing rects fragments the free space. To reclaim it, clear the rect packer and add the remaining rects again as a batch.
+	void remove(const AllocatedRect &rect);
+
+	/// \brief Removes a group and its rects. The index of the following groups decreases by one.
+	void remove_group(unsigned int group_index);
+
+	/// \brief Removes all rects and groups.
+	void clear();
+
 /// \}
 /// \name Implementation
 /// \{
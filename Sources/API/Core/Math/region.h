@@ -0,0 +1,128 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+/// \addtogroup clanCore_Math clanCore Math
+/// \{
+
+#pragma once
+
+#include "../api_core.h"
+#include "rect.h"
+#include <vector>
+
+/// \brief Area described by a set of non-overlapping rectangles.
+///
+/// The rectangles are kept in y-x banded form: sorted top to bottom and then left to right,
+/// with all rectangles in a band sharing the same top and bottom. Vertically adjacent bands
+/// with identical spans are coalesced after every operation.
+/// \xmlonly !group=Core/Math! !header=core.h! \endxmlonly
+class CL_API_CORE CL_Region
+{
+/// \name Construction
+/// \{
+public:
+	/// \brief Constructs an empty region.
+	CL_Region();
+
+	/// \brief Constructs a region covering a rectangle.
+	CL_Region(const CL_Rect &rect);
+
+/// \}
+/// \name Attributes
+/// \{
+public:
+	/// \brief Returns true if the region covers no pixels.
+	bool is_empty() const { return rects.empty(); }
+
+	/// \brief Returns the banded rectangles making up the region.
+	const std::vector<CL_Rect> &get_rects() const { return rects; }
+
+	/// \brief Returns the smallest rectangle containing the region.
+	CL_Rect get_bounds() const;
+
+	/// \brief Returns the number of pixels covered by the region.
+	int get_area() const;
+
+	/// \brief Returns true if the point is inside the region.
+	bool contains(const CL_Point &point) const;
+
+	/// \brief Returns true if the rectangle overlaps the region.
+	bool is_overlapped(const CL_Rect &rect) const;
+
+	/// \brief Returns rectangles covering the region, merging neighbours where that is cheaper.
+	///
+	/// \param rect_cost = Fixed cost, measured in pixels, of processing one rectangle.
+	/// \return Rectangles covering the region. Merged rectangles may cover pixels outside the region.
+	std::vector<CL_Rect> get_merged_rects(int rect_cost) const;
+
+/// \}
+/// \name Operations
+/// \{
+public:
+	/// \brief Removes all rectangles from the region.
+	void clear() { rects.clear(); }
+
+	/// \brief Adds a rectangle to the region.
+	void unite(const CL_Rect &rect);
+
+	/// \brief Adds another region to this region.
+	void unite(const CL_Region &region);
+
+	/// \brief Removes a rectangle from the region.
+	void subtract(const CL_Rect &rect);
+
+	/// \brief Removes another region from this region.
+	void subtract(const CL_Region &region);
+
+	/// \brief Clips the region to a rectangle.
+	void intersect(const CL_Rect &rect);
+
+	/// \brief Clips the region to another region.
+	void intersect(const CL_Region &region);
+
+	/// \brief Moves the region.
+	void translate(const CL_Point &offset);
+
+/// \}
+/// \name Implementation
+/// \{
+private:
+	enum Operation
+	{
+		op_union,
+		op_subtract,
+		op_intersect
+	};
+
+	void combine(const std::vector<CL_Rect> &other, Operation op);
+
+	std::vector<CL_Rect> rects;
+/// \}
+};
+
+/// \}
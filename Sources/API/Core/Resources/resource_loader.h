@@ -0,0 +1,250 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+/// \addtogroup clanCore_Resources clanCore Resources
+/// \{
+
+#pragma once
+
+#include "../api_core.h"
+#include "../System/sharedptr.h"
+#include "../System/event.h"
+#include "../Text/string_types.h"
+#include "resource_manager.h"
+
+class CL_ResourceLoader_Impl;
+class CL_ResourceLoadHandle_Impl;
+
+/// \brief Resource loading task.
+///
+/// <p>A task is split in three stages. prepare() is called by CL_ResourceLoader::queue on
+///    the calling thread and is the only stage allowed to access the resource manager.
+///    load() is called on a worker thread and should do the file I/O and decoding.
+///    finish() is called from CL_ResourceLoader::process_completed, normally on the
+///    graphics thread, and should do the final object creation (such as a texture upload).</p>
+/// \xmlonly !group=Core/Resources! !header=core.h! \endxmlonly
+class CL_API_CORE CL_ResourceLoadTask
+{
+/// \name Construction
+/// \{
+
+public:
+	virtual ~CL_ResourceLoadTask() { }
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	/// \brief Reads the resource description. Called on the thread queueing the task.
+	virtual void prepare(CL_ResourceManager &resources) { }
+
+	/// \brief Loads and decodes the resource data. Called on a worker thread.
+	virtual void load() = 0;
+
+	/// \brief Creates the final resource object. Called by CL_ResourceLoader::process_completed.
+	virtual void finish() { }
+
+/// \}
+};
+
+/// \brief Handle to a task queued on a CL_ResourceLoader.
+///
+/// \xmlonly !group=Core/Resources! !header=core.h! \endxmlonly
+class CL_API_CORE CL_ResourceLoadHandle
+{
+/// \name Construction
+/// \{
+
+public:
+	/// \brief Constructs a null handle.
+	CL_ResourceLoadHandle();
+
+	~CL_ResourceLoadHandle();
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	enum Status
+	{
+		status_queued,
+		status_loading,
+		status_loaded,
+		status_finished,
+		status_cancelled,
+		status_failed
+	};
+
+	/// \brief Returns true if this handle is null.
+	bool is_null() const { return !impl; }
+
+	/// \brief Throw an exception if this handle is null.
+	void throw_if_null() const;
+
+	/// \brief Returns the current status of the task.
+	Status get_status() const;
+
+	/// \brief Returns true if the task is finished, cancelled or failed.
+	bool is_done() const;
+
+	/// \brief Returns the priority of the task. Higher priorities are loaded first.
+	int get_priority() const;
+
+	/// \brief Returns the error message if the task failed.
+	CL_String get_error_message() const;
+
+	/// \brief Returns the task object.
+	CL_SharedPtr<CL_ResourceLoadTask> get_task() const;
+
+	/// \brief Returns an event flagged when the task is finished, cancelled or failed.
+	CL_Event get_done_event() const;
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	bool operator ==(const CL_ResourceLoadHandle &other) const { return impl == other.impl; }
+
+	/// \brief Changes the priority of a task that has not started loading yet.
+	void set_priority(int priority);
+
+	/// \brief Cancels the task.
+	///
+	/// <p>A task still in the queue is removed from it. A task currently being loaded
+	///    runs to completion on its worker thread, but finish() is not called.</p>
+	void cancel();
+
+	/// \brief Waits until the task is finished, cancelled or failed.
+	///
+	/// <p>Note that finish() is only called by CL_ResourceLoader::process_completed,
+	///    so waiting from the thread calling process_completed will deadlock unless
+	///    the task is cancelled or fails.</p>
+	/// \return true if the task is done, false if the timeout elapsed.
+	bool wait(int timeout = -1);
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	CL_ResourceLoadHandle(const CL_SharedPtr<CL_ResourceLoadHandle_Impl> &impl);
+
+	CL_SharedPtr<CL_ResourceLoadHandle_Impl> impl;
+
+	friend class CL_ResourceLoader;
+/// \}
+};
+
+/// \brief Asynchronous, prioritized resource loader.
+///
+/// <p>The loader owns a pool of worker threads that runs the load() stage of queued tasks,
+///    highest priority first. Completed tasks are handed back to the application through
+///    process_completed, which should be called once per frame from the thread owning the
+///    graphic context.</p>
+/// <p>Worker threads open files through the virtual directories of the resource manager.
+///    Virtual file sources that are not thread safe should not be used with the loader.</p>
+/// \xmlonly !group=Core/Resources! !header=core.h! \endxmlonly
+class CL_API_CORE CL_ResourceLoader
+{
+/// \name Construction
+/// \{
+
+public:
+	/// \brief Constructs a null instance.
+	CL_ResourceLoader();
+
+	/// \brief Constructs a loader attached to a resource manager.
+	///
+	/// \param resources = Resource manager passed to CL_ResourceLoadTask::prepare.
+	/// \param num_workers = Number of worker threads. 0 uses one thread per core, less one for the main thread.
+	CL_ResourceLoader(const CL_ResourceManager &resources, int num_workers = 0);
+
+	~CL_ResourceLoader();
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	/// \brief Returns true if this object is invalid.
+	bool is_null() const { return !impl; }
+
+	/// \brief Throw an exception if this object is invalid.
+	void throw_if_null() const;
+
+	/// \brief Returns the resource manager the loader is attached to.
+	CL_ResourceManager get_resources() const;
+
+	/// \brief Returns the number of worker threads.
+	int get_num_workers() const;
+
+	/// \brief Returns the number of tasks queued or being loaded.
+	int get_pending_count() const;
+
+	/// \brief Returns the number of tasks waiting for process_completed.
+	int get_completed_count() const;
+
+	/// \brief Returns an event flagged while tasks are waiting for process_completed.
+	CL_Event get_completed_event() const;
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	/// \brief Queues a task.
+	///
+	/// <p>The prepare() stage of the task is run before this function returns.
+	///    Exceptions thrown by prepare() are passed on to the caller.</p>
+	/// \param task = Task to load.
+	/// \param priority = Load priority. Higher priorities are loaded first, equal priorities in queue order.
+	/// \return Handle to the queued task.
+	CL_ResourceLoadHandle queue(const CL_SharedPtr<CL_ResourceLoadTask> &task, int priority = 0);
+
+	/// \brief Runs the finish() stage of loaded tasks on the calling thread.
+	///
+	/// \param time_budget = Maximum time in milliseconds to spend, or -1 to process all loaded tasks.
+	/// \return Number of tasks finished.
+	int process_completed(int time_budget = -1);
+
+	/// \brief Cancels all tasks.
+	void cancel_all();
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	CL_SharedPtr<CL_ResourceLoader_Impl> impl;
+/// \}
+};
+
+/// \}
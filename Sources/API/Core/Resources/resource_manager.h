@@ -179,6 +179,32 @@ public:
 	/// \param directory = Virtual Directory
 	void load(CL_IODevice file, CL_VirtualDirectory directory = CL_VirtualDirectory());
 
+	/// \brief Save resources in the compiled binary format.
+	///
+	/// <p>A compiled resource file contains the resource document together with the
+	///    resource id table, so load_compiled can restore it without parsing any XML.</p>
+	void save_compiled(const CL_String &filename);
+
+	/// \brief Save resources in the compiled binary format.
+	///
+	/// \param file = IODevice
+	void save_compiled(CL_IODevice file);
+
+	/// \brief Load resources saved with save_compiled.
+	void load_compiled(const CL_String &filename);
+
+	/// \brief Load resources saved with save_compiled.
+	///
+	/// \param filename = the filename to load
+	/// \param directory = Virtual Directory
+	void load_compiled(const CL_String &filename, CL_VirtualDirectory directory);
+
+	/// \brief Load resources saved with save_compiled.
+	///
+	/// \param file = the file to load
+	/// \param directory = Virtual Directory
+	void load_compiled(CL_IODevice file, CL_VirtualDirectory directory = CL_VirtualDirectory());
+
 /// \}
 /// \name Implementation
 /// \{
@@ -192,6 +218,7 @@ private:
 	CL_SharedPtr<CL_ResourceManager_Impl> impl;
 
 	friend class CL_Resource;
+	friend class CL_ResourceManager_Impl;
 /// \}
 };
 
@@ -180,12 +180,18 @@ public:
 
 	void invoke(Param1 param1) const
 	{
-		std::vector< CL_SharedPtr<CL_SlotCallback> > callbacks = impl->connected_slots;
-		std::vector< CL_SharedPtr<CL_SlotCallback> >::size_type i, size;
-		size = callbacks.size();
-		for (i = 0; i < size; i++)
-			if (callbacks[i]->valid && callbacks[i]->enabled)
-				((CL_SlotCallback_v1<Param1> *) callbacks[i].get())->invoke(param1);
+		// Slots are called in place. A local reference keeps the slot list alive if a
+		// slot destroys the signal. Slots connected during the invoke are not called,
+		// and destroyed slots are only removed once no invoke is in progress.
+		CL_SharedPtr<CL_Signal_Impl> signal_impl(impl);
+		CL_SignalInvokeScope invoke_scope(signal_impl.get());
+		int size = signal_impl->connected_slots.size();
+		for (int i = 0; i < size; i++)
+		{
+			CL_SlotCallback *callback = signal_impl->connected_slots.get(i);
+			if (callback->valid && callback->enabled)
+				((CL_SlotCallback_v1<Param1> *) callback)->invoke(param1);
+		}
 	}
 
 
@@ -196,17 +202,8 @@ public:
 private:
 	void clean_up()
 	{
-		std::vector< CL_SharedPtr<CL_SlotCallback> >::size_type i, size;
-		size = impl->connected_slots.size();
-		for (i = 0; i < size; i++)
-		{
-			if (!impl->connected_slots[i]->valid)
-			{
-				impl->connected_slots.erase(impl->connected_slots.begin()+i);
-				i--;
-				size--;
-			}
-		}
+		if (impl->invoke_depth.get() == 0)
+			impl->connected_slots.remove_invalid();
 	}
 
 	CL_SharedPtr<CL_Signal_Impl> impl;
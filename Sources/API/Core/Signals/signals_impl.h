@@ -31,6 +31,7 @@
 
 #include "../api_core.h"
 #include "../System/sharedptr.h"
+#include "../System/interlocked_variable.h"
 #include <vector>
 
 /// (Internal ClanLib Class)
@@ -59,8 +60,88 @@ public:
 
 /// (Internal ClanLib Class)
 /// \xmlonly !group=Core/Signals! !header=core.h! !hide! \endxmlonly
+class CL_API_CORE CL_SlotCallbackList
+{
+public:
+	CL_SlotCallbackList() : count(0) { return; }
+
+	int size() const { return count; }
+
+	CL_SlotCallback *get(int index) const
+	{
+		return index < inline_size ? inline_slots[index].get() : overflow_slots[index - inline_size].get();
+	}
+
+	void push_back(const CL_SharedPtr<CL_SlotCallback> &callback)
+	{
+		if (count < inline_size)
+			inline_slots[count] = callback;
+		else
+			overflow_slots.push_back(callback);
+		count++;
+	}
+
+	void remove_invalid()
+	{
+		int new_count = 0;
+		for (int i = 0; i < count; i++)
+		{
+			if (at(i)->valid)
+			{
+				if (new_count != i)
+					at(new_count) = at(i);
+				new_count++;
+			}
+		}
+		for (int i = new_count; i < count && i < inline_size; i++)
+			inline_slots[i].reset();
+		overflow_slots.resize(new_count > inline_size ? new_count - inline_size : 0);
+		count = new_count;
+	}
+
+private:
+	enum { inline_size = 2 };
+
+	CL_SharedPtr<CL_SlotCallback> &at(int index)
+	{
+		return index < inline_size ? inline_slots[index] : overflow_slots[index - inline_size];
+	}
+
+	CL_SharedPtr<CL_SlotCallback> inline_slots[inline_size];
+	std::vector< CL_SharedPtr<CL_SlotCallback> > overflow_slots;
+	int count;
+};
+
+/// (Internal ClanLib Class)
+/// \xmlonly !group=Core/Signals! !header=core.h! !hide! \endxmlonly
+///
+/// A signal may be invoked from several threads at once. The slot list itself is not locked,
+/// so connecting slots must not happen while another thread invokes the signal.
 class CL_API_CORE CL_Signal_Impl
 {
+public:
+	CL_SlotCallbackList connected_slots;
+
+	/// \brief Number of invokes in progress. Invalid slots are only removed when it is zero.
+	CL_InterlockedVariable invoke_depth;
+};
+
+/// (Internal ClanLib Class)
+/// \xmlonly !group=Core/Signals! !header=core.h! !hide! \endxmlonly
+class CL_SignalInvokeScope
+{
+public:
+	CL_SignalInvokeScope(CL_Signal_Impl *impl) : impl(impl) { impl->invoke_depth.increment(); }
+	~CL_SignalInvokeScope() { impl->invoke_depth.decrement(); }
+
+private:
+	CL_Signal_Impl *impl;
+};
+
+/// (Internal ClanLib Class)
+/// \xmlonly !group=Core/Signals! !header=core.h! !hide! \endxmlonly
+class CL_API_CORE CL_VirtualFunction_Impl
+{
 public:
 	std::vector< CL_SharedPtr<CL_SlotCallback> > connected_slots;
 };
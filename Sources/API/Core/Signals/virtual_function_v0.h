@@ -167,7 +167,7 @@ class CL_API_CORE CL_VirtualFunction_v0
 
 public:
 	CL_VirtualFunction_v0()
-	: impl(new CL_Signal_Impl) { return; }
+	: impl(new CL_VirtualFunction_Impl) { return; }
 
 	CL_VirtualFunction_v0(const CL_VirtualFunction_v0 &copy)
 	: impl(copy.impl) { return; }
@@ -257,7 +257,7 @@ private:
 		}
 	}
 
-	CL_SharedPtr<CL_Signal_Impl> impl;
+	CL_SharedPtr<CL_VirtualFunction_Impl> impl;
 /// \}
 };
 
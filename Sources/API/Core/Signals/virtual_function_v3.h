@@ -170,7 +170,7 @@ class CL_VirtualFunction_v3
 
 public:
 	CL_VirtualFunction_v3()
-	: impl(new CL_Signal_Impl) { return; }
+	: impl(new CL_VirtualFunction_Impl) { return; }
 
 	CL_VirtualFunction_v3(const CL_VirtualFunction_v3<Param1, Param2, Param3> &copy)
 	: impl(copy.impl) { return; }
@@ -260,7 +260,7 @@ private:
 		}
 	}
 
-	CL_SharedPtr<CL_Signal_Impl> impl;
+	CL_SharedPtr<CL_VirtualFunction_Impl> impl;
 /// \}
 };
 
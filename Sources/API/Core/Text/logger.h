@@ -89,31 +89,31 @@ private:
 CL_API_CORE void cl_log_event(const CL_StringRef &type, const CL_StringRef &text);
 
 template <class Arg1>
-void cl_log_event(const CL_StringRef &type, const CL_StringRef &format, Arg1 arg1)
-{ CL_StringFormat f(format); f.set_arg(1, arg1); cl_log_event(type, f.get_result()); }
+void cl_log_event(const CL_StringRef &type, const CL_StringRef &format, const Arg1 &arg1)
+{ CL_StringFormatBuffer buffer; cl_format_to(buffer, format, arg1); cl_log_event(type, buffer.get_text()); }
 
 template <class Arg1, class Arg2>
-void cl_log_event(const CL_StringRef &type, const CL_StringRef &format, Arg1 arg1, Arg2 arg2)
-{ CL_StringFormat f(format); f.set_arg(1, arg1); f.set_arg(2, arg2); cl_log_event(type, f.get_result()); }
+void cl_log_event(const CL_StringRef &type, const CL_StringRef &format, const Arg1 &arg1, const Arg2 &arg2)
+{ CL_StringFormatBuffer buffer; cl_format_to(buffer, format, arg1, arg2); cl_log_event(type, buffer.get_text()); }
 
 template <class Arg1, class Arg2, class Arg3>
-void cl_log_event(const CL_StringRef &type, const CL_StringRef &format, Arg1 arg1, Arg2 arg2, Arg3 arg3)
-{ CL_StringFormat f(format); f.set_arg(1, arg1); f.set_arg(2, arg2); f.set_arg(3, arg3); cl_log_event(type, f.get_result()); }
+void cl_log_event(const CL_StringRef &type, const CL_StringRef &format, const Arg1 &arg1, const Arg2 &arg2, const Arg3 &arg3)
+{ CL_StringFormatBuffer buffer; cl_format_to(buffer, format, arg1, arg2, arg3); cl_log_event(type, buffer.get_text()); }
 
 template <class Arg1, class Arg2, class Arg3, class Arg4>
-void cl_log_event(const CL_StringRef &type, const CL_StringRef &format, Arg1 arg1, Arg2 arg2, Arg3 arg3, Arg4 arg4)
-{ CL_StringFormat f(format); f.set_arg(1, arg1); f.set_arg(2, arg2); f.set_arg(3, arg3); f.set_arg(4, arg4); cl_log_event(type, f.get_result()); }
+void cl_log_event(const CL_StringRef &type, const CL_StringRef &format, const Arg1 &arg1, const Arg2 &arg2, const Arg3 &arg3, const Arg4 &arg4)
+{ CL_StringFormatBuffer buffer; cl_format_to(buffer, format, arg1, arg2, arg3, arg4); cl_log_event(type, buffer.get_text()); }
 
 template <class Arg1, class Arg2, class Arg3, class Arg4, class Arg5>
-void cl_log_event(const CL_StringRef &type, const CL_StringRef &format, Arg1 arg1, Arg2 arg2, Arg3 arg3, Arg4 arg4, Arg5 arg5)
-{ CL_StringFormat f(format); f.set_arg(1, arg1); f.set_arg(2, arg2); f.set_arg(3, arg3); f.set_arg(4, arg4); f.set_arg(5, arg5); cl_log_event(type, f.get_result()); }
+void cl_log_event(const CL_StringRef &type, const CL_StringRef &format, const Arg1 &arg1, const Arg2 &arg2, const Arg3 &arg3, const Arg4 &arg4, const Arg5 &arg5)
+{ CL_StringFormatBuffer buffer; cl_format_to(buffer, format, arg1, arg2, arg3, arg4, arg5); cl_log_event(type, buffer.get_text()); }
 
 template <class Arg1, class Arg2, class Arg3, class Arg4, class Arg5, class Arg6>
-void cl_log_event(const CL_StringRef &type, const CL_StringRef &format, Arg1 arg1, Arg2 arg2, Arg3 arg3, Arg4 arg4, Arg5 arg5, Arg6 arg6)
-{ CL_StringFormat f(format); f.set_arg(1, arg1); f.set_arg(2, arg2); f.set_arg(3, arg3); f.set_arg(4, arg4); f.set_arg(5, arg5); f.set_arg(6, arg6); cl_log_event(type, f.get_result()); }
+void cl_log_event(const CL_StringRef &type, const CL_StringRef &format, const Arg1 &arg1, const Arg2 &arg2, const Arg3 &arg3, const Arg4 &arg4, const Arg5 &arg5, const Arg6 &arg6)
+{ CL_StringFormatBuffer buffer; cl_format_to(buffer, format, arg1, arg2, arg3, arg4, arg5, arg6); cl_log_event(type, buffer.get_text()); }
 
 template <class Arg1, class Arg2, class Arg3, class Arg4, class Arg5, class Arg6, class Arg7>
-void cl_log_event(const CL_StringRef &type, const CL_StringRef &format, Arg1 arg1, Arg2 arg2, Arg3 arg3, Arg4 arg4, Arg5 arg5, Arg6 arg6, Arg7 arg7)
-{ CL_StringFormat f(format); f.set_arg(1, arg1); f.set_arg(2, arg2); f.set_arg(3, arg3); f.set_arg(4, arg4); f.set_arg(5, arg5); f.set_arg(6, arg6); f.set_arg(7, arg7); cl_log_event(type, f.get_result()); }
+void cl_log_event(const CL_StringRef &type, const CL_StringRef &format, const Arg1 &arg1, const Arg2 &arg2, const Arg3 &arg3, const Arg4 &arg4, const Arg5 &arg5, const Arg6 &arg6, const Arg7 &arg7)
+{ CL_StringFormatBuffer buffer; cl_format_to(buffer, format, arg1, arg2, arg3, arg4, arg5, arg6, arg7); cl_log_event(type, buffer.get_text()); }
 
 /// \}
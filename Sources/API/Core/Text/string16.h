@@ -54,6 +54,13 @@ public:
 	/// \param source = String Container
 	CL_String16(const CL_String16 &source);
 
+#ifdef CL_HAS_RVALUE_REFERENCES
+	/// \brief Constructs a StringContainer, taking over the heap buffer of source
+	///
+	/// \param source = String Container. Left empty.
+	CL_String16(CL_String16 &&source) throw();
+#endif
+
 	/// \brief Constructs a StringContainer
 	CL_String16(const CL_StringData16 &source);
 
@@ -428,6 +435,9 @@ public:
 	size_type copy(wchar_t *buf, size_type n, size_type pos = 0) const;
 
 	CL_String16 &operator =(const CL_String16 &source);
+#ifdef CL_HAS_RVALUE_REFERENCES
+	CL_String16 &operator =(CL_String16 &&source) throw();
+#endif
 	CL_String16 &operator =(const CL_StringData16 &source);
 	CL_String16 &operator =(const char *c_str);
 	CL_String16 &operator =(const wchar_t *c_str);
@@ -440,6 +450,9 @@ private:
 	/// \brief Init
 	void init();
 
+	/// \brief Takes over the data of source and leaves it empty. Must only be called on an empty string.
+	void take(CL_String16 &source);
+
 	size_type data_capacity;
 	enum { local_string_length = 63 };
 	wchar_t local_string[local_string_length + 1];
@@ -453,4 +466,10 @@ CL_API_CORE CL_String16 operator+(const CL_StringData16 &s1, const wchar_t *s2);
 CL_API_CORE CL_String16 operator+(wchar_t c, const CL_StringData16 &s2);
 CL_API_CORE CL_String16 operator+(const CL_StringData16 &s1, wchar_t c);
 
+#ifdef CL_HAS_RVALUE_REFERENCES
+CL_API_CORE CL_String16 operator+(CL_String16 &&s1, const CL_StringData16 &s2);
+CL_API_CORE CL_String16 operator+(CL_String16 &&s1, const wchar_t *s2);
+CL_API_CORE CL_String16 operator+(CL_String16 &&s1, wchar_t c);
+#endif
+
 /// \}
@@ -54,6 +54,13 @@ public:
 	/// \param source = String Container
 	CL_String8(const CL_String8 &source);
 
+#ifdef CL_HAS_RVALUE_REFERENCES
+	/// \brief Constructs a StringContainer, taking over the heap buffer of source
+	///
+	/// \param source = String Container. Left empty.
+	CL_String8(CL_String8 &&source) throw();
+#endif
+
 	/// \brief Constructs a StringContainer
 	CL_String8(const CL_StringData8 &source);
 
@@ -428,6 +435,9 @@ public:
 	size_type copy(char *buf, size_type n, size_type pos = 0) const;
 
 	CL_String8 &operator =(const CL_String8 &source);
+#ifdef CL_HAS_RVALUE_REFERENCES
+	CL_String8 &operator =(CL_String8 &&source) throw();
+#endif
 	CL_String8 &operator =(const CL_StringData8 &source);
 	CL_String8 &operator =(const char *c_str);
 	CL_String8 &operator =(const wchar_t *c_str);
@@ -440,6 +450,9 @@ private:
 	/// \brief Init
 	void init();
 
+	/// \brief Takes over the data of source and leaves it empty. Must only be called on an empty string.
+	void take(CL_String8 &source);
+
 	size_type data_capacity;
 	enum { local_string_length = 63 };
 	char local_string[local_string_length + 1];
@@ -453,4 +466,10 @@ CL_API_CORE CL_String8 operator+(const CL_StringData8 &s1, const wchar_t *s2);
 CL_API_CORE CL_String8 operator+(char c, const CL_StringData8 &s2);
 CL_API_CORE CL_String8 operator+(const CL_StringData8 &s1, char c);
 
+#ifdef CL_HAS_RVALUE_REFERENCES
+CL_API_CORE CL_String8 operator+(CL_String8 &&s1, const CL_StringData8 &s2);
+CL_API_CORE CL_String8 operator+(CL_String8 &&s1, const char *s2);
+CL_API_CORE CL_String8 operator+(CL_String8 &&s1, char c);
+#endif
+
 /// \}
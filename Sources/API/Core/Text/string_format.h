@@ -34,9 +34,11 @@
 #include "../api_core.h"
 #include <vector>
 #include "string_types.h"
+#include "string_format_buffer.h"
 
 /// \brief String formatting class.
 ///
+/// Every occurrence of an argument, such as both %1 in "%1 and %1", is replaced, the same way cl_format does it.
 /// \xmlonly !group=Core/Text! !header=core.h! \endxmlonly
 class CL_API_CORE CL_StringFormat
 {
@@ -135,8 +137,8 @@ private:
 
 	struct ArgPosition
 	{
-		ArgPosition() : start(0), length(-1) { }
-		ArgPosition(int s, int l) : start(s), length(l) {}
+		ArgPosition(int i, int s, int l) : index(i), start(s), length(l) {}
+		int index;
 		int start;
 		int length;
 	};
@@ -149,31 +151,31 @@ inline CL_String cl_format(const CL_StringRef &format)
 { return format; }
 
 template <class Arg1>
-CL_String cl_format(const CL_StringRef &format, Arg1 arg1)
-{ CL_StringFormat f(format); f.set_arg(1, arg1); return f.get_result(); }
+CL_String cl_format(const CL_StringRef &format, const Arg1 &arg1)
+{ CL_StringFormatBuffer buffer; cl_format_to(buffer, format, arg1); return buffer.get_text(); }
 
 template <class Arg1, class Arg2>
-CL_String cl_format(const CL_StringRef &format, Arg1 arg1, Arg2 arg2)
-{ CL_StringFormat f(format); f.set_arg(1, arg1); f.set_arg(2, arg2); return f.get_result(); }
+CL_String cl_format(const CL_StringRef &format, const Arg1 &arg1, const Arg2 &arg2)
+{ CL_StringFormatBuffer buffer; cl_format_to(buffer, format, arg1, arg2); return buffer.get_text(); }
 
 template <class Arg1, class Arg2, class Arg3>
-CL_String cl_format(const CL_StringRef &format, Arg1 arg1, Arg2 arg2, Arg3 arg3)
-{ CL_StringFormat f(format); f.set_arg(1, arg1); f.set_arg(2, arg2); f.set_arg(3, arg3); return f.get_result(); }
+CL_String cl_format(const CL_StringRef &format, const Arg1 &arg1, const Arg2 &arg2, const Arg3 &arg3)
+{ CL_StringFormatBuffer buffer; cl_format_to(buffer, format, arg1, arg2, arg3); return buffer.get_text(); }
 
 template <class Arg1, class Arg2, class Arg3, class Arg4>
-CL_String cl_format(const CL_StringRef &format, Arg1 arg1, Arg2 arg2, Arg3 arg3, Arg4 arg4)
-{ CL_StringFormat f(format); f.set_arg(1, arg1); f.set_arg(2, arg2); f.set_arg(3, arg3); f.set_arg(4, arg4); return f.get_result(); }
+CL_String cl_format(const CL_StringRef &format, const Arg1 &arg1, const Arg2 &arg2, const Arg3 &arg3, const Arg4 &arg4)
+{ CL_StringFormatBuffer buffer; cl_format_to(buffer, format, arg1, arg2, arg3, arg4); return buffer.get_text(); }
 
 template <class Arg1, class Arg2, class Arg3, class Arg4, class Arg5>
-CL_String cl_format(const CL_StringRef &format, Arg1 arg1, Arg2 arg2, Arg3 arg3, Arg4 arg4, Arg5 arg5)
-{ CL_StringFormat f(format); f.set_arg(1, arg1); f.set_arg(2, arg2); f.set_arg(3, arg3); f.set_arg(4, arg4); f.set_arg(5, arg5); return f.get_result(); }
+CL_String cl_format(const CL_StringRef &format, const Arg1 &arg1, const Arg2 &arg2, const Arg3 &arg3, const Arg4 &arg4, const Arg5 &arg5)
+{ CL_StringFormatBuffer buffer; cl_format_to(buffer, format, arg1, arg2, arg3, arg4, arg5); return buffer.get_text(); }
 
 template <class Arg1, class Arg2, class Arg3, class Arg4, class Arg5, class Arg6>
-CL_String cl_format(const CL_StringRef &format, Arg1 arg1, Arg2 arg2, Arg3 arg3, Arg4 arg4, Arg5 arg5, Arg6 arg6)
-{ CL_StringFormat f(format); f.set_arg(1, arg1); f.set_arg(2, arg2); f.set_arg(3, arg3); f.set_arg(4, arg4); f.set_arg(5, arg5); f.set_arg(6, arg6); return f.get_result(); }
+CL_String cl_format(const CL_StringRef &format, const Arg1 &arg1, const Arg2 &arg2, const Arg3 &arg3, const Arg4 &arg4, const Arg5 &arg5, const Arg6 &arg6)
+{ CL_StringFormatBuffer buffer; cl_format_to(buffer, format, arg1, arg2, arg3, arg4, arg5, arg6); return buffer.get_text(); }
 
 template <class Arg1, class Arg2, class Arg3, class Arg4, class Arg5, class Arg6, class Arg7>
-CL_String cl_format(const CL_StringRef &format, Arg1 arg1, Arg2 arg2, Arg3 arg3, Arg4 arg4, Arg5 arg5, Arg6 arg6, Arg7 arg7)
-{ CL_StringFormat f(format); f.set_arg(1, arg1); f.set_arg(2, arg2); f.set_arg(3, arg3); f.set_arg(4, arg4); f.set_arg(5, arg5); f.set_arg(6, arg6); f.set_arg(7, arg7); return f.get_result(); }
+CL_String cl_format(const CL_StringRef &format, const Arg1 &arg1, const Arg2 &arg2, const Arg3 &arg3, const Arg4 &arg4, const Arg5 &arg5, const Arg6 &arg6, const Arg7 &arg7)
+{ CL_StringFormatBuffer buffer; cl_format_to(buffer, format, arg1, arg2, arg3, arg4, arg5, arg6, arg7); return buffer.get_text(); }
 
 /// \}
@@ -0,0 +1,283 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+/// \addtogroup clanCore_Text clanCore Text
+/// \{
+
+#pragma once
+
+#include "../api_core.h"
+#include <vector>
+#include "string_types.h"
+
+class CL_StringFormatPattern;
+
+/// \brief Buffer that formatted text is written into without intermediate strings.
+///
+/// Text is written either to storage inside the object, which only moves to the heap
+/// when the result outgrows it, or to memory provided by the caller.
+/// \xmlonly !group=Core/Text! !header=core.h! \endxmlonly
+class CL_API_CORE CL_StringFormatBuffer
+{
+/// \name Construction
+/// \{
+
+public:
+	/// \brief Constructs a format buffer using its own storage
+	CL_StringFormatBuffer();
+
+	/// \brief Constructs a format buffer writing into caller-provided memory
+	///
+	/// Text that does not fit is truncated and is_truncated() returns true.
+	/// \param buffer = Destination memory
+	/// \param buffer_size = Size of the memory in bytes, including the null terminator
+	CL_StringFormatBuffer(char *buffer, int buffer_size);
+
+	~CL_StringFormatBuffer();
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	/// \brief Returns the null terminated text written so far
+	const char *c_str() const { return data; }
+
+	/// \brief Returns the length of the text written so far
+	int length() const { return data_length; }
+
+	/// \brief Returns true if text was dropped because the caller-provided memory was full
+	bool is_truncated() const { return truncated; }
+
+	/// \brief Returns a reference to the text written so far
+	///
+	/// The reference is valid until the buffer is modified or destroyed.
+	CL_StringRef get_text() const;
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	/// \brief Removes all text from the buffer
+	void clear();
+
+	/// \brief Append text
+	///
+	/// \param text = Characters to append
+	/// \param length = Number of characters
+	void append_text(const char *text, int length);
+
+	/// \brief Append a single character
+	void append_char(char c);
+
+	/// \brief Append text
+	void append(const CL_StringRef &text);
+
+	/// \brief Append a number in decimal notation
+	///
+	/// \param value = value
+	/// \param min_length = Minimum number of digits, padded with zeros
+	void append(int value, int min_length = 0);
+
+	/// \brief Append a number in decimal notation
+	///
+	/// \param value = value
+	/// \param min_length = Minimum number of digits, padded with zeros
+	void append(unsigned int value, int min_length = 0);
+
+	/// \brief Append a number in decimal notation
+	///
+	/// \param value = value
+	/// \param min_length = Minimum number of digits, padded with zeros
+	void append(long unsigned int value, int min_length = 0);
+
+	/// \brief Append a number in decimal notation
+	///
+	/// \param value = value
+	/// \param min_length = Minimum number of digits, padded with zeros
+	void append(long long value, int min_length = 0);
+
+	/// \brief Append a number in decimal notation
+	///
+	/// \param value = value
+	/// \param min_length = Minimum number of digits, padded with zeros
+	void append(unsigned long long value, int min_length = 0);
+
+	/// \brief Append a number with a fixed number of decimals
+	///
+	/// \param value = value
+	/// \param num_decimals = Digits written after the decimal point
+	void append(float value, int num_decimals = 6);
+
+	/// \brief Append a number with a fixed number of decimals
+	///
+	/// \param value = value
+	/// \param num_decimals = Digits written after the decimal point
+	void append(double value, int num_decimals = 6);
+
+	/// \brief Append format text up to the next argument
+	///
+	/// Arguments outside the range 1 to num_args are written as they appear in the format.
+	/// \param format = Format string using %1, %2 and so on for arguments and %% for a percent sign
+	/// \param position = Position in the format string, updated past the returned argument
+	/// \param num_args = Number of arguments available
+	/// \return Index of the argument to write next, or 0 when the end of the format has been reached
+	int append_format(const CL_StringRef &format, int &position, int num_args);
+
+	/// \brief Append format text up to the next argument
+	///
+	/// \param pattern = Parsed format string
+	/// \param position = Segment position in the pattern, updated past the returned argument
+	/// \param num_args = Number of arguments available
+	/// \return Index of the argument to write next, or 0 when the end of the pattern has been reached
+	int append_format(const CL_StringFormatPattern &pattern, int &position, int num_args);
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	CL_StringFormatBuffer(const CL_StringFormatBuffer &);
+	CL_StringFormatBuffer &operator =(const CL_StringFormatBuffer &);
+
+	int reserve(int length);
+	void append_digits(const char *digits, int num_digits, bool negative, int min_length);
+
+	enum { local_buffer_length = 255 };
+
+	char *data;
+	int data_length;
+	int data_capacity;
+	bool fixed_size;
+	bool truncated;
+	char local_buffer[local_buffer_length + 1];
+/// \}
+};
+
+/// \brief Format string parsed once for repeated use.
+///
+/// Constant format strings used on hot paths can be parsed into a pattern at startup,
+/// which removes the scanning from each cl_format_to call.
+/// \xmlonly !group=Core/Text! !header=core.h! \endxmlonly
+class CL_API_CORE CL_StringFormatPattern
+{
+/// \name Construction
+/// \{
+
+public:
+	/// \brief Constructs a format pattern
+	///
+	/// \param format = Format string using %1, %2 and so on for arguments and %% for a percent sign
+	explicit CL_StringFormatPattern(const CL_StringRef &format);
+
+	~CL_StringFormatPattern();
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	struct Segment
+	{
+		Segment(int s, int l, int a) : start(s), length(l), arg_index(a) { }
+		int start;
+		int length;
+		int arg_index;
+	};
+
+	CL_String text;
+	std::vector<Segment> segments;
+
+	friend class CL_StringFormatBuffer;
+/// \}
+};
+
+inline void cl_format_to(CL_StringFormatBuffer &buffer, const CL_StringRef &format)
+{ int pos = 0; buffer.append_format(format, pos, 0); }
+
+inline void cl_format_to(CL_StringFormatBuffer &buffer, const CL_StringFormatPattern &format)
+{ int pos = 0; buffer.append_format(format, pos, 0); }
+
+template <class Arg1>
+void cl_format_to(CL_StringFormatBuffer &buffer, const CL_StringRef &format, const Arg1 &arg1)
+{ int pos = 0; for (int arg = buffer.append_format(format, pos, 1); arg != 0; arg = buffer.append_format(format, pos, 1)) buffer.append(arg1); }
+
+template <class Arg1, class Arg2>
+void cl_format_to(CL_StringFormatBuffer &buffer, const CL_StringRef &format, const Arg1 &arg1, const Arg2 &arg2)
+{ int pos = 0; for (int arg = buffer.append_format(format, pos, 2); arg != 0; arg = buffer.append_format(format, pos, 2)) switch (arg) { case 1: buffer.append(arg1); break; default: buffer.append(arg2); break; } }
+
+template <class Arg1, class Arg2, class Arg3>
+void cl_format_to(CL_StringFormatBuffer &buffer, const CL_StringRef &format, const Arg1 &arg1, const Arg2 &arg2, const Arg3 &arg3)
+{ int pos = 0; for (int arg = buffer.append_format(format, pos, 3); arg != 0; arg = buffer.append_format(format, pos, 3)) switch (arg) { case 1: buffer.append(arg1); break; case 2: buffer.append(arg2); break; default: buffer.append(arg3); break; } }
+
+template <class Arg1, class Arg2, class Arg3, class Arg4>
+void cl_format_to(CL_StringFormatBuffer &buffer, const CL_StringRef &format, const Arg1 &arg1, const Arg2 &arg2, const Arg3 &arg3, const Arg4 &arg4)
+{ int pos = 0; for (int arg = buffer.append_format(format, pos, 4); arg != 0; arg = buffer.append_format(format, pos, 4)) switch (arg) { case 1: buffer.append(arg1); break; case 2: buffer.append(arg2); break; case 3: buffer.append(arg3); break; default: buffer.append(arg4); break; } }
+
+template <class Arg1, class Arg2, class Arg3, class Arg4, class Arg5>
+void cl_format_to(CL_StringFormatBuffer &buffer, const CL_StringRef &format, const Arg1 &arg1, const Arg2 &arg2, const Arg3 &arg3, const Arg4 &arg4, const Arg5 &arg5)
+{ int pos = 0; for (int arg = buffer.append_format(format, pos, 5); arg != 0; arg = buffer.append_format(format, pos, 5)) switch (arg) { case 1: buffer.append(arg1); break; case 2: buffer.append(arg2); break; case 3: buffer.append(arg3); break; case 4: buffer.append(arg4); break; default: buffer.append(arg5); break; } }
+
+template <class Arg1, class Arg2, class Arg3, class Arg4, class Arg5, class Arg6>
+void cl_format_to(CL_StringFormatBuffer &buffer, const CL_StringRef &format, const Arg1 &arg1, const Arg2 &arg2, const Arg3 &arg3, const Arg4 &arg4, const Arg5 &arg5, const Arg6 &arg6)
+{ int pos = 0; for (int arg = buffer.append_format(format, pos, 6); arg != 0; arg = buffer.append_format(format, pos, 6)) switch (arg) { case 1: buffer.append(arg1); break; case 2: buffer.append(arg2); break; case 3: buffer.append(arg3); break; case 4: buffer.append(arg4); break; case 5: buffer.append(arg5); break; default: buffer.append(arg6); break; } }
+
+template <class Arg1, class Arg2, class Arg3, class Arg4, class Arg5, class Arg6, class Arg7>
+void cl_format_to(CL_StringFormatBuffer &buffer, const CL_StringRef &format, const Arg1 &arg1, const Arg2 &arg2, const Arg3 &arg3, const Arg4 &arg4, const Arg5 &arg5, const Arg6 &arg6, const Arg7 &arg7)
+{ int pos = 0; for (int arg = buffer.append_format(format, pos, 7); arg != 0; arg = buffer.append_format(format, pos, 7)) switch (arg) { case 1: buffer.append(arg1); break; case 2: buffer.append(arg2); break; case 3: buffer.append(arg3); break; case 4: buffer.append(arg4); break; case 5: buffer.append(arg5); break; case 6: buffer.append(arg6); break; default: buffer.append(arg7); break; } }
+
+template <class Arg1>
+void cl_format_to(CL_StringFormatBuffer &buffer, const CL_StringFormatPattern &format, const Arg1 &arg1)
+{ int pos = 0; for (int arg = buffer.append_format(format, pos, 1); arg != 0; arg = buffer.append_format(format, pos, 1)) buffer.append(arg1); }
+
+template <class Arg1, class Arg2>
+void cl_format_to(CL_StringFormatBuffer &buffer, const CL_StringFormatPattern &format, const Arg1 &arg1, const Arg2 &arg2)
+{ int pos = 0; for (int arg = buffer.append_format(format, pos, 2); arg != 0; arg = buffer.append_format(format, pos, 2)) switch (arg) { case 1: buffer.append(arg1); break; default: buffer.append(arg2); break; } }
+
+template <class Arg1, class Arg2, class Arg3>
+void cl_format_to(CL_StringFormatBuffer &buffer, const CL_StringFormatPattern &format, const Arg1 &arg1, const Arg2 &arg2, const Arg3 &arg3)
+{ int pos = 0; for (int arg = buffer.append_format(format, pos, 3); arg != 0; arg = buffer.append_format(format, pos, 3)) switch (arg) { case 1: buffer.append(arg1); break; case 2: buffer.append(arg2); break; default: buffer.append(arg3); break; } }
+
+template <class Arg1, class Arg2, class Arg3, class Arg4>
+void cl_format_to(CL_StringFormatBuffer &buffer, const CL_StringFormatPattern &format, const Arg1 &arg1, const Arg2 &arg2, const Arg3 &arg3, const Arg4 &arg4)
+{ int pos = 0; for (int arg = buffer.append_format(format, pos, 4); arg != 0; arg = buffer.append_format(format, pos, 4)) switch (arg) { case 1: buffer.append(arg1); break; case 2: buffer.append(arg2); break; case 3: buffer.append(arg3); break; default: buffer.append(arg4); break; } }
+
+template <class Arg1, class Arg2, class Arg3, class Arg4, class Arg5>
+void cl_format_to(CL_StringFormatBuffer &buffer, const CL_StringFormatPattern &format, const Arg1 &arg1, const Arg2 &arg2, const Arg3 &arg3, const Arg4 &arg4, const Arg5 &arg5)
+{ int pos = 0; for (int arg = buffer.append_format(format, pos, 5); arg != 0; arg = buffer.append_format(format, pos, 5)) switch (arg) { case 1: buffer.append(arg1); break; case 2: buffer.append(arg2); break; case 3: buffer.append(arg3); break; case 4: buffer.append(arg4); break; default: buffer.append(arg5); break; } }
+
+template <class Arg1, class Arg2, class Arg3, class Arg4, class Arg5, class Arg6>
+void cl_format_to(CL_StringFormatBuffer &buffer, const CL_StringFormatPattern &format, const Arg1 &arg1, const Arg2 &arg2, const Arg3 &arg3, const Arg4 &arg4, const Arg5 &arg5, const Arg6 &arg6)
+{ int pos = 0; for (int arg = buffer.append_format(format, pos, 6); arg != 0; arg = buffer.append_format(format, pos, 6)) switch (arg) { case 1: buffer.append(arg1); break; case 2: buffer.append(arg2); break; case 3: buffer.append(arg3); break; case 4: buffer.append(arg4); break; case 5: buffer.append(arg5); break; default: buffer.append(arg6); break; } }
+
+template <class Arg1, class Arg2, class Arg3, class Arg4, class Arg5, class Arg6, class Arg7>
+void cl_format_to(CL_StringFormatBuffer &buffer, const CL_StringFormatPattern &format, const Arg1 &arg1, const Arg2 &arg2, const Arg3 &arg3, const Arg4 &arg4, const Arg5 &arg5, const Arg6 &arg6, const Arg7 &arg7)
+{ int pos = 0; for (int arg = buffer.append_format(format, pos, 7); arg != 0; arg = buffer.append_format(format, pos, 7)) switch (arg) { case 1: buffer.append(arg1); break; case 2: buffer.append(arg2); break; case 3: buffer.append(arg3); break; case 4: buffer.append(arg4); break; case 5: buffer.append(arg5); break; case 6: buffer.append(arg6); break; default: buffer.append(arg7); break; } }
+
+/// \}
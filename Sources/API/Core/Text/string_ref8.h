@@ -53,6 +53,13 @@ public:
 	/// \param source = String Reference
 	CL_StringRef8(const CL_StringRef8 &source);
 
+#ifdef CL_HAS_RVALUE_REFERENCES
+	/// \brief Constructs a StringReference, taking over the temporary buffer of source if it has one
+	///
+	/// \param source = String Reference. Left empty.
+	CL_StringRef8(CL_StringRef8 &&source) throw();
+#endif
+
 	/// \brief Constructs a StringReference
 	CL_StringRef8(const CL_StringData8 &source);
 
@@ -89,6 +96,9 @@ public:
 	void set_length(size_type length);
 
 	CL_StringRef8 &operator =(const CL_StringRef8 &source);
+#ifdef CL_HAS_RVALUE_REFERENCES
+	CL_StringRef8 &operator =(CL_StringRef8 &&source) throw();
+#endif
 	CL_StringRef8 &operator =(const CL_StringData8 &source);
 	CL_StringRef8 &operator =(const char *c_str);
 	CL_StringRef8 &operator =(const wchar_t *c_str);
@@ -0,0 +1,167 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+/// \addtogroup clanCore_XML clanCore XML
+/// \{
+
+#pragma once
+
+#include "../api_core.h"
+#include "../System/sharedptr.h"
+#include "../Text/string_types.h"
+#include "xml_token.h"
+
+class CL_IODevice;
+class CL_XMLReader_Generic;
+
+/// \brief Streaming XML reader.
+///
+/// <p>CL_XMLReader is a pull parser: each call to read() advances to the next node in the
+///    input and the current node is inspected with the attribute functions. Names, values and
+///    attributes are returned as string references pointing directly into the input buffer.
+///    They stay valid until the next call to read(). Entity references are only unescaped
+///    when get_value() or get_attribute_value() is called.</p>
+/// <p>When reading from an I/O device, the input is read in blocks and only the data of the
+///    current node is kept in memory. When reading from a memory block, no data is copied
+///    at all and the block must stay valid while the reader is used.</p>
+/// \xmlonly !group=Core/XML! !header=core.h! \endxmlonly
+class CL_API_CORE CL_XMLReader
+{
+/// \name Construction
+/// \{
+
+public:
+	/// \brief Constructs a null instance.
+	CL_XMLReader();
+
+	/// \brief Constructs a XML reader reading from an I/O device
+	///
+	/// \param input = Device to read the XML data from
+	/// \param buffer_size = Initial size of the read buffer. The buffer grows if a single node is larger.
+	CL_XMLReader(CL_IODevice &input, int buffer_size = 64*1024);
+
+	/// \brief Constructs a XML reader reading from a memory block
+	///
+	/// \param data = XML data. Must stay valid for the lifetime of the reader.
+	/// \param size = Size of the data in bytes
+	CL_XMLReader(const void *data, int size);
+
+	~CL_XMLReader();
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	/// \brief Returns true if this object is invalid.
+	bool is_null() const { return !impl; }
+
+	/// \brief Returns true if eat whitespace flag is set.
+	bool get_eat_whitespace() const;
+
+	/// \brief Returns the type of the current node.
+	CL_XMLToken::TokenType get_type() const;
+
+	/// \brief Returns the variant of the current node (begin, end or single element).
+	CL_XMLToken::TokenVariant get_variant() const;
+
+	/// \brief Returns true if the current node is a start tag (including empty-element tags).
+	bool is_element_begin() const;
+
+	/// \brief Returns true if the current node is an end tag (including empty-element tags).
+	bool is_element_end() const;
+
+	/// \brief Returns the element nesting depth of the current node.
+	///
+	/// The document element has depth 0, its children depth 1 and so on.
+	int get_depth() const;
+
+	/// \brief Returns the name of the current element, processing instruction or document type.
+	CL_StringRef get_name() const;
+
+	/// \brief Returns the value of the current node as it appears in the input.
+	CL_StringRef get_raw_value() const;
+
+	/// \brief Returns the value of the current node with entity references unescaped.
+	CL_String get_value() const;
+
+	/// \brief Returns the number of attributes of the current element.
+	int get_attribute_count() const;
+
+	/// \brief Returns the name of an attribute of the current element.
+	CL_StringRef get_attribute_name(int index) const;
+
+	/// \brief Returns the value of an attribute as it appears in the input.
+	CL_StringRef get_attribute_raw_value(int index) const;
+
+	/// \brief Returns the value of an attribute with entity references unescaped.
+	CL_String get_attribute_value(int index) const;
+
+	/// \brief Returns true if the current element has the named attribute.
+	bool has_attribute(const CL_StringRef &name) const;
+
+	/// \brief Returns the unescaped value of the named attribute, or default_value if not present.
+	CL_String get_attribute(const CL_StringRef &name, const CL_StringRef &default_value = CL_StringRef()) const;
+
+	/// \brief Returns the line number of the current node.
+	int get_line_number() const;
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	/// \brief If enabled, will eat any whitespace between tags.
+	void set_eat_whitespace(bool enable);
+
+	/// \brief Advances to the next node.
+	///
+	/// \return false when the end of the input has been reached.
+	bool read();
+
+	/// \brief Skips all children of the current element.
+	///
+	/// If the current node is a start tag, the reader is advanced to its matching end tag.
+	void skip_element();
+
+	/// \brief Replaces entity references in text with the characters they represent.
+	static CL_String unescape(const CL_StringRef &text);
+
+	/// \brief Replaces entity references in text, storing the result in an existing string.
+	static void unescape(const CL_StringRef &text, CL_String &out_text);
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	CL_SharedPtr<CL_XMLReader_Generic> impl;
+/// \}
+};
+
+/// \}
@@ -33,6 +33,7 @@
 
 #include "../System/sharedptr.h"
 #include "xpath_object.h"
+#include "xpath_expression.h"
 
 class CL_DomNode;
 class CL_XPathEvaluator_Impl;
@@ -62,6 +63,29 @@ public:
 	/// \return XPath Object
 	CL_XPathObject evaluate(const CL_StringRef &expression, const CL_DomNode &context_node) const;
 
+	/// \brief Evaluate a compiled expression
+	///
+	/// \param expression = Expression returned by compile
+	/// \param context_node = Dom Node
+	///
+	/// \return XPath Object
+	CL_XPathObject evaluate(const CL_XPathExpression &expression, const CL_DomNode &context_node) const;
+
+	/// \brief Compile an expression for repeated evaluation
+	///
+	/// Compiled expressions are shared through the expression cache, so compiling the
+	/// same text twice returns the same expression as long as it is still cached.
+	CL_XPathExpression compile(const CL_StringRef &expression) const;
+
+	/// \brief Sets the maximum number of compiled expressions kept in the expression cache.
+	///
+	/// The cache is shared by all evaluators. evaluate(const CL_StringRef &, ...) looks up
+	/// the expression text in this cache before compiling it. A size of 0 disables the cache.
+	static void set_cache_size(int max_expressions);
+
+	/// \brief Removes all expressions from the expression cache.
+	static void clear_cache();
+
 /// \}
 /// \name Implementation
 /// \{
@@ -0,0 +1,85 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+/// \addtogroup clanCore_XML clanCore XML
+/// \{
+
+#pragma once
+
+#include "../api_core.h"
+#include "../System/sharedptr.h"
+#include "../Text/string_types.h"
+
+class CL_XPathEvaluator;
+class CL_XPathExpression_Impl;
+
+/// \brief Compiled XPath expression.
+///
+/// <p>A compiled expression is created by CL_XPathEvaluator::compile. It is tokenized once,
+///    and its location paths are parsed the first time they are evaluated, making it cheap to
+///    evaluate the same expression many times.</p>
+/// \xmlonly !group=Core/XML! !header=core.h! \endxmlonly
+class CL_API_CORE CL_XPathExpression
+{
+/// \name Construction
+/// \{
+
+public:
+	/// \brief Constructs a null instance.
+	CL_XPathExpression();
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	/// \brief Returns true if this object is invalid.
+	bool is_null() const { return !impl; }
+
+	/// \brief Returns the expression text.
+	CL_String get_text() const;
+
+	/// \brief Returns true if the expression is a plain child/attribute path without predicates.
+	///
+	/// Such paths are evaluated by walking the DOM directly.
+	bool is_simple_path() const;
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	CL_XPathExpression(const CL_SharedPtr<CL_XPathExpression_Impl> &impl);
+
+	CL_SharedPtr<CL_XPathExpression_Impl> impl;
+
+	friend class CL_XPathEvaluator;
+/// \}
+};
+
+/// \}
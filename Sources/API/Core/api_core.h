@@ -41,3 +41,8 @@
 	#define CL_API_CORE_STATIC
 #endif
 
+// Move constructors and rvalue overloads are only declared when the compiler supports rvalue references:
+#if defined(__GXX_EXPERIMENTAL_CXX0X__) || (__cplusplus >= 201103L) || (defined(_MSC_VER) && _MSC_VER >= 1600)
+	#define CL_HAS_RVALUE_REFERENCES
+#endif
+
@@ -73,6 +73,9 @@ public:
 	/// \brief Returns the output parameter containing the row id of the last inserted row
 	int get_output_last_insert_rowid() const;
 
+	/// \brief Returns the number of parameter rows added with add_batch() and not yet executed
+	int get_batch_size() const;
+
 	/// \brief Returns the provider interface for this command
 	CL_DBCommandProvider *get_provider();
 /// \}
@@ -106,6 +109,12 @@ public:
 	template<class ValueType>
 	void set_input_parameter(const CL_StringRef &name, ValueType value);
 
+	/// \brief Adds the current input parameters as a row of the batch
+	///
+	/// The rows are executed by CL_DBConnection::execute_batch(). The input parameters
+	/// keep their values, so only the ones that differ need to be set for the next row.
+	void add_batch();
+
 /// \}
 
 /// \name Implementation
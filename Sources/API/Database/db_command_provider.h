@@ -55,6 +55,9 @@ public:
 
 	/// \brief Returns the output parameter containing the row id of the last inserted row
 	virtual int get_output_last_insert_rowid() const = 0;
+
+	/// \brief Returns the number of parameter rows added with add_batch() and not yet executed
+	virtual int get_batch_size() const = 0;
 /// \}
 
 /// \name Operations
@@ -77,6 +80,9 @@ public:
 
 	/// \brief Sets the specified input parameter index from a CL_DataBuffer value
 	virtual void set_input_parameter_binary(int index, const CL_DataBuffer &value) = 0;
+
+	/// \brief Adds the current input parameters as a row of the batch
+	virtual void add_batch() = 0;
 /// \}
 
 /// \name Implementation
@@ -62,6 +62,8 @@ public:
 /// \name Attributes
 /// \{
 public:
+	/// \brief Returns the provider interface for this connection
+	CL_DBConnectionProvider *get_provider();
 /// \}
 
 /// \name Operations
@@ -119,6 +121,12 @@ public:
 
 	/// \brief Execute database command.
 	void execute_non_query(CL_DBCommand &command);
+
+	/// \brief Execute database command once for each row added with CL_DBCommand::add_batch().
+	///
+	/// All rows are executed as a single unit: if one row fails, none of them are applied.
+	/// The batch of the command is empty afterwards, also when an exception is thrown.
+	void execute_batch(CL_DBCommand &command);
 /// \}
 
 /// \name Implementation
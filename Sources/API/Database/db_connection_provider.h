@@ -75,6 +75,9 @@ public:
 
 	/// \brief Execute database command.
 	virtual void execute_non_query(CL_DBCommandProvider *command) = 0;
+
+	/// \brief Execute database command once for each row added with add_batch() and clear the batch.
+	virtual void execute_batch(CL_DBCommandProvider *command) = 0;
 /// \}
 
 /// \name Implementation
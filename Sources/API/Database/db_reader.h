@@ -141,6 +141,41 @@ public:
 	/// \brief Retrieves a row from the command execution result
 	/// \return True if a row was retrieved, false if there are no more rows
 	bool retrieve_row();
+
+	/// \brief Binds an array that retrieve_rows fills with the values of a column
+	void bind_column(int index, int *values);
+
+	/// \brief Binds an array that retrieve_rows fills with the values of a column
+	void bind_column(int index, double *values);
+
+	/// \brief Binds an array that retrieve_rows fills with the values of a column
+	void bind_column(int index, CL_String *values);
+
+	/// \brief Binds an array that retrieve_rows fills with the values of a column
+	void bind_column(int index, CL_DateTime *values);
+
+	/// \brief Binds an array that retrieve_rows fills with the values of a column
+	void bind_column(const CL_StringRef &column_name, int *values);
+
+	/// \brief Binds an array that retrieve_rows fills with the values of a column
+	void bind_column(const CL_StringRef &column_name, double *values);
+
+	/// \brief Binds an array that retrieve_rows fills with the values of a column
+	void bind_column(const CL_StringRef &column_name, CL_String *values);
+
+	/// \brief Binds an array that retrieve_rows fills with the values of a column
+	void bind_column(const CL_StringRef &column_name, CL_DateTime *values);
+
+	/// \brief Removes all arrays bound with bind_column
+	void unbind_columns();
+
+	/// \brief Retrieves up to max_rows rows at once, storing their values in the arrays bound with bind_column
+	///
+	/// This is faster than retrieve_row for large results, as values are converted column by column.
+	/// \param max_rows = Maximum number of rows to retrieve. Each bound array must have room for this many values.
+	/// \return Number of rows retrieved, 0 if there are no more rows.
+	///         The last row retrieved becomes the current row, unless fewer than max_rows were left.
+	int retrieve_rows(int max_rows);
 	
 	/// \brief Closes the database reader
 	void close();
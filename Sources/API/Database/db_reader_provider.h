@@ -32,10 +32,40 @@
 #pragma once
 
 #include "api_database.h"
+#include <vector>
 
 class CL_DateTime;
 class CL_DataBuffer;
 
+/// \brief Array receiving the values of a column, filled by CL_DBReaderProvider::retrieve_rows.
+///
+/// \xmlonly !group=Database/System! !header=database.h! \endxmlonly
+class CL_DBColumnArray
+{
+public:
+	enum Type
+	{
+		type_int,
+		type_double,
+		type_string,
+		type_datetime
+	};
+
+	CL_DBColumnArray(int index, int *values) : index(index), type(type_int), values(values) { }
+	CL_DBColumnArray(int index, double *values) : index(index), type(type_double), values(values) { }
+	CL_DBColumnArray(int index, CL_String *values) : index(index), type(type_string), values(values) { }
+	CL_DBColumnArray(int index, CL_DateTime *values) : index(index), type(type_datetime), values(values) { }
+
+	/// \brief Column index in the result set
+	int index;
+
+	/// \brief Element type of the array
+	Type type;
+
+	/// \brief First element of the array
+	void *values;
+};
+
 /// \brief Database reader provider.
 ///
 /// \xmlonly !group=Database/System! !header=database.h! \endxmlonly
@@ -93,6 +123,12 @@ public:
 	/// \brief Retrieves a row from the command execution result
 	/// \return True if a row was retrieved, false if there are no more rows
 	virtual bool retrieve_row() = 0;
+
+	/// \brief Retrieves the next rows and stores their values in the column arrays
+	/// \param max_rows = Maximum number of rows to retrieve. Each array must have room for this many values.
+	/// \return Number of rows retrieved, 0 if there are no more rows.
+	///         The last row retrieved becomes the current row, unless fewer than max_rows were left.
+	virtual int retrieve_rows(int max_rows, const std::vector<CL_DBColumnArray> &columns) = 0;
 	
 	/// \brief Closes the database reader
 	virtual void close() = 0;
@@ -0,0 +1,93 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+/// \addtogroup clanDisplay_2D clanDisplay 2D
+/// \{
+
+#pragma once
+
+#include "../api_display.h"
+#include "../../Core/Resources/resource_loader.h"
+#include "../../Core/Text/string_types.h"
+#include "../Render/graphic_context.h"
+#include "../Image/image_import_description.h"
+#include "sprite.h"
+
+class CL_SpriteLoadTask_Impl;
+
+/// \brief Resource loader task creating a sprite from a sprite resource.
+///
+/// <p>The image files referenced by the sprite resource are decoded on a CL_ResourceLoader
+///    worker thread. When CL_ResourceLoader::process_completed is called, the images are
+///    uploaded into the shared texture cache and the sprite is created from the resource,
+///    so the sprite is set up exactly as if it was created with CL_Sprite(gc, resource_id, resources).</p>
+/// \xmlonly !group=Display/2D! !header=display.h! \endxmlonly
+class CL_API_DISPLAY CL_SpriteLoadTask : public CL_ResourceLoadTask
+{
+/// \name Construction
+/// \{
+
+public:
+	/// \brief Constructs a sprite load task
+	///
+	/// \param gc = Graphic Context used to create the textures.
+	/// \param resource_id = Id of a resource of type 'sprite', 'sprite_description' or 'image'.
+	/// \param import_desc = Image Import Description
+	CL_SpriteLoadTask(CL_GraphicContext &gc, const CL_String &resource_id, const CL_ImageImportDescription &import_desc = CL_ImageImportDescription());
+
+	~CL_SpriteLoadTask();
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	/// \brief Returns the loaded sprite, or a null sprite if the task has not finished.
+	CL_Sprite get_sprite() const;
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	void prepare(CL_ResourceManager &resources);
+
+	void load();
+
+	void finish();
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	CL_SharedPtr<CL_SpriteLoadTask_Impl> impl;
+/// \}
+};
+
+/// \}
@@ -34,6 +34,7 @@
 
 #include "../api_display.h"
 #include "../../Core/System/sharedptr.h"
+#include "../../Core/Math/rect_packer.h"
 
 class CL_Size;
 class CL_Rect;
@@ -92,6 +93,9 @@ public:
 	/// \brief Returns the texture allocation policy.
 	TextureAllocationPolicy get_texture_allocation_policy() const;
 
+	/// \brief Returns the algorithm used to pack sub-textures into textures.
+	CL_RectPacker::PackingAlgorithm get_packing_algorithm() const;
+
 	/// \brief Returns the size of the textures used by this texture group.
 	CL_Size get_texture_sizes() const;
 
@@ -105,19 +109,39 @@ public:
 	/// \brief Allocate space for another sub texture.
 	CL_Subtexture add(CL_GraphicContext &context, const CL_Size &size);
 
+	/// \brief Allocate space for a batch of sub textures.
+	///
+	/// The sub textures are packed largest first, which uses less texture space than adding them one by one.
+	/// \return Sub textures, in the same order as sizes.
+	std::vector<CL_Subtexture> add(CL_GraphicContext &context, const std::vector<CL_Size> &sizes);
+
 	/// \brief Deallocate space, from a previously allocated texture
 	///
 	/// Warning - It is advised to set TextureAllocationPolicy to search_previous_textures
-	/// if using this function.  Also be aware of texture fragmentation.
-	/// Empty textures are not removed.
+	/// if using this function.  Also be aware of texture fragmentation, which repack() undoes.
+	/// Empty textures are removed.
 	void remove(CL_Subtexture &subtexture);
 
 	/// \brief Set the texture allocation policy.
 	void set_texture_allocation_policy(TextureAllocationPolicy policy);
 
+	/// \brief Set the algorithm used to pack sub-textures into textures.
+	///
+	/// Textures keep the algorithm they were created with. The default is CL_RectPacker::guillotine.
+	void set_packing_algorithm(CL_RectPacker::PackingAlgorithm algorithm);
+
+	/// \brief Packs the sub textures in use into new textures, reclaiming the space fragmented by remove().
+	///
+	/// The sub textures are copied as one batch into new textures and the textures added with
+	/// insert_texture(), whose areas are reused from scratch. All other previous textures are released.
+	/// If the sub textures do not fit, an exception is thrown and the group is left unchanged.
+	/// \param subtextures = All sub textures still in use. They are replaced by their new location.
+	void repack(CL_GraphicContext &context, std::vector<CL_Subtexture> &subtextures);
+
 	/// \brief Insert an existing texture into the texture group
 	///
 	/// \param texture = Texture to insert
+	/// The texture stays in the group through repack(), until its last sub texture is removed.
 	/// \param texture_rect = Free space within the texture that the texture group can use
 	void insert_texture(CL_Texture &texture, const CL_Rect &texture_rect);
 
@@ -350,6 +350,13 @@ public:
 	/// \param remove_old_collision_info = set to true to remove old collision info
 	bool collide( const CL_CollisionOutline &outline, bool remove_old_collision_info=true );
 
+	/// \brief Returns true if outlines overlap, storing the collision info in collision_info instead of this outline.
+	///
+	/// Neither outline is modified, so several pairs may be tested at the same time from different threads.
+	/// \param outline = Outline to test against.
+	/// \param collision_info = Receives the collision info, as enabled on this outline. Its previous contents are removed.
+	bool collide( const CL_CollisionOutline &outline, std::vector<CL_CollidingContours> &collision_info ) const;
+
 	/// \brief Will calculate the penetration_depth and penetration_normal for all colliding contours.
 	static void calculate_penetration_depth(std::vector<CL_CollidingContours> &collision_info);
 
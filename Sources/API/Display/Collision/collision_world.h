@@ -0,0 +1,143 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Kenneth Gangstoe
+*/
+
+/// \addtogroup clanDisplay_Collision clanDisplay Collision
+/// \{
+
+#pragma once
+
+#include "../api_display.h"
+#include <vector>
+#include "collision_outline.h"
+#include "../../Core/Math/rect.h"
+
+class CL_CollisionWorld_Impl;
+
+/// \brief Pair of outlines found by CL_CollisionWorld.
+///
+/// \xmlonly !group=Display/Collision! !header=display.h! \endxmlonly
+struct CL_CollisionPair
+{
+	CL_CollisionPair() : id1(-1), id2(-1) { }
+	CL_CollisionPair(int id1, int id2) : id1(id1), id2(id2) { }
+
+	/// \brief Ids of the outlines, as returned by CL_CollisionWorld::add(). id1 is always the lower one.
+	int id1, id2;
+
+	/// \brief Collision info, as enabled on the outline of id1. Empty for candidate pairs.
+	std::vector<CL_CollidingContours> collision_info;
+};
+
+/// \brief Collision world finding the colliding pairs among many outlines.
+///
+/// <p>The world keeps the bounding box of every outline in a dynamic tree, enlarged by a margin,
+/// so only outlines that moved out of their box need to be reinserted each step. Outlines whose
+/// boxes overlap are candidate pairs, which are tested with CL_CollisionOutline::collide() on
+/// several threads.</p>
+/// <p>The outlines are shared with the world, so they can be moved, rotated and scaled as usual
+/// between steps, but must not be changed while a step is running.</p>
+/// \xmlonly !group=Display/Collision! !header=display.h! \endxmlonly
+class CL_API_DISPLAY CL_CollisionWorld
+{
+/// \name Construction
+/// \{
+public:
+	/// \brief Constructs an empty collision world.
+	CL_CollisionWorld();
+
+	~CL_CollisionWorld();
+
+/// \}
+/// \name Attributes
+/// \{
+public:
+	/// \brief Returns the number of outlines in the world.
+	int get_outline_count() const;
+
+	/// \brief Returns the outline with the given id.
+	CL_CollisionOutline get_outline(int id) const;
+
+	/// \brief Returns the distance the bounding boxes are enlarged by.
+	float get_margin() const;
+
+	/// \brief Returns the maximum number of extra threads used for the narrow phase.
+	int get_max_threads() const;
+
+	/// \brief Returns the candidate pairs found by the last step.
+	const std::vector<CL_CollisionPair> &get_candidate_pairs() const;
+
+	/// \brief Returns the colliding pairs found by the last step.
+	const std::vector<CL_CollisionPair> &get_collisions() const;
+
+/// \}
+/// \name Operations
+/// \{
+public:
+	/// \brief Adds an outline and returns its id.
+	///
+	/// Ids of removed outlines are reused.
+	int add(const CL_CollisionOutline &outline);
+
+	/// \brief Removes an outline.
+	void remove(int id);
+
+	/// \brief Removes all outlines.
+	void clear();
+
+	/// \brief Sets the distance the bounding boxes are enlarged by.
+	///
+	/// Larger margins let outlines move further before their box is updated, at the cost of more candidate pairs.
+	/// The margin applies to the boxes updated from then on.
+	void set_margin(float margin);
+
+	/// \brief Sets the maximum number of extra threads used for the narrow phase. Zero tests all pairs on the calling thread.
+	void set_max_threads(int max_threads);
+
+	/// \brief Updates the bounding boxes of the outlines that moved out of them.
+	void update();
+
+	/// \brief Updates the bounding boxes and returns the pairs of outlines whose boxes overlap.
+	const std::vector<CL_CollisionPair> &find_candidate_pairs();
+
+	/// \brief Finds the candidate pairs and returns the ones whose outlines collide.
+	const std::vector<CL_CollisionPair> &step();
+
+	/// \brief Returns the ids of the outlines whose bounding box overlaps an area.
+	///
+	/// The boxes are the ones found by the last update.
+	std::vector<int> query(const CL_Rectf &area) const;
+
+/// \}
+/// \name Implementation
+/// \{
+private:
+	CL_SharedPtr<CL_CollisionWorld_Impl> impl;
+/// \}
+};
+
+/// \}
@@ -201,6 +201,15 @@ public:
 	/// \brief Returns the current effective modelview matrix.
 	const CL_Mat4f &get_modelview() const;
 
+	/// \brief Returns the current projection mapping mode.
+	CL_MapMode get_map_mode() const;
+
+	/// \brief Returns the projection matrix last set with set_projection().
+	const CL_Mat4f &get_projection() const;
+
+	/// \brief Returns the viewport last set with set_viewport(), or the full context when a 2D map mode was selected after it.
+	const CL_Rectf &get_viewport() const;
+
 	/// \brief Returns the maximum size of a texture this graphic context supports.
 	/** <p>It returns CL_Size(0,0) if there is no known limitation to the max
 	    texture size.</p>*/
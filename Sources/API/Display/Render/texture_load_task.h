@@ -0,0 +1,91 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+/// \addtogroup clanDisplay_Display clanDisplay Display
+/// \{
+
+#pragma once
+
+#include "../api_display.h"
+#include "../../Core/Resources/resource_loader.h"
+#include "../../Core/Text/string_types.h"
+#include "graphic_context.h"
+#include "texture.h"
+#include "../Image/image_import_description.h"
+
+class CL_TextureLoadTask_Impl;
+
+/// \brief Resource loader task creating a texture from a texture resource.
+///
+/// <p>The image file is decoded on a CL_ResourceLoader worker thread. The texture is
+///    created and uploaded when CL_ResourceLoader::process_completed is called.</p>
+/// \xmlonly !group=Display/Display! !header=display.h! \endxmlonly
+class CL_API_DISPLAY CL_TextureLoadTask : public CL_ResourceLoadTask
+{
+/// \name Construction
+/// \{
+
+public:
+	/// \brief Constructs a texture load task
+	///
+	/// \param gc = Graphic Context used to create the texture.
+	/// \param resource_id = Id of a resource of type 'texture'.
+	/// \param import_desc = Image Import Description
+	CL_TextureLoadTask(CL_GraphicContext &gc, const CL_String &resource_id, const CL_ImageImportDescription &import_desc = CL_ImageImportDescription());
+
+	~CL_TextureLoadTask();
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	/// \brief Returns the loaded texture, or a null texture if the task has not finished.
+	CL_Texture get_texture() const;
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	void prepare(CL_ResourceManager &resources);
+
+	void load();
+
+	void finish();
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	CL_SharedPtr<CL_TextureLoadTask_Impl> impl;
+/// \}
+};
+
+/// \}
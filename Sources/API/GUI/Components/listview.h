@@ -48,6 +48,7 @@ enum CL_ListViewDisplayMode
 #include "listview_selected_item.h"
 #include "listview_column_header.h"
 #include "listview_icon_list.h"
+#include "listview_model.h"
 
 class CL_ListViewHeader;
 class CL_ListView_Impl;
@@ -130,6 +131,9 @@ public:
 	/// \return display_mode
 	CL_ListViewDisplayMode get_display_mode() const;
 
+	/// \brief Returns the model shown by the list view, or a null pointer if it shows its items.
+	CL_SharedPtr<CL_ListViewModel> get_model() const;
+
 /// \}
 /// \name Operations
 /// \{
@@ -168,6 +172,16 @@ public:
 	/// \brief Set if node opener is shown in the detail display mode
 	void show_detail_opener(bool enable = true);
 
+	/// \brief Show the rows of a model instead of the items of the document item.
+	///
+	/// Only the rows scrolled into view are requested from the model. Models are shown
+	/// in the details display mode; the other display modes keep showing the items.
+	/// Pass a null pointer to show the items again.
+	void set_model(const CL_SharedPtr<CL_ListViewModel> &model);
+
+	/// \brief Call after the row count or the row contents of the model changed.
+	void invalidate_model();
+
 	/// \brief Remove all items.
 	void clear();
 
@@ -243,6 +243,7 @@ private:
 	friend class CL_ListView_Impl;
 	friend class CL_ListViewSelection;
 	friend class CL_ListViewLayout;
+	friend class CL_ListViewModelRows;
 /// \}
 };
 
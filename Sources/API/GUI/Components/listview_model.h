@@ -0,0 +1,72 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+/// \addtogroup clanGUI_Components clanGUI Components
+/// \{
+
+#pragma once
+
+#include "../api_gui.h"
+
+/// \brief Data source for a list view that only materializes its visible rows.
+///
+/// When a model is attached with CL_ListView::set_model, the details view asks the
+/// model for the rows currently scrolled into view instead of walking the item tree.
+/// All rows share the row height of the list view, so scrolling does not depend on
+/// the number of rows in the model.
+///
+/// The items handed out by the list view for a model (selection, callbacks) have their
+/// id set to the row index.
+///
+/// \xmlonly !group=GUI/Components! !header=gui.h! \endxmlonly
+class CL_API_GUI CL_ListViewModel
+{
+/// \name Construction
+/// \{
+
+public:
+	virtual ~CL_ListViewModel() { }
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	/// \brief Returns the number of rows in the model.
+	virtual int get_row_count() = 0;
+
+	/// \brief Returns the text of a row for the specified column.
+	virtual CL_String get_text(int row, const CL_StringRef &column_id) = 0;
+
+	/// \brief Returns the icon index of a row.
+	virtual int get_icon(int row) { return 0; }
+
+/// \}
+};
+
+/// \}
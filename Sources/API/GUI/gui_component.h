@@ -312,6 +312,9 @@ public:
 	/// \brief Enabled whether the GUI will constantly repaint this component when there are no other messages to process
 	bool get_constant_repaint() const;
 
+	/// \brief Returns true if this component and its children are rendered through a cache texture
+	bool get_render_cache() const;
+
 	/// \brief Gets the css layout
 	CL_CSSLayout get_css_layout();
 
@@ -541,6 +544,11 @@ public:
 	/// \brief Enabled whether the GUI will constantly repaint this component when there are no other messages to process
 	void set_constant_repaint(bool enable);
 
+	/// \brief Enables rendering this component and its children into a cache texture
+	/** <p>The cache is redrawn after request_repaint has been called on the component or one
+	    of its children, so a static subtree only costs a single textured quad per frame.</p>*/
+	void set_render_cache(bool enable);
+
 	/// \brief Loads a layout from file.
 	void load_css_layout(const CL_String &xml_filename, const CL_String &css_filename);
 
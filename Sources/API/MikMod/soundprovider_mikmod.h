@@ -52,7 +52,7 @@ public:
 	///
 	/// \param filename Filename of module file.
 	/// \param provider Input source provider used to retrieve module file.
-	/// \param stream If true, will stream from disk. If false, will load it to memory.
+	/// \param stream If true, sessions render ahead of playback on a background thread. The module itself is always loaded to memory.
 	CL_SoundProvider_MikMod(
 		const CL_String &filename,
 		const CL_VirtualDirectory &provider,
@@ -68,11 +68,24 @@ public:
 
 	virtual ~CL_SoundProvider_MikMod();
 
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	/// \brief Returns how many times streamed sessions ran out of rendered samples.
+	int get_num_underruns() const;
+
 /// \}
 /// \name Operations
 /// \{
 
 public:
+	/// \brief Sets how many samples streamed sessions render ahead of playback.
+	///
+	/// Only affects sessions started after the call.
+	void set_stream_buffer_size(int samples);
+
 	/// \brief Called by CL_SoundBuffer when a new session starts.
 	/** \return The soundbuffer session to be attached to the newly started session.*/
 	virtual CL_SoundProvider_Session *begin_session();
@@ -34,6 +34,7 @@
 #include "../api_network.h"
 
 #include "connection_site.h"	// TODO: Remove
+#include "event.h"
 #include "../../Core/System/event.h"
 #include "../../Core/Signals/signal_v0.h"
 #include "../../Core/Signals/signal_v1.h"
@@ -57,6 +58,17 @@ public:
 	/// \param port = String
 	void connect(const CL_String &server, const CL_String &port);
 
+	/// \brief Connect to a server started with CL_NetGameServer::start_udp
+	///
+	/// \param server = String
+	/// \param port = String
+	void connect_udp(const CL_String &server, const CL_String &port);
+
+	/// \brief Set how events with the specified name are delivered by the UDP transport.
+	///
+	/// Events default to CL_NetGameEvent::reliable_ordered.
+	void set_delivery_mode(const CL_String &event_name, CL_NetGameEvent::DeliveryMode mode);
+
 	/// \brief Disconnect
 	void disconnect();
 
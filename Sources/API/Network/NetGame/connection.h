@@ -42,6 +42,7 @@
 
 class CL_NetGameConnectionSite;
 class CL_NetGameConnection_Impl;
+class CL_NetGameUDPTransport;
 
 /// \brief CL_NetGameConnection
 ///
@@ -56,6 +57,7 @@ public:
 	/// \param connection = TCPConnection
 	CL_NetGameConnection(CL_NetGameConnectionSite *site, const CL_TCPConnection &connection);
 	CL_NetGameConnection(CL_NetGameConnectionSite *site, const CL_SocketName &socket_name);
+	CL_NetGameConnection(CL_NetGameConnectionSite *site, CL_NetGameUDPTransport *transport, const CL_SocketName &socket_name);
 
 	~CL_NetGameConnection();
 
@@ -85,6 +87,11 @@ public:
 	/// \return remote_name
 	CL_SocketName get_remote_name() const;
 
+	/// \brief Returns the smoothed round trip time in milliseconds.
+	///
+	/// Only UDP connections measure it. Returns -1 for TCP connections, or until the first packet has been acknowledged.
+	int get_round_trip_time() const;
+
 private:
 	/// \brief Disallow copy constructors
 	CL_NetGameConnection(CL_NetGameConnection &other);
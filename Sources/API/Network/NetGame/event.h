@@ -41,6 +41,21 @@ class CL_API_NETWORK CL_NetGameEvent
 {
 public:
 
+	/// \brief How the UDP transport delivers an event.
+	///
+	/// TCP connections always deliver events reliable and ordered.
+	enum DeliveryMode
+	{
+		/// \brief The event may be lost or arrive out of order.
+		unreliable,
+
+		/// \brief The event may be lost, and is dropped if a newer event with the same name already arrived.
+		unreliable_sequenced,
+
+		/// \brief The event is resent until acknowledged and is received in send order.
+		reliable_ordered
+	};
+
 	/// \brief Constructs a NetGameEvent
 	///
 	/// \param name = String
@@ -105,6 +120,13 @@ public:
 	/// \param value = Net Game Event Value
 	void add_argument(const CL_NetGameEventValue &value);
 
+#ifdef CL_HAS_RVALUE_REFERENCES
+	/// \brief Add argument, moving the value into the event
+	///
+	/// \param value = Net Game Event Value
+	void add_argument(CL_NetGameEventValue &&value);
+#endif
+
 	/// \brief To string
 	///
 	/// \return String
@@ -175,6 +175,13 @@ public:
 	/// \param value = Net Game Event Value
 	void add_member(const CL_NetGameEventValue &value);
 
+#ifdef CL_HAS_RVALUE_REFERENCES
+	/// \brief Add member, moving the value into this value
+	///
+	/// \param value = Net Game Event Value
+	void add_member(CL_NetGameEventValue &&value);
+#endif
+
 	/// \brief Set member
 	///
 	/// \param index = value
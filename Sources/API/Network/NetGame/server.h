@@ -34,6 +34,7 @@
 #include "../api_network.h"
 
 #include "connection_site.h"	// TODO: Remove
+#include "event.h"
 #include "../../Core/System/event.h"
 #include "../../Core/Signals/signal_v1.h"
 #include "../../Core/Signals/signal_v2.h"
@@ -62,6 +63,24 @@ public:
 	/// \param port = String
 	void start(const CL_String &address, const CL_String &port);
 
+	/// \brief Start accepting clients over UDP
+	///
+	/// Events are delivered as set by set_delivery_mode.
+	///
+	/// \param port = String
+	void start_udp(const CL_String &port);
+
+	/// \brief Start accepting clients over UDP
+	///
+	/// \param address = String
+	/// \param port = String
+	void start_udp(const CL_String &address, const CL_String &port);
+
+	/// \brief Set how events with the specified name are delivered by the UDP transport.
+	///
+	/// Events default to CL_NetGameEvent::reliable_ordered.
+	void set_delivery_mode(const CL_String &event_name, CL_NetGameEvent::DeliveryMode mode);
+
 	/// \brief Process events
 	void process_events();
 
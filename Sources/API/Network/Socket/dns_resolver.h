@@ -33,14 +33,96 @@
 
 #include "../api_network.h"
 #include "../../Core/System/sharedptr.h"
+#include "../../Core/System/event.h"
 #include <vector>
 
 class CL_DNSResourceRecord;
 class CL_DNSPacket;
+class CL_SocketName;
 class CL_DNSResolver_Impl;
+class CL_DNSLookup_Impl;
+
+/// \brief Handle to an asynchronous DNS lookup started by CL_DNSResolver::lookup_resource_async.
+///
+/// \xmlonly !group=Network/Socket! !header=network.h! \endxmlonly
+class CL_API_NETWORK CL_DNSLookup
+{
+/// \name Construction
+/// \{
+
+public:
+	/// \brief Constructs a null handle.
+	CL_DNSLookup();
+
+	~CL_DNSLookup();
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	/// \brief Returns true if this handle is null.
+	bool is_null() const { return !impl; }
+
+	/// \brief Throw an exception if this handle is null.
+	void throw_if_null() const;
+
+	/// \brief Returns the domain name being looked up.
+	CL_String get_domain_name() const;
+
+	/// \brief Returns the resource type being looked up.
+	CL_String get_resource_type() const;
+
+	/// \brief Returns true if the lookup has completed or failed.
+	bool is_done() const;
+
+	/// \brief Returns true if the lookup failed.
+	bool is_failed() const;
+
+	/// \brief Returns true if the answer came from the resolver cache.
+	bool is_cached() const;
+
+	/// \brief Returns the error message if the lookup failed.
+	CL_String get_error_message() const;
+
+	/// \brief Returns the resource records found by a completed lookup.
+	std::vector<CL_DNSResourceRecord> get_records() const;
+
+	/// \brief Returns an event flagged when the lookup completes or fails.
+	CL_Event get_done_event() const;
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	bool operator ==(const CL_DNSLookup &other) const { return impl == other.impl; }
+
+	/// \brief Waits until the lookup completes or fails.
+	///
+	/// \return true if the lookup is done, false if the timeout elapsed.
+	bool wait(int timeout = -1);
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	CL_DNSLookup(const CL_SharedPtr<CL_DNSLookup_Impl> &impl);
+
+	CL_SharedPtr<CL_DNSLookup_Impl> impl;
+
+	friend class CL_DNSResolver;
+	friend class CL_DNSResolver_Impl;
+/// \}
+};
 
 /// \brief DNS resolver.
 ///
+/// <p>Answers are kept in a cache shared by all copies of the resolver. Positive answers
+///    are cached for the lowest TTL of the returned records. Names that do not exist are
+///    cached for the TTL of the SOA record in the answer, or the negative cache TTL if the
+///    server did not include one.</p>
 /// \xmlonly !group=Network/Socket! !header=network.h! \endxmlonly
 class CL_API_NETWORK CL_DNSResolver
 {
@@ -48,8 +130,12 @@ class CL_API_NETWORK CL_DNSResolver
 /// \{
 
 public:
+	/// \brief Constructs a resolver using the DNS servers configured for the system.
 	CL_DNSResolver();
 
+	/// \brief Constructs a resolver using the specified DNS servers.
+	CL_DNSResolver(const std::vector<CL_SocketName> &dns_servers);
+
 	~CL_DNSResolver();
 
 /// \}
@@ -57,17 +143,43 @@ public:
 /// \{
 
 public:
+	/// \brief Returns the number of answers in the cache, including expired ones not yet removed.
+	int get_cache_size() const;
 
 /// \}
 /// \name Operations
 /// \{
 
 public:
+	/// \brief Looks up a resource, blocking until the answer arrives.
+	///
+	/// Throws an exception if the lookup fails.
 	std::vector<CL_DNSResourceRecord> lookup_resource(
 		const CL_String &domain_name,
 		const CL_String &resource_type,
 		int timeout);
 
+	/// \brief Starts looking up a resource in the background.
+	///
+	/// Cached answers complete the returned lookup immediately.
+	///
+	/// \param domain_name = Domain name to look up
+	/// \param resource_type = Resource type, such as "A" or "MX"
+	/// \param timeout = Time in milliseconds before the lookup fails
+	CL_DNSLookup lookup_resource_async(
+		const CL_String &domain_name,
+		const CL_String &resource_type,
+		int timeout);
+
+	/// \brief Sets how long failed lookups are cached when the server sends no SOA record. Default is 60 seconds.
+	void set_negative_cache_ttl(int seconds);
+
+	/// \brief Sets the maximum time an answer is cached, regardless of its TTL. Default is one day.
+	void set_max_cache_ttl(int seconds);
+
+	/// \brief Removes all answers from the cache.
+	void clear_cache();
+
 	CL_DNSPacket perform_query(
 		CL_DNSPacket &packet,
 		int timeout,
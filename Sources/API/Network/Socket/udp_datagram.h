@@ -0,0 +1,103 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+/// \addtogroup clanNetwork_Socket clanNetwork Socket
+/// \{
+
+#pragma once
+
+#include "../api_network.h"
+
+class CL_SocketName;
+
+/// \brief Buffer and address of one datagram in a batched CL_UDPSocket send or receive.
+///
+/// The address is stored as a raw IPv4 address and port. Batches can then be sent and
+/// received without building a CL_SocketName for every datagram.
+///
+/// \xmlonly !group=Network/Socket! !header=network.h! \endxmlonly
+class CL_API_NETWORK CL_UDPDatagram
+{
+/// \name Construction
+/// \{
+
+public:
+	/// \brief Constructs an empty datagram
+	CL_UDPDatagram();
+
+	/// \brief Constructs a datagram receive buffer
+	///
+	/// \param buffer = Buffer receiving the datagram
+	/// \param buffer_size = Size of the buffer
+	CL_UDPDatagram(void *buffer, int buffer_size);
+
+	/// \brief Constructs a datagram to send
+	///
+	/// \param data = Datagram data
+	/// \param length = Length of the datagram
+	/// \param to = Destination, resolved once here
+	CL_UDPDatagram(const void *data, int length, const CL_SocketName &to);
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	/// \brief Returns the address as a socket name.
+	CL_SocketName get_address() const;
+
+	/// \brief Datagram data, or the buffer a received datagram is written to.
+	void *data;
+
+	/// \brief Size of the receive buffer.
+	int size;
+
+	/// \brief Length of the datagram to send, or of the received datagram.
+	int length;
+
+	/// \brief IPv4 address in host byte order. Destination for sends, source for receives.
+	unsigned int address;
+
+	/// \brief Port in host byte order.
+	unsigned short port;
+
+	/// \brief True if a received datagram was larger than the buffer and got cut off.
+	bool truncated;
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	/// \brief Set the address from a socket name, looking up host names if needed.
+	void set_address(const CL_SocketName &name);
+
+/// \}
+};
+
+/// \}
@@ -36,6 +36,7 @@
 
 class CL_Event;
 class CL_SocketName;
+class CL_UDPDatagram;
 class CL_UDPSocket_Impl;
 
 /// \brief UDP socket.
@@ -134,6 +135,27 @@ public:
 	/// \return int
 	int peek(void *data, int len, CL_SocketName &out_from);
 
+	/// \brief Send several datagrams with as few system calls as possible
+	///
+	/// On Linux the datagrams are passed to the kernel in batches with sendmmsg.
+	///
+	/// \param datagrams = Datagrams to send
+	/// \param count = Number of datagrams
+	///
+	/// \return Number of datagrams sent. Less than count if the send buffer filled up.
+	int send(const CL_UDPDatagram *datagrams, int count);
+
+	/// \brief Receive the datagrams that are queued on the socket
+	///
+	/// On Linux the datagrams are fetched from the kernel in batches with recvmmsg.
+	/// The length, address, port and truncated fields of the received datagrams are updated.
+	///
+	/// \param datagrams = Receive buffers
+	/// \param count = Maximum number of datagrams to receive
+	///
+	/// \return Number of datagrams received, or 0 if none were queued.
+	int receive(CL_UDPDatagram *datagrams, int count);
+
 /// \}
 /// \name Implementation
 /// \{
@@ -72,6 +72,21 @@ public:
 /// \{
 
 public:
+	/// \brief Sets how many prepared statements are kept on the server for reuse
+	///
+	/// Commands are prepared on the server the first time their SQL text is executed,
+	/// and later executions only send the parameters.
+	/// \param size = Number of statements kept, or 0 to send the SQL text every time. The default is 16.
+	void set_statement_cache_size(int size);
+
+	/// \brief Sets if query results are received in binary format
+	///
+	/// Binary results skip the text conversions on both the server and the client.
+	/// Statements are only received in binary format when the types of all their columns
+	/// can be decoded from it (booleans, integers, floats, text, bytea, date and timestamp),
+	/// and in text format otherwise. Requires a statement cache size above 0.
+	/// \param enable = True to receive binary results. The default is false.
+	void set_binary_results(bool enable);
 
 /// \}
 /// \name Implementation
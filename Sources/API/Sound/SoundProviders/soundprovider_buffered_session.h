@@ -0,0 +1,112 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+/// \addtogroup clanSound_Sound_Providers clanSound Sound Providers
+/// \{
+
+#pragma once
+
+#include "../api_sound.h"
+#include "soundprovider_session.h"
+
+class CL_InterlockedVariable;
+class CL_SoundProvider_Buffered_Session_Impl;
+
+/// \brief Sound provider session decoding another session ahead on a background thread.
+///
+///  <p>Streaming providers wrap their sessions in this class, so decoding and reading the
+///  compressed source never happens on the mixer thread. The decoded samples are kept in a
+///  ring of blocks shared between the decoder thread and the mixer without locks.</p>
+///  <p>If the mixer catches up with the decoder, the missing samples are played as silence
+///  and counted as an underrun. Looping is done by the decoder thread, so loops are gapless.
+///  Stopping the session keeps the decoded samples, as playback resumes where it stopped.</p>
+/// \xmlonly !group=Sound/Sound Providers! !header=sound.h! \endxmlonly
+class CL_API_SOUND CL_SoundProvider_Buffered_Session : public CL_SoundProvider_Session
+{
+/// \name Construction
+/// \{
+
+public:
+	/// \brief Constructs a buffered session.
+	///
+	/// Nothing is decoded until the session is played. The wrapped session is then started on the
+	/// decoder thread; reads come back short, without counting underruns, until it has caught up.
+	/// \param session = Session to decode from. It is started with play() and deleted by this object.
+	/// \param buffer_samples = Number of samples to decode ahead of playback.
+	/// \param underrun_counter = Optional counter incremented together with get_num_underruns().
+	CL_SoundProvider_Buffered_Session(CL_SoundProvider_Session *session, int buffer_samples = 65536, CL_InterlockedVariable *underrun_counter = 0);
+
+	~CL_SoundProvider_Buffered_Session();
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	int get_num_samples() const;
+	int get_frequency() const;
+	int get_position() const;
+	int get_num_channels() const;
+
+	/// \brief Returns how many times get_data had to pad with silence as the decoder fell behind.
+	int get_num_underruns() const;
+
+	/// \brief Returns the total number of silent samples inserted by underruns.
+	int get_num_underrun_samples() const;
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	bool set_looping(bool loop);
+	bool eof() const;
+	void stop();
+	bool play();
+
+	/// \brief Seeks the decoder. Samples already decoded are discarded.
+	///
+	/// Always succeeds; if the wrapped session cannot seek, decoding continues where it was.
+	bool set_position(int pos);
+
+	bool set_end_position(int pos);
+	int get_data(float **data_ptr, int data_requested);
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	CL_SoundProvider_Buffered_Session(const CL_SoundProvider_Buffered_Session &);
+	CL_SoundProvider_Buffered_Session &operator =(const CL_SoundProvider_Buffered_Session &);
+
+	CL_SharedPtr<CL_SoundProvider_Buffered_Session_Impl> impl;
+/// \}
+};
+
+/// \}
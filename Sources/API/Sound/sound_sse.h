@@ -77,17 +77,54 @@ public:
 	/// \brief Multiplies floats with a float
 	static void multiply_float(float *channel, int size, float volume);
 
+	/// \brief Multiplies floats with a volume changing linearly
+	///
+	/// Sample i is multiplied by 'start_volume + i * volume_step'.
+	static void multiply_float_ramp(float *channel, int size, float start_volume, float volume_step);
+
 	/// \brief Sets floats to a specific value
 	static void set_float(float *channel, int size, float value);
 
 	/// \brief Mixes one float channel with specified volume into another float channel
 	static void mix_one_to_one(float *input, int size, float *output, float volume);
 
+	/// \brief Mixes one float channel into another float channel while moving the volume from start_volume towards end_volume
+	///
+	/// Sample i is mixed with volume 'start_volume + (end_volume - start_volume) * (i + 1) / size'.
+	static void mix_one_to_one_ramp(float *input, int size, float *output, float start_volume, float end_volume);
+
+	/// \brief Runs a float channel through a feedback delay line
+	///
+	/// For each sample, 'delay[i] = delay[i] * feedback + channel[i]', and the new delay value replaces the channel sample.
+	static void feedback_delay(float *channel, float *delay, int size, float feedback);
+
 	/// \brief Mixes one float channel into many float channels with individual volumes for each channel
 	static void mix_one_to_many(float *input, int size, float **output, float *volume, int channels);
 
 	/// \brief Mixes many float channels into one float channel with individual volumes for each channel
 	static void mix_many_to_one(float **input, float *volume, int channels, int size, float *output);
+
+	/// \brief Resamples a float channel by picking the nearest preceding sample
+	///
+	/// Output sample i is read from input position 'position + i * step'. Position must not be negative.
+	static void resample_nearest(float *input, double position, double step, float *output, int size);
+
+	/// \brief Resamples a float channel with linear interpolation
+	///
+	/// Reads one input sample past each position.
+	static void resample_linear(float *input, double position, double step, float *output, int size);
+
+	/// \brief Resamples a float channel with Catmull-Rom cubic interpolation
+	///
+	/// Reads one input sample before and two past each position.
+	static void resample_cubic(float *input, double position, double step, float *output, int size);
+
+	/// \brief Resamples a float channel with a polyphase FIR filter
+	///
+	/// The filter holds phases + 1 rows of taps coefficients, 16-byte aligned, where row j is
+	/// the filter for a fraction of j / phases between two input samples. Taps must be a multiple
+	/// of four. Reads taps / 2 - 1 input samples before and taps / 2 past each position.
+	static void resample_polyphase(float *input, double position, double step, float *filter, int taps, int phases, float *output, int size);
 /// \}
 };
 
@@ -0,0 +1,85 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+/// \addtogroup clanSound_Audio_Mixing clanSound Audio Mixing
+/// \{
+
+#pragma once
+
+#include "api_sound.h"
+#include "../Core/System/sharedptr.h"
+#include "../Core/Resources/resource_loader.h"
+#include "soundbuffer.h"
+
+class CL_SoundBufferLoadTask_Impl;
+
+/// \brief Resource loader task creating a soundbuffer from a sample resource.
+///
+/// <p>The sample file is opened and, unless the resource is streamed, decoded on a
+///    CL_ResourceLoader worker thread.</p>
+/// \xmlonly !group=Sound/Audio Mixing! !header=sound.h! \endxmlonly
+class CL_API_SOUND CL_SoundBufferLoadTask : public CL_ResourceLoadTask
+{
+/// \name Construction
+/// \{
+
+public:
+	/// \brief Constructs a soundbuffer load task
+	///
+	/// \param resource_id = Id of a resource of type 'sample'.
+	CL_SoundBufferLoadTask(const CL_String &resource_id);
+
+	~CL_SoundBufferLoadTask();
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	/// \brief Returns the loaded soundbuffer, or a null soundbuffer if the task has not finished.
+	CL_SoundBuffer get_soundbuffer() const;
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	void prepare(CL_ResourceManager &resources);
+
+	void load();
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	CL_SharedPtr<CL_SoundBufferLoadTask_Impl> impl;
+/// \}
+};
+
+/// \}
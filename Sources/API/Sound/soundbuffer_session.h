@@ -39,6 +39,25 @@ class CL_SoundFilter;
 class CL_SoundBuffer;
 class CL_SoundBuffer_Session_Impl;
 class CL_SoundOutput;
+class CL_SoundBus;
+
+/// \brief Interpolation used when a session plays at another frequency than the sound output.
+///
+/// \xmlonly !group=Sound/Audio Mixing! !header=sound.h! \endxmlonly
+enum CL_SoundResampling
+{
+	/// \brief Repeats or drops samples. Cheapest, but aliases audibly.
+	cl_resample_nearest,
+
+	/// \brief Linear interpolation between neighbouring samples.
+	cl_resample_linear,
+
+	/// \brief Catmull-Rom interpolation over four samples.
+	cl_resample_cubic,
+
+	/// \brief Band-limited polyphase windowed-sinc filter over sixteen samples.
+	cl_resample_sinc
+};
 
 /// \brief CL_SoundBuffer_Session provides control over a playing soundeffect.
 ///
@@ -88,6 +107,9 @@ public:
 	/// \brief Returns the frequency of the session.
 	int get_frequency() const;
 
+	/// \brief Returns the interpolation used to convert to the mixing frequency.
+	CL_SoundResampling get_resampling() const;
+
 	/// \brief Returns the linear relative volume of the soundeffect.
 	///
 	/// 0 means the soundeffect is muted, 1 means the soundeffect
@@ -105,6 +127,12 @@ public:
 	/// \return true if session should loop, false otherwise
 	bool get_looping() const;
 
+	/// \brief Returns true if volume and pan changes are spread over a fragment
+	bool get_volume_ramping() const;
+
+	/// \brief Returns the bus the session is mixed into, or a null bus if it is mixed directly into the sound output.
+	CL_SoundBus get_bus() const;
+
 	/// \brief Returns true if the session is playing
 	bool is_playing();
 
@@ -115,8 +143,11 @@ public:
 public:
 	/// \brief Sets the session position to 'new_pos'.
 	///
+	/// Like all other changes to a session, the mixer applies the new position at the
+	///    start of the next fragment it mixes.
+	///
 	/// \param new_pos = The new position of the session.
-	/// \return Returns true if operation completed succesfully.
+	/// \return Returns false if the position is negative.
 	bool set_position(int new_pos);
 
 	/// \brief Sets the relative position of the session.
@@ -133,7 +164,7 @@ public:
 	///
 	/// \param pos = End position.
 	///
-	/// \return True for success. False otherwise.
+	/// \return Returns false if the position is negative.
 	bool set_end_position(int pos);
 
 	/// \brief Sets the frequency of the session.
@@ -141,6 +172,13 @@ public:
 	/// \param new_freq New frequency of session.
 	void set_frequency(int new_freq);
 
+	/// \brief Sets the interpolation used to convert to the mixing frequency.
+	///
+	/// The default is cl_resample_cubic. Sessions playing at the mixing frequency are copied
+	/// without resampling regardless of this setting.
+	/// \param resampling = Interpolation mode
+	void set_resampling(CL_SoundResampling resampling);
+
 	/// \brief Sets the volume of the session in a relative measure (0->1)
 	///
 	/// A value of 0 will effectively mute the sound (although it will
@@ -160,6 +198,12 @@ public:
 	///    \return Returns true if the operation completed sucecsfully.
 	void set_pan(float new_pan);
 
+	/// \brief Spreads volume and pan changes over one fragment to avoid zipper noise.
+	///
+	/// Disabled by default, in which case changes take effect at the start of the next fragment.
+	/// \param enable = true to ramp volume changes
+	void set_volume_ramping(bool enable);
+
 	/// \brief Starts playback of the session.
 	void play();
 
@@ -179,6 +223,11 @@ public:
 	/// \brief Remove the sound filter from the session. See CL_SoundFilter for details.
 	void remove_filter(CL_SoundFilter &filter);
 
+	/// \brief Routes the session through a bus. See CL_SoundBus for details.
+	///
+	/// \param bus = Bus of the same sound output, or a null bus to mix directly into the sound output
+	void set_bus(const CL_SoundBus &bus);
+
 /// \}
 /// \name Implementation
 /// \{
@@ -189,6 +238,7 @@ private:
 
 	friend class CL_SoundBuffer;
 	friend class CL_SoundOutput_Impl;
+	friend class CL_SoundMixPool;
 /// \}
 };
 
@@ -0,0 +1,146 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+**    Mark Page
+*/
+
+/// \addtogroup clanSound_Audio_Mixing clanSound Audio Mixing
+/// \{
+
+#pragma once
+
+#include "api_sound.h"
+#include "../Core/System/sharedptr.h"
+
+class CL_SoundOutput;
+class CL_SoundFilter;
+class CL_SoundBus_Impl;
+
+/// \brief CL_SoundBus mixes soundbuffer sessions and other buses into a sub-mix.
+///
+///    <p>Sessions routed to a bus with CL_SoundBuffer_Session::set_bus() are summed
+///    first, and the filters of the bus then run once on the sum. An echo on a bus
+///    shared by many sessions therefore costs the same as on a single session.</p>
+///    <p>A bus mixes into its parent bus, or directly into the sound output if it has
+///    none. Buses that do not feed each other are filtered in parallel when the
+///    filters take a noticeable part of the fragment.</p>
+///    <p>A filter object must only be attached to one bus or session at a time.</p>
+/// \xmlonly !group=Sound/Audio Mixing! !header=sound.h! \endxmlonly
+class CL_API_SOUND CL_SoundBus
+{
+/// \name Construction
+/// \{
+
+public:
+	/// \brief Constructs a null instance
+	CL_SoundBus();
+
+	/// \brief Constructs a bus mixing into the sound output
+	///
+	/// \param output = Sound output the bus belongs to
+	CL_SoundBus(CL_SoundOutput &output);
+
+	/// \brief Constructs a bus mixing into another bus
+	///
+	/// \param output = Sound output the bus belongs to
+	/// \param parent = Bus the sub-mix is mixed into, or a null bus to mix into the sound output
+	CL_SoundBus(CL_SoundOutput &output, const CL_SoundBus &parent);
+
+	~CL_SoundBus();
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	/// \brief Returns true if this object is invalid.
+	bool is_null() const { return !impl; }
+
+	/// \brief Throw an exception if this object is invalid.
+	void throw_if_null() const;
+
+	/// \brief Returns the bus this bus mixes into, or a null bus if it mixes into the sound output.
+	CL_SoundBus get_parent() const;
+
+	/// \brief Returns the linear volume the sub-mix is mixed with.
+	float get_volume() const;
+
+	/// \brief Returns the pan of the sub-mix (in a measure from -1 -> 1).
+	float get_pan() const;
+
+/// \}
+/// \name Operators
+/// \{
+
+public:
+	/// \brief Equality operator
+	bool operator==(const CL_SoundBus &other) const
+	{
+		return impl==other.impl;
+	}
+
+	/// \brief Inequality operator
+	bool operator!=(const CL_SoundBus &other) const
+	{
+		return impl!=other.impl;
+	}
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	/// \brief Sets the volume the sub-mix is mixed with.
+	///
+	/// Changes are spread over one fragment to avoid zipper noise.
+	/// \param new_volume = Linear volume, from 0 (muted) to 1
+	void set_volume(float new_volume);
+
+	/// \brief Sets the pan of the sub-mix.
+	///
+	/// \param new_pan = -1 for the left speaker only, 0 for center, and 1 for the right speaker only
+	void set_pan(float new_pan);
+
+	/// \brief Adds a sound filter run on the sub-mix. Filters run in the order they were added.
+	void add_filter(CL_SoundFilter &filter);
+
+	/// \brief Removes a sound filter from the bus.
+	void remove_filter(CL_SoundFilter &filter);
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	CL_SoundBus(const CL_SharedPtr<CL_SoundBus_Impl> &impl);
+
+	CL_SharedPtr<CL_SoundBus_Impl> impl;
+
+	friend class CL_SoundBuffer_Session;
+/// \}
+};
+
+/// \}
@@ -35,12 +35,39 @@
 #include "../Core/Text/string_types.h"
 #include "../Core/System/sharedptr.h"
 #include "../Core/System/weakptr.h"
+#include "../Core/System/cl_platform.h"
 
 class CL_SoundFilter;
 class CL_SoundBuffer;
 class CL_SoundOutput_Description;
 class CL_SoundOutput_Impl;
 
+/// \brief Mixing time measurements of a sound output.
+///
+/// All times are in microseconds and only include mixing, not writing to the device.
+/// \xmlonly !group=Sound/Audio Mixing! !header=sound.h! \endxmlonly
+struct CL_SoundOutput_Statistics
+{
+	CL_SoundOutput_Statistics()
+	: fragment_size(0), num_fragments(0), num_late_fragments(0), total_mix_time(0), min_mix_time(0), max_mix_time(0), last_mix_time(0)
+	{
+	}
+
+	/// \brief Number of stereo samples in each fragment.
+	int fragment_size;
+
+	/// \brief Number of fragments mixed.
+	int num_fragments;
+
+	/// \brief Number of fragments that took longer to mix than they take to play.
+	int num_late_fragments;
+
+	cl_ubyte64 total_mix_time;
+	int min_mix_time;
+	int max_mix_time;
+	int last_mix_time;
+};
+
 /// \brief SoundOutput interface in ClanLib.
 ///
 ///   <p>CL_SoundOutput is the interface to a sound output device. It is used to
@@ -94,6 +121,9 @@ public:
 	/// \brief Returns the main panning position of the sound output.
 	float get_global_pan() const;
 
+	/// \brief Returns the mixing times measured since the output was created or the statistics were reset.
+	CL_SoundOutput_Statistics get_statistics() const;
+
 /// \}
 /// \name Operations
 /// \{
@@ -116,6 +146,17 @@ public:
 	/// \brief Remove the sound filter from the session.
 	void remove_filter(CL_SoundFilter &filter);
 
+	/// \brief Clears the mixing time measurements.
+	void reset_statistics();
+
+	/// \brief Mixes fragments on the calling thread.
+	///
+	/// Only available for offline sound outputs with an offline speed of 0. Session changes
+	/// made before the call apply from the first fragment rendered. Making changes never waits
+	/// for this call, however many are made in between.
+	/// \param num_fragments = Number of fragments to mix and write.
+	void render_fragments(int num_fragments);
+
 /// \}
 /// \name Implementation
 /// \{
@@ -132,6 +173,7 @@ private:
 	friend class CL_SoundBuffer;
 	friend class CL_Sound;
 	friend class CL_SoundBuffer_Session;
+	friend class CL_SoundBus;
 /// \}
 };
 
@@ -33,6 +33,7 @@
 
 #include "api_sound.h"
 #include "../Core/System/sharedptr.h"
+#include "../Core/Text/string_types.h"
 
 class CL_SoundOutput_Description_Impl;
 
@@ -61,6 +62,15 @@ public:
 	/// \brief Returns the mixing latency in milliseconds.
 	int get_mixing_latency() const;
 
+	/// \brief Returns true if the sound output renders without a sound device.
+	bool is_offline() const;
+
+	/// \brief Returns the offline rendering speed relative to realtime, or 0 if rendering on request.
+	float get_offline_speed() const;
+
+	/// \brief Returns the WAV file offline rendering writes to, or an empty string.
+	CL_String get_offline_filename() const;
+
 /// \}
 /// \name Operations
 /// \{
@@ -72,6 +82,21 @@ public:
 	/// \brief Sets the mixing latency in milliseconds.
 	void set_mixing_latency(int latency);
 
+	/// \brief Renders without a sound device, for example for tests and benchmarks.
+	///
+	/// The fragment size is given by the mixing latency.
+	void set_offline(bool enable);
+
+	/// \brief Sets the offline rendering speed relative to realtime.
+	///
+	/// With a speed of 0 (the default), no mixer thread is started and fragments are only
+	/// rendered by CL_SoundOutput::render_fragments(), as fast as possible.
+	/// Otherwise a mixer thread renders fragments paced at the given speed, 1.0 being realtime.
+	void set_offline_speed(float speed);
+
+	/// \brief Sets a WAV file (16 bit stereo) for offline rendering to write to. Empty discards the output.
+	void set_offline_filename(const CL_String &filename);
+
 /// \}
 /// \name Implementation
 /// \{
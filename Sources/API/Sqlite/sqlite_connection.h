@@ -62,6 +62,18 @@ public:
 /// \{
 
 public:
+	/// \brief Sets how long to wait for another connection to release a lock
+	///
+	/// Commands fail with a "Database Busy!" exception when the lock is not released in time.
+	/// \param milliseconds = Maximum time to wait. The default is 1000 ms.
+	void set_busy_timeout(int milliseconds);
+
+	/// \brief Sets how many prepared statements are kept for reuse
+	///
+	/// Creating a command with the same SQL text as a destroyed command reuses its
+	/// prepared statement instead of compiling the SQL again.
+	/// \param size = Number of statements kept, or 0 to disable the cache. The default is 16.
+	void set_statement_cache_size(int size);
 
 /// \}
 /// \name Implementation
@@ -51,7 +51,7 @@ public:
 	///
 	/// \param filename Filename of module file.
 	/// \param provider Input source provider used to retrieve module file.
-	/// \param stream If true, will stream from disk. If false, will load it to memory.
+	/// \param stream If true, will stream from disk, decoding ahead on a background thread. If false, will load it to memory.
 	CL_SoundProvider_Vorbis(
 		const CL_String &filename,
 		const CL_VirtualDirectory &directory,
@@ -67,11 +67,24 @@ public:
 
 	virtual ~CL_SoundProvider_Vorbis();
 
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	/// \brief Returns how many times streamed sessions ran out of decoded samples.
+	int get_num_underruns() const;
+
 /// \}
 /// \name Operations
 /// \{
 
 public:
+	/// \brief Sets how many samples streamed sessions decode ahead of playback.
+	///
+	/// Only affects sessions started after the call.
+	void set_stream_buffer_size(int samples);
+
 	/// \brief Called by CL_SoundBuffer when a new session starts.
 	/** \return The soundbuffer session to be attached to the newly started session.*/
 	virtual CL_SoundProvider_Session *begin_session();
@@ -65,6 +65,7 @@
 #include "Core/Text/console_logger.h"
 #include "Core/Text/logger.h"
 #include "Core/Text/string_format.h"
+#include "Core/Text/string_format_buffer.h"
 #include "Core/Text/string_help.h"
 #include "Core/Text/string_allocator.h"
 #include "Core/Text/utf8_reader.h"
@@ -120,6 +121,7 @@
 #include "Core/Resources/resource.h"
 #include "Core/Resources/resource_manager.h"
 #include "Core/Resources/resource_data_session.h"
+#include "Core/Resources/resource_loader.h"
 #include "Core/XML/dom_processing_instruction.h"
 #include "Core/XML/dom_entity_reference.h"
 #include "Core/XML/dom_notation.h"
@@ -140,9 +142,11 @@
 #include "Core/XML/dom_element.h"
 #include "Core/XML/dom_string.h"
 #include "Core/XML/xml_tokenizer.h"
+#include "Core/XML/xml_reader.h"
 #include "Core/XML/xml_writer.h"
 #include "Core/XML/xml_token.h"
 #include "Core/XML/xpath_evaluator.h"
+#include "Core/XML/xpath_expression.h"
 #include "Core/XML/xpath_object.h"
 #include "Core/CSS/css_document.h"
 #include "Core/CSS/css_property.h"
@@ -196,6 +200,7 @@
 #include "Core/Math/quad.h"
 #include "Core/Math/rect.h"
 #include "Core/Math/rect_packer.h"
+#include "Core/Math/region.h"
 #include "Core/Math/size.h"
 #include "Core/Math/triangle_math.h"
 #include "Core/Math/line.h"
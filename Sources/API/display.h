@@ -52,11 +52,13 @@
 #include "Display/2D/rounded_rect.h"
 #include "Display/2D/sprite.h"
 #include "Display/2D/sprite_description.h"
+#include "Display/2D/sprite_load_task.h"
 #include "Display/2D/subtexture.h"
 #include "Display/2D/texture_group.h"
 #include "Display/2D/span_layout.h"
 #include "Display/2D/collidable_sprite.h"
 #include "Display/Collision/collision_outline.h"
+#include "Display/Collision/collision_world.h"
 #include "Display/Collision/contour.h"
 #include "Display/Collision/outline_accuracy.h"
 #include "Display/Collision/outline_circle.h"
@@ -106,6 +108,7 @@
 #include "Display/Render/shader_object.h"
 #include "Display/Render/shared_gc_data.h"
 #include "Display/Render/texture.h"
+#include "Display/Render/texture_load_task.h"
 #include "Display/Render/vertex_array_buffer.h"
 #include "Display/TargetProviders/cursor_provider.h"
 #include "Display/TargetProviders/display_target_provider.h"
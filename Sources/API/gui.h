@@ -72,6 +72,7 @@
 #include "GUI/Components/listview.h"
 #include "GUI/Components/listview_header.h"
 #include "GUI/Components/listview_column_data.h"
+#include "GUI/Components/listview_model.h"
 #include "GUI/Components/main_window.h"
 #include "GUI/Components/menubar.h"
 #include "GUI/Components/message_box.h"
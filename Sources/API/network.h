@@ -48,6 +48,7 @@
 #include "Network/Socket/socket_name.h"
 #include "Network/Socket/tcp_connection.h"
 #include "Network/Socket/tcp_listen.h"
+#include "Network/Socket/udp_datagram.h"
 #include "Network/Socket/udp_socket.h"
 
 #include "Network/Web/web_request.h"
@@ -47,8 +47,11 @@
 #include "Sound/soundformat.h"
 #include "Sound/SoundProviders/soundprovider.h"
 #include "Sound/SoundProviders/soundprovider_session.h"
+#include "Sound/SoundProviders/soundprovider_buffered_session.h"
 #include "Sound/soundbuffer.h"
+#include "Sound/soundbuffer_load_task.h"
 #include "Sound/soundbuffer_session.h"
+#include "Sound/soundbus.h"
 #include "Sound/soundfilter.h"
 #include "Sound/cd_drive.h"
 #include "Sound/sound_sse.h"
@@ -31,7 +31,7 @@
 #include "API/CSSLayout/css_layout_user_data.h"
 
 CL_CSSBoxNode::CL_CSSBoxNode()
-: parent(0), next(0), prev(0), first_child(0), last_child(0)
+: parent(0), next(0), prev(0), first_child(0), last_child(0), style_dirty(true), child_style_dirty(false), layout_dirty(true)
 {
 }
 
@@ -80,10 +80,16 @@ void CL_CSSBoxNode::insert(CL_CSSBoxNode *new_child, CL_CSSBoxNode *insert_point
 		if (!first_child)
 			first_child = new_child;
 	}
+
+	// A moved node inherits from a new parent and may match different selectors:
+	new_child->set_style_dirty();
 }
 
 void CL_CSSBoxNode::remove()
 {
+	if (parent)
+		parent->set_layout_dirty();
+
 	if (prev)
 		prev->next = next;
 
@@ -115,3 +121,31 @@ const CL_CSSLayoutUserData *CL_CSSBoxNode::get_user_data() const
 {
 	return user_data.get();
 }
+
+void CL_CSSBoxNode::set_style_dirty()
+{
+	style_dirty = true;
+	for (CL_CSSBoxNode *cur = parent; cur && !cur->child_style_dirty; cur = cur->parent)
+		cur->child_style_dirty = true;
+	set_layout_dirty();
+}
+
+void CL_CSSBoxNode::set_layout_dirty()
+{
+	// New nodes start out dirty, so always walk up to the first dirty ancestor
+	layout_dirty = true;
+	for (CL_CSSBoxNode *cur = parent; cur && !cur->layout_dirty; cur = cur->parent)
+		cur->layout_dirty = true;
+}
+
+void CL_CSSBoxNode::clear_dirty()
+{
+	if (layout_dirty || style_dirty || child_style_dirty)
+	{
+		style_dirty = false;
+		child_style_dirty = false;
+		layout_dirty = false;
+		for (CL_CSSBoxNode *child = first_child; child; child = child->next)
+			child->clear_dirty();
+	}
+}
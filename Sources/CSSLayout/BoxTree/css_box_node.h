@@ -46,6 +46,19 @@ public:
 	CL_CSSLayoutUserData *get_user_data();
 	const CL_CSSLayoutUserData *get_user_data() const;
 
+	/// \brief Flags this node for a restyle and its ancestors for a relayout
+	void set_style_dirty();
+
+	/// \brief Flags this node and its ancestors for a relayout
+	void set_layout_dirty();
+
+	/// \brief Clears the dirty flags of this node and all dirty descendants
+	void clear_dirty();
+
+	bool is_style_dirty() const { return style_dirty; }
+	bool is_child_style_dirty() const { return child_style_dirty; }
+	bool is_layout_dirty() const { return layout_dirty; }
+
 	CL_CSSBoxNode *get_parent() { return parent; }
 	CL_CSSBoxNode *get_next_sibling() { return next; }
 	CL_CSSBoxNode *get_prev_sibling() { return prev; }
@@ -65,4 +78,7 @@ private:
 	CL_CSSBoxNode *first_child;
 	CL_CSSBoxNode *last_child;
 	CL_UniquePtr<CL_CSSLayoutUserData> user_data;
+	bool style_dirty;
+	bool child_style_dirty;
+	bool layout_dirty;
 };
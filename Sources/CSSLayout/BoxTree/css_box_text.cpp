@@ -36,6 +36,7 @@ void CL_CSSBoxText::set_text(const CL_String &new_text)
 	processed_text = text;
 	processed_selection_start = selection_start;
 	processed_selection_end = selection_end;
+	set_layout_dirty();
 }
 
 const CL_CSSBoxElement *CL_CSSBoxText::get_parent_element() const
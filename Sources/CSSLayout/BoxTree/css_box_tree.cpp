@@ -49,6 +49,8 @@ void CL_CSSBoxTree::set_root_element(CL_CSSBoxElement *new_root_element)
 {
 	clear();
 	root_element = new_root_element;
+	if (root_element)
+		root_element->set_style_dirty();
 }
 
 void CL_CSSBoxTree::set_html_body_element(CL_CSSBoxElement *new_html_body_element)
@@ -68,9 +70,19 @@ void CL_CSSBoxTree::create(const CL_DomNode &node)
 	}
 }
 
+bool CL_CSSBoxTree::is_dirty() const
+{
+	return root_element && root_element->is_layout_dirty();
+}
+
 void CL_CSSBoxTree::prepare(CL_CSSResourceCache *resource_cache)
 {
 	clean();
+
+	// The root background may hold a copy of the body background from the last pass
+	if (html_body_element && html_body_element != root_element && html_body_element->is_style_dirty())
+		root_element->set_style_dirty();
+
 	compute_element(root_element, resource_cache);
 	propagate_html_body();
 	convert_run_in_blocks(root_element);
@@ -78,6 +90,12 @@ void CL_CSSBoxTree::prepare(CL_CSSResourceCache *resource_cache)
 	filter_table(resource_cache);
 }
 
+void CL_CSSBoxTree::clear_dirty()
+{
+	if (root_element)
+		root_element->clear_dirty();
+}
+
 void CL_CSSBoxTree::clean(CL_CSSBoxNode *node)
 {
 	if (node == 0)
@@ -153,6 +171,7 @@ void CL_CSSBoxTree::apply_properties(CL_CSSBoxElement *node, const CL_CSSPropert
 {
 	for (size_t i = css_properties.size(); i > 0; i--)
 		property_parsers.parse(node->properties, css_properties[i-1]);
+	node->set_style_dirty();
 }
 
 CL_CSSBoxProperties CL_CSSBoxTree::get_css_properties(const CL_DomElement &element, const CL_String &pseudo_element)
@@ -164,22 +183,34 @@ CL_CSSBoxProperties CL_CSSBoxTree::get_css_properties(const CL_DomElement &eleme
 	return properties;
 }
 
-void CL_CSSBoxTree::compute_element(CL_CSSBoxElement *element, CL_CSSResourceCache *resource_cache)
+void CL_CSSBoxTree::compute_element(CL_CSSBoxElement *element, CL_CSSResourceCache *resource_cache, bool parent_restyled)
 {
-	CL_CSSBoxProperties *parent_properties = 0;
-	CL_CSSBoxNode *parent_node = element->get_parent();
-	if (parent_node)
-		parent_properties = &dynamic_cast<CL_CSSBoxElement*>(parent_node)->computed_properties;
+	// Only restyle elements that changed, and everything inheriting from them
+	bool restyle = parent_restyled || element->is_style_dirty();
+	if (restyle)
+	{
+		CL_CSSBoxProperties *parent_properties = 0;
+		CL_CSSBoxNode *parent_node = element->get_parent();
+		if (parent_node)
+			parent_properties = &dynamic_cast<CL_CSSBoxElement*>(parent_node)->computed_properties;
+
+		element->computed_properties = element->properties;
+		element->computed_properties.compute(parent_properties, resource_cache);
 
-	element->computed_properties = element->properties;
-	element->computed_properties.compute(parent_properties, resource_cache);
+		// Inherited values may change how the element is laid out
+		element->set_layout_dirty();
+	}
+	else if (!element->is_child_style_dirty())
+	{
+		return;
+	}
 
 	CL_CSSBoxNode *cur = element->get_first_child();
 	while (cur)
 	{
 		CL_CSSBoxElement *cur_element = dynamic_cast<CL_CSSBoxElement*>(cur);
 		if (cur_element)
-			compute_element(cur_element, resource_cache);
+			compute_element(cur_element, resource_cache, restyle);
 		cur = cur->get_next_sibling();
 	}
 }
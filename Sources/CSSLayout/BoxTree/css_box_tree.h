@@ -46,6 +46,10 @@ public:
 	void set_root_element(CL_CSSBoxElement *new_root_element);
 	void set_html_body_element(CL_CSSBoxElement *new_html_body_element);
 	void prepare(CL_CSSResourceCache *resource_cache);
+	bool is_dirty() const;
+
+	/// \brief Clears the dirty flags once the layout tree has been created from the prepared tree.
+	void clear_dirty();
 	void apply_properties(CL_CSSBoxElement *node, const CL_CSSPropertyList2 &properties);
 	void set_selection(CL_CSSBoxNode *start, size_t start_text_offset, CL_CSSBoxNode *end, size_t end_text_offset);
 
@@ -60,7 +64,7 @@ private:
 	CL_CSSBoxNode *create_node(const CL_DomNode &node);
 	void create_pseudo_element(CL_CSSBoxElement *box_element, const CL_DomElement &dom_element, const CL_String &pseudo_element);
 	CL_CSSBoxProperties get_css_properties(const CL_DomElement &element, const CL_String &pseudo_element = CL_String());
-	void compute_element(CL_CSSBoxElement *element, CL_CSSResourceCache *resource_cache);
+	void compute_element(CL_CSSBoxElement *element, CL_CSSResourceCache *resource_cache, bool parent_restyled = false);
 	void propagate_html_body();
 	void create_anonymous_blocks(CL_CSSBoxElement *element, CL_CSSResourceCache *resource_cache);
 	void filter_table(CL_CSSResourceCache *resource_cache);
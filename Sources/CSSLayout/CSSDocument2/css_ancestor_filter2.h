@@ -0,0 +1,49 @@
+
+#pragma once
+
+// Bloom filter of the element names, ids and classes of a node's ancestors.
+// Used to reject descendant and child selectors without walking the tree.
+class CL_CSSAncestorFilter2
+{
+public:
+	CL_CSSAncestorFilter2() { clear(); }
+
+	void clear()
+	{
+		for (int i = 0; i < num_words; i++)
+			bits[i] = 0;
+	}
+
+	void add(unsigned int hash)
+	{
+		unsigned int bit1 = hash & (num_bits - 1);
+		unsigned int bit2 = (hash >> 16) & (num_bits - 1);
+		bits[bit1 >> 5] |= 1 << (bit1 & 31);
+		bits[bit2 >> 5] |= 1 << (bit2 & 31);
+	}
+
+	bool may_contain(unsigned int hash) const
+	{
+		unsigned int bit1 = hash & (num_bits - 1);
+		unsigned int bit2 = (hash >> 16) & (num_bits - 1);
+		return (bits[bit1 >> 5] & (1 << (bit1 & 31))) && (bits[bit2 >> 5] & (1 << (bit2 & 31)));
+	}
+
+	static unsigned int hash(char prefix, const CL_String &text)
+	{
+		// FNV-1a
+		unsigned int h = 2166136261U;
+		h = (h ^ (unsigned char)prefix) * 16777619U;
+		for (CL_String::size_type i = 0; i < text.length(); i++)
+			h = (h ^ (unsigned char)text[i]) * 16777619U;
+		return h;
+	}
+
+private:
+	enum
+	{
+		num_bits = 512,
+		num_words = num_bits / 32
+	};
+	unsigned int bits[num_words];
+};
@@ -80,6 +80,11 @@ CL_CSSPropertyList2 CL_CSSDocument2::select(CL_CSSSelectNode2 *node, const CL_St
 	return properties;
 }
 
+void CL_CSSDocument2::set_selector_index_enabled(bool enable)
+{
+	impl->index_enabled = enable;
+}
+
 CL_CSSPropertyList2 CL_CSSDocument2::get_style_properties(const CL_String &style_string, const CL_String &base_uri)
 {
 	CL_CSSTokenizer tokenizer(style_string);
@@ -29,8 +29,135 @@
 #include "CSSLayout/precomp.h"
 #include "css_document2_impl.h"
 #include "API/Core/IOData/html_url.h"
+#include "API/Core/System/uniqueptr.h"
 
 std::vector<CL_CSSRulesetMatch2> CL_CSSDocument2_Impl::select_rulesets(CL_CSSSelectNode2 *node, const CL_String &pseudo_element)
+{
+	if (!index_enabled)
+		return select_rulesets_unindexed(node, pseudo_element);
+
+	if (index_dirty)
+		update_index();
+
+	CL_String node_name = CL_StringHelp::text_to_lower(node->name());
+	CL_String node_id = node->id();
+	std::vector<CL_String> node_classes = node->element_classes();
+	std::vector<CL_String> node_pseudo_classes = node->pseudo_classes();
+	for (size_t i = 0; i < node_classes.size(); i++)
+		node_classes[i] = CL_StringHelp::text_to_lower(node_classes[i]);
+	for (size_t i = 0; i < node_pseudo_classes.size(); i++)
+		node_pseudo_classes[i] = CL_StringHelp::text_to_lower(node_pseudo_classes[i]);
+	std::sort(node_classes.begin(), node_classes.end());
+	std::sort(node_pseudo_classes.begin(), node_pseudo_classes.end());
+
+	CL_String key = CL_StringHelp::text_to_lower(pseudo_element) + "\n" + node_name + "\n" + node_id + "\n" + node->lang() + "\n";
+	for (size_t i = 0; i < node_classes.size(); i++)
+		key += "." + node_classes[i];
+	key += "\n";
+	for (size_t i = 0; i < node_pseudo_classes.size(); i++)
+		key += ":" + node_pseudo_classes[i];
+
+	std::map<CL_String, SelectCacheEntry>::iterator it_cache = select_cache.find(key);
+	if (it_cache == select_cache.end())
+	{
+		if (select_cache.size() >= max_select_cache_size)
+			select_cache.clear();
+
+		SelectCacheEntry entry;
+		std::map<CL_String, std::vector<ChainRef> >::iterator it;
+		if (!node_id.empty())
+		{
+			it = id_index.find(node_id);
+			if (it != id_index.end())
+				entry.candidates.insert(entry.candidates.end(), it->second.begin(), it->second.end());
+		}
+		for (size_t i = 0; i < node_classes.size(); i++)
+		{
+			if (i > 0 && node_classes[i] == node_classes[i-1])
+				continue;
+			it = class_index.find(node_classes[i]);
+			if (it != class_index.end())
+				entry.candidates.insert(entry.candidates.end(), it->second.begin(), it->second.end());
+		}
+		it = element_index.find(node_name);
+		if (it != element_index.end())
+			entry.candidates.insert(entry.candidates.end(), it->second.begin(), it->second.end());
+		entry.candidates.insert(entry.candidates.end(), universal_index.begin(), universal_index.end());
+
+		// Remove chains for other pseudo elements and restore document order:
+		std::vector<ChainRef> candidates;
+		for (size_t i = 0; i < entry.candidates.size(); i++)
+		{
+			const CL_CSSSelectorChain2 &chain = rulesets[entry.candidates[i].ruleset_index].selectors[entry.candidates[i].chain_index];
+			if (equals(chain.pseudo_element, pseudo_element))
+			{
+				candidates.push_back(entry.candidates[i]);
+				if (!is_context_free(chain))
+					entry.context_free = false;
+			}
+		}
+		std::sort(candidates.begin(), candidates.end());
+		entry.candidates.swap(candidates);
+
+		it_cache = select_cache.insert(std::pair<CL_String, SelectCacheEntry>(cl_move(key), cl_move(entry))).first;
+	}
+	else if (it_cache->second.context_free)
+	{
+		return it_cache->second.matches;
+	}
+
+	SelectCacheEntry &entry = it_cache->second;
+
+	CL_CSSAncestorFilter2 ancestor_filter;
+	bool ancestor_filter_built = false;
+
+	std::vector<CL_CSSRulesetMatch2> matched_rulesets;
+	size_t last_matched_ruleset = (size_t)-1;
+	for (size_t i = 0; i < entry.candidates.size(); i++)
+	{
+		const ChainRef &ref = entry.candidates[i];
+		if (ref.ruleset_index == last_matched_ruleset)
+			continue;
+
+		CL_CSSRuleset2 &cur_ruleset = rulesets[ref.ruleset_index];
+		const CL_CSSSelectorChain2 &chain = cur_ruleset.selectors[ref.chain_index];
+
+		if (!chain.ancestor_hashes.empty())
+		{
+			if (!ancestor_filter_built)
+			{
+				build_ancestor_filter(node, ancestor_filter);
+				ancestor_filter_built = true;
+			}
+
+			bool rejected = false;
+			for (size_t k = 0; k < chain.ancestor_hashes.size(); k++)
+			{
+				if (!ancestor_filter.may_contain(chain.ancestor_hashes[k]))
+				{
+					rejected = true;
+					break;
+				}
+			}
+			if (rejected)
+				continue;
+		}
+
+		if (try_match_chain(chain, node, chain.links.size()))
+		{
+			matched_rulesets.push_back(CL_CSSRulesetMatch2(&cur_ruleset, ref.chain_index, matched_rulesets.size()));
+			last_matched_ruleset = ref.ruleset_index;
+		}
+	}
+	std::sort(matched_rulesets.begin(), matched_rulesets.end());
+
+	if (entry.context_free)
+		entry.matches = matched_rulesets;
+
+	return matched_rulesets;
+}
+
+std::vector<CL_CSSRulesetMatch2> CL_CSSDocument2_Impl::select_rulesets_unindexed(CL_CSSSelectNode2 *node, const CL_String &pseudo_element)
 {
 	std::vector<CL_CSSRulesetMatch2> matched_rulesets;
 	for (size_t i = 0; i < rulesets.size(); i++)
@@ -39,14 +166,10 @@ std::vector<CL_CSSRulesetMatch2> CL_CSSDocument2_Impl::select_rulesets(CL_CSSSel
 		for (size_t j = 0; j < cur_ruleset.selectors.size(); j++)
 		{
 			const CL_CSSSelectorChain2 &chain = cur_ruleset.selectors[j];
-			if (equals(chain.pseudo_element, pseudo_element))
+			if (equals(chain.pseudo_element, pseudo_element) && try_match_chain(chain, node, chain.links.size()))
 			{
-				bool matches = try_match_chain(chain, node, chain.links.size());
-				if (matches)
-				{
-					matched_rulesets.push_back(CL_CSSRulesetMatch2(&cur_ruleset, j, matched_rulesets.size()));
-					break;
-				}
+				matched_rulesets.push_back(CL_CSSRulesetMatch2(&cur_ruleset, j, matched_rulesets.size()));
+				break;
 			}
 		}
 	}
@@ -54,6 +177,89 @@ std::vector<CL_CSSRulesetMatch2> CL_CSSDocument2_Impl::select_rulesets(CL_CSSSel
 	return matched_rulesets;
 }
 
+void CL_CSSDocument2_Impl::update_index()
+{
+	id_index.clear();
+	class_index.clear();
+	element_index.clear();
+	universal_index.clear();
+	select_cache.clear();
+
+	for (size_t i = 0; i < rulesets.size(); i++)
+	{
+		for (size_t j = 0; j < rulesets[i].selectors.size(); j++)
+		{
+			CL_CSSSelectorChain2 &chain = rulesets[i].selectors[j];
+			add_ancestor_hashes(chain);
+
+			if (chain.links.empty())
+			{
+				universal_index.push_back(ChainRef(i, j));
+				continue;
+			}
+
+			const CL_CSSSelectorLink2 &link = chain.links.back();
+			if (!link.element_id.empty())
+				id_index[link.element_id].push_back(ChainRef(i, j));
+			else if (!link.element_classes.empty())
+				class_index[CL_StringHelp::text_to_lower(link.element_classes[0])].push_back(ChainRef(i, j));
+			else if (link.type == CL_CSSSelectorLink2::type_simple_selector)
+				element_index[CL_StringHelp::text_to_lower(link.element_name)].push_back(ChainRef(i, j));
+			else
+				universal_index.push_back(ChainRef(i, j));
+		}
+	}
+
+	index_dirty = false;
+}
+
+void CL_CSSDocument2_Impl::add_ancestor_hashes(CL_CSSSelectorChain2 &chain)
+{
+	// A selector to the left of a descendant or child combinator always
+	// matches an ancestor of the node, even if a sibling combinator follows.
+	chain.ancestor_hashes.clear();
+	for (size_t i = 0; i + 1 < chain.links.size(); i++)
+	{
+		const CL_CSSSelectorLink2 &link = chain.links[i];
+		const CL_CSSSelectorLink2 &combinator = chain.links[i + 1];
+		if (combinator.type != CL_CSSSelectorLink2::type_descendant_combinator && combinator.type != CL_CSSSelectorLink2::type_child_combinator)
+			continue;
+
+		if (link.type == CL_CSSSelectorLink2::type_simple_selector)
+			chain.ancestor_hashes.push_back(CL_CSSAncestorFilter2::hash('E', CL_StringHelp::text_to_lower(link.element_name)));
+		else if (link.type != CL_CSSSelectorLink2::type_universal_selector)
+			continue;
+
+		if (!link.element_id.empty())
+			chain.ancestor_hashes.push_back(CL_CSSAncestorFilter2::hash('#', link.element_id));
+		for (size_t k = 0; k < link.element_classes.size(); k++)
+			chain.ancestor_hashes.push_back(CL_CSSAncestorFilter2::hash('.', CL_StringHelp::text_to_lower(link.element_classes[k])));
+	}
+}
+
+void CL_CSSDocument2_Impl::build_ancestor_filter(CL_CSSSelectNode2 *node, CL_CSSAncestorFilter2 &filter)
+{
+	node->push();
+	while (node->parent())
+	{
+		filter.add(CL_CSSAncestorFilter2::hash('E', CL_StringHelp::text_to_lower(node->name())));
+		CL_String id = node->id();
+		if (!id.empty())
+			filter.add(CL_CSSAncestorFilter2::hash('#', id));
+		std::vector<CL_String> classes = node->element_classes();
+		for (size_t i = 0; i < classes.size(); i++)
+			filter.add(CL_CSSAncestorFilter2::hash('.', CL_StringHelp::text_to_lower(classes[i])));
+	}
+	node->pop();
+}
+
+bool CL_CSSDocument2_Impl::is_context_free(const CL_CSSSelectorChain2 &chain)
+{
+	// Chains consisting of a single selector without attribute tests only depend
+	// on the name, id, classes, pseudo classes and lang of the node itself.
+	return chain.links.size() <= 1 && (chain.links.empty() || chain.links[0].attribute_selectors.empty());
+}
+
 bool CL_CSSDocument2_Impl::try_match_chain(const CL_CSSSelectorChain2 &chain, CL_CSSSelectNode2 *node, size_t chain_index)
 {
 	bool matches = false;
@@ -241,6 +447,8 @@ bool CL_CSSDocument2_Impl::try_match_link(const CL_CSSSelectorLink2 &link, CL_CS
 void CL_CSSDocument2_Impl::read_stylesheet(CL_CSSTokenizer &tokenizer, const CL_String &new_base_uri)
 {
 	base_uri = new_base_uri;
+	index_dirty = true;
+	select_cache.clear();
 	CL_CSSToken token;
 	while (true)
 	{
@@ -36,13 +36,20 @@
 #include "css_selector_chain2.h"
 #include "css_selector_link2.h"
 #include "css_ruleset_match2.h"
+#include "css_ancestor_filter2.h"
 #include <algorithm>
+#include <map>
 
 class CL_CSSDocument2_Impl
 {
 public:
-	CL_CSSDocument2_Impl() : next_origin(0) { }
+	CL_CSSDocument2_Impl() : next_origin(0), index_enabled(true), index_dirty(true) { }
 	std::vector<CL_CSSRulesetMatch2> select_rulesets(CL_CSSSelectNode2 *node, const CL_String &pseudo_element);
+	std::vector<CL_CSSRulesetMatch2> select_rulesets_unindexed(CL_CSSSelectNode2 *node, const CL_String &pseudo_element);
+	void update_index();
+	void add_ancestor_hashes(CL_CSSSelectorChain2 &chain);
+	void build_ancestor_filter(CL_CSSSelectNode2 *node, CL_CSSAncestorFilter2 &filter);
+	bool is_context_free(const CL_CSSSelectorChain2 &chain);
 	bool try_match_chain(const CL_CSSSelectorChain2 &chain, CL_CSSSelectNode2 *node, size_t chain_index);
 	bool try_match_link(const CL_CSSSelectorLink2 &link, CL_CSSSelectNode2 *node);
 	void read_stylesheet(CL_CSSTokenizer &tokenizer, const CL_String &base_uri);
@@ -59,4 +66,41 @@ public:
 	CL_String base_uri;
 	std::vector<CL_CSSRuleset2> rulesets;
 	int next_origin;
+
+	// Reference to a selector chain in rulesets. Sorts in document order.
+	struct ChainRef
+	{
+		ChainRef(size_t ruleset_index, size_t chain_index) : ruleset_index(ruleset_index), chain_index(chain_index) { }
+		size_t ruleset_index;
+		size_t chain_index;
+
+		bool operator <(const ChainRef &other) const
+		{
+			if (ruleset_index == other.ruleset_index)
+				return chain_index < other.chain_index;
+			else
+				return ruleset_index < other.ruleset_index;
+		}
+		bool operator ==(const ChainRef &other) const { return ruleset_index == other.ruleset_index && chain_index == other.chain_index; }
+	};
+
+	// Selector chains bucketed by the id, first class or element name of their rightmost selector.
+	bool index_enabled;
+	bool index_dirty;
+	std::map<CL_String, std::vector<ChainRef> > id_index;
+	std::map<CL_String, std::vector<ChainRef> > class_index;
+	std::map<CL_String, std::vector<ChainRef> > element_index;
+	std::vector<ChainRef> universal_index;
+
+	// Candidate chains for nodes sharing the same name, id, classes, pseudo classes, lang and pseudo element.
+	// If none of the candidates look beyond the node itself, the matched rulesets are cached as well.
+	struct SelectCacheEntry
+	{
+		SelectCacheEntry() : context_free(true) { }
+		std::vector<ChainRef> candidates;
+		bool context_free;
+		std::vector<CL_CSSRulesetMatch2> matches;
+	};
+	std::map<CL_String, SelectCacheEntry> select_cache;
+	enum { max_select_cache_size = 4096 };
 };
@@ -8,6 +8,7 @@ class CL_CSSSelectorChain2
 public:
 	std::vector<CL_CSSSelectorLink2> links;
 	CL_String pseudo_element; // E:before (E::before in CSS3), E:after (E::after in CSS3)
+	std::vector<unsigned int> ancestor_hashes; // Names, ids and classes required of ancestors (for CL_CSSAncestorFilter2)
 
 	size_t get_specificity()
 	{
@@ -43,6 +43,11 @@ CL_CSSInlineLayout::CL_CSSInlineLayout(CL_CSSBoxElement *element)
 {
 }
 
+CL_CSSInlineLayout::~CL_CSSInlineLayout()
+{
+	clear_lines();
+}
+
 void CL_CSSInlineLayout::add_box(CL_CSSInlineGeneratedBox *box)
 {
 	boxes.add_box(box);
@@ -150,7 +155,7 @@ bool CL_CSSInlineLayout::is_empty() const
 
 void CL_CSSInlineLayout::layout_content(CL_CSSLayoutGraphics *graphics, CL_CSSLayoutCursor &cursor, LayoutStrategy strategy)
 {
-	lines.clear();
+	clear_lines();
 	layout_inline_blocks_and_floats(graphics, cursor.resources, strategy);
 	create_linebreak_opportunities();
 
@@ -664,6 +669,13 @@ CL_CSSInlinePosition CL_CSSInlineLayout::end() const
 	return CL_CSSInlinePosition();
 }
 
+void CL_CSSInlineLayout::clear_lines()
+{
+	for (size_t i = 0; i < lines.size(); i++)
+		delete lines[i];
+	lines.clear();
+}
+
 void CL_CSSInlineLayout::generate_block_line(CL_CSSInlinePosition pos)
 {
 	CL_UniquePtr<CL_CSSInlineGeneratedBox> line(new CL_CSSInlineGeneratedBox());
@@ -106,6 +106,7 @@ class CL_CSSInlineLayout : public CL_CSSLayoutTreeNode
 {
 public:
 	CL_CSSInlineLayout(CL_CSSBoxElement *element);
+	~CL_CSSInlineLayout();
 	void add_box(CL_CSSInlineGeneratedBox *box);
 
 	void set_component_geometry();
@@ -149,6 +150,7 @@ private:
 	bool is_empty_line(CL_CSSInlinePosition start, CL_CSSInlinePosition end) const;
 	CL_CSSInlinePosition begin() const;
 	CL_CSSInlinePosition end() const;
+	void clear_lines();
 
 	std::vector<CL_CSSInlineGeneratedBox *> lines;
 	std::vector<CL_CSSLayoutTreeNode *> floats;
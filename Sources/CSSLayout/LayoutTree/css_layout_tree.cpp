@@ -54,14 +54,26 @@ void CL_CSSLayoutTree::clear()
 {
 	delete root_stacking_context;
 	root_stacking_context = 0;
-	delete root_layout;
 	root_layout = 0;
+	delete_layouts(layout_nodes);
+	delete_layouts(old_layout_nodes);
 }
 
 void CL_CSSLayoutTree::create(CL_CSSBoxElement *element)
 {
-	clear();
+	// Only dirty elements and their ancestors get new layout nodes. A clean subtree kept its
+	// structure and display types, so its nodes are taken over from the previous tree.
+	if (root_layout && root_layout->get_element_node() == element && !element->is_layout_dirty())
+		return;
+
+	delete root_stacking_context;
+	root_stacking_context = 0;
+	root_layout = 0;
+
+	delete_layouts(old_layout_nodes);
+	old_layout_nodes.swap(layout_nodes);
 	root_layout = create_layout(element);
+	delete_layouts(old_layout_nodes);
 }
 
 void CL_CSSLayoutTree::layout(CL_CSSLayoutGraphics *graphics, CL_CSSResourceCache *resource_cache, const CL_Size &viewport)
@@ -113,7 +125,10 @@ CL_CSSLayoutTreeNode *CL_CSSLayoutTree::create_layout(CL_CSSBoxElement *element)
 {
 	if (element->is_block_level() || element->is_inline_block_level())
 	{
-		if (dynamic_cast<CL_CSSBoxObject*>(element))
+		CL_CSSLayoutTreeNode *reused_layout = reuse_layout(element);
+		if (reused_layout)
+			return reused_layout;
+		else if (dynamic_cast<CL_CSSBoxObject*>(element))
 			return create_replaced_level_layout(dynamic_cast<CL_CSSBoxObject*>(element));
 		else if (element->is_table() || element->is_inline_table())
 			return create_table_level_layout(element);
@@ -162,6 +177,7 @@ CL_CSSTableLayout *CL_CSSLayoutTree::create_table_level_layout(CL_CSSBoxElement
 	*/
 
 	CL_CSSTableLayout *table = new CL_CSSTableLayout(element);
+	layout_nodes[element] = table;
 	// bool in_table_row = false;
 
 	CL_CSSBoxNodeWalker walker(element->get_first_child(), false);
@@ -226,12 +242,19 @@ CL_CSSTableLayout *CL_CSSLayoutTree::create_table_level_layout(CL_CSSBoxElement
 
 CL_CSSReplacedLayout *CL_CSSLayoutTree::create_replaced_level_layout(CL_CSSBoxObject *object)
 {
-	return new CL_CSSReplacedLayout(object);
+	CL_CSSLayoutTreeNode *reused_layout = reuse_layout(object);
+	if (reused_layout)
+		return static_cast<CL_CSSReplacedLayout*>(reused_layout);
+
+	CL_CSSReplacedLayout *replaced = new CL_CSSReplacedLayout(object);
+	layout_nodes[object] = replaced;
+	return replaced;
 }
 
 CL_CSSInlineLayout *CL_CSSLayoutTree::create_inline_level_layout(CL_CSSBoxElement *element)
 {
 	CL_CSSInlineLayout *inline_layout = new CL_CSSInlineLayout(element);
+	layout_nodes[element] = inline_layout;
 
 	CL_CSSBoxNode *cur = element->get_first_child();
 	while (cur)
@@ -288,3 +311,44 @@ CL_CSSInlineGeneratedBox *CL_CSSLayoutTree::create_inline_generated_box(CL_CSSBo
 		return generated_box;
 	}
 }
+
+CL_CSSLayoutTreeNode *CL_CSSLayoutTree::reuse_layout(CL_CSSBoxElement *element)
+{
+	if (element->is_layout_dirty())
+		return 0;
+
+	std::map<CL_CSSBoxElement *, CL_CSSLayoutTreeNode *>::iterator it = old_layout_nodes.find(element);
+	if (it == old_layout_nodes.end())
+		return 0;
+
+	CL_CSSLayoutTreeNode *layout = it->second;
+	old_layout_nodes.erase(it);
+	layout_nodes[element] = layout;
+	reuse_descendant_layouts(element);
+	return layout;
+}
+
+void CL_CSSLayoutTree::reuse_descendant_layouts(CL_CSSBoxElement *element)
+{
+	for (CL_CSSBoxNode *cur = element->get_first_child(); cur; cur = cur->get_next_sibling())
+	{
+		CL_CSSBoxElement *cur_element = dynamic_cast<CL_CSSBoxElement*>(cur);
+		if (cur_element)
+		{
+			std::map<CL_CSSBoxElement *, CL_CSSLayoutTreeNode *>::iterator it = old_layout_nodes.find(cur_element);
+			if (it != old_layout_nodes.end())
+			{
+				layout_nodes[cur_element] = it->second;
+				old_layout_nodes.erase(it);
+			}
+			reuse_descendant_layouts(cur_element);
+		}
+	}
+}
+
+void CL_CSSLayoutTree::delete_layouts(std::map<CL_CSSBoxElement *, CL_CSSLayoutTreeNode *> &layouts)
+{
+	for (std::map<CL_CSSBoxElement *, CL_CSSLayoutTreeNode *>::iterator it = layouts.begin(); it != layouts.end(); ++it)
+		delete it->second;
+	layouts.clear();
+}
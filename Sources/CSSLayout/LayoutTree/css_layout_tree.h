@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <map>
+
 class CL_CSSBoxNode;
 class CL_CSSBoxElement;
 class CL_CSSBoxObject;
@@ -48,6 +50,7 @@ public:
 	CL_CSSLayoutTree();
 	~CL_CSSLayoutTree();
 
+	bool is_null() const { return root_layout == 0; }
 	void clear();
 	void create(CL_CSSBoxElement *element);
 	void layout(CL_CSSLayoutGraphics *graphics, CL_CSSResourceCache *resource_cache, const CL_Size &viewport);
@@ -62,7 +65,16 @@ private:
 	CL_CSSInlineGeneratedBox *create_inline_generated_box(CL_CSSBoxNode *cur);
 	CL_CSSReplacedLayout *create_replaced_level_layout(CL_CSSBoxObject *object);
 	CL_CSSTableLayout *create_table_level_layout(CL_CSSBoxElement *element);
+	CL_CSSLayoutTreeNode *reuse_layout(CL_CSSBoxElement *element);
+	void reuse_descendant_layouts(CL_CSSBoxElement *element);
+	static void delete_layouts(std::map<CL_CSSBoxElement *, CL_CSSLayoutTreeNode *> &layouts);
 
 	CL_CSSLayoutTreeNode *root_layout;
 	CL_CSSStackingContext *root_stacking_context;
+
+	// The tree owns all layout nodes. Inline and table layouts only refer to the nodes of their children.
+	std::map<CL_CSSBoxElement *, CL_CSSLayoutTreeNode *> layout_nodes;
+
+	// Nodes of the previous tree that have not been reused by the current create pass
+	std::map<CL_CSSBoxElement *, CL_CSSLayoutTreeNode *> old_layout_nodes;
 };
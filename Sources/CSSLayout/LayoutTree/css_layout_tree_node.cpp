@@ -54,6 +54,10 @@ CL_CSSLayoutTreeNode::~CL_CSSLayoutTreeNode()
 
 void CL_CSSLayoutTreeNode::prepare(CL_CSSBlockFormattingContext *current_formatting_context, CL_CSSStackingContext *current_stacking_context)
 {
+	// Nodes are reused between layout passes, so the widths from the last pass are stale
+	preferred_width_calculated = false;
+	min_width_calculated = false;
+
 	if (current_formatting_context == 0 || element_node->is_inline_block_level() || element_node->is_float() || element_node->is_table() || element_node->is_table_cell() || is_replaced() || element_node->is_absolute() || !element_node->is_overflow_visible())
 		set_formatting_context(new CL_CSSBlockFormattingContext(current_formatting_context), true);
 	else if (element_node->is_fixed())
@@ -61,7 +61,12 @@ void CL_CSSStackingContext::push_back(CL_CSSStackingContext *child)
 
 void CL_CSSStackingContext::sort()
 {
-	std::sort(children.begin(), children.end(), SortPred());
+	// Children are added in tree order, so only z-index changes require an actual sort
+	bool sorted = true;
+	for (size_t i = 1; i < children.size() && sorted; i++)
+		sorted = !((*children[i]) < (*children[i-1]));
+	if (!sorted)
+		std::sort(children.begin(), children.end(), SortPred());
 	for (size_t i = 0; i < children.size(); i++)
 		children[i]->sort();
 }
@@ -49,18 +49,7 @@ CL_CSSTableLayout::CL_CSSTableLayout(CL_CSSBoxElement *block_element)
 
 CL_CSSTableLayout::~CL_CSSTableLayout()
 {
-	for (size_t i = 0; i < columns.size(); i++)
-	{
-		for (size_t j = 0; j < columns[i].rows.size(); j++)
-		{
-			delete columns[i].rows[j].layout;
-		}
-	}
-
-	for (size_t i = 0; i < captions.size(); i++)
-	{
-		delete captions[i];
-	}
+	// The cell and caption layouts are owned by CL_CSSLayoutTree
 }
 
 void CL_CSSTableLayout::add_row(CL_CSSBoxElement *row_element)
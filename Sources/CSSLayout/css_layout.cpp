@@ -55,9 +55,17 @@ void CL_CSSLayout::layout(CL_GraphicContext &gc, const CL_Rect &viewport)
 {
 	impl->throw_if_disposed();
 
+	// Nothing to do if no node changed since the last layout and the viewport kept its size
+	if (!impl->box_tree.is_dirty() && !impl->layout_tree.is_null() && impl->viewport.get_size() == viewport.get_size())
+	{
+		impl->viewport = viewport;
+		return;
+	}
+
 	CL_CSSLayoutGraphics graphics(gc, &impl->resource_cache, impl->viewport);
 	impl->box_tree.prepare(&impl->resource_cache);
 	impl->layout_tree.create(impl->box_tree.get_root_element());
+	impl->box_tree.clear_dirty();
 	impl->layout_tree.layout(&graphics, &impl->resource_cache, viewport.get_size());
 	impl->viewport = viewport;
 }
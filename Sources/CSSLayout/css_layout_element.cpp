@@ -58,13 +58,19 @@ void CL_CSSLayoutElement::set_name(const CL_String &name)
 void CL_CSSLayoutElement::set_col_span(int span)
 {
 	if (!is_null())
+	{
 		static_cast<CL_CSSBoxElement*>(impl->box_node)->col_span = span;
+		impl->box_node->set_layout_dirty();
+	}
 }
 
 void CL_CSSLayoutElement::set_row_span(int span)
 {
 	if (!is_null())
+	{
 		static_cast<CL_CSSBoxElement*>(impl->box_node)->row_span = span;
+		impl->box_node->set_layout_dirty();
+	}
 }
 
 void CL_CSSLayoutElement::apply_properties(const CL_CSSPropertyList2 &properties)
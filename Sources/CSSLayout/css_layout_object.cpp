@@ -49,6 +49,7 @@ void CL_CSSLayoutObject::set_intrinsic_width(int width)
 	{
 		component->intrinsic_has_width = true;
 		component->intrinsic_width = width;
+		impl->box_node->set_layout_dirty();
 	}
 }
 
@@ -61,6 +62,7 @@ void CL_CSSLayoutObject::set_intrinsic_height(int height)
 	{
 		component->intrinsic_has_height = true;
 		component->intrinsic_height = height;
+		impl->box_node->set_layout_dirty();
 	}
 }
 
@@ -73,6 +75,7 @@ void CL_CSSLayoutObject::set_intrinsic_ratio(float ratio)
 	{
 		component->intrinsic_has_ratio = true;
 		component->intrinsic_ratio = ratio;
+		impl->box_node->set_layout_dirty();
 	}
 }
 
@@ -82,7 +85,10 @@ void CL_CSSLayoutObject::set_no_intrinsic_width()
 	if (!is_null())
 		component = static_cast<CL_CSSBoxObject*>(impl->box_node)->get_component();
 	if (component)
+	{
 		component->intrinsic_has_width = false;
+		impl->box_node->set_layout_dirty();
+	}
 }
 
 void CL_CSSLayoutObject::set_no_intrinsic_height()
@@ -91,7 +97,10 @@ void CL_CSSLayoutObject::set_no_intrinsic_height()
 	if (!is_null())
 		component = static_cast<CL_CSSBoxObject*>(impl->box_node)->get_component();
 	if (component)
+	{
 		component->intrinsic_has_height = false;
+		impl->box_node->set_layout_dirty();
+	}
 }
 
 void CL_CSSLayoutObject::set_no_intrinsic_ratio()
@@ -100,13 +109,19 @@ void CL_CSSLayoutObject::set_no_intrinsic_ratio()
 	if (!is_null())
 		component = static_cast<CL_CSSBoxObject*>(impl->box_node)->get_component();
 	if (component)
+	{
 		component->intrinsic_has_ratio = false;
+		impl->box_node->set_layout_dirty();
+	}
 }
 
 void CL_CSSLayoutObject::set_component_private(CL_CSSReplacedComponent *component)
 {
 	if (!is_null())
+	{
 		static_cast<CL_CSSBoxObject*>(impl->box_node)->set_component(component);
+		impl->box_node->set_layout_dirty();
+	}
 	else
 		delete component;
 }
@@ -37,10 +37,11 @@ CL_RectPacker::CL_RectPacker()
 {
 }
 
-CL_RectPacker::CL_RectPacker(const CL_Size &max_group_size, AllocationPolicy policy)
+CL_RectPacker::CL_RectPacker(const CL_Size &max_group_size, AllocationPolicy policy, PackingAlgorithm algorithm)
 : impl(new CL_RectPacker_Impl(max_group_size))
 {
 	set_allocation_policy(policy);
+	set_packing_algorithm(algorithm);
 }
 
 CL_RectPacker::~CL_RectPacker()
@@ -76,9 +77,14 @@ int CL_RectPacker::get_rect_count(unsigned int group_index) const
 	return impl->get_rect_count(group_index);
 }
 
+CL_RectPacker::PackingAlgorithm CL_RectPacker::get_packing_algorithm() const
+{
+	return impl->packing_algorithm;
+}
+
 int CL_RectPacker::get_group_count() const
 {
-	return impl->root_nodes.size();
+	return impl->groups.size();
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -89,7 +95,37 @@ void CL_RectPacker::set_allocation_policy(AllocationPolicy policy)
 	impl->allocation_policy = policy;
 }
 
+void CL_RectPacker::set_packing_algorithm(PackingAlgorithm algorithm)
+{
+	impl->packing_algorithm = algorithm;
+}
+
 CL_RectPacker::AllocatedRect CL_RectPacker::add(const CL_Size &size)
 {
 	return impl->add_new_node(size);
 }
+
+std::vector<CL_RectPacker::AllocatedRect> CL_RectPacker::add(const std::vector<CL_Size> &sizes)
+{
+	return impl->add_batch(sizes);
+}
+
+int CL_RectPacker::add_group(const CL_Rect &area)
+{
+	return impl->add_group(area);
+}
+
+void CL_RectPacker::remove(const AllocatedRect &rect)
+{
+	impl->remove(rect);
+}
+
+void CL_RectPacker::remove_group(unsigned int group_index)
+{
+	impl->remove_group(group_index);
+}
+
+void CL_RectPacker::clear()
+{
+	impl->clear();
+}
@@ -0,0 +1,469 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Kenneth Gangstoe
+*/
+
+#include "Core/precomp.h"
+#include "rect_packer_bin.h"
+#include "API/Core/Math/cl_math.h"
+#include <algorithm>
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_RectPackerBin_Guillotine:
+
+CL_RectPackerBin_Guillotine::CL_RectPackerBin_Guillotine(const CL_Rect &area)
+: CL_RectPackerBin(area), root(area)
+{
+}
+
+bool CL_RectPackerBin_Guillotine::insert(const CL_Size &size, CL_Rect &out_rect)
+{
+	Node *node = root.insert(size);
+	if (node == 0)
+		return false;
+	out_rect = node->node_rect;
+	return true;
+}
+
+bool CL_RectPackerBin_Guillotine::remove(const CL_Rect &rect)
+{
+	Node *node = root.find(rect);
+	if (node == 0)
+		return false;
+	node->used = false;
+
+	// Join split nodes that are empty again, so their space can hold larger rects:
+	while (true)
+	{
+		Node *parent = &root;
+		Node *empty_parent = 0;
+		while (parent->child[0])
+		{
+			Node *first = parent->child[0];
+			Node *second = parent->child[1];
+			if (!first->used && !second->used && !first->child[0] && !second->child[0])
+			{
+				empty_parent = parent;
+				break;
+			}
+			parent = first->node_rect.is_inside(rect) ? first : second;
+		}
+		if (empty_parent == 0)
+			break;
+		empty_parent->clear();
+	}
+	return true;
+}
+
+CL_RectPackerBin_Guillotine::Node::Node(const CL_Rect &rect)
+: node_rect(rect), used(false)
+{
+	child[0] = 0;
+	child[1] = 0;
+}
+
+CL_RectPackerBin_Guillotine::Node::~Node()
+{
+	clear();
+}
+
+void CL_RectPackerBin_Guillotine::Node::clear()
+{
+	delete child[0];
+	delete child[1];
+	child[0] = 0;
+	child[1] = 0;
+	used = false;
+}
+
+CL_RectPackerBin_Guillotine::Node *CL_RectPackerBin_Guillotine::Node::insert(const CL_Size &rect_size)
+{
+	// If we're not a leaf
+	if (child[0] && child[1])
+	{
+		// Try inserting into first child
+		Node *new_node = child[0]->insert(rect_size);
+		if (new_node != 0)
+			return new_node;
+
+		// No room, insert into second
+		return child[1]->insert(rect_size);
+	}
+	else
+	{
+		// If there's already a rect here, return
+		if (used)
+			return 0;
+
+		// If we're too small, return
+		if (rect_size.width > node_rect.get_width() || rect_size.height > node_rect.get_height())
+			return 0;
+
+		// If we're just right, accept
+		if (rect_size.width == node_rect.get_width() && rect_size.height == node_rect.get_height())
+		{
+			used = true;
+			return this;
+		}
+
+		// Otherwise, decide which way to split
+		int dw = node_rect.get_width() - rect_size.width;
+		int dh = node_rect.get_height() - rect_size.height;
+
+		if (dw > dh)
+		{
+			child[0] = new Node(CL_Rect(node_rect.left, node_rect.top, node_rect.left + rect_size.width, node_rect.bottom));
+			child[1] = new Node(CL_Rect(node_rect.left + rect_size.width, node_rect.top, node_rect.right, node_rect.bottom));
+		}
+		else
+		{
+			child[0] = new Node(CL_Rect(node_rect.left, node_rect.top, node_rect.right, node_rect.top + rect_size.height));
+			child[1] = new Node(CL_Rect(node_rect.left, node_rect.top + rect_size.height, node_rect.right, node_rect.bottom));
+		}
+
+		// Insert into first child we created
+		return child[0]->insert(rect_size);
+	}
+}
+
+CL_RectPackerBin_Guillotine::Node *CL_RectPackerBin_Guillotine::Node::find(const CL_Rect &rect)
+{
+	if (child[0])
+	{
+		// The children split the node, so only one of them can hold the rect
+		Node *next = child[0]->node_rect.is_inside(rect) ? child[0] : child[1];
+		return next->find(rect);
+	}
+
+	if (used && node_rect == rect)
+		return this;
+	return 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_RectPackerBin_Skyline:
+
+CL_RectPackerBin_Skyline::CL_RectPackerBin_Skyline(const CL_Rect &area)
+: CL_RectPackerBin(area)
+{
+	skyline.push_back(Segment(area.left, area.top, area.get_width()));
+}
+
+bool CL_RectPackerBin_Skyline::insert(const CL_Size &size, CL_Rect &out_rect)
+{
+	if (insert_waste(size, out_rect))
+	{
+		rects.push_back(out_rect);
+		return true;
+	}
+
+	int best_index = -1;
+	int best_bottom = 0;
+	for (size_t i = 0; i < skyline.size(); i++)
+	{
+		int top = fit(i, size);
+		if (top >= 0 && (best_index == -1 || top + size.height < best_bottom))
+		{
+			best_index = i;
+			best_bottom = top + size.height;
+		}
+	}
+	if (best_index == -1)
+		return false;
+
+	int x = skyline[best_index].x;
+	out_rect = CL_Rect(x, best_bottom - size.height, x + size.width, best_bottom);
+	add_waste(x, size.width, out_rect.top);
+	set_height(x, size.width, best_bottom);
+	rects.push_back(out_rect);
+	return true;
+}
+
+bool CL_RectPackerBin_Skyline::remove(const CL_Rect &rect)
+{
+	std::vector<CL_Rect>::iterator it = std::find(rects.begin(), rects.end(), rect);
+	if (it == rects.end())
+		return false;
+	rects.erase(it);
+
+	if (rects.empty())
+	{
+		skyline.clear();
+		skyline.push_back(Segment(area.left, area.top, area.get_width()));
+		waste_rects.clear();
+		return true;
+	}
+
+	// The skyline can only be lowered if nothing was placed on top of the rect:
+	for (size_t i = 0; i < skyline.size(); i++)
+	{
+		const Segment &segment = skyline[i];
+		if (segment.x < rect.right && segment.x + segment.width > rect.left && segment.y != rect.bottom)
+		{
+			waste_rects.push_back(rect);
+			return true;
+		}
+	}
+	set_height(rect.left, rect.get_width(), rect.top);
+	return true;
+}
+
+bool CL_RectPackerBin_Skyline::insert_waste(const CL_Size &size, CL_Rect &out_rect)
+{
+	// Best short side fit, like CL_RectPackerBin_MaxRects
+	int best_index = -1;
+	int best_short_side = 0;
+	for (size_t i = 0; i < waste_rects.size(); i++)
+	{
+		int leftover_width = waste_rects[i].get_width() - size.width;
+		int leftover_height = waste_rects[i].get_height() - size.height;
+		if (leftover_width < 0 || leftover_height < 0)
+			continue;
+
+		int short_side = cl_min(leftover_width, leftover_height);
+		if (best_index == -1 || short_side < best_short_side)
+		{
+			best_index = i;
+			best_short_side = short_side;
+		}
+	}
+	if (best_index == -1)
+		return false;
+
+	CL_Rect free_rect = waste_rects[best_index];
+	waste_rects[best_index] = waste_rects.back();
+	waste_rects.pop_back();
+	out_rect = CL_Rect(free_rect.left, free_rect.top, free_rect.left + size.width, free_rect.top + size.height);
+
+	// Split the leftover space along the shorter leftover side, keeping the larger piece whole:
+	if (free_rect.get_width() - size.width < free_rect.get_height() - size.height)
+	{
+		if (out_rect.right < free_rect.right)
+			waste_rects.push_back(CL_Rect(out_rect.right, free_rect.top, free_rect.right, out_rect.bottom));
+		if (out_rect.bottom < free_rect.bottom)
+			waste_rects.push_back(CL_Rect(free_rect.left, out_rect.bottom, free_rect.right, free_rect.bottom));
+	}
+	else
+	{
+		if (out_rect.right < free_rect.right)
+			waste_rects.push_back(CL_Rect(out_rect.right, free_rect.top, free_rect.right, free_rect.bottom));
+		if (out_rect.bottom < free_rect.bottom)
+			waste_rects.push_back(CL_Rect(free_rect.left, out_rect.bottom, out_rect.right, free_rect.bottom));
+	}
+	return true;
+}
+
+void CL_RectPackerBin_Skyline::add_waste(int x, int width, int y)
+{
+	for (size_t i = 0; i < skyline.size(); i++)
+	{
+		const Segment &segment = skyline[i];
+		int left = cl_max(segment.x, x);
+		int right = cl_min(segment.x + segment.width, x + width);
+		if (left < right && segment.y < y)
+			waste_rects.push_back(CL_Rect(left, segment.y, right, y));
+	}
+}
+
+int CL_RectPackerBin_Skyline::fit(int segment_index, const CL_Size &size) const
+{
+	int x = skyline[segment_index].x;
+	if (x + size.width > area.right)
+		return -1;
+
+	// The rect rests on the highest segment below it:
+	int top = skyline[segment_index].y;
+	int width_left = size.width;
+	for (size_t i = segment_index; width_left > 0; i++)
+	{
+		top = cl_max(top, skyline[i].y);
+		if (top + size.height > area.bottom)
+			return -1;
+		width_left -= skyline[i].width;
+	}
+	return top;
+}
+
+void CL_RectPackerBin_Skyline::set_height(int x, int width, int y)
+{
+	std::vector<Segment> segments;
+	segments.reserve(skyline.size() + 2);
+	bool inserted = false;
+	for (size_t i = 0; i < skyline.size(); i++)
+	{
+		const Segment &segment = skyline[i];
+		int segment_right = segment.x + segment.width;
+		if (segment_right <= x || segment.x >= x + width)
+		{
+			if (!inserted && segment.x >= x + width)
+			{
+				segments.push_back(Segment(x, y, width));
+				inserted = true;
+			}
+			segments.push_back(segment);
+			continue;
+		}
+
+		if (segment.x < x)
+			segments.push_back(Segment(segment.x, segment.y, x - segment.x));
+		if (!inserted)
+		{
+			segments.push_back(Segment(x, y, width));
+			inserted = true;
+		}
+		if (segment_right > x + width)
+			segments.push_back(Segment(x + width, segment.y, segment_right - (x + width)));
+	}
+	skyline.swap(segments);
+	merge_segments();
+}
+
+void CL_RectPackerBin_Skyline::merge_segments()
+{
+	size_t count = 0;
+	for (size_t i = 0; i < skyline.size(); i++)
+	{
+		if (count > 0 && skyline[count - 1].y == skyline[i].y)
+			skyline[count - 1].width += skyline[i].width;
+		else
+			skyline[count++] = skyline[i];
+	}
+	skyline.resize(count, Segment(0, 0, 0));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_RectPackerBin_MaxRects:
+
+CL_RectPackerBin_MaxRects::CL_RectPackerBin_MaxRects(const CL_Rect &area)
+: CL_RectPackerBin(area)
+{
+	free_rects.push_back(area);
+}
+
+bool CL_RectPackerBin_MaxRects::insert(const CL_Size &size, CL_Rect &out_rect)
+{
+	// Best short side fit: the free rect leaving the smallest gap along either side
+	int best_index = -1;
+	int best_short_side = 0;
+	int best_long_side = 0;
+	for (size_t i = 0; i < free_rects.size(); i++)
+	{
+		int leftover_width = free_rects[i].get_width() - size.width;
+		int leftover_height = free_rects[i].get_height() - size.height;
+		if (leftover_width < 0 || leftover_height < 0)
+			continue;
+
+		int short_side = cl_min(leftover_width, leftover_height);
+		int long_side = cl_max(leftover_width, leftover_height);
+		if (best_index == -1 || short_side < best_short_side || (short_side == best_short_side && long_side < best_long_side))
+		{
+			best_index = i;
+			best_short_side = short_side;
+			best_long_side = long_side;
+		}
+	}
+	if (best_index == -1)
+		return false;
+
+	const CL_Rect &free_rect = free_rects[best_index];
+	out_rect = CL_Rect(free_rect.left, free_rect.top, free_rect.left + size.width, free_rect.top + size.height);
+	split_free_rects(out_rect);
+	prune_free_rects();
+	rects.push_back(out_rect);
+	return true;
+}
+
+bool CL_RectPackerBin_MaxRects::remove(const CL_Rect &rect)
+{
+	std::vector<CL_Rect>::iterator it = std::find(rects.begin(), rects.end(), rect);
+	if (it == rects.end())
+		return false;
+	rects.erase(it);
+
+	// Rebuilding the free rects from the remaining rects keeps them maximal:
+	free_rects.clear();
+	free_rects.push_back(area);
+	for (size_t i = 0; i < rects.size(); i++)
+	{
+		split_free_rects(rects[i]);
+		prune_free_rects();
+	}
+	return true;
+}
+
+void CL_RectPackerBin_MaxRects::split_free_rects(const CL_Rect &used)
+{
+	size_t count = free_rects.size();
+	for (size_t i = 0; i < count; )
+	{
+		CL_Rect free_rect = free_rects[i];
+		if (!free_rect.is_overlapped(used))
+		{
+			i++;
+			continue;
+		}
+
+		if (used.left > free_rect.left)
+			free_rects.push_back(CL_Rect(free_rect.left, free_rect.top, used.left, free_rect.bottom));
+		if (used.right < free_rect.right)
+			free_rects.push_back(CL_Rect(used.right, free_rect.top, free_rect.right, free_rect.bottom));
+		if (used.top > free_rect.top)
+			free_rects.push_back(CL_Rect(free_rect.left, free_rect.top, free_rect.right, used.top));
+		if (used.bottom < free_rect.bottom)
+			free_rects.push_back(CL_Rect(free_rect.left, used.bottom, free_rect.right, free_rect.bottom));
+
+		free_rects[i] = free_rects[count - 1];
+		free_rects[count - 1] = free_rects.back();
+		free_rects.pop_back();
+		count--;
+	}
+}
+
+void CL_RectPackerBin_MaxRects::prune_free_rects()
+{
+	for (size_t i = 0; i < free_rects.size(); i++)
+	{
+		for (size_t j = i + 1; j < free_rects.size(); )
+		{
+			if (free_rects[i].is_inside(free_rects[j]))
+			{
+				free_rects[j] = free_rects.back();
+				free_rects.pop_back();
+			}
+			else if (free_rects[j].is_inside(free_rects[i]))
+			{
+				free_rects[i] = free_rects[j];
+				free_rects[j] = free_rects.back();
+				free_rects.pop_back();
+				j = i + 1;
+			}
+			else
+			{
+				j++;
+			}
+		}
+	}
+}
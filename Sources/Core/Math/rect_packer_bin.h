@@ -0,0 +1,141 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Kenneth Gangstoe
+*/
+
+#pragma once
+
+#include "API/Core/Math/rect.h"
+#include <vector>
+
+/// \brief Free space of one rect packer group, placing rects with a packing algorithm.
+class CL_RectPackerBin
+{
+public:
+	CL_RectPackerBin(const CL_Rect &area) : area(area), rect_count(0) { }
+	virtual ~CL_RectPackerBin() { }
+
+	/// \brief Allocates space for a rect
+	/// \return False if there is no room for the rect
+	virtual bool insert(const CL_Size &size, CL_Rect &out_rect) = 0;
+
+	/// \brief Releases the space of a rect allocated by insert
+	/// \return False if the rect was not allocated in this bin
+	virtual bool remove(const CL_Rect &rect) = 0;
+
+	/// \brief Area of the group the rects are placed in
+	CL_Rect area;
+
+	/// \brief Number of rects allocated
+	int rect_count;
+};
+
+/// \brief Splits the free space into a binary tree, placing rects in the first node they fit.
+class CL_RectPackerBin_Guillotine : public CL_RectPackerBin
+{
+public:
+	CL_RectPackerBin_Guillotine(const CL_Rect &area);
+
+	bool insert(const CL_Size &size, CL_Rect &out_rect);
+	bool remove(const CL_Rect &rect);
+
+private:
+	class Node
+	{
+	public:
+		Node(const CL_Rect &rect);
+		~Node();
+
+		Node *insert(const CL_Size &rect_size);
+		Node *find(const CL_Rect &rect);
+		void clear();
+
+		Node *child[2];
+		CL_Rect node_rect;
+		bool used;
+	};
+
+	Node root;
+};
+
+/// \brief Keeps the top edge of the packed rects, placing rects where their bottom ends up highest.
+///
+/// Gaps left below the skyline and removed rects are kept in a waste list, which is searched first.
+class CL_RectPackerBin_Skyline : public CL_RectPackerBin
+{
+public:
+	CL_RectPackerBin_Skyline(const CL_Rect &area);
+
+	bool insert(const CL_Size &size, CL_Rect &out_rect);
+	bool remove(const CL_Rect &rect);
+
+private:
+	struct Segment
+	{
+		Segment(int x, int y, int width) : x(x), y(y), width(width) { }
+		int x;
+		int y;
+		int width;
+	};
+
+	/// \brief Returns the top of a rect placed at a segment, or -1 if it does not fit there
+	int fit(int segment_index, const CL_Size &size) const;
+
+	/// \brief Sets the skyline to y across the span, splitting the segments it partially covers
+	void set_height(int x, int width, int y);
+
+	void merge_segments();
+
+	/// \brief Places a rect in the waste list, splitting the leftover space of the free rect used
+	bool insert_waste(const CL_Size &size, CL_Rect &out_rect);
+
+	/// \brief Adds the gaps between the skyline and the bottom of a rect about to be placed to the waste list
+	void add_waste(int x, int width, int y);
+
+	std::vector<Segment> skyline;
+	std::vector<CL_Rect> waste_rects;
+	std::vector<CL_Rect> rects;
+};
+
+/// \brief Tracks every maximal free rectangle, placing rects where they leave the shortest leftover side.
+class CL_RectPackerBin_MaxRects : public CL_RectPackerBin
+{
+public:
+	CL_RectPackerBin_MaxRects(const CL_Rect &area);
+
+	bool insert(const CL_Size &size, CL_Rect &out_rect);
+	bool remove(const CL_Rect &rect);
+
+private:
+	/// \brief Replaces the free rects overlapping the used rect with the parts of them it leaves free
+	void split_free_rects(const CL_Rect &used);
+
+	/// \brief Removes free rects contained in another free rect
+	void prune_free_rects();
+
+	std::vector<CL_Rect> free_rects;
+	std::vector<CL_Rect> rects;
+};
@@ -29,24 +29,21 @@
 #include "Core/precomp.h"
 #include "API/Core/Math/rect.h"
 #include "rect_packer_impl.h"
+#include "rect_packer_bin.h"
+#include "API/Core/Math/cl_math.h"
+#include <algorithm>
 
 /////////////////////////////////////////////////////////////////////////////
 // CL_RectPacker_Impl construction:
 
 CL_RectPacker_Impl::CL_RectPacker_Impl(const CL_Size &max_group_size)
-: active_root_node(0), next_node_id(0), max_group_size(max_group_size)
+: active_group(-1), packing_algorithm(CL_RectPacker::guillotine), max_group_size(max_group_size)
 {
 }
 
 CL_RectPacker_Impl::~CL_RectPacker_Impl()
 {
-	std::vector<RootNode *>::size_type index, size;
-	size = root_nodes.size();
-	for(index = 0; index < size; ++index)
-	{
-		root_nodes[index]->node.clear();
-		delete root_nodes[index];
-	}
+	clear();
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -56,10 +53,10 @@ int CL_RectPacker_Impl::get_total_rect_count() const
 {
 	int count = 0;
 
-	std::vector<RootNode *>::size_type index, size;
-	size = root_nodes.size();
+	std::vector<CL_RectPackerBin *>::size_type index, size;
+	size = groups.size();
 	for(index = 0; index < size; ++index)
-		count += root_nodes[index]->node.get_rect_count();
+		count += groups[index]->rect_count;
 
 	return count;
 }
@@ -68,8 +65,8 @@ int CL_RectPacker_Impl::get_rect_count(unsigned int group_index) const
 {
 	int count = 0;
 
-	if(group_index >= 0 && group_index < root_nodes.size())
-		count = root_nodes[group_index]->node.get_rect_count();
+	if(group_index < groups.size())
+		count = groups[group_index]->rect_count;
 
 	return count;
 }
@@ -80,173 +77,134 @@ int CL_RectPacker_Impl::get_rect_count(unsigned int group_index) const
 CL_RectPacker::AllocatedRect CL_RectPacker_Impl::add_new_node(const CL_Size &rect_size)
 {
 	// Try inserting in current active group
-	Node *node;
-	if (!active_root_node)
-	{
-		// Create an initial root, if it does not exist
-		node = 0;
-		next_node_id = 1;
-	}
-	else
+	CL_Rect rect;
+	if (active_group != -1 && insert(active_group, rect_size, rect))
+		return CL_RectPacker::AllocatedRect(active_group, rect);
+
+	// Couldn't find a fit in current active group
+	if(allocation_policy == CL_RectPacker::fail_if_full && !groups.empty())
 	{
-		node = active_root_node->node.insert(rect_size, next_node_id);
+		throw CL_Exception("Unable to pack rect into group: full");
 	}
 
-	if(node == 0) // Couldn't find a fit in current active group
+	if(allocation_policy == CL_RectPacker::search_previous_groups)
 	{
-		if(allocation_policy == CL_RectPacker::fail_if_full && root_nodes.size() > 0)
+		int index, size;
+		size = groups.size();
+		for(index = 0; index < size; ++index)
 		{
-			throw CL_Exception("Unable to pack rect into group: full");
-		}
-
-		if(allocation_policy == CL_RectPacker::search_previous_groups)
-		{
-			std::vector<RootNode *>::size_type index, size;
-			size = root_nodes.size();
-			for(index = 0; index < size; ++index)
-			{
-				node = root_nodes[index]->node.insert(rect_size, next_node_id);
-				if(node)	// We found space in a previous group
-					break;
-			}
-		}
-
-		if(node == 0) // Couldn't find a fit, so create a new group
-		{
-			if(rect_size.width <= max_group_size.width && rect_size.height <= max_group_size.height)
-			{
-				node = add_new_root()->node.insert(rect_size, next_node_id);
-			}
-			else
-			{
-				throw CL_Exception("Unable to pack rect into group: Larger than max_group_size");
-			}
+			if (index != active_group && insert(index, rect_size, rect))	// We found space in a previous group
+				return CL_RectPacker::AllocatedRect(index, rect);
 		}
+	}
 
-		if(node == 0)
-			throw CL_Exception("Unable to pack rect into group: Unknown reason");
+	// Couldn't find a fit, so create a new group
+	if(rect_size.width > max_group_size.width || rect_size.height > max_group_size.height)
+	{
+		throw CL_Exception("Unable to pack rect into group: Larger than max_group_size");
 	}
 
-	next_node_id++;
+	int group_index = add_group(CL_Rect(CL_Point(0, 0), max_group_size));
+	if (!insert(group_index, rect_size, rect))
+		throw CL_Exception("Unable to pack rect into group: Unknown reason");
 
-	return CL_RectPacker::AllocatedRect(active_root_node->group_id, node->node_rect);
+	return CL_RectPacker::AllocatedRect(group_index, rect);
 }
 
-CL_RectPacker_Impl::RootNode *CL_RectPacker_Impl::add_new_root()
+std::vector<CL_RectPacker::AllocatedRect> CL_RectPacker_Impl::add_batch(const std::vector<CL_Size> &sizes)
 {
-	Node node(CL_Rect(CL_Point(0, 0), max_group_size));
+	// Packing the largest rects first leaves the small ones to fill the gaps:
+	std::vector<int> order(sizes.size());
+	for (size_t i = 0; i < order.size(); i++)
+		order[i] = i;
+	std::stable_sort(order.begin(), order.end(), [&sizes](int a, int b) { return is_larger(sizes[a], sizes[b]); });
+
+	std::vector<CL_RectPacker::AllocatedRect> allocations(sizes.size(), CL_RectPacker::AllocatedRect(-1, CL_Rect()));
+	try
+	{
+		for (size_t i = 0; i < order.size(); i++)
+			allocations[order[i]] = add_new_node(sizes[order[i]]);
+	}
+	catch (const CL_Exception &)
+	{
+		for (size_t i = 0; i < allocations.size(); i++)
+		{
+			if (allocations[i].group_index != -1)
+				remove(allocations[i]);
+		}
+		throw;
+	}
+	return allocations;
+}
 
-	active_root_node = new RootNode();
-	active_root_node->group_id = (int)root_nodes.size();
-	active_root_node->node = node;
-	
-	root_nodes.push_back(active_root_node);
+int CL_RectPacker_Impl::add_group(const CL_Rect &area)
+{
+	CL_RectPackerBin *bin;
+	switch (packing_algorithm)
+	{
+	case CL_RectPacker::skyline:
+		bin = new CL_RectPackerBin_Skyline(area);
+		break;
+	case CL_RectPacker::max_rects:
+		bin = new CL_RectPackerBin_MaxRects(area);
+		break;
+	case CL_RectPacker::guillotine:
+	default:
+		bin = new CL_RectPackerBin_Guillotine(area);
+		break;
+	}
 
-	return active_root_node;
+	groups.push_back(bin);
+	active_group = groups.size() - 1;
+	return active_group;
 }
 
-/////////////////////////////////////////////////////////////////////////////
-// CL_RectPacker_Impl::Node:
-
-CL_RectPacker_Impl::Node::Node()
+void CL_RectPacker_Impl::remove(const CL_RectPacker::AllocatedRect &rect)
 {
-	child[0] = NULL;
-	child[1] = NULL;
-
-	id = 0;
+	if (rect.group_index < 0 || rect.group_index >= (int) groups.size() || !groups[rect.group_index]->remove(rect.rect))
+		throw CL_Exception("Unable to remove rect: not allocated in the group");
+	groups[rect.group_index]->rect_count--;
 }
 
-CL_RectPacker_Impl::Node::Node(const CL_Rect &new_rect)
+void CL_RectPacker_Impl::remove_group(unsigned int group_index)
 {
-	node_rect = new_rect;
+	if (group_index >= groups.size())
+		throw CL_Exception("Unable to remove group: invalid index");
 
-	child[0] = NULL;
-	child[1] = NULL;
+	delete groups[group_index];
+	groups.erase(groups.begin() + group_index);
 
-	id = 0;
+	if (active_group == (int) group_index)
+		active_group = groups.size() - 1;
+	else if (active_group > (int) group_index)
+		active_group--;
 }
 
-CL_RectPacker_Impl::Node::~Node()
+void CL_RectPacker_Impl::clear()
 {
-	clear();
+	for (size_t index = 0; index < groups.size(); ++index)
+		delete groups[index];
+	groups.clear();
+	active_group = -1;
 }
 
-int CL_RectPacker_Impl::Node::get_rect_count() const
-{
-	int count = 0;
-
-	if(child[0])
-		count += child[0]->get_rect_count();
-	if(child[1])
-		count += child[1]->get_rect_count();
-
-	if(id)
-		count++;
-
-	return count;
-}
+/////////////////////////////////////////////////////////////////////////////
+// CL_RectPacker_Impl implementation:
 
-void CL_RectPacker_Impl::Node::clear()
+bool CL_RectPacker_Impl::insert(int group_index, const CL_Size &rect_size, CL_Rect &out_rect)
 {
-	if(child[0])
-	{
-		delete child[0];
-		child[0] = NULL;
-	}
-	if(child[1])
-	{
-		delete child[1];
-		child[1] = NULL;
-	}
-	id = 0;
+	CL_RectPackerBin *bin = groups[group_index];
+	if (!bin->insert(rect_size, out_rect))
+		return false;
+	bin->rect_count++;
+	return true;
 }
 
-CL_RectPacker_Impl::Node *CL_RectPacker_Impl::Node::insert(const CL_Size &rect_size, int rect_id)
+bool CL_RectPacker_Impl::is_larger(const CL_Size &a, const CL_Size &b)
 {
-	// If we're not a leaf
-	if(child[0] && child[1])
-	{
-		// Try inserting into first child
-		Node *new_node = child[0]->insert(rect_size, rect_id);
-		if(new_node != NULL)
-			return new_node;
-        
-		// No room, insert into second
-		return child[1]->insert(rect_size, rect_id);
-	}
-	else
-	{
-		// If there's already a rect here, return
-		if (id)
-			return NULL;
-
-		// If we're too small, return
-		if (rect_size.width > node_rect.get_width() || rect_size.height > node_rect.get_height())
-			return NULL;
-
-		// If we're just right, accept
-		if (rect_size.width == node_rect.get_width() && rect_size.height == node_rect.get_height())
-		{
-			id = rect_id;
-			return this;
-		}
-        
-		// Otherwise, decide which way to split
-		int dw = node_rect.get_width() - rect_size.width;
-		int dh = node_rect.get_height() - rect_size.height;
-
-		if (dw > dh)
-		{
-			child[0] = new Node(CL_Rect(node_rect.left, node_rect.top, node_rect.left + rect_size.width, node_rect.bottom));
-			child[1] = new Node(CL_Rect(node_rect.left + rect_size.width, node_rect.top, node_rect.right, node_rect.bottom));
-		}
-		else
-		{
-			child[0] = new Node(CL_Rect(node_rect.left, node_rect.top, node_rect.right, node_rect.top + rect_size.height));
-			child[1] = new Node(CL_Rect(node_rect.left, node_rect.top + rect_size.height, node_rect.right, node_rect.bottom));
-		}
-        
-		// Insert into first child we created
-		return child[0]->insert(rect_size, rect_id);
-	}
+	int a_long_side = cl_max(a.width, a.height);
+	int b_long_side = cl_max(b.width, b.height);
+	if (a_long_side != b_long_side)
+		return a_long_side > b_long_side;
+	return cl_min(a.width, a.height) > cl_min(b.width, b.height);
 }
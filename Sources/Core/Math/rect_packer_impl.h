@@ -30,35 +30,10 @@
 
 #include "API/Core/Math/rect_packer.h"
 
+class CL_RectPackerBin;
+
 class CL_RectPacker_Impl
 {
-public:
-	class Node
-	{
-	public:
-		Node();
-		Node(const CL_Rect &rect);
-		~Node();
-
-		int get_rect_count() const;
-
-		Node *insert(const CL_Size &rect_size, int rect_id);
-
-		void clear();
-
-		Node *child[2];
-		CL_Rect node_rect;
-
-	    int id;
-	};
-
-	struct RootNode
-	{
-	public:
-		int group_id;
-		Node node;
-	};
-
 public:
 	CL_RectPacker_Impl(const CL_Size &max_group_size);
 	~CL_RectPacker_Impl();
@@ -67,14 +42,21 @@ public:
 	int get_rect_count(unsigned int group_index) const;
 
 	CL_RectPacker::AllocatedRect add_new_node(const CL_Size &rect_size);
-	RootNode *add_new_root();
+	std::vector<CL_RectPacker::AllocatedRect> add_batch(const std::vector<CL_Size> &sizes);
+	int add_group(const CL_Rect &area);
+	void remove(const CL_RectPacker::AllocatedRect &rect);
+	void remove_group(unsigned int group_index);
+	void clear();
 
-	std::vector<RootNode *> root_nodes;
-	RootNode *active_root_node;
-
-	int next_node_id;
+	std::vector<CL_RectPackerBin *> groups;
+	int active_group;
 
 	CL_RectPacker::AllocationPolicy allocation_policy;
+	CL_RectPacker::PackingAlgorithm packing_algorithm;
 
 	CL_Size max_group_size;
+
+private:
+	bool insert(int group_index, const CL_Size &rect_size, CL_Rect &out_rect);
+	static bool is_larger(const CL_Size &a, const CL_Size &b);
 };
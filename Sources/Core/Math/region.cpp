@@ -0,0 +1,310 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#include "Core/precomp.h"
+#include "API/Core/Math/region.h"
+#include <algorithm>
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_Region Construction:
+
+CL_Region::CL_Region()
+{
+}
+
+CL_Region::CL_Region(const CL_Rect &rect)
+{
+	if (rect.right > rect.left && rect.bottom > rect.top)
+		rects.push_back(rect);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_Region Attributes:
+
+CL_Rect CL_Region::get_bounds() const
+{
+	if (rects.empty())
+		return CL_Rect();
+
+	CL_Rect bounds = rects.front();
+	for (size_t i = 1; i < rects.size(); i++)
+	{
+		bounds.left = cl_min(bounds.left, rects[i].left);
+		bounds.right = cl_max(bounds.right, rects[i].right);
+	}
+	bounds.bottom = rects.back().bottom;
+	return bounds;
+}
+
+int CL_Region::get_area() const
+{
+	int area = 0;
+	for (size_t i = 0; i < rects.size(); i++)
+		area += rects[i].get_width() * rects[i].get_height();
+	return area;
+}
+
+bool CL_Region::contains(const CL_Point &point) const
+{
+	for (size_t i = 0; i < rects.size() && rects[i].top <= point.y; i++)
+	{
+		const CL_Rect &rect = rects[i];
+		if (point.x >= rect.left && point.x < rect.right && point.y >= rect.top && point.y < rect.bottom)
+			return true;
+	}
+	return false;
+}
+
+bool CL_Region::is_overlapped(const CL_Rect &rect) const
+{
+	for (size_t i = 0; i < rects.size() && rects[i].top < rect.bottom; i++)
+	{
+		if (rects[i].left < rect.right && rects[i].right > rect.left && rects[i].bottom > rect.top)
+			return true;
+	}
+	return false;
+}
+
+std::vector<CL_Rect> CL_Region::get_merged_rects(int rect_cost) const
+{
+	// Too many pieces to be worth the quadratic search below
+	const size_t max_rects = 32;
+	if (rects.size() > max_rects)
+		return std::vector<CL_Rect>(1, get_bounds());
+
+	std::vector<CL_Rect> result = rects;
+	std::vector<int> areas(result.size());
+	for (size_t i = 0; i < result.size(); i++)
+		areas[i] = result[i].get_width() * result[i].get_height();
+
+	// Greedily merge the pair that wastes the fewest pixels, as long as
+	// the wasted pixels cost less than processing an extra rectangle.
+	while (result.size() > 1)
+	{
+		size_t best_i = 0, best_j = 0;
+		int best_waste = rect_cost;
+		for (size_t i = 0; i < result.size(); i++)
+		{
+			for (size_t j = i + 1; j < result.size(); j++)
+			{
+				CL_Rect merged = result[i];
+				merged.bounding_rect(result[j]);
+				int waste = merged.get_width() * merged.get_height() - areas[i] - areas[j];
+				if (waste < best_waste)
+				{
+					best_waste = waste;
+					best_i = i;
+					best_j = j;
+				}
+			}
+		}
+
+		if (best_i == best_j)
+			break;
+
+		result[best_i].bounding_rect(result[best_j]);
+		areas[best_i] = result[best_i].get_width() * result[best_i].get_height();
+		result.erase(result.begin() + best_j);
+		areas.erase(areas.begin() + best_j);
+	}
+	return result;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_Region Operations:
+
+void CL_Region::unite(const CL_Rect &rect)
+{
+	if (rect.right > rect.left && rect.bottom > rect.top)
+		combine(std::vector<CL_Rect>(1, rect), op_union);
+}
+
+void CL_Region::unite(const CL_Region &region)
+{
+	combine(region.rects, op_union);
+}
+
+void CL_Region::subtract(const CL_Rect &rect)
+{
+	if (rect.right > rect.left && rect.bottom > rect.top)
+		combine(std::vector<CL_Rect>(1, rect), op_subtract);
+}
+
+void CL_Region::subtract(const CL_Region &region)
+{
+	combine(region.rects, op_subtract);
+}
+
+void CL_Region::intersect(const CL_Rect &rect)
+{
+	if (rect.right > rect.left && rect.bottom > rect.top)
+		combine(std::vector<CL_Rect>(1, rect), op_intersect);
+	else
+		rects.clear();
+}
+
+void CL_Region::intersect(const CL_Region &region)
+{
+	combine(region.rects, op_intersect);
+}
+
+void CL_Region::translate(const CL_Point &offset)
+{
+	for (size_t i = 0; i < rects.size(); i++)
+		rects[i].translate(offset);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_Region Implementation:
+
+namespace
+{
+	// Finds the band covering the scanline interval starting at y and appends its spans
+	void cl_region_get_band_spans(const std::vector<CL_Rect> &rects, size_t &cursor, int y, std::vector<int> &spans)
+	{
+		spans.clear();
+		while (cursor < rects.size() && rects[cursor].bottom <= y)
+			cursor++;
+		if (cursor < rects.size() && rects[cursor].top <= y)
+		{
+			int band_top = rects[cursor].top;
+			for (size_t i = cursor; i < rects.size() && rects[i].top == band_top; i++)
+			{
+				spans.push_back(rects[i].left);
+				spans.push_back(rects[i].right);
+			}
+		}
+	}
+}
+
+void CL_Region::combine(const std::vector<CL_Rect> &other, Operation op)
+{
+	if (op == op_union && other.empty())
+		return;
+	if (op == op_subtract && (other.empty() || rects.empty()))
+		return;
+	if (op == op_union && rects.empty())
+	{
+		// A single rectangle is already banded; regions are banded too
+		rects = other;
+		return;
+	}
+
+	std::vector<int> edges;
+	edges.reserve((rects.size() + other.size()) * 2);
+	for (size_t i = 0; i < rects.size(); i++)
+	{
+		edges.push_back(rects[i].top);
+		edges.push_back(rects[i].bottom);
+	}
+	for (size_t i = 0; i < other.size(); i++)
+	{
+		edges.push_back(other[i].top);
+		edges.push_back(other[i].bottom);
+	}
+	std::sort(edges.begin(), edges.end());
+	edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+	std::vector<CL_Rect> result;
+	std::vector<int> spans_a, spans_b, spans_out, prev_spans;
+	size_t cursor_a = 0, cursor_b = 0;
+	size_t prev_band_start = 0;
+	int prev_band_bottom = 0;
+	bool has_prev_band = false;
+
+	for (size_t e = 0; e + 1 < edges.size(); e++)
+	{
+		int y0 = edges[e];
+		int y1 = edges[e + 1];
+
+		cl_region_get_band_spans(rects, cursor_a, y0, spans_a);
+		cl_region_get_band_spans(other, cursor_b, y0, spans_b);
+
+		// Sweep both span lists left to right
+		spans_out.clear();
+		size_t ia = 0, ib = 0;
+		bool in_a = false, in_b = false, inside = false;
+		while (ia < spans_a.size() || ib < spans_b.size())
+		{
+			int x;
+			if (ib >= spans_b.size() || (ia < spans_a.size() && spans_a[ia] <= spans_b[ib]))
+				x = spans_a[ia];
+			else
+				x = spans_b[ib];
+
+			while (ia < spans_a.size() && spans_a[ia] == x)
+			{
+				in_a = !in_a;
+				ia++;
+			}
+			while (ib < spans_b.size() && spans_b[ib] == x)
+			{
+				in_b = !in_b;
+				ib++;
+			}
+
+			bool covered;
+			switch (op)
+			{
+			case op_union: covered = in_a || in_b; break;
+			case op_subtract: covered = in_a && !in_b; break;
+			default: covered = in_a && in_b; break;
+			}
+
+			if (covered != inside)
+			{
+				spans_out.push_back(x);
+				inside = covered;
+			}
+		}
+
+		if (spans_out.empty())
+		{
+			has_prev_band = false;
+			continue;
+		}
+
+		if (has_prev_band && prev_band_bottom == y0 && spans_out == prev_spans)
+		{
+			// Same spans as the band directly above, so extend it
+			for (size_t i = prev_band_start; i < result.size(); i++)
+				result[i].bottom = y1;
+		}
+		else
+		{
+			prev_band_start = result.size();
+			for (size_t i = 0; i < spans_out.size(); i += 2)
+				result.push_back(CL_Rect(spans_out[i], y0, spans_out[i + 1], y1));
+			prev_spans.swap(spans_out);
+			has_prev_band = true;
+		}
+		prev_band_bottom = y1;
+	}
+
+	rects.swap(result);
+}
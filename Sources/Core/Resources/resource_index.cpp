@@ -0,0 +1,121 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#include "Core/precomp.h"
+#include "resource_index.h"
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_ResourceIndex Construction:
+
+CL_ResourceIndex::CL_ResourceIndex()
+{
+	buckets.resize(64, -1);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_ResourceIndex Attributes:
+
+const CL_Resource *CL_ResourceIndex::find(const CL_StringRef &resource_id) const
+{
+	unsigned int resource_hash = hash(resource_id);
+	int index = buckets[resource_hash & (buckets.size() - 1)];
+	while (index != -1)
+	{
+		const Entry &entry = entries[index];
+		if (entry.hash == resource_hash && entry.resource_id == resource_id)
+			return &entry.resource;
+		index = entry.next;
+	}
+	return 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_ResourceIndex Operations:
+
+void CL_ResourceIndex::clear()
+{
+	entries.clear();
+	buckets.assign(64, -1);
+}
+
+bool CL_ResourceIndex::insert(const CL_String &resource_id, const CL_Resource &resource)
+{
+	if (find(resource_id))
+		return false;
+	insert_entry(Entry(hash(resource_id), resource_id, resource));
+	return true;
+}
+
+void CL_ResourceIndex::merge(const CL_ResourceIndex &other)
+{
+	for (std::vector<Entry>::size_type i = 0; i < other.entries.size(); i++)
+	{
+		if (!find(other.entries[i].resource_id))
+			insert_entry(other.entries[i]);
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_ResourceIndex Implementation:
+
+unsigned int CL_ResourceIndex::hash(const CL_StringRef &resource_id)
+{
+	// FNV-1a
+	unsigned int value = 2166136261u;
+	const char *data = resource_id.data();
+	CL_StringRef::size_type length = resource_id.length();
+	for (CL_StringRef::size_type i = 0; i < length; i++)
+	{
+		value ^= (unsigned char)data[i];
+		value *= 16777619u;
+	}
+	return value;
+}
+
+void CL_ResourceIndex::insert_entry(const Entry &entry)
+{
+	if (entries.size() + 1 > buckets.size())
+		rehash(buckets.size() * 2);
+
+	entries.push_back(entry);
+	int index = entries.size() - 1;
+	int &bucket = buckets[entry.hash & (buckets.size() - 1)];
+	entries[index].next = bucket;
+	bucket = index;
+}
+
+void CL_ResourceIndex::rehash(unsigned int bucket_count)
+{
+	buckets.assign(bucket_count, -1);
+	for (std::vector<Entry>::size_type i = 0; i < entries.size(); i++)
+	{
+		int &bucket = buckets[entries[i].hash & (bucket_count - 1)];
+		entries[i].next = bucket;
+		bucket = i;
+	}
+}
@@ -0,0 +1,96 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#pragma once
+
+#include "API/Core/Resources/resource.h"
+#include <vector>
+
+/// \brief Hash table mapping resource ids to resources.
+///
+/// Used by CL_ResourceManager to keep a flattened index of its own resources
+/// and those of all managers added with add_resources.
+class CL_ResourceIndex
+{
+/// \name Construction
+/// \{
+
+public:
+	CL_ResourceIndex();
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	int get_size() const { return entries.size(); }
+
+	/// \brief Returns the resource with the given id, or 0 if not found.
+	const CL_Resource *find(const CL_StringRef &resource_id) const;
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	void clear();
+
+	/// \brief Adds a resource, unless the id is already in the index.
+	///
+	/// \return false if the id was already in the index.
+	bool insert(const CL_String &resource_id, const CL_Resource &resource);
+
+	/// \brief Adds all resources of another index not already in this index.
+	void merge(const CL_ResourceIndex &other);
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	struct Entry
+	{
+		Entry(unsigned int hash, const CL_String &resource_id, const CL_Resource &resource) : hash(hash), next(-1), resource_id(resource_id), resource(resource) { }
+
+		unsigned int hash;
+		int next;
+		CL_String resource_id;
+		CL_Resource resource;
+	};
+
+	static unsigned int hash(const CL_StringRef &resource_id);
+
+	void insert_entry(const Entry &entry);
+
+	void rehash(unsigned int bucket_count);
+
+	std::vector<Entry> entries;
+
+	std::vector<int> buckets;
+/// \}
+};
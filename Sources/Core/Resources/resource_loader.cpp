@@ -0,0 +1,463 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#include "Core/precomp.h"
+#include "API/Core/Resources/resource_loader.h"
+#include "API/Core/System/system.h"
+#include "API/Core/System/exception.h"
+#include "API/Core/Math/cl_math.h"
+#include "resource_loader_impl.h"
+#include <algorithm>
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_ResourceLoadHandle Construction:
+
+CL_ResourceLoadHandle::CL_ResourceLoadHandle()
+{
+}
+
+CL_ResourceLoadHandle::CL_ResourceLoadHandle(const CL_SharedPtr<CL_ResourceLoadHandle_Impl> &impl)
+: impl(impl)
+{
+}
+
+CL_ResourceLoadHandle::~CL_ResourceLoadHandle()
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_ResourceLoadHandle Attributes:
+
+void CL_ResourceLoadHandle::throw_if_null() const
+{
+	if (!impl)
+		throw CL_Exception("CL_ResourceLoadHandle is null");
+}
+
+CL_ResourceLoadHandle::Status CL_ResourceLoadHandle::get_status() const
+{
+	throw_if_null();
+	CL_MutexSection mutex_lock(&impl->mutex);
+	return impl->status;
+}
+
+bool CL_ResourceLoadHandle::is_done() const
+{
+	Status status = get_status();
+	return status == status_finished || status == status_cancelled || status == status_failed;
+}
+
+int CL_ResourceLoadHandle::get_priority() const
+{
+	throw_if_null();
+	CL_MutexSection mutex_lock(&impl->mutex);
+	return impl->priority;
+}
+
+CL_String CL_ResourceLoadHandle::get_error_message() const
+{
+	throw_if_null();
+	CL_MutexSection mutex_lock(&impl->mutex);
+	return impl->error_message;
+}
+
+CL_SharedPtr<CL_ResourceLoadTask> CL_ResourceLoadHandle::get_task() const
+{
+	throw_if_null();
+	return impl->task;
+}
+
+CL_Event CL_ResourceLoadHandle::get_done_event() const
+{
+	throw_if_null();
+	return impl->done_event;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_ResourceLoadHandle Operations:
+
+void CL_ResourceLoadHandle::set_priority(int priority)
+{
+	throw_if_null();
+	CL_SharedPtr<CL_ResourceLoader_Impl> loader = impl->loader.lock();
+	if (loader)
+	{
+		CL_MutexSection loader_lock(&loader->mutex);
+		CL_MutexSection mutex_lock(&impl->mutex);
+		impl->priority = priority;
+	}
+	else
+	{
+		CL_MutexSection mutex_lock(&impl->mutex);
+		impl->priority = priority;
+	}
+}
+
+void CL_ResourceLoadHandle::cancel()
+{
+	throw_if_null();
+	CL_SharedPtr<CL_ResourceLoader_Impl> loader = impl->loader.lock();
+	if (loader)
+		loader->cancel(impl);
+}
+
+bool CL_ResourceLoadHandle::wait(int timeout)
+{
+	throw_if_null();
+	return impl->done_event.wait(timeout);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_ResourceLoader Construction:
+
+CL_ResourceLoader::CL_ResourceLoader()
+{
+}
+
+CL_ResourceLoader::CL_ResourceLoader(const CL_ResourceManager &resources, int num_workers)
+: impl(new CL_ResourceLoader_Impl(resources, num_workers))
+{
+}
+
+CL_ResourceLoader::~CL_ResourceLoader()
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_ResourceLoader Attributes:
+
+void CL_ResourceLoader::throw_if_null() const
+{
+	if (!impl)
+		throw CL_Exception("CL_ResourceLoader is null");
+}
+
+CL_ResourceManager CL_ResourceLoader::get_resources() const
+{
+	throw_if_null();
+	return impl->resources;
+}
+
+int CL_ResourceLoader::get_num_workers() const
+{
+	throw_if_null();
+	return impl->threads.size();
+}
+
+int CL_ResourceLoader::get_pending_count() const
+{
+	throw_if_null();
+	CL_MutexSection mutex_lock(&impl->mutex);
+	return impl->queued.size() + impl->loading_count;
+}
+
+int CL_ResourceLoader::get_completed_count() const
+{
+	throw_if_null();
+	CL_MutexSection mutex_lock(&impl->mutex);
+	return impl->completed.size();
+}
+
+CL_Event CL_ResourceLoader::get_completed_event() const
+{
+	throw_if_null();
+	return impl->event_completed;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_ResourceLoader Operations:
+
+CL_ResourceLoadHandle CL_ResourceLoader::queue(const CL_SharedPtr<CL_ResourceLoadTask> &task, int priority)
+{
+	throw_if_null();
+	if (!task)
+		throw CL_Exception("Cannot queue a null resource load task");
+
+	task->prepare(impl->resources);
+
+	CL_SharedPtr<CL_ResourceLoadHandle_Impl> handle(new CL_ResourceLoadHandle_Impl);
+	handle->task = task;
+	handle->priority = priority;
+	handle->loader = impl;
+	impl->add(handle);
+	return CL_ResourceLoadHandle(handle);
+}
+
+int CL_ResourceLoader::process_completed(int time_budget)
+{
+	throw_if_null();
+	return impl->process_completed(time_budget);
+}
+
+void CL_ResourceLoader::cancel_all()
+{
+	throw_if_null();
+	impl->cancel_all();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_ResourceLoader_Impl Construction:
+
+CL_ResourceLoader_Impl::CL_ResourceLoader_Impl(const CL_ResourceManager &resources, int num_workers)
+: resources(resources), loading_count(0), next_sequence(0), event_stop(true, false), event_work(true, false), event_completed(true, false)
+{
+	if (num_workers <= 0)
+		num_workers = cl_max(CL_System::get_num_cores() - 1, 1);
+
+	try
+	{
+		for (int i = 0; i < num_workers; i++)
+		{
+			CL_Thread thread;
+			thread.start(this, &CL_ResourceLoader_Impl::worker_main);
+			threads.push_back(thread);
+		}
+	}
+	catch (const CL_Exception&)
+	{
+		event_stop.set();
+		for (std::vector<CL_Thread>::size_type i = 0; i < threads.size(); i++)
+			threads[i].join();
+		throw;
+	}
+}
+
+CL_ResourceLoader_Impl::~CL_ResourceLoader_Impl()
+{
+	event_stop.set();
+	for (std::vector<CL_Thread>::size_type i = 0; i < threads.size(); i++)
+		threads[i].join();
+	cancel_all();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_ResourceLoader_Impl Operations:
+
+void CL_ResourceLoader_Impl::add(const CL_SharedPtr<CL_ResourceLoadHandle_Impl> &handle)
+{
+	CL_MutexSection mutex_lock(&mutex);
+	handle->sequence = next_sequence++;
+	queued.push_back(handle);
+	event_work.set();
+}
+
+void CL_ResourceLoader_Impl::cancel(const CL_SharedPtr<CL_ResourceLoadHandle_Impl> &handle)
+{
+	CL_MutexSection mutex_lock(&mutex);
+	CL_MutexSection handle_lock(&handle->mutex);
+	switch (handle->status)
+	{
+	case CL_ResourceLoadHandle::status_queued:
+		for (std::vector<CL_SharedPtr<CL_ResourceLoadHandle_Impl> >::iterator it = queued.begin(); it != queued.end(); ++it)
+		{
+			if (*it == handle)
+			{
+				queued.erase(it);
+				break;
+			}
+		}
+		handle->status = CL_ResourceLoadHandle::status_cancelled;
+		handle->done_event.set();
+		break;
+
+	case CL_ResourceLoadHandle::status_loading:
+		// The worker thread completes the cancellation when load() returns.
+		handle->cancelled = true;
+		break;
+
+	case CL_ResourceLoadHandle::status_loaded:
+		{
+			// Not in the list if process_completed is already running finish() for it.
+			std::list<CL_SharedPtr<CL_ResourceLoadHandle_Impl> >::iterator it = std::find(completed.begin(), completed.end(), handle);
+			if (it != completed.end())
+			{
+				completed.erase(it);
+				if (completed.empty())
+					event_completed.reset();
+				handle->status = CL_ResourceLoadHandle::status_cancelled;
+				handle->done_event.set();
+			}
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+int CL_ResourceLoader_Impl::process_completed(int time_budget)
+{
+	unsigned int start_time = CL_System::get_time();
+	int finished_count = 0;
+	while (true)
+	{
+		CL_SharedPtr<CL_ResourceLoadHandle_Impl> handle;
+		{
+			CL_MutexSection mutex_lock(&mutex);
+			if (completed.empty())
+			{
+				event_completed.reset();
+				break;
+			}
+			handle = completed.front();
+			completed.pop_front();
+			if (completed.empty())
+				event_completed.reset();
+		}
+
+		try
+		{
+			handle->task->finish();
+			set_done(handle, CL_ResourceLoadHandle::status_finished);
+		}
+		catch (const CL_Exception &e)
+		{
+			set_done(handle, CL_ResourceLoadHandle::status_failed, e.message);
+		}
+		catch (...)
+		{
+			// The handle is no longer in the completed list, so it must be marked done here or waiters hang.
+			set_done(handle, CL_ResourceLoadHandle::status_failed, "Unknown exception while finishing resource");
+		}
+		finished_count++;
+
+		if (time_budget >= 0 && (int)(CL_System::get_time() - start_time) >= time_budget)
+			break;
+	}
+	return finished_count;
+}
+
+void CL_ResourceLoader_Impl::cancel_all()
+{
+	CL_MutexSection mutex_lock(&mutex);
+	for (std::vector<CL_SharedPtr<CL_ResourceLoadHandle_Impl> >::size_type i = 0; i < queued.size(); i++)
+		set_done(queued[i], CL_ResourceLoadHandle::status_cancelled);
+	queued.clear();
+
+	for (std::list<CL_SharedPtr<CL_ResourceLoadHandle_Impl> >::iterator it = completed.begin(); it != completed.end(); ++it)
+		set_done(*it, CL_ResourceLoadHandle::status_cancelled);
+	completed.clear();
+
+	event_work.reset();
+	event_completed.reset();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_ResourceLoader_Impl Implementation:
+
+void CL_ResourceLoader_Impl::worker_main()
+{
+	CL_Thread::set_thread_name("CL_ResourceLoader worker");
+	while (true)
+	{
+		int wakeup_reason = CL_Event::wait(event_stop, event_work);
+		if (wakeup_reason != 1)
+			break;
+
+		CL_SharedPtr<CL_ResourceLoadHandle_Impl> handle;
+		{
+			CL_MutexSection mutex_lock(&mutex);
+			handle = pop_highest_priority();
+			if (!handle)
+			{
+				event_work.reset();
+				continue;
+			}
+			loading_count++;
+			CL_MutexSection handle_lock(&handle->mutex);
+			handle->status = CL_ResourceLoadHandle::status_loading;
+		}
+
+		bool failed = false;
+		CL_String error_message;
+		try
+		{
+			handle->task->load();
+		}
+		catch (const CL_Exception &e)
+		{
+			failed = true;
+			error_message = e.message;
+		}
+		catch (...)
+		{
+			failed = true;
+			error_message = "Unknown exception while loading resource";
+		}
+
+		CL_MutexSection mutex_lock(&mutex);
+		loading_count--;
+		CL_MutexSection handle_lock(&handle->mutex);
+		if (handle->cancelled)
+		{
+			handle->status = CL_ResourceLoadHandle::status_cancelled;
+			handle->done_event.set();
+		}
+		else if (failed)
+		{
+			handle->status = CL_ResourceLoadHandle::status_failed;
+			handle->error_message = error_message;
+			handle->done_event.set();
+		}
+		else
+		{
+			handle->status = CL_ResourceLoadHandle::status_loaded;
+			completed.push_back(handle);
+			event_completed.set();
+		}
+	}
+}
+
+CL_SharedPtr<CL_ResourceLoadHandle_Impl> CL_ResourceLoader_Impl::pop_highest_priority()
+{
+	if (queued.empty())
+		return CL_SharedPtr<CL_ResourceLoadHandle_Impl>();
+
+	// Priorities can change while queued, so the queue is searched rather than kept as a heap.
+	std::vector<CL_SharedPtr<CL_ResourceLoadHandle_Impl> >::size_type best = 0;
+	for (std::vector<CL_SharedPtr<CL_ResourceLoadHandle_Impl> >::size_type i = 1; i < queued.size(); i++)
+	{
+		if (queued[i]->priority > queued[best]->priority ||
+			(queued[i]->priority == queued[best]->priority && queued[i]->sequence < queued[best]->sequence))
+		{
+			best = i;
+		}
+	}
+
+	CL_SharedPtr<CL_ResourceLoadHandle_Impl> handle = queued[best];
+	queued.erase(queued.begin() + best);
+	return handle;
+}
+
+void CL_ResourceLoader_Impl::set_done(const CL_SharedPtr<CL_ResourceLoadHandle_Impl> &handle, CL_ResourceLoadHandle::Status status, const CL_String &error_message)
+{
+	CL_MutexSection handle_lock(&handle->mutex);
+	handle->status = status;
+	handle->error_message = error_message;
+	handle->done_event.set();
+}
@@ -0,0 +1,115 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#pragma once
+
+#include "API/Core/Resources/resource_loader.h"
+#include "API/Core/System/mutex.h"
+#include "API/Core/System/thread.h"
+#include "API/Core/System/event.h"
+#include "API/Core/System/weakptr.h"
+#include <vector>
+#include <list>
+
+class CL_ResourceLoadHandle_Impl
+{
+public:
+	CL_ResourceLoadHandle_Impl()
+	: status(CL_ResourceLoadHandle::status_queued), priority(0), sequence(0), cancelled(false), done_event(true, false)
+	{
+	}
+
+	CL_Mutex mutex;
+	CL_SharedPtr<CL_ResourceLoadTask> task;
+	CL_WeakPtr<CL_ResourceLoader_Impl> loader;
+	CL_ResourceLoadHandle::Status status;
+	int priority;
+	unsigned int sequence;
+	bool cancelled;
+	CL_String error_message;
+	CL_Event done_event;
+};
+
+class CL_ResourceLoader_Impl
+{
+/// \name Construction
+/// \{
+
+public:
+	CL_ResourceLoader_Impl(const CL_ResourceManager &resources, int num_workers);
+
+	~CL_ResourceLoader_Impl();
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	CL_ResourceManager resources;
+
+	CL_Mutex mutex;
+
+	/// \brief Tasks not yet picked up by a worker.
+	std::vector<CL_SharedPtr<CL_ResourceLoadHandle_Impl> > queued;
+
+	/// \brief Tasks loaded and waiting for process_completed, in completion order.
+	std::list<CL_SharedPtr<CL_ResourceLoadHandle_Impl> > completed;
+
+	int loading_count;
+
+	unsigned int next_sequence;
+
+	std::vector<CL_Thread> threads;
+
+	CL_Event event_stop, event_work, event_completed;
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	void add(const CL_SharedPtr<CL_ResourceLoadHandle_Impl> &handle);
+
+	void cancel(const CL_SharedPtr<CL_ResourceLoadHandle_Impl> &handle);
+
+	int process_completed(int time_budget);
+
+	void cancel_all();
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	void worker_main();
+
+	CL_SharedPtr<CL_ResourceLoadHandle_Impl> pop_highest_priority();
+
+	static void set_done(const CL_SharedPtr<CL_ResourceLoadHandle_Impl> &handle, CL_ResourceLoadHandle::Status status, const CL_String &error_message = CL_String());
+/// \}
+};
@@ -38,6 +38,11 @@
 #include "API/Core/XML/dom_element.h"
 #include "API/Core/Text/string_format.h"
 #include "API/Core/Text/string_help.h"
+#include "API/Core/System/weakptr.h"
+#include "API/Core/XML/dom_named_node_map.h"
+#include "API/Core/XML/dom_text.h"
+#include "API/Core/XML/dom_cdata_section.h"
+#include "resource_index.h"
 #include <map>
 
 /////////////////////////////////////////////////////////////////////////////
@@ -45,6 +50,10 @@
 
 class CL_ResourceManager_Impl
 {
+//! Construction:
+public:
+	CL_ResourceManager_Impl() : index_dirty(true) { }
+
 //! Attributes:
 public:
 	CL_VirtualDirectory directory;
@@ -56,8 +65,167 @@ public:
 	std::vector<CL_ResourceManager> additional_resources;
 
 	CL_String ns_resources;
+
+	/// \brief Own resources followed by those of additional_resources, in search order.
+	CL_ResourceIndex index;
+
+	bool index_dirty;
+
+	/// \brief Managers that have this manager in their additional_resources.
+	std::vector<CL_WeakPtr<CL_ResourceManager_Impl> > parents;
+
+//! Operations:
+public:
+	const CL_Resource *find_resource(const CL_StringRef &resource_id);
+
+	void invalidate_index();
+
+	void update_index();
+
+	/// \brief Writes a node and its children. section is the resource path of the children of node, or 0 if they are not resources.
+	void write_compiled_node(CL_IODevice &file, const CL_DomNode &node, const CL_String *section, unsigned int &element_count, std::vector<std::pair<CL_String, unsigned int> > &resource_table);
+
+	CL_DomNode read_compiled_node(CL_IODevice &file, std::vector<CL_DomElement> &elements);
+
+	static const unsigned int compiled_magic = 0x49524c43; // "CLRI"
+
+	static const unsigned int compiled_version = 1;
 };
 
+const CL_Resource *CL_ResourceManager_Impl::find_resource(const CL_StringRef &resource_id)
+{
+	if (index_dirty)
+		update_index();
+	return index.find(resource_id);
+}
+
+void CL_ResourceManager_Impl::invalidate_index()
+{
+	// A dirty manager always has dirty parents, so there is no need to walk further up.
+	if (index_dirty)
+		return;
+
+	index_dirty = true;
+	for (std::vector<CL_WeakPtr<CL_ResourceManager_Impl> >::size_type i = 0; i < parents.size(); i++)
+	{
+		CL_SharedPtr<CL_ResourceManager_Impl> parent = parents[i].lock();
+		if (parent)
+			parent->invalidate_index();
+	}
+}
+
+void CL_ResourceManager_Impl::update_index()
+{
+	index.clear();
+	std::map<CL_String, CL_Resource>::const_iterator it;
+	for (it = resources.begin(); it != resources.end(); ++it)
+		index.insert(it->first, it->second);
+
+	for (std::vector<CL_ResourceManager>::size_type i = 0; i < additional_resources.size(); i++)
+	{
+		CL_ResourceManager_Impl *additional = additional_resources[i].impl.get();
+		if (additional->index_dirty)
+			additional->update_index();
+		index.merge(additional->index);
+	}
+	index_dirty = false;
+}
+
+void CL_ResourceManager_Impl::write_compiled_node(CL_IODevice &file, const CL_DomNode &node, const CL_String *section, unsigned int &element_count, std::vector<std::pair<CL_String, unsigned int> > &resource_table)
+{
+	if (node.is_text() || node.is_cdata_section())
+	{
+		file.write_uint8(node.get_node_type());
+		file.write_string_a(node.get_node_value());
+		return;
+	}
+
+	CL_DomElement element = node.to_element();
+	element_count++;
+
+	file.write_uint8(CL_DomNode::ELEMENT_NODE);
+	file.write_string_a(element.get_namespace_uri());
+	file.write_string_a(element.get_node_name());
+
+	CL_DomNamedNodeMap attributes = element.get_attributes();
+	unsigned long attribute_count = attributes.get_length();
+	file.write_uint32(attribute_count);
+	for (unsigned long i = 0; i < attribute_count; i++)
+	{
+		CL_DomNode attribute = attributes.item(i);
+		file.write_string_a(attribute.get_namespace_uri());
+		file.write_string_a(attribute.get_node_name());
+		file.write_string_a(attribute.get_node_value());
+	}
+
+	unsigned int child_count = 0;
+	CL_DomNode child;
+	for (child = element.get_first_child(); !child.is_null(); child = child.get_next_sibling())
+	{
+		if (child.is_element() || child.is_text() || child.is_cdata_section())
+			child_count++;
+	}
+
+	file.write_uint32(child_count);
+	for (child = element.get_first_child(); !child.is_null(); child = child.get_next_sibling())
+	{
+		if (child.is_text() || child.is_cdata_section())
+		{
+			write_compiled_node(file, child, 0, element_count, resource_table);
+		}
+		else if (child.is_element())
+		{
+			// Resources are found the same way as load() does: named elements directly inside the document element or a section.
+			CL_DomElement child_element = child.to_element();
+			if (section && child_element.get_namespace_uri() == ns_resources && child_element.get_local_name() == "section")
+			{
+				CL_String child_section = *section + CL_PathHelp::add_trailing_slash(child_element.get_attribute_ns(ns_resources, "name"), CL_PathHelp::path_type_virtual);
+				write_compiled_node(file, child, &child_section, element_count, resource_table);
+			}
+			else
+			{
+				if (section && child_element.has_attribute_ns(ns_resources, "name"))
+					resource_table.push_back(std::pair<CL_String, unsigned int>(*section + child_element.get_attribute_ns(ns_resources, "name"), element_count));
+				write_compiled_node(file, child, 0, element_count, resource_table);
+			}
+		}
+	}
+}
+
+CL_DomNode CL_ResourceManager_Impl::read_compiled_node(CL_IODevice &file, std::vector<CL_DomElement> &elements)
+{
+	int node_type = file.read_uint8();
+	if (node_type == CL_DomNode::TEXT_NODE)
+		return document.create_text_node(file.read_string_a());
+	else if (node_type == CL_DomNode::CDATA_SECTION_NODE)
+		return document.create_cdata_section(file.read_string_a());
+	else if (node_type != CL_DomNode::ELEMENT_NODE)
+		throw CL_Exception("Corrupt compiled resource file");
+
+	CL_String namespace_uri = file.read_string_a();
+	CL_String name = file.read_string_a();
+	CL_DomElement element = namespace_uri.empty() ? document.create_element(name) : document.create_element_ns(namespace_uri, name);
+	elements.push_back(element);
+
+	unsigned int attribute_count = file.read_uint32();
+	for (unsigned int i = 0; i < attribute_count; i++)
+	{
+		CL_String attribute_namespace_uri = file.read_string_a();
+		CL_String attribute_name = file.read_string_a();
+		CL_String attribute_value = file.read_string_a();
+		if (attribute_namespace_uri.empty())
+			element.set_attribute(attribute_name, attribute_value);
+		else
+			element.set_attribute_ns(attribute_namespace_uri, attribute_name, attribute_value);
+	}
+
+	unsigned int child_count = file.read_uint32();
+	for (unsigned int i = 0; i < child_count; i++)
+		element.append_child(read_compiled_node(file, elements));
+
+	return element;
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_ResourceManager Construction:
 
@@ -107,17 +275,7 @@ CL_ResourceManager::~CL_ResourceManager()
 
 bool CL_ResourceManager::resource_exists(const CL_String &resource_id) const
 {
-	std::map<CL_String, CL_Resource>::const_iterator it;
-	it = impl->resources.find(resource_id);
-	if (it != impl->resources.end())
-		return true;
-
-	for (std::vector<CL_ResourceManager>::const_iterator it = impl->additional_resources.begin();
-		it != impl->additional_resources.end();
-		++it)
-		if ((*it).resource_exists(resource_id))
-			return true;
-	return false;
+	return impl->find_resource(resource_id) != 0;
 }
 
 std::vector<CL_String> CL_ResourceManager::get_section_names() const
@@ -232,26 +390,10 @@ CL_Resource CL_ResourceManager::get_resource(
 	bool resolve_alias,
 	int reserved)
 {
- 	std::map<CL_String, CL_Resource>::const_iterator it;
-	it = impl->resources.find(resource_id);
-	if (it != impl->resources.end())
-		return it->second;
-
-	std::vector<CL_ResourceManager>::size_type i;
-	for (i = 0; i < impl->additional_resources.size(); i++)
-	{
-		try
-		{
-			return impl->additional_resources[i].get_resource(
-				resource_id, resolve_alias, reserved);
-		}
-		catch (const CL_Exception&)
-		{
-		}
-	}
-
-	throw CL_Exception(cl_format("Resource not found: %1", resource_id));
-	return CL_Resource(impl->document.get_document_element(), *this);
+	const CL_Resource *resource = impl->find_resource(resource_id);
+	if (resource == 0)
+		throw CL_Exception(cl_format("Resource not found: %1", resource_id));
+	return *resource;
 }
 
 CL_VirtualDirectory CL_ResourceManager::get_directory(const CL_Resource &resource) const
@@ -317,6 +459,8 @@ bool CL_ResourceManager::operator ==(const CL_ResourceManager &manager) const
 void CL_ResourceManager::add_resources(const CL_ResourceManager& additional_resources)
 {
 	impl->additional_resources.push_back(additional_resources);
+	additional_resources.impl->parents.push_back(impl);
+	impl->invalidate_index();
 }
 
 void CL_ResourceManager::remove_resources(const CL_ResourceManager& additional_resources)
@@ -327,6 +471,18 @@ void CL_ResourceManager::remove_resources(const CL_ResourceManager& additional_r
 		if (impl->additional_resources[i] == additional_resources)
 		{
 			impl->additional_resources.erase(impl->additional_resources.begin() + i);
+
+			std::vector<CL_WeakPtr<CL_ResourceManager_Impl> > &parents = additional_resources.impl->parents;
+			for (std::vector<CL_WeakPtr<CL_ResourceManager_Impl> >::size_type j = 0; j < parents.size(); j++)
+			{
+				if (parents[j].lock() == impl)
+				{
+					parents.erase(parents.begin() + j);
+					break;
+				}
+			}
+
+			impl->invalidate_index();
 			break;
 		}
 	}
@@ -400,6 +556,7 @@ CL_Resource CL_ResourceManager::create_resource(const CL_String &resource_id, co
 
 	// Create resource:
 	impl->resources[resource_id] = CL_Resource(resource_node, *this);
+	impl->invalidate_index();
 	return impl->resources[resource_id];
 }
 
@@ -411,6 +568,7 @@ void CL_ResourceManager::destroy_resource(const CL_String &resource_id)
 		return;
 	CL_DomNode cur = it->second.get_element();
 	impl->resources.erase(it);
+	impl->invalidate_index();
 	CL_DomNode parent = cur.get_parent_node();
 	while (!parent.is_null())
 	{
@@ -480,6 +638,7 @@ void CL_ResourceManager::load(CL_IODevice file, CL_VirtualDirectory directory)
 	impl->document = new_document;
 	impl->directory = directory;
 	impl->resources.clear();
+	impl->invalidate_index();
 
 	std::vector<CL_String> section_stack;
 	std::vector<CL_DomNode> nodes_stack;
@@ -518,6 +677,80 @@ void CL_ResourceManager::load(CL_IODevice file, CL_VirtualDirectory directory)
 	}
 }
 
+void CL_ResourceManager::save_compiled(const CL_String &filename)
+{
+	CL_File file(filename, CL_File::create_always, CL_File::access_read_write);
+	save_compiled(file);
+}
+
+void CL_ResourceManager::save_compiled(CL_IODevice file)
+{
+	file.set_little_endian_mode();
+
+	unsigned int element_count = 0;
+	std::vector<std::pair<CL_String, unsigned int> > resource_table;
+
+	file.write_uint32(CL_ResourceManager_Impl::compiled_magic);
+	file.write_uint32(CL_ResourceManager_Impl::compiled_version);
+	file.write_string_a(impl->ns_resources);
+
+	CL_String root_section;
+	impl->write_compiled_node(file, impl->document.get_document_element(), &root_section, element_count, resource_table);
+
+	file.write_uint32(resource_table.size());
+	for (std::vector<std::pair<CL_String, unsigned int> >::size_type i = 0; i < resource_table.size(); i++)
+	{
+		file.write_string_a(resource_table[i].first);
+		file.write_uint32(resource_table[i].second);
+	}
+}
+
+void CL_ResourceManager::load_compiled(const CL_String &fullname)
+{
+	CL_String path = CL_PathHelp::get_fullpath(fullname, CL_PathHelp::path_type_file);
+	CL_String filename = CL_PathHelp::get_filename(fullname, CL_PathHelp::path_type_file);
+	CL_VirtualFileSystem vfs(path);
+	load_compiled(filename, vfs.get_root_directory());
+}
+
+void CL_ResourceManager::load_compiled(const CL_String &fullname, CL_VirtualDirectory directory)
+{
+	CL_String path = CL_PathHelp::get_fullpath(fullname, CL_PathHelp::path_type_virtual);
+	CL_String filename = CL_PathHelp::get_filename(fullname, CL_PathHelp::path_type_virtual);
+	CL_VirtualDirectory dir = directory.open_directory(path);
+	load_compiled(dir.open_file(filename, CL_File::open_existing, CL_File::access_read, CL_File::share_read), dir);
+}
+
+void CL_ResourceManager::load_compiled(CL_IODevice file, CL_VirtualDirectory directory)
+{
+	file.set_little_endian_mode();
+	if (file.read_uint32() != CL_ResourceManager_Impl::compiled_magic)
+		throw CL_Exception("File is not a compiled ClanLib resources document.");
+	if (file.read_uint32() != CL_ResourceManager_Impl::compiled_version)
+		throw CL_Exception("Unsupported compiled ClanLib resources document version.");
+
+	CL_String ns_resources = file.read_string_a();
+
+	impl->document = CL_DomDocument();
+	std::vector<CL_DomElement> elements;
+	impl->document.append_child(impl->read_compiled_node(file, elements));
+
+	impl->ns_resources = ns_resources;
+	impl->directory = directory;
+	impl->resources.clear();
+	impl->invalidate_index();
+
+	unsigned int resource_count = file.read_uint32();
+	for (unsigned int i = 0; i < resource_count; i++)
+	{
+		CL_String resource_id = file.read_string_a();
+		unsigned int element_index = file.read_uint32();
+		if (element_index >= elements.size())
+			throw CL_Exception("Corrupt compiled resource file");
+		impl->resources[resource_id] = CL_Resource(elements[element_index], *this);
+	}
+}
+
 void CL_ResourceManager::set_directory(const CL_VirtualDirectory &directory)
 {
 	impl->directory = directory;
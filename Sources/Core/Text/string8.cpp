@@ -34,6 +34,7 @@
 #ifndef WIN32
 #include <cstring>
 #endif
+#include <utility>
 
 CL_String8::CL_String8()
 : data_capacity(local_string_length)
@@ -55,6 +56,15 @@ CL_String8::CL_String8(const CL_String8 &source)
 	append(source);
 }
 
+#ifdef CL_HAS_RVALUE_REFERENCES
+CL_String8::CL_String8(CL_String8 &&source) throw()
+: data_capacity(local_string_length)
+{
+	init();
+	take(source);
+}
+#endif
+
 CL_String8::CL_String8(const CL_StringData8 &source)
 : data_capacity(local_string_length)
 {
@@ -103,6 +113,25 @@ void CL_String8::init()
 	this->data_ptr = local_string;
 }
 
+void CL_String8::take(CL_String8 &source)
+{
+	if (source.data_capacity > local_string_length)
+	{
+		this->data_ptr = source.data_ptr;
+		this->data_length = source.data_length;
+		data_capacity = source.data_capacity;
+		source.data_capacity = local_string_length;
+		source.init();
+	}
+	else
+	{
+		// Short strings live in the local buffer, so a copy is as cheap as a move
+		memcpy(local_string, source.local_string, sizeof(char) * (source.data_length + 1));
+		this->data_length = source.data_length;
+	}
+	source.data_length = 0;
+}
+
 CL_String8::~CL_String8()
 {
 	if (data_capacity > local_string_length)
@@ -449,6 +478,21 @@ CL_String8 &CL_String8::operator =(const CL_String8 &source)
 	return assign(source);
 }
 
+#ifdef CL_HAS_RVALUE_REFERENCES
+CL_String8 &CL_String8::operator =(CL_String8 &&source) throw()
+{
+	if (&source != this)
+	{
+		if (data_capacity > local_string_length)
+			delete[] this->data_ptr;
+		data_capacity = local_string_length;
+		init();
+		take(source);
+	}
+	return *this;
+}
+#endif
+
 CL_String8 &CL_String8::operator =(const CL_StringData8 &source)
 {
 	return assign(source);
@@ -554,3 +598,23 @@ CL_String8 operator+(const CL_StringData8 &s1, char c)
 	result.push_back(c);
 	return result;
 }
+
+#ifdef CL_HAS_RVALUE_REFERENCES
+CL_String8 operator+(CL_String8 &&s1, const CL_StringData8 &s2)
+{
+	s1.append(s2);
+	return std::move(s1);
+}
+
+CL_String8 operator+(CL_String8 &&s1, const char *s2)
+{
+	s1.append(s2);
+	return std::move(s1);
+}
+
+CL_String8 operator+(CL_String8 &&s1, char c)
+{
+	s1.push_back(c);
+	return std::move(s1);
+}
+#endif
@@ -28,6 +28,7 @@
 
 #include "Core/precomp.h"
 #include "API/Core/Text/string_format.h"
+#include "API/Core/Text/string_format_buffer.h"
 #include "API/Core/Text/string_help.h"
 #include "API/Core/System/exception.h"
 
@@ -115,74 +116,70 @@ const CL_String &CL_StringFormat::get_result() const
 
 void CL_StringFormat::set_arg(int index, const CL_StringRef &text)
 {
-	if (index >= (int) args.size())
-		return;
-		
-	ArgPosition pos = args[index];
-	if (pos.length == -1)
-		return;
-		
-	int delta_size = ((int) text.length()) - pos.length;
-	string = string.substr(0, pos.start) + text + string.substr(pos.start + pos.length);
-	args[index].length = text.length();
-	
+	// Positions are in string order, so each replacement only moves the ones after it
+	int delta_size = 0;
 	std::vector<ArgPosition>::size_type i, size;
 	size = args.size();
 	for (i = 0; i < size; i++)
 	{
-		if (args[i].start > pos.start)
-			args[i].start += delta_size;
+		ArgPosition &pos = args[i];
+		pos.start += delta_size;
+		if (pos.index == index)
+		{
+			string.replace(pos.start, pos.length, text);
+			delta_size += ((int) text.length()) - pos.length;
+			pos.length = text.length();
+		}
 	}
 }
 	
 void CL_StringFormat::set_arg(int index, int value, int min_length)
 {
-	CL_String t = CL_StringHelp::int_to_text(value);
-	if ((int) t.length() < min_length)
-		t = CL_String(min_length-t.length(), '0') + t;
-	set_arg(index, t);
+	CL_StringFormatBuffer t;
+	t.append(value, min_length);
+	set_arg(index, t.get_text());
 }
 
 void CL_StringFormat::set_arg(int index, unsigned int value, int min_length)
 {
-	CL_String t = CL_StringHelp::uint_to_text(value);
-	if ((int) t.length() < min_length)
-		t = CL_String(min_length-t.length(), '0') + t;
-	set_arg(index, t);
+	CL_StringFormatBuffer t;
+	t.append(value, min_length);
+	set_arg(index, t.get_text());
 }
 
 void CL_StringFormat::set_arg(int index, long long value, int min_length)
 {
-	CL_String t = CL_StringHelp::ll_to_text(value);
-	if ((int) t.length() < min_length)
-		t = CL_String(min_length-t.length(), '0') + t;
-	set_arg(index, t);
+	CL_StringFormatBuffer t;
+	t.append(value, min_length);
+	set_arg(index, t.get_text());
 }
 
 void CL_StringFormat::set_arg(int index, unsigned long long value, int min_length)
 {
-	CL_String t = CL_StringHelp::ull_to_text(value);
-	if ((int) t.length() < min_length)
-		t = CL_String(min_length-t.length(), '0') + t;
-	set_arg(index, t);
+	CL_StringFormatBuffer t;
+	t.append(value, min_length);
+	set_arg(index, t.get_text());
 }
 
 void CL_StringFormat::set_arg(int index, long unsigned int value, int min_length)
 {
-	CL_String t = CL_StringHelp::ull_to_text(value);
-	if ((int) t.length() < min_length)
-		t = CL_String(min_length-t.length(), '0') + t;
-	set_arg(index, t);
+	CL_StringFormatBuffer t;
+	t.append(value, min_length);
+	set_arg(index, t.get_text());
 }
 
 void CL_StringFormat::set_arg(int index, float value)
 {
-	set_arg(index, CL_StringHelp::float_to_text(value));
+	CL_StringFormatBuffer t;
+	t.append(value);
+	set_arg(index, t.get_text());
 }
 
 void CL_StringFormat::set_arg(int index, double value)
 {
-	set_arg(index, CL_StringHelp::double_to_text(value));
+	CL_StringFormatBuffer t;
+	t.append(value);
+	set_arg(index, t.get_text());
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -193,10 +190,5 @@ void CL_StringFormat::create_arg(int index, int start, int length)
 	if (index > 256)
 		throw CL_Exception("Encountered more than 256 indexes in a formatted string!");
 
-	ArgPosition pos(start, length);
-	while (index >= (int) args.size())
-		args.push_back(ArgPosition());
-	
-	args[index].start = start;
-	args[index].length = length;
+	args.push_back(ArgPosition(index, start, length));
 }
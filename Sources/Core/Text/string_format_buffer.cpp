@@ -0,0 +1,405 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#include "Core/precomp.h"
+#include "API/Core/Text/string_format_buffer.h"
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+
+static const char cl_digit_pairs[] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+// Writes the digits of value backwards from end and returns how many were written.
+static int cl_uint_to_digits(unsigned int value, char *end)
+{
+	char *p = end;
+	while (value >= 100)
+	{
+		unsigned int pair = (value % 100) * 2;
+		value /= 100;
+		p -= 2;
+		p[0] = cl_digit_pairs[pair];
+		p[1] = cl_digit_pairs[pair + 1];
+	}
+	if (value >= 10)
+	{
+		p -= 2;
+		p[0] = cl_digit_pairs[value * 2];
+		p[1] = cl_digit_pairs[value * 2 + 1];
+	}
+	else
+	{
+		*(--p) = '0' + value;
+	}
+	return end - p;
+}
+
+static int cl_ull_to_digits(unsigned long long value, char *end)
+{
+	// Peel off eight digits at a time with 64 bit division until the rest fits in 32 bits
+	char *p = end;
+	while (value > 0xffffffffULL)
+	{
+		unsigned int low = (unsigned int) (value % 100000000ULL);
+		value /= 100000000ULL;
+		for (int i = 0; i < 4; i++)
+		{
+			unsigned int pair = (low % 100) * 2;
+			low /= 100;
+			p -= 2;
+			p[0] = cl_digit_pairs[pair];
+			p[1] = cl_digit_pairs[pair + 1];
+		}
+	}
+	p -= cl_uint_to_digits((unsigned int) value, p);
+	return end - p;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_StringFormatBuffer Construction:
+
+CL_StringFormatBuffer::CL_StringFormatBuffer()
+: data(local_buffer), data_length(0), data_capacity(local_buffer_length), fixed_size(false), truncated(false)
+{
+	local_buffer[0] = 0;
+}
+
+CL_StringFormatBuffer::CL_StringFormatBuffer(char *buffer, int buffer_size)
+: data(buffer), data_length(0), data_capacity(buffer_size - 1), fixed_size(true), truncated(false)
+{
+	if (buffer == 0 || buffer_size < 1)
+	{
+		data = local_buffer;
+		data_capacity = 0;
+	}
+	data[0] = 0;
+}
+
+CL_StringFormatBuffer::~CL_StringFormatBuffer()
+{
+	if (!fixed_size && data != local_buffer)
+		delete[] data;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_StringFormatBuffer Attributes:
+
+CL_StringRef CL_StringFormatBuffer::get_text() const
+{
+	return CL_StringRef(data, data_length, true);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_StringFormatBuffer Operations:
+
+void CL_StringFormatBuffer::clear()
+{
+	data_length = 0;
+	data[0] = 0;
+	truncated = false;
+}
+
+void CL_StringFormatBuffer::append_text(const char *text, int length)
+{
+	length = reserve(length);
+	memcpy(data + data_length, text, length);
+	data_length += length;
+	data[data_length] = 0;
+}
+
+void CL_StringFormatBuffer::append_char(char c)
+{
+	if (reserve(1) == 1)
+	{
+		data[data_length++] = c;
+		data[data_length] = 0;
+	}
+}
+
+void CL_StringFormatBuffer::append(const CL_StringRef &text)
+{
+	append_text(text.data(), text.length());
+}
+
+void CL_StringFormatBuffer::append(int value, int min_length)
+{
+	char digits[16];
+	unsigned int magnitude = value < 0 ? 0u - (unsigned int) value : (unsigned int) value;
+	int num_digits = cl_uint_to_digits(magnitude, digits + 16);
+	append_digits(digits + 16 - num_digits, num_digits, value < 0, min_length);
+}
+
+void CL_StringFormatBuffer::append(unsigned int value, int min_length)
+{
+	char digits[16];
+	int num_digits = cl_uint_to_digits(value, digits + 16);
+	append_digits(digits + 16 - num_digits, num_digits, false, min_length);
+}
+
+void CL_StringFormatBuffer::append(long unsigned int value, int min_length)
+{
+	append((unsigned long long) value, min_length);
+}
+
+void CL_StringFormatBuffer::append(long long value, int min_length)
+{
+	char digits[24];
+	unsigned long long magnitude = value < 0 ? 0ULL - (unsigned long long) value : (unsigned long long) value;
+	int num_digits = cl_ull_to_digits(magnitude, digits + 24);
+	append_digits(digits + 24 - num_digits, num_digits, value < 0, min_length);
+}
+
+void CL_StringFormatBuffer::append(unsigned long long value, int min_length)
+{
+	char digits[24];
+	int num_digits = cl_ull_to_digits(value, digits + 24);
+	append_digits(digits + 24 - num_digits, num_digits, false, min_length);
+}
+
+void CL_StringFormatBuffer::append(float value, int num_decimals)
+{
+	append((double) value, num_decimals);
+}
+
+void CL_StringFormatBuffer::append(double value, int num_decimals)
+{
+	static const double scale[] = { 1.0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 };
+	static const unsigned int integer_scale[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+
+	if (num_decimals < 0)
+		num_decimals = 0;
+
+	// Round to integer digits directly unless the value is too large, not finite, or so close to
+	// a rounding tie that the multiplication error could decide it. Those cases use the C library.
+	if (num_decimals <= 9)
+	{
+		double scaled = value * scale[num_decimals];
+		double magnitude = scaled < 0.0 ? -scaled : scaled;
+		if (magnitude < 1e15)
+		{
+			double whole = floor(magnitude);
+			double fraction = magnitude - whole;
+			if (fabs(fraction - 0.5) > magnitude * 1e-15)
+			{
+				unsigned long long rounded = (unsigned long long) whole;
+				if (fraction > 0.5)
+					rounded++;
+
+				char digits[40];
+				char *end = digits + 40;
+				char *p = end;
+				if (num_decimals > 0)
+				{
+					unsigned int decimals = (unsigned int) (rounded % integer_scale[num_decimals]);
+					rounded /= integer_scale[num_decimals];
+					for (int i = 0; i < num_decimals; i++)
+					{
+						*(--p) = '0' + decimals % 10;
+						decimals /= 10;
+					}
+					*(--p) = '.';
+				}
+				p -= cl_ull_to_digits(rounded, p);
+
+				bool negative = value < 0.0 || (value == 0.0 && 1.0 / value < 0.0);
+				append_digits(p, end - p, negative, 0);
+				return;
+			}
+		}
+	}
+
+	if (num_decimals > 100)
+		num_decimals = 100;
+	char text[512];
+#ifdef WIN32
+	int length = _snprintf(text, 511, "%.*f", num_decimals, value);
+#else
+	int length = snprintf(text, 511, "%.*f", num_decimals, value);
+#endif
+	if (length < 0 || length > 511)
+		length = 511;
+	append_text(text, length);
+}
+
+int CL_StringFormatBuffer::append_format(const CL_StringRef &format, int &position, int num_args)
+{
+	const char *text = format.data();
+	int size = format.length();
+	int pos = position;
+	while (pos < size)
+	{
+		int start = pos;
+		while (pos < size && text[pos] != '%')
+			pos++;
+		if (pos > start)
+			append_text(text + start, pos - start);
+		if (pos == size)
+			break;
+
+		int arg_start = pos++;
+		if (pos < size && text[pos] == '%')
+		{
+			append_char('%');
+			pos++;
+			continue;
+		}
+
+		int arg_index = 0;
+		while (pos < size && text[pos] >= '0' && text[pos] <= '9')
+		{
+			if (arg_index < 1000)
+				arg_index = arg_index * 10 + (text[pos] - '0');
+			pos++;
+		}
+
+		if (arg_index >= 1 && arg_index <= num_args)
+		{
+			position = pos;
+			return arg_index;
+		}
+		append_text(text + arg_start, pos - arg_start);
+	}
+	position = pos;
+	return 0;
+}
+
+int CL_StringFormatBuffer::append_format(const CL_StringFormatPattern &pattern, int &position, int num_args)
+{
+	const char *text = pattern.text.data();
+	int num_segments = pattern.segments.size();
+	while (position < num_segments)
+	{
+		const CL_StringFormatPattern::Segment &segment = pattern.segments[position++];
+		if (segment.arg_index >= 1 && segment.arg_index <= num_args)
+			return segment.arg_index;
+		append_text(text + segment.start, segment.length);
+	}
+	return 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_StringFormatBuffer Implementation:
+
+int CL_StringFormatBuffer::reserve(int length)
+{
+	if (length <= data_capacity - data_length)
+		return length;
+
+	if (fixed_size)
+	{
+		truncated = true;
+		return data_capacity - data_length;
+	}
+
+	int new_capacity = data_capacity * 2;
+	if (new_capacity < data_length + length)
+		new_capacity = data_length + length;
+	char *new_data = new char[new_capacity + 1];
+	memcpy(new_data, data, data_length + 1);
+	if (data != local_buffer)
+		delete[] data;
+	data = new_data;
+	data_capacity = new_capacity;
+	return length;
+}
+
+void CL_StringFormatBuffer::append_digits(const char *digits, int num_digits, bool negative, int min_length)
+{
+	static const char zeros[] = "0000000000000000";
+
+	if (negative)
+		append_char('-');
+	for (int padding = min_length - num_digits; padding > 0; padding -= 16)
+		append_text(zeros, padding < 16 ? padding : 16);
+	append_text(digits, num_digits);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_StringFormatPattern Construction:
+
+CL_StringFormatPattern::CL_StringFormatPattern(const CL_StringRef &format)
+{
+	const char *format_text = format.data();
+	int size = format.length();
+	int literal_start = 0;
+	int pos = 0;
+
+	text.reserve(size);
+	while (pos < size)
+	{
+		if (format_text[pos] != '%')
+		{
+			text.append(1, format_text[pos++]);
+		}
+		else if (pos + 1 < size && format_text[pos + 1] == '%')
+		{
+			text.append(1, '%');
+			pos += 2;
+		}
+		else
+		{
+			int arg_start = pos++;
+			int arg_index = 0;
+			while (pos < size && format_text[pos] >= '0' && format_text[pos] <= '9')
+			{
+				if (arg_index < 1000)
+					arg_index = arg_index * 10 + (format_text[pos] - '0');
+				pos++;
+			}
+
+			if (arg_index == 0)
+			{
+				text.append(format_text + arg_start, pos - arg_start);
+				continue;
+			}
+
+			if ((int) text.length() > literal_start)
+				segments.push_back(Segment(literal_start, text.length() - literal_start, 0));
+			segments.push_back(Segment(text.length(), pos - arg_start, arg_index));
+			text.append(format_text + arg_start, pos - arg_start);
+			literal_start = text.length();
+		}
+	}
+
+	if ((int) text.length() > literal_start)
+		segments.push_back(Segment(literal_start, text.length() - literal_start, 0));
+}
+
+CL_StringFormatPattern::~CL_StringFormatPattern()
+{
+}
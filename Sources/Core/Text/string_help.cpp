@@ -28,6 +28,7 @@
 
 #include "Core/precomp.h"
 #include "API/Core/Text/string_help.h"
+#include "API/Core/Text/string_format_buffer.h"
 #include "API/Core/Text/logger.h"
 #include "API/Core/System/exception.h"
 #ifndef WIN32
@@ -267,14 +268,9 @@ CL_String CL_StringHelp::float_to_text(float value, int num_decimal_places)
 
 CL_String8 CL_StringHelp::float_to_local8(float value, int num_decimals)
 {
-	char buf[64];
-	memset(buf, 0, 64);
-#ifdef WIN32
-	_snprintf(buf, 63, ("%." + CL_StringHelp::int_to_local8(num_decimals) + "f").c_str(), value);
-#else
-	snprintf(buf, 63, ("%." + CL_StringHelp::int_to_local8(num_decimals) + "f").c_str(), value);
-#endif
-	return CL_String8(buf);
+	CL_StringFormatBuffer buffer;
+	buffer.append(value, num_decimals);
+	return CL_String8(buffer.get_text());
 }
 	
 CL_String16 CL_StringHelp::float_to_ucs2(float value, int num_decimals)
@@ -318,14 +314,9 @@ CL_String CL_StringHelp::double_to_text(double value, int num_decimals)
 
 CL_String8 CL_StringHelp::double_to_local8(double value, int num_decimals)
 {
-	char buf[64];
-	memset(buf, 0, 64);
-#ifdef WIN32
-	_snprintf(buf, 63, ("%." + CL_StringHelp::int_to_local8(num_decimals) + "f").c_str(), value);
-#else
-	snprintf(buf, 63, ("%." + CL_StringHelp::int_to_local8(num_decimals) + "f").c_str(), value);
-#endif
-	return CL_String8(buf);
+	CL_StringFormatBuffer buffer;
+	buffer.append(value, num_decimals);
+	return CL_String8(buffer.get_text());
 }
 	
 CL_String16 CL_StringHelp::double_to_ucs2(double value, int num_decimals)
@@ -369,14 +360,9 @@ CL_String CL_StringHelp::int_to_text(int value)
 
 CL_String8 CL_StringHelp::int_to_local8(int value)
 {
-	char buf[32];
-	memset(buf, 0, 32);
-#ifdef WIN32
-	_snprintf(buf, 31, "%d", value);
-#else
-	snprintf(buf, 31, "%d", value);
-#endif
-	return CL_String8(buf);
+	CL_StringFormatBuffer buffer;
+	buffer.append(value);
+	return CL_String8(buffer.get_text());
 }
 	
 CL_String16 CL_StringHelp::int_to_ucs2(int value)
@@ -489,14 +475,9 @@ CL_String CL_StringHelp::uint_to_text(unsigned int value)
 
 CL_String8 CL_StringHelp::uint_to_local8(unsigned int value)
 {
-	char buf[32];
-	memset(buf, 0, 32);
-#ifdef WIN32
-	_snprintf(buf, 31, "%u", value);
-#else
-	snprintf(buf, 31, "%u", value);
-#endif
-	return CL_String8(buf);
+	CL_StringFormatBuffer buffer;
+	buffer.append(value);
+	return CL_String8(buffer.get_text());
 }
 	
 CL_String16 CL_StringHelp::uint_to_ucs2(unsigned int value)
@@ -516,15 +497,14 @@ CL_String16 CL_StringHelp::uint_to_ucs2(unsigned int value)
 
 CL_String CL_StringHelp::ull_to_text(unsigned long long value)
 {
-	return uint_to_local8(value);
+	return ull_to_local8(value);
 }
 
 CL_String8 CL_StringHelp::ull_to_local8(unsigned long long value)
 {
-	std::ostringstream stream;
-	stream << value;
-	
-	return CL_String8(stream.str().c_str());
+	CL_StringFormatBuffer buffer;
+	buffer.append(value);
+	return CL_String8(buffer.get_text());
 }
 	
 CL_String16 CL_StringHelp::ull_to_ucs2(unsigned long long value)
@@ -537,15 +517,14 @@ CL_String16 CL_StringHelp::ull_to_ucs2(unsigned long long value)
 
 CL_String CL_StringHelp::ll_to_text(long long value)
 {
-	return uint_to_local8(value);
+	return ll_to_local8(value);
 }
 
 CL_String8 CL_StringHelp::ll_to_local8(long long value)
 {
-	std::ostringstream stream;
-	stream << value;
-	
-	return CL_String8(stream.str().c_str());
+	CL_StringFormatBuffer buffer;
+	buffer.append(value);
+	return CL_String8(buffer.get_text());
 }
 	
 CL_String16 CL_StringHelp::ll_to_ucs2(long long value)
@@ -69,6 +69,17 @@ CL_StringRef16::CL_StringRef16(const CL_StringRef16 &source)
 	this->data_length = source.length();
 }
 
+#ifdef CL_HAS_RVALUE_REFERENCES
+CL_StringRef16::CL_StringRef16(CL_StringRef16 &&source) throw()
+: null_terminated(source.null_terminated), temporary(source.temporary)
+{
+	this->data_ptr = source.data_ptr;
+	this->data_length = source.data_length;
+	source.temporary = false;
+	source.clear();
+}
+#endif
+
 CL_StringRef16::CL_StringRef16(const CL_StringData16 &source)
 : null_terminated(false), temporary(false)
 {
@@ -122,6 +133,22 @@ CL_StringRef16 &CL_StringRef16::operator =(const CL_StringRef16 &source)
 	return *this;
 }
 
+#ifdef CL_HAS_RVALUE_REFERENCES
+CL_StringRef16 &CL_StringRef16::operator =(CL_StringRef16 &&source) throw()
+{
+	if (&source == this)
+		return *this;
+	clear();
+	this->data_ptr = source.data_ptr;
+	this->data_length = source.data_length;
+	null_terminated = source.null_terminated;
+	temporary = source.temporary;
+	source.temporary = false;
+	source.clear();
+	return *this;
+}
+#endif
+
 CL_StringRef16 &CL_StringRef16::operator =(const CL_StringData16 &source)
 {
 	if (&source == this)
@@ -54,6 +54,17 @@ CL_StringRef8::CL_StringRef8(const CL_StringRef8 &source)
 	this->data_length = source.length();
 }
 
+#ifdef CL_HAS_RVALUE_REFERENCES
+CL_StringRef8::CL_StringRef8(CL_StringRef8 &&source) throw()
+: null_terminated(source.null_terminated), temporary(source.temporary)
+{
+	this->data_ptr = source.data_ptr;
+	this->data_length = source.data_length;
+	source.temporary = false;
+	source.clear();
+}
+#endif
+
 CL_StringRef8::CL_StringRef8(const CL_StringData8 &source)
 : null_terminated(false), temporary(false)
 {
@@ -121,6 +132,22 @@ CL_StringRef8 &CL_StringRef8::operator =(const CL_StringRef8 &source)
 	return *this;
 }
 
+#ifdef CL_HAS_RVALUE_REFERENCES
+CL_StringRef8 &CL_StringRef8::operator =(CL_StringRef8 &&source) throw()
+{
+	if (&source == this)
+		return *this;
+	clear();
+	this->data_ptr = source.data_ptr;
+	this->data_length = source.data_length;
+	null_terminated = source.null_terminated;
+	temporary = source.temporary;
+	source.temporary = false;
+	source.clear();
+	return *this;
+}
+#endif
+
 CL_StringRef8 &CL_StringRef8::operator =(const CL_StringData8 &source)
 {
 	if (&source == this)
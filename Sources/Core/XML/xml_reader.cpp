@@ -0,0 +1,670 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#include "Core/precomp.h"
+#include "API/Core/XML/xml_reader.h"
+#include "API/Core/Text/string_format.h"
+#include "API/Core/Text/string_help.h"
+#include "xml_reader_generic.h"
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_XMLReader Construction:
+
+CL_XMLReader::CL_XMLReader()
+{
+}
+
+CL_XMLReader::CL_XMLReader(CL_IODevice &input, int buffer_size)
+: impl(new CL_XMLReader_Generic)
+{
+	impl->input = input;
+	impl->buffer.set_size(buffer_size > 16 ? buffer_size : 16);
+	impl->data = impl->buffer.get_data();
+	impl->end_of_input = false;
+}
+
+CL_XMLReader::CL_XMLReader(const void *data, int size)
+: impl(new CL_XMLReader_Generic)
+{
+	impl->data = static_cast<const char *>(data);
+	impl->data_size = size;
+	impl->end_of_input = true;
+}
+
+CL_XMLReader::~CL_XMLReader()
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_XMLReader Attributes:
+
+bool CL_XMLReader::get_eat_whitespace() const
+{
+	return impl->eat_whitespace;
+}
+
+CL_XMLToken::TokenType CL_XMLReader::get_type() const
+{
+	return impl->type;
+}
+
+CL_XMLToken::TokenVariant CL_XMLReader::get_variant() const
+{
+	return impl->variant;
+}
+
+bool CL_XMLReader::is_element_begin() const
+{
+	return impl->type == CL_XMLToken::ELEMENT_TOKEN && impl->variant != CL_XMLToken::END;
+}
+
+bool CL_XMLReader::is_element_end() const
+{
+	return impl->type == CL_XMLToken::ELEMENT_TOKEN && impl->variant != CL_XMLToken::BEGIN;
+}
+
+int CL_XMLReader::get_depth() const
+{
+	return impl->depth;
+}
+
+CL_StringRef CL_XMLReader::get_name() const
+{
+	return impl->name;
+}
+
+CL_StringRef CL_XMLReader::get_raw_value() const
+{
+	return impl->value;
+}
+
+CL_String CL_XMLReader::get_value() const
+{
+	if (impl->type == CL_XMLToken::CDATA_SECTION_TOKEN)
+		return impl->value;
+	else
+		return unescape(impl->value);
+}
+
+int CL_XMLReader::get_attribute_count() const
+{
+	return impl->num_attributes;
+}
+
+CL_StringRef CL_XMLReader::get_attribute_name(int index) const
+{
+	if (index < 0 || index >= impl->num_attributes)
+		throw CL_Exception("Attribute index out of range");
+	return impl->attributes[index].name;
+}
+
+CL_StringRef CL_XMLReader::get_attribute_raw_value(int index) const
+{
+	if (index < 0 || index >= impl->num_attributes)
+		throw CL_Exception("Attribute index out of range");
+	return impl->attributes[index].value;
+}
+
+CL_String CL_XMLReader::get_attribute_value(int index) const
+{
+	return unescape(get_attribute_raw_value(index));
+}
+
+bool CL_XMLReader::has_attribute(const CL_StringRef &name) const
+{
+	for (int index = 0; index < impl->num_attributes; index++)
+	{
+		if (impl->attributes[index].name == name)
+			return true;
+	}
+	return false;
+}
+
+CL_String CL_XMLReader::get_attribute(const CL_StringRef &name, const CL_StringRef &default_value) const
+{
+	for (int index = 0; index < impl->num_attributes; index++)
+	{
+		if (impl->attributes[index].name == name)
+			return unescape(impl->attributes[index].value);
+	}
+	return default_value;
+}
+
+int CL_XMLReader::get_line_number() const
+{
+	return impl->get_line_number();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_XMLReader Operations:
+
+void CL_XMLReader::set_eat_whitespace(bool enable)
+{
+	impl->eat_whitespace = enable;
+}
+
+bool CL_XMLReader::read()
+{
+	if (impl)
+		return impl->read();
+	else
+		return false;
+}
+
+void CL_XMLReader::skip_element()
+{
+	if (impl->type != CL_XMLToken::ELEMENT_TOKEN || impl->variant != CL_XMLToken::BEGIN)
+		return;
+
+	int element_depth = impl->depth;
+	while (impl->read())
+	{
+		if (impl->type == CL_XMLToken::ELEMENT_TOKEN && impl->variant == CL_XMLToken::END && impl->depth == element_depth)
+			return;
+	}
+	CL_XMLReader_Generic::throw_exception("Premature end of XML data!");
+}
+
+CL_String CL_XMLReader::unescape(const CL_StringRef &text)
+{
+	CL_String result;
+	unescape(text, result);
+	return result;
+}
+
+void CL_XMLReader::unescape(const CL_StringRef &text, CL_String &out_text)
+{
+	CL_StringRef::size_type amp_pos = text.find('&');
+	if (amp_pos == CL_StringRef::npos)
+	{
+		out_text = text;
+		return;
+	}
+
+	out_text.clear();
+	out_text.reserve(text.length());
+
+	CL_StringRef::size_type pos = 0;
+	while (amp_pos != CL_StringRef::npos)
+	{
+		out_text.append(text.data() + pos, amp_pos - pos);
+
+		CL_StringRef::size_type end_pos = text.find(';', amp_pos);
+		if (end_pos == CL_StringRef::npos)
+			break;
+
+		CL_StringRef entity = text.substr(amp_pos + 1, end_pos - amp_pos - 1);
+		if (entity == "quot")
+			out_text.push_back('"');
+		else if (entity == "apos")
+			out_text.push_back('\'');
+		else if (entity == "lt")
+			out_text.push_back('<');
+		else if (entity == "gt")
+			out_text.push_back('>');
+		else if (entity == "amp")
+			out_text.push_back('&');
+		else if (entity.length() > 1 && entity[0] == '#')
+		{
+			unsigned int code = 0;
+			if (entity[1] == 'x' || entity[1] == 'X')
+				code = CL_StringHelp::text_to_uint(entity.substr(2), 16);
+			else
+				code = CL_StringHelp::text_to_uint(entity.substr(1));
+			out_text.append(CL_StringHelp::unicode_to_utf8(code));
+		}
+		else
+		{
+			// Unknown entity, keep it as is:
+			out_text.append(text.data() + amp_pos, end_pos - amp_pos + 1);
+		}
+
+		pos = end_pos + 1;
+		amp_pos = text.find('&', pos);
+	}
+
+	if (amp_pos != CL_StringRef::npos)
+		out_text.append(text.data() + amp_pos, text.length() - amp_pos);
+	else
+		out_text.append(text.data() + pos, text.length() - pos);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_XMLReader_Generic Construction:
+
+CL_XMLReader_Generic::CL_XMLReader_Generic()
+: data(0), data_size(0), pos(0), end_of_input(true), bom_checked(false), line_count(0), line_pos(0),
+  eat_whitespace(true), depth(0), type(CL_XMLToken::NULL_TOKEN), variant(CL_XMLToken::SINGLE),
+  token_start(0), num_attributes(0)
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_XMLReader_Generic Operations:
+
+bool CL_XMLReader_Generic::read()
+{
+	if (type == CL_XMLToken::ELEMENT_TOKEN && variant == CL_XMLToken::BEGIN)
+		depth++;
+
+	if (!bom_checked)
+		check_bom();
+
+	while (true)
+	{
+		token_start = pos;
+		count_lines(token_start);
+		num_attributes = 0;
+		name = CL_StringRef();
+		value = CL_StringRef();
+		variant = CL_XMLToken::SINGLE;
+
+		if (pos == data_size)
+		{
+			if (fill_buffer())
+				continue;
+			type = CL_XMLToken::NULL_TOKEN;
+			return false;
+		}
+
+		bool tag = (data[pos] == '<');
+		ParseResult result = tag ? parse_tag() : parse_text();
+		if (result == parse_need_data)
+		{
+			if (!fill_buffer() && tag)
+				throw_exception(cl_format("Premature end of XML data at line %1", get_line_number()));
+			pos = token_start;
+		}
+		else if (result == parse_ok)
+		{
+			if (type == CL_XMLToken::ELEMENT_TOKEN && variant == CL_XMLToken::END)
+				depth--;
+			return true;
+		}
+	}
+}
+
+int CL_XMLReader_Generic::get_line_number() const
+{
+	return line_count + 1;
+}
+
+void CL_XMLReader_Generic::throw_exception(const CL_StringRef &str)
+{
+	throw CL_Exception(str);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_XMLReader_Generic Implementation:
+
+CL_XMLReader_Generic::ParseResult CL_XMLReader_Generic::parse_text()
+{
+	int end = find(pos, '<');
+	if (end == -1)
+	{
+		if (!end_of_input)
+			return parse_need_data;
+		end = data_size;
+	}
+
+	type = CL_XMLToken::TEXT_TOKEN;
+	value = eat_whitespace ? trim_whitespace(pos, end) : make_ref(pos, end);
+	pos = end;
+
+	if (value.empty())
+		return parse_skip;
+	return parse_ok;
+}
+
+CL_XMLReader_Generic::ParseResult CL_XMLReader_Generic::parse_tag()
+{
+	int p = pos + 1;
+	if (p >= data_size)
+		return parse_need_data;
+
+	char first_char = data[p];
+	if (first_char == '!')
+		return parse_exclamation_mark(p + 1);
+
+	bool closing = (first_char == '/');
+	bool question_mark = (first_char == '?');
+	if (closing || question_mark)
+		p++;
+
+	// Extract the tag name:
+	int name_start = p;
+	p = find_first_of(p, " \r\n\t?/>");
+	if (p == -1)
+		return parse_need_data;
+
+	type = question_mark ? CL_XMLToken::PROCESSING_INSTRUCTION_TOKEN : CL_XMLToken::ELEMENT_TOKEN;
+	variant = closing ? CL_XMLToken::END : CL_XMLToken::BEGIN;
+	name = make_ref(name_start, p);
+
+	if (question_mark)
+	{
+		p = skip_whitespace(p);
+		if (p == -1)
+			return parse_need_data;
+
+		int value_end = find(p, '?');
+		if (value_end == -1)
+			return parse_need_data;
+		value = make_ref(p, value_end);
+		p = value_end;
+	}
+	else
+	{
+		// Check for possible attributes:
+		while (true)
+		{
+			p = skip_whitespace(p);
+			if (p == -1)
+				return parse_need_data;
+
+			// End of tag, stop searching for more attributes:
+			if (data[p] == '/' || data[p] == '?' || data[p] == '>')
+				break;
+
+			// Extract attribute name:
+			int attribute_start = p;
+			p = find_first_of(p, " \r\n\t=");
+			if (p == -1)
+				return parse_need_data;
+			CL_StringRef attribute_name = make_ref(attribute_start, p);
+
+			// Find seperator:
+			p = skip_whitespace(p);
+			if (p == -1)
+				return parse_need_data;
+			if (data[p] != '=')
+				throw_exception(cl_format("XML error(s), parser confused at line %1 (tag=%2, attributeName=%3)", get_line_number(), name, attribute_name));
+			p = skip_whitespace(p + 1);
+			if (p == -1)
+				return parse_need_data;
+
+			// Extract attribute value:
+			char quote = data[p];
+			int value_end;
+			if (quote == '"' || quote == '\'')
+			{
+				p++;
+				value_end = find(p, quote);
+				if (value_end == -1)
+					return parse_need_data;
+				add_attribute(attribute_name, make_ref(p, value_end));
+				p = value_end + 1;
+			}
+			else
+			{
+				value_end = find_first_of(p, " \r\n\t/>");
+				if (value_end == -1)
+					return parse_need_data;
+				add_attribute(attribute_name, make_ref(p, value_end));
+				p = value_end;
+			}
+		}
+	}
+
+	if (p >= data_size)
+		return parse_need_data;
+
+	// Check if its singular:
+	if (data[p] == '/' || data[p] == '?')
+	{
+		variant = CL_XMLToken::SINGLE;
+		p++;
+		if (p >= data_size)
+			return parse_need_data;
+	}
+
+	if (data[p] != '>')
+		throw_exception(cl_format("Error in XML stream, line %1 (expected end of tag)", get_line_number()));
+
+	pos = p + 1;
+	return parse_ok;
+}
+
+CL_XMLReader_Generic::ParseResult CL_XMLReader_Generic::parse_exclamation_mark(int p)
+{
+	if (p + 2 > data_size)
+		return parse_need_data;
+
+	if (data[p] == '-' && data[p + 1] == '-')
+	{
+		int start = p + 2;
+		int end = find(start, "-->", 3);
+		if (end == -1)
+			return parse_need_data;
+
+		type = CL_XMLToken::COMMENT_TOKEN;
+		value = eat_whitespace ? trim_whitespace(start, end) : make_ref(start, end);
+		pos = end + 3;
+		return parse_ok;
+	}
+
+	if (p + 7 > data_size)
+		return parse_need_data;
+
+	if (memcmp(data + p, "[CDATA[", 7) == 0)
+	{
+		int start = p + 7;
+		int end = find(start, "]]>", 3);
+		if (end == -1)
+			return parse_need_data;
+
+		type = CL_XMLToken::CDATA_SECTION_TOKEN;
+		value = make_ref(start, end);
+		pos = end + 3;
+		return parse_ok;
+	}
+	else if (memcmp(data + p, "DOCTYPE", 7) == 0)
+	{
+		p = skip_whitespace(p + 7);
+		if (p == -1)
+			return parse_need_data;
+
+		int name_start = p;
+		p = find_first_of(p, " \r\n\t[>");
+		if (p == -1)
+			return parse_need_data;
+		name = make_ref(name_start, p);
+
+		// Find the end of the declaration, skipping the internal subset and quoted literals:
+		int value_start = p;
+		bool internal_subset = false;
+		char quote = 0;
+		for (; p < data_size; p++)
+		{
+			char c = data[p];
+			if (quote)
+			{
+				if (c == quote)
+					quote = 0;
+			}
+			else if (c == '"' || c == '\'')
+				quote = c;
+			else if (c == '[')
+				internal_subset = true;
+			else if (c == ']')
+				internal_subset = false;
+			else if (c == '>' && !internal_subset)
+				break;
+		}
+		if (p == data_size)
+			return parse_need_data;
+
+		type = CL_XMLToken::DOCUMENT_TYPE_TOKEN;
+		value = trim_whitespace(value_start, p);
+		pos = p + 1;
+		return parse_ok;
+	}
+	else
+	{
+		throw_exception(cl_format("Error in XML stream, line %1", get_line_number()));
+		return parse_skip;
+	}
+}
+
+bool CL_XMLReader_Generic::fill_buffer()
+{
+	if (end_of_input)
+		return false;
+
+	// Discard data before the current token:
+	count_lines(token_start);
+	line_pos = 0;
+
+	char *buffer_data = buffer.get_data();
+	int keep_size = data_size - token_start;
+	if (keep_size > 0 && token_start > 0)
+		memmove(buffer_data, buffer_data + token_start, keep_size);
+	pos -= token_start;
+	token_start = 0;
+	data_size = keep_size;
+
+	// Grow the buffer if a single token fills all of it:
+	if (data_size == buffer.get_size())
+	{
+		buffer.set_size(buffer.get_size() * 2);
+		buffer_data = buffer.get_data();
+		data = buffer_data;
+	}
+
+	int received = input.read(buffer_data + data_size, buffer.get_size() - data_size, false);
+	if (received <= 0)
+	{
+		end_of_input = true;
+		return false;
+	}
+	data_size += received;
+	return true;
+}
+
+void CL_XMLReader_Generic::check_bom()
+{
+	while (data_size < 4 && fill_buffer())
+	{
+	}
+	bom_checked = true;
+
+	CL_StringHelp::BOMType bom_type = CL_StringHelp::detect_bom(data, data_size);
+	switch (bom_type)
+	{
+	default:
+	case CL_StringHelp::bom_none:
+		break;
+	case CL_StringHelp::bom_utf32_be:
+	case CL_StringHelp::bom_utf32_le:
+		throw_exception("UTF-32 XML files not supported yet");
+		break;
+	case CL_StringHelp::bom_utf16_be:
+	case CL_StringHelp::bom_utf16_le:
+		throw_exception("UTF-16 XML files not supported yet");
+		break;
+	case CL_StringHelp::bom_utf8:
+		pos = 3;
+		break;
+	}
+}
+
+void CL_XMLReader_Generic::count_lines(int p)
+{
+	while (line_pos < p)
+	{
+		const void *found = memchr(data + line_pos, '\n', p - line_pos);
+		if (!found)
+			break;
+		line_count++;
+		line_pos = static_cast<const char *>(found) - data + 1;
+	}
+	line_pos = p;
+}
+
+inline int CL_XMLReader_Generic::find(int p, char c) const
+{
+	const void *found = memchr(data + p, c, data_size - p);
+	return found ? static_cast<const char *>(found) - data : -1;
+}
+
+inline int CL_XMLReader_Generic::find(int p, const char *str, int length) const
+{
+	while (true)
+	{
+		p = find(p, str[0]);
+		if (p == -1 || p + length > data_size)
+			return -1;
+		if (memcmp(data + p, str, length) == 0)
+			return p;
+		p++;
+	}
+}
+
+inline int CL_XMLReader_Generic::find_first_of(int p, const char *chars) const
+{
+	for (; p < data_size; p++)
+	{
+		if (strchr(chars, data[p]) != 0 && data[p] != 0)
+			return p;
+	}
+	return -1;
+}
+
+inline int CL_XMLReader_Generic::skip_whitespace(int p) const
+{
+	for (; p < data_size; p++)
+	{
+		char c = data[p];
+		if (c != ' ' && c != '\t' && c != '\r' && c != '\n')
+			return p;
+	}
+	return -1;
+}
+
+inline CL_StringRef CL_XMLReader_Generic::make_ref(int start, int end) const
+{
+	return CL_StringRef(data + start, end - start, false);
+}
+
+CL_StringRef CL_XMLReader_Generic::trim_whitespace(int start, int end) const
+{
+	while (start < end && (data[start] == ' ' || data[start] == '\t' || data[start] == '\r' || data[start] == '\n'))
+		start++;
+	while (end > start && (data[end - 1] == ' ' || data[end - 1] == '\t' || data[end - 1] == '\r' || data[end - 1] == '\n'))
+		end--;
+	return make_ref(start, end);
+}
+
+void CL_XMLReader_Generic::add_attribute(const CL_StringRef &name, const CL_StringRef &value)
+{
+	if (num_attributes == (int)attributes.size())
+		attributes.push_back(AttributeRef());
+	attributes[num_attributes].name = name;
+	attributes[num_attributes].value = value;
+	num_attributes++;
+}
@@ -0,0 +1,124 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#pragma once
+
+#include "API/Core/IOData/iodevice.h"
+#include "API/Core/System/databuffer.h"
+#include "API/Core/XML/xml_token.h"
+#include <vector>
+
+class CL_XMLReader_Generic
+{
+/// \name Construction
+/// \{
+
+public:
+	CL_XMLReader_Generic();
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	struct AttributeRef
+	{
+		CL_StringRef name;
+		CL_StringRef value;
+	};
+
+	CL_IODevice input;
+	CL_DataBuffer buffer;
+
+	/// \brief Start of the buffered data (the read buffer or the external memory block).
+	const char *data;
+	int data_size;
+	int pos;
+	bool end_of_input;
+	bool bom_checked;
+
+	/// \brief Number of line breaks before line_pos, including the ones already discarded from the buffer.
+	int line_count;
+
+	/// \brief Position in data up to which line breaks have been counted.
+	int line_pos;
+
+	bool eat_whitespace;
+	int depth;
+
+	CL_XMLToken::TokenType type;
+	CL_XMLToken::TokenVariant variant;
+	int token_start;
+	CL_StringRef name;
+	CL_StringRef value;
+
+	/// \brief Attribute slots, reused between nodes. Only the first num_attributes are valid.
+	std::vector<AttributeRef> attributes;
+	int num_attributes;
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	bool read();
+
+	int get_line_number() const;
+
+	static void throw_exception(const CL_StringRef &str);
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	enum ParseResult
+	{
+		parse_ok,
+		parse_skip,
+		parse_need_data
+	};
+
+	ParseResult parse_text();
+	ParseResult parse_tag();
+	ParseResult parse_exclamation_mark(int p);
+	bool fill_buffer();
+	void check_bom();
+
+	/// \brief Advances line_count and line_pos to position p
+	void count_lines(int p);
+
+	int find(int p, char c) const;
+	int find(int p, const char *str, int length) const;
+	int find_first_of(int p, const char *chars) const;
+	int skip_whitespace(int p) const;
+	CL_StringRef make_ref(int start, int end) const;
+	CL_StringRef trim_whitespace(int start, int end) const;
+	void add_attribute(const CL_StringRef &name, const CL_StringRef &value);
+/// \}
+};
@@ -31,6 +31,7 @@
 #include "API/Core/XML/xpath_evaluator.h"
 #include "API/Core/XML/xpath_exception.h"
 #include "API/Core/XML/dom_node.h"
+#include "API/Core/Math/cl_math.h"
 #include "xpath_evaluator_impl.h"
 #include "xpath_token.h"
 
@@ -47,10 +48,28 @@ CL_XPathEvaluator::CL_XPathEvaluator()
 
 CL_XPathObject CL_XPathEvaluator::evaluate(const CL_StringRef &expression, const CL_DomNode &context_node) const
 {
-	CL_XPathToken prev_token;
-	std::vector<CL_DomNode> nodelist(1, context_node);
-	CL_XPathEvaluateResult result = impl->evaluate(expression, nodelist, 0, prev_token);
-	if (result.next_token.type != CL_XPathToken::type_none)
-		throw CL_XPathException("Expected end of expression", expression, result.next_token);
-	return result.result;
+	CL_SharedPtr<CL_XPathExpression_Impl> compiled = impl->get_cached_expression(expression);
+	return impl->evaluate(*compiled, context_node);
+}
+
+CL_XPathObject CL_XPathEvaluator::evaluate(const CL_XPathExpression &expression, const CL_DomNode &context_node) const
+{
+	if (expression.is_null())
+		throw CL_XPathException("Null XPath expression");
+	return impl->evaluate(*expression.impl, context_node);
+}
+
+CL_XPathExpression CL_XPathEvaluator::compile(const CL_StringRef &expression) const
+{
+	return CL_XPathExpression(impl->get_cached_expression(expression));
+}
+
+void CL_XPathEvaluator::set_cache_size(int max_expressions)
+{
+	CL_XPathEvaluator_Impl::set_cache_size(cl_max(max_expressions, 0));
+}
+
+void CL_XPathEvaluator::clear_cache()
+{
+	CL_XPathEvaluator_Impl::clear_cache();
 }
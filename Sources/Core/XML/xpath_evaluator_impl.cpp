@@ -43,12 +43,120 @@
 #include <cmath>
 #include <limits>
 
+CL_Mutex CL_XPathEvaluator_Impl::cache_mutex;
+CL_XPathEvaluator_Impl::CacheList CL_XPathEvaluator_Impl::cache_list;
+std::map<CL_StringRef, CL_XPathEvaluator_Impl::CacheList::iterator> CL_XPathEvaluator_Impl::cache_index;
+unsigned int CL_XPathEvaluator_Impl::cache_size = 64;
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_XPathEvaluator_Impl Operations:
 
+CL_XPathObject CL_XPathEvaluator_Impl::evaluate(
+	const CL_XPathExpression_Impl &expression,
+	const CL_DomNode &context_node) const
+{
+	if (expression.simple_path)
+	{
+		CL_DomNode start_node = context_node;
+		if (expression.absolute_path)
+		{
+			while (true)
+			{
+				CL_DomNode parent = start_node.get_parent_node();
+				if (parent.is_null())
+					break;
+				start_node = parent;
+			}
+		}
+
+		CL_XPathNodeSet nodes;
+		select_nodes_simple_path(start_node, expression.simple_steps, 0, nodes);
+		return CL_XPathObject(nodes);
+	}
+	else
+	{
+		CL_XPathNodeSet nodelist(1, context_node);
+		CL_XPathEvaluateResult result = evaluate(expression, nodelist, 0, CL_XPathToken());
+		if (result.next_token.type != CL_XPathToken::type_none)
+			throw CL_XPathException("Expected end of expression", expression.text, result.next_token);
+		return result.result;
+	}
+}
+
+CL_SharedPtr<CL_XPathExpression_Impl> CL_XPathEvaluator_Impl::compile(const CL_StringRef &expression) const
+{
+	CL_SharedPtr<CL_XPathExpression_Impl> compiled(new CL_XPathExpression_Impl);
+	compiled->text = expression;
+
+	CL_XPathToken token;
+	do
+	{
+		token = scan_token(compiled->text, token);
+		compiled->tokens.push_back(token);
+	} while (token.type != CL_XPathToken::type_none);
+
+	compiled->token_at.resize(compiled->text.length() + 1);
+	unsigned int token_index = 0;
+	for (CL_String::size_type pos = 0; pos < compiled->token_at.size(); pos++)
+	{
+		while (compiled->tokens[token_index].pos < pos)
+			token_index++;
+		compiled->token_at[pos] = token_index;
+	}
+
+	find_simple_path(*compiled);
+	return compiled;
+}
+
+CL_SharedPtr<CL_XPathExpression_Impl> CL_XPathEvaluator_Impl::get_cached_expression(const CL_StringRef &expression) const
+{
+	{
+		CL_MutexSection mutex_lock(&cache_mutex);
+		std::map<CL_StringRef, CacheList::iterator>::iterator it = cache_index.find(expression);
+		if (it != cache_index.end())
+		{
+			cache_list.splice(cache_list.begin(), cache_list, it->second);
+			return cache_list.front();
+		}
+	}
+
+	CL_SharedPtr<CL_XPathExpression_Impl> compiled = compile(expression);
+
+	CL_MutexSection mutex_lock(&cache_mutex);
+	if (cache_size > 0 && cache_index.find(compiled->text) == cache_index.end())
+	{
+		cache_list.push_front(compiled);
+		cache_index[CL_StringRef(compiled->text)] = cache_list.begin();
+		while (cache_list.size() > cache_size)
+		{
+			cache_index.erase(CL_StringRef(cache_list.back()->text));
+			cache_list.pop_back();
+		}
+	}
+	return compiled;
+}
+
+void CL_XPathEvaluator_Impl::set_cache_size(unsigned int max_expressions)
+{
+	CL_MutexSection mutex_lock(&cache_mutex);
+	cache_size = max_expressions;
+	while (cache_list.size() > cache_size)
+	{
+		cache_index.erase(CL_StringRef(cache_list.back()->text));
+		cache_list.pop_back();
+	}
+}
+
+void CL_XPathEvaluator_Impl::clear_cache()
+{
+	CL_MutexSection mutex_lock(&cache_mutex);
+	cache_index.clear();
+	cache_list.clear();
+}
+
 
 CL_XPathEvaluateResult CL_XPathEvaluator_Impl::evaluate(
-	const CL_StringRef &expression,
+	const CL_XPathExpression_Impl &expression,
 	const CL_XPathNodeSet &context,
 	CL_XPathNodeSet::size_type context_node_index,
 	CL_XPathToken prev_token) const
@@ -110,7 +218,7 @@ CL_XPathEvaluateResult CL_XPathEvaluator_Impl::evaluate(
 			if (cur_token.type != CL_XPathToken::type_operator ||
 				cur_token.value.oper != CL_XPathToken::operator_parenthesis_begin)
 			{
-				throw CL_XPathException("Expected '(' after function name", expression, cur_token);
+				throw CL_XPathException("Expected '(' after function name", expression.text, cur_token);
 			}
 
 			std::vector<CL_XPathObject> parameters;
@@ -125,7 +233,7 @@ CL_XPathEvaluateResult CL_XPathEvaluator_Impl::evaluate(
 					cur_token.value.oper == CL_XPathToken::operator_parenthesis_end)
 					break;
 				if (cur_token.type != CL_XPathToken::type_comma)
-					throw CL_XPathException("Expected ',' or ')' in function call", expression, cur_token);
+					throw CL_XPathException("Expected ',' or ')' in function call", expression.text, cur_token);
 			}
 
 			CL_XPathObject obj = call_function(context, context_node_index, function_name, parameters);
@@ -134,19 +242,19 @@ CL_XPathEvaluateResult CL_XPathEvaluator_Impl::evaluate(
 		else if (cur_token.type == CL_XPathToken::type_bracket_begin)
 		{
 			if (operand_stack.empty())
-				throw CL_XPathException("Missing operand before predicate", expression, cur_token);
+				throw CL_XPathException("Missing operand before predicate", expression.text, cur_token);
 
 			Operand cur_operand = operand_stack.back();
 			operand_stack.pop_back();
 			if (cur_operand.get_type() != CL_XPathObject::type_node_set)
-				throw CL_XPathException("Expected node-set operand before '['", expression, cur_token);
+				throw CL_XPathException("Expected node-set operand before '['", expression.text, cur_token);
 
 			CL_XPathToken end_token = cur_token;
 			while (end_token.type != CL_XPathToken::type_bracket_end && end_token.type != CL_XPathToken::type_none)
 				end_token = read_token(expression, end_token);
 
 			if (end_token.type == CL_XPathToken::type_none)
-				throw CL_XPathException("Missing matching ']' in expression", expression, cur_token);
+				throw CL_XPathException("Missing matching ']' in expression", expression.text, cur_token);
 
 			CL_XPathLocationStep::Predicate predicate;
 			predicate.pos = cur_token.pos + cur_token.length;
@@ -200,7 +308,7 @@ CL_XPathEvaluateResult CL_XPathEvaluator_Impl::evaluate(
 		}
 		else
 		{
-			throw CL_XPathException("Unexpected token", expression, cur_token);
+			throw CL_XPathException("Unexpected token", expression.text, cur_token);
 		}
 
 		prev_token = cur_token;
@@ -215,7 +323,7 @@ CL_XPathEvaluateResult CL_XPathEvaluator_Impl::evaluate(
 			cur_token.type == CL_XPathToken::type_operator &&
 			cur_token.value.oper == CL_XPathToken::operator_parenthesis_end))
 	{
-		throw CL_XPathException("Expected operand", expression, cur_token);
+		throw CL_XPathException("Expected operand", expression.text, cur_token);
 	}
 
 	CL_XPathEvaluateResult result;
@@ -886,7 +994,7 @@ bool CL_XPathEvaluator_Impl::compare_string(const Operand &a, const Operand &b,
 }
 
 CL_XPathToken CL_XPathEvaluator_Impl::read_location_path(
-	const CL_StringRef &expression,
+	const CL_XPathExpression_Impl &expression,
 	CL_XPathToken cur_token,
 	const CL_XPathNodeSet &context,
 	CL_XPathNodeSet::size_type context_node_index,
@@ -945,13 +1053,32 @@ CL_XPathToken CL_XPathEvaluator_Impl::read_location_path(
 }
 
 CL_XPathToken CL_XPathEvaluator_Impl::read_location_steps(
-	const CL_StringRef &expression,
+	const CL_XPathExpression_Impl &expression,
 	CL_XPathToken cur_token,
 	const CL_XPathNodeSet &context,
 	CL_XPathNodeSet::size_type context_node_index,
 	std::vector<CL_XPathEvaluator_Impl::Operand> &operand_stack) const
 {
-	std::vector<CL_XPathLocationStep> steps;
+	const CL_XPathExpression_Impl::LocationSteps *location_steps = expression.find_location_steps(cur_token.pos);
+	if (location_steps == 0)
+	{
+		CL_XPathExpression_Impl::LocationSteps parsed;
+		CL_String::size_type start_pos = cur_token.pos;
+		parsed.end_token = read_location_steps(expression, cur_token, parsed.steps);
+		location_steps = expression.add_location_steps(start_pos, parsed);
+	}
+
+	CL_XPathNodeSet nodeset;
+	evaluate_location_step(context, context_node_index, location_steps->steps, 0, expression, nodeset);
+	operand_stack.push_back(CL_XPathObject(nodeset));
+	return location_steps->end_token;
+}
+
+CL_XPathToken CL_XPathEvaluator_Impl::read_location_steps(
+	const CL_XPathExpression_Impl &expression,
+	CL_XPathToken cur_token,
+	std::vector<CL_XPathLocationStep> &steps) const
+{
 	while (true)
 	{
 		CL_XPathLocationStep step;
@@ -983,15 +1110,11 @@ CL_XPathToken CL_XPathEvaluator_Impl::read_location_steps(
 			break;
 		}
 	}
-
-	CL_XPathNodeSet nodeset;
-	evaluate_location_step(context, context_node_index, steps, 0, expression, nodeset);
-	operand_stack.push_back(CL_XPathObject(nodeset));
 	return cur_token;
 }
 
 CL_XPathToken CL_XPathEvaluator_Impl::read_location_step(
-	const CL_StringRef &expression,
+	const CL_XPathExpression_Impl &expression,
 	CL_XPathToken cur_token,
 	CL_XPathLocationStep &step) const
 {
@@ -1019,19 +1142,19 @@ CL_XPathToken CL_XPathEvaluator_Impl::read_location_step(
 */
 	if (cur_token.type == CL_XPathToken::type_dot)
 	{
-		step.axis = "self";
+		step.axis = CL_XPathLocationStep::axis_self;
 		step.test_type = CL_XPathLocationStep::type_node;
 		step.node_type = CL_XPathToken::node_type_node;
 	}
 	else if (cur_token.type == CL_XPathToken::type_double_dot)
 	{
-		step.axis = "parent";
+		step.axis = CL_XPathLocationStep::axis_parent;
 		step.test_type = CL_XPathLocationStep::type_node;
 		step.node_type = CL_XPathToken::node_type_node;
 	}
 	else if (cur_token.type == CL_XPathToken::type_operator && cur_token.value.oper == CL_XPathToken::operator_double_slash)
 	{
-		step.axis = "descendant-or-self";
+		step.axis = CL_XPathLocationStep::axis_descendant_or_self;
 		step.test_type = CL_XPathLocationStep::type_node;
 		step.node_type = CL_XPathToken::node_type_node;
 	}
@@ -1040,20 +1163,20 @@ CL_XPathToken CL_XPathEvaluator_Impl::read_location_step(
 		// Read AxisSpecifier:
 		if (cur_token.type == CL_XPathToken::type_axis_name)
 		{
-			step.axis = cur_token.value.str;
+			step.axis = get_axis(expression, cur_token);
 			cur_token = read_token(expression, cur_token);
 			if (cur_token.type != CL_XPathToken::type_double_colon)
-				throw CL_XPathException("Expected '::' after axis name", expression, cur_token);
+				throw CL_XPathException("Expected '::' after axis name", expression.text, cur_token);
 			cur_token = read_token(expression, cur_token);
 		}
 		else if (cur_token.type == CL_XPathToken::type_at_sign) // Abbreviated axis specifier
 		{
-			step.axis = "attribute";
+			step.axis = CL_XPathLocationStep::axis_attribute;
 			cur_token = read_token(expression, cur_token);
 		}
 		else // Abbreviated syntax
 		{
-			step.axis = "child";
+			step.axis = CL_XPathLocationStep::axis_child;
 		}
 
 		// Read Node Test:
@@ -1068,7 +1191,7 @@ CL_XPathToken CL_XPathEvaluator_Impl::read_location_step(
 			step.node_type = cur_token.value.node_type;
 			cur_token = read_token(expression, cur_token);
 			if (cur_token.type != CL_XPathToken::type_operator || cur_token.value.oper != CL_XPathToken::operator_parenthesis_begin)
-				throw CL_XPathException("Expected '(' after node-type test", expression, cur_token);
+				throw CL_XPathException("Expected '(' after node-type test", expression.text, cur_token);
 			cur_token = read_token(expression, cur_token);
 			if (cur_token.type == CL_XPathToken::type_literal && step.node_type == CL_XPathToken::node_type_processing_instruction)
 			{
@@ -1076,11 +1199,11 @@ CL_XPathToken CL_XPathEvaluator_Impl::read_location_step(
 				cur_token = read_token(expression, cur_token);
 			}
 			if (cur_token.type != CL_XPathToken::type_operator || cur_token.value.oper != CL_XPathToken::operator_parenthesis_end)
-				throw CL_XPathException("Expected ')' after node-type test", expression, cur_token);
+				throw CL_XPathException("Expected ')' after node-type test", expression.text, cur_token);
 		}
 		else
 		{
-			throw CL_XPathException("Unknown node test type", expression, cur_token);
+			throw CL_XPathException("Unknown node test type", expression.text, cur_token);
 		}
 
 		CL_XPathToken next_token = read_token(expression, cur_token);
@@ -1097,7 +1220,132 @@ CL_XPathToken CL_XPathEvaluator_Impl::read_location_step(
 	return cur_token;
 }
 
-CL_XPathToken CL_XPathEvaluator_Impl::skip_predicate_expression(const CL_StringRef &expression, const CL_XPathToken &previous_token) const
+void CL_XPathEvaluator_Impl::find_simple_path(CL_XPathExpression_Impl &expression) const
+{
+	// Recognizes expressions of the form [/]step/step/.../[@]step where each step is
+	// a child name test (optionally with 'child::') and only the last step may be an
+	// attribute. Such paths never need the generic evaluator.
+
+	std::vector<CL_XPathToken>::size_type index = 0;
+	const std::vector<CL_XPathToken> &tokens = expression.tokens;
+
+	bool absolute_path = false;
+	if (tokens[index].type == CL_XPathToken::type_operator && tokens[index].value.oper == CL_XPathToken::operator_slash)
+	{
+		absolute_path = true;
+		index++;
+	}
+
+	std::vector<CL_XPathLocationStep> steps;
+	while (true)
+	{
+		CL_XPathLocationStep step;
+		step.axis = CL_XPathLocationStep::axis_child;
+		step.test_type = CL_XPathLocationStep::type_name;
+
+		if (tokens[index].type == CL_XPathToken::type_at_sign)
+		{
+			step.axis = CL_XPathLocationStep::axis_attribute;
+			index++;
+		}
+		else if (tokens[index].type == CL_XPathToken::type_axis_name)
+		{
+			if (tokens[index].value.str == "attribute")
+				step.axis = CL_XPathLocationStep::axis_attribute;
+			else if (tokens[index].value.str != "child")
+				return;
+			if (tokens[index + 1].type != CL_XPathToken::type_double_colon)
+				return;
+			index += 2;
+		}
+
+		if (tokens[index].type != CL_XPathToken::type_name_test)
+			return;
+		step.test_str = tokens[index].value.str;
+		steps.push_back(step);
+		index++;
+
+		if (tokens[index].type == CL_XPathToken::type_none)
+			break;
+		else if (step.axis == CL_XPathLocationStep::axis_attribute)
+			return;
+		else if (tokens[index].type != CL_XPathToken::type_operator || tokens[index].value.oper != CL_XPathToken::operator_slash)
+			return;
+		index++;
+	}
+
+	expression.simple_path = true;
+	expression.absolute_path = absolute_path;
+	expression.simple_steps = steps;
+}
+
+void CL_XPathEvaluator_Impl::select_nodes_simple_path(const CL_DomNode &node, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, CL_XPathNodeSet &nodes) const
+{
+	const CL_XPathLocationStep &step = steps[step_index];
+	bool any_name = (step.test_str == "*");
+	if (step.axis == CL_XPathLocationStep::axis_attribute)
+	{
+		CL_DomNamedNodeMap attributes = node.get_attributes();
+		unsigned long num_attributes = attributes.get_length();
+		for (unsigned long idx = 0; idx < num_attributes; idx++)
+		{
+			CL_DomNode attribute = attributes.item(idx);
+			if (any_name || attribute.get_node_name() == step.test_str)
+				nodes.push_back(attribute);
+		}
+	}
+	else
+	{
+		bool last_step = (step_index + 1 == steps.size());
+		CL_DomNode cur_node = node.get_first_child();
+		while (!cur_node.is_null())
+		{
+			if (cur_node.is_element() && (any_name || cur_node.get_node_name() == step.test_str))
+			{
+				if (last_step)
+					nodes.push_back(cur_node);
+				else
+					select_nodes_simple_path(cur_node, steps, step_index + 1, nodes);
+			}
+			cur_node = cur_node.get_next_sibling();
+		}
+	}
+}
+
+CL_XPathLocationStep::Axis CL_XPathEvaluator_Impl::get_axis(const CL_XPathExpression_Impl &expression, const CL_XPathToken &token) const
+{
+	const CL_String &name = token.value.str;
+	if (name == "ancestor")
+		return CL_XPathLocationStep::axis_ancestor;
+	else if (name == "ancestor-or-self")
+		return CL_XPathLocationStep::axis_ancestor_or_self;
+	else if (name == "attribute")
+		return CL_XPathLocationStep::axis_attribute;
+	else if (name == "child")
+		return CL_XPathLocationStep::axis_child;
+	else if (name == "descendant")
+		return CL_XPathLocationStep::axis_descendant;
+	else if (name == "descendant-or-self")
+		return CL_XPathLocationStep::axis_descendant_or_self;
+	else if (name == "following")
+		return CL_XPathLocationStep::axis_following;
+	else if (name == "following-sibling")
+		return CL_XPathLocationStep::axis_following_sibling;
+	else if (name == "namespace")
+		return CL_XPathLocationStep::axis_namespace;
+	else if (name == "parent")
+		return CL_XPathLocationStep::axis_parent;
+	else if (name == "preceding")
+		return CL_XPathLocationStep::axis_preceding;
+	else if (name == "preceding-sibling")
+		return CL_XPathLocationStep::axis_preceding_sibling;
+	else if (name == "self")
+		return CL_XPathLocationStep::axis_self;
+	else
+		throw CL_XPathException(cl_format("Unknown location step axis '%1'", name), expression.text, token);
+}
+
+CL_XPathToken CL_XPathEvaluator_Impl::skip_predicate_expression(const CL_XPathExpression_Impl &expression, const CL_XPathToken &previous_token) const
 {
 	int bracket_count = 1;
 	CL_XPathToken cur_token = previous_token;
@@ -1122,38 +1370,52 @@ CL_XPathToken CL_XPathEvaluator_Impl::skip_predicate_expression(const CL_StringR
 	return cur_token;
 }
 
-void CL_XPathEvaluator_Impl::evaluate_location_step(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_StringRef &expression, CL_XPathNodeSet &nodes) const
+void CL_XPathEvaluator_Impl::evaluate_location_step(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_XPathExpression_Impl &expression, CL_XPathNodeSet &nodes) const
 {
 	if (step_index < steps.size())
 	{
-		if (steps[step_index].axis == "ancestor")
+		switch (steps[step_index].axis)
+		{
+		case CL_XPathLocationStep::axis_ancestor:
 			select_nodes_ancestor(context, context_node_index, steps, step_index, expression, nodes);
-		else if (steps[step_index].axis == "ancestor-or-self")
+			break;
+		case CL_XPathLocationStep::axis_ancestor_or_self:
 			select_nodes_ancestor_or_self(context, context_node_index, steps, step_index, expression, nodes);
-		else if (steps[step_index].axis == "attribute")
+			break;
+		case CL_XPathLocationStep::axis_attribute:
 			select_nodes_attribute(context, context_node_index, steps, step_index, expression, nodes);
-		else if (steps[step_index].axis == "child")
+			break;
+		case CL_XPathLocationStep::axis_child:
 			select_nodes_child(context, context_node_index, steps, step_index, expression, nodes);
-		else if (steps[step_index].axis == "descendant")
+			break;
+		case CL_XPathLocationStep::axis_descendant:
 			select_nodes_descendant(context, context_node_index, steps, step_index, expression, nodes);
-		else if (steps[step_index].axis == "descendant-or-self")
+			break;
+		case CL_XPathLocationStep::axis_descendant_or_self:
 			select_nodes_descendant_or_self(context, context_node_index, steps, step_index, expression, nodes);
-		else if (steps[step_index].axis == "following")
+			break;
+		case CL_XPathLocationStep::axis_following:
 			select_nodes_following(context, context_node_index, steps, step_index, expression, nodes);
-		else if (steps[step_index].axis == "follwing-sibling")
+			break;
+		case CL_XPathLocationStep::axis_following_sibling:
 			select_nodes_following_sibling(context, context_node_index, steps, step_index, expression, nodes);
-		else if (steps[step_index].axis == "namespace")
+			break;
+		case CL_XPathLocationStep::axis_namespace:
 			select_nodes_namespace(context, context_node_index, steps, step_index, expression, nodes);
-		else if (steps[step_index].axis == "parent")
+			break;
+		case CL_XPathLocationStep::axis_parent:
 			select_nodes_parent(context, context_node_index, steps, step_index, expression, nodes);
-		else if (steps[step_index].axis == "preceding")
+			break;
+		case CL_XPathLocationStep::axis_preceding:
 			select_nodes_preceding(context, context_node_index, steps, step_index, expression, nodes);
-		else if (steps[step_index].axis == "preceding-sibling")
+			break;
+		case CL_XPathLocationStep::axis_preceding_sibling:
 			select_nodes_preceding_sibling(context, context_node_index, steps, step_index, expression, nodes);
-		else if (steps[step_index].axis == "self")
+			break;
+		case CL_XPathLocationStep::axis_self:
 			select_nodes_self(context, context_node_index, steps, step_index, expression, nodes);
-		else
-			throw CL_XPathException(cl_format("Unknown location step axis", steps[step_index].axis), expression);
+			break;
+		}
 	}
 	else
 	{
@@ -1161,7 +1423,7 @@ void CL_XPathEvaluator_Impl::evaluate_location_step(const CL_XPathNodeSet &conte
 	}
 }
 
-void CL_XPathEvaluator_Impl::select_nodes_ancestor(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_StringRef &expression, CL_XPathNodeSet &nodes) const
+void CL_XPathEvaluator_Impl::select_nodes_ancestor(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_XPathExpression_Impl &expression, CL_XPathNodeSet &nodes) const
 {
 	CL_XPathNodeSet nodeset;
 	CL_DomNode parent = context[context_node_index].get_parent_node();
@@ -1176,7 +1438,7 @@ void CL_XPathEvaluator_Impl::select_nodes_ancestor(const CL_XPathNodeSet &contex
 	evaluate_location_step_predicates(nodeset, steps, step_index, expression, nodes);
 }
 
-void CL_XPathEvaluator_Impl::select_nodes_ancestor_or_self(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_StringRef &expression, CL_XPathNodeSet &nodes) const
+void CL_XPathEvaluator_Impl::select_nodes_ancestor_or_self(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_XPathExpression_Impl &expression, CL_XPathNodeSet &nodes) const
 {
 	CL_XPathNodeSet nodeset;
 	CL_DomNode parent = context[context_node_index];
@@ -1191,7 +1453,7 @@ void CL_XPathEvaluator_Impl::select_nodes_ancestor_or_self(const CL_XPathNodeSet
 	evaluate_location_step_predicates(nodeset, steps, step_index, expression, nodes);
 }
 
-void CL_XPathEvaluator_Impl::select_nodes_attribute(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_StringRef &expression, CL_XPathNodeSet &nodes) const
+void CL_XPathEvaluator_Impl::select_nodes_attribute(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_XPathExpression_Impl &expression, CL_XPathNodeSet &nodes) const
 {
 	CL_XPathNodeSet nodeset;
 	CL_DomNamedNodeMap attributes = context[context_node_index].get_attributes();
@@ -1206,7 +1468,7 @@ void CL_XPathEvaluator_Impl::select_nodes_attribute(const CL_XPathNodeSet &conte
 	evaluate_location_step_predicates(nodeset, steps, step_index, expression, nodes);
 }
 
-void CL_XPathEvaluator_Impl::select_nodes_child(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_StringRef &expression, CL_XPathNodeSet &nodes) const
+void CL_XPathEvaluator_Impl::select_nodes_child(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_XPathExpression_Impl &expression, CL_XPathNodeSet &nodes) const
 {
 	CL_XPathNodeSet nodeset;
 	CL_DomNode cur_node = context[context_node_index].get_first_child();
@@ -1220,7 +1482,7 @@ void CL_XPathEvaluator_Impl::select_nodes_child(const CL_XPathNodeSet &context,
 	evaluate_location_step_predicates(nodeset, steps, step_index, expression, nodes);
 }
 
-void CL_XPathEvaluator_Impl::select_nodes_descendant(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_StringRef &expression, CL_XPathNodeSet &nodes) const
+void CL_XPathEvaluator_Impl::select_nodes_descendant(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_XPathExpression_Impl &expression, CL_XPathNodeSet &nodes) const
 {
 	CL_XPathNodeSet parentNodes;
 	CL_XPathNodeSet nodeset;
@@ -1246,7 +1508,7 @@ void CL_XPathEvaluator_Impl::select_nodes_descendant(const CL_XPathNodeSet &cont
 	evaluate_location_step_predicates(nodeset, steps, step_index, expression, nodes);
 }
 
-void CL_XPathEvaluator_Impl::select_nodes_descendant_or_self(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_StringRef &expression, CL_XPathNodeSet &nodes) const
+void CL_XPathEvaluator_Impl::select_nodes_descendant_or_self(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_XPathExpression_Impl &expression, CL_XPathNodeSet &nodes) const
 {
 	CL_XPathNodeSet parentNodes;
 	CL_XPathNodeSet nodeset;
@@ -1272,7 +1534,7 @@ void CL_XPathEvaluator_Impl::select_nodes_descendant_or_self(const CL_XPathNodeS
 	evaluate_location_step_predicates(nodeset, steps, step_index, expression, nodes);
 }
 
-void CL_XPathEvaluator_Impl::select_nodes_following(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_StringRef &expression, CL_XPathNodeSet &nodes) const
+void CL_XPathEvaluator_Impl::select_nodes_following(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_XPathExpression_Impl &expression, CL_XPathNodeSet &nodes) const
 {
 	CL_XPathNodeSet nodeset;
 
@@ -1308,7 +1570,7 @@ void CL_XPathEvaluator_Impl::select_nodes_following(const CL_XPathNodeSet &conte
 	evaluate_location_step_predicates(nodeset, steps, step_index, expression, nodes);
 }
 
-void CL_XPathEvaluator_Impl::select_nodes_following_sibling(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_StringRef &expression, CL_XPathNodeSet &nodes) const
+void CL_XPathEvaluator_Impl::select_nodes_following_sibling(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_XPathExpression_Impl &expression, CL_XPathNodeSet &nodes) const
 {
 	CL_XPathNodeSet nodeset;
 	CL_DomNode cur_node = context[context_node_index].get_next_sibling();
@@ -1322,11 +1584,11 @@ void CL_XPathEvaluator_Impl::select_nodes_following_sibling(const CL_XPathNodeSe
 	evaluate_location_step_predicates(nodeset, steps, step_index, expression, nodes);
 }
 
-void CL_XPathEvaluator_Impl::select_nodes_namespace(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_StringRef &expression, CL_XPathNodeSet &nodes) const
+void CL_XPathEvaluator_Impl::select_nodes_namespace(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_XPathExpression_Impl &expression, CL_XPathNodeSet &nodes) const
 {
 }
 
-void CL_XPathEvaluator_Impl::select_nodes_parent(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_StringRef &expression, CL_XPathNodeSet &nodes) const
+void CL_XPathEvaluator_Impl::select_nodes_parent(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_XPathExpression_Impl &expression, CL_XPathNodeSet &nodes) const
 {
 	CL_XPathNodeSet nodeset;
 	CL_DomNode parent = context[context_node_index].get_parent_node();
@@ -1339,7 +1601,7 @@ void CL_XPathEvaluator_Impl::select_nodes_parent(const CL_XPathNodeSet &context,
 	evaluate_location_step_predicates(nodeset, steps, step_index, expression, nodes);
 }
 
-void CL_XPathEvaluator_Impl::select_nodes_preceding(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_StringRef &expression, CL_XPathNodeSet &nodes) const
+void CL_XPathEvaluator_Impl::select_nodes_preceding(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_XPathExpression_Impl &expression, CL_XPathNodeSet &nodes) const
 {
 	CL_XPathNodeSet nodeset;
 
@@ -1375,7 +1637,7 @@ void CL_XPathEvaluator_Impl::select_nodes_preceding(const CL_XPathNodeSet &conte
 	evaluate_location_step_predicates(nodeset, steps, step_index, expression, nodes);
 }
 
-void CL_XPathEvaluator_Impl::select_nodes_preceding_sibling(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_StringRef &expression, CL_XPathNodeSet &nodes) const
+void CL_XPathEvaluator_Impl::select_nodes_preceding_sibling(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_XPathExpression_Impl &expression, CL_XPathNodeSet &nodes) const
 {
 	CL_XPathNodeSet nodeset;
 	CL_DomNode cur_node = context[context_node_index].get_previous_sibling();
@@ -1389,7 +1651,7 @@ void CL_XPathEvaluator_Impl::select_nodes_preceding_sibling(const CL_XPathNodeSe
 	evaluate_location_step_predicates(nodeset, steps, step_index, expression, nodes);
 }
 
-void CL_XPathEvaluator_Impl::select_nodes_self(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_StringRef &expression, CL_XPathNodeSet &nodes) const
+void CL_XPathEvaluator_Impl::select_nodes_self(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_XPathExpression_Impl &expression, CL_XPathNodeSet &nodes) const
 {
 	CL_DomNode cur_node = context[context_node_index];
 	if (!cur_node.is_null())
@@ -1399,7 +1661,7 @@ void CL_XPathEvaluator_Impl::select_nodes_self(const CL_XPathNodeSet &context, C
 	}
 }
 
-bool CL_XPathEvaluator_Impl::confirm_step_requirements(const CL_DomNode &node, const CL_XPathLocationStep &step, const CL_StringRef &expression) const
+bool CL_XPathEvaluator_Impl::confirm_step_requirements(const CL_DomNode &node, const CL_XPathLocationStep &step, const CL_XPathExpression_Impl &expression) const
 {
 	bool test_passed = false;
 	switch (step.test_type)
@@ -1438,9 +1700,11 @@ bool CL_XPathEvaluator_Impl::confirm_step_requirements(const CL_DomNode &node, c
 	return test_passed;
 }
 
-bool CL_XPathEvaluator_Impl::confirm_step_predicate(CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const CL_XPathLocationStep::Predicate &predicate, const CL_StringRef &expression) const
+bool CL_XPathEvaluator_Impl::confirm_step_predicate(CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const CL_XPathLocationStep::Predicate &predicate, const CL_XPathExpression_Impl &expression) const
 {
-	CL_XPathEvaluateResult result = evaluate(expression.substr(predicate.pos, predicate.length), context, context_node_index, CL_XPathToken());
+	CL_XPathToken predicate_start;
+	predicate_start.pos = predicate.pos;
+	CL_XPathEvaluateResult result = evaluate(expression, context, context_node_index, predicate_start);
 	bool include_in_nodeset = false;
 	switch (result.result.get_type())
 	{
@@ -1462,7 +1726,7 @@ bool CL_XPathEvaluator_Impl::confirm_step_predicate(CL_XPathNodeSet &context, CL
 	return include_in_nodeset;
 }
 
-void CL_XPathEvaluator_Impl::evaluate_location_step_predicates(const CL_XPathNodeSet &context, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_StringRef &expression, CL_XPathNodeSet &nodes) const
+void CL_XPathEvaluator_Impl::evaluate_location_step_predicates(const CL_XPathNodeSet &context, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_XPathExpression_Impl &expression, CL_XPathNodeSet &nodes) const
 {
 	CL_XPathNodeSet nodeset = context;
 	for (std::vector<CL_XPathLocationStep::Predicate>::const_iterator pit = steps[step_index].predicates.begin(), pEnd = steps[step_index].predicates.end(); pit != pEnd; ++pit)
@@ -1480,7 +1744,14 @@ void CL_XPathEvaluator_Impl::evaluate_location_step_predicates(const CL_XPathNod
 		evaluate_location_step(nodeset, node_index, steps, step_index+1, expression, nodes);
 }
 
-CL_XPathToken CL_XPathEvaluator_Impl::read_token(
+const CL_XPathToken &CL_XPathEvaluator_Impl::read_token(
+	const CL_XPathExpression_Impl &expression,
+	const CL_XPathToken &previous_token) const
+{
+	return expression.read_token(previous_token);
+}
+
+CL_XPathToken CL_XPathEvaluator_Impl::scan_token(
 	const CL_StringRef &expression,
 	const CL_XPathToken &previous_token) const
 {
@@ -1489,7 +1760,7 @@ CL_XPathToken CL_XPathEvaluator_Impl::read_token(
 	if (pos == CL_StringRef::npos || expression.length() == pos)
 	{
 		CL_XPathToken token;
-		token.pos = pos;
+		token.pos = expression.length();
 		token.length = 0;
 		return token;
 	}
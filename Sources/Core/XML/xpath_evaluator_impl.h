@@ -32,6 +32,10 @@
 #include "API/Core/XML/xpath_object.h"
 #include "xpath_token.h"
 #include "xpath_location_step.h"
+#include "xpath_expression_impl.h"
+#include "API/Core/System/mutex.h"
+#include <list>
+#include <map>
 
 class CL_XPathEvaluateResult
 {
@@ -46,12 +50,23 @@ public:
 	typedef std::vector<CL_DomNode> CL_XPathNodeSet;
 
 public:
+	CL_XPathObject evaluate(
+		const CL_XPathExpression_Impl &expression,
+		const CL_DomNode &context_node) const;
+
 	CL_XPathEvaluateResult evaluate(
-		const CL_StringRef &expression,
+		const CL_XPathExpression_Impl &expression,
 		const CL_XPathNodeSet &context,
 		CL_XPathNodeSet::size_type context_node_index,
 		CL_XPathToken prev_token) const;
 
+	CL_SharedPtr<CL_XPathExpression_Impl> compile(const CL_StringRef &expression) const;
+
+	CL_SharedPtr<CL_XPathExpression_Impl> get_cached_expression(const CL_StringRef &expression) const;
+
+	static void set_cache_size(unsigned int max_expressions);
+	static void clear_cache();
+
 private:
 	typedef CL_XPathToken::Operator Operator;
 	typedef CL_XPathObject Operand;
@@ -74,50 +89,63 @@ private:
 	bool compare_string(const Operand &a, const Operand &b, Operator oper) const;
 
 	CL_XPathToken read_location_path(
-		const CL_StringRef &expression,
+		const CL_XPathExpression_Impl &expression,
 		CL_XPathToken cur_token,
 		const CL_XPathNodeSet &context,
 		CL_XPathNodeSet::size_type context_node_index,
 		std::vector<Operand> &operand_stack) const;
 
 	CL_XPathToken read_location_steps(
-		const CL_StringRef &expression,
+		const CL_XPathExpression_Impl &expression,
 		CL_XPathToken cur_token,
 		const CL_XPathNodeSet &context,
 		CL_XPathNodeSet::size_type context_node_index,
 		std::vector<CL_XPathEvaluator_Impl::Operand> &operand_stack) const;
 
+	CL_XPathToken read_location_steps(
+		const CL_XPathExpression_Impl &expression,
+		CL_XPathToken cur_token,
+		std::vector<CL_XPathLocationStep> &steps) const;
+
 	CL_XPathToken read_location_step(
-		const CL_StringRef &expression,
+		const CL_XPathExpression_Impl &expression,
 		CL_XPathToken cur_token,
 		CL_XPathLocationStep &step) const;
 
-	CL_XPathToken read_token(
-		const CL_StringRef &expression,
+	const CL_XPathToken &read_token(
+		const CL_XPathExpression_Impl &expression,
 		const CL_XPathToken &previous_token = CL_XPathToken()) const;
 
-	CL_XPathToken skip_predicate_expression(
+	CL_XPathToken scan_token(
 		const CL_StringRef &expression,
+		const CL_XPathToken &previous_token) const;
+
+	void find_simple_path(CL_XPathExpression_Impl &expression) const;
+	void select_nodes_simple_path(const CL_DomNode &node, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, CL_XPathNodeSet &out_nodeset) const;
+	CL_XPathLocationStep::Axis get_axis(const CL_XPathExpression_Impl &expression, const CL_XPathToken &token) const;
+
+	CL_XPathToken skip_predicate_expression(
+		const CL_XPathExpression_Impl &expression,
 		const CL_XPathToken &previous_token = CL_XPathToken()) const;
 
-	void evaluate_location_step(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_StringRef &expression, CL_XPathNodeSet &out_nodeset) const;
-	void evaluate_location_step_predicates(const CL_XPathNodeSet &context, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_StringRef & expression, CL_XPathNodeSet & nodes) const;
-
-	void select_nodes_ancestor(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_StringRef &expression, CL_XPathNodeSet &out_nodeset) const;
-	void select_nodes_ancestor_or_self(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_StringRef &expression, CL_XPathNodeSet &out_nodeset) const;
-	void select_nodes_attribute(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_StringRef &expression, CL_XPathNodeSet &out_nodeset) const;
-	void select_nodes_child(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_StringRef &expression, CL_XPathNodeSet &out_nodeset) const;
-	void select_nodes_descendant(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_StringRef &expression, CL_XPathNodeSet &out_nodeset) const;
-	void select_nodes_descendant_or_self(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_StringRef &expression, CL_XPathNodeSet &out_nodeset) const;
-	void select_nodes_following(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_StringRef &expression, CL_XPathNodeSet &out_nodeset) const;
-	void select_nodes_following_sibling(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_StringRef &expression, CL_XPathNodeSet &out_nodeset) const;
-	void select_nodes_namespace(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_StringRef &expression, CL_XPathNodeSet &out_nodeset) const;
-	void select_nodes_parent(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_StringRef &expression, CL_XPathNodeSet &out_nodeset) const;
-	void select_nodes_preceding(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_StringRef &expression, CL_XPathNodeSet &out_nodeset) const;
-	void select_nodes_preceding_sibling(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_StringRef &expression, CL_XPathNodeSet &out_nodeset) const;
-	void select_nodes_self(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_StringRef &expression, CL_XPathNodeSet &out_nodeset) const;
-	bool confirm_step_requirements(const CL_DomNode &node, const CL_XPathLocationStep &step, const CL_StringRef &expression) const;
-	bool confirm_step_predicate(CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const CL_XPathLocationStep::Predicate &predicate, const CL_StringRef &expression) const;
+	void evaluate_location_step(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_XPathExpression_Impl &expression, CL_XPathNodeSet &out_nodeset) const;
+	void evaluate_location_step_predicates(const CL_XPathNodeSet &context, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_XPathExpression_Impl &expression, CL_XPathNodeSet & nodes) const;
+
+	void select_nodes_ancestor(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_XPathExpression_Impl &expression, CL_XPathNodeSet &out_nodeset) const;
+	void select_nodes_ancestor_or_self(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_XPathExpression_Impl &expression, CL_XPathNodeSet &out_nodeset) const;
+	void select_nodes_attribute(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_XPathExpression_Impl &expression, CL_XPathNodeSet &out_nodeset) const;
+	void select_nodes_child(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_XPathExpression_Impl &expression, CL_XPathNodeSet &out_nodeset) const;
+	void select_nodes_descendant(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_XPathExpression_Impl &expression, CL_XPathNodeSet &out_nodeset) const;
+	void select_nodes_descendant_or_self(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_XPathExpression_Impl &expression, CL_XPathNodeSet &out_nodeset) const;
+	void select_nodes_following(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_XPathExpression_Impl &expression, CL_XPathNodeSet &out_nodeset) const;
+	void select_nodes_following_sibling(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_XPathExpression_Impl &expression, CL_XPathNodeSet &out_nodeset) const;
+	void select_nodes_namespace(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_XPathExpression_Impl &expression, CL_XPathNodeSet &out_nodeset) const;
+	void select_nodes_parent(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_XPathExpression_Impl &expression, CL_XPathNodeSet &out_nodeset) const;
+	void select_nodes_preceding(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_XPathExpression_Impl &expression, CL_XPathNodeSet &out_nodeset) const;
+	void select_nodes_preceding_sibling(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_XPathExpression_Impl &expression, CL_XPathNodeSet &out_nodeset) const;
+	void select_nodes_self(const CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const std::vector<CL_XPathLocationStep> &steps, std::vector<CL_XPathLocationStep>::size_type step_index, const CL_XPathExpression_Impl &expression, CL_XPathNodeSet &out_nodeset) const;
+	bool confirm_step_requirements(const CL_DomNode &node, const CL_XPathLocationStep &step, const CL_XPathExpression_Impl &expression) const;
+	bool confirm_step_predicate(CL_XPathNodeSet &context, CL_XPathNodeSet::size_type context_node_index, const CL_XPathLocationStep::Predicate &predicate, const CL_XPathExpression_Impl &expression) const;
 
 	CL_XPathObject call_function(const CL_XPathNodeSet& context, CL_XPathNodeSet::size_type context_node_index, const CL_StringRef &name, const std::vector<CL_XPathObject> &parameters) const;
 	CL_XPathObject get_variable(const CL_StringRef &name) const;
@@ -162,4 +190,11 @@ private:
 	static inline bool boolean(const CL_DomNode &node);
 	static inline double number(const CL_DomNode &node);
 	static inline CL_String string(const CL_DomNode &node);
+
+	typedef std::list<CL_SharedPtr<CL_XPathExpression_Impl> > CacheList;
+
+	static CL_Mutex cache_mutex;
+	static CacheList cache_list;
+	static std::map<CL_StringRef, CacheList::iterator> cache_index;
+	static unsigned int cache_size;
 };
@@ -0,0 +1,87 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#include "Core/precomp.h"
+#include "API/Core/XML/xpath_expression.h"
+#include "xpath_expression_impl.h"
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_XPathExpression Construction:
+
+CL_XPathExpression::CL_XPathExpression()
+{
+}
+
+CL_XPathExpression::CL_XPathExpression(const CL_SharedPtr<CL_XPathExpression_Impl> &impl)
+: impl(impl)
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_XPathExpression Attributes:
+
+CL_String CL_XPathExpression::get_text() const
+{
+	if (impl)
+		return impl->text;
+	else
+		return CL_String();
+}
+
+bool CL_XPathExpression::is_simple_path() const
+{
+	if (impl)
+		return impl->simple_path;
+	else
+		return false;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_XPathExpression_Impl Attributes:
+
+const CL_XPathExpression_Impl::LocationSteps *CL_XPathExpression_Impl::find_location_steps(CL_String::size_type pos) const
+{
+	CL_MutexSection mutex_lock(&mutex);
+	std::map<CL_String::size_type, LocationSteps>::const_iterator it = location_steps.find(pos);
+	if (it != location_steps.end())
+		return &it->second;
+	else
+		return 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_XPathExpression_Impl Operations:
+
+const CL_XPathExpression_Impl::LocationSteps *CL_XPathExpression_Impl::add_location_steps(CL_String::size_type pos, const LocationSteps &steps) const
+{
+	CL_MutexSection mutex_lock(&mutex);
+	std::map<CL_String::size_type, LocationSteps>::iterator it = location_steps.find(pos);
+	if (it == location_steps.end())
+		it = location_steps.insert(std::pair<CL_String::size_type, LocationSteps>(pos, steps)).first;
+	return &it->second;
+}
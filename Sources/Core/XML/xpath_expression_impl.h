@@ -0,0 +1,104 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#pragma once
+
+#include "API/Core/System/mutex.h"
+#include "xpath_token.h"
+#include "xpath_location_step.h"
+#include <map>
+
+class CL_XPathExpression_Impl
+{
+/// \name Construction
+/// \{
+
+public:
+	CL_XPathExpression_Impl()
+	: simple_path(false), absolute_path(false)
+	{
+	}
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	struct LocationSteps
+	{
+		std::vector<CL_XPathLocationStep> steps;
+		CL_XPathToken end_token;
+	};
+
+	/// \brief Expression text the tokens refer to.
+	CL_String text;
+
+	/// \brief All tokens of the expression, terminated by a type_none token.
+	std::vector<CL_XPathToken> tokens;
+
+	/// \brief Index of the first token starting at or after each character position.
+	std::vector<unsigned int> token_at;
+
+	/// \brief True if the expression is a plain child/attribute path without predicates.
+	bool simple_path;
+
+	/// \brief True if the simple path starts at the document root.
+	bool absolute_path;
+
+	/// \brief Location steps of a simple path.
+	std::vector<CL_XPathLocationStep> simple_steps;
+
+	/// \brief Returns the token following previous_token.
+	const CL_XPathToken &read_token(const CL_XPathToken &previous_token) const
+	{
+		CL_String::size_type pos = previous_token.pos + previous_token.length;
+		if (pos >= token_at.size())
+			return tokens.back();
+		return tokens[token_at[pos]];
+	}
+
+	/// \brief Returns the location steps previously parsed at a token position, or 0 if not parsed yet.
+	const LocationSteps *find_location_steps(CL_String::size_type pos) const;
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	/// \brief Stores the location steps parsed at a token position.
+	const LocationSteps *add_location_steps(CL_String::size_type pos, const LocationSteps &steps) const;
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	mutable CL_Mutex mutex;
+	mutable std::map<CL_String::size_type, LocationSteps> location_steps;
+/// \}
+};
@@ -34,10 +34,27 @@ class CL_XPathLocationStep
 {
 public:
 	CL_XPathLocationStep()
-	: test_type(type_none)
+	: axis(axis_child), test_type(type_none)
 	{
 	}
 
+	enum Axis
+	{
+		axis_ancestor,
+		axis_ancestor_or_self,
+		axis_attribute,
+		axis_child,
+		axis_descendant,
+		axis_descendant_or_self,
+		axis_following,
+		axis_following_sibling,
+		axis_namespace,
+		axis_parent,
+		axis_preceding,
+		axis_preceding_sibling,
+		axis_self
+	};
+
 	enum TestType
 	{
 		type_none,
@@ -45,7 +62,7 @@ public:
 		type_node,
 	};
 
-	CL_String axis;
+	Axis axis;
 	TestType test_type;
 	CL_String test_str;
 
@@ -66,6 +66,11 @@ int CL_DBCommand::get_output_last_insert_rowid() const
 	return impl->provider->get_output_last_insert_rowid();
 }
 
+int CL_DBCommand::get_batch_size() const
+{
+	return impl->provider->get_batch_size();
+}
+
 CL_DBCommandProvider *CL_DBCommand::get_provider()
 {
 	return impl->provider;
@@ -104,6 +109,11 @@ void CL_DBCommand::set_input_parameter_binary(int index, const CL_DataBuffer &va
 	impl->provider->set_input_parameter_binary(index, value);
 }
 
+void CL_DBCommand::add_batch()
+{
+	impl->provider->add_batch();
+}
+
 template<>
 void CL_DBCommand::set_input_parameter<int>(int index, int value)
 {
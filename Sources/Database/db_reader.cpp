@@ -183,6 +183,58 @@ bool CL_DBReader::retrieve_row()
 	return impl->provider->retrieve_row();
 }
 
+void CL_DBReader::bind_column(int index, int *values)
+{
+	impl->columns.push_back(CL_DBColumnArray(index, values));
+}
+
+void CL_DBReader::bind_column(int index, double *values)
+{
+	impl->columns.push_back(CL_DBColumnArray(index, values));
+}
+
+void CL_DBReader::bind_column(int index, CL_String *values)
+{
+	impl->columns.push_back(CL_DBColumnArray(index, values));
+}
+
+void CL_DBReader::bind_column(int index, CL_DateTime *values)
+{
+	impl->columns.push_back(CL_DBColumnArray(index, values));
+}
+
+void CL_DBReader::bind_column(const CL_StringRef &column_name, int *values)
+{
+	bind_column(get_name_index(column_name), values);
+}
+
+void CL_DBReader::bind_column(const CL_StringRef &column_name, double *values)
+{
+	bind_column(get_name_index(column_name), values);
+}
+
+void CL_DBReader::bind_column(const CL_StringRef &column_name, CL_String *values)
+{
+	bind_column(get_name_index(column_name), values);
+}
+
+void CL_DBReader::bind_column(const CL_StringRef &column_name, CL_DateTime *values)
+{
+	bind_column(get_name_index(column_name), values);
+}
+
+void CL_DBReader::unbind_columns()
+{
+	impl->columns.clear();
+}
+
+int CL_DBReader::retrieve_rows(int max_rows)
+{
+	if (max_rows <= 0)
+		return 0;
+	return impl->provider->retrieve_rows(max_rows, impl->columns);
+}
+
 void CL_DBReader::close()
 {
 	impl->provider->close();
@@ -54,6 +54,9 @@ public:
 
 public:
 	CL_DBReaderProvider *provider;
+
+	/// \brief Arrays bound with CL_DBReader::bind_column
+	std::vector<CL_DBColumnArray> columns;
 /// \}
 };
 
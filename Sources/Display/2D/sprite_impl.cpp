@@ -652,6 +652,24 @@ void CL_Sprite_Impl::create_textures(CL_GraphicContext &gc, const CL_SpriteDescr
 		texture_group_height = size.height;
 	}
 
+	// Frames are added to the texture group as one batch, which packs them tighter:
+	std::vector<CL_Size> group_frame_sizes;
+	for (it_frames = description_frames.begin(); it_frames != description_frames.end(); ++it_frames)
+	{
+		if (it_frames->type == CL_SpriteDescriptionFrame::type_pixelbuffer &&
+			texture_group_width >0 &&
+			it_frames->rect.get_width() <= texture_group_width &&
+			it_frames->rect.get_height() <= texture_group_height)
+		{
+			group_frame_sizes.push_back(it_frames->rect.get_size());
+		}
+	}
+
+	std::vector<CL_Subtexture> group_subtextures;
+	if (!group_frame_sizes.empty())
+		group_subtextures = texture_group.add(gc, group_frame_sizes);
+	std::vector<CL_Subtexture>::size_type next_group_subtexture = 0;
+
 	for (it_frames = description_frames.begin(); it_frames != description_frames.end(); ++it_frames)
 	{
 		CL_SpriteDescriptionFrame description_frame = (*it_frames);
@@ -663,7 +681,7 @@ void CL_Sprite_Impl::create_textures(CL_GraphicContext &gc, const CL_SpriteDescr
 				description_frame.rect.get_width() <= texture_group_width &&
 				description_frame.rect.get_height() <= texture_group_height)
 			{
-				CL_Subtexture subtexture = texture_group.add(gc, description_frame.rect.get_size());
+				CL_Subtexture subtexture = group_subtextures[next_group_subtexture++];
 				subtexture.get_texture().set_subimage(subtexture.get_geometry().get_top_left(), image, description_frame.rect);
 				subtexture.get_texture().set_mag_filter(linear_filter ? cl_filter_linear : cl_filter_nearest);
 				subtexture.get_texture().set_min_filter(linear_filter ? cl_filter_linear : cl_filter_nearest);
@@ -0,0 +1,209 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#include "Display/precomp.h"
+#include "API/Display/2D/sprite_load_task.h"
+#include "API/Display/Image/pixel_buffer.h"
+#include "API/Display/ImageProviders/provider_factory.h"
+#include "API/Display/Render/shared_gc_data.h"
+#include "API/Core/IOData/path_help.h"
+#include "API/Core/Resources/resource.h"
+#include "API/Core/Text/string_format.h"
+#include "API/Core/Text/string_help.h"
+#include "API/Core/XML/dom_element.h"
+#include <vector>
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SpriteLoadTask_Impl Class:
+
+class CL_SpriteLoadTask_Impl
+{
+public:
+	/// \brief Image files referenced by an image element of the sprite resource.
+	struct ImageSource
+	{
+		ImageSource() : is_sequence(false), start_index(0), skip_index(1), leading_zeroes(0) { }
+
+		bool is_sequence;
+		CL_String filename;
+		CL_String prefix;
+		CL_String suffix;
+		int start_index;
+		int skip_index;
+		int leading_zeroes;
+	};
+
+	struct DecodedImage
+	{
+		DecodedImage(const CL_String &filename, const CL_PixelBuffer &image) : filename(filename), image(image) { }
+
+		CL_String filename;
+		CL_PixelBuffer image;
+	};
+
+	CL_String get_sequence_filename(const ImageSource &source, int index) const;
+
+	CL_GraphicContext gc;
+	CL_String resource_id;
+	CL_ImageImportDescription import_desc;
+
+	CL_ResourceManager resources;
+	CL_VirtualDirectory directory;
+	std::vector<ImageSource> sources;
+	std::vector<DecodedImage> images;
+	CL_Sprite sprite;
+};
+
+CL_String CL_SpriteLoadTask_Impl::get_sequence_filename(const ImageSource &source, int index) const
+{
+	CL_String file_name = source.prefix;
+
+	CL_String frame_text = CL_StringHelp::int_to_text(index);
+	for (int zeroes_to_add = (source.leading_zeroes+1) - frame_text.length(); zeroes_to_add > 0; zeroes_to_add--)
+		file_name += "0";
+
+	return file_name + frame_text + source.suffix;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SpriteLoadTask Construction:
+
+CL_SpriteLoadTask::CL_SpriteLoadTask(CL_GraphicContext &gc, const CL_String &resource_id, const CL_ImageImportDescription &import_desc)
+: impl(new CL_SpriteLoadTask_Impl)
+{
+	impl->gc = gc;
+	impl->resource_id = resource_id;
+	impl->import_desc = import_desc;
+}
+
+CL_SpriteLoadTask::~CL_SpriteLoadTask()
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SpriteLoadTask Attributes:
+
+CL_Sprite CL_SpriteLoadTask::get_sprite() const
+{
+	return impl->sprite;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SpriteLoadTask Operations:
+
+void CL_SpriteLoadTask::prepare(CL_ResourceManager &resources)
+{
+	CL_Resource resource = resources.get_resource(impl->resource_id);
+	if (resource.get_type() != "sprite" && resource.get_type() != "sprite_description" && resource.get_type() != "image")
+		throw CL_Exception(cl_format("Resource '%1' is not of type 'sprite' or 'sprite_description' or 'image'", impl->resource_id));
+
+	impl->resources = resources;
+	impl->directory = resources.get_directory(resource);
+
+	// Collect the image files the same way CL_SpriteDescription does, so finish() finds all of them in the texture cache.
+	for (CL_DomNode cur_node = resource.get_element().get_first_child(); !cur_node.is_null(); cur_node = cur_node.get_next_sibling())
+	{
+		if (!cur_node.is_element())
+			continue;
+
+		CL_DomElement cur_element = cur_node.to_element();
+		CL_String tag_name = cur_element.get_tag_name();
+		if (tag_name != "image" && tag_name != "image-file")
+			continue;
+
+		CL_SpriteLoadTask_Impl::ImageSource source;
+		if (cur_element.has_attribute("fileseq"))
+		{
+			source.is_sequence = true;
+			if (cur_element.has_attribute("start_index"))
+				source.start_index = CL_StringHelp::text_to_int(cur_element.get_attribute("start_index"));
+			if (cur_element.has_attribute("skip_index"))
+				source.skip_index = CL_StringHelp::text_to_int(cur_element.get_attribute("skip_index"));
+			if (cur_element.has_attribute("leading_zeroes"))
+				source.leading_zeroes = CL_StringHelp::text_to_int(cur_element.get_attribute("leading_zeroes"));
+
+			source.prefix = cur_element.get_attribute("fileseq");
+			source.suffix = "." + CL_PathHelp::get_extension(source.prefix);
+			source.prefix.erase(source.prefix.length() - source.suffix.length(), source.prefix.length());
+		}
+		else
+		{
+			source.filename = cur_element.get_attribute("file");
+		}
+		impl->sources.push_back(source);
+	}
+}
+
+void CL_SpriteLoadTask::load()
+{
+	for (std::vector<CL_SpriteLoadTask_Impl::ImageSource>::size_type i = 0; i < impl->sources.size(); i++)
+	{
+		const CL_SpriteLoadTask_Impl::ImageSource &source = impl->sources[i];
+		if (source.is_sequence)
+		{
+			for (int index = source.start_index;; index += source.skip_index)
+			{
+				CL_String filename = impl->get_sequence_filename(source, index);
+				CL_PixelBuffer image;
+				try
+				{
+					image = CL_ImageProviderFactory::load(filename, impl->directory, CL_String());
+				}
+				catch (const CL_Exception&)
+				{
+					if (index == source.start_index)
+						throw;
+					break;
+				}
+				impl->images.push_back(CL_SpriteLoadTask_Impl::DecodedImage(filename, impl->import_desc.process(image)));
+			}
+		}
+		else
+		{
+			CL_PixelBuffer image = CL_ImageProviderFactory::load(source.filename, impl->directory, CL_String());
+			impl->images.push_back(CL_SpriteLoadTask_Impl::DecodedImage(source.filename, impl->import_desc.process(image)));
+		}
+	}
+}
+
+void CL_SpriteLoadTask::finish()
+{
+	// The cache only keeps weak references, so the textures are kept alive until the sprite owns them.
+	std::vector<CL_Texture> textures;
+	for (std::vector<CL_SpriteLoadTask_Impl::DecodedImage>::size_type i = 0; i < impl->images.size(); i++)
+	{
+		CL_PixelBuffer &image = impl->images[i].image;
+		CL_Texture texture(impl->gc, image.get_width(), image.get_height());
+		texture.set_subimage(CL_Point(0, 0), image, CL_Rect(image.get_size()), 0);
+		CL_SharedGCData::add_texture(texture, impl->images[i].filename, impl->directory, impl->import_desc);
+		textures.push_back(texture);
+	}
+	impl->images.clear();
+
+	impl->sprite = CL_Sprite(impl->gc, impl->resource_id, &impl->resources, impl->import_desc);
+}
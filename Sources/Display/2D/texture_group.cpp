@@ -69,7 +69,12 @@ int CL_TextureGroup::get_subtexture_count(unsigned int texture_index) const
 
 int CL_TextureGroup::get_texture_count() const
 {
-	return impl->root_nodes.size();
+	return impl->textures.size();
+}
+
+CL_RectPacker::PackingAlgorithm CL_TextureGroup::get_packing_algorithm() const
+{
+	return impl->packer.get_packing_algorithm();
 }
 
 CL_TextureGroup::TextureAllocationPolicy CL_TextureGroup::get_texture_allocation_policy() const
@@ -95,6 +100,11 @@ CL_Subtexture CL_TextureGroup::add(CL_GraphicContext &context, const CL_Size &si
 	return impl->add_new_node(context, size);
 }
 
+std::vector<CL_Subtexture> CL_TextureGroup::add(CL_GraphicContext &context, const std::vector<CL_Size> &sizes)
+{
+	return impl->add_batch(context, sizes);
+}
+
 void CL_TextureGroup::remove(CL_Subtexture &subtexture)
 {
 	impl->remove(subtexture);
@@ -102,7 +112,17 @@ void CL_TextureGroup::remove(CL_Subtexture &subtexture)
 
 void CL_TextureGroup::set_texture_allocation_policy(TextureAllocationPolicy policy)
 {
-	impl->texture_allocation_policy = policy;
+	impl->set_texture_allocation_policy(policy);
+}
+
+void CL_TextureGroup::set_packing_algorithm(CL_RectPacker::PackingAlgorithm algorithm)
+{
+	impl->packer.set_packing_algorithm(algorithm);
+}
+
+void CL_TextureGroup::repack(CL_GraphicContext &context, std::vector<CL_Subtexture> &subtextures)
+{
+	impl->repack(context, subtextures);
 }
 
 void CL_TextureGroup::insert_texture(CL_Texture &texture, const CL_Rect &texture_rect)
@@ -28,6 +28,7 @@
 
 #include "Display/precomp.h"
 #include "API/Display/2D/subtexture.h"
+#include "API/Display/Image/pixel_buffer.h"
 #include "API/Core/Math/point.h"
 #include "API/Core/Math/rect.h"
 #include "texture_group_impl.h"
@@ -36,19 +37,12 @@
 // CL_TextureGroup_Impl construction:
 
 CL_TextureGroup_Impl::CL_TextureGroup_Impl(const CL_Size &texture_sizes)
-: initial_texture_size(texture_sizes), active_root(NULL), next_id(0)
+: packer(texture_sizes), initial_texture_size(texture_sizes)
 {
 }
 
 CL_TextureGroup_Impl::~CL_TextureGroup_Impl()
 {
-	std::vector<RootNode *>::size_type index, size;
-	size = root_nodes.size();
-	for(index = 0; index < size; ++index)
-	{
-		root_nodes[index]->node.clear();
-		delete root_nodes[index];
-	}
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -56,37 +50,16 @@ CL_TextureGroup_Impl::~CL_TextureGroup_Impl()
 
 int CL_TextureGroup_Impl::get_subtexture_count() const
 {
-	int count = 0;
-
-	std::vector<RootNode *>::size_type index, size;
-	size = root_nodes.size();
-	for(index = 0; index < size; ++index)
-		count += root_nodes[index]->node.get_subtexture_count();
-
-	return count;
+	return packer.get_total_rect_count();
 }
 
 int CL_TextureGroup_Impl::get_subtexture_count(unsigned int texture_index) const
 {
-	int count = 0;
-
-	if(texture_index >= 0 && texture_index < root_nodes.size())
-		count = root_nodes[texture_index]->node.get_subtexture_count();
-
-	return count;
+	return packer.get_rect_count(texture_index);
 }
 
 std::vector<CL_Texture> CL_TextureGroup_Impl::get_textures() const
 {
-	std::vector<CL_Texture> textures;
-	
-	std::vector<RootNode *>::size_type index, size;
-	size = root_nodes.size();
-	for(index = 0; index < size; ++index)
-	{
-		textures.push_back(root_nodes[index]->texture);
-	}
-
 	return textures;
 }
 
@@ -95,255 +68,192 @@ std::vector<CL_Texture> CL_TextureGroup_Impl::get_textures() const
 
 CL_Subtexture CL_TextureGroup_Impl::add_new_node(CL_GraphicContext &context, const CL_Size &texture_size)
 {
+	CL_RectPacker::AllocatedRect allocation = allocate(context, packer, textures, texture_size);
+	return CL_Subtexture(textures[allocation.group_index], allocation.rect);
+}
+
+std::vector<CL_Subtexture> CL_TextureGroup_Impl::add_batch(CL_GraphicContext &context, const std::vector<CL_Size> &texture_sizes)
+{
+	std::vector<CL_RectPacker::AllocatedRect> allocations = allocate_batch(context, packer, textures, texture_sizes);
 
-	// Try inserting in current active texture
-	Node *node;
-	if (!active_root)
+	std::vector<CL_Subtexture> subtextures(allocations.size());
+	for (size_t i = 0; i < allocations.size(); i++)
+		subtextures[i] = CL_Subtexture(textures[allocations[i].group_index], allocations[i].rect);
+	return subtextures;
+}
+
+void CL_TextureGroup_Impl::repack(CL_GraphicContext &context, std::vector<CL_Subtexture> &subtextures)
+{
+	std::vector<int> source_indexes(subtextures.size());
+	std::vector<CL_Size> sizes(subtextures.size());
+	for (size_t i = 0; i < subtextures.size(); i++)
 	{
-		// Create an initial root, if it does not exist
-		node = NULL;
-		next_id = 1;
+		source_indexes[i] = find_texture(subtextures[i].get_texture());
+		if (source_indexes[i] == -1)
+			throw CL_Exception("Cannot find the SubTexture in the TextureGroup");
+		sizes[i] = subtextures[i].get_geometry().get_size();
 	}
-	else
+
+	// The new layout is built aside, so the group is left as it was if it does not fit.
+	// Inserted textures start out empty again and are reused:
+	CL_RectPacker new_packer(initial_texture_size, packer.get_allocation_policy(), packer.get_packing_algorithm());
+	std::vector<CL_Texture> new_textures;
+	for (size_t i = 0; i < inserted_textures.size(); i++)
 	{
-		node = active_root->node.insert(texture_size, next_id);
+		new_packer.add_group(inserted_textures[i].area);
+		new_textures.push_back(inserted_textures[i].texture);
 	}
+	int num_inserted = new_textures.size();
+
+	std::vector<CL_RectPacker::AllocatedRect> allocations = allocate_batch(context, new_packer, new_textures, sizes);
 
-	if(node == 0) // Couldn't find a fit in current active texture
+	// Download each source texture once, before anything is written, as an inserted texture
+	// can be both the source and the destination of sub textures:
+	std::vector<CL_PixelBuffer> source_pixels(textures.size());
+	for (size_t i = 0; i < subtextures.size(); i++)
 	{
-		// Search previous textures if policy says so
-		if(texture_allocation_policy == CL_TextureGroup::search_previous_textures)
-		{
-			std::vector<RootNode *>::size_type index, size;
-			size = root_nodes.size();
-			for(index = 0; index < size; ++index)
-			{
-				node = root_nodes[index]->node.insert(texture_size, next_id);
-				if(node)	// We found space in a previous texture
-					break;
-			}
-		}
+		int source_index = source_indexes[i];
+		if (source_pixels[source_index].is_null())
+			source_pixels[source_index] = textures[source_index].get_pixeldata();
+	}
 
-		if(node == 0) // Couldn't find a fit, so create a new texture
+	std::vector<CL_Subtexture> new_subtextures(subtextures.size());
+	for (size_t i = 0; i < subtextures.size(); i++)
+	{
+		int source_index = source_indexes[i];
+		CL_Texture &texture = new_textures[allocations[i].group_index];
+		texture.set_subimage(allocations[i].rect.get_top_left(), source_pixels[source_index], subtextures[i].get_geometry());
+		if (allocations[i].group_index >= num_inserted)
 		{
-			if(texture_size.width > initial_texture_size.width || texture_size.height > initial_texture_size.height)
-			{
-				// If the specified size is greater than the initial size,  then create a texture using the specified size
-				node = add_new_root(context, texture_size)->node.insert(texture_size, next_id);
-			}
-			else
-			{
-				node = add_new_root(context, initial_texture_size)->node.insert(texture_size, next_id);
-			}
+			texture.set_mag_filter(textures[source_index].get_mag_filter());
+			texture.set_min_filter(textures[source_index].get_min_filter());
 		}
-
-		if(node == 0)
-			throw CL_Exception("Unable to pack Texture into TextureGroup");
+		new_subtextures[i] = CL_Subtexture(texture, allocations[i].rect);
 	}
 
-	next_id++;
-
-	return CL_Subtexture(active_root->texture, node->image_rect);
-}
-
-CL_TextureGroup_Impl::RootNode *CL_TextureGroup_Impl::add_new_root(CL_GraphicContext &context, const CL_Size &texture_size)
-{
-	CL_Rect rect(CL_Point(0, 0), texture_size);
-	Node node(rect);
-
-	active_root = new RootNode();
-	active_root->texture = CL_Texture(context, texture_size);
-	active_root->node = node;
-	
-	root_nodes.push_back(active_root);
-
-	return active_root;
+	packer = new_packer;
+	textures.swap(new_textures);
+	subtextures.swap(new_subtextures);
 }
 
 void CL_TextureGroup_Impl::insert_texture(CL_Texture &texture, const CL_Rect &texture_rect)
 {
-	Node node(texture_rect);
-
-	active_root = new RootNode();
-	active_root->texture = texture;
-	active_root->node = node;
-
-	root_nodes.push_back(active_root);
-
+	packer.add_group(texture_rect);
+	textures.push_back(texture);
+	inserted_textures.push_back(InsertedTexture(texture, texture_rect));
 }
 
 void CL_TextureGroup_Impl::remove(CL_Subtexture &subtexture)
 {
 	// Find the texture
-	Node *node = NULL;
-	CL_Texture texture = subtexture.get_texture();
-	CL_Rect rect = subtexture.get_geometry();
+	int index = find_texture(subtexture.get_texture());
+	if (index == -1)
+		throw CL_Exception("Cannot find the SubTexture in the TextureGroup");
 
-	std::vector<RootNode *>::size_type index, size;
-	size = root_nodes.size();
-	for(index = 0; index < size; ++index)
-	{
-		// Find a texture match
-		if (root_nodes[index]->texture == texture )
-		{
-			node = root_nodes[index]->node.find_image_rect(rect);
-			break;
-		}
-	}
-	if (node)
+	try
 	{
-		node->clear();
-		if(root_nodes[index]->node.get_subtexture_count() <= 0)
-		{
-			root_nodes[index]->node.clear();
-			delete root_nodes[index];
-			root_nodes.erase(root_nodes.begin() + index);
-		}
-		if(root_nodes.empty())
-		{
-			active_root = 0;
-		}
-		else
-		{
-			active_root = root_nodes.back();
-		}
+		packer.remove(CL_RectPacker::AllocatedRect(index, subtexture.get_geometry()));
 	}
-	else
+	catch (const CL_Exception &)
 	{
 		throw CL_Exception("Cannot find the SubTexture in the TextureGroup");
 	}
-}
-
-/////////////////////////////////////////////////////////////////////////////
-// CL_TextureGroup_Impl::Node:
-
-CL_TextureGroup_Impl::Node::Node()
-{
-	child[0] = NULL;
-	child[1] = NULL;
 
-	id = 0;
-}
-
-CL_TextureGroup_Impl::Node::Node(const CL_Rect &new_rect)
-{
-	node_rect = new_rect;
-
-	child[0] = NULL;
-	child[1] = NULL;
+	if (packer.get_rect_count(index) <= 0)
+	{
+		for (size_t i = 0; i < inserted_textures.size(); i++)
+		{
+			if (inserted_textures[i].texture == textures[index])
+			{
+				inserted_textures.erase(inserted_textures.begin() + i);
+				break;
+			}
+		}
 
-	id = 0;
+		packer.remove_group(index);
+		textures.erase(textures.begin() + index);
+	}
 }
 
-CL_TextureGroup_Impl::Node::~Node()
+void CL_TextureGroup_Impl::set_texture_allocation_policy(CL_TextureGroup::TextureAllocationPolicy policy)
 {
-	clear();
+	texture_allocation_policy = policy;
+	if (policy == CL_TextureGroup::search_previous_textures)
+		packer.set_allocation_policy(CL_RectPacker::search_previous_groups);
+	else
+		packer.set_allocation_policy(CL_RectPacker::create_new_group);
 }
 
-int CL_TextureGroup_Impl::Node::get_subtexture_count() const
-{
-	int count = 0;
-
-	if(child[0])
-		count += child[0]->get_subtexture_count();
-	if(child[1])
-		count += child[1]->get_subtexture_count();
-
-	if(id)
-		count++;
-
-	return count;
-}
+/////////////////////////////////////////////////////////////////////////////
+// CL_TextureGroup_Impl implementation:
 
-void CL_TextureGroup_Impl::Node::clear()
+CL_RectPacker::AllocatedRect CL_TextureGroup_Impl::allocate(CL_GraphicContext &context, CL_RectPacker &target_packer, std::vector<CL_Texture> &target_textures, const CL_Size &texture_size)
 {
-	if(child[0])
+	CL_RectPacker::AllocatedRect allocation(-1, CL_Rect());
+	if(texture_size.width > initial_texture_size.width || texture_size.height > initial_texture_size.height)
 	{
-		delete child[0];
-		child[0] = NULL;
+		try
+		{
+			// An inserted texture may still have room for it
+			allocation = target_packer.add(texture_size);
+		}
+		catch (const CL_Exception &)
+		{
+			// If the specified size is greater than the initial size,  then create a texture using the specified size
+			target_packer.add_group(CL_Rect(CL_Point(0, 0), texture_size));
+			target_textures.push_back(CL_Texture(context, texture_size));
+			allocation = target_packer.add(texture_size);
+		}
 	}
-	if(child[1])
+	else
 	{
-		delete child[1];
-		child[1] = NULL;
+		allocation = target_packer.add(texture_size);
 	}
-	id = 0;
+
+	create_textures(context, target_packer, target_textures);
+	return allocation;
 }
 
-CL_TextureGroup_Impl::Node *CL_TextureGroup_Impl::Node::insert(const CL_Size &texture_size, int texture_id)
+std::vector<CL_RectPacker::AllocatedRect> CL_TextureGroup_Impl::allocate_batch(CL_GraphicContext &context, CL_RectPacker &target_packer, std::vector<CL_Texture> &target_textures, const std::vector<CL_Size> &texture_sizes)
 {
-	// If we're not a leaf
-	if(child[0] && child[1])
-	{
-		// Try inserting into first child
-		Node *new_node = child[0]->insert(texture_size, texture_id);
-		if(new_node != NULL)
-			return new_node;
-        
-		// No room, insert into second
-		return child[1]->insert(texture_size, texture_id);
-	}
-	else
-	{
-		// If there's already a texture here, return
-		if (id)
-			return NULL;
-
-		// If we're too small, return
-		if (texture_size.width > node_rect.get_width() || texture_size.height > node_rect.get_height())
-			return NULL;
-
-		// If we're just right, accept
-		if (texture_size.width == node_rect.get_width() && texture_size.height == node_rect.get_height())
-		{
-			id = texture_id;
-			image_rect = node_rect;
-			return this;
-		}
-        
-		// Otherwise, decide which way to split
-		int dw = node_rect.get_width() - texture_size.width;
-		int dh = node_rect.get_height() - texture_size.height;
+	std::vector<CL_RectPacker::AllocatedRect> allocations(texture_sizes.size(), CL_RectPacker::AllocatedRect(-1, CL_Rect()));
 
-		if (dw > dh)
+	// Sub-textures larger than the initial size get textures of their own:
+	std::vector<CL_Size> batch_sizes;
+	std::vector<int> batch_indexes;
+	for (size_t i = 0; i < texture_sizes.size(); i++)
+	{
+		if (texture_sizes[i].width > initial_texture_size.width || texture_sizes[i].height > initial_texture_size.height)
 		{
-			child[0] = new Node(CL_Rect(node_rect.left, node_rect.top, node_rect.left + texture_size.width, node_rect.bottom));
-			child[1] = new Node(CL_Rect(node_rect.left + texture_size.width, node_rect.top, node_rect.right, node_rect.bottom));
+			allocations[i] = allocate(context, target_packer, target_textures, texture_sizes[i]);
 		}
 		else
 		{
-			child[0] = new Node(CL_Rect(node_rect.left, node_rect.top, node_rect.right, node_rect.top + texture_size.height));
-			child[1] = new Node(CL_Rect(node_rect.left, node_rect.top + texture_size.height, node_rect.right, node_rect.bottom));
+			batch_sizes.push_back(texture_sizes[i]);
+			batch_indexes.push_back(i);
 		}
-        
-		// Insert into first child we created
-		return child[0]->insert(texture_size, texture_id);
 	}
+
+	std::vector<CL_RectPacker::AllocatedRect> batch_allocations = target_packer.add(batch_sizes);
+	create_textures(context, target_packer, target_textures);
+	for (size_t i = 0; i < batch_allocations.size(); i++)
+		allocations[batch_indexes[i]] = batch_allocations[i];
+
+	return allocations;
 }
 
-CL_TextureGroup_Impl::Node *CL_TextureGroup_Impl::Node::find_image_rect(const CL_Rect &new_rect)
+void CL_TextureGroup_Impl::create_textures(CL_GraphicContext &context, const CL_RectPacker &target_packer, std::vector<CL_Texture> &target_textures)
 {
-	// Check leaf
-	if(child[0])
-	{
-		Node *node = child[0]->find_image_rect(new_rect);
-		if (node)
-			return node;
-	}
+	while ((int) target_textures.size() < target_packer.get_group_count())
+		target_textures.push_back(CL_Texture(context, initial_texture_size));
+}
 
-	if(child[1])
+int CL_TextureGroup_Impl::find_texture(const CL_Texture &texture) const
+{
+	for (size_t index = 0; index < textures.size(); ++index)
 	{
-		Node *node = child[1]->find_image_rect(new_rect);
-		if (node)
-			return node;
+		if (textures[index] == texture)
+			return index;
 	}
-
-	if (id == 0)
-		return NULL;
-
-	if (image_rect == new_rect)
-		return this;
-
-	return NULL;
-
+	return -1;
 }
@@ -31,41 +31,13 @@
 #include <list>
 #include "API/Display/Render/texture.h"
 #include "API/Display/2D/texture_group.h"
+#include "API/Core/Math/rect_packer.h"
 
 class CL_GraphicContext;
 
 /// \brief Texture group implementation interface.
 class CL_TextureGroup_Impl
 {
-public:
-	class Node
-	{
-	public:
-		Node();
-		Node(const CL_Rect &rect);
-		~Node();
-
-		int get_subtexture_count() const;
-
-		Node *insert(const CL_Size &texture_size, int texture_id);
-		Node *find_image_rect(const CL_Rect &new_rect);
-
-		void clear();
-
-		Node *child[2];
-		CL_Rect node_rect;
-
-	    int id;
-	    CL_Rect image_rect;
-	};
-
-	struct RootNode
-	{
-	public:
-		CL_Texture texture;
-		Node node;
-	};
-
 public:
 	CL_TextureGroup_Impl(const CL_Size &texture_sizes);
 	~CL_TextureGroup_Impl();
@@ -74,19 +46,43 @@ public:
 	int get_subtexture_count(unsigned int texture_index) const;
 	void insert_texture(CL_Texture &texture, const CL_Rect &texture_rect);
 	void remove(CL_Subtexture &subtexture);
+	void set_texture_allocation_policy(CL_TextureGroup::TextureAllocationPolicy policy);
 
 	std::vector<CL_Texture> get_textures() const;
 
 	CL_Subtexture add_new_node(CL_GraphicContext &context, const CL_Size &texture_size);
+	std::vector<CL_Subtexture> add_batch(CL_GraphicContext &context, const std::vector<CL_Size> &texture_sizes);
+	void repack(CL_GraphicContext &context, std::vector<CL_Subtexture> &subtextures);
+
+	/// \brief Texture of each rect packer group
+	std::vector<CL_Texture> textures;
 
-	std::vector<RootNode *> root_nodes;
+	/// \brief Texture passed to insert_texture, and the area of it the group may use
+	struct InsertedTexture
+	{
+		InsertedTexture(const CL_Texture &texture, const CL_Rect &area) : texture(texture), area(area) { }
+
+		CL_Texture texture;
+		CL_Rect area;
+	};
+
+	/// \brief Inserted textures, kept by repack()
+	std::vector<InsertedTexture> inserted_textures;
+
+	CL_RectPacker packer;
 
 	CL_Size initial_texture_size;
 	CL_TextureGroup::TextureAllocationPolicy texture_allocation_policy;
 
 private:
-	RootNode *add_new_root(CL_GraphicContext &context, const CL_Size &texture_size);
+	/// \brief Allocates a sub texture in target_packer, adding to target_textures as needed
+	CL_RectPacker::AllocatedRect allocate(CL_GraphicContext &context, CL_RectPacker &target_packer, std::vector<CL_Texture> &target_textures, const CL_Size &texture_size);
+
+	/// \brief Allocates a batch of sub textures in target_packer, adding to target_textures as needed
+	std::vector<CL_RectPacker::AllocatedRect> allocate_batch(CL_GraphicContext &context, CL_RectPacker &target_packer, std::vector<CL_Texture> &target_textures, const std::vector<CL_Size> &texture_sizes);
+
+	/// \brief Creates the textures of the groups the rect packer added
+	void create_textures(CL_GraphicContext &context, const CL_RectPacker &target_packer, std::vector<CL_Texture> &target_textures);
 
-	RootNode *active_root;
-	int next_id;
+	int find_texture(const CL_Texture &texture) const;
 };
@@ -0,0 +1,293 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Kenneth Gangstoe
+*/
+
+#include "Display/precomp.h"
+#include "collision_aabb_tree.h"
+#include "API/Core/Math/cl_math.h"
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_CollisionAABBTree Construction:
+
+CL_CollisionAABBTree::CL_CollisionAABBTree()
+: root(null_node), free_list(null_node)
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_CollisionAABBTree Operations:
+
+int CL_CollisionAABBTree::insert(const CL_Rectf &box, int data)
+{
+	int leaf = allocate_node();
+	nodes[leaf].box = box;
+	nodes[leaf].data = data;
+	insert_leaf(leaf);
+	return leaf;
+}
+
+void CL_CollisionAABBTree::remove(int leaf)
+{
+	remove_leaf(leaf);
+	free_node(leaf);
+}
+
+void CL_CollisionAABBTree::move(int leaf, const CL_Rectf &box)
+{
+	remove_leaf(leaf);
+	nodes[leaf].box = box;
+	insert_leaf(leaf);
+}
+
+void CL_CollisionAABBTree::clear()
+{
+	nodes.clear();
+	root = null_node;
+	free_list = null_node;
+}
+
+void CL_CollisionAABBTree::query(const CL_Rectf &box, std::vector<int> &out_data) const
+{
+	if (root == null_node)
+		return;
+
+	query_stack.clear();
+	query_stack.push_back(root);
+	while (!query_stack.empty())
+	{
+		const Node &node = nodes[query_stack.back()];
+		query_stack.pop_back();
+
+		if (!overlaps(node.box, box))
+			continue;
+
+		if (node.is_leaf())
+		{
+			out_data.push_back(node.data);
+		}
+		else
+		{
+			query_stack.push_back(node.child1);
+			query_stack.push_back(node.child2);
+		}
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_CollisionAABBTree Implementation:
+
+int CL_CollisionAABBTree::allocate_node()
+{
+	if (free_list == null_node)
+	{
+		nodes.push_back(Node());
+		return nodes.size() - 1;
+	}
+
+	int node = free_list;
+	free_list = nodes[node].parent;
+	nodes[node] = Node();
+	return node;
+}
+
+void CL_CollisionAABBTree::free_node(int node)
+{
+	nodes[node].parent = free_list;
+	nodes[node].height = -1;
+	free_list = node;
+}
+
+void CL_CollisionAABBTree::insert_leaf(int leaf)
+{
+	if (root == null_node)
+	{
+		root = leaf;
+		nodes[root].parent = null_node;
+		return;
+	}
+
+	// Walk down to the sibling that grows the total perimeter of the tree the least:
+	CL_Rectf box = nodes[leaf].box;
+	int sibling = root;
+	while (!nodes[sibling].is_leaf())
+	{
+		int child1 = nodes[sibling].child1;
+		int child2 = nodes[sibling].child2;
+
+		float area = perimeter(nodes[sibling].box);
+		float combined_area = perimeter(combine(nodes[sibling].box, box));
+
+		// Cost of making a new parent for this node and the leaf, and the minimum cost pushed down to the children:
+		float cost = 2.0f * combined_area;
+		float inheritance_cost = 2.0f * (combined_area - area);
+
+		float cost1 = perimeter(combine(nodes[child1].box, box)) + inheritance_cost;
+		if (!nodes[child1].is_leaf())
+			cost1 -= perimeter(nodes[child1].box);
+
+		float cost2 = perimeter(combine(nodes[child2].box, box)) + inheritance_cost;
+		if (!nodes[child2].is_leaf())
+			cost2 -= perimeter(nodes[child2].box);
+
+		if (cost < cost1 && cost < cost2)
+			break;
+
+		sibling = (cost1 < cost2) ? child1 : child2;
+	}
+
+	int old_parent = nodes[sibling].parent;
+	int new_parent = allocate_node();
+	nodes[new_parent].parent = old_parent;
+	nodes[new_parent].box = combine(box, nodes[sibling].box);
+	nodes[new_parent].height = nodes[sibling].height + 1;
+	nodes[new_parent].child1 = sibling;
+	nodes[new_parent].child2 = leaf;
+	nodes[sibling].parent = new_parent;
+	nodes[leaf].parent = new_parent;
+
+	if (old_parent == null_node)
+	{
+		root = new_parent;
+	}
+	else
+	{
+		if (nodes[old_parent].child1 == sibling)
+			nodes[old_parent].child1 = new_parent;
+		else
+			nodes[old_parent].child2 = new_parent;
+	}
+
+	refit(nodes[leaf].parent);
+}
+
+void CL_CollisionAABBTree::remove_leaf(int leaf)
+{
+	if (leaf == root)
+	{
+		root = null_node;
+		return;
+	}
+
+	int parent = nodes[leaf].parent;
+	int grand_parent = nodes[parent].parent;
+	int sibling = (nodes[parent].child1 == leaf) ? nodes[parent].child2 : nodes[parent].child1;
+
+	// The sibling takes the place of the parent:
+	if (grand_parent == null_node)
+	{
+		root = sibling;
+		nodes[sibling].parent = null_node;
+	}
+	else
+	{
+		if (nodes[grand_parent].child1 == parent)
+			nodes[grand_parent].child1 = sibling;
+		else
+			nodes[grand_parent].child2 = sibling;
+		nodes[sibling].parent = grand_parent;
+	}
+	free_node(parent);
+
+	if (grand_parent != null_node)
+		refit(grand_parent);
+}
+
+void CL_CollisionAABBTree::refit(int node)
+{
+	while (node != null_node)
+	{
+		node = balance(node);
+
+		int child1 = nodes[node].child1;
+		int child2 = nodes[node].child2;
+		nodes[node].height = 1 + cl_max(nodes[child1].height, nodes[child2].height);
+		nodes[node].box = combine(nodes[child1].box, nodes[child2].box);
+
+		node = nodes[node].parent;
+	}
+}
+
+int CL_CollisionAABBTree::balance(int a)
+{
+	if (nodes[a].is_leaf() || nodes[a].height < 2)
+		return a;
+
+	int b = nodes[a].child1;
+	int c = nodes[a].child2;
+	int difference = nodes[c].height - nodes[b].height;
+	if (difference >= -1 && difference <= 1)
+		return a;
+
+	// Lift the taller child up into the place of a, moving its shorter child down to a:
+	int up = (difference > 1) ? c : b;
+	int other = (difference > 1) ? b : c;
+	int f = nodes[up].child1;
+	int g = nodes[up].child2;
+
+	nodes[up].child1 = a;
+	nodes[up].parent = nodes[a].parent;
+	nodes[a].parent = up;
+
+	if (nodes[up].parent == null_node)
+		root = up;
+	else if (nodes[nodes[up].parent].child1 == a)
+		nodes[nodes[up].parent].child1 = up;
+	else
+		nodes[nodes[up].parent].child2 = up;
+
+	int keep = (nodes[f].height > nodes[g].height) ? f : g;
+	int move_down = (keep == f) ? g : f;
+
+	nodes[up].child2 = keep;
+	if (difference > 1)
+		nodes[a].child2 = move_down;
+	else
+		nodes[a].child1 = move_down;
+	nodes[move_down].parent = a;
+
+	nodes[a].box = combine(nodes[other].box, nodes[move_down].box);
+	nodes[a].height = 1 + cl_max(nodes[other].height, nodes[move_down].height);
+	nodes[up].box = combine(nodes[a].box, nodes[keep].box);
+	nodes[up].height = 1 + cl_max(nodes[a].height, nodes[keep].height);
+
+	return up;
+}
+
+bool CL_CollisionAABBTree::overlaps(const CL_Rectf &box1, const CL_Rectf &box2)
+{
+	return box1.left <= box2.right && box1.right >= box2.left && box1.top <= box2.bottom && box1.bottom >= box2.top;
+}
+
+CL_Rectf CL_CollisionAABBTree::combine(const CL_Rectf &box1, const CL_Rectf &box2)
+{
+	return CL_Rectf(cl_min(box1.left, box2.left), cl_min(box1.top, box2.top), cl_max(box1.right, box2.right), cl_max(box1.bottom, box2.bottom));
+}
+
+float CL_CollisionAABBTree::perimeter(const CL_Rectf &box)
+{
+	return 2.0f * (box.get_width() + box.get_height());
+}
@@ -0,0 +1,124 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Kenneth Gangstoe
+*/
+
+#pragma once
+
+#include "API/Core/Math/rect.h"
+#include <vector>
+
+/// \brief Dynamic bounding box tree used as the broad phase of CL_CollisionWorld.
+///
+/// Leaves hold the boxes of the outlines, enlarged by a margin so small movements do not change the tree.
+/// Parents hold the bounding box of their children, and the tree is kept balanced with rotations as leaves are inserted and removed.
+class CL_CollisionAABBTree
+{
+/// \name Construction
+/// \{
+
+public:
+	CL_CollisionAABBTree();
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	/// \brief Returns the box stored in a leaf
+	const CL_Rectf &get_box(int leaf) const { return nodes[leaf].box; }
+
+	/// \brief Returns the data stored in a leaf
+	int get_data(int leaf) const { return nodes[leaf].data; }
+
+	/// \brief Returns the height of the tree, zero for a single leaf and -1 if empty
+	int get_height() const { return root == null_node ? -1 : nodes[root].height; }
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	/// \brief Adds a leaf and returns its index
+	int insert(const CL_Rectf &box, int data);
+
+	/// \brief Removes a leaf
+	void remove(int leaf);
+
+	/// \brief Moves a leaf to a new box
+	void move(int leaf, const CL_Rectf &box);
+
+	/// \brief Removes all leaves
+	void clear();
+
+	/// \brief Appends the data of the leaves whose box overlaps the given box
+	void query(const CL_Rectf &box, std::vector<int> &out_data) const;
+
+	/// \brief Returns true if the boxes overlap or touch
+	static bool overlaps(const CL_Rectf &box1, const CL_Rectf &box2);
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	enum { null_node = -1 };
+
+	struct Node
+	{
+		Node() : parent(null_node), child1(null_node), child2(null_node), height(0), data(-1) { }
+		bool is_leaf() const { return child1 == null_node; }
+
+		CL_Rectf box;
+
+		/// \brief Parent node, or the next free node when in the free list
+		int parent;
+		int child1;
+		int child2;
+		int height;
+		int data;
+	};
+
+	int allocate_node();
+	void free_node(int node);
+	void insert_leaf(int leaf);
+	void remove_leaf(int leaf);
+
+	/// \brief Recalculates the boxes and heights from a node up to the root, balancing on the way
+	void refit(int node);
+
+	/// \brief Rotates the children of an unbalanced node and returns the node now at its place
+	int balance(int node);
+
+	static CL_Rectf combine(const CL_Rectf &box1, const CL_Rectf &box2);
+	static float perimeter(const CL_Rectf &box);
+
+	std::vector<Node> nodes;
+	int root;
+	int free_list;
+	mutable std::vector<int> query_stack;
+/// \}
+};
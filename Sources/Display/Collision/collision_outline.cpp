@@ -520,6 +520,11 @@ bool CL_CollisionOutline::collide(const CL_CollisionOutline &outline, bool remov
 	return impl->collide(outline, remove_old_collision_info);
 }
 
+bool CL_CollisionOutline::collide(const CL_CollisionOutline &outline, std::vector<CL_CollidingContours> &collision_info) const
+{
+	return impl->collide(outline, collision_info);
+}
+
 void CL_CollisionOutline::calculate_penetration_depth(std::vector<CL_CollidingContours> &collision_info)
 {
 	CL_CollisionOutline_Generic::calculate_penetration_depth(collision_info);
@@ -513,6 +513,34 @@ bool CL_CollisionOutline_Generic::collide( const CL_CollisionOutline &outline, b
 		collision_info.clear();
 	}
 
+	bool any_collisions = find_collisions(outline, collision_info);
+
+	// Should we calculate the penetration depth
+	if( !collision_info.empty() && collision_info_pen_depth && remove_old_collision_info)
+	{
+		// We only do this, if we have any info and if is new collision-info.
+		calculate_penetration_depth(collision_info);
+	}
+	
+	return any_collisions;
+}
+
+bool CL_CollisionOutline_Generic::collide( const CL_CollisionOutline &outline, std::vector<CL_CollidingContours> &out_collision_info) const
+{
+	out_collision_info.clear();
+
+	bool any_collisions = find_collisions(outline, out_collision_info);
+
+	if( !out_collision_info.empty() && collision_info_pen_depth )
+	{
+		calculate_penetration_depth(out_collision_info);
+	}
+
+	return any_collisions;
+}
+
+bool CL_CollisionOutline_Generic::find_collisions( const CL_CollisionOutline &outline, std::vector<CL_CollidingContours> &out_collision_info) const
+{
 	// bounding circle test.
 	float dist = minimum_enclosing_disc.position.distance(outline.get_minimum_enclosing_disc().position);
 	
@@ -528,7 +556,7 @@ bool CL_CollisionOutline_Generic::collide( const CL_CollisionOutline &outline, b
 			 it_contours2 != outline.get_contours().end();
 			 ++it_contours2 )
 		{
-			if( contours_collide( (*it_contours), (*it_contours2) ) )
+			if( contours_collide( (*it_contours), (*it_contours2), out_collision_info ) )
 			{
 				if( collision_info_collect == false ) 
 					return true; // don't return info about all line intersections
@@ -541,7 +569,7 @@ bool CL_CollisionOutline_Generic::collide( const CL_CollisionOutline &outline, b
 					if( collision_info_collect )
 					{
 						// Add this info to the
-						collision_info.push_back(CL_CollidingContours(&(*it_contours), &(*it_contours2), true));
+						out_collision_info.push_back(CL_CollidingContours(&(*it_contours), &(*it_contours2), true));
 					}
 					else
 					{
@@ -554,7 +582,7 @@ bool CL_CollisionOutline_Generic::collide( const CL_CollisionOutline &outline, b
 					if( collision_info_collect )
 					{
 						// Add this info to the
-						collision_info.push_back(CL_CollidingContours(&(*it_contours2), &(*it_contours), true));
+						out_collision_info.push_back(CL_CollidingContours(&(*it_contours2), &(*it_contours), true));
 					}
 					else
 					{
@@ -566,13 +594,6 @@ bool CL_CollisionOutline_Generic::collide( const CL_CollisionOutline &outline, b
 		}
 	}
 
-	// Should we calculate the penetration depth
-	if( !collision_info.empty() && collision_info_pen_depth && remove_old_collision_info)
-	{
-		// We only do this, if we have any info and if is new collision-info.
-		calculate_penetration_depth(collision_info);
-	}
-	
 	return any_collisions;
 }
 
@@ -660,7 +681,7 @@ inline bool CL_CollisionOutline_Generic::line_bounding_box_overlap( const std::v
 	return (r_left <= right && r_right >= left && r_top <= bottom && r_bottom >= top);
 }
 
-bool CL_CollisionOutline_Generic::contours_collide(const CL_Contour &contour1, const CL_Contour &contour2, bool do_subcirle_test)
+bool CL_CollisionOutline_Generic::contours_collide(const CL_Contour &contour1, const CL_Contour &contour2, std::vector<CL_CollidingContours> &out_collision_info, bool do_subcirle_test) const
 {
 	CL_CollidingContours metadata(&contour1, &contour2);
 	
@@ -741,7 +762,7 @@ bool CL_CollisionOutline_Generic::contours_collide(const CL_Contour &contour1, c
 	if( collision_info_collect && metadata.points.size() > 0)
 	{
 		// Add this info
-		collision_info.push_back(metadata);
+		out_collision_info.push_back(metadata);
 		return true;
 	}
 
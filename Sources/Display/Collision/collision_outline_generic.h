@@ -95,9 +95,10 @@ public:
 	void save(CL_IODevice &file) const;
 
 	bool collide( const CL_CollisionOutline &outline, bool remove_old_collision_info);
+	bool collide( const CL_CollisionOutline &outline, std::vector<CL_CollidingContours> &out_collision_info) const;
 	bool point_inside( const CL_Pointf &point ) const;
 	static bool point_inside_contour( const CL_Pointf &point, const CL_Contour &contour);
-	bool contours_collide(const CL_Contour &contour1, const CL_Contour &contour2, bool do_subcirle_test=true);
+	bool contours_collide(const CL_Contour &contour1, const CL_Contour &contour2, std::vector<CL_CollidingContours> &out_collision_info, bool do_subcirle_test=true) const;
 	static void calculate_penetration_depth(std::vector<CL_CollidingContours> &collision_info);
 
 	void calculate_radius();
@@ -107,6 +108,10 @@ public:
 
 	inline bool line_bounding_box_overlap( const std::vector<CL_Pointf> &rect1, const std::vector<CL_Pointf> &rect2, int i, int j, int i2, int j2 ) const;
 
+private:
+	/// \brief Tests the contours of both outlines, appending the collision info to out_collision_info
+	bool find_collisions( const CL_CollisionOutline &outline, std::vector<CL_CollidingContours> &out_collision_info) const;
+
 /// \}
 
 /// \}
@@ -0,0 +1,132 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Kenneth Gangstoe
+*/
+
+#include "Display/precomp.h"
+#include "API/Display/Collision/collision_world.h"
+#include "collision_world_impl.h"
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_CollisionWorld Construction:
+
+CL_CollisionWorld::CL_CollisionWorld()
+: impl(new CL_CollisionWorld_Impl)
+{
+}
+
+CL_CollisionWorld::~CL_CollisionWorld()
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_CollisionWorld Attributes:
+
+int CL_CollisionWorld::get_outline_count() const
+{
+	return impl->outline_count;
+}
+
+CL_CollisionOutline CL_CollisionWorld::get_outline(int id) const
+{
+	impl->throw_if_invalid(id);
+	return impl->proxies[id].outline;
+}
+
+float CL_CollisionWorld::get_margin() const
+{
+	return impl->margin;
+}
+
+int CL_CollisionWorld::get_max_threads() const
+{
+	return impl->max_threads;
+}
+
+const std::vector<CL_CollisionPair> &CL_CollisionWorld::get_candidate_pairs() const
+{
+	return impl->candidate_pairs;
+}
+
+const std::vector<CL_CollisionPair> &CL_CollisionWorld::get_collisions() const
+{
+	return impl->collisions;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_CollisionWorld Operations:
+
+int CL_CollisionWorld::add(const CL_CollisionOutline &outline)
+{
+	return impl->add(outline);
+}
+
+void CL_CollisionWorld::remove(int id)
+{
+	impl->remove(id);
+}
+
+void CL_CollisionWorld::clear()
+{
+	impl->clear();
+}
+
+void CL_CollisionWorld::set_margin(float margin)
+{
+	impl->margin = margin;
+}
+
+void CL_CollisionWorld::set_max_threads(int max_threads)
+{
+	impl->set_max_threads(max_threads);
+}
+
+void CL_CollisionWorld::update()
+{
+	impl->update();
+}
+
+const std::vector<CL_CollisionPair> &CL_CollisionWorld::find_candidate_pairs()
+{
+	impl->find_candidate_pairs();
+	return impl->candidate_pairs;
+}
+
+const std::vector<CL_CollisionPair> &CL_CollisionWorld::step()
+{
+	impl->find_collisions();
+	return impl->collisions;
+}
+
+std::vector<int> CL_CollisionWorld::query(const CL_Rectf &area) const
+{
+	std::vector<int> ids;
+	impl->query(area, ids);
+	return ids;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_CollisionWorld Implementation:
@@ -0,0 +1,266 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Kenneth Gangstoe
+*/
+
+#include "Display/precomp.h"
+#include "collision_world_impl.h"
+#include "API/Core/System/system.h"
+#include "API/Core/System/exception.h"
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_CollisionWorld_Impl Construction:
+
+CL_CollisionWorld_Impl::CL_CollisionWorld_Impl()
+: outline_count(0), margin(8.0f), max_threads(0)
+{
+	// The calling thread is one of the workers:
+	set_max_threads(cl_min(CL_System::get_num_cores() - 1, 7));
+}
+
+CL_CollisionWorld_Impl::~CL_CollisionWorld_Impl()
+{
+	stop_workers();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_CollisionWorld_Impl Operations:
+
+void CL_CollisionWorld_Impl::throw_if_invalid(int id) const
+{
+	if (id < 0 || id >= (int) proxies.size() || proxies[id].leaf == -1)
+		throw CL_Exception("Invalid collision outline id");
+}
+
+void CL_CollisionWorld_Impl::set_max_threads(int new_max_threads)
+{
+	if (new_max_threads < 0)
+		new_max_threads = 0;
+	if (new_max_threads == max_threads)
+		return;
+
+	// The workers are started again with the new count when needed:
+	stop_workers();
+	max_threads = new_max_threads;
+}
+
+int CL_CollisionWorld_Impl::add(const CL_CollisionOutline &outline)
+{
+	int id;
+	if (free_ids.empty())
+	{
+		id = proxies.size();
+		proxies.push_back(Proxy());
+	}
+	else
+	{
+		id = free_ids.back();
+		free_ids.pop_back();
+	}
+
+	Proxy &proxy = proxies[id];
+	proxy.outline = outline;
+	proxy.box = get_outline_box(outline);
+	proxy.leaf = tree.insert(CL_Rectf(proxy.box).expand(margin), id);
+	outline_count++;
+	return id;
+}
+
+void CL_CollisionWorld_Impl::remove(int id)
+{
+	throw_if_invalid(id);
+	tree.remove(proxies[id].leaf);
+	proxies[id] = Proxy();
+	free_ids.push_back(id);
+	outline_count--;
+}
+
+void CL_CollisionWorld_Impl::clear()
+{
+	tree.clear();
+	proxies.clear();
+	free_ids.clear();
+	outline_count = 0;
+	candidate_pairs.clear();
+	collisions.clear();
+}
+
+void CL_CollisionWorld_Impl::update()
+{
+	for (std::vector<Proxy>::size_type id = 0; id < proxies.size(); id++)
+	{
+		Proxy &proxy = proxies[id];
+		if (proxy.leaf == -1)
+			continue;
+
+		proxy.box = get_outline_box(proxy.outline);
+		if (!tree.get_box(proxy.leaf).is_inside(proxy.box))
+			tree.move(proxy.leaf, CL_Rectf(proxy.box).expand(margin));
+	}
+}
+
+void CL_CollisionWorld_Impl::find_candidate_pairs()
+{
+	update();
+
+	candidate_pairs.clear();
+	for (std::vector<Proxy>::size_type id = 0; id < proxies.size(); id++)
+	{
+		const Proxy &proxy = proxies[id];
+		if (proxy.leaf == -1)
+			continue;
+
+		// Every pair is found from both sides, so only keep it from the lower id:
+		query_result.clear();
+		tree.query(tree.get_box(proxy.leaf), query_result);
+		for (std::vector<int>::size_type i = 0; i < query_result.size(); i++)
+		{
+			int other_id = query_result[i];
+			if (other_id > (int) id && CL_CollisionAABBTree::overlaps(proxy.box, proxies[other_id].box))
+				candidate_pairs.push_back(CL_CollisionPair(id, other_id));
+		}
+	}
+}
+
+void CL_CollisionWorld_Impl::find_collisions()
+{
+	find_candidate_pairs();
+
+	int num_pairs = candidate_pairs.size();
+	colliding.assign(num_pairs, 0);
+
+	int num_workers = cl_min(max_threads + 1, num_pairs / min_pairs_per_worker);
+	next_job.set(0);
+	if (num_workers <= 1)
+	{
+		collide_shared_pairs();
+	}
+	else
+	{
+		start_workers();
+		for (int i = 0; i < num_workers - 1; i++)
+			event_start[i].set();
+
+		collide_shared_pairs();
+
+		for (int i = 0; i < num_workers - 1; i++)
+		{
+			event_done[i].wait();
+			event_done[i].reset();
+		}
+	}
+
+	collisions.clear();
+	for (int i = 0; i < num_pairs; i++)
+	{
+		if (colliding[i])
+		{
+			collisions.push_back(CL_CollisionPair(candidate_pairs[i].id1, candidate_pairs[i].id2));
+			collisions.back().collision_info.swap(candidate_pairs[i].collision_info);
+		}
+	}
+}
+
+void CL_CollisionWorld_Impl::query(const CL_Rectf &area, std::vector<int> &out_ids) const
+{
+	std::vector<int> result;
+	tree.query(area, result);
+	for (std::vector<int>::size_type i = 0; i < result.size(); i++)
+	{
+		if (CL_CollisionAABBTree::overlaps(area, proxies[result[i]].box))
+			out_ids.push_back(result[i]);
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_CollisionWorld_Impl Implementation:
+
+CL_Rectf CL_CollisionWorld_Impl::get_outline_box(const CL_CollisionOutline &outline)
+{
+	CL_Circlef disc = outline.get_minimum_enclosing_disc();
+	return CL_Rectf(disc.position.x - disc.radius, disc.position.y - disc.radius, disc.position.x + disc.radius, disc.position.y + disc.radius);
+}
+
+void CL_CollisionWorld_Impl::start_workers()
+{
+	if (!threads.empty())
+		return;
+
+	// Do not change this code to resize(), as that copies the same CL_Event handle into every index.
+	event_start.clear();
+	event_done.clear();
+	for (int i = 0; i < max_threads; i++)
+	{
+		event_start.push_back(CL_Event());
+		event_done.push_back(CL_Event());
+	}
+	event_stop.reset();
+
+	for (int i = 0; i < max_threads; i++)
+	{
+		CL_Thread thread;
+		thread.start(this, &CL_CollisionWorld_Impl::worker_main, i);
+		threads.push_back(thread);
+	}
+}
+
+void CL_CollisionWorld_Impl::stop_workers()
+{
+	event_stop.set();
+	for (std::vector<CL_Thread>::size_type i = 0; i < threads.size(); i++)
+		threads[i].join();
+	threads.clear();
+}
+
+void CL_CollisionWorld_Impl::worker_main(int index)
+{
+	while (true)
+	{
+		int wakeup_reason = CL_Event::wait(event_start[index], event_stop);
+		if (wakeup_reason != 0)
+			break;
+		event_start[index].reset();
+
+		collide_shared_pairs();
+
+		event_done[index].set();
+	}
+}
+
+void CL_CollisionWorld_Impl::collide_shared_pairs()
+{
+	int num_pairs = candidate_pairs.size();
+	while (true)
+	{
+		int index = next_job.increment() - 1;
+		if (index >= num_pairs)
+			break;
+
+		// Outlines are only read here, and each pair writes to its own collision info:
+		CL_CollisionPair &pair = candidate_pairs[index];
+		colliding[index] = proxies[pair.id1].outline.collide(proxies[pair.id2].outline, pair.collision_info);
+	}
+}
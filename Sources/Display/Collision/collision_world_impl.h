@@ -0,0 +1,121 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Kenneth Gangstoe
+*/
+
+#pragma once
+
+#include "API/Display/Collision/collision_world.h"
+#include "API/Core/System/thread.h"
+#include "API/Core/System/event.h"
+#include "API/Core/System/interlocked_variable.h"
+#include "collision_aabb_tree.h"
+
+class CL_CollisionWorld_Impl
+{
+/// \name Construction
+/// \{
+
+public:
+	CL_CollisionWorld_Impl();
+	~CL_CollisionWorld_Impl();
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	enum
+	{
+		/// \brief Fewest candidate pairs worth handing to an extra thread
+		min_pairs_per_worker = 32
+	};
+
+	struct Proxy
+	{
+		Proxy() : leaf(-1) { }
+		CL_CollisionOutline outline;
+		CL_Rectf box;
+		int leaf;
+	};
+
+	/// \brief Outlines by id. Removed ones have a leaf of -1.
+	std::vector<Proxy> proxies;
+	std::vector<int> free_ids;
+	int outline_count;
+
+	float margin;
+	int max_threads;
+
+	std::vector<CL_CollisionPair> candidate_pairs;
+	std::vector<CL_CollisionPair> collisions;
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	void throw_if_invalid(int id) const;
+	void set_max_threads(int max_threads);
+
+	int add(const CL_CollisionOutline &outline);
+	void remove(int id);
+	void clear();
+	void update();
+	void find_candidate_pairs();
+	void find_collisions();
+	void query(const CL_Rectf &area, std::vector<int> &out_ids) const;
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	CL_CollisionWorld_Impl(const CL_CollisionWorld_Impl &);
+	CL_CollisionWorld_Impl &operator =(const CL_CollisionWorld_Impl &);
+
+	/// \brief Returns the box enclosing the outline as it is now
+	static CL_Rectf get_outline_box(const CL_CollisionOutline &outline);
+
+	void start_workers();
+	void stop_workers();
+	void worker_main(int index);
+
+	/// \brief Tests candidate pairs claimed from the shared range
+	void collide_shared_pairs();
+
+	CL_CollisionAABBTree tree;
+	std::vector<int> query_result;
+
+	std::vector<CL_Thread> threads;
+	std::vector<CL_Event> event_start;
+	std::vector<CL_Event> event_done;
+	CL_Event event_stop;
+
+	CL_InterlockedVariable next_job;
+	std::vector<char> colliding;
+/// \}
+};
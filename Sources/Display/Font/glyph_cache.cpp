@@ -56,6 +56,9 @@ CL_GlyphCache::CL_GlyphCache()
 	// Note, the user can specify a different texture group size using set_texture_group()
 	texture_group = CL_TextureGroup(CL_Size(256,256));
 
+	// Glyphs have similar heights, which the skyline packs with little waste
+	texture_group.set_packing_algorithm(CL_RectPacker::skyline);
+
 	// Set default font metrics
 	font_metrics = CL_FontMetrics(
 		0,0, 0, 0,0,0,0,0, 0,0,
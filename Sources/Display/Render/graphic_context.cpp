@@ -147,6 +147,21 @@ const CL_Mat4f &CL_GraphicContext::get_modelview() const
 	return impl->modelviews[impl->modelview_index];
 }
 
+CL_MapMode CL_GraphicContext::get_map_mode() const
+{
+	return impl->map_mode;
+}
+
+const CL_Mat4f &CL_GraphicContext::get_projection() const
+{
+	return impl->projection;
+}
+
+const CL_Rectf &CL_GraphicContext::get_viewport() const
+{
+	return impl->viewport;
+}
+
 CL_Size CL_GraphicContext::get_max_texture_size() const
 {
 	return impl->provider->get_max_texture_size();
@@ -596,12 +611,17 @@ void CL_GraphicContext::set_map_mode(CL_MapMode mode)
 	}
 
 	impl->provider->set_map_mode(mode);
+
+	impl->map_mode = mode;
+	if (mode != cl_user_projection)
+		impl->viewport = CL_Rectf(0.0f, 0.0f, (float)get_width(), (float)get_height());
 }
 
 void CL_GraphicContext::set_projection(const CL_Mat4f &matrix)
 {
 	impl->flush_batcher(*this);
 	impl->provider->set_projection(matrix);
+	impl->projection = matrix;
 }
 
 void CL_GraphicContext::set_modelview(const CL_Mat4f &matrix)
@@ -718,6 +738,7 @@ void CL_GraphicContext::set_viewport(const CL_Rectf &viewport)
 {
 	impl->flush_batcher(*this);
 	impl->provider->set_viewport(viewport);
+	impl->viewport = viewport;
 }
 
 void CL_GraphicContext::flush_batcher()
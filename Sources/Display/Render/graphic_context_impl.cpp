@@ -33,7 +33,7 @@
 #include "API/Display/Render/shared_gc_data.h"
 
 CL_GraphicContext_Impl::CL_GraphicContext_Impl(CL_GraphicContextProvider *provider)
-: provider(provider), max_attributes(0), modelview_changed(false), active_batcher(0), modelview_index(0), current_internal_batcher(&render_batcher_2d)
+: provider(provider), max_attributes(0), modelview_changed(false), active_batcher(0), modelview_index(0), map_mode(cl_map_2d_upper_left), projection(CL_Mat4f::identity()), current_internal_batcher(&render_batcher_2d)
 {
 	selected_textures.resize(8);	// Create 8 unit indexes by default
 	modelviews.push_back(CL_Mat4f::identity());
@@ -67,6 +67,9 @@ public:
 	CL_RenderBatcher *active_batcher;
 	CL_RenderBatcherSprite *current_internal_batcher;
 	int modelview_index;
+	CL_MapMode map_mode;
+	CL_Mat4f projection;
+	CL_Rectf viewport;
 
 	std::vector<CL_Texture> selected_textures;
 	CL_BlendMode selected_blend_mode;
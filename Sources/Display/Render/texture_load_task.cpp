@@ -0,0 +1,103 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#include "Display/precomp.h"
+#include "API/Display/Render/texture_load_task.h"
+#include "API/Display/Image/pixel_buffer.h"
+#include "API/Display/ImageProviders/provider_factory.h"
+#include "API/Core/Resources/resource.h"
+#include "API/Core/Text/string_format.h"
+#include "API/Core/XML/dom_element.h"
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_TextureLoadTask_Impl Class:
+
+class CL_TextureLoadTask_Impl
+{
+public:
+	CL_GraphicContext gc;
+	CL_String resource_id;
+	CL_ImageImportDescription import_desc;
+
+	CL_String filename;
+	CL_VirtualDirectory directory;
+	CL_PixelBuffer image;
+	CL_Texture texture;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_TextureLoadTask Construction:
+
+CL_TextureLoadTask::CL_TextureLoadTask(CL_GraphicContext &gc, const CL_String &resource_id, const CL_ImageImportDescription &import_desc)
+: impl(new CL_TextureLoadTask_Impl)
+{
+	impl->gc = gc;
+	impl->resource_id = resource_id;
+	impl->import_desc = import_desc;
+}
+
+CL_TextureLoadTask::~CL_TextureLoadTask()
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_TextureLoadTask Attributes:
+
+CL_Texture CL_TextureLoadTask::get_texture() const
+{
+	return impl->texture;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_TextureLoadTask Operations:
+
+void CL_TextureLoadTask::prepare(CL_ResourceManager &resources)
+{
+	CL_Resource resource = resources.get_resource(impl->resource_id);
+	if (resource.get_element().get_tag_name() != "texture")
+		throw CL_Exception(cl_format("Resource '%1' is not of type 'texture'", impl->resource_id));
+
+	impl->filename = resource.get_element().get_attribute("file");
+	impl->directory = resources.get_directory(resource);
+}
+
+void CL_TextureLoadTask::load()
+{
+	CL_PixelBuffer image = CL_ImageProviderFactory::load(impl->filename, impl->directory, CL_String());
+	impl->image = impl->import_desc.process(image);
+}
+
+void CL_TextureLoadTask::finish()
+{
+	CL_PixelBuffer image = impl->image;
+	impl->image = CL_PixelBuffer();
+
+	CL_Texture texture(impl->gc, image.get_width(), image.get_height());
+	texture.set_subimage(CL_Point(0, 0), image, CL_Rect(image.get_size()), 0);
+	impl->texture = texture;
+}
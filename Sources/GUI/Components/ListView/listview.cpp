@@ -164,6 +164,13 @@ CL_ListViewDisplayMode CL_ListView::get_display_mode() const
 	return impl->display_mode;
 }
 
+CL_SharedPtr<CL_ListViewModel> CL_ListView::get_model() const
+{
+	if (impl->model_rows)
+		return impl->model_rows->get_model();
+	return CL_SharedPtr<CL_ListViewModel>();
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_ListView Operations:
 
@@ -231,6 +238,8 @@ void CL_ListView::set_display_mode(CL_ListViewDisplayMode mode)
 	impl->layout->set_listview_header(impl->header);
 	impl->layout->set_view_rect(impl->rect_columns_content);
 	impl->layout->set_root_item(impl->document_item);
+	if (mode == listview_mode_details)
+		impl->layout->set_model_rows(impl->model_rows);
 	impl->layout->create_parts();
 	impl->layout->invalidate();
 
@@ -251,6 +260,65 @@ void CL_ListView::show_detail_opener(bool enable)
 	impl->layout->set_show_detail_opener(impl->show_detail_opener);
 }
 
+void CL_ListView::set_model(const CL_SharedPtr<CL_ListViewModel> &model)
+{
+	impl->cancel_edit();
+
+	clear_selection();
+
+	delete impl->model_rows;
+	impl->model_rows = 0;
+	if (model)
+		impl->model_rows = new CL_ListViewModelRows(model, impl->header);
+
+	if (impl->display_mode == listview_mode_details)
+		impl->layout->set_model_rows(impl->model_rows);
+
+	impl->scrollbar->set_position(0);
+	impl->on_scroll();
+	impl->update_scrollbar();
+}
+
+void CL_ListView::invalidate_model()
+{
+	if (impl->model_rows == 0)
+		return;
+
+	impl->cancel_edit();
+
+	impl->model_rows->update();
+
+	// Rows past the new end were unselected by the update; rebuild the selection without them.
+	bool selection_changed = false;
+	std::vector<CL_ListViewItem> selected_items;
+	CL_ListViewSelectedItem it = impl->selection.get_first();
+	while (it.is_item())
+	{
+		if (it.get_item().is_selected())
+			selected_items.push_back(it.get_item());
+		else
+			selection_changed = true;
+		it = it.get_next_sibling();
+	}
+
+	if (selection_changed)
+	{
+		impl->selection.clear();
+		for (size_t i = 0; i < selected_items.size(); i++)
+		{
+			selected_items[i].impl->selected = true;
+			impl->selection.append(selected_items[i]);
+		}
+
+		if (!impl->func_selection_changed.is_null())
+			impl->func_selection_changed.invoke(impl->selection);
+	}
+
+	impl->layout->invalidate();
+	impl->update_scrollbar();
+	request_repaint();
+}
+
 void CL_ListView::clear()
 {
 	impl->cancel_edit();
@@ -435,7 +503,7 @@ bool CL_ListView_Impl::on_keyboard_pressed(CL_InputEvent &event)
 {
 	bool event_consumed = false;
 
-	if (document_item.get_child_count() == 0)
+	if (is_empty())
 		return event_consumed;
 
 	if (event.id == CL_KEY_LEFT || event.id == CL_KEY_RIGHT || event.id == CL_KEY_UP || event.id == CL_KEY_DOWN)
@@ -445,7 +513,7 @@ bool CL_ListView_Impl::on_keyboard_pressed(CL_InputEvent &event)
 		// Ensure we have a selected item.
 		if (selection.get_first().is_null())
 		{
-			CL_ListViewItem item = document_item.get_first_child();
+			CL_ListViewItem item = get_first_item();
 			listview->set_selected(item, true);
 		}
 
@@ -778,6 +846,8 @@ void CL_ListView_Impl::on_mouse_leave()
 void CL_ListView_Impl::on_column_added(CL_ListViewColumnHeader col)
 {
 	cancel_edit();
+	if (model_rows)
+		model_rows->update();
 	update_part_positions();
 }
 
@@ -892,6 +962,20 @@ void CL_ListView_Impl::update_scrollbar()
 		layout->set_scroll_offset(CL_Point(0, 0));
 }
 
+bool CL_ListView_Impl::is_empty()
+{
+	if (layout->model_rows)
+		return layout->model_rows->get_row_count() == 0;
+	return document_item.get_child_count() == 0;
+}
+
+CL_ListViewItem CL_ListView_Impl::get_first_item()
+{
+	if (layout->model_rows)
+		return layout->model_rows->get_item(0);
+	return document_item.get_first_child();
+}
+
 void CL_ListView_Impl::on_scroll()
 { 
 	cancel_edit();
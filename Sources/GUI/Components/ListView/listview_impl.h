@@ -57,6 +57,7 @@
 #include "listview_renderer.h"
 #include "listview_layout_details.h"
 #include "listview_layout_icons.h"
+#include "listview_model_rows.h"
 
 /////////////////////////////////////////////////////////////////////////////
 // CL_ListView_Impl Class:
@@ -65,7 +66,7 @@ class CL_ListView_Impl
 {
 public:
 	CL_ListView_Impl()
-	  : display_mode(listview_mode_details), listview(0), layout(0), renderer(0), scrollbar(0),
+	  : display_mode(listview_mode_details), listview(0), layout(0), renderer(0), model_rows(0), scrollbar(0),
 		  header(0), lineedit(0), multiple_selection(false), select_whole_row(false),
 		  context_menu(CL_PopupMenu::create_null_object()), just_launched_lineedit(false),
 		  show_detail_icon(true), show_detail_opener(true)
@@ -78,6 +79,7 @@ public:
 	{
 		delete renderer;
 		delete layout;
+		delete model_rows;
 	}
 
 	void on_process_message(CL_GUIMessage &msg);
@@ -145,6 +147,8 @@ public:
 
 	CL_ListViewRenderer *renderer;
 
+	CL_ListViewModelRows *model_rows;
+
 	CL_ScrollBar *scrollbar;
 
 	CL_ListViewItem document_item;
@@ -191,11 +195,15 @@ public:
 	bool show_detail_icon;
 	bool show_detail_opener;
 
+	void update_scrollbar();
+
+	bool is_empty();
+
+	CL_ListViewItem get_first_item();
+
 private:
 	// void update_shown_items();
 
-	void update_scrollbar();
-
 	void edit_item(ListViewShownItem &si);
 
 	CL_Rect get_opener_rect(
@@ -52,7 +52,7 @@
 // CL_ListViewLayout Construction:
 
 CL_ListViewLayout::CL_ListViewLayout(CL_ListView *listview)
-: listview(listview), gc(listview->get_gc()), header(0), scroll_x(0), scroll_y(0),
+: listview(listview), gc(listview->get_gc()), header(0), model_rows(0), scroll_x(0), scroll_y(0),
   height_row(0), height_text(0), row_counter(0), valid(false), columns_valid(false)
 {
 }
@@ -99,6 +99,12 @@ void CL_ListViewLayout::set_listview_header(CL_ListViewHeader *header)
 	this->header = header;
 }
 
+void CL_ListViewLayout::set_model_rows(CL_ListViewModelRows *model_rows)
+{
+	this->model_rows = model_rows;
+	invalidate();
+}
+
 void CL_ListViewLayout::invalidate()
 {
 	valid = false;
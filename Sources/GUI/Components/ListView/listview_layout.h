@@ -40,6 +40,7 @@
 
 class CL_ListViewHeader;
 class CL_ListView;
+class CL_ListViewModelRows;
 
 struct ListViewColumn
 {
@@ -126,6 +127,9 @@ public:
 	/// \brief Set the listview header needed for column sizes.
 	void set_listview_header(CL_ListViewHeader *hearder);
 
+	/// \brief Set the model rows to show instead of the item tree, or null for the item tree.
+	void set_model_rows(CL_ListViewModelRows *model_rows);
+
 	/// \brief Force an update of the shown items vector at the next get_shown_items() call.
 	void invalidate();
 
@@ -143,6 +147,7 @@ public:
 	CL_GUIThemePart part_row;
 	CL_GUIThemePart part_opener;
 	CL_ListViewHeader *header;
+	CL_ListViewModelRows *model_rows;
 	CL_ListViewItem root_item;
 	CL_Rect rect_view;
 	CL_Size size_icon;
@@ -52,6 +52,7 @@
 #include "listview_item_impl.h"
 #include "listview_layout_details.h"
 #include "listview_shown_item.h"
+#include "listview_model_rows.h"
 
 /////////////////////////////////////////////////////////////////////////////
 // CL_ListViewLayoutDetails Construction:
@@ -98,7 +99,7 @@ CL_Size CL_ListViewLayoutDetails::get_total_size()
 	if (height_row <= 0)
 		return CL_Size(0,0);
 
-	int num_rows = root_item.get_child_count(true,true);
+	int num_rows = model_rows ? model_rows->get_row_count() : root_item.get_child_count(true,true);
 	if (num_rows <= 0)
 		return CL_Size(0,0);
 
@@ -109,7 +110,15 @@ CL_ListViewItem CL_ListViewLayoutDetails::get_neighbour(CL_ListViewItem item, Ne
 {
 	CL_ListViewItem retval = item;
 
-	if (neighbour == neighbour_left)
+	if (model_rows)
+	{
+		int row = item.get_id();
+		if (neighbour == neighbour_up)
+			retval = model_rows->get_item(row - 1);
+		else if (neighbour == neighbour_down)
+			retval = model_rows->get_item(row + 1);
+	}
+	else if (neighbour == neighbour_left)
 	{
 		retval = item.get_parent();
 		if (retval.get_parent().is_null()) // don't go all the way to the document_item.
@@ -180,6 +189,13 @@ std::vector<ListViewShownItem> &CL_ListViewLayoutDetails::get_shown_items()
 	CL_Font font = part_cell.get_font();
 	max_rows_visible = rect_view.get_height() / height_row;
 
+	if (model_rows)
+	{
+		update_shown_model_rows(font);
+		valid = true;
+		return shown_items;
+	}
+
 	CL_ListViewItem child = root_item.get_first_child();
 	while (child.is_item())
 	{
@@ -340,6 +356,39 @@ void CL_ListViewLayoutDetails::update_shown_items_rows(CL_Font &font, CL_ListVie
 		return;
 	}
 
+	add_shown_item(font, item);
+
+	if (item.has_children() && item.is_open())
+	{
+		CL_ListViewItem it = item.get_first_child();
+		while (it.is_item())
+		{
+			if (shown_items.size() == max_rows_visible)
+				break;
+
+			update_shown_items_rows(font, it);
+			it = it.get_next_sibling();
+		}
+	}
+}
+
+void CL_ListViewLayoutDetails::update_shown_model_rows(CL_Font &font)
+{
+	// All rows have the same height, so the first visible row follows directly from the scroll offset.
+	int first_row = scroll_y / height_row;
+	int end_row = cl_min(first_row + max_rows_visible, model_rows->get_row_count());
+
+	row_draw_y_pos = rect_view.top;
+	row_counter = first_row;
+
+	for (int row = first_row; row < end_row; row++)
+		add_shown_item(font, model_rows->get_item(row));
+
+	model_rows->release_rows(first_row, end_row);
+}
+
+void CL_ListViewLayoutDetails::add_shown_item(CL_Font &font, CL_ListViewItem item)
+{
 	ListViewShownItem si;
 	si.valid = true;
 	si.item = item;
@@ -413,19 +462,6 @@ void CL_ListViewLayoutDetails::update_shown_items_rows(CL_Font &font, CL_ListVie
 	rows.push_back(row);
 
 	row_counter++;
-
-	if (item.has_children() && item.is_open())
-	{
-		CL_ListViewItem it = item.get_first_child();
-		while (it.is_item())
-		{
-			if (shown_items.size() == max_rows_visible)
-				break;
-
-			update_shown_items_rows(font, it);
-			it = it.get_next_sibling();
-		}
-	}
 }
 
 CL_Rect CL_ListViewLayoutDetails::get_opener_rect(const CL_Rect &cell_content_rect, CL_ListViewItem item, int offset_x)
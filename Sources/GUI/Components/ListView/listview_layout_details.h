@@ -76,6 +76,8 @@ public:
 /// \{
 public:
 	void update_shown_items_rows(CL_Font &font, CL_ListViewItem item);
+	void update_shown_model_rows(CL_Font &font);
+	void add_shown_item(CL_Font &font, CL_ListViewItem item);
 	CL_Rect get_opener_rect(const CL_Rect &cell_content_rect, CL_ListViewItem item, int offset_x);
 	CL_Rect get_icon_rect(const CL_Rect &cell_content_rect, CL_ListViewItem item, int offset_x);
 
@@ -0,0 +1,131 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#include "GUI/precomp.h"
+#include "API/GUI/Components/listview_model.h"
+#include "API/GUI/Components/listview_header.h"
+#include "API/GUI/Components/listview_column_header.h"
+#include "API/GUI/Components/listview_column_data.h"
+#include "listview_item_impl.h"
+#include "listview_model_rows.h"
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_ListViewModelRows Construction:
+
+CL_ListViewModelRows::CL_ListViewModelRows(const CL_SharedPtr<CL_ListViewModel> &model, CL_ListViewHeader *header)
+: model(model), header(header), row_count(0)
+{
+	// Rows are parented to a private root item so they get the indent level of top-level items.
+	CL_SharedPtr<CL_ListViewItem_Impl> item_impl(new CL_ListViewItem_Impl());
+	root_item = CL_ListViewItem(item_impl);
+
+	row_count = cl_max(model->get_row_count(), 0);
+}
+
+CL_ListViewModelRows::~CL_ListViewModelRows()
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_ListViewModelRows Attributes:
+
+CL_ListViewItem CL_ListViewModelRows::get_item(int row)
+{
+	if (row < 0 || row >= row_count)
+		return CL_ListViewItem();
+
+	std::map<int, CL_ListViewItem>::iterator it = items.find(row);
+	if (it != items.end())
+		return it->second;
+
+	CL_SharedPtr<CL_ListViewItem_Impl> item_impl(new CL_ListViewItem_Impl());
+	CL_ListViewItem item(item_impl);
+	item.impl->id = row;
+	root_item.append_child(item);
+	fill_item(item, row);
+
+	items[row] = item;
+	return item;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_ListViewModelRows Operations:
+
+void CL_ListViewModelRows::release_rows(int first_row, int end_row)
+{
+	std::map<int, CL_ListViewItem>::iterator it = items.begin();
+	while (it != items.end())
+	{
+		if ((it->first < first_row || it->first >= end_row) && !it->second.is_selected())
+		{
+			it->second.remove();
+			items.erase(it++);
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
+
+void CL_ListViewModelRows::update()
+{
+	row_count = cl_max(model->get_row_count(), 0);
+
+	std::map<int, CL_ListViewItem>::iterator it = items.begin();
+	while (it != items.end())
+	{
+		if (it->first >= row_count)
+		{
+			it->second.impl->selected = false;
+			it->second.remove();
+			items.erase(it++);
+		}
+		else
+		{
+			fill_item(it->second, it->first);
+			++it;
+		}
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_ListViewModelRows Implementation:
+
+void CL_ListViewModelRows::fill_item(CL_ListViewItem &item, int row)
+{
+	CL_ListViewColumnHeader col = header->get_first_column();
+	while (!col.is_null())
+	{
+		CL_String col_id = col.get_column_id();
+		item.set_column_text(col_id, model->get_text(row, col_id));
+		col = col.get_next_sibling();
+	}
+
+	item.impl->icon = model->get_icon(row);
+}
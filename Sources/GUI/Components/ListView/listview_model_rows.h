@@ -0,0 +1,93 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+/// \addtogroup clanGUI_Components clanGUI Components
+/// \{
+
+
+#pragma once
+
+
+#include "API/GUI/Components/listview_item.h"
+#include <map>
+
+class CL_ListViewModel;
+class CL_ListViewHeader;
+
+/// \brief Materializes list view items for the rows of a CL_ListViewModel.
+///
+/// Only rows that are visible or selected are kept as items.
+class CL_ListViewModelRows
+{
+/// \name Construction
+/// \{
+public:
+	CL_ListViewModelRows(const CL_SharedPtr<CL_ListViewModel> &model, CL_ListViewHeader *header);
+	~CL_ListViewModelRows();
+
+
+/// \}
+/// \name Attributes
+/// \{
+public:
+	CL_SharedPtr<CL_ListViewModel> get_model() const { return model; }
+
+	/// \brief Returns the row count read at construction or during the last update().
+	int get_row_count() const { return row_count; }
+
+	/// \brief Returns the item of a row, creating it from the model if needed.
+	CL_ListViewItem get_item(int row);
+
+
+/// \}
+/// \name Operations
+/// \{
+public:
+	/// \brief Drops the items outside [first_row, end_row) that are not selected.
+	void release_rows(int first_row, int end_row);
+
+	/// \brief Rereads the row count and the contents of the kept items.
+	void update();
+
+
+/// \}
+/// \name Implementation
+/// \{
+private:
+	void fill_item(CL_ListViewItem &item, int row);
+
+	CL_SharedPtr<CL_ListViewModel> model;
+	CL_ListViewHeader *header;
+	CL_ListViewItem root_item;
+	std::map<int, CL_ListViewItem> items;
+	int row_count;
+/// \}
+};
+
+
+/// \}
@@ -45,6 +45,9 @@
 #include "../gui_manager_impl.h"
 #include <algorithm>
 
+// Estimated cost, in pixels, of an extra paint pass over the component tree
+static const int paint_pass_cost = 128 * 128;
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_GUIWindowManagerProvider_Texture Construction:
 
@@ -112,11 +115,15 @@ void CL_GUIWindowManagerProvider_Texture::update_paint()
 		if (it->second->dirty)
 		{
 			it->second->dirty = false;
-			std::vector<CL_Rect>::size_type size = it->second->update_region_list.size();
-			for (int i = 0; i < size; i++)
+
+			// Every paint renders the component tree again, so only paint rects
+			// separately when that saves more than the cost of an extra pass.
+			std::vector<CL_Rect> paint_rects = it->second->update_region.get_merged_rects(paint_pass_cost);
+			for (size_t i = 0; i < paint_rects.size(); i++)
 			{
-				site->func_paint->invoke(it->first, it->second->update_region_list[i]);
+				site->func_paint->invoke(it->first, paint_rects[i]);
 			}
+			it->second->update_region.clear();
 		}
 	}
 }
@@ -675,36 +682,12 @@ void CL_GUIWindowManagerProvider_Texture::request_repaint(CL_GUITopLevelWindow *
 	CL_GUITopLevelWindowTexture *wptr = get_window_texture(handle);
 	if (wptr->dirty)
 	{
-		// If the update region is already set, then check to see if it is a seperate rect or if it
-		// should be extended to include the new update region
-
-		bool updated = false;
-		std::vector<CL_Rect>::size_type size = wptr->update_region_list.size();
-		for (int i = 0; i < size; i++)
-		{
-			if (wptr->update_region_list[i].is_overlapped(update_region))
-			{
-				// Found an overlapping section
-				wptr->update_region_list[i].bounding_rect(update_region);
-				updated = true;
-				break;
-			}
-		}
-
-		if (!updated)
-		{
-			wptr->update_region_list.push_back(update_region);
-		}
-		else
-		{
-			//TODO: Check for overlapping rects in the wptr->update_region_list
-		}
+		wptr->update_region.unite(update_region);
 	}
 	else
 	{
 		wptr->dirty = true;
-		wptr->update_region_list.clear();
-		wptr->update_region_list.push_back(update_region);
+		wptr->update_region = CL_Region(update_region);
 	}
 }
 
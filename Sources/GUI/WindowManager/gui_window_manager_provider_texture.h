@@ -37,6 +37,7 @@
 #include "API/Core/Signals/slot_container.h"
 #include "API/Core/Signals/callback_v0.h"
 #include "API/Core/Signals/callback_v2.h"
+#include "API/Core/Math/region.h"
 #include "API/Display/Window/display_window.h"
 #include "API/Display/Render/texture.h"
 #include "API/Display/Render/frame_buffer.h"
@@ -71,7 +72,7 @@ public:
 	CL_GUITopLevelWindowTexture *owner_window;
 	std::vector<CL_GUITopLevelWindowTexture *> child_windows_zorder;	// Beginning is at the top
 
-	std::vector<CL_Rect> update_region_list;		// Only valid when "dirty" is set to true
+	CL_Region update_region;		// Only valid when "dirty" is set to true
 };
 
 class CL_GUIWindowManagerProvider_Texture : public CL_GUIWindowManagerProvider
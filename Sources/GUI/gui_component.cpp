@@ -602,6 +602,11 @@ bool CL_GUIComponent::get_constant_repaint() const
 	return impl->constant_repaint;
 }
 
+bool CL_GUIComponent::get_render_cache() const
+{
+	return impl->render_cache_enabled;
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_GUIComponent Events:
 
@@ -728,6 +733,22 @@ void CL_GUIComponent::render(CL_GraphicContext &gc, const CL_Rect &clip_rect, bo
 	if (!impl->visible)
 		return;
 
+	if (impl->render_cache_enabled && include_children && !impl->render_cache_rendering)
+	{
+		impl->update_render_cache(gc);
+		if (!impl->render_cache_image.is_null())
+		{
+			// The cache holds premultiplied colors
+			CL_BlendMode old_blend_mode = gc.get_blend_mode();
+			CL_BlendMode blend_mode;
+			blend_mode.set_blend_function(cl_blend_one, cl_blend_one_minus_src_alpha, cl_blend_one, cl_blend_one_minus_src_alpha);
+			gc.set_blend_mode(blend_mode);
+			impl->render_cache_image.draw(gc, 0.0f, 0.0f);
+			gc.set_blend_mode(old_blend_mode);
+		}
+		return;
+	}
+
 	if (!impl->css_layout.is_null())
 	{
 		impl->css_layout.layout(gc, get_size());
@@ -858,6 +879,7 @@ void CL_GUIComponent::capture_proximity(bool capture)
 void CL_GUIComponent::set_type_name(const CL_StringRef &name)
 {
 	impl->type_name = name;
+	impl->invalidate_render_cache();
 	if (!impl->func_style_changed.is_null())
 		impl->func_style_changed.invoke();
 }
@@ -866,6 +888,7 @@ void CL_GUIComponent::set_class_name(const CL_StringRef &name)
 {
 	impl->class_name = name;
 	impl->element_name = CL_String(); // force update of cached element name 
+	impl->invalidate_render_cache();
 	if (!impl->func_style_changed.is_null())
 		impl->func_style_changed.invoke();
 }
@@ -874,6 +897,7 @@ void CL_GUIComponent::set_id_name(const CL_StringRef &name)
 {
 	impl->id_name = name;
 	impl->element_name = CL_String(); // force update of cached element name 
+	impl->invalidate_render_cache();
 	if (!impl->func_style_changed.is_null())
 		impl->func_style_changed.invoke();
 }
@@ -883,6 +907,7 @@ void CL_GUIComponent::set_enabled(bool enable)
 	if (impl->enabled != enable)
 	{
 		impl->enabled = enable;
+		impl->invalidate_render_cache();
 		impl->invoke_enablemode_changed();
 		if (impl->parent == 0)
 			impl->gui_manager.lock()->set_enabled(this, enable);
@@ -1004,6 +1029,7 @@ void CL_GUIComponent::create_components(const CL_StringRef &fullname)
 
 void CL_GUIComponent::request_repaint(CL_Rect request_repaint)
 {
+	impl->invalidate_render_cache();
 	get_gui_manager().request_repaint(component_to_window_coords(request_repaint), get_top_level_component());
 }
 
@@ -1015,6 +1041,15 @@ void CL_GUIComponent::request_repaint()
 void CL_GUIComponent::set_cliprect(CL_GraphicContext &gc, const CL_Rect &rect)
 {
 	CL_Rect windcliprect = component_to_window_coords(rect);
+
+	// Cache textures have their origin at the top-left corner of the cached component
+	CL_GUIComponent *cache_component = impl->gui_manager_impl->render_cache_component;
+	if (cache_component)
+	{
+		gc.set_cliprect(cache_component->window_to_component_coords(windcliprect));
+		return;
+	}
+
 	CL_GUIComponent *toplevel = get_top_level_component();
 	CL_GUITopLevelWindow *window = impl->gui_manager_impl->get_toplevel_window(toplevel);
 	impl->gui_manager_impl->window_manager.set_cliprect(window, gc, windcliprect);
@@ -1022,6 +1057,14 @@ void CL_GUIComponent::set_cliprect(CL_GraphicContext &gc, const CL_Rect &rect)
 
 void CL_GUIComponent::reset_cliprect(CL_GraphicContext &gc)
 {
+	// Inside a render cache, the clip stack also holds the cache bounds, so only the clipping is reset
+	CL_GUIComponent *cache_component = impl->gui_manager_impl->render_cache_component;
+	if (cache_component)
+	{
+		gc.set_cliprect(cache_component->get_size());
+		return;
+	}
+
 	CL_GUIComponent *toplevel = get_top_level_component();
 	CL_GUITopLevelWindow *window = impl->gui_manager_impl->get_toplevel_window(toplevel);
 	impl->gui_manager_impl->window_manager.reset_cliprect(window, gc);
@@ -1030,6 +1073,14 @@ void CL_GUIComponent::reset_cliprect(CL_GraphicContext &gc)
 void CL_GUIComponent::push_cliprect(CL_GraphicContext &gc, const CL_Rect &rect)
 {
 	CL_Rect windcliprect = component_to_window_coords(rect);
+
+	CL_GUIComponent *cache_component = impl->gui_manager_impl->render_cache_component;
+	if (cache_component)
+	{
+		gc.push_cliprect(cache_component->window_to_component_coords(windcliprect));
+		return;
+	}
+
 	CL_GUIComponent *toplevel = get_top_level_component();
 	CL_GUITopLevelWindow *window = impl->gui_manager_impl->get_toplevel_window(toplevel);
 	impl->gui_manager_impl->window_manager.push_cliprect(window, gc, windcliprect);
@@ -1037,6 +1088,12 @@ void CL_GUIComponent::push_cliprect(CL_GraphicContext &gc, const CL_Rect &rect)
 
 void CL_GUIComponent::pop_cliprect(CL_GraphicContext &gc)
 {
+	if (impl->gui_manager_impl->render_cache_component)
+	{
+		gc.pop_cliprect();
+		return;
+	}
+
 	CL_GUIComponent *toplevel = get_top_level_component();
 	CL_GUITopLevelWindow *window = impl->gui_manager_impl->get_toplevel_window(toplevel);
 	impl->gui_manager_impl->window_manager.pop_cliprect(window, gc);
@@ -1274,6 +1331,7 @@ CL_GUIComponent *CL_GUIComponent::get_previous_component_in_tree()
 void CL_GUIComponent::set_default(bool value)
 {
 	impl->default_handler = value;
+	impl->invalidate_render_cache();
 	impl->func_style_changed.invoke();
 }
 
@@ -1297,6 +1355,18 @@ void CL_GUIComponent::set_constant_repaint(bool enable)
 	impl->constant_repaint = enable;
 }
 
+void CL_GUIComponent::set_render_cache(bool enable)
+{
+	if (impl->render_cache_enabled != enable)
+	{
+		impl->render_cache_enabled = enable;
+		impl->render_cache_texture = CL_Texture();
+		impl->render_cache_frame_buffer = CL_FrameBuffer();
+		impl->render_cache_image = CL_Image();
+		request_repaint();
+	}
+}
+
 void CL_GUIComponent::set_selected_in_component_group(bool selected)
 {
 	impl->is_selected_in_group = selected;
@@ -31,6 +31,9 @@
 #include "API/GUI/gui_manager.h"
 #include "API/GUI/gui_component.h"
 #include "API/Display/2D/image.h"
+#include "API/Display/2D/draw.h"
+#include "API/Display/Render/graphic_context.h"
+#include "API/Display/Render/blend_mode.h"
 #include "gui_component_impl.h"
 #include "gui_manager_impl.h"
 
@@ -41,7 +44,8 @@ CL_GUIComponent_Impl::CL_GUIComponent_Impl(const CL_SharedPtr<CL_GUIManager_Impl
 : gui_manager(init_gui_manager), parent(0), prev_sibling(0), next_sibling(0), first_child(0), last_child(0),
   focus_policy(CL_GUIComponent::focus_refuse), allow_resize(false), clip_children(false), enabled(true),
   visible(true), activated(false), default_handler(false), cancel_handler(false),
-  constant_repaint(false), blocks_default_action_when_focused(false), is_selected_in_group(false), double_click_enabled(true)
+  constant_repaint(false), blocks_default_action_when_focused(false), is_selected_in_group(false), double_click_enabled(true),
+  render_cache_enabled(false), render_cache_dirty(true), render_cache_rendering(false)
 {
 	gui_manager_impl = gui_manager.lock().get();
 
@@ -99,6 +103,9 @@ CL_GUIComponent_Impl::~CL_GUIComponent_Impl()
 	if (next_sibling == 0 && parent)
 		parent->impl->last_child = prev_sibling;
 
+	if (parent)
+		parent->impl->invalidate_render_cache();
+
 	gui_manager_impl->remove_component(this);
 }
 
@@ -165,6 +172,89 @@ void CL_GUIComponent_Impl::invoke_enablemode_changed()
 	}
 }
 
+void CL_GUIComponent_Impl::invalidate_render_cache()
+{
+	// Cached ancestors contain our pixels as well
+	CL_GUIComponent_Impl *cur = this;
+	while (cur)
+	{
+		cur->render_cache_dirty = true;
+		cur = cur->parent ? cur->parent->impl.get() : 0;
+	}
+}
+
+void CL_GUIComponent_Impl::update_render_cache(CL_GraphicContext &gc)
+{
+	CL_Size size = geometry.get_size();
+	if (size.width <= 0 || size.height <= 0)
+	{
+		render_cache_texture = CL_Texture();
+		render_cache_image = CL_Image();
+		return;
+	}
+
+	if (render_cache_texture.is_null() || render_cache_texture.get_size() != size)
+	{
+		if (render_cache_frame_buffer.is_null())
+			render_cache_frame_buffer = CL_FrameBuffer(gc);
+		render_cache_texture = CL_Texture(gc, size);
+		render_cache_frame_buffer.attach_color_buffer(0, render_cache_texture);
+		render_cache_image = CL_Image(gc, render_cache_texture, size);
+		render_cache_dirty = true;
+	}
+
+	if (!render_cache_dirty)
+		return;
+
+	CL_FrameBuffer old_frame_buffer = gc.get_write_frame_buffer();
+	CL_BlendMode old_blend_mode = gc.get_blend_mode();
+	CL_GUIComponent *old_cache_component = gui_manager_impl->render_cache_component;
+
+	// Selecting a map mode resets the transform, so save everything the parent has set up first
+	gc.push_modelview();
+	CL_MapMode old_map_mode = gc.get_map_mode();
+	CL_Mat4f old_projection = gc.get_projection();
+	CL_Rectf old_viewport = gc.get_viewport();
+
+	gc.set_frame_buffer(render_cache_frame_buffer);
+	gc.set_map_mode(cl_map_2d_upper_left);
+	gc.set_modelview(CL_Mat4f::identity());
+	gc.push_cliprect();
+	gc.set_cliprect(size);
+
+	CL_BlendMode blend_mode;
+	blend_mode.enable_blending(false);
+	gc.set_blend_mode(blend_mode);
+	CL_Draw::fill(gc, CL_Rectf(size), CL_Colorf::transparent);
+
+	// Accumulate alpha separately so the cache ends up with premultiplied colors
+	blend_mode.enable_blending(true);
+	blend_mode.set_blend_function(cl_blend_src_alpha, cl_blend_one_minus_src_alpha, cl_blend_one, cl_blend_one_minus_src_alpha);
+	gc.set_blend_mode(blend_mode);
+
+	gui_manager_impl->render_cache_component = component;
+	render_cache_rendering = true;
+	component->render(gc, size, true);
+	render_cache_rendering = false;
+	gui_manager_impl->render_cache_component = old_cache_component;
+
+	gc.pop_cliprect();
+	if (old_frame_buffer.is_null())
+		gc.reset_frame_buffer();
+	else
+		gc.set_frame_buffer(old_frame_buffer);
+	gc.set_map_mode(old_map_mode);
+	if (old_map_mode == cl_user_projection)
+	{
+		gc.set_viewport(old_viewport);
+		gc.set_projection(old_projection);
+	}
+	gc.pop_modelview();
+	gc.set_blend_mode(old_blend_mode);
+
+	render_cache_dirty = false;
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_GUIComponent_Impl Implementation:
 
@@ -34,6 +34,9 @@
 #include "API/GUI/gui_component.h"
 #include "API/CSSLayout/css_layout.h"
 #include "API/CSSLayout/css_layout_element.h"
+#include "API/Display/Render/texture.h"
+#include "API/Display/Render/frame_buffer.h"
+#include "API/Display/2D/image.h"
 #include <vector>
 #include <map>
 #include "API/Core/Math/rect.h"
@@ -114,6 +117,12 @@ public:
 	CL_CSSLayout css_layout;
 	CL_CSSLayoutElement css_element;
 	bool double_click_enabled;
+	bool render_cache_enabled;
+	bool render_cache_dirty;
+	bool render_cache_rendering;
+	CL_Texture render_cache_texture;
+	CL_FrameBuffer render_cache_frame_buffer;
+	CL_Image render_cache_image;
 
 /// \}
 /// \name Operations
@@ -123,6 +132,8 @@ public:
 	void set_geometry(CL_Rect new_geometry, bool client_area);
 	void geometry_updated();
 	void invoke_enablemode_changed();
+	void invalidate_render_cache();
+	void update_render_cache(CL_GraphicContext &gc);
 
 /// \}
 /// \name Implementation
@@ -141,6 +141,9 @@ public:
 	CL_Callback_v3<CL_GUITopLevelWindow *, const CL_InputEvent &, const CL_InputState &> func_input_received;
 	CL_GUIFontCache font_cache;
 
+	/// \brief Component currently rendering into its cache texture, or 0 when rendering to the window
+	CL_GUIComponent *render_cache_component;
+
 /// \}
 /// \name Operations
 /// \{
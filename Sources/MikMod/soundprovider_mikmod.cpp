@@ -34,6 +34,7 @@
 #include "API/Core/IOData/virtual_directory.h"
 #include "API/Core/Text/string_help.h"
 #include "API/Core/IOData/path_help.h"
+#include "API/Sound/SoundProviders/soundprovider_buffered_session.h"
 #include "soundprovider_mikmod_impl.h"
 #include "soundprovider_mikmod_session.h"
 
@@ -47,6 +48,7 @@ CL_SoundProvider_MikMod::CL_SoundProvider_MikMod(
 {
 	CL_VirtualDirectory new_directory = directory;
 	CL_IODevice input = new_directory.open_file(filename, CL_File::open_existing, CL_File::access_read, CL_File::share_all);
+	impl->stream = stream;
 	impl->load(input);
 }
 
@@ -59,6 +61,7 @@ CL_SoundProvider_MikMod::CL_SoundProvider_MikMod(
 	CL_VirtualFileSystem vfs(path);
 	CL_VirtualDirectory dir = vfs.get_root_directory();
 	CL_IODevice input = dir.open_file(filename, CL_File::open_existing, CL_File::access_read, CL_File::share_all);
+	impl->stream = stream;
 	impl->load(input);
 }
 
@@ -66,6 +69,7 @@ CL_SoundProvider_MikMod::CL_SoundProvider_MikMod(
 	CL_IODevice &file, bool stream)
 : impl(new CL_SoundProvider_MikMod_Impl)
 {
+	impl->stream = stream;
 	impl->load(file);
 }
 
@@ -73,12 +77,28 @@ CL_SoundProvider_MikMod::~CL_SoundProvider_MikMod()
 {
 }
 
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundProvider_MikMod attributes:
+
+int CL_SoundProvider_MikMod::get_num_underruns() const
+{
+	return impl->num_underruns.get();
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_SoundProvider_MikMod operations:
 
+void CL_SoundProvider_MikMod::set_stream_buffer_size(int samples)
+{
+	impl->stream_buffer_size = samples;
+}
+
 CL_SoundProvider_Session *CL_SoundProvider_MikMod::begin_session()
 {
-	return new CL_SoundProvider_MikMod_Session(*this);
+	CL_SoundProvider_Session *session = new CL_SoundProvider_MikMod_Session(*this);
+	if (impl->stream)
+		session = new CL_SoundProvider_Buffered_Session(session, impl->stream_buffer_size, &impl->num_underruns);
+	return session;
 }
 
 void CL_SoundProvider_MikMod::end_session(CL_SoundProvider_Session *session)
@@ -89,6 +109,8 @@ void CL_SoundProvider_MikMod::end_session(CL_SoundProvider_Session *session)
 /////////////////////////////////////////////////////////////////////////////
 // CL_SoundProvider_MikMod implementation:
 
+CL_Mutex CL_SoundProvider_MikMod_Impl::player_mutex;
+
 void CL_SoundProvider_MikMod_Impl::load(CL_IODevice &input)
 {
 	int size = input.get_size();
@@ -32,6 +32,8 @@
 #include "API/Sound/soundformat.h"
 #include "API/Core/System/databuffer.h"
 #include "API/Core/IOData/virtual_directory.h"
+#include "API/Core/System/interlocked_variable.h"
+#include "API/Core/System/mutex.h"
 #include <cstring>
 
 class CL_InputSourceProvider;
@@ -39,6 +41,12 @@ class CL_IODevice;
 
 class CL_SoundProvider_MikMod_Impl
 {
+/// \name Construction
+/// \{
+public:
+	CL_SoundProvider_MikMod_Impl() : stream(false), stream_buffer_size(65536) { }
+
+/// \}
 /// \name Attributes
 /// \{
 public:
@@ -46,6 +54,18 @@ public:
 
 public:
 	CL_DataBuffer buffer;
+
+	/// \brief True if sessions are rendered ahead on a background thread.
+	bool stream;
+
+	int stream_buffer_size;
+
+	CL_InterlockedVariable num_underruns;
+
+	/// \brief Guards libmikmod, whose player and mixer state is global.
+	///
+	/// Held by every session while it calls into libmikmod, whether from the mixer or a decoder thread.
+	static CL_Mutex player_mutex;
 /// \}
 };
 
@@ -33,6 +33,7 @@
 #include "API/Core/IOData/iodevice_memory.h"
 #include "API/Core/System/exception.h"
 #include "API/Core/System/uniqueptr.h"
+#include "API/Core/System/mutex.h"
 
 #include "soundprovider_mikmod_session.h"
 #include "soundprovider_mikmod_impl.h"
@@ -45,8 +46,10 @@
 // CL_SoundProvider_MikMod_Session construction:
 
 CL_SoundProvider_MikMod_Session::CL_SoundProvider_MikMod_Session(CL_SoundProvider_MikMod &source) :
-	source(source), num_samples(0), position(0), stream_eof(false)
+	source(source), num_samples(0), position(0), stream_eof(true)
 {
+	CL_MutexSection player_lock(&CL_SoundProvider_MikMod_Impl::player_mutex);
+
 	CL_UniquePtr<CL_IODevice_Memory> input_autoptr(new CL_IODevice_Memory(source.impl->buffer));
 	CL_IODevice_Memory *input = input_autoptr.get();
 
@@ -73,7 +76,9 @@ CL_SoundProvider_MikMod_Session::CL_SoundProvider_MikMod_Session(CL_SoundProvide
 
 CL_SoundProvider_MikMod_Session::~CL_SoundProvider_MikMod_Session()
 {
-	Player_Stop();
+	CL_MutexSection player_lock(&CL_SoundProvider_MikMod_Impl::player_mutex);
+	if (Player_GetModule() == module)
+		Player_Stop();
 	Player_Free(module);
 }
 
@@ -105,6 +110,7 @@ int CL_SoundProvider_MikMod_Session::get_position() const
 
 bool CL_SoundProvider_MikMod_Session::set_looping(bool loop)
 {
+	CL_MutexSection player_lock(&CL_SoundProvider_MikMod_Impl::player_mutex);
 	module->wrap = loop;
 	module->loop = loop;
 
@@ -113,23 +119,35 @@ bool CL_SoundProvider_MikMod_Session::set_looping(bool loop)
 
 bool CL_SoundProvider_MikMod_Session::eof() const
 {
-	return !Player_Active();
+	return stream_eof;
 }
 
 void CL_SoundProvider_MikMod_Session::stop()
 {
-	Player_Stop();
+	CL_MutexSection player_lock(&CL_SoundProvider_MikMod_Impl::player_mutex);
+	if (Player_GetModule() == module)
+		Player_Stop();
+	stream_eof = true;
 }
 
 bool CL_SoundProvider_MikMod_Session::play()
 {
-	Player_Start (module);
+	CL_MutexSection player_lock(&CL_SoundProvider_MikMod_Impl::player_mutex);
+	Player_Start(module);
+	stream_eof = false;
 	return true;
 }
-	
+
 bool CL_SoundProvider_MikMod_Session::set_position(int pos)
 {
+	CL_MutexSection player_lock(&CL_SoundProvider_MikMod_Impl::player_mutex);
+
+	// libmikmod can only seek the active module:
+	activate();
 	Player_SetPosition(pos);
+	if (stream_eof)
+		Player_Stop();
+
 	position = pos;
 	if (num_samples < position) num_samples = position;
 	return true;
@@ -137,6 +155,10 @@ bool CL_SoundProvider_MikMod_Session::set_position(int pos)
 
 int CL_SoundProvider_MikMod_Session::get_data(float **channels, int data_requested)
 {
+	CL_MutexSection player_lock(&CL_SoundProvider_MikMod_Impl::player_mutex);
+	if (stream_eof)
+		return 0;
+	activate();
 
 	int total_written = 0;
 	int bytes_per_sample = (format == sf_16bit_signed) ? 2 : 1;
@@ -187,7 +209,8 @@ int CL_SoundProvider_MikMod_Session::get_data(float **channels, int data_request
 		// Check if we reached the end of the song:
 		if (module->sngpos >= module->numpos)
 		{
-			stop();
+			Player_Stop();
+			stream_eof = true;
 			break;
 		}
 
@@ -203,3 +226,11 @@ int CL_SoundProvider_MikMod_Session::get_data(float **channels, int data_request
 
 /////////////////////////////////////////////////////////////////////////////
 // CL_SoundProvider_MikMod_Session implementation:
+
+void CL_SoundProvider_MikMod_Session::activate()
+{
+	// libmikmod plays one module at a time. Switching stops the voices of the previous module,
+	// so sessions playing at the same time take turns and lose the notes sounding at a switch.
+	if (Player_GetModule() != module)
+		Player_Start(module);
+}
@@ -77,11 +77,16 @@ public:
 /// \{
 
 private:
+	/// \brief Makes this session's module the one libmikmod renders. Requires the player mutex.
+	void activate();
+
 	CL_SoundProvider_MikMod source;
 	CL_SoundFormat format;
 	int num_channels;
 	int num_samples;
 	int position;
+
+	/// \brief True while the session is not playing, as libmikmod only tracks the active module
 	bool stream_eof;
 	int frequency;
 	MODULE *module;
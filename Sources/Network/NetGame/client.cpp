@@ -50,11 +50,37 @@ void CL_NetGameClient::connect(const CL_String &server, const CL_String &port)
 	impl->connection.reset(new CL_NetGameConnection(this, CL_SocketName(server, port)));
 }
 
+void CL_NetGameClient::connect_udp(const CL_String &server, const CL_String &port)
+{
+	disconnect();
+	impl->udp_transport.reset(new CL_NetGameUDPTransport(this));
+
+	std::map<CL_String, CL_NetGameEvent::DeliveryMode>::iterator it;
+	for (it = impl->delivery_modes.begin(); it != impl->delivery_modes.end(); ++it)
+		impl->udp_transport->set_delivery_mode(it->first, it->second);
+
+	impl->udp_transport->start();
+
+	// Packets are matched to peers by address, so the server name must be in dotted form.
+	CL_SocketName server_name(server, port);
+	impl->connection.reset(new CL_NetGameConnection(this, impl->udp_transport.get(), server_name.to_ipv4()));
+}
+
+void CL_NetGameClient::set_delivery_mode(const CL_String &event_name, CL_NetGameEvent::DeliveryMode mode)
+{
+	impl->delivery_modes[event_name] = mode;
+	if (impl->udp_transport.get() != 0)
+		impl->udp_transport->set_delivery_mode(event_name, mode);
+}
+
 void CL_NetGameClient::disconnect()
 {
 	if (impl->connection.get() != 0)
 		impl->connection->disconnect();
+	if (impl->udp_transport.get() != 0)
+		impl->udp_transport->stop();
 	impl->connection.reset();
+	impl->udp_transport.reset();
 	impl->events.clear();
 }
 
@@ -30,6 +30,8 @@
 
 #include "API/Core/System/keep_alive.h"
 #include "API/Core/System/uniqueptr.h"
+#include "udp_transport.h"
+#include <map>
 
 class CL_NetGameClient_Impl : public CL_KeepAliveObject
 {
@@ -39,7 +41,9 @@ public:
 	CL_Mutex mutex;
 	std::vector<CL_NetGameNetworkEvent> events;
 
+	CL_UniquePtr<CL_NetGameUDPTransport> udp_transport;
 	CL_UniquePtr<CL_NetGameConnection> connection;
+	std::map<CL_String, CL_NetGameEvent::DeliveryMode> delivery_modes;
 	CL_Signal_v1<const CL_NetGameEvent &> sig_game_event_received;
 	CL_Signal_v0 sig_game_connected;
 	CL_Signal_v0 sig_game_disconnected;
@@ -45,6 +45,12 @@ CL_NetGameConnection::CL_NetGameConnection(CL_NetGameConnectionSite *site, const
 	impl->start(this, site, socket_name);
 }
 
+CL_NetGameConnection::CL_NetGameConnection(CL_NetGameConnectionSite *site, CL_NetGameUDPTransport *transport, const CL_SocketName &socket_name)
+: impl(new CL_NetGameConnection_Impl())
+{
+	impl->start(this, site, transport, socket_name);
+}
+
 CL_NetGameConnection::~CL_NetGameConnection()
 {
 	delete impl;
@@ -74,3 +80,8 @@ CL_SocketName CL_NetGameConnection::get_remote_name() const
 {
 	return impl->get_remote_name();
 }
+
+int CL_NetGameConnection::get_round_trip_time() const
+{
+	return impl->get_round_trip_time();
+}
@@ -31,11 +31,14 @@
 #include "API/Network/NetGame/connection.h"
 #include "API/Network/NetGame/connection_site.h"
 #include "API/Core/System/databuffer.h"
+#include "API/Core/System/uniqueptr.h"
 #include "network_event.h"
 #include "network_data.h"
 #include "connection_impl.h"
+#include "udp_transport.h"
 
 CL_NetGameConnection_Impl::CL_NetGameConnection_Impl()
+: base(0), site(0), udp_transport(0), is_connected(false)
 {
 }
 
@@ -58,10 +61,27 @@ void CL_NetGameConnection_Impl::start(CL_NetGameConnection *xbase, CL_NetGameCon
 	thread.start(this, &CL_NetGameConnection_Impl::connection_main);
 }
 
+void CL_NetGameConnection_Impl::start(CL_NetGameConnection *xbase, CL_NetGameConnectionSite *xsite, CL_NetGameUDPTransport *transport, const CL_SocketName &xsocket_name)
+{
+	base = xbase;
+	site = xsite;
+	udp_transport = transport;
+	socket_name = xsocket_name;
+	is_connected = false;
+	udp_transport->add_peer(base, socket_name);
+}
+
 CL_NetGameConnection_Impl::~CL_NetGameConnection_Impl()
 {
-	stop_event.set();
-	thread.join();
+	if (udp_transport)
+	{
+		udp_transport->remove_peer(base);
+	}
+	else
+	{
+		stop_event.set();
+		thread.join();
+	}
 }
 
 void CL_NetGameConnection_Impl::set_data(const CL_StringRef &name, void *new_data)
@@ -92,20 +112,32 @@ void *CL_NetGameConnection_Impl::get_data(const CL_StringRef &name) const
 
 void CL_NetGameConnection_Impl::send_event(const CL_NetGameEvent &game_event)
 {
+	if (udp_transport)
+	{
+		udp_transport->send_event(base, game_event);
+		return;
+	}
+
 	CL_MutexSection mutex_lock(&mutex);
 	Message message;
 	message.type = Message::type_message;
 	message.event = game_event;
-	send_queue.push_back(message);
+	send_queue.push_back(cl_move(message));
 	queue_event.set();
 }
 
 void CL_NetGameConnection_Impl::disconnect()
 {
+	if (udp_transport)
+	{
+		udp_transport->disconnect_peer(base);
+		return;
+	}
+
 	CL_MutexSection mutex_lock(&mutex);
 	Message message;
 	message.type = Message::type_disconnect;
-	send_queue.push_back(message);
+	send_queue.push_back(cl_move(message));
 	queue_event.set();
 }
 
@@ -114,6 +146,13 @@ CL_SocketName CL_NetGameConnection_Impl::get_remote_name() const
 	return socket_name;
 }
 
+int CL_NetGameConnection_Impl::get_round_trip_time() const
+{
+	if (udp_transport)
+		return udp_transport->get_round_trip_time(base);
+	return -1;
+}
+
 void CL_NetGameConnection_Impl::connection_main()
 {
 	try
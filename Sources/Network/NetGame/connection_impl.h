@@ -29,6 +29,8 @@
 
 #pragma once
 
+class CL_NetGameUDPTransport;
+
 class CL_NetGameConnection_Impl
 {
 public:
@@ -36,11 +38,13 @@ public:
 	~CL_NetGameConnection_Impl();
 	void start(CL_NetGameConnection *base, CL_NetGameConnectionSite *site, const CL_TCPConnection &connection);
 	void start(CL_NetGameConnection *base, CL_NetGameConnectionSite *site, const CL_SocketName &socket_name);
+	void start(CL_NetGameConnection *base, CL_NetGameConnectionSite *site, CL_NetGameUDPTransport *transport, const CL_SocketName &socket_name);
 	void set_data(const CL_StringRef &name, void *data);
 	void *get_data(const CL_StringRef &name) const;
 	void send_event(const CL_NetGameEvent &game_event);
 	void disconnect();
 	CL_SocketName get_remote_name() const;
+	int get_round_trip_time() const;
 
 private:
 	void connection_main();
@@ -50,6 +54,7 @@ private:
 	CL_NetGameConnection *base;
 
 	CL_NetGameConnectionSite *site;
+	CL_NetGameUDPTransport *udp_transport;
 	CL_TCPConnection connection;
 	CL_SocketName socket_name;
 	bool is_connected;
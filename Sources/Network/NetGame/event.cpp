@@ -93,6 +93,13 @@ void CL_NetGameEvent::add_argument(const CL_NetGameEventValue &value)
 	arguments.push_back(value);
 }
 
+#ifdef CL_HAS_RVALUE_REFERENCES
+void CL_NetGameEvent::add_argument(CL_NetGameEventValue &&value)
+{
+	arguments.push_back(std::move(value));
+}
+#endif
+
 CL_String CL_NetGameEvent::to_string() const
 {
 	CL_String event_info = cl_format("%1(", name);
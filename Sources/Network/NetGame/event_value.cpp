@@ -170,6 +170,14 @@ void CL_NetGameEventValue::add_member(const CL_NetGameEventValue &value)
 	value_complex.push_back(value);
 }
 
+#ifdef CL_HAS_RVALUE_REFERENCES
+void CL_NetGameEventValue::add_member(CL_NetGameEventValue &&value)
+{
+	throw_if_not_complex();
+	value_complex.push_back(std::move(value));
+}
+#endif
+
 void CL_NetGameEventValue::set_member(unsigned int index, const CL_NetGameEventValue &value)
 {
 	throw_if_not_complex();
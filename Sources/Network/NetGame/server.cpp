@@ -81,17 +81,45 @@ void CL_NetGameServer::start(const CL_String &address, const CL_String &port)
 	impl->listen_thread.start(this, &CL_NetGameServer::listen_thread_main);
 }
 
+void CL_NetGameServer::start_udp(const CL_String &port)
+{
+	start_udp(CL_String(), port);
+}
+
+void CL_NetGameServer::start_udp(const CL_String &address, const CL_String &port)
+{
+	stop();
+	impl->udp_transport.reset(new CL_NetGameUDPTransport(this));
+	impl->udp_transport->func_peer_accepted().set(impl.get(), &CL_NetGameServer_Impl::add_connection);
+
+	std::map<CL_String, CL_NetGameEvent::DeliveryMode>::iterator it;
+	for (it = impl->delivery_modes.begin(); it != impl->delivery_modes.end(); ++it)
+		impl->udp_transport->set_delivery_mode(it->first, it->second);
+
+	impl->udp_transport->start(CL_SocketName(address, port));
+}
+
+void CL_NetGameServer::set_delivery_mode(const CL_String &event_name, CL_NetGameEvent::DeliveryMode mode)
+{
+	impl->delivery_modes[event_name] = mode;
+	if (impl->udp_transport.get() != 0)
+		impl->udp_transport->set_delivery_mode(event_name, mode);
+}
+
 void CL_NetGameServer::stop()
 {
 	impl->stop_event.set();
 	impl->listen_thread.join();
 	impl->tcp_listen.reset();
+	if (impl->udp_transport.get() != 0)
+		impl->udp_transport->stop();
 
 	for (unsigned int i = 0; i < impl->connections.size(); i++)
 	{
 		delete impl->connections[i];
 	}
 	impl->connections.clear();
+	impl->udp_transport.reset();
 }
 
 void CL_NetGameServer::listen_thread_main()
@@ -125,6 +153,12 @@ CL_Signal_v2<CL_NetGameConnection *, const CL_NetGameEvent &> &CL_NetGameServer:
 	return impl->sig_game_event_received; 
 }
 
+void CL_NetGameServer_Impl::add_connection(CL_NetGameConnection *connection)
+{
+	CL_MutexSection mutex_lock(&mutex);
+	connections.push_back(connection);
+}
+
 void CL_NetGameServer_Impl::process()
 {
 	CL_MutexSection mutex_lock(&mutex);
@@ -31,14 +31,19 @@
 #include "API/Network/Socket/tcp_listen.h"
 #include "API/Core/System/keep_alive.h"
 #include "API/Core/System/uniqueptr.h"
+#include "udp_transport.h"
+#include <map>
 
 class CL_NetGameServer_Impl : public CL_KeepAliveObject
 {
 public:
 	void process();
+	void add_connection(CL_NetGameConnection *connection);
 
 	CL_UniquePtr<CL_TCPListen> tcp_listen;
 	CL_Thread listen_thread;
+	CL_UniquePtr<CL_NetGameUDPTransport> udp_transport;
+	std::map<CL_String, CL_NetGameEvent::DeliveryMode> delivery_modes;
 
 	CL_Mutex mutex;
 	CL_Event stop_event;
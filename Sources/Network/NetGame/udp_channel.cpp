@@ -0,0 +1,372 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2013 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#include "Network/precomp.h"
+#include "API/Core/System/databuffer.h"
+#include "API/Core/Math/cl_math.h"
+#include "API/Core/System/uniqueptr.h"
+#include "network_data.h"
+#include "udp_channel.h"
+#include <cmath>
+
+CL_NetGameUDPChannel::CL_NetGameUDPChannel()
+: local_sequence(0), remote_sequence(0), received_bits(0), packet_received(false), ack_pending(false),
+  last_send_time(0), last_receive_time(0),
+  next_reliable_send(0), next_reliable_receive(0), smoothed_rtt(-1.0f), rtt_variance(0.0f), retransmit_timeout(200)
+{
+}
+
+bool CL_NetGameUDPChannel::is_channel_packet(const void *data, int size)
+{
+	return size >= header_size && *static_cast<const unsigned short*>(data) == protocol_id;
+}
+
+bool CL_NetGameUDPChannel::is_close_packet(const void *data, int size)
+{
+	return size == header_size + 1 && is_channel_packet(data, size) && static_cast<const unsigned char*>(data)[header_size] == message_close;
+}
+
+int CL_NetGameUDPChannel::get_round_trip_time() const
+{
+	if (smoothed_rtt < 0.0f)
+		return -1;
+	return (int)(smoothed_rtt + 0.5f);
+}
+
+void CL_NetGameUDPChannel::send_event(const CL_NetGameEvent &game_event, CL_NetGameEvent::DeliveryMode mode)
+{
+	CL_DataBuffer event_data = CL_NetGameNetworkData::send_data(game_event);
+
+	int prefix_size = (mode == CL_NetGameEvent::unreliable) ? 1 : 3;
+	CL_DataBuffer message(prefix_size + event_data.get_size());
+	unsigned char *d = message.get_data<unsigned char>();
+	memcpy(d + prefix_size, event_data.get_data(), event_data.get_size());
+
+	if (mode == CL_NetGameEvent::unreliable)
+	{
+		d[0] = message_unreliable;
+		unreliable_queue.push_back(message);
+	}
+	else if (mode == CL_NetGameEvent::unreliable_sequenced)
+	{
+		d[0] = message_unreliable_sequenced;
+		*reinterpret_cast<unsigned short*>(d + 1) = next_sequenced_send[game_event.get_name()]++;
+		unreliable_queue.push_back(message);
+	}
+	else
+	{
+		d[0] = message_reliable_ordered;
+		*reinterpret_cast<unsigned short*>(d + 1) = next_reliable_send;
+
+		ReliableMessage reliable;
+		reliable.sequence = next_reliable_send++;
+		reliable.data = message;
+		reliable.sent = false;
+		reliable.send_time = 0;
+		reliable_queue.push_back(reliable);
+	}
+}
+
+CL_DataBuffer CL_NetGameUDPChannel::create_close_packet()
+{
+	CL_DataBuffer packet(header_size + 1);
+	write_header(packet, local_sequence++);
+	packet.get_data<unsigned char>()[header_size] = message_close;
+	return packet;
+}
+
+bool CL_NetGameUDPChannel::read_packet(const void *data, int size, unsigned int time, std::vector<CL_NetGameEvent> &out_events, bool &out_closed)
+{
+	out_closed = false;
+
+	if (!is_channel_packet(data, size))
+		return false;
+
+	const unsigned char *d = static_cast<const unsigned char *>(data);
+
+	unsigned short sequence = *reinterpret_cast<const unsigned short*>(d + 2);
+	unsigned short ack = *reinterpret_cast<const unsigned short*>(d + 4);
+	unsigned int ack_bits = *reinterpret_cast<const unsigned int*>(d + 6);
+
+	last_receive_time = time;
+	process_acks(ack, ack_bits, time);
+
+	if (!track_remote_sequence(sequence))
+		return true; // Duplicate or too old to be acked
+
+	ack_pending = true;
+
+	int pos = header_size;
+	while (pos < size)
+	{
+		unsigned char type = d[pos++];
+		if (type == message_close)
+		{
+			out_closed = true;
+			return true;
+		}
+		else if (type > message_close)
+		{
+			throw CL_Exception("Invalid network data");
+		}
+
+		unsigned short message_sequence = 0;
+		if (type != message_unreliable)
+		{
+			if (pos + 2 > size)
+				throw CL_Exception("Invalid network data");
+			message_sequence = *reinterpret_cast<const unsigned short*>(d + pos);
+			pos += 2;
+		}
+
+		int bytes_consumed = 0;
+		CL_NetGameEvent game_event = CL_NetGameNetworkData::receive_data(d + pos, size - pos, bytes_consumed);
+		if (bytes_consumed == 0)
+			throw CL_Exception("Invalid network data");
+		pos += bytes_consumed;
+
+		if (type == message_unreliable)
+		{
+			out_events.push_back(cl_move(game_event));
+		}
+		else if (type == message_unreliable_sequenced)
+		{
+			std::map<CL_String, unsigned short>::iterator it = last_sequenced_received.find(game_event.get_name());
+			if (it == last_sequenced_received.end())
+			{
+				last_sequenced_received[game_event.get_name()] = message_sequence;
+				out_events.push_back(cl_move(game_event));
+			}
+			else if (sequence_greater(message_sequence, it->second))
+			{
+				it->second = message_sequence;
+				out_events.push_back(cl_move(game_event));
+			}
+		}
+		else
+		{
+			receive_reliable(message_sequence, game_event, out_events);
+		}
+	}
+
+	return true;
+}
+
+void CL_NetGameUDPChannel::write_packets(unsigned int time, unsigned int keep_alive_interval, std::vector<CL_DataBuffer> &out_packets)
+{
+	CL_DataBuffer packet;
+	SentPacket sent;
+
+	for (std::list<ReliableMessage>::iterator it = reliable_queue.begin(); it != reliable_queue.end(); ++it)
+	{
+		if (!it->sent || time - it->send_time >= (unsigned int)retransmit_timeout)
+		{
+			append_message(packet, sent, it->data, time, out_packets);
+			sent.reliable_sequences.push_back(it->sequence);
+			it->sent = true;
+			it->send_time = time;
+		}
+	}
+
+	for (std::vector<CL_DataBuffer>::size_type i = 0; i < unreliable_queue.size(); i++)
+		append_message(packet, sent, unreliable_queue[i], time, out_packets);
+	unreliable_queue.clear();
+
+	if (packet.get_size() == 0 && (ack_pending || time - last_send_time >= keep_alive_interval))
+	{
+		packet.set_size(header_size);
+		sent.reliable_sequences.clear();
+	}
+
+	if (packet.get_size() != 0)
+		finish_packet(packet, sent, time, out_packets);
+}
+
+void CL_NetGameUDPChannel::append_message(CL_DataBuffer &packet, SentPacket &sent, const CL_DataBuffer &message, unsigned int time, std::vector<CL_DataBuffer> &out_packets)
+{
+	// Messages larger than a packet are sent on their own and rely on IP fragmentation.
+	if (packet.get_size() > header_size && packet.get_size() + message.get_size() > max_packet_size)
+		finish_packet(packet, sent, time, out_packets);
+
+	if (packet.get_size() == 0)
+	{
+		packet.set_capacity(max_packet_size);
+		packet.set_size(header_size);
+	}
+
+	int pos = packet.get_size();
+	packet.set_size(pos + message.get_size());
+	memcpy(packet.get_data() + pos, message.get_data(), message.get_size());
+}
+
+void CL_NetGameUDPChannel::finish_packet(CL_DataBuffer &packet, SentPacket &sent, unsigned int time, std::vector<CL_DataBuffer> &out_packets)
+{
+	sent.sequence = local_sequence++;
+	sent.send_time = time;
+	sent.acked = false;
+	write_header(packet, sent.sequence);
+
+	sent_packets.push_back(sent);
+	if (sent_packets.size() > max_sent_packets)
+		sent_packets.pop_front();
+
+	out_packets.push_back(packet);
+	ack_pending = false;
+	last_send_time = time;
+
+	packet = CL_DataBuffer();
+	sent.reliable_sequences.clear();
+}
+
+void CL_NetGameUDPChannel::write_header(CL_DataBuffer &packet, unsigned short sequence)
+{
+	unsigned char *d = packet.get_data<unsigned char>();
+	*reinterpret_cast<unsigned short*>(d) = protocol_id;
+	*reinterpret_cast<unsigned short*>(d + 2) = sequence;
+	*reinterpret_cast<unsigned short*>(d + 4) = remote_sequence;
+	*reinterpret_cast<unsigned int*>(d + 6) = received_bits;
+}
+
+bool CL_NetGameUDPChannel::track_remote_sequence(unsigned short sequence)
+{
+	// Bit N of received_bits is set if packet remote_sequence-1-N was received.
+	if (!packet_received)
+	{
+		packet_received = true;
+		remote_sequence = sequence;
+		received_bits = 0;
+	}
+	else if (sequence_greater(sequence, remote_sequence))
+	{
+		unsigned short shift = sequence - remote_sequence;
+		if (shift < 32)
+			received_bits = (received_bits << shift) | (1u << (shift - 1));
+		else if (shift == 32)
+			received_bits = 1u << 31;
+		else
+			received_bits = 0;
+		remote_sequence = sequence;
+	}
+	else
+	{
+		unsigned short distance = remote_sequence - sequence;
+		if (distance == 0 || distance > 32)
+			return false;
+
+		unsigned int bit = 1u << (distance - 1);
+		if (received_bits & bit)
+			return false;
+		received_bits |= bit;
+	}
+	return true;
+}
+
+void CL_NetGameUDPChannel::process_acks(unsigned short ack, unsigned int ack_bits, unsigned int time)
+{
+	for (std::deque<SentPacket>::iterator it = sent_packets.begin(); it != sent_packets.end(); ++it)
+	{
+		if (it->acked)
+			continue;
+
+		bool acked = false;
+		if (it->sequence == ack)
+		{
+			acked = true;
+		}
+		else if (sequence_greater(ack, it->sequence))
+		{
+			unsigned short distance = ack - it->sequence;
+			acked = distance <= 32 && (ack_bits & (1u << (distance - 1))) != 0;
+		}
+
+		if (!acked)
+			continue;
+
+		it->acked = true;
+		update_round_trip_time(time - it->send_time);
+
+		for (std::vector<unsigned short>::size_type i = 0; i < it->reliable_sequences.size(); i++)
+		{
+			for (std::list<ReliableMessage>::iterator msg_it = reliable_queue.begin(); msg_it != reliable_queue.end(); ++msg_it)
+			{
+				if (msg_it->sequence == it->reliable_sequences[i])
+				{
+					reliable_queue.erase(msg_it);
+					break;
+				}
+			}
+		}
+	}
+}
+
+void CL_NetGameUDPChannel::update_round_trip_time(int sample)
+{
+	// Smoothing as specified in RFC 6298.
+	if (smoothed_rtt < 0.0f)
+	{
+		smoothed_rtt = (float)sample;
+		rtt_variance = sample / 2.0f;
+	}
+	else
+	{
+		rtt_variance = 0.75f * rtt_variance + 0.25f * fabs(smoothed_rtt - sample);
+		smoothed_rtt = 0.875f * smoothed_rtt + 0.125f * sample;
+	}
+
+	retransmit_timeout = (int)(smoothed_rtt + cl_max(10.0f, 4.0f * rtt_variance));
+	retransmit_timeout = cl_clamp(retransmit_timeout, (int)min_retransmit_timeout, (int)max_retransmit_timeout);
+}
+
+void CL_NetGameUDPChannel::receive_reliable(unsigned short sequence, CL_NetGameEvent &game_event, std::vector<CL_NetGameEvent> &out_events)
+{
+	if (sequence == next_reliable_receive)
+	{
+		out_events.push_back(cl_move(game_event));
+		next_reliable_receive++;
+
+		// Deliver the messages that were waiting for this one.
+		while (true)
+		{
+			std::map<unsigned short, CL_NetGameEvent>::iterator it = reliable_received.find(next_reliable_receive);
+			if (it == reliable_received.end())
+				break;
+			out_events.push_back(cl_move(it->second));
+			reliable_received.erase(it);
+			next_reliable_receive++;
+		}
+	}
+	else if (sequence_greater(sequence, next_reliable_receive) && (unsigned short)(sequence - next_reliable_receive) < reliable_receive_window)
+	{
+		reliable_received.insert(std::pair<unsigned short, CL_NetGameEvent>(sequence, cl_move(game_event)));
+	}
+}
+
+bool CL_NetGameUDPChannel::sequence_greater(unsigned short a, unsigned short b)
+{
+	return ((a > b) && (a - b <= 32768)) || ((a < b) && (b - a > 32768));
+}
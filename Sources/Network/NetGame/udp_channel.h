@@ -0,0 +1,149 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2013 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#pragma once
+
+#include "API/Core/System/databuffer.h"
+#include "API/Network/NetGame/event.h"
+#include <list>
+#include <deque>
+#include <map>
+
+/// \brief Reliability layer of one UDP peer.
+///
+/// Events are encoded into messages that are coalesced into packets of up to max_packet_size bytes.
+/// Every packet carries its own sequence number plus an ack of the 33 latest packets received from
+/// the remote end. Reliable messages are resent until a packet containing them has been acked,
+/// using a retransmission timeout derived from the measured round trip time.
+class CL_NetGameUDPChannel
+{
+public:
+	CL_NetGameUDPChannel();
+
+	enum { max_packet_size = 1200 };
+
+	/// \brief Returns true if the data starts with a channel packet header.
+	static bool is_channel_packet(const void *data, int size);
+
+	/// \brief Returns true if the data is a packet created by create_close_packet.
+	static bool is_close_packet(const void *data, int size);
+
+	/// \brief Smoothed round trip time in milliseconds, or -1 if no packet has been acked yet.
+	int get_round_trip_time() const;
+
+	/// \brief Time the last valid packet was received.
+	unsigned int get_last_receive_time() const { return last_receive_time; }
+
+	/// \brief Returns true if a packet has been received from the remote end.
+	bool is_packet_received() const { return packet_received; }
+
+	/// \brief Queue an event for sending.
+	void send_event(const CL_NetGameEvent &game_event, CL_NetGameEvent::DeliveryMode mode);
+
+	/// \brief Create a packet telling the remote end that the channel is closed.
+	CL_DataBuffer create_close_packet();
+
+	/// \brief Processes an incoming packet.
+	///
+	/// \return False if the data is not a channel packet.
+	bool read_packet(const void *data, int size, unsigned int time, std::vector<CL_NetGameEvent> &out_events, bool &out_closed);
+
+	/// \brief Creates the packets that are due.
+	///
+	/// A packet without messages is sent if acks are pending or nothing was sent for keep_alive_interval milliseconds.
+	void write_packets(unsigned int time, unsigned int keep_alive_interval, std::vector<CL_DataBuffer> &out_packets);
+
+private:
+	struct ReliableMessage
+	{
+		unsigned short sequence;
+		CL_DataBuffer data;
+		bool sent;
+		unsigned int send_time;
+	};
+
+	struct SentPacket
+	{
+		unsigned short sequence;
+		unsigned int send_time;
+		bool acked;
+		std::vector<unsigned short> reliable_sequences;
+	};
+
+	enum MessageType
+	{
+		message_unreliable,
+		message_unreliable_sequenced,
+		message_reliable_ordered,
+		message_close
+	};
+
+	enum
+	{
+		protocol_id = 0x4c43,
+		header_size = 10,
+		max_sent_packets = 64,
+		reliable_receive_window = 8192,
+		min_retransmit_timeout = 50,
+		max_retransmit_timeout = 2000
+	};
+
+	void append_message(CL_DataBuffer &packet, SentPacket &sent, const CL_DataBuffer &message, unsigned int time, std::vector<CL_DataBuffer> &out_packets);
+	void finish_packet(CL_DataBuffer &packet, SentPacket &sent, unsigned int time, std::vector<CL_DataBuffer> &out_packets);
+	void write_header(CL_DataBuffer &packet, unsigned short sequence);
+	bool track_remote_sequence(unsigned short sequence);
+	void process_acks(unsigned short ack, unsigned int ack_bits, unsigned int time);
+	void update_round_trip_time(int sample);
+	void receive_reliable(unsigned short sequence, CL_NetGameEvent &game_event, std::vector<CL_NetGameEvent> &out_events);
+
+	static bool sequence_greater(unsigned short a, unsigned short b);
+
+	unsigned short local_sequence;
+	unsigned short remote_sequence;
+	unsigned int received_bits;
+	bool packet_received;
+	bool ack_pending;
+	unsigned int last_send_time;
+	unsigned int last_receive_time;
+
+	// Unreliable sequenced events are ordered per event name, so one name never drops another.
+	std::map<CL_String, unsigned short> next_sequenced_send;
+	std::map<CL_String, unsigned short> last_sequenced_received;
+
+	unsigned short next_reliable_send;
+	unsigned short next_reliable_receive;
+	std::map<unsigned short, CL_NetGameEvent> reliable_received;
+
+	std::vector<CL_DataBuffer> unreliable_queue;
+	std::list<ReliableMessage> reliable_queue;
+	std::deque<SentPacket> sent_packets;
+
+	float smoothed_rtt;
+	float rtt_variance;
+	int retransmit_timeout;
+};
@@ -0,0 +1,322 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2013 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#include "Network/precomp.h"
+#include "API/Network/NetGame/connection.h"
+#include "API/Network/NetGame/connection_site.h"
+#include "API/Core/System/system.h"
+#include "network_event.h"
+#include "udp_transport.h"
+
+CL_NetGameUDPTransport::CL_NetGameUDPTransport(CL_NetGameConnectionSite *site)
+: site(site), accept_peers(false)
+{
+}
+
+CL_NetGameUDPTransport::~CL_NetGameUDPTransport()
+{
+	stop();
+
+	for (std::map<CL_NetGameConnection *, Peer *>::iterator it = connection_peers.begin(); it != connection_peers.end(); ++it)
+		delete it->second;
+}
+
+void CL_NetGameUDPTransport::start()
+{
+	stop();
+	socket = CL_UDPSocket();
+	accept_peers = false;
+	stop_event.reset();
+	thread.start(this, &CL_NetGameUDPTransport::thread_main);
+}
+
+void CL_NetGameUDPTransport::start(const CL_SocketName &local_name)
+{
+	stop();
+	socket = CL_UDPSocket(local_name, false);
+	accept_peers = true;
+	stop_event.reset();
+	thread.start(this, &CL_NetGameUDPTransport::thread_main);
+}
+
+void CL_NetGameUDPTransport::stop()
+{
+	stop_event.set();
+	thread.join();
+
+	// Let the remote ends know right away instead of having them time out.
+	CL_MutexSection mutex_lock(&mutex);
+	for (std::map<CL_NetGameConnection *, Peer *>::iterator it = connection_peers.begin(); it != connection_peers.end(); ++it)
+	{
+		if (!it->second->closed)
+			send_close(it->second);
+	}
+}
+
+void CL_NetGameUDPTransport::set_delivery_mode(const CL_String &event_name, CL_NetGameEvent::DeliveryMode mode)
+{
+	CL_MutexSection mutex_lock(&mutex);
+	delivery_modes[event_name] = mode;
+}
+
+void CL_NetGameUDPTransport::add_peer(CL_NetGameConnection *connection, const CL_SocketName &peer_name)
+{
+	CL_MutexSection mutex_lock(&mutex);
+	Peer *peer = new Peer;
+	peer->connection = connection;
+	peer->name = peer_name;
+	peer->start_time = CL_System::get_time();
+	peer->connected = accept_peers;
+	peers[peer_name] = peer;
+	connection_peers[connection] = peer;
+	queue_event.set();
+}
+
+void CL_NetGameUDPTransport::remove_peer(CL_NetGameConnection *connection)
+{
+	CL_MutexSection mutex_lock(&mutex);
+	std::map<CL_NetGameConnection *, Peer *>::iterator it = connection_peers.find(connection);
+	if (it == connection_peers.end())
+		return;
+
+	Peer *peer = it->second;
+	connection_peers.erase(it);
+
+	// A new peer from the same address may already have replaced this one.
+	std::map<CL_SocketName, Peer *>::iterator name_it = peers.find(peer->name);
+	if (name_it != peers.end() && name_it->second == peer)
+		peers.erase(name_it);
+
+	delete peer;
+}
+
+void CL_NetGameUDPTransport::send_event(CL_NetGameConnection *connection, const CL_NetGameEvent &game_event)
+{
+	CL_MutexSection mutex_lock(&mutex);
+	Peer *peer = find_peer(connection);
+	if (peer == 0 || peer->closed)
+		return;
+
+	CL_NetGameEvent::DeliveryMode mode = CL_NetGameEvent::reliable_ordered;
+	std::map<CL_String, CL_NetGameEvent::DeliveryMode>::iterator it = delivery_modes.find(game_event.get_name());
+	if (it != delivery_modes.end())
+		mode = it->second;
+
+	peer->channel.send_event(game_event, mode);
+	queue_event.set();
+}
+
+void CL_NetGameUDPTransport::disconnect_peer(CL_NetGameConnection *connection)
+{
+	CL_MutexSection mutex_lock(&mutex);
+	Peer *peer = find_peer(connection);
+	if (peer == 0 || peer->closed)
+		return;
+
+	// Flush what is queued once; the close is not acknowledged, so nothing is resent after this.
+	write_peer_packets(peer, CL_System::get_time());
+	send_close(peer);
+	peer->closed = true;
+	mutex_lock.unlock();
+
+	site->add_network_event(CL_NetGameNetworkEvent(connection, CL_NetGameNetworkEvent::client_disconnected));
+}
+
+int CL_NetGameUDPTransport::get_round_trip_time(CL_NetGameConnection *connection)
+{
+	CL_MutexSection mutex_lock(&mutex);
+	Peer *peer = find_peer(connection);
+	if (peer == 0)
+		return -1;
+	return peer->channel.get_round_trip_time();
+}
+
+void CL_NetGameUDPTransport::thread_main()
+{
+	CL_DataBuffer receive_buffer(max_datagram_size);
+	std::vector<CL_NetGameNetworkEvent> events;
+	CL_Event read_event = socket.get_read_event();
+
+	while (true)
+	{
+		int wakeup_reason = CL_Event::wait(stop_event, read_event, queue_event, tick_interval);
+		if (wakeup_reason == 0)
+			break;
+
+		unsigned int time = CL_System::get_time();
+		if (wakeup_reason == 1)
+			receive_packets(receive_buffer, time, events);
+		write_packets(time, events);
+
+		// The site is called without holding the mutex, as it may call back into the transport.
+		for (std::vector<CL_NetGameNetworkEvent>::size_type i = 0; i < events.size(); i++)
+			site->add_network_event(events[i]);
+		events.clear();
+	}
+}
+
+void CL_NetGameUDPTransport::receive_packets(CL_DataBuffer &buffer, unsigned int time, std::vector<CL_NetGameNetworkEvent> &events)
+{
+	CL_Event read_event = socket.get_read_event();
+	do
+	{
+		CL_SocketName from;
+		int bytes = 0;
+		try
+		{
+			bytes = socket.receive(buffer.get_data(), buffer.get_size(), from);
+		}
+		catch (const CL_Exception &)
+		{
+			break;
+		}
+
+		if (bytes > 0)
+			read_packet(from, buffer.get_data(), bytes, time, events);
+	} while (read_event.wait(0));
+}
+
+void CL_NetGameUDPTransport::read_packet(const CL_SocketName &from, const void *data, int size, unsigned int time, std::vector<CL_NetGameNetworkEvent> &events)
+{
+	CL_MutexSection mutex_lock(&mutex);
+	std::map<CL_SocketName, Peer *>::iterator it = peers.find(from);
+	if (it == peers.end())
+	{
+		if (!accept_peers || !CL_NetGameUDPChannel::is_channel_packet(data, size) || CL_NetGameUDPChannel::is_close_packet(data, size))
+			return;
+
+		// The connection registers itself through add_peer. The owner is notified without holding
+		// the mutex, since it calls into the transport while holding its own lock.
+		mutex_lock.unlock();
+		CL_NetGameConnection *connection = new CL_NetGameConnection(site, this, from);
+		if (!peer_accepted.is_null())
+			peer_accepted.invoke(connection);
+		events.push_back(CL_NetGameNetworkEvent(connection, CL_NetGameNetworkEvent::client_connected));
+		mutex_lock.lock();
+
+		it = peers.find(from);
+		if (it == peers.end())
+			return;
+	}
+
+	Peer *peer = it->second;
+	if (peer->closed)
+		return;
+
+	std::vector<CL_NetGameEvent> received_events;
+	bool closed = false;
+	try
+	{
+		if (!peer->channel.read_packet(data, size, time, received_events, closed))
+			return;
+	}
+	catch (const CL_Exception &)
+	{
+		return;
+	}
+
+	if (!peer->connected)
+	{
+		peer->connected = true;
+		events.push_back(CL_NetGameNetworkEvent(peer->connection, CL_NetGameNetworkEvent::client_connected));
+	}
+
+	for (std::vector<CL_NetGameEvent>::size_type i = 0; i < received_events.size(); i++)
+		events.push_back(CL_NetGameNetworkEvent(peer->connection, received_events[i]));
+
+	if (closed)
+	{
+		peer->closed = true;
+		events.push_back(CL_NetGameNetworkEvent(peer->connection, CL_NetGameNetworkEvent::client_disconnected));
+	}
+}
+
+void CL_NetGameUDPTransport::write_packets(unsigned int time, std::vector<CL_NetGameNetworkEvent> &events)
+{
+	CL_MutexSection mutex_lock(&mutex);
+	queue_event.reset();
+
+	for (std::map<CL_NetGameConnection *, Peer *>::iterator it = connection_peers.begin(); it != connection_peers.end(); ++it)
+	{
+		Peer *peer = it->second;
+		if (peer->closed)
+			continue;
+
+		unsigned int last_receive_time = peer->channel.is_packet_received() ? peer->channel.get_last_receive_time() : peer->start_time;
+		if (time - last_receive_time >= timeout_interval)
+		{
+			peer->closed = true;
+			events.push_back(CL_NetGameNetworkEvent(peer->connection, CL_NetGameNetworkEvent::client_disconnected, CL_NetGameEvent("Connection timed out")));
+			continue;
+		}
+
+		write_peer_packets(peer, time);
+	}
+}
+
+void CL_NetGameUDPTransport::write_peer_packets(Peer *peer, unsigned int time)
+{
+	std::vector<CL_DataBuffer> packets;
+	peer->channel.write_packets(time, peer->connected ? keep_alive_interval : connect_interval, packets);
+
+	for (std::vector<CL_DataBuffer>::size_type i = 0; i < packets.size(); i++)
+	{
+		try
+		{
+			socket.send(packets[i].get_data(), packets[i].get_size(), peer->name);
+		}
+		catch (const CL_Exception &)
+		{
+			// Treated as packet loss.
+		}
+	}
+}
+
+void CL_NetGameUDPTransport::send_close(Peer *peer)
+{
+	// Sent a few times as it is never resent.
+	CL_DataBuffer packet = peer->channel.create_close_packet();
+	for (int i = 0; i < 3; i++)
+	{
+		try
+		{
+			socket.send(packet.get_data(), packet.get_size(), peer->name);
+		}
+		catch (const CL_Exception &)
+		{
+		}
+	}
+}
+
+CL_NetGameUDPTransport::Peer *CL_NetGameUDPTransport::find_peer(CL_NetGameConnection *connection)
+{
+	std::map<CL_NetGameConnection *, Peer *>::iterator it = connection_peers.find(connection);
+	if (it != connection_peers.end())
+		return it->second;
+	return 0;
+}
@@ -0,0 +1,115 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2013 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#pragma once
+
+#include "API/Network/Socket/udp_socket.h"
+#include "API/Network/Socket/socket_name.h"
+#include "API/Network/NetGame/event.h"
+#include "API/Core/System/thread.h"
+#include "API/Core/System/event.h"
+#include "API/Core/System/mutex.h"
+#include "API/Core/Signals/callback_v1.h"
+#include "udp_channel.h"
+#include <map>
+
+class CL_NetGameConnection;
+class CL_NetGameConnectionSite;
+class CL_NetGameNetworkEvent;
+
+/// \brief Runs the NetGame connections of a client or server over a single UDP socket.
+///
+/// The CL_NetGameConnection objects are owned by the client or server, like for TCP.
+/// A connection registers itself as a peer on construction and unregisters on destruction.
+class CL_NetGameUDPTransport
+{
+public:
+	CL_NetGameUDPTransport(CL_NetGameConnectionSite *site);
+	~CL_NetGameUDPTransport();
+
+	/// \brief Start the transport on an unbound socket, for connecting to a server.
+	void start();
+
+	/// \brief Start the transport on local_name, accepting packets from new peers.
+	void start(const CL_SocketName &local_name);
+
+	void stop();
+
+	void set_delivery_mode(const CL_String &event_name, CL_NetGameEvent::DeliveryMode mode);
+
+	void add_peer(CL_NetGameConnection *connection, const CL_SocketName &peer_name);
+	void remove_peer(CL_NetGameConnection *connection);
+	void send_event(CL_NetGameConnection *connection, const CL_NetGameEvent &game_event);
+	void disconnect_peer(CL_NetGameConnection *connection);
+	int get_round_trip_time(CL_NetGameConnection *connection);
+
+	/// \brief Invoked from the transport thread when a connection was created for a new peer.
+	CL_Callback_v1<CL_NetGameConnection *> &func_peer_accepted() { return peer_accepted; }
+
+private:
+	struct Peer
+	{
+		Peer() : connection(0), start_time(0), connected(false), closed(false) { }
+
+		CL_NetGameConnection *connection;
+		CL_SocketName name;
+		CL_NetGameUDPChannel channel;
+		unsigned int start_time;
+		bool connected;
+		bool closed;
+	};
+
+	enum
+	{
+		tick_interval = 10,
+		connect_interval = 250,
+		keep_alive_interval = 1000,
+		timeout_interval = 10000,
+		max_datagram_size = 64 * 1024
+	};
+
+	void thread_main();
+	void receive_packets(CL_DataBuffer &buffer, unsigned int time, std::vector<CL_NetGameNetworkEvent> &events);
+	void read_packet(const CL_SocketName &from, const void *data, int size, unsigned int time, std::vector<CL_NetGameNetworkEvent> &events);
+	void write_packets(unsigned int time, std::vector<CL_NetGameNetworkEvent> &events);
+	void write_peer_packets(Peer *peer, unsigned int time);
+	void send_close(Peer *peer);
+	Peer *find_peer(CL_NetGameConnection *connection);
+
+	CL_NetGameConnectionSite *site;
+	CL_UDPSocket socket;
+	bool accept_peers;
+	CL_Thread thread;
+	CL_Event stop_event;
+	CL_Event queue_event;
+	CL_Mutex mutex;
+	std::map<CL_SocketName, Peer *> peers;
+	std::map<CL_NetGameConnection *, Peer *> connection_peers;
+	std::map<CL_String, CL_NetGameEvent::DeliveryMode> delivery_modes;
+	CL_Callback_v1<CL_NetGameConnection *> peer_accepted;
+};
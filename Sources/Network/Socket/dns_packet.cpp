@@ -113,7 +113,7 @@ bool CL_DNSPacket::is_query() const
 	if (impl->data.get_size() < 4)
 		return 0;
 	unsigned short command = ntohs(*(unsigned short *) (impl->data.get_data() + 2));
-	return (command & 0x8000) != 0;
+	return (command & 0x8000) == 0;
 }
 
 bool CL_DNSPacket::is_response() const
@@ -34,11 +34,90 @@
 #include "API/Core/System/system.h"
 #include "API/Core/Text/string_help.h"
 #include "API/Core/IOData/file.h"
+#include "API/Network/Socket/socket_name.h"
 #include "dns_resolver_impl.h"
 #ifdef WIN32
 #include <iphlpapi.h>
 #endif
 
+/////////////////////////////////////////////////////////////////////////////
+// CL_DNSLookup Construction:
+
+CL_DNSLookup::CL_DNSLookup()
+{
+}
+
+CL_DNSLookup::CL_DNSLookup(const CL_SharedPtr<CL_DNSLookup_Impl> &impl)
+: impl(impl)
+{
+}
+
+CL_DNSLookup::~CL_DNSLookup()
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_DNSLookup Attributes:
+
+void CL_DNSLookup::throw_if_null() const
+{
+	if (!impl)
+		throw CL_Exception("CL_DNSLookup is null");
+}
+
+CL_String CL_DNSLookup::get_domain_name() const
+{
+	return impl->domain_name;
+}
+
+CL_String CL_DNSLookup::get_resource_type() const
+{
+	return impl->resource_type;
+}
+
+bool CL_DNSLookup::is_done() const
+{
+	CL_MutexSection mutex_lock(&impl->mutex);
+	return impl->done;
+}
+
+bool CL_DNSLookup::is_failed() const
+{
+	CL_MutexSection mutex_lock(&impl->mutex);
+	return impl->failed;
+}
+
+bool CL_DNSLookup::is_cached() const
+{
+	CL_MutexSection mutex_lock(&impl->mutex);
+	return impl->cached;
+}
+
+CL_String CL_DNSLookup::get_error_message() const
+{
+	CL_MutexSection mutex_lock(&impl->mutex);
+	return impl->error_message;
+}
+
+std::vector<CL_DNSResourceRecord> CL_DNSLookup::get_records() const
+{
+	CL_MutexSection mutex_lock(&impl->mutex);
+	return impl->records;
+}
+
+CL_Event CL_DNSLookup::get_done_event() const
+{
+	return impl->done_event;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_DNSLookup Operations:
+
+bool CL_DNSLookup::wait(int timeout)
+{
+	return impl->done_event.wait(timeout);
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_DNSResolver Construction:
 
@@ -120,6 +199,14 @@ CL_DNSResolver::CL_DNSResolver()
 #endif
 }
 
+CL_DNSResolver::CL_DNSResolver(const std::vector<CL_SocketName> &dns_servers)
+: impl(new CL_DNSResolver_Impl)
+{
+	if (dns_servers.empty())
+		throw CL_Exception("No dns servers specified");
+	impl->dns_servers = dns_servers;
+}
+
 CL_DNSResolver::~CL_DNSResolver()
 {
 }
@@ -127,6 +214,12 @@ CL_DNSResolver::~CL_DNSResolver()
 /////////////////////////////////////////////////////////////////////////////
 // CL_DNSResolver Attributes:
 
+int CL_DNSResolver::get_cache_size() const
+{
+	CL_MutexSection mutex_lock(&impl->mutex);
+	return impl->cache.size();
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_DNSResolver Operations:
 
@@ -135,96 +228,57 @@ std::vector<CL_DNSResourceRecord> CL_DNSResolver::lookup_resource(
 		const CL_String &resource_type,
 		int timeout)
 {
-	CL_String dns_server = impl->dns_servers[0].get_address();
-
-	for (int i=0; i<25; i++)
-	{
-		CL_DNSPacket packet = perform_query(
-			domain_name, resource_type, timeout, dns_server);
-
-		if (packet.is_truncated())
-			throw CL_Exception("Unable to lookup DNS resource; truncated DNS answer packet");
-
-		switch (packet.get_response_code())
-		{
-		case CL_DNSPacket::response_ok:
-			break;
-		case CL_DNSPacket::response_format_error:
-			throw CL_Exception("Unable to lookup DNS resource; format error");
-		case CL_DNSPacket::response_server_failure:
-			throw CL_Exception("Unable to lookup DNS resource; server failure");
-		case CL_DNSPacket::response_name_error:
-			throw CL_Exception("Unable to lookup DNS resource; name error");
-		case CL_DNSPacket::response_not_implemented:
-			throw CL_Exception("Unable to lookup DNS resource; not implemented");
-		case CL_DNSPacket::response_refused:
-			throw CL_Exception("Unable to lookup DNS resource; refused");
-		default:
-			throw CL_Exception("Unable to lookup DNS resource; unknown error");
-		}
-
-		// Does this DNS server know the answer?
-		CL_String domain_name_cname;
-		std::vector<CL_DNSResourceRecord> results;
-		int j;
-		for (j=0; j<packet.get_answer_count(); j++)
-		{
-			CL_DNSResourceRecord record = packet.get_answer(j);
-
-			if (record.get_name() == domain_name && record.get_type() == "CNAME")
-				domain_name_cname = record.get_cname_cname();
-
-			if (record.get_name() == domain_name && record.get_type() == resource_type)
-				results.push_back(record);
-		}
-		for (j=0; j<packet.get_additional_count(); j++)
-		{
-			CL_DNSResourceRecord record = packet.get_additional(j);
+	CL_DNSLookup lookup = lookup_resource_async(domain_name, resource_type, timeout);
+	lookup.wait();
+	if (lookup.is_failed())
+		throw CL_Exception(lookup.get_error_message());
+	return lookup.get_records();
+}
 
-			if (record.get_name() == domain_name && record.get_type() == "CNAME")
-				domain_name_cname = record.get_cname_cname();
+CL_DNSLookup CL_DNSResolver::lookup_resource_async(
+	const CL_String &domain_name,
+	const CL_String &resource_type,
+	int timeout)
+{
+	CL_SharedPtr<CL_DNSLookup_Impl> lookup(new CL_DNSLookup_Impl);
+	lookup->domain_name = domain_name;
+	lookup->resource_type = resource_type;
+	lookup->timeout = timeout;
 
-			if (record.get_name() == domain_name && record.get_type() == resource_type)
-				results.push_back(record);
-		}
-		if (!results.empty())
-			return results;
+	if (!impl->find_cached(lookup))
+	{
+		lookup->packet = CL_DNSPacket(
+			0,
+			CL_DNSPacket::opcode_query,
+			true,
+			domain_name,
+			CL_DNSResourceRecord::type_to_int(resource_type),
+			CL_DNSResourceRecord::class_to_int("IN"));
+
+		CL_MutexSection mutex_lock(&impl->mutex);
+		impl->new_lookups.push_back(lookup);
+		impl->event_lookup.set();
+	}
 
-		// Check for CNAME redirected answers:
-		if (!domain_name_cname.empty())
-		{
-			for (j=0; j<packet.get_answer_count(); j++)
-			{
-				CL_DNSResourceRecord record = packet.get_answer(j);
-				if (record.get_name() == domain_name_cname && record.get_type() == resource_type)
-					results.push_back(record);
-			}
-			for (j=0; j<packet.get_additional_count(); j++)
-			{
-				CL_DNSResourceRecord record = packet.get_additional(j);
-				if (record.get_name() == domain_name_cname && record.get_type() == resource_type)
-					results.push_back(record);
-			}
-			if (!results.empty())
-				return results;
-		}
+	return CL_DNSLookup(lookup);
+}
 
-		// Does it know someone who does?
-		if (packet.get_nameserver_count() > 0)
-		{
-			CL_DNSResourceRecord rr = packet.get_nameserver(0);
-			if (rr.get_type() != "NS")
-				throw CL_Exception("Unable to lookup DNS resource");
-			dns_server = rr.get_ns_nsdname();
-			continue;
-		}
+void CL_DNSResolver::set_negative_cache_ttl(int seconds)
+{
+	CL_MutexSection mutex_lock(&impl->mutex);
+	impl->negative_cache_ttl = seconds;
+}
 
-		// Looks like this resource does not exist.
-		throw CL_Exception("DNS resource data not found");
-	}
+void CL_DNSResolver::set_max_cache_ttl(int seconds)
+{
+	CL_MutexSection mutex_lock(&impl->mutex);
+	impl->max_cache_ttl = seconds;
+}
 
-	std::vector<CL_DNSResourceRecord> results;
-	return results;
+void CL_DNSResolver::clear_cache()
+{
+	CL_MutexSection mutex_lock(&impl->mutex);
+	impl->cache.clear();
 }
 
 CL_DNSPacket CL_DNSResolver::perform_query(
@@ -232,17 +286,16 @@ CL_DNSPacket CL_DNSResolver::perform_query(
 	int timeout,
 	const CL_String &dns_server_name)
 {
+	CL_SocketName dns_server = CL_SocketName(dns_server_name, "53").to_ipv4();
+	int query_id = impl->alloc_query_id();
 	CL_MutexSection mutex_lock(&impl->mutex);
-	int query_id = impl->query_id++;
-	if (impl->query_id > 0xffff)
-		impl->query_id = 0;
 	packet.set_query_id(query_id);
-	impl->queries[query_id] = packet;
+	impl->queries[query_id].packet = packet;
+	impl->queries[query_id].dns_server_address = dns_server;
 	mutex_lock.unlock();
 
 	for (int i = 0; i < timeout; i += 1000)
 	{
-		CL_SocketName dns_server(dns_server_name, "53");
 		impl->udp_socket.send(
 			packet.get_data().get_data(),
 			packet.get_data().get_size(),
@@ -266,6 +319,7 @@ CL_DNSPacket CL_DNSResolver::perform_query(
 		}
 	}
 
+	mutex_lock.lock();
 	impl->queries.erase(impl->queries.find(query_id));
 	throw CL_Exception("Unable to perform lookup");
 	return CL_DNSPacket();
@@ -29,13 +29,17 @@
 #include "Network/precomp.h"
 #include "dns_resolver_impl.h"
 #include "API/Core/System/databuffer.h"
+#include "API/Core/System/system.h"
 #include "API/Core/Text/logger.h"
+#include "API/Core/Text/string_help.h"
+#include "API/Core/Math/cl_math.h"
+#include "API/Network/Socket/udp_datagram.h"
 
 /////////////////////////////////////////////////////////////////////////////
 // CL_DNSResolver_Impl Construction:
 
 CL_DNSResolver_Impl::CL_DNSResolver_Impl()
-: query_id(0)
+: negative_cache_ttl(60), max_cache_ttl(24*60*60)
 {
 	thread.start(this, &CL_DNSResolver_Impl::thread_main);
 }
@@ -52,43 +56,412 @@ CL_DNSResolver_Impl::~CL_DNSResolver_Impl()
 /////////////////////////////////////////////////////////////////////////////
 // CL_DNSResolver_Impl Operations:
 
+int CL_DNSResolver_Impl::alloc_query_id()
+{
+	// Unpredictable ids make forged answers much harder to get accepted (RFC 5452)
+	CL_MutexSection mutex_lock(&mutex);
+	while (true)
+	{
+		unsigned char bytes[2];
+		random.get_random_bytes(bytes, 2);
+		int id = (bytes[0] << 8) | bytes[1];
+		if (queries.find(id) == queries.end() && active_lookups.find(id) == active_lookups.end())
+			return id;
+	}
+}
+
+bool CL_DNSResolver_Impl::find_cached(const CL_SharedPtr<CL_DNSLookup_Impl> &lookup)
+{
+	CL_MutexSection mutex_lock(&mutex);
+	std::map<CL_String, CacheEntry>::iterator it = cache.find(get_cache_key(lookup->domain_name, lookup->resource_type));
+	if (it == cache.end())
+		return false;
+
+	if ((int)(it->second.expire_time - CL_System::get_time()) <= 0)
+	{
+		cache.erase(it);
+		return false;
+	}
+
+	CL_MutexSection lookup_lock(&lookup->mutex);
+	lookup->records = it->second.records;
+	lookup->error_message = it->second.error_message;
+	lookup->failed = !it->second.error_message.empty();
+	lookup->cached = true;
+	lookup->done = true;
+	lookup->done_event.set();
+	return true;
+}
+
 void CL_DNSResolver_Impl::thread_main()
 {
-	// Wait for socket to become bound. This will happen when the first query has been sent.
-	int result = CL_Event::wait(event_stop, event_bound);
-	if (result != 1)
+	bool bound = false;
+	CL_DataBuffer buffer(64*1024);
+	while (true)
+	{
+		int wait_time = process_lookups(bound);
+
+		// Until the socket is bound by the first query sent, wait for the bound event instead of the read event.
+		int result;
+		if (bound)
+		{
+			CL_Event event_read = udp_socket.get_read_event();
+			result = CL_Event::wait(event_stop, event_lookup, event_read, wait_time);
+		}
+		else
+		{
+			result = CL_Event::wait(event_stop, event_lookup, event_bound, wait_time);
+		}
+
+		if (result == 0)
+			break;
+		if (result != 2)
+			continue;
+		if (!bound)
+		{
+			bound = true;
+			continue;
+		}
+
+		try
+		{
+			CL_UDPDatagram datagram(buffer.get_data(), buffer.get_size());
+			while (udp_socket.receive(&datagram, 1) == 1)
+			{
+				try
+				{
+					CL_DNSPacket packet(CL_DataBuffer(buffer.get_data(), datagram.length));
+					CL_SocketName from = datagram.get_address();
+					CL_MutexSection mutex_lock(&mutex);
+					int query_id = packet.get_query_id();
+					std::map<int, Query>::iterator it = queries.find(query_id);
+					if (it != queries.end())
+					{
+						if (from == it->second.dns_server_address && is_answer_to(it->second.packet, packet))
+							answers[query_id] = packet;
+						else
+							cl_log_event("dns", "Ignored dns packet from %1:%2 not matching query %3", from.get_address(), from.get_port(), query_id);
+						continue;
+					}
+
+					std::map<int, CL_SharedPtr<CL_DNSLookup_Impl> >::iterator it_lookup = active_lookups.find(query_id);
+					if (it_lookup != active_lookups.end())
+					{
+						CL_SharedPtr<CL_DNSLookup_Impl> lookup = it_lookup->second;
+						if (!(from == lookup->dns_server_address) || !is_answer_to(lookup->packet, packet))
+						{
+							cl_log_event("dns", "Ignored dns packet from %1:%2 not matching query %3", from.get_address(), from.get_port(), query_id);
+							continue;
+						}
+						active_lookups.erase(it_lookup);
+						mutex_lock.unlock();
+						process_answer(lookup, packet, bound);
+					}
+				}
+				catch (const CL_Exception& e)
+				{
+					cl_log_event("dns", "Exception during parsing of response dns packet: %1", e.message);
+				}
+			}
+		}
+		catch (const CL_Exception& e)
+		{
+			cl_log_event("dns", "Exception while receiving dns packet: %1", e.message);
+		}
+	}
+
+	CL_MutexSection mutex_lock(&mutex);
+	std::vector<CL_SharedPtr<CL_DNSLookup_Impl> > lookups;
+	lookups.swap(new_lookups);
+	std::map<int, CL_SharedPtr<CL_DNSLookup_Impl> >::iterator it;
+	for (it = active_lookups.begin(); it != active_lookups.end(); ++it)
+		lookups.push_back(it->second);
+	active_lookups.clear();
+	mutex_lock.unlock();
+
+	for (std::vector<CL_SharedPtr<CL_DNSLookup_Impl> >::size_type i = 0; i < lookups.size(); i++)
+		fail_lookup(lookups[i], "DNS resolver was destroyed");
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_DNSResolver_Impl Implementation:
+
+int CL_DNSResolver_Impl::process_lookups(bool &bound)
+{
+	const int resend_interval = 1000;
+
+	CL_MutexSection mutex_lock(&mutex);
+	event_lookup.reset();
+	std::vector<CL_SharedPtr<CL_DNSLookup_Impl> > lookups;
+	lookups.swap(new_lookups);
+	mutex_lock.unlock();
+
+	std::vector<CL_SharedPtr<CL_DNSLookup_Impl> >::size_type i;
+	for (i = 0; i < lookups.size(); i++)
+	{
+		lookups[i]->start_time = CL_System::get_time();
+		lookups[i]->dns_server = dns_servers[0];
+		start_query(lookups[i], bound);
+	}
+
+	// Find queries to resend or to give up on:
+	unsigned int current_time = CL_System::get_time();
+	std::vector<CL_SharedPtr<CL_DNSLookup_Impl> > resend, timed_out;
+	mutex_lock.lock();
+	std::map<int, CL_SharedPtr<CL_DNSLookup_Impl> >::iterator it = active_lookups.begin();
+	while (it != active_lookups.end())
+	{
+		CL_SharedPtr<CL_DNSLookup_Impl> lookup = it->second;
+		if ((int)(current_time - lookup->start_time) >= lookup->timeout)
+		{
+			timed_out.push_back(lookup);
+			active_lookups.erase(it++);
+		}
+		else
+		{
+			if ((int)(current_time - lookup->send_time) >= resend_interval)
+				resend.push_back(lookup);
+			++it;
+		}
+	}
+	mutex_lock.unlock();
+
+	for (i = 0; i < timed_out.size(); i++)
+		fail_lookup(timed_out[i], "Unable to perform lookup");
+	for (i = 0; i < resend.size(); i++)
+		send_query(resend[i], bound);
+
+	// Wake up again at the next resend or timeout:
+	int wait_time = -1;
+	mutex_lock.lock();
+	for (it = active_lookups.begin(); it != active_lookups.end(); ++it)
+	{
+		CL_DNSLookup_Impl *lookup = it->second.get();
+		int next_timeout = lookup->timeout - (int)(current_time - lookup->start_time);
+		int next_resend = resend_interval - (int)(current_time - lookup->send_time);
+		int next = cl_max(cl_min(next_timeout, next_resend), 0);
+		if (wait_time == -1 || next < wait_time)
+			wait_time = next;
+	}
+	return wait_time;
+}
+
+void CL_DNSResolver_Impl::start_query(const CL_SharedPtr<CL_DNSLookup_Impl> &lookup, bool &bound)
+{
+	lookup->query_id = alloc_query_id();
+	lookup->packet.set_query_id(lookup->query_id);
+	lookup->dns_server_address = CL_SocketName();
+	send_query(lookup, bound);
+}
+
+void CL_DNSResolver_Impl::send_query(const CL_SharedPtr<CL_DNSLookup_Impl> &lookup, bool &bound)
+{
+	try
+	{
+		// Answers are only accepted from the address the query was sent to
+		if (lookup->dns_server_address.get_address().empty())
+			lookup->dns_server_address = lookup->dns_server.to_ipv4();
+
+		const CL_DataBuffer &data = lookup->packet.get_data();
+		udp_socket.send(data.get_data(), data.get_size(), lookup->dns_server_address);
+		bound = true;
+	}
+	catch (const CL_Exception& e)
+	{
+		CL_MutexSection mutex_lock(&mutex);
+		active_lookups.erase(lookup->query_id);
+		mutex_lock.unlock();
+		fail_lookup(lookup, e.message);
 		return;
+	}
 
-	while (true)
+	lookup->send_time = CL_System::get_time();
+	CL_MutexSection mutex_lock(&mutex);
+	active_lookups[lookup->query_id] = lookup;
+}
+
+void CL_DNSResolver_Impl::process_answer(const CL_SharedPtr<CL_DNSLookup_Impl> &lookup, const CL_DNSPacket &packet, bool &bound)
+{
+	try
 	{
-		CL_Event event_read = udp_socket.get_read_event();
-		int result = CL_Event::wait(event_stop, event_read);
-		if (result != 0)
+		if (packet.is_truncated())
 		{
-			CL_SocketName from;
-			CL_DataBuffer buffer(64*1024);
-			int bytes_read = udp_socket.receive(buffer.get_data(), buffer.get_size(), from);
-			buffer.set_size(bytes_read);
-			try
+			fail_lookup(lookup, "Unable to lookup DNS resource; truncated DNS answer packet");
+			return;
+		}
+
+		switch (packet.get_response_code())
+		{
+		case CL_DNSPacket::response_ok:
+			break;
+		case CL_DNSPacket::response_format_error:
+			fail_lookup(lookup, "Unable to lookup DNS resource; format error");
+			return;
+		case CL_DNSPacket::response_server_failure:
+			fail_lookup(lookup, "Unable to lookup DNS resource; server failure");
+			return;
+		case CL_DNSPacket::response_name_error:
+			fail_lookup(lookup, "Unable to lookup DNS resource; name error", get_negative_ttl(packet));
+			return;
+		case CL_DNSPacket::response_not_implemented:
+			fail_lookup(lookup, "Unable to lookup DNS resource; not implemented");
+			return;
+		case CL_DNSPacket::response_refused:
+			fail_lookup(lookup, "Unable to lookup DNS resource; refused");
+			return;
+		default:
+			fail_lookup(lookup, "Unable to lookup DNS resource; unknown error");
+			return;
+		}
+
+		// Does this DNS server know the answer?
+		std::vector<CL_DNSResourceRecord> records;
+		CL_String domain_name_cname;
+		int ttl = -1;
+		find_records(packet, lookup->domain_name, lookup->resource_type, records, domain_name_cname, ttl);
+
+		// Check for CNAME redirected answers:
+		if (records.empty() && !domain_name_cname.empty())
+		{
+			CL_String cname_cname;
+			find_records(packet, domain_name_cname, lookup->resource_type, records, cname_cname, ttl);
+		}
+
+		if (!records.empty())
+		{
+			complete_lookup(lookup, records, ttl);
+			return;
+		}
+
+		// Does it know someone who does?
+		if (packet.get_nameserver_count() > 0)
+		{
+			CL_DNSResourceRecord rr = packet.get_nameserver(0);
+			if (rr.get_type() == "NS")
 			{
-				CL_DNSPacket packet(buffer);
-				CL_MutexSection mutex_lock(&mutex);
-				int query_id = packet.get_query_id();
-				std::map<int, CL_DNSPacket>::iterator it = queries.find(query_id);
-				if (it != queries.end())
-					answers[query_id] = packet;
+				if (++lookup->referrals >= 25)
+				{
+					fail_lookup(lookup, "Unable to lookup DNS resource; too many referrals");
+					return;
+				}
+				lookup->dns_server = CL_SocketName(rr.get_ns_nsdname(), "53");
+				start_query(lookup, bound);
+				return;
 			}
-			catch (const CL_Exception& e)
+			else if (rr.get_type() != "SOA")
 			{
-				cl_log_event("dns", "Exception during parsing of response dns packet: %1", e.message);
+				fail_lookup(lookup, "Unable to lookup DNS resource");
+				return;
 			}
 		}
-		else
+
+		// Looks like this resource does not exist.
+		fail_lookup(lookup, "DNS resource data not found", get_negative_ttl(packet));
+	}
+	catch (const CL_Exception& e)
+	{
+		fail_lookup(lookup, e.message);
+	}
+}
+
+void CL_DNSResolver_Impl::complete_lookup(const CL_SharedPtr<CL_DNSLookup_Impl> &lookup, const std::vector<CL_DNSResourceRecord> &records, int ttl)
+{
+	add_to_cache(lookup, records, CL_String(), ttl);
+
+	CL_MutexSection lookup_lock(&lookup->mutex);
+	lookup->records = records;
+	lookup->done = true;
+	lookup->done_event.set();
+}
+
+void CL_DNSResolver_Impl::fail_lookup(const CL_SharedPtr<CL_DNSLookup_Impl> &lookup, const CL_String &error_message, int negative_ttl)
+{
+	add_to_cache(lookup, std::vector<CL_DNSResourceRecord>(), error_message, negative_ttl);
+
+	CL_MutexSection lookup_lock(&lookup->mutex);
+	lookup->error_message = error_message;
+	lookup->failed = true;
+	lookup->done = true;
+	lookup->done_event.set();
+}
+
+void CL_DNSResolver_Impl::add_to_cache(const CL_SharedPtr<CL_DNSLookup_Impl> &lookup, const std::vector<CL_DNSResourceRecord> &records, const CL_String &error_message, int ttl)
+{
+	CL_MutexSection mutex_lock(&mutex);
+	ttl = cl_min(ttl, max_cache_ttl);
+	if (ttl <= 0)
+		return;
+
+	unsigned int current_time = CL_System::get_time();
+	if (cache.size() >= 1024)
+	{
+		std::map<CL_String, CacheEntry>::iterator it = cache.begin();
+		while (it != cache.end())
 		{
-			break;
+			if ((int)(it->second.expire_time - current_time) <= 0)
+				cache.erase(it++);
+			else
+				++it;
 		}
 	}
+
+	CacheEntry &entry = cache[get_cache_key(lookup->domain_name, lookup->resource_type)];
+	entry.records = records;
+	entry.error_message = error_message;
+	entry.expire_time = current_time + ttl * 1000;
 }
 
-/////////////////////////////////////////////////////////////////////////////
-// CL_DNSResolver_Impl Implementation:
+int CL_DNSResolver_Impl::get_negative_ttl(const CL_DNSPacket &packet)
+{
+	// RFC 2308: negative answers are cached for the lower of the SOA TTL and the SOA minimum field.
+	if (packet.get_nameserver_count() > 0)
+	{
+		CL_DNSResourceRecord rr = packet.get_nameserver(0);
+		if (rr.get_type() == "SOA")
+			return cl_min(rr.get_ttl(), (int)cl_min(rr.get_soa_minimum(), (unsigned int)0x7fffffff));
+	}
+
+	CL_MutexSection mutex_lock(&mutex);
+	return negative_cache_ttl;
+}
+
+bool CL_DNSResolver_Impl::is_answer_to(const CL_DNSPacket &query, const CL_DNSPacket &answer)
+{
+	if (!answer.is_response() || answer.get_question_count() != 1 || query.get_question_count() != 1)
+		return false;
+
+	return
+		CL_StringHelp::compare(answer.get_question_name(0), query.get_question_name(0), true) == 0 &&
+		answer.get_question_type(0) == query.get_question_type(0) &&
+		answer.get_question_class(0) == query.get_question_class(0);
+}
+
+CL_String CL_DNSResolver_Impl::get_cache_key(const CL_String &domain_name, const CL_String &resource_type)
+{
+	return CL_StringHelp::text_to_lower(domain_name) + " " + resource_type;
+}
+
+void CL_DNSResolver_Impl::find_records(const CL_DNSPacket &packet, const CL_String &domain_name, const CL_String &resource_type, std::vector<CL_DNSResourceRecord> &out_records, CL_String &out_cname, int &inout_ttl)
+{
+	int count = packet.get_answer_count() + packet.get_additional_count();
+	for (int i = 0; i < count; i++)
+	{
+		CL_DNSResourceRecord record;
+		if (i < packet.get_answer_count())
+			record = packet.get_answer(i);
+		else
+			record = packet.get_additional(i - packet.get_answer_count());
+
+		if (record.get_name() != domain_name)
+			continue;
+
+		bool is_cname = (record.get_type() == "CNAME");
+		bool is_match = (record.get_type() == resource_type);
+		if (is_cname)
+			out_cname = record.get_cname_cname();
+		if (is_match)
+			out_records.push_back(record);
+		if (is_cname || is_match)
+			inout_ttl = (inout_ttl == -1) ? record.get_ttl() : cl_min(inout_ttl, record.get_ttl());
+	}
+}
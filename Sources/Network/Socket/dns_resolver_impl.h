@@ -32,12 +32,45 @@
 #include "API/Core/System/mutex.h"
 #include "API/Core/System/thread.h"
 #include "API/Core/System/event.h"
+#include "API/Core/Crypto/random.h"
 #include "API/Network/Socket/socket_name.h"
 #include "API/Network/Socket/udp_socket.h"
 #include "API/Network/Socket/dns_packet.h"
+#include "API/Network/Socket/dns_resource_record.h"
 #include <vector>
 #include <map>
 
+class CL_DNSLookup_Impl
+{
+public:
+	CL_DNSLookup_Impl()
+	: timeout(0), start_time(0), send_time(0), query_id(0), referrals(0), done(false), failed(false), cached(false)
+	{
+	}
+
+	CL_String domain_name;
+	CL_String resource_type;
+	int timeout;
+
+	// Query state, only used by the resolver thread:
+	CL_SocketName dns_server;
+	CL_SocketName dns_server_address;
+	CL_DNSPacket packet;
+	unsigned int start_time;
+	unsigned int send_time;
+	int query_id;
+	int referrals;
+
+	// Result, protected by mutex:
+	CL_Mutex mutex;
+	bool done;
+	bool failed;
+	bool cached;
+	CL_String error_message;
+	std::vector<CL_DNSResourceRecord> records;
+	CL_Event done_event;
+};
+
 class CL_DNSResolver_Impl
 {
 /// \name Construction
@@ -54,21 +87,44 @@ public:
 /// \{
 
 public:
-	int query_id;
+	struct CacheEntry
+	{
+		std::vector<CL_DNSResourceRecord> records;
+		CL_String error_message;
+		unsigned int expire_time;
+	};
+
+	struct Query
+	{
+		CL_DNSPacket packet;
+		CL_SocketName dns_server_address;
+	};
+
+	CL_Random random;
 
 	std::vector<CL_SocketName> dns_servers;
 
-	std::map<int, CL_DNSPacket> queries;
+	std::map<int, Query> queries;
 
 	std::map<int, CL_DNSPacket> answers;
 
+	std::vector<CL_SharedPtr<CL_DNSLookup_Impl> > new_lookups;
+
+	std::map<int, CL_SharedPtr<CL_DNSLookup_Impl> > active_lookups;
+
+	std::map<CL_String, CacheEntry> cache;
+
+	int negative_cache_ttl;
+
+	int max_cache_ttl;
+
 	CL_UDPSocket udp_socket;
 
 	CL_Mutex mutex;
 
 	CL_Thread thread;
 
-	CL_Event event_stop, event_bound;
+	CL_Event event_stop, event_bound, event_lookup;
 
 
 /// \}
@@ -76,6 +132,10 @@ public:
 /// \{
 
 public:
+	int alloc_query_id();
+
+	bool find_cached(const CL_SharedPtr<CL_DNSLookup_Impl> &lookup);
+
 	void thread_main();
 
 
@@ -84,7 +144,26 @@ public:
 /// \{
 
 private:
-/// \}
-};
+	int process_lookups(bool &bound);
+
+	void start_query(const CL_SharedPtr<CL_DNSLookup_Impl> &lookup, bool &bound);
+
+	void send_query(const CL_SharedPtr<CL_DNSLookup_Impl> &lookup, bool &bound);
+
+	void process_answer(const CL_SharedPtr<CL_DNSLookup_Impl> &lookup, const CL_DNSPacket &packet, bool &bound);
 
+	void complete_lookup(const CL_SharedPtr<CL_DNSLookup_Impl> &lookup, const std::vector<CL_DNSResourceRecord> &records, int ttl);
 
+	void fail_lookup(const CL_SharedPtr<CL_DNSLookup_Impl> &lookup, const CL_String &error_message, int negative_ttl = -1);
+
+	void add_to_cache(const CL_SharedPtr<CL_DNSLookup_Impl> &lookup, const std::vector<CL_DNSResourceRecord> &records, const CL_String &error_message, int ttl);
+
+	int get_negative_ttl(const CL_DNSPacket &packet);
+
+	static bool is_answer_to(const CL_DNSPacket &query, const CL_DNSPacket &answer);
+
+	static CL_String get_cache_key(const CL_String &domain_name, const CL_String &resource_type);
+
+	static void find_records(const CL_DNSPacket &packet, const CL_String &domain_name, const CL_String &resource_type, std::vector<CL_DNSResourceRecord> &out_records, CL_String &out_cname, int &inout_ttl);
+/// \}
+};
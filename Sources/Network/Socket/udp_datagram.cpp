@@ -0,0 +1,83 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#include "Network/precomp.h"
+#include "API/Network/Socket/udp_datagram.h"
+#include "API/Network/Socket/socket_name.h"
+#ifndef WIN32
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <string.h>
+#endif
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_UDPDatagram Construction:
+
+CL_UDPDatagram::CL_UDPDatagram()
+: data(0), size(0), length(0), address(0), port(0), truncated(false)
+{
+}
+
+CL_UDPDatagram::CL_UDPDatagram(void *buffer, int buffer_size)
+: data(buffer), size(buffer_size), length(0), address(0), port(0), truncated(false)
+{
+}
+
+CL_UDPDatagram::CL_UDPDatagram(const void *data, int length, const CL_SocketName &to)
+: data(const_cast<void *>(data)), size(length), length(length), address(0), port(0), truncated(false)
+{
+	set_address(to);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_UDPDatagram Attributes:
+
+CL_SocketName CL_UDPDatagram::get_address() const
+{
+	sockaddr_in addr;
+	memset(&addr, 0, sizeof(sockaddr_in));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(address);
+	addr.sin_port = htons(port);
+
+	CL_SocketName name;
+	name.from_sockaddr(AF_INET, (sockaddr *) &addr, sizeof(sockaddr_in));
+	return name;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_UDPDatagram Operations:
+
+void CL_UDPDatagram::set_address(const CL_SocketName &name)
+{
+	sockaddr_in addr;
+	name.to_sockaddr(AF_INET, (sockaddr *) &addr, sizeof(sockaddr_in));
+	address = ntohl(addr.sin_addr.s_addr);
+	port = ntohs(addr.sin_port);
+}
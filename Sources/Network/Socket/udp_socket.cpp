@@ -105,5 +105,15 @@ int CL_UDPSocket::peek(void *data, int len, CL_SocketName &out_from)
 	return impl->peek(data, len, out_from);
 }
 
+int CL_UDPSocket::send(const CL_UDPDatagram *datagrams, int count)
+{
+	return impl->send(datagrams, count);
+}
+
+int CL_UDPSocket::receive(CL_UDPDatagram *datagrams, int count)
+{
+	return impl->receive(datagrams, count);
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_UDPSocket Implementation:
@@ -132,5 +132,15 @@ int CL_UDPSocket_Impl::peek(void *data, int len, CL_SocketName &out_from)
 	return socket.peek_from(data, len, out_from);
 }
 
+int CL_UDPSocket_Impl::send(const CL_UDPDatagram *datagrams, int count)
+{
+	return socket.send_to(datagrams, count);
+}
+
+int CL_UDPSocket_Impl::receive(CL_UDPDatagram *datagrams, int count)
+{
+	return socket.receive_from(datagrams, count);
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_UDPSocket_Impl Implementation:
@@ -41,6 +41,7 @@
 
 class CL_SocketName;
 class CL_Event;
+class CL_UDPDatagram;
 
 class CL_UDPSocket_Impl
 {
@@ -75,6 +76,8 @@ public:
 	int send(const void *data, int len, const CL_SocketName &to);
 	int receive(void *data, int len, CL_SocketName &out_from);
 	int peek(void *data, int len, CL_SocketName &out_from);
+	int send(const CL_UDPDatagram *datagrams, int count);
+	int receive(CL_UDPDatagram *datagrams, int count);
 
 
 /// \}
@@ -30,6 +30,7 @@
 #include "unix_socket.h"
 #include "API/Core/Text/string_format.h"
 #include "API/Network/Socket/socket_name.h"
+#include "API/Network/Socket/udp_datagram.h"
 #include <sys/time.h>
 #include <sys/types.h>
 #include <sys/socket.h>
@@ -304,6 +305,183 @@ int CL_UnixSocket::send_to(const void *data, int size, const CL_SocketName &sock
 	}
 }
 
+#ifdef __linux__
+
+int CL_UnixSocket::receive_from(CL_UDPDatagram *datagrams, int count)
+{
+	const int max_batch = 64;
+	mmsghdr msgs[max_batch];
+	iovec iovecs[max_batch];
+	sockaddr_in addrs[max_batch];
+
+	int received = 0;
+	while (received < count)
+	{
+		int batch = count - received;
+		if (batch > max_batch)
+			batch = max_batch;
+
+		memset(msgs, 0, sizeof(mmsghdr) * batch);
+		for (int i = 0; i < batch; i++)
+		{
+			iovecs[i].iov_base = datagrams[received + i].data;
+			iovecs[i].iov_len = datagrams[received + i].size;
+			msgs[i].msg_hdr.msg_iov = &iovecs[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+			msgs[i].msg_hdr.msg_name = &addrs[i];
+			msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+		}
+
+		int result = ::recvmmsg(handle, msgs, batch, MSG_DONTWAIT, 0);
+		if (result == -1)
+		{
+			int errorcode = errno;
+			if (errorcode == EINTR)
+				continue;
+			else if (errorcode == EAGAIN || errorcode == EWOULDBLOCK)
+				break;
+			else
+				throw CL_Exception(error_to_string(errorcode));
+		}
+
+		for (int i = 0; i < result; i++)
+		{
+			CL_UDPDatagram &datagram = datagrams[received + i];
+			datagram.length = msgs[i].msg_len;
+			datagram.truncated = (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+			datagram.address = ntohl(addrs[i].sin_addr.s_addr);
+			datagram.port = ntohs(addrs[i].sin_port);
+		}
+		received += result;
+
+		if (result < batch)
+			break;
+	}
+	return received;
+}
+
+int CL_UnixSocket::send_to(const CL_UDPDatagram *datagrams, int count)
+{
+	const int max_batch = 64;
+	mmsghdr msgs[max_batch];
+	iovec iovecs[max_batch];
+	sockaddr_in addrs[max_batch];
+
+	int sent = 0;
+	while (sent < count)
+	{
+		int batch = count - sent;
+		if (batch > max_batch)
+			batch = max_batch;
+
+		memset(msgs, 0, sizeof(mmsghdr) * batch);
+		memset(addrs, 0, sizeof(sockaddr_in) * batch);
+		for (int i = 0; i < batch; i++)
+		{
+			const CL_UDPDatagram &datagram = datagrams[sent + i];
+			addrs[i].sin_family = AF_INET;
+			addrs[i].sin_addr.s_addr = htonl(datagram.address);
+			addrs[i].sin_port = htons(datagram.port);
+			iovecs[i].iov_base = datagram.data;
+			iovecs[i].iov_len = datagram.length;
+			msgs[i].msg_hdr.msg_iov = &iovecs[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+			msgs[i].msg_hdr.msg_name = &addrs[i];
+			msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+		}
+
+		int result = ::sendmmsg(handle, msgs, batch, MSG_DONTWAIT);
+		if (result == -1)
+		{
+			int errorcode = errno;
+			if (errorcode == EINTR)
+				continue;
+			else if (errorcode == EAGAIN || errorcode == EWOULDBLOCK)
+				break;
+			else
+				throw CL_Exception(error_to_string(errorcode));
+		}
+
+		sent += result;
+		if (result < batch)
+			break;
+	}
+	return sent;
+}
+
+#else
+
+int CL_UnixSocket::receive_from(CL_UDPDatagram *datagrams, int count)
+{
+	int received = 0;
+	while (received < count)
+	{
+		CL_UDPDatagram &datagram = datagrams[received];
+
+		sockaddr_in addr;
+		memset(&addr, 0, sizeof(sockaddr_in));
+		iovec iov;
+		iov.iov_base = datagram.data;
+		iov.iov_len = datagram.size;
+		msghdr msg;
+		memset(&msg, 0, sizeof(msghdr));
+		msg.msg_name = &addr;
+		msg.msg_namelen = sizeof(sockaddr_in);
+		msg.msg_iov = &iov;
+		msg.msg_iovlen = 1;
+
+		int result = ::recvmsg(handle, &msg, MSG_DONTWAIT);
+		if (result == -1)
+		{
+			int errorcode = errno;
+			if (errorcode == EINTR)
+				continue;
+			else if (errorcode == EAGAIN || errorcode == EWOULDBLOCK)
+				break;
+			else
+				throw CL_Exception(error_to_string(errorcode));
+		}
+
+		datagram.length = result;
+		datagram.truncated = (msg.msg_flags & MSG_TRUNC) != 0;
+		datagram.address = ntohl(addr.sin_addr.s_addr);
+		datagram.port = ntohs(addr.sin_port);
+		received++;
+	}
+	return received;
+}
+
+int CL_UnixSocket::send_to(const CL_UDPDatagram *datagrams, int count)
+{
+	int sent = 0;
+	while (sent < count)
+	{
+		const CL_UDPDatagram &datagram = datagrams[sent];
+
+		sockaddr_in addr;
+		memset(&addr, 0, sizeof(sockaddr_in));
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(datagram.address);
+		addr.sin_port = htons(datagram.port);
+
+		int result = ::sendto(handle, (const char *) datagram.data, datagram.length, MSG_DONTWAIT, (const sockaddr *) &addr, sizeof(sockaddr_in));
+		if (result == -1)
+		{
+			int errorcode = errno;
+			if (errorcode == EINTR)
+				continue;
+			else if (errorcode == EAGAIN || errorcode == EWOULDBLOCK)
+				break;
+			else
+				throw CL_Exception(error_to_string(errorcode));
+		}
+		sent++;
+	}
+	return sent;
+}
+
+#endif
+
 void CL_UnixSocket::close_send()
 {
 	shutdown(handle, SHUT_WR);
@@ -33,6 +33,7 @@ typedef int SOCKET;
 #endif
 
 class CL_SocketName;
+class CL_UDPDatagram;
 
 class CL_UnixSocket
 {
@@ -71,6 +72,9 @@ public:
 	int peek_from(void *data, int size, CL_SocketName &out_socketname);
 	int send_to(const void *data, int size, const CL_SocketName &socketname);
 
+	int receive_from(CL_UDPDatagram *datagrams, int count);
+	int send_to(const CL_UDPDatagram *datagrams, int count);
+
 	int get_handle() const { return handle; }
 
 private:
@@ -30,6 +30,7 @@
 #include "win32_socket.h"
 #include "API/Core/Text/string_format.h"
 #include "API/Network/Socket/socket_name.h"
+#include "API/Network/Socket/udp_datagram.h"
 #include <Mstcpip.h>
 
 CL_Win32Socket::CL_Win32Socket()
@@ -330,6 +331,71 @@ int CL_Win32Socket::send_to(const void *data, int size, const CL_SocketName &soc
 	}
 }
 
+int CL_Win32Socket::receive_from(CL_UDPDatagram *datagrams, int count)
+{
+	int received = 0;
+	while (received < count)
+	{
+		CL_UDPDatagram &datagram = datagrams[received];
+
+		sockaddr_in addr;
+		memset(&addr, 0, sizeof(sockaddr_in));
+		int addr_size = sizeof(sockaddr_in);
+		int result = ::recvfrom(handle, (char *) datagram.data, datagram.size, 0, (sockaddr *) &addr, &addr_size);
+		datagram.truncated = false;
+		if (result == SOCKET_ERROR)
+		{
+			int errorcode = WSAGetLastError();
+			if (errorcode == WSAEWOULDBLOCK)
+				break;
+			else if (errorcode == WSAEMSGSIZE)
+				datagram.truncated = true;
+			else
+				throw CL_Exception(error_to_string(errorcode));
+			result = datagram.size;
+		}
+
+		datagram.length = result;
+		datagram.address = ntohl(addr.sin_addr.s_addr);
+		datagram.port = ntohs(addr.sin_port);
+		received++;
+	}
+	reset_receive();
+	return received;
+}
+
+int CL_Win32Socket::send_to(const CL_UDPDatagram *datagrams, int count)
+{
+	int sent = 0;
+	while (sent < count)
+	{
+		const CL_UDPDatagram &datagram = datagrams[sent];
+
+		sockaddr_in addr;
+		memset(&addr, 0, sizeof(sockaddr_in));
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(datagram.address);
+		addr.sin_port = htons(datagram.port);
+
+		int result = ::sendto(handle, (const char *) datagram.data, datagram.length, 0, (const sockaddr *) &addr, sizeof(sockaddr_in));
+		if (result == SOCKET_ERROR)
+		{
+			int errorcode = WSAGetLastError();
+			if (errorcode == WSAEWOULDBLOCK)
+			{
+				reset_send();
+				break;
+			}
+			else
+			{
+				throw CL_Exception(error_to_string(errorcode));
+			}
+		}
+		sent++;
+	}
+	return sent;
+}
+
 void CL_Win32Socket::close_send()
 {
 	shutdown(handle, SD_SEND);
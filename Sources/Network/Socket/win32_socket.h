@@ -29,6 +29,7 @@
 #pragma once
 
 class CL_SocketName;
+class CL_UDPDatagram;
 
 class CL_Win32Socket
 {
@@ -67,6 +68,9 @@ public:
 	int peek_from(void *data, int size, CL_SocketName &out_socketname);
 	int send_to(const void *data, int size, const CL_SocketName &socketname);
 
+	int receive_from(CL_UDPDatagram *datagrams, int count);
+	int send_to(const CL_UDPDatagram *datagrams, int count);
+
 	HANDLE get_event_handle() const { return event_handle; }
 	void process_events();
 
@@ -33,9 +33,13 @@
 #include "API/Core/IOData/iodevice_provider.h"
 #include "API/Core/Text/string_help.h"
 #include "API/Core/Text/string_format.h"
+#include "API/Core/Text/string_format_buffer.h"
 #include "http_server_connection_impl.h"
 #include "http_server_impl.h"
 
+static const CL_StringFormatPattern cl_http_status_line("HTTP/1.1 %1 %2\r\n");
+static const CL_StringFormatPattern cl_http_content_length_line("Content-Length: %1\r\n");
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_IODeviceProvider_HTTPServerConnection class:
 
@@ -209,13 +213,9 @@ void CL_HTTPServerConnection::write_response_status(int status_code, const CL_St
 	if (impl->performed_write)
 		throw CL_Exception("Cannot write reponse status if manual writing has been performed first.");
 
-	CL_String8 status_line;
-	status_line.append("HTTP/1.1 ");
-	status_line.append(CL_StringHelp::int_to_local8(status_code));
-	status_line.append(" ");
-	status_line.append(status_text);
-	status_line.append("\r\n");
-	impl->connection.write(status_line.data(), status_line.length(), true);
+	CL_StringFormatBuffer status_line;
+	cl_format_to(status_line, cl_http_status_line, status_code, status_text);
+	impl->connection.write(status_line.c_str(), status_line.length(), true);
 }
 
 void CL_HTTPServerConnection::write_response_headers(const CL_StringRef8 &headers)
@@ -298,11 +298,9 @@ void CL_HTTPServerConnection::write_response_data(const CL_DataBuffer &data)
 	{
 		if (impl->written_content_length == -1)
 		{
-			CL_String8 length;
-			length.append("Content-Length: ");
-			length.append(CL_StringHelp::int_to_local8(data.get_size()));
-			length.append("\r\n");
-			impl->connection.write(length.data(), length.length(), true);
+			CL_StringFormatBuffer length;
+			cl_format_to(length, cl_http_content_length_line, data.get_size());
+			impl->connection.write(length.c_str(), length.length(), true);
 		}
 		impl->connection.write("\r\n", 2, true);
 	}
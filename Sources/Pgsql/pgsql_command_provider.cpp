@@ -33,6 +33,7 @@
 #include "pgsql_reader_provider.h"
 #include "API/Core/System/databuffer.h"
 #include "API/Core/Text/string_help.h"
+#include "API/Core/Math/cl_math.h"
 #include "API/Database/db_command_provider.h"
 
 #include <libpq-fe.h>
@@ -45,7 +46,7 @@ CL_PgsqlCommandProvider::CL_PgsqlCommandProvider(CL_PgsqlConnectionProvider *con
 : connection(connection), last_insert_rowid(-1)
 {
 	text = compute_command(user_text, arguments_count);
-	arguments.resize(arguments_count);
+	current.arguments.resize(arguments_count);
 }
 
 CL_PgsqlCommandProvider::~CL_PgsqlCommandProvider()
@@ -65,6 +66,11 @@ int CL_PgsqlCommandProvider::get_output_last_insert_rowid() const
 	return last_insert_rowid;
 }
 
+int CL_PgsqlCommandProvider::get_batch_size() const
+{
+	return batch.size();
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_PgsqlCommandProvider Operations:
 
@@ -98,15 +104,20 @@ void CL_PgsqlCommandProvider::set_input_parameter_binary(int index, const CL_Dat
 	put(index, value);
 }
 
+void CL_PgsqlCommandProvider::add_batch()
+{
+	batch.push_back(current);
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_PgsqlCommandProvider Implementation:
 inline
 void CL_PgsqlCommandProvider::put(int index, const CL_String &value)
 {
-	if (index > arguments_count)
+	if (index < 1 || index > arguments_count)
 		throw CL_Exception("Index out of range");
-	arguments[index - 1] = value;
-	bin_arguments.erase(index);
+	current.arguments[index - 1] = value;
+	current.bin_arguments.erase(index - 1);
 }
 
 inline
@@ -115,8 +126,8 @@ void CL_PgsqlCommandProvider::put(int index, const CL_DataBuffer &value)
 	if (index < 1 || index > arguments_count)
 		throw CL_Exception("Index out of range");
 	last_insert_rowid = index;
-	arguments[index - 1] = "";
-	bin_arguments[index - 1] = value;
+	current.arguments[index - 1] = "";
+	current.bin_arguments[index - 1] = value;
 }
 
 CL_String CL_PgsqlCommandProvider::compute_command(const CL_String &text, int &arguments_count) const
@@ -127,8 +138,9 @@ CL_String CL_PgsqlCommandProvider::compute_command(const CL_String &text, int &a
 	{
 		if (c == '?')
 		{
-			out.push_back('$');
 			++arguments;
+			out.push_back('$');
+			out.append(CL_StringHelp::int_to_text(arguments));
 		}
 		else
 			out.push_back(c);
@@ -137,47 +149,173 @@ CL_String CL_PgsqlCommandProvider::compute_command(const CL_String &text, int &a
 	return out;
 }
 
-PGresult *CL_PgsqlCommandProvider::exec_command()
+bool CL_PgsqlCommandProvider::find_values_row(CL_String &prefix, CL_String &row) const
 {
-	CL_UniquePtr<const char*[]> values(new const char*[arguments_count + 1]);
-	CL_UniquePtr<Oid[]>  types(new Oid[arguments_count + 1]);
-	CL_UniquePtr<int[]>  formats(new int[arguments_count + 1]);
-	CL_UniquePtr<int[]>  lengths(new int[arguments_count + 1]);
+	CL_String upper = CL_StringHelp::text_to_upper(text);
+	CL_String::size_type start = upper.find_first_not_of(" \t\r\n");
+	if (start == CL_String::npos || upper.compare(start, 6, "INSERT") != 0)
+		return false;
 
-	for (int i = 0; i < arguments_count; i++)
+	CL_String::size_type values = upper.rfind("VALUES");
+	if (values == CL_String::npos)
+		return false;
+	CL_String::size_type row_start = upper.find_first_not_of(" \t\r\n", values + 6);
+	if (row_start == CL_String::npos || text[row_start] != '(')
+		return false;
+
+	// Find the end of the row, skipping nested parentheses and string literals:
+	int depth = 0;
+	bool in_string = false;
+	CL_String::size_type row_end;
+	for (row_end = row_start; row_end < text.length(); row_end++)
 	{
-		if (!arguments[i].empty())
+		char c = text[row_end];
+		if (in_string)
 		{
-			values[i] = arguments[i].c_str(); //The value as string
-			types[i] = NULLOID; //Default type
-			formats[i] = 0; //It's a text string
-			lengths[i] = 0; //Let libpq calculate the string length
+			if (c == '\'')
+				in_string = false;
 		}
-		else
+		else if (c == '\'')
 		{
-			if (bin_arguments.find(i) != bin_arguments.end())
-			{
-				values[i] = bin_arguments[i].get_data();
-				types[i] = BYTEAOID; //Default type
-				formats[i] = 1; //It's a binary string
-				lengths[i] = bin_arguments[i].get_size();
-			}
-			else
+			in_string = true;
+		}
+		else if (c == '(')
+		{
+			depth++;
+		}
+		else if (c == ')')
+		{
+			depth--;
+			if (depth == 0)
+				break;
+		}
+	}
+	if (row_end == text.length())
+		return false;
+
+	// Clauses after the row, such as RETURNING, apply to the whole statement:
+	CL_String::size_type tail = text.find_first_not_of(" \t\r\n;", row_end + 1);
+	if (tail != CL_String::npos)
+		return false;
+
+	prefix = text.substr(0, row_start);
+	row = text.substr(row_start, row_end + 1 - row_start);
+	return true;
+}
+
+CL_String CL_PgsqlCommandProvider::offset_arguments(const CL_String &row, int offset)
+{
+	CL_String out;
+	CL_String::size_type pos = 0;
+	while (pos < row.length())
+	{
+		char c = row[pos++];
+		out.push_back(c);
+		if (c == '$')
+		{
+			CL_String::size_type end = row.find_first_not_of("0123456789", pos);
+			if (end == CL_String::npos)
+				end = row.length();
+			if (end > pos)
 			{
-				values[i] = 0;
-				types[i] = NULLOID;
-				formats[i] = 0;
-				lengths[i] = 0; //Let libpq calculate the string length
+				out.append(CL_StringHelp::int_to_text(CL_StringHelp::text_to_int(row.substr(pos, end - pos)) + offset));
+				pos = end;
 			}
 		}
 	}
+	return out;
+}
 
-	return PQexecParams(connection->db,
-			text.c_str(),
-			arguments_count,
-			types.get(),
-			values.get(),
-			lengths.get(),
-			formats.get(),
-			0); //Text output format
+void CL_PgsqlCommandProvider::append_parameters(const ArgumentRow &row, Parameters &parameters) const
+{
+	for (int i = 0; i < arguments_count; i++)
+	{
+		std::map<int, CL_DataBuffer>::const_iterator bin_it = row.bin_arguments.find(i);
+		if (!row.arguments[i].empty())
+		{
+			parameters.values.push_back(row.arguments[i].c_str()); //The value as string
+			parameters.types.push_back(NULLOID); //Default type
+			parameters.formats.push_back(0); //It's a text string
+			parameters.lengths.push_back(0); //Let libpq calculate the string length
+		}
+		else if (bin_it != row.bin_arguments.end())
+		{
+			parameters.values.push_back(bin_it->second.get_data());
+			parameters.types.push_back(BYTEAOID); //Default type
+			parameters.formats.push_back(1); //It's a binary string
+			parameters.lengths.push_back(bin_it->second.get_size());
+		}
+		else
+		{
+			parameters.values.push_back(0);
+			parameters.types.push_back(NULLOID);
+			parameters.formats.push_back(0);
+			parameters.lengths.push_back(0); //Let libpq calculate the string length
+		}
+	}
+}
+
+PGresult *CL_PgsqlCommandProvider::exec_command()
+{
+	Parameters parameters;
+	append_parameters(current, parameters);
+	return connection->exec_prepared(text, parameters.values.size(),
+		parameters.types.empty() ? 0 : &parameters.types[0],
+		parameters.values.empty() ? 0 : &parameters.values[0],
+		parameters.lengths.empty() ? 0 : &parameters.lengths[0],
+		parameters.formats.empty() ? 0 : &parameters.formats[0]);
+}
+
+void CL_PgsqlCommandProvider::execute_checked(const CL_String &statement, Parameters &parameters)
+{
+	auto deleter = [](PGresult *ptr) {if (ptr) {PQclear(ptr);} };
+	CL_UniquePtr<PGresult, decltype(deleter)> result(connection->exec_prepared(statement, parameters.values.size(),
+		parameters.types.empty() ? 0 : &parameters.types[0],
+		parameters.values.empty() ? 0 : &parameters.values[0],
+		parameters.lengths.empty() ? 0 : &parameters.lengths[0],
+		parameters.formats.empty() ? 0 : &parameters.formats[0]), deleter);
+
+	ExecStatusType status = PQresultStatus(result.get());
+	if (status != PGRES_COMMAND_OK && status != PGRES_TUPLES_OK)
+		throw CL_Exception(PQresultErrorMessage(result.get()));
+}
+
+void CL_PgsqlCommandProvider::execute_batch_rows()
+{
+	std::vector<ArgumentRow> rows;
+	rows.swap(batch);
+
+	// Inserts send many rows per statement, to save a round trip to the server per row:
+	int rows_per_statement = 1;
+	CL_String prefix, row;
+	if (arguments_count > 0 && find_values_row(prefix, row))
+		rows_per_statement = cl_min((int) max_batch_rows, (int) max_parameters / arguments_count);
+
+	int num_rows = rows.size();
+	int next_row = 0;
+	if (rows_per_statement > 1 && num_rows >= rows_per_statement)
+	{
+		CL_String statement = prefix;
+		for (int i = 0; i < rows_per_statement; i++)
+		{
+			if (i > 0)
+				statement += ",";
+			statement += offset_arguments(row, i * arguments_count);
+		}
+
+		for (; next_row + rows_per_statement <= num_rows; next_row += rows_per_statement)
+		{
+			Parameters parameters;
+			for (int i = 0; i < rows_per_statement; i++)
+				append_parameters(rows[next_row + i], parameters);
+			execute_checked(statement, parameters);
+		}
+	}
+
+	for (; next_row < num_rows; next_row++)
+	{
+		Parameters parameters;
+		append_parameters(rows[next_row], parameters);
+		execute_checked(text, parameters);
+	}
 }
@@ -57,6 +57,7 @@ public:
 public:
 	int get_input_parameter_column(const CL_StringRef &name) const;
 	int get_output_last_insert_rowid() const;
+	int get_batch_size() const;
 /// \}
 
 /// \name Operations
@@ -68,26 +69,70 @@ public:
 	void set_input_parameter_double(int index, double value);
 	void set_input_parameter_datetime(int index, const CL_DateTime &value);
 	void set_input_parameter_binary(int index, const CL_DataBuffer &value);
+	void add_batch();
 /// \}
 
 /// \name Implementation
 /// \{
 private:
+	enum
+	{
+		/// \brief Most rows sent in one multi-row insert
+		max_batch_rows = 100,
+
+		/// \brief Most parameters accepted by the server for one statement
+		max_parameters = 65535
+	};
+
+	/// \brief Input parameter values of one execution of the command
+	struct ArgumentRow
+	{
+		std::vector<CL_String> arguments;
+		std::map<int, CL_DataBuffer> bin_arguments;
+	};
+
+	/// \brief Parameters in the form passed to libpq, for one or more argument rows
+	struct Parameters
+	{
+		std::vector<const char *> values;
+		std::vector<Oid> types;
+		std::vector<int> lengths;
+		std::vector<int> formats;
+	};
+
 	/// \brief Replace each '?' by a '$i' where i is the occurence of '?'.
 	CL_String compute_command(const CL_String &text, int &arguments_count) const;
 
+	/// \brief Splits an "INSERT ... VALUES (...)" command into the text before the row and the row itself.
+	bool find_values_row(CL_String &prefix, CL_String &row) const;
+
+	/// \brief Returns the row with each '$i' replaced by '$(i + offset)'.
+	static CL_String offset_arguments(const CL_String &row, int offset);
+
 	inline void put(int index, const CL_DataBuffer &value);
 	inline void put(int index, const CL_String &value);
 
+	void append_parameters(const ArgumentRow &row, Parameters &parameters) const;
+
+	/// \brief Executes the command for each row of the batch and clears the batch
+	void execute_batch_rows();
+
+	/// \brief Executes a statement with parameters and throws if it fails
+	void execute_checked(const CL_String &statement, Parameters &parameters);
+
 	CL_PgsqlConnectionProvider *connection;
 	CL_String text;
 	int last_insert_rowid;
 	int arguments_count;
-	std::vector<CL_String> arguments;
-	std::map<int, CL_DataBuffer> bin_arguments;
+	ArgumentRow current;
+
+	/// \brief Rows added with add_batch()
+	std::vector<ArgumentRow> batch;
 
 	PGresult *exec_command();
 
+	friend class CL_PgsqlConnectionProvider;
+
 	friend class CL_PgsqlReaderProvider;
 /// \}
 };
@@ -53,5 +53,15 @@ CL_PgsqlConnection::~CL_PgsqlConnection()
 /////////////////////////////////////////////////////////////////////////////
 // CL_DBConnection Operations:
 
+void CL_PgsqlConnection::set_statement_cache_size(int size)
+{
+	static_cast<CL_PgsqlConnectionProvider *>(get_provider())->set_statement_cache_size(size);
+}
+
+void CL_PgsqlConnection::set_binary_results(bool enable)
+{
+	static_cast<CL_PgsqlConnectionProvider *>(get_provider())->set_binary_results(enable);
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_DBConnection Implementation:
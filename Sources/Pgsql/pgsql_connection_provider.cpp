@@ -38,12 +38,13 @@
 #include "API/Core/Text/string_format.h"
 
 #include <memory>
+#include <cstring>
 
 /////////////////////////////////////////////////////////////////////////////
 // CL_PgsqlConnectionProvider Construction:
 
 CL_PgsqlConnectionProvider::CL_PgsqlConnectionProvider(const Parameters &parameters)
-: db(nullptr), active_transaction(nullptr)
+: db(nullptr), active_transaction(nullptr), statement_cache_size(default_statement_cache_size), next_statement_id(0), binary_results(false)
 {
 	const int length = parameters.size() + 1;
 	CL_UniquePtr<const char*[]> keywords(new const char*[length]);
@@ -68,7 +69,7 @@ CL_PgsqlConnectionProvider::CL_PgsqlConnectionProvider(const Parameters &paramet
 }
 
 CL_PgsqlConnectionProvider::CL_PgsqlConnectionProvider(const CL_String &connection_string)
-: db(nullptr), active_transaction(nullptr)
+: db(nullptr), active_transaction(nullptr), statement_cache_size(default_statement_cache_size), next_statement_id(0), binary_results(false)
 {
 	db = PQconnectdb(connection_string.c_str());
 	if (PQstatus(db) == CONNECTION_BAD)
@@ -92,6 +93,22 @@ CL_PgsqlConnectionProvider::~CL_PgsqlConnectionProvider()
 /////////////////////////////////////////////////////////////////////////////
 // CL_PgsqlConnectionProvider Operations:
 
+void CL_PgsqlConnectionProvider::set_statement_cache_size(int size)
+{
+	statement_cache_size = size;
+	trim_statement_cache(statement_cache_size);
+}
+
+void CL_PgsqlConnectionProvider::set_binary_results(bool enable)
+{
+	if (binary_results != enable)
+	{
+		// The result format of cached statements was decided when they were prepared
+		binary_results = enable;
+		trim_statement_cache(0);
+	}
+}
+
 CL_DBCommandProvider *CL_PgsqlConnectionProvider::create_command(const CL_StringRef &text, CL_DBCommand::Type type)
 {
 	if (type != CL_DBCommand::sql_statement)
@@ -133,6 +150,36 @@ void CL_PgsqlConnectionProvider::execute_non_query(CL_DBCommandProvider *command
 	CL_UniquePtr<CL_DBReaderProvider> reader(execute_reader(command));
 }
 
+void CL_PgsqlConnectionProvider::execute_batch(CL_DBCommandProvider *command)
+{
+	CL_PgsqlCommandProvider *pgsql_command = dynamic_cast<CL_PgsqlCommandProvider*>(command);
+	if (pgsql_command->batch.empty())
+		return;
+
+	// A savepoint makes the rows a single unit inside an active transaction:
+	bool own_transaction = (active_transaction == nullptr);
+	execute_sql(own_transaction ? "BEGIN;" : "SAVEPOINT cl_batch;");
+	try
+	{
+		pgsql_command->execute_batch_rows();
+	}
+	catch (const CL_Exception &)
+	{
+		try
+		{
+			if (own_transaction)
+				execute_sql("ROLLBACK;");
+			else
+				execute_sql("ROLLBACK TO SAVEPOINT cl_batch; RELEASE SAVEPOINT cl_batch;");
+		}
+		catch (const CL_Exception &)
+		{
+		}
+		throw;
+	}
+	execute_sql(own_transaction ? "COMMIT;" : "RELEASE SAVEPOINT cl_batch;");
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_PgsqlConnectionProvider Implementation:
 
@@ -145,3 +192,85 @@ CL_DateTime CL_PgsqlConnectionProvider::from_sql_datetime(const CL_String &value
 {
 	return CL_DateTime::from_short_date_string(value);
 }
+
+PGresult *CL_PgsqlConnectionProvider::exec_prepared(const CL_String &text, int num_params, const Oid *types, const char *const *values, const int *lengths, const int *formats)
+{
+	if (statement_cache_size <= 0)
+		return PQexecParams(db, text.c_str(), num_params, types, values, lengths, formats, 0);
+
+	// The server infers the parameter types when preparing, so they are part of the key:
+	CL_String key = text;
+	for (int i = 0; i < num_params; i++)
+	{
+		key += ":";
+		key += CL_StringHelp::uint_to_text(types[i]);
+	}
+
+	std::map<CL_String, StatementCache::iterator>::iterator it = statement_cache_index.find(key);
+	if (it != statement_cache_index.end())
+	{
+		statement_cache.splice(statement_cache.begin(), statement_cache, it->second);
+	}
+	else
+	{
+		CachedStatement cached;
+		cached.key = key;
+		cached.name = "cl_statement_" + CL_StringHelp::int_to_text(next_statement_id++);
+		cached.binary_results = false;
+
+		PGresult *result = PQprepare(db, cached.name.c_str(), text.c_str(), num_params, types);
+		if (PQresultStatus(result) != PGRES_COMMAND_OK)
+			return result;
+		PQclear(result);
+
+		// Describing the statement costs a round trip, but only once per cached statement:
+		if (binary_results)
+			cached.binary_results = has_binary_result_types(cached.name);
+
+		statement_cache.push_front(cached);
+		statement_cache_index[key] = statement_cache.begin();
+		trim_statement_cache(statement_cache_size);
+	}
+
+	const CachedStatement &statement = statement_cache.front();
+	return PQexecPrepared(db, statement.name.c_str(), num_params, values, lengths, formats, statement.binary_results ? 1 : 0);
+}
+
+bool CL_PgsqlConnectionProvider::has_binary_result_types(const CL_String &name)
+{
+	auto deleter = [](PGresult *ptr) {if (ptr) {PQclear(ptr);} };
+	CL_UniquePtr<PGresult, decltype(deleter)> description(PQdescribePrepared(db, name.c_str()), deleter);
+	if (PQresultStatus(description.get()) != PGRES_COMMAND_OK)
+		return false;
+
+	const char *integer_datetimes = PQparameterStatus(db, "integer_datetimes");
+	bool integer_timestamps = (integer_datetimes != nullptr && strcmp(integer_datetimes, "on") == 0);
+
+	int count = PQnfields(description.get());
+	for (int i = 0; i < count; i++)
+	{
+		if (!CL_PgsqlReaderProvider::is_binary_type(PQftype(description.get(), i), integer_timestamps))
+			return false;
+	}
+	return true;
+}
+
+void CL_PgsqlConnectionProvider::trim_statement_cache(int size)
+{
+	while ((int) statement_cache.size() > size)
+	{
+		// Failing is harmless, as names are never reused:
+		CL_String deallocate = "DEALLOCATE " + statement_cache.back().name + ";";
+		PQclear(PQexec(db, deallocate.c_str()));
+		statement_cache_index.erase(statement_cache.back().key);
+		statement_cache.pop_back();
+	}
+}
+
+void CL_PgsqlConnectionProvider::execute_sql(const char *text)
+{
+	auto deleter = [](PGresult *ptr) {if (ptr) {PQclear(ptr);} };
+	CL_UniquePtr<PGresult, decltype(deleter)> result(PQexec(db, text), deleter);
+	if (PQresultStatus(result.get()) != PGRES_COMMAND_OK)
+		throw CL_Exception(PQresultErrorMessage(result.get()));
+}
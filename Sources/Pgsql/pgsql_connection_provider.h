@@ -33,6 +33,8 @@
 #pragma once
 
 
+#include <list>
+#include <map>
 #include <libpq-fe.h>
 #include "API/Pgsql/pgsql_connection.h"
 #include "API/Database/db_connection_provider.h"
@@ -61,12 +63,19 @@ public:
 /// \name Operations
 /// \{
 public:
+	/// \brief Sets how many prepared statements are kept on the server for reuse
+	void set_statement_cache_size(int size);
+
+	/// \brief Sets if results are received in binary format when all their columns can be decoded from it
+	void set_binary_results(bool enable);
+
 	CL_DBCommandProvider *create_command(const CL_StringRef &text, CL_DBCommand::Type type);
 	CL_DBTransactionProvider *begin_transaction(CL_DBTransaction::Type type);
 	CL_DBReaderProvider *execute_reader(CL_DBCommandProvider *command);
 	CL_String execute_scalar_string(CL_DBCommandProvider *command);
 	int execute_scalar_int(CL_DBCommandProvider *command);
 	void execute_non_query(CL_DBCommandProvider *command);
+	void execute_batch(CL_DBCommandProvider *command);
 /// \}
 
 /// \name Implementation
@@ -75,9 +84,43 @@ private:
 	static CL_String to_sql_datetime(const CL_DateTime &value);
 	static CL_DateTime from_sql_datetime(const CL_String &value);
 
+	/// \brief Executes a statement through a prepared statement, preparing it first if it is not cached
+	PGresult *exec_prepared(const CL_String &text, int num_params, const Oid *types, const char *const *values, const int *lengths, const int *formats);
+
+	/// \brief Returns true if every result column of a prepared statement has a type that can be decoded from binary format
+	bool has_binary_result_types(const CL_String &name);
+
+	/// \brief Deallocates the least recently used statements until the cache holds at most size statements
+	void trim_statement_cache(int size);
+
+	/// \brief Executes a statement without parameters and throws if it fails
+	void execute_sql(const char *text);
+
+	enum
+	{
+		default_statement_cache_size = 16
+	};
+
+	struct CachedStatement
+	{
+		CL_String key;
+		CL_String name;
+
+		/// \brief True if the results of the statement are received in binary format
+		bool binary_results;
+	};
+	typedef std::list<CachedStatement> StatementCache;
+
 	PGconn *db;
 	CL_PgsqlTransactionProvider *active_transaction;
 
+	/// \brief Statements prepared on the server, most recently used first
+	StatementCache statement_cache;
+	std::map<CL_String, StatementCache::iterator> statement_cache_index;
+	int statement_cache_size;
+	int next_statement_id;
+	bool binary_results;
+
 	friend class CL_PgsqlReaderProvider;
 	friend class CL_PgsqlTransactionProvider;
 	friend class CL_PgsqlCommandProvider;
@@ -30,12 +30,17 @@
 #include "pgsql_reader_provider.h"
 #include "pgsql_connection_provider.h"
 #include "pgsql_command_provider.h"
+#include "pg_type.h"
 #include "API/Core/System/databuffer.h"
 #include "API/Core/System/datetime.h"
 #include "API/Core/Text/string_help.h"
 #include "API/Core/Text/string_format.h"
+#include "API/Core/Math/cl_math.h"
 #include <libpq-fe.h>
 #include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <cfloat>
 
 /////////////////////////////////////////////////////////////////////////////
 // CL_PgsqlReaderProvider Construction:
@@ -69,6 +74,18 @@ CL_PgsqlReaderProvider::CL_PgsqlReaderProvider(CL_PgsqlConnectionProvider *conne
 		throw CL_Exception(CL_StringHelp::text_to_local8(PQresultErrorMessage(result)));
 	}
 	nb_rows = PQntuples(result);
+
+	int count = PQnfields(result);
+	columns.resize(count);
+	for (int i = 0; i < count; i++)
+	{
+		columns[i].type = PQftype(result, i);
+		columns[i].binary = (PQfformat(result, i) == 1);
+
+		// Like PQfnumber, a duplicated name refers to the first column:
+		name_indexes.insert(std::pair<CL_String, int>(PQfname(result, i), i));
+	}
+
 	result_uniqueptr.release();
 }
 
@@ -82,19 +99,37 @@ CL_PgsqlReaderProvider::~CL_PgsqlReaderProvider()
 
 int CL_PgsqlReaderProvider::get_column_count() const
 {
-	return  PQnfields(result);
+	return columns.size();
 }
 
 CL_String CL_PgsqlReaderProvider::get_column_name(int index) const
 {
 	const char *const string = PQfname(result, index);
 	if (string == nullptr)
-		throw ("Index out of range");
+		throw CL_Exception("Index out of range");
 	return CL_String(string);
 }
 
 int CL_PgsqlReaderProvider::get_name_index(const CL_StringRef &name) const
 {
+	// PQfnumber folds unquoted names to lower case, so only plain lower case names can be looked up directly:
+	bool plain_name = true;
+	for (CL_StringRef::size_type i = 0; i < name.length(); i++)
+	{
+		if ((name[i] >= 'A' && name[i] <= 'Z') || name[i] == '"')
+		{
+			plain_name = false;
+			break;
+		}
+	}
+
+	if (plain_name)
+	{
+		std::map<CL_String, int>::const_iterator it = name_indexes.find(name);
+		if (it != name_indexes.end())
+			return it->second;
+	}
+
 	int index = PQfnumber(result, name.c_str());
 	if (index < 0)
 		throw CL_Exception(cl_format("No such column name %1", name));
@@ -103,66 +138,57 @@ int CL_PgsqlReaderProvider::get_name_index(const CL_StringRef &name) const
 
 CL_String CL_PgsqlReaderProvider::get_column_string(int index) const
 {
-	const char *const str = PQgetvalue(result, current_row, index);
-	if (str != nullptr)
-		return str;
-	else
-		throw ("Index out of range");
+	return decode_string(current_row, index);
 }
 
 bool CL_PgsqlReaderProvider::get_column_bool(int index) const
 {
-	const CL_String value = get_column_string(index);
-	return CL_StringHelp::text_to_bool(value);
+	return decode_bool(current_row, index);
 }
 
 char CL_PgsqlReaderProvider::get_column_char(int index) const
 {
-	const CL_String value = get_column_string(index);
-	return static_cast<int>(CL_StringHelp::text_to_int(value));
+	return static_cast<char>(decode_int(current_row, index));
 }
 
 unsigned char CL_PgsqlReaderProvider::get_column_uchar(int index) const
 {
-	const CL_String value = get_column_string(index);
-	return static_cast<unsigned char>(CL_StringHelp::text_to_uint(value));
+	return static_cast<unsigned char>(decode_int(current_row, index));
 }
 
 int CL_PgsqlReaderProvider::get_column_int(int index) const
 {
-	const CL_String value = get_column_string(index);
-	return CL_StringHelp::text_to_int(value);
+	return static_cast<int>(decode_int(current_row, index));
 }
 
 unsigned int CL_PgsqlReaderProvider::get_column_uint(int index) const
 {
-	const CL_String value = get_column_string(index);
-	return CL_StringHelp::text_to_uint(value);
+	return static_cast<unsigned int>(decode_int(current_row, index));
 }
 
 double CL_PgsqlReaderProvider::get_column_double(int index) const
 {
-	const CL_String value = get_column_string(index);
-	return CL_StringHelp::text_to_double(value);
+	return decode_double(current_row, index);
 }
 
 CL_DateTime CL_PgsqlReaderProvider::get_column_datetime(int index) const
 {
-	return CL_PgsqlConnectionProvider::from_sql_datetime(get_column_string(index));
+	return decode_datetime(current_row, index);
 }
 
 CL_DataBuffer CL_PgsqlReaderProvider::get_column_binary(int index) const
 {
-	const unsigned char *const str = reinterpret_cast<unsigned char*>(PQgetvalue(result, current_row, index));
-	if (str == nullptr)
-		throw ("Index out of range");
+	const char *value = get_value(current_row, index);
+	if (get_column(index).binary)
+		return CL_DataBuffer(value, PQgetlength(result, current_row, index));
+
 	size_t length;
 	auto deleter = [](void *ptr) {if (ptr) {free(ptr);} };
-	CL_UniquePtr<unsigned char, decltype(deleter)> value(PQunescapeBytea(
-				str,
+	CL_UniquePtr<unsigned char, decltype(deleter)> unescaped(PQunescapeBytea(
+				reinterpret_cast<const unsigned char*>(value),
 				&length),
 				deleter);
-	CL_DataBuffer output(value.get(), length);
+	CL_DataBuffer output(unescaped.get(), length);
 	return output;
 }
 
@@ -177,6 +203,54 @@ bool CL_PgsqlReaderProvider::retrieve_row()
 	return true;
 }
 
+int CL_PgsqlReaderProvider::retrieve_rows(int max_rows, const std::vector<CL_DBColumnArray> &column_arrays)
+{
+	int first_row = current_row + 1;
+	int count = cl_min(max_rows, nb_rows - first_row);
+	if (count <= 0)
+		return 0;
+
+	// The whole result is already on the client, so each column is decoded in one pass:
+	for (size_t i = 0; i < column_arrays.size(); i++)
+	{
+		const CL_DBColumnArray &array = column_arrays[i];
+		switch (array.type)
+		{
+		case CL_DBColumnArray::type_int:
+			{
+				int *values = static_cast<int*>(array.values);
+				for (int row = 0; row < count; row++)
+					values[row] = static_cast<int>(decode_int(first_row + row, array.index));
+			}
+			break;
+		case CL_DBColumnArray::type_double:
+			{
+				double *values = static_cast<double*>(array.values);
+				for (int row = 0; row < count; row++)
+					values[row] = decode_double(first_row + row, array.index);
+			}
+			break;
+		case CL_DBColumnArray::type_string:
+			{
+				CL_String *values = static_cast<CL_String*>(array.values);
+				for (int row = 0; row < count; row++)
+					values[row] = decode_string(first_row + row, array.index);
+			}
+			break;
+		case CL_DBColumnArray::type_datetime:
+			{
+				CL_DateTime *values = static_cast<CL_DateTime*>(array.values);
+				for (int row = 0; row < count; row++)
+					values[row] = decode_datetime(first_row + row, array.index);
+			}
+			break;
+		}
+	}
+
+	current_row = first_row + count - 1;
+	return count;
+}
+
 void CL_PgsqlReaderProvider::close()
 {
 	if (!closed)
@@ -187,5 +261,306 @@ void CL_PgsqlReaderProvider::close()
 	}
 }
 
+bool CL_PgsqlReaderProvider::is_binary_type(Oid type, bool integer_datetimes)
+{
+	switch (type)
+	{
+	case BOOLOID:
+	case BYTEAOID:
+	case CHAROID:
+	case NAMEOID:
+	case INT8OID:
+	case INT2OID:
+	case INT4OID:
+	case TEXTOID:
+	case OIDOID:
+	case FLOAT4OID:
+	case FLOAT8OID:
+	case BPCHAROID:
+	case VARCHAROID:
+	case DATEOID:
+		return true;
+	case TIMESTAMPOID:
+		// Servers built without integer datetimes send timestamps as doubles
+		return integer_datetimes;
+	default:
+		return false;
+	}
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_PgsqlReaderProvider Implementation:
+
+const char *CL_PgsqlReaderProvider::get_value(int row, int index) const
+{
+	if (row < 0 || row >= nb_rows || index < 0 || index >= (int) columns.size())
+		throw CL_Exception("Index out of range");
+	return PQgetvalue(result, row, index);
+}
+
+const CL_PgsqlReaderProvider::Column &CL_PgsqlReaderProvider::get_column(int index) const
+{
+	return columns[index];
+}
+
+cl_byte64 CL_PgsqlReaderProvider::decode_int(int row, int index) const
+{
+	const char *value = get_value(row, index);
+	const Column &column = get_column(index);
+	if (!column.binary)
+		return CL_StringHelp::text_to_ll(value);
+	if (PQgetisnull(result, row, index))
+		return 0;
+
+	int length = PQgetlength(result, row, index);
+	switch (column.type)
+	{
+	case BOOLOID:
+	case CHAROID:
+	case INT2OID:
+	case INT4OID:
+	case INT8OID:
+		return read_int(value, length);
+	case OIDOID:
+		return read_int(value, length) & 0xffffffff;
+	case FLOAT4OID:
+	case FLOAT8OID:
+		return static_cast<cl_byte64>(read_double(value, length));
+	case BYTEAOID:
+	case DATEOID:
+	case TIMESTAMPOID:
+		throw CL_Exception(cl_format("Column %1 is not a number", get_column_name(index)));
+	default:
+		return CL_StringHelp::text_to_ll(CL_StringRef(value, length, true));
+	}
+}
+
+double CL_PgsqlReaderProvider::decode_double(int row, int index) const
+{
+	const char *value = get_value(row, index);
+	const Column &column = get_column(index);
+	if (!column.binary)
+		return CL_StringHelp::text_to_double(value);
+	if (PQgetisnull(result, row, index))
+		return 0.0;
+
+	int length = PQgetlength(result, row, index);
+	switch (column.type)
+	{
+	case FLOAT4OID:
+	case FLOAT8OID:
+		return read_double(value, length);
+	case BOOLOID:
+	case CHAROID:
+	case INT2OID:
+	case INT4OID:
+	case INT8OID:
+	case OIDOID:
+		return static_cast<double>(decode_int(row, index));
+	case BYTEAOID:
+	case DATEOID:
+	case TIMESTAMPOID:
+		throw CL_Exception(cl_format("Column %1 is not a number", get_column_name(index)));
+	default:
+		return CL_StringHelp::text_to_double(CL_StringRef(value, length, true));
+	}
+}
+
+bool CL_PgsqlReaderProvider::decode_bool(int row, int index) const
+{
+	const char *value = get_value(row, index);
+	const Column &column = get_column(index);
+	if (column.binary)
+	{
+		switch (column.type)
+		{
+		case BOOLOID:
+		case CHAROID:
+		case INT2OID:
+		case INT4OID:
+		case INT8OID:
+		case OIDOID:
+			return decode_int(row, index) != 0;
+		case FLOAT4OID:
+		case FLOAT8OID:
+			return decode_double(row, index) != 0.0;
+		default:
+			break;
+		}
+	}
+
+	// The server writes booleans as 't' and 'f' in text format
+	return value[0] == 't' || CL_StringHelp::text_to_bool(value);
+}
+
+CL_String CL_PgsqlReaderProvider::decode_string(int row, int index) const
+{
+	const char *value = get_value(row, index);
+	const Column &column = get_column(index);
+	int length = PQgetlength(result, row, index);
+	if (!column.binary || PQgetisnull(result, row, index))
+		return CL_String(value, length);
+
+	// Formats the values the way the server does in text format:
+	switch (column.type)
+	{
+	case BOOLOID:
+		return value[0] ? "t" : "f";
+	case INT2OID:
+	case INT4OID:
+	case INT8OID:
+	case OIDOID:
+		return CL_StringHelp::ll_to_text(decode_int(row, index));
+	case FLOAT4OID:
+		return double_to_sql(read_double(value, length), 9);
+	case FLOAT8OID:
+		return double_to_sql(read_double(value, length), 17);
+	case DATEOID:
+		return decode_datetime(row, index).to_short_date_string();
+	case TIMESTAMPOID:
+		{
+			CL_DateTime datetime = decode_datetime(row, index);
+			CL_String text = datetime.to_short_datetime_string();
+			unsigned int microseconds = datetime.get_nanoseconds() / 1000;
+			if (microseconds != 0)
+			{
+				char fraction[8];
+				sprintf(fraction, ".%06u", microseconds);
+				int end = 7;
+				while (fraction[end - 1] == '0')
+					end--;
+				text.append(fraction, end);
+			}
+			return text;
+		}
+	case BYTEAOID:
+		{
+			static const char hex[] = "0123456789abcdef";
+			CL_String text("\\x");
+			text.reserve(2 + length * 2);
+			for (int i = 0; i < length; i++)
+			{
+				unsigned char c = value[i];
+				text.append(1, hex[c >> 4]);
+				text.append(1, hex[c & 15]);
+			}
+			return text;
+		}
+	default:
+		return CL_String(value, length);
+	}
+}
+
+CL_DateTime CL_PgsqlReaderProvider::decode_datetime(int row, int index) const
+{
+	const char *value = get_value(row, index);
+	const Column &column = get_column(index);
+	if (!column.binary)
+		return CL_PgsqlConnectionProvider::from_sql_datetime(value);
+	if (PQgetisnull(result, row, index))
+		return CL_DateTime();
+
+	const cl_byte64 microseconds_per_day = 86400LL * 1000000LL;
+	int length = PQgetlength(result, row, index);
+	switch (column.type)
+	{
+	case DATEOID:
+		return datetime_from_microseconds(read_int(value, length) * microseconds_per_day);
+	case TIMESTAMPOID:
+		return datetime_from_microseconds(read_int(value, length));
+	case BOOLOID:
+	case BYTEAOID:
+	case CHAROID:
+	case INT2OID:
+	case INT4OID:
+	case INT8OID:
+	case OIDOID:
+	case FLOAT4OID:
+	case FLOAT8OID:
+		throw CL_Exception(cl_format("Column %1 is not a date", get_column_name(index)));
+	default:
+		return CL_PgsqlConnectionProvider::from_sql_datetime(CL_String(value, length));
+	}
+}
+
+cl_byte64 CL_PgsqlReaderProvider::read_int(const char *data, int size)
+{
+	// Binary values are big endian
+	cl_ubyte64 value = 0;
+	for (int i = 0; i < size; i++)
+		value = (value << 8) | static_cast<unsigned char>(data[i]);
+	if (size > 0 && size < 8 && (data[0] & 0x80))
+		value |= ~cl_ubyte64(0) << (size * 8);
+	return static_cast<cl_byte64>(value);
+}
+
+double CL_PgsqlReaderProvider::read_double(const char *data, int size)
+{
+	if (size == 4)
+	{
+		unsigned int bits = static_cast<unsigned int>(read_int(data, 4));
+		float value;
+		memcpy(&value, &bits, 4);
+		return value;
+	}
+	else if (size == 8)
+	{
+		cl_ubyte64 bits = static_cast<cl_ubyte64>(read_int(data, 8));
+		double value;
+		memcpy(&value, &bits, 8);
+		return value;
+	}
+	else
+	{
+		return 0.0;
+	}
+}
+
+CL_DateTime CL_PgsqlReaderProvider::datetime_from_microseconds(cl_byte64 microseconds)
+{
+	// Microseconds since 2000-01-01, split into days and time of day:
+	const cl_byte64 microseconds_per_day = 86400LL * 1000000LL;
+	cl_byte64 days = microseconds / microseconds_per_day;
+	cl_byte64 time = microseconds % microseconds_per_day;
+	if (time < 0)
+	{
+		time += microseconds_per_day;
+		days--;
+	}
+
+	// Gregorian calendar date from the day number, counted in 400 year eras starting at 0000-03-01:
+	cl_byte64 z = days + 730425;
+	cl_byte64 era = (z >= 0 ? z : z - 146096) / 146097;
+	int day_of_era = static_cast<int>(z - era * 146097);
+	int year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+	int day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+	int month_from_march = (5 * day_of_year + 2) / 153;
+	int day = day_of_year - (153 * month_from_march + 2) / 5 + 1;
+	int month = month_from_march < 10 ? month_from_march + 3 : month_from_march - 9;
+	int year = static_cast<int>(year_of_era + era * 400) + (month <= 2 ? 1 : 0);
+
+	int seconds = static_cast<int>(time / 1000000);
+	int nanoseconds = static_cast<int>(time % 1000000) * 1000;
+	return CL_DateTime(year, month, day, seconds / 3600, (seconds / 60) % 60, seconds % 60, nanoseconds);
+}
+
+CL_String CL_PgsqlReaderProvider::double_to_sql(double value, int digits)
+{
+	if (value != value)
+		return "NaN";
+	if (value > DBL_MAX)
+		return "Infinity";
+	if (value < -DBL_MAX)
+		return "-Infinity";
+
+	// The shortest representation that reads back as the same value:
+	char buffer[32];
+	for (int precision = digits - 2; precision <= digits; precision++)
+	{
+		sprintf(buffer, "%.*g", precision, value);
+		double parsed = strtod(buffer, nullptr);
+		if (digits == 9 ? (static_cast<float>(parsed) == static_cast<float>(value)) : (parsed == value))
+			break;
+	}
+	return buffer;
+}
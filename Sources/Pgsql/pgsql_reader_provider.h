@@ -33,6 +33,8 @@
 #pragma once
 
 
+#include <map>
+#include <vector>
 #include <libpq-fe.h>
 #include "API/Database/db_reader_provider.h"
 
@@ -70,7 +72,11 @@ public:
 /// \{
 public:
 	bool retrieve_row();
+	int retrieve_rows(int max_rows, const std::vector<CL_DBColumnArray> &columns);
 	void close();
+
+	/// \brief Returns true if values of the type can be decoded from the binary result format
+	static bool is_binary_type(Oid type, bool integer_datetimes);
 /// \}
 
 /// \name Implementation
@@ -82,6 +88,25 @@ private:
 		TUPLES_RESULT
 	};
 
+	struct Column
+	{
+		Oid type;
+		bool binary;
+	};
+
+	const char *get_value(int row, int index) const;
+	const Column &get_column(int index) const;
+	cl_byte64 decode_int(int row, int index) const;
+	double decode_double(int row, int index) const;
+	bool decode_bool(int row, int index) const;
+	CL_String decode_string(int row, int index) const;
+	CL_DateTime decode_datetime(int row, int index) const;
+
+	static cl_byte64 read_int(const char *data, int size);
+	static double read_double(const char *data, int size);
+	static CL_DateTime datetime_from_microseconds(cl_byte64 microseconds);
+	static CL_String double_to_sql(double value, int digits);
+
 	CL_PgsqlConnectionProvider *connection;
 	CL_PgsqlCommandProvider *command;
 	PGresult *result;
@@ -90,6 +115,12 @@ private:
 	int current_row;
 	int nb_rows;
 
+	/// \brief Type and format of each column, looked up once per result
+	std::vector<Column> columns;
+
+	/// \brief Index of each column name
+	std::map<CL_String, int> name_indexes;
+
 	friend class CL_PgsqlConnectionProvider;
 	friend class CL_PgsqlCommandProvider;
 /// \}
@@ -0,0 +1,159 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+**    (if your name is missing here, please add it)
+*/
+
+#include "Sound/precomp.h"
+#include "soundoutput_offline.h"
+#include "API/Core/System/exception.h"
+#include "API/Core/System/system.h"
+#include "API/Core/IOData/file.h"
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundOutput_Offline construction:
+
+CL_SoundOutput_Offline::CL_SoundOutput_Offline(int mixing_frequency, int mixing_latency, float speed, const CL_String &filename) :
+	CL_SoundOutput_Impl(mixing_frequency, mixing_latency), speed(speed), frag_size(0), data_size(0), start_time(0), num_written(0)
+{
+	name = "Offline";
+
+	// Use the mixing latency as fragment size, rounded to a multiple of 4 for the SSE mixing functions:
+	frag_size = (mixing_frequency * mixing_latency / 1000) & ~3;
+	if (frag_size < 64)
+		frag_size = 64;
+
+	if (!filename.empty())
+	{
+		file = CL_File(filename, CL_File::create_always, CL_File::access_read_write);
+		file.set_little_endian_mode();
+		write_wav_header();
+	}
+
+	if (speed > 0.0f)
+	{
+		start_time = CL_System::get_microseconds();
+		start_mixer_thread();
+	}
+}
+
+CL_SoundOutput_Offline::~CL_SoundOutput_Offline()
+{
+	if (speed > 0.0f)
+		stop_mixer_thread();
+
+	if (!file.is_null())
+	{
+		try
+		{
+			file.seek(0);
+			write_wav_header();
+		}
+		catch (const CL_Exception &)
+		{
+		}
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundOutput_Offline attributes:
+
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundOutput_Offline operations:
+
+void CL_SoundOutput_Offline::render_fragments(int num_fragments)
+{
+	if (speed > 0.0f)
+		throw CL_Exception("Offline sound output renders on its own mixer thread");
+
+	for (int i = 0; i < num_fragments; i++)
+		render_fragment();
+}
+
+void CL_SoundOutput_Offline::silence()
+{
+}
+
+int CL_SoundOutput_Offline::get_fragment_size()
+{
+	return frag_size;
+}
+
+void CL_SoundOutput_Offline::write_fragment(float *data)
+{
+	if (file.is_null())
+		return;
+
+	// 16 bit little endian stereo:
+	int num_values = frag_size * 2;
+	file_buffer.resize(num_values * 2);
+	char *dest = &file_buffer[0];
+	for (int i = 0; i < num_values; i++)
+	{
+		int value = (int) (data[i] * 32767.0f);
+		dest[i * 2] = (char) (value & 0xff);
+		dest[i * 2 + 1] = (char) ((value >> 8) & 0xff);
+	}
+
+	file.write(&file_buffer[0], file_buffer.size());
+	data_size += file_buffer.size();
+}
+
+void CL_SoundOutput_Offline::wait()
+{
+	num_written++;
+
+	cl_ubyte64 due_time = start_time + (cl_ubyte64) (num_written * frag_size * 1000000.0 / (mixing_frequency * (double) speed));
+	cl_ubyte64 current_time = CL_System::get_microseconds();
+	if (current_time < due_time)
+		stop_mixer.wait((int) ((due_time - current_time) / 1000));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundOutput_Offline implementation:
+
+void CL_SoundOutput_Offline::write_wav_header()
+{
+	const int num_channels = 2;
+	const int bytes_per_sample = 2;
+
+	file.write("RIFF", 4);
+	file.write_uint32(36 + data_size);
+	file.write("WAVE", 4);
+
+	file.write("fmt ", 4);
+	file.write_uint32(16);
+	file.write_uint16(1); // PCM
+	file.write_uint16(num_channels);
+	file.write_uint32(mixing_frequency);
+	file.write_uint32(mixing_frequency * num_channels * bytes_per_sample);
+	file.write_uint16(num_channels * bytes_per_sample);
+	file.write_uint16(bytes_per_sample * 8);
+
+	file.write("data", 4);
+	file.write_uint32(data_size);
+}
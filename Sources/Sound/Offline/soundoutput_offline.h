@@ -0,0 +1,101 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+**    (if your name is missing here, please add it)
+*/
+
+#pragma once
+
+#include "../soundoutput_impl.h"
+#include "API/Core/IOData/iodevice.h"
+#include "API/Core/System/cl_platform.h"
+
+class CL_SoundOutput_Offline : public CL_SoundOutput_Impl
+{
+/// \name Construction
+/// \{
+
+public:
+	CL_SoundOutput_Offline(int mixing_frequency, int mixing_latency, float speed, const CL_String &filename);
+
+	~CL_SoundOutput_Offline();
+
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	/// \brief Rendering speed relative to realtime. 0 if fragments are only rendered on request.
+	float speed;
+
+	int frag_size;
+
+	/// \brief WAV file written to. Null if the output is discarded.
+	CL_IODevice file;
+
+	/// \brief Number of sample bytes written to file.
+	cl_ubyte32 data_size;
+
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	/// \brief Mixes and writes fragments on the calling thread.
+	virtual void render_fragments(int num_fragments);
+
+	/// \brief Called when we have no samples to play - and wants to tell the soundcard
+	/// \brief about this possible event.
+	virtual void silence();
+
+	/// \brief Returns the buffer size used by device (returned as num [stereo] samples).
+	virtual int get_fragment_size();
+
+	/// \brief Writes a fragment to the WAV file.
+	virtual void write_fragment(float *data);
+
+	/// \brief Waits until the next fragment is due at the rendering speed.
+	virtual void wait();
+
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	void write_wav_header();
+
+	/// \brief Time the mixer thread started, in microseconds.
+	cl_ubyte64 start_time;
+
+	/// \brief Number of fragments written by the mixer thread.
+	cl_ubyte64 num_written;
+
+	std::vector<char> file_buffer;
+/// \}
+};
@@ -29,6 +29,8 @@
 
 #include "Sound/precomp.h"
 #include "echofilter_provider.h"
+#include "API/Sound/sound_sse.h"
+#include "API/Core/Math/cl_math.h"
 #include <memory.h>
 
 CL_EchoFilterProvider::CL_EchoFilterProvider(int new_buffer_size, float new_shift_factor) : buffer_size(new_buffer_size), shift_factor(new_shift_factor)
@@ -55,24 +57,22 @@ void CL_EchoFilterProvider::destroy()
 
 void CL_EchoFilterProvider::filter(float **sample_data, int num_samples, int channels)
 {
-	int start_pos = pos;
+	float feedback = 1.0f / shift_factor;
 
-	for (int c=0; c<2; c++)
+	// Process blocks up to where the echo buffer wraps around:
+	int offset = 0;
+	while (offset < num_samples)
 	{
-		if (c == channels) break;
+		int block_size = cl_min(num_samples - offset, buffer_size - pos);
 
-		float *data = sample_data[c];
-		float *work_buffer = buffer[c];
-
-		pos = start_pos;
-
-		for (int i=0; i<num_samples; i++)
+		for (int c=0; c<2; c++)
 		{
-			work_buffer[pos] /= shift_factor;
-			work_buffer[pos] += data[i];
-			data[i] = work_buffer[pos];
-			pos++;
-			if (pos == buffer_size) pos = 0;
+			if (c == channels) break;
+			CL_SoundSSE::feedback_delay(sample_data[c] + offset, buffer[c] + pos, block_size, feedback);
 		}
+
+		offset += block_size;
+		pos += block_size;
+		if (pos == buffer_size) pos = 0;
 	}
 }
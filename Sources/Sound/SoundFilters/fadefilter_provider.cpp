@@ -30,6 +30,7 @@
 #include "Sound/precomp.h"
 
 #include "fadefilter_provider.h"
+#include "API/Sound/sound_sse.h"
 
 CL_FadeFilterProvider::CL_FadeFilterProvider(float initial_volume)
 {
@@ -83,21 +84,34 @@ void CL_FadeFilterProvider::fade_to_volume(float volume, int duration)
 
 void CL_FadeFilterProvider::filter(float **sample_data, int num_samples, int channels)
 {
-	for (int i=0; i<num_samples; i++)
+	if (speed == 0.0f)
 	{
 		for (int j=0; j<channels; j++)
-		{
-			sample_data[j][i] = (sample_data[j][i] * cur_volume);
-		}
-
-		// change volume for every second sample (because data is in stereo).
-		cur_volume += speed;
-		if (
-			(speed > 0 && cur_volume > new_volume) ||
-			(speed < 0 && cur_volume < new_volume))
-		{
-			cur_volume = new_volume;
-			speed = 0;
-		}
+			CL_SoundSSE::multiply_float(sample_data[j], num_samples, cur_volume);
+		return;
+	}
+
+	// The volume moves by speed every sample, until the sample where it would pass new_volume:
+	float steps = (new_volume - cur_volume) / speed;
+	int fade_samples = num_samples;
+	if (steps < 0.0f)
+		fade_samples = 1;
+	else if (steps + 1.0f < num_samples)
+		fade_samples = int(steps) + 1;
+
+	for (int j=0; j<channels; j++)
+	{
+		CL_SoundSSE::multiply_float_ramp(sample_data[j], fade_samples, cur_volume, speed);
+		if (fade_samples < num_samples)
+			CL_SoundSSE::multiply_float(sample_data[j] + fade_samples, num_samples - fade_samples, new_volume);
+	}
+
+	cur_volume += speed * fade_samples;
+	if (fade_samples < num_samples ||
+		(speed > 0 && cur_volume > new_volume) ||
+		(speed < 0 && cur_volume < new_volume))
+	{
+		cur_volume = new_volume;
+		speed = 0;
 	}
 }
@@ -30,6 +30,8 @@
 #include "Sound/precomp.h"
 
 #include "inverse_echofilter_provider.h"
+#include "API/Sound/sound_sse.h"
+#include "API/Core/Math/cl_math.h"
 #include <memory>
 
 #ifndef WIN32
@@ -60,34 +62,42 @@ void CL_InverseEchoFilterProvider::destroy()
 
 void CL_InverseEchoFilterProvider::filter(float **sample_data, int num_samples, int channels)
 {
-	int start_pos = pos;
+	int delay = buffer_size / 4;
 
-	for (int c=0; c<2; c++)
+	// A block no longer than the delay never reads taps written by the same block,
+	// so each block can be stored first and then summed from its taps:
+	int max_block_size = cl_max(delay, 1);
+
+	int offset = 0;
+	while (offset < num_samples)
 	{
-		if (c == channels) break;
+		int block_size = cl_min(cl_min(num_samples - offset, buffer_size - pos), max_block_size);
 
-		float *work_buffer = buffer[c];
+		for (int c=0; c<2; c++)
+		{
+			if (c == channels) break;
 
-		pos = start_pos;
+			float *data = sample_data[c] + offset;
+			float *work_buffer = buffer[c];
 
-		int delay = buffer_size / 4;
-		for (int i=0; i<num_samples; i++)
-		{
-			work_buffer[pos] = sample_data[c][i];
+			CL_SoundSSE::copy_float(data, block_size, work_buffer + pos);
+			CL_SoundSSE::multiply_float(data, block_size, 1.0f / 5);
 
-			int res = 0;
-			for (int j=0; j<4; j++)
+			for (int j=1; j<4; j++)
 			{
 				int p = pos+delay*j;
 				if (p >= buffer_size) p -= buffer_size;
 
-				res += work_buffer[p] / (5-j);
+				// The tap may wrap around the end of the buffer:
+				int first_size = cl_min(block_size, buffer_size - p);
+				CL_SoundSSE::mix_one_to_one(work_buffer + p, first_size, data, 1.0f / (5-j));
+				if (first_size < block_size)
+					CL_SoundSSE::mix_one_to_one(work_buffer, block_size - first_size, data + first_size, 1.0f / (5-j));
 			}
-
-			sample_data[c][i] = res;
-
-			pos++;
-			if (pos == buffer_size) pos = 0;
 		}
+
+		offset += block_size;
+		pos += block_size;
+		if (pos == buffer_size) pos = 0;
 	}
 }
@@ -0,0 +1,368 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#include "Sound/precomp.h"
+#include "API/Sound/SoundProviders/soundprovider_buffered_session.h"
+#include "API/Sound/sound_sse.h"
+#include "API/Core/System/exception.h"
+#include "API/Core/Text/logger.h"
+#include "soundprovider_buffered_session_impl.h"
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundProvider_Buffered_Session construction:
+
+CL_SoundProvider_Buffered_Session::CL_SoundProvider_Buffered_Session(CL_SoundProvider_Session *session, int buffer_samples, CL_InterlockedVariable *underrun_counter)
+: impl(new CL_SoundProvider_Buffered_Session_Impl(session, buffer_samples, underrun_counter))
+{
+}
+
+CL_SoundProvider_Buffered_Session::~CL_SoundProvider_Buffered_Session()
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundProvider_Buffered_Session attributes:
+
+int CL_SoundProvider_Buffered_Session::get_num_samples() const
+{
+	return impl->num_samples.get();
+}
+
+int CL_SoundProvider_Buffered_Session::get_frequency() const
+{
+	return impl->frequency;
+}
+
+int CL_SoundProvider_Buffered_Session::get_position() const
+{
+	return impl->position;
+}
+
+int CL_SoundProvider_Buffered_Session::get_num_channels() const
+{
+	return impl->num_channels;
+}
+
+int CL_SoundProvider_Buffered_Session::get_num_underruns() const
+{
+	return impl->num_underruns.get();
+}
+
+int CL_SoundProvider_Buffered_Session::get_num_underrun_samples() const
+{
+	return impl->num_underrun_samples.get();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundProvider_Buffered_Session operations:
+
+bool CL_SoundProvider_Buffered_Session::set_looping(bool loop)
+{
+	impl->request_looping(loop);
+	return true;
+}
+
+bool CL_SoundProvider_Buffered_Session::eof() const
+{
+	return impl->end_reached;
+}
+
+void CL_SoundProvider_Buffered_Session::stop()
+{
+}
+
+bool CL_SoundProvider_Buffered_Session::play()
+{
+	impl->start_decoder();
+	return true;
+}
+
+bool CL_SoundProvider_Buffered_Session::set_position(int pos)
+{
+	impl->request_seek(pos);
+	return true;
+}
+
+bool CL_SoundProvider_Buffered_Session::set_end_position(int pos)
+{
+	impl->request_end_position(pos);
+	return true;
+}
+
+int CL_SoundProvider_Buffered_Session::get_data(float **data_ptr, int data_requested)
+{
+	return impl->read(data_ptr, data_requested);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundProvider_Buffered_Session_Impl construction:
+
+CL_SoundProvider_Buffered_Session_Impl::CL_SoundProvider_Buffered_Session_Impl(CL_SoundProvider_Session *session, int buffer_samples, CL_InterlockedVariable *underrun_counter)
+: frequency(0), num_channels(0), position(0), end_reached(false), decoder_started(false), session(session), underrun_counter(underrun_counter),
+  read_offset(0), seek_pending(true), decoder_generation(0), decoder_looping(false), decoder_end_of_stream(false), session_loops(false)
+{
+	frequency = session->get_frequency();
+	num_channels = session->get_num_channels();
+	position = session->get_position();
+	num_samples.set(session->get_num_samples());
+	end_position.set(-1);
+
+	// One block is always left empty to tell a full ring from an empty one:
+	int num_blocks = (buffer_samples + block_size - 1) / block_size + 1;
+	if (num_blocks < 3)
+		num_blocks = 3;
+	blocks.resize(num_blocks);
+	for (int i = 0; i < num_blocks; i++)
+		blocks[i].samples.resize(block_size * num_channels);
+}
+
+CL_SoundProvider_Buffered_Session_Impl::~CL_SoundProvider_Buffered_Session_Impl()
+{
+	event_stop.set();
+	thread.join();
+	delete session;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundProvider_Buffered_Session_Impl operations:
+
+int CL_SoundProvider_Buffered_Session_Impl::read(float **data_ptr, int data_requested)
+{
+	int wanted_generation = generation.get();
+	int samples_read = 0;
+	bool released = false;
+
+	while (samples_read < data_requested && !end_reached)
+	{
+		int index = read_index.get();
+		if (index == write_index.get())
+			break;
+
+		Block &block = blocks[index];
+		if (block.generation != wanted_generation)
+		{
+			release_block(index);
+			released = true;
+			continue;
+		}
+
+		int count = block.length - read_offset;
+		if (count > data_requested - samples_read)
+			count = data_requested - samples_read;
+
+		for (int channel = 0; channel < num_channels; channel++)
+		{
+			const float *src = &block.samples[0] + channel * block_size + read_offset;
+			memcpy(data_ptr[channel] + samples_read, src, sizeof(float) * count);
+		}
+		read_offset += count;
+		samples_read += count;
+		position = block.start_position + read_offset;
+
+		if (read_offset == block.length)
+		{
+			end_reached = block.end_of_stream;
+			release_block(index);
+			released = true;
+		}
+	}
+
+	if (released)
+		event_wakeup.set();
+
+	if (samples_read == data_requested)
+		seek_pending = false;
+
+	if (samples_read < data_requested && !end_reached)
+	{
+		// Until the decoder has caught up after starting or seeking, only return what there is.
+		// The mixer then asks again next fragment instead of playing a whole buffer of silence.
+		if (seek_pending)
+			return samples_read;
+
+		// The decoder fell behind. Keep playback timing by inserting silence:
+		int missing = data_requested - samples_read;
+		for (int channel = 0; channel < num_channels; channel++)
+			CL_SoundSSE::set_float(data_ptr[channel] + samples_read, missing, 0.0f);
+
+		// Only this thread changes the counters, other threads just read them:
+		num_underruns.increment();
+		num_underrun_samples.set(num_underrun_samples.get() + missing);
+		if (underrun_counter)
+			underrun_counter->increment();
+		samples_read = data_requested;
+	}
+
+	return samples_read;
+}
+
+void CL_SoundProvider_Buffered_Session_Impl::request_seek(int new_position)
+{
+	seek_position.set(new_position);
+	generation.increment();
+	position = new_position;
+	end_reached = false;
+	seek_pending = true;
+	event_wakeup.set();
+}
+
+void CL_SoundProvider_Buffered_Session_Impl::request_looping(bool loop)
+{
+	looping.set(loop ? 1 : 0);
+	event_wakeup.set();
+}
+
+void CL_SoundProvider_Buffered_Session_Impl::request_end_position(int new_end_position)
+{
+	end_position.set(new_end_position);
+	event_wakeup.set();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundProvider_Buffered_Session_Impl implementation:
+
+void CL_SoundProvider_Buffered_Session_Impl::start_decoder()
+{
+	if (decoder_started)
+		return;
+
+	// Until the decoder catches up, reads come back short without counting underruns, as seek_pending is set
+	decoder_started = true;
+	thread.start(this, &CL_SoundProvider_Buffered_Session_Impl::decoder_main);
+}
+
+void CL_SoundProvider_Buffered_Session_Impl::decoder_main()
+{
+	// The wrapped session is only started once the mixer plays this one
+	session->play();
+
+	while (true)
+	{
+		event_wakeup.reset();
+		apply_requests();
+
+		int index = write_index.get();
+		int next_index = (index + 1) % int(blocks.size());
+		if (!decoder_end_of_stream && next_index != read_index.get())
+		{
+			decode_block(blocks[index]);
+			write_index.set(next_index);
+			continue;
+		}
+
+		int wakeup_reason = CL_Event::wait(event_wakeup, event_stop);
+		if (wakeup_reason != 0)
+			break;
+	}
+}
+
+void CL_SoundProvider_Buffered_Session_Impl::apply_requests()
+{
+	bool loop = (looping.get() != 0);
+	if (loop != decoder_looping)
+	{
+		decoder_looping = loop;
+		session_loops = session->set_looping(loop);
+	}
+
+	int new_end_position = end_position.get();
+	if (new_end_position != -1 && end_position.compare_and_swap(new_end_position, -1))
+	{
+		if (!session->set_end_position(new_end_position))
+			cl_log_event("mixer", "Buffered sound session could not set end position %1", new_end_position);
+	}
+
+	int new_generation = generation.get();
+	if (new_generation != decoder_generation)
+	{
+		decoder_generation = new_generation;
+		int new_position = seek_position.get();
+		if (!session->set_position(new_position))
+			cl_log_event("mixer", "Buffered sound session could not seek to %1", new_position);
+		decoder_end_of_stream = false;
+	}
+}
+
+void CL_SoundProvider_Buffered_Session_Impl::decode_block(Block &block)
+{
+	block.generation = decoder_generation;
+	block.start_position = session->get_position();
+	block.length = 0;
+	block.end_of_stream = false;
+
+	std::vector<float *> channels(num_channels);
+	bool rewound = false;
+	try
+	{
+		while (block.length < block_size)
+		{
+			for (int channel = 0; channel < num_channels; channel++)
+				channels[channel] = &block.samples[0] + channel * block_size + block.length;
+
+			int written = session->get_data(&channels[0], block_size - block.length);
+			block.length += written;
+
+			if (block.length < block_size && session->eof())
+			{
+				// Loop here rather than in the mixer, so no samples are missing at the loop point:
+				if (decoder_looping && !session_loops && !(rewound && block.length == 0) && session->set_position(0))
+				{
+					session->play();
+					rewound = true;
+
+					// Blocks hold continuous samples, so positions stay correct:
+					if (block.length > 0)
+						break;
+					continue;
+				}
+
+				block.end_of_stream = true;
+				break;
+			}
+			else if (written == 0)
+			{
+				block.end_of_stream = true;
+				break;
+			}
+		}
+	}
+	catch (const CL_Exception &e)
+	{
+		cl_log_event("mixer", "Buffered sound session stopped decoding: %1", e.message);
+		block.end_of_stream = true;
+	}
+
+	decoder_end_of_stream = block.end_of_stream;
+	num_samples.set(session->get_num_samples());
+}
+
+void CL_SoundProvider_Buffered_Session_Impl::release_block(int index)
+{
+	read_offset = 0;
+	read_index.set((index + 1) % int(blocks.size()));
+}
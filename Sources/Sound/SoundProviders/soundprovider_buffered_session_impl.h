@@ -0,0 +1,146 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#pragma once
+
+#include <vector>
+#include "API/Core/System/thread.h"
+#include "API/Core/System/event.h"
+#include "API/Core/System/interlocked_variable.h"
+
+class CL_SoundProvider_Session;
+
+class CL_SoundProvider_Buffered_Session_Impl
+{
+/// \name Construction
+/// \{
+
+public:
+	CL_SoundProvider_Buffered_Session_Impl(CL_SoundProvider_Session *session, int buffer_samples, CL_InterlockedVariable *underrun_counter);
+	~CL_SoundProvider_Buffered_Session_Impl();
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	enum
+	{
+		/// \brief Samples decoded at a time by the decoder thread
+		block_size = 4096
+	};
+
+	int frequency;
+	int num_channels;
+
+	/// \brief Length of the wrapped session, published by the decoder thread
+	CL_InterlockedVariable num_samples;
+
+	CL_InterlockedVariable num_underruns;
+	CL_InterlockedVariable num_underrun_samples;
+
+	// The following are only accessed by the reading thread:
+	int position;
+	bool end_reached;
+	bool decoder_started;
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	/// \brief Copies decoded samples, padding with silence on underrun
+	int read(float **data_ptr, int data_requested);
+
+	/// \brief Makes the decoder continue from another position
+	void request_seek(int position);
+
+	void request_looping(bool loop);
+	void request_end_position(int position);
+
+	/// \brief Starts the decoder thread, the first time the session is played
+	void start_decoder();
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	struct Block
+	{
+		Block() : length(0), start_position(0), generation(0), end_of_stream(false) { }
+
+		std::vector<float> samples;
+		int length;
+		int start_position;
+		int generation;
+		bool end_of_stream;
+	};
+
+	void decoder_main();
+
+	/// \brief Applies requests from the reading thread to the wrapped session. Decoder thread only.
+	void apply_requests();
+
+	/// \brief Decodes the next block of the wrapped session. Decoder thread only.
+	void decode_block(Block &block);
+
+	/// \brief Returns the block at the read position to the decoder
+	void release_block(int index);
+
+	CL_SoundProvider_Session *session;
+	CL_InterlockedVariable *underrun_counter;
+
+	/// \brief Ring of decoded blocks. The decoder writes at write_index, the reader reads at read_index.
+	std::vector<Block> blocks;
+	CL_InterlockedVariable read_index;
+	CL_InterlockedVariable write_index;
+
+	/// \brief Samples already read from the block at read_index
+	int read_offset;
+
+	/// \brief True after starting or seeking, until a read could be served in full
+	bool seek_pending;
+
+	/// \brief Incremented by every seek. Blocks decoded before the latest seek are skipped.
+	CL_InterlockedVariable generation;
+	CL_InterlockedVariable seek_position;
+	CL_InterlockedVariable looping;
+	CL_InterlockedVariable end_position;
+
+	// Decoder thread state:
+	int decoder_generation;
+	bool decoder_looping;
+	bool decoder_end_of_stream;
+	bool session_loops;
+
+	CL_Thread thread;
+	CL_Event event_wakeup;
+	CL_Event event_stop;
+/// \}
+};
@@ -100,16 +100,18 @@ int CL_SoundProvider_Raw_Session::get_data(float **data_ptr, int data_requested)
 		if (data_requested < 0) return 0;
 	}
 
+	// The pointers below are typed, so step them by the number of channels only
+	int channels = source.impl->stereo ? 2 : 1;
 	if (source.impl->bytes_per_sample == 2)
 	{
 		if (source.impl->stereo)
 		{
-			short *src = (short *) source.impl->sound_data + position * source.impl->bytes_per_sample;
+			short *src = (short *) source.impl->sound_data + position * channels;
 			CL_SoundSSE::unpack_16bit_stereo(src, data_requested, data_ptr);
 		}
 		else
 		{
-			short *src = (short *) source.impl->sound_data + position * source.impl->bytes_per_sample;
+			short *src = (short *) source.impl->sound_data + position * channels;
 			CL_SoundSSE::unpack_16bit_mono(src, data_requested, data_ptr[0]);
 		}
 	}
@@ -117,12 +119,12 @@ int CL_SoundProvider_Raw_Session::get_data(float **data_ptr, int data_requested)
 	{
 		if (source.impl->stereo)
 		{
-			unsigned char *src = (unsigned char *) source.impl->sound_data + position * source.impl->bytes_per_sample;
+			unsigned char *src = (unsigned char *) source.impl->sound_data + position * channels;
 			CL_SoundSSE::unpack_8bit_stereo(src, data_requested, data_ptr);
 		}
 		else
 		{
-			unsigned char *src = (unsigned char *) source.impl->sound_data + position * source.impl->bytes_per_sample;
+			unsigned char *src = (unsigned char *) source.impl->sound_data + position * channels;
 			CL_SoundSSE::unpack_8bit_mono(src, data_requested, data_ptr[0]);
 		}
 	}
@@ -0,0 +1,99 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#include "Sound/precomp.h"
+#include "sound_command_queue.h"
+#include "soundbuffer_session_impl.h"
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundCommandQueue construction:
+
+CL_SoundCommandQueue::CL_SoundCommandQueue(int capacity)
+: commands(capacity), pending_index(0)
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundCommandQueue operations:
+
+void CL_SoundCommandQueue::push(const CL_SoundCommand &command)
+{
+	CL_MutexSection producer_lock(&producer_mutex);
+
+	int capacity = commands.size();
+	int index = write_index.get();
+	int next_index = (index + 1) % capacity;
+
+	// Everything in the overflow list is newer than the ring contents, so once it is in use
+	// new commands must follow it there until the mixer has taken it:
+	if (next_index == read_index.get() || overflow_size.get() != 0)
+	{
+		CL_MutexSection overflow_lock(&overflow_mutex);
+		overflow.push_back(command);
+		overflow_size.set(overflow.size());
+		return;
+	}
+
+	commands[index] = command;
+	write_index.set(next_index);
+}
+
+bool CL_SoundCommandQueue::pop(CL_SoundCommand &command)
+{
+	if (pending_index < int(pending.size()))
+	{
+		command = pending[pending_index];
+		pending[pending_index++] = CL_SoundCommand();
+		return true;
+	}
+
+	int index = read_index.get();
+	if (index != write_index.get())
+	{
+		command = commands[index];
+		commands[index] = CL_SoundCommand();
+		read_index.set((index + 1) % int(commands.size()));
+		return true;
+	}
+
+	if (overflow_size.get() == 0)
+		return false;
+
+	// The ring is empty, so the overflow commands are the oldest ones left:
+	pending.clear();
+	pending_index = 0;
+	{
+		CL_MutexSection overflow_lock(&overflow_mutex);
+		pending.swap(overflow);
+		overflow_size.set(0);
+	}
+
+	command = pending[pending_index];
+	pending[pending_index++] = CL_SoundCommand();
+	return true;
+}
@@ -0,0 +1,138 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#pragma once
+
+#include <vector>
+#include "API/Core/System/sharedptr.h"
+#include "API/Core/System/mutex.h"
+#include "API/Core/System/interlocked_variable.h"
+#include "API/Sound/soundfilter.h"
+
+class CL_SoundBuffer_Session_Impl;
+class CL_SoundBus_Impl;
+
+/// \brief Change to a soundbuffer session or bus, applied by the mixer thread at the start of a fragment
+class CL_SoundCommand
+{
+public:
+	enum Type
+	{
+		type_none,
+		type_play,
+		type_stop,
+		type_set_position,
+		type_set_end_position,
+		type_set_looping,
+		type_set_volume,
+		type_set_pan,
+		type_set_frequency,
+		type_set_resampling,
+		type_set_volume_ramping,
+		type_add_filter,
+		type_remove_filter,
+		type_set_bus,
+		type_add_bus,
+		type_bus_set_volume,
+		type_bus_set_pan,
+		type_bus_add_filter,
+		type_bus_remove_filter
+	};
+
+	CL_SoundCommand() : type(type_none), int_value(0), float_value(0.0f) { }
+
+	CL_SoundCommand(Type type, const CL_SharedPtr<CL_SoundBuffer_Session_Impl> &session, int int_value = 0, float float_value = 0.0f)
+	: type(type), session(session), int_value(int_value), float_value(float_value) { }
+
+	CL_SoundCommand(Type type, const CL_SharedPtr<CL_SoundBus_Impl> &bus, float float_value = 0.0f)
+	: type(type), bus(bus), int_value(0), float_value(float_value) { }
+
+	Type type;
+
+	/// \brief Session changed, or null for commands changing a bus
+	CL_SharedPtr<CL_SoundBuffer_Session_Impl> session;
+
+	/// \brief Bus changed, or the bus a session is routed to by type_set_bus
+	CL_SharedPtr<CL_SoundBus_Impl> bus;
+
+	int int_value;
+	float float_value;
+	CL_SoundFilter filter;
+};
+
+/// \brief Queue of commands from API calls to the mixer thread
+///
+/// The mixer thread is the only consumer. Threads calling push() are serialized among
+/// themselves by a mutex the mixer never touches. When the ring is full, commands go to
+/// an overflow list instead; the mixer only locks that list when it is not empty.
+class CL_SoundCommandQueue
+{
+/// \name Construction
+/// \{
+
+public:
+	CL_SoundCommandQueue(int capacity = 4096);
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	/// \brief Adds a command to the end of the queue
+	///
+	/// Never waits for the mixer. Commands that do not fit in the ring are kept in order in the overflow list.
+	void push(const CL_SoundCommand &command);
+
+	/// \brief Removes the oldest command from the queue. Must only be called by the mixer thread.
+	///
+	/// \return false if the queue was empty
+	bool pop(CL_SoundCommand &command);
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	CL_SoundCommandQueue(const CL_SoundCommandQueue &);
+	CL_SoundCommandQueue &operator =(const CL_SoundCommandQueue &);
+
+	std::vector<CL_SoundCommand> commands;
+	CL_InterlockedVariable read_index;
+	CL_InterlockedVariable write_index;
+	CL_Mutex producer_mutex;
+
+	/// \brief Commands pushed while the ring was full or the overflow list not yet drained
+	std::vector<CL_SoundCommand> overflow;
+	CL_InterlockedVariable overflow_size;
+	CL_Mutex overflow_mutex;
+
+	/// \brief Overflow commands taken by the mixer, delivered before anything in the ring
+	std::vector<CL_SoundCommand> pending;
+	int pending_index;
+/// \}
+};
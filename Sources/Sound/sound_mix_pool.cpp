@@ -0,0 +1,313 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#include "Sound/precomp.h"
+#include "sound_mix_pool.h"
+#include "soundbuffer_session_impl.h"
+#include "soundbus_impl.h"
+#include "API/Sound/soundbuffer_session.h"
+#include "API/Sound/sound_sse.h"
+#include "API/Core/System/system.h"
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundMixPool construction:
+
+CL_SoundMixPool::CL_SoundMixPool()
+: max_threads(0), workers_started(false), worker_buffer_size(0), job_type(job_mix_sessions), job_end(0),
+  job_sessions(0), job_playing(0), job_buses(0), job_size(0), last_num_workers(1), session_cost(0.0f), bus_cost(0.0f)
+{
+	// The mixer thread itself is one of the workers:
+	max_threads = CL_System::get_num_cores() - 1;
+	if (max_threads < 0)
+		max_threads = 0;
+	if (max_threads > 7)
+		max_threads = 7;
+}
+
+CL_SoundMixPool::~CL_SoundMixPool()
+{
+	stop_workers();
+	free_worker_buffers();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundMixPool operations:
+
+void CL_SoundMixPool::mix(std::vector<CL_SoundBuffer_Session> &sessions, int begin, int end, int num_serial, std::vector<char> &playing, float **mix_buffers, float **temp_buffers, int size, int frequency)
+{
+	int num_sessions = end - begin;
+	if (num_sessions <= 0)
+		return;
+
+	int num_workers = choose_num_workers(num_sessions - num_serial, session_cost, min_sessions_per_worker, size, frequency);
+	cl_ubyte64 start_time = CL_System::get_microseconds();
+
+	if (num_workers <= 1)
+	{
+		for (int i = begin; i < end; i++)
+			playing[i] = sessions[i].impl->mix_to(mix_buffers, temp_buffers, size, 2);
+	}
+	else
+	{
+		start_workers();
+		resize_worker_buffers(size);
+
+		job_type = job_mix_sessions;
+		job_sessions = &sessions;
+		job_playing = &playing;
+		job_size = size;
+		job_end = end;
+		next_job.set(begin + num_serial);
+		start_job(num_workers);
+
+		for (int i = begin; i < begin + num_serial; i++)
+			playing[i] = sessions[i].impl->mix_to(mix_buffers, temp_buffers, size, 2);
+		mix_shared_sessions(mix_buffers, temp_buffers, false);
+
+		wait_job(num_workers);
+
+		// Sum the partial mixes of the workers:
+		for (int i = 0; i < num_workers - 1; i++)
+		{
+			if (worker_buffers[i].used)
+			{
+				CL_SoundSSE::mix_one_to_one(worker_buffers[i].mix[0], size, mix_buffers[0], 1.0f);
+				CL_SoundSSE::mix_one_to_one(worker_buffers[i].mix[1], size, mix_buffers[1], 1.0f);
+			}
+		}
+
+		job_sessions = 0;
+		job_playing = 0;
+	}
+
+	update_cost(session_cost, start_time, num_workers, num_sessions);
+	last_num_workers = num_workers;
+}
+
+void CL_SoundMixPool::run_bus_filters(std::vector<CL_SoundBus_Impl *> &buses, bool allow_parallel, int size, int frequency)
+{
+	int num_buses = buses.size();
+	if (num_buses == 0)
+		return;
+
+	int num_workers = 1;
+	if (allow_parallel)
+		num_workers = choose_num_workers(num_buses, bus_cost, 1, size, frequency);
+	cl_ubyte64 start_time = CL_System::get_microseconds();
+
+	if (num_workers <= 1)
+	{
+		for (int i = 0; i < num_buses; i++)
+			buses[i]->run_filters();
+	}
+	else
+	{
+		start_workers();
+
+		job_type = job_bus_filters;
+		job_buses = &buses;
+		job_end = num_buses;
+		next_job.set(0);
+		start_job(num_workers);
+
+		run_shared_bus_filters();
+
+		wait_job(num_workers);
+		job_buses = 0;
+	}
+
+	update_cost(bus_cost, start_time, num_workers, num_buses);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundMixPool implementation:
+
+int CL_SoundMixPool::choose_num_workers(int num_shared_jobs, float job_cost, int min_jobs_per_worker, int size, int frequency) const
+{
+	if (max_threads == 0 || num_shared_jobs < min_jobs_per_worker * 2 || frequency <= 0)
+		return 1;
+
+	// Only go parallel when running on one thread would take a noticeable part of the fragment:
+	float budget = size * 1000000.0f / frequency / fragment_budget_divisor;
+	float estimated = job_cost * num_shared_jobs;
+	if (estimated < budget)
+		return 1;
+
+	int num_workers = 1 + int(estimated / budget);
+	if (num_workers > num_shared_jobs / min_jobs_per_worker)
+		num_workers = num_shared_jobs / min_jobs_per_worker;
+	if (num_workers > max_threads + 1)
+		num_workers = max_threads + 1;
+	return num_workers;
+}
+
+void CL_SoundMixPool::start_job(int num_workers)
+{
+	for (int i = 0; i < num_workers - 1; i++)
+		event_start[i].set();
+}
+
+void CL_SoundMixPool::wait_job(int num_workers)
+{
+	for (int i = 0; i < num_workers - 1; i++)
+	{
+		event_done[i].wait();
+		event_done[i].reset();
+	}
+}
+
+void CL_SoundMixPool::update_cost(float &cost, cl_ubyte64 start_time, int num_workers, int num_jobs)
+{
+	// Track the cost of a job, as if all of them ran on a single thread:
+	float elapsed = float(CL_System::get_microseconds() - start_time);
+	float new_cost = elapsed * num_workers / num_jobs;
+	if (cost == 0.0f)
+		cost = new_cost;
+	else
+		cost += (new_cost - cost) / 8.0f;
+}
+
+void CL_SoundMixPool::start_workers()
+{
+	if (workers_started)
+		return;
+	workers_started = true;
+
+	// Do not change this code to resize(), as that copies the same CL_Event handle into every index.
+	for (int i = 0; i < max_threads; i++)
+	{
+		event_start.push_back(CL_Event());
+		event_done.push_back(CL_Event());
+	}
+	worker_buffers.resize(max_threads);
+
+	for (int i = 0; i < max_threads; i++)
+	{
+		CL_Thread thread;
+		thread.start(this, &CL_SoundMixPool::worker_main, i);
+		threads.push_back(thread);
+	}
+}
+
+void CL_SoundMixPool::stop_workers()
+{
+	event_stop.set();
+	for (std::vector<CL_Thread>::size_type i = 0; i < threads.size(); i++)
+		threads[i].join();
+	threads.clear();
+}
+
+void CL_SoundMixPool::resize_worker_buffers(int size)
+{
+	if (size == worker_buffer_size)
+		return;
+
+	free_worker_buffers();
+	for (std::vector<WorkerBuffers>::size_type i = 0; i < worker_buffers.size(); i++)
+	{
+		for (int channel = 0; channel < 2; channel++)
+		{
+			worker_buffers[i].mix[channel] = (float *) CL_SoundSSE::aligned_alloc(sizeof(float) * size);
+			worker_buffers[i].temp[channel] = (float *) CL_SoundSSE::aligned_alloc(sizeof(float) * size);
+		}
+	}
+	worker_buffer_size = size;
+}
+
+void CL_SoundMixPool::free_worker_buffers()
+{
+	for (std::vector<WorkerBuffers>::size_type i = 0; i < worker_buffers.size(); i++)
+	{
+		for (int channel = 0; channel < 2; channel++)
+		{
+			CL_SoundSSE::aligned_free(worker_buffers[i].mix[channel]); worker_buffers[i].mix[channel] = 0;
+			CL_SoundSSE::aligned_free(worker_buffers[i].temp[channel]); worker_buffers[i].temp[channel] = 0;
+		}
+	}
+	worker_buffer_size = 0;
+}
+
+void CL_SoundMixPool::worker_main(int index)
+{
+	while (true)
+	{
+		int wakeup_reason = CL_Event::wait(event_start[index], event_stop);
+		if (wakeup_reason != 0)
+			break;
+		event_start[index].reset();
+
+		if (job_type == job_mix_sessions)
+		{
+			WorkerBuffers &buffers = worker_buffers[index];
+			buffers.used = mix_shared_sessions(buffers.mix, buffers.temp, true) > 0;
+		}
+		else
+		{
+			run_shared_bus_filters();
+		}
+
+		event_done[index].set();
+	}
+}
+
+int CL_SoundMixPool::mix_shared_sessions(float **mix_buffers, float **temp_buffers, bool clear_mix_buffers)
+{
+	std::vector<CL_SoundBuffer_Session> &sessions = *job_sessions;
+	std::vector<char> &playing = *job_playing;
+
+	int num_mixed = 0;
+	while (true)
+	{
+		int index = next_job.increment() - 1;
+		if (index >= job_end)
+			break;
+
+		if (num_mixed == 0 && clear_mix_buffers)
+		{
+			CL_SoundSSE::set_float(mix_buffers[0], job_size, 0.0f);
+			CL_SoundSSE::set_float(mix_buffers[1], job_size, 0.0f);
+		}
+
+		playing[index] = sessions[index].impl->mix_to(mix_buffers, temp_buffers, job_size, 2);
+		num_mixed++;
+	}
+	return num_mixed;
+}
+
+void CL_SoundMixPool::run_shared_bus_filters()
+{
+	std::vector<CL_SoundBus_Impl *> &buses = *job_buses;
+	while (true)
+	{
+		int index = next_job.increment() - 1;
+		if (index >= job_end)
+			break;
+
+		buses[index]->run_filters();
+	}
+}
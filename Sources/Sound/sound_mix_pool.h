@@ -0,0 +1,174 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#pragma once
+
+#include <vector>
+#include "API/Core/System/thread.h"
+#include "API/Core/System/event.h"
+#include "API/Core/System/interlocked_variable.h"
+#include "API/Core/System/cl_platform.h"
+
+class CL_SoundBuffer_Session;
+class CL_SoundBus_Impl;
+
+/// \brief Worker threads mixing soundbuffer sessions and filtering buses in parallel.
+///
+/// Sessions are claimed one at a time by the calling thread and the workers, each mixing into
+/// its own partial buffers, which are summed into the output buffers afterwards. Small voice
+/// counts and cheap fragments are mixed on the calling thread alone. Buses are claimed the
+/// same way, each filtered in place by a single thread.
+class CL_SoundMixPool
+{
+/// \name Construction
+/// \{
+
+public:
+	CL_SoundMixPool();
+	~CL_SoundMixPool();
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	enum
+	{
+		/// \brief Fewest sessions worth handing to an extra thread
+		min_sessions_per_worker = 8,
+
+		/// \brief Part of the fragment duration the estimated mixing time may take per thread
+		fragment_budget_divisor = 8
+	};
+
+	/// \brief Returns the number of threads used for the last mix, including the calling thread
+	int get_last_num_workers() const { return last_num_workers; }
+
+	/// \brief Returns the estimated mixing time per session, in microseconds
+	float get_session_cost() const { return session_cost; }
+
+	/// \brief Returns the estimated filtering time per bus, in microseconds
+	float get_bus_cost() const { return bus_cost; }
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	/// \brief Mixes the sessions from begin to end into mix_buffers and stores whether each is still playing
+	///
+	/// The first num_serial sessions of the range are always mixed by the calling thread.
+	/// \param sessions = Sessions to mix
+	/// \param begin = Index of the first session to mix
+	/// \param end = Index after the last session to mix
+	/// \param num_serial = Number of sessions at the start of the range that must not be mixed by workers
+	/// \param playing = Receives the mix_to result for each session, at the same index as the session
+	/// \param mix_buffers = Stereo buffers to mix into
+	/// \param temp_buffers = Stereo scratch buffers used by the calling thread
+	/// \param size = Number of samples per buffer
+	/// \param frequency = Mixing frequency, used to find the duration of the fragment
+	void mix(std::vector<CL_SoundBuffer_Session> &sessions, int begin, int end, int num_serial, std::vector<char> &playing, float **mix_buffers, float **temp_buffers, int size, int frequency);
+
+	/// \brief Runs the filters of each bus on its sub-mix
+	///
+	/// \param buses = Buses to filter. None of them may be mixed into another one of the list.
+	/// \param allow_parallel = False if the buses share filter objects, which must then run on the calling thread
+	/// \param size = Number of samples per buffer
+	/// \param frequency = Mixing frequency, used to find the duration of the fragment
+	void run_bus_filters(std::vector<CL_SoundBus_Impl *> &buses, bool allow_parallel, int size, int frequency);
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	CL_SoundMixPool(const CL_SoundMixPool &);
+	CL_SoundMixPool &operator =(const CL_SoundMixPool &);
+
+	/// \brief Returns the number of threads to run the shared jobs on
+	int choose_num_workers(int num_shared_jobs, float job_cost, int min_jobs_per_worker, int size, int frequency) const;
+
+	/// \brief Wakes num_workers - 1 workers for the current job
+	void start_job(int num_workers);
+
+	/// \brief Waits for the workers woken by start_job
+	void wait_job(int num_workers);
+
+	/// \brief Updates an estimate of the time a job takes on a single thread
+	static void update_cost(float &cost, cl_ubyte64 start_time, int num_workers, int num_jobs);
+
+	void start_workers();
+	void stop_workers();
+	void resize_worker_buffers(int size);
+	void free_worker_buffers();
+
+	void worker_main(int index);
+
+	/// \brief Mixes sessions claimed from the shared range into the given buffers and returns how many it mixed
+	int mix_shared_sessions(float **mix_buffers, float **temp_buffers, bool clear_mix_buffers);
+
+	/// \brief Filters buses claimed from the shared range
+	void run_shared_bus_filters();
+
+	enum JobType
+	{
+		job_mix_sessions,
+		job_bus_filters
+	};
+
+	struct WorkerBuffers
+	{
+		WorkerBuffers() : used(false) { mix[0] = mix[1] = 0; temp[0] = temp[1] = 0; }
+		float *mix[2];
+		float *temp[2];
+		bool used;
+	};
+
+	int max_threads;
+	bool workers_started;
+	std::vector<CL_Thread> threads;
+	std::vector<CL_Event> event_start;
+	std::vector<CL_Event> event_done;
+	CL_Event event_stop;
+
+	std::vector<WorkerBuffers> worker_buffers;
+	int worker_buffer_size;
+
+	JobType job_type;
+	CL_InterlockedVariable next_job;
+	int job_end;
+	std::vector<CL_SoundBuffer_Session> *job_sessions;
+	std::vector<char> *job_playing;
+	std::vector<CL_SoundBus_Impl *> *job_buses;
+	int job_size;
+
+	int last_num_workers;
+	float session_cost;
+	float bus_cost;
+/// \}
+};
@@ -0,0 +1,95 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#include "Sound/precomp.h"
+#include "sound_sinc_filter.h"
+#include "API/Sound/sound_sse.h"
+#include "API/Core/System/mutex.h"
+#include <map>
+#include <cmath>
+
+static CL_Mutex cl_sinc_filter_mutex;
+static std::map<int, CL_SharedPtr<CL_SoundSincFilter> > cl_sinc_filters;
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundSincFilter Construction:
+
+CL_SoundSincFilter::CL_SoundSincFilter(float cutoff)
+: cutoff(cutoff), coefficients(0)
+{
+	const double pi = 3.14159265358979323846;
+	const int first_tap = taps / 2 - 1;
+	const double window_width = taps / 2;
+
+	coefficients = (float *) CL_SoundSSE::aligned_alloc(sizeof(float) * taps * (phases + 1));
+	for (int phase = 0; phase <= phases; phase++)
+	{
+		// Filter for an output position 'phase / phases' past input sample 0, applied to
+		// input samples -first_tap to taps - first_tap - 1.
+		double fraction = phase / double(phases);
+		double row[taps];
+		double sum = 0.0;
+		for (int tap = 0; tap < taps; tap++)
+		{
+			double x = tap - first_tap - fraction;
+			double sinc = (x == 0.0) ? 1.0 : sin(pi * cutoff * x) / (pi * cutoff * x);
+			double w = x / window_width;
+			double window = (w <= -1.0 || w >= 1.0) ? 0.0 : 0.42 + 0.5 * cos(pi * w) + 0.08 * cos(2.0 * pi * w);
+			row[tap] = sinc * window;
+			sum += row[tap];
+		}
+
+		// Normalize so a constant signal passes unchanged
+		for (int tap = 0; tap < taps; tap++)
+			coefficients[phase * taps + tap] = float(row[tap] / sum);
+	}
+}
+
+CL_SoundSincFilter::~CL_SoundSincFilter()
+{
+	CL_SoundSSE::aligned_free(coefficients);
+}
+
+CL_SharedPtr<CL_SoundSincFilter> CL_SoundSincFilter::get_filter(double step)
+{
+	// Leave some room for the transition band, and lower the cutoff when reading faster than
+	// the output rate so frequencies above the output Nyquist frequency are removed.
+	double cutoff = 0.9;
+	if (step > 1.0)
+		cutoff /= step;
+
+	int bucket = int(cutoff * 64.0 + 0.5);
+	if (bucket < 1)
+		bucket = 1;
+
+	CL_MutexSection mutex_lock(&cl_sinc_filter_mutex);
+	CL_SharedPtr<CL_SoundSincFilter> &filter = cl_sinc_filters[bucket];
+	if (!filter)
+		filter = CL_SharedPtr<CL_SoundSincFilter>(new CL_SoundSincFilter(bucket / 64.0f));
+	return filter;
+}
@@ -0,0 +1,73 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#pragma once
+
+#include "API/Core/System/sharedptr.h"
+
+/// \brief Polyphase windowed-sinc coefficient table used by CL_SoundSSE::resample_polyphase.
+///
+/// Tables are shared between sessions playing at similar speeds.
+class CL_SoundSincFilter
+{
+/// \name Construction
+/// \{
+
+public:
+	CL_SoundSincFilter(float cutoff);
+	~CL_SoundSincFilter();
+
+	/// \brief Returns a shared table suited for reading input 'step' samples per output sample
+	static CL_SharedPtr<CL_SoundSincFilter> get_filter(double step);
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	enum
+	{
+		taps = 16,
+		phases = 256
+	};
+
+	/// \brief Cutoff frequency relative to the input Nyquist frequency
+	float cutoff;
+
+	/// \brief phases + 1 rows of taps coefficients, 16-byte aligned
+	float *coefficients;
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	CL_SoundSincFilter(const CL_SoundSincFilter &);
+	CL_SoundSincFilter &operator =(const CL_SoundSincFilter &);
+/// \}
+};
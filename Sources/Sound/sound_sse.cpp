@@ -319,6 +319,30 @@ void CL_SoundSSE::multiply_float(float *channel, int size, float volume)
 		channel[i] *= volume;
 }
 
+void CL_SoundSSE::multiply_float_ramp(float *channel, int size, float start_volume, float volume_step)
+{
+#ifndef CL_DISABLE_SSE2
+	int sse_size = (size/4)*4;
+
+	__m128 start0 = _mm_set1_ps(start_volume);
+	__m128 step0 = _mm_set1_ps(volume_step);
+	__m128 index0 = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+	__m128 index_step0 = _mm_set1_ps(4.0f);
+	for (int i = 0; i < sse_size; i+=4)
+	{
+		__m128 volume0 = _mm_add_ps(start0, _mm_mul_ps(index0, step0));
+		__m128 s = _mm_loadu_ps(channel+i);
+		_mm_storeu_ps(channel+i, _mm_mul_ps(s, volume0));
+		index0 = _mm_add_ps(index0, index_step0);
+	}
+#else
+	const int sse_size = 0;
+#endif
+
+	for (int i = sse_size; i < size; i++)
+		channel[i] *= start_volume + i * volume_step;
+}
+
 void CL_SoundSSE::set_float(float *channel, int size, float value)
 {
 #ifndef CL_DISABLE_SSE2
@@ -359,6 +383,62 @@ void CL_SoundSSE::mix_one_to_one(float *input, int size, float *output, float vo
 	}
 }
 
+void CL_SoundSSE::mix_one_to_one_ramp(float *input, int size, float *output, float start_volume, float end_volume)
+{
+	if (size <= 0)
+		return;
+	float volume_step = (end_volume - start_volume) / size;
+
+#ifndef CL_DISABLE_SSE2
+	int sse_size = (size/4)*4;
+	__m128 start0 = _mm_set1_ps(start_volume);
+	__m128 step0 = _mm_set1_ps(volume_step);
+	__m128 index0 = _mm_set_ps(4.0f, 3.0f, 2.0f, 1.0f);
+	__m128 index_step0 = _mm_set1_ps(4.0f);
+	for (int i = 0; i < sse_size; i+=4)
+	{
+		__m128 volume0 = _mm_add_ps(start0, _mm_mul_ps(index0, step0));
+		__m128 sample0 = _mm_loadu_ps(input+i);
+		__m128 sample1 = _mm_loadu_ps(output+i);
+		_mm_storeu_ps(output+i, _mm_add_ps(_mm_mul_ps(sample0, volume0), sample1));
+		index0 = _mm_add_ps(index0, index_step0);
+	}
+
+#else
+	const int sse_size = 0;
+#endif
+
+	for (int i = sse_size; i < size; i++)
+	{
+		output[i] += input[i] * (start_volume + (i + 1) * volume_step);
+	}
+}
+
+void CL_SoundSSE::feedback_delay(float *channel, float *delay, int size, float feedback)
+{
+#ifndef CL_DISABLE_SSE2
+	int sse_size = (size/4)*4;
+	__m128 feedback0 = _mm_set1_ps(feedback);
+	for (int i = 0; i < sse_size; i+=4)
+	{
+		__m128 sample0 = _mm_loadu_ps(channel+i);
+		__m128 delay0 = _mm_loadu_ps(delay+i);
+		delay0 = _mm_add_ps(_mm_mul_ps(delay0, feedback0), sample0);
+		_mm_storeu_ps(delay+i, delay0);
+		_mm_storeu_ps(channel+i, delay0);
+	}
+
+#else
+	const int sse_size = 0;
+#endif
+
+	for (int i = sse_size; i < size; i++)
+	{
+		delay[i] = delay[i] * feedback + channel[i];
+		channel[i] = delay[i];
+	}
+}
+
 void CL_SoundSSE::mix_one_to_many(float *input, int size, float **output, float *volume, int channels)
 {
 #ifndef CL_DISABLE_SSE2
@@ -466,3 +546,156 @@ void CL_SoundSSE::unpack_float_mono(float *input, int size, float *output)
 	if(sse_size < size)
 		memcpy(output, input, (size-sse_size)*sizeof(float));
 }
+
+#ifndef CL_DISABLE_SSE2
+// Source indexes and fractions of four output samples, using the same double precision arithmetic as the scalar loops
+static inline __m128i cl_resample_positions(__m128d position, __m128d step, __m128d offset01, __m128d offset23, __m128 &out_fraction)
+{
+	__m128d pos01 = _mm_add_pd(position, _mm_mul_pd(offset01, step));
+	__m128d pos23 = _mm_add_pd(position, _mm_mul_pd(offset23, step));
+	__m128i index01 = _mm_cvttpd_epi32(pos01);
+	__m128i index23 = _mm_cvttpd_epi32(pos23);
+	__m128 fraction01 = _mm_cvtpd_ps(_mm_sub_pd(pos01, _mm_cvtepi32_pd(index01)));
+	__m128 fraction23 = _mm_cvtpd_ps(_mm_sub_pd(pos23, _mm_cvtepi32_pd(index23)));
+	out_fraction = _mm_movelh_ps(fraction01, fraction23);
+	return _mm_unpacklo_epi64(index01, index23);
+}
+#endif
+
+void CL_SoundSSE::resample_nearest(float *input, double position, double step, float *output, int size)
+{
+	for (int i = 0; i < size; i++)
+		output[i] = input[int(position + i * step)];
+}
+
+void CL_SoundSSE::resample_linear(float *input, double position, double step, float *output, int size)
+{
+#ifndef CL_DISABLE_SSE2
+	int sse_size = (size/4)*4;
+	__m128d pos = _mm_set1_pd(position);
+	__m128d pos_step = _mm_set1_pd(step);
+	__m128d offset01 = _mm_set_pd(1.0, 0.0);
+	__m128d offset23 = _mm_set_pd(3.0, 2.0);
+	__m128d offset_step = _mm_set1_pd(4.0);
+	for (int i = 0; i < sse_size; i+=4)
+	{
+		__m128 t;
+		__m128i index = cl_resample_positions(pos, pos_step, offset01, offset23, t);
+		offset01 = _mm_add_pd(offset01, offset_step);
+		offset23 = _mm_add_pd(offset23, offset_step);
+
+		// Each sample pair is one 64 bit load, then the pairs are split into the two interpolation inputs
+		const float *p0 = input + _mm_cvtsi128_si32(index);
+		const float *p1 = input + _mm_cvtsi128_si32(_mm_srli_si128(index, 4));
+		const float *p2 = input + _mm_cvtsi128_si32(_mm_srli_si128(index, 8));
+		const float *p3 = input + _mm_cvtsi128_si32(_mm_srli_si128(index, 12));
+		__m128 pairs01 = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), (const __m64 *) p0), (const __m64 *) p1);
+		__m128 pairs23 = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), (const __m64 *) p2), (const __m64 *) p3);
+		__m128 s0 = _mm_shuffle_ps(pairs01, pairs23, _MM_SHUFFLE(2,0,2,0));
+		__m128 s1 = _mm_shuffle_ps(pairs01, pairs23, _MM_SHUFFLE(3,1,3,1));
+
+		_mm_storeu_ps(output+i, _mm_add_ps(s0, _mm_mul_ps(_mm_sub_ps(s1, s0), t)));
+	}
+#else
+	const int sse_size = 0;
+#endif
+
+	for (int i = sse_size; i < size; i++)
+	{
+		double pos = position + i * step;
+		int index = int(pos);
+		float t = float(pos - index);
+		output[i] = input[index] + (input[index + 1] - input[index]) * t;
+	}
+}
+
+void CL_SoundSSE::resample_cubic(float *input, double position, double step, float *output, int size)
+{
+#ifndef CL_DISABLE_SSE2
+	int sse_size = (size/4)*4;
+	__m128 half = _mm_set1_ps(0.5f);
+	__m128 two = _mm_set1_ps(2.0f);
+	__m128 three = _mm_set1_ps(3.0f);
+	__m128 four = _mm_set1_ps(4.0f);
+	__m128 five = _mm_set1_ps(5.0f);
+	__m128d pos = _mm_set1_pd(position);
+	__m128d pos_step = _mm_set1_pd(step);
+	__m128d offset01 = _mm_set_pd(1.0, 0.0);
+	__m128d offset23 = _mm_set_pd(3.0, 2.0);
+	__m128d offset_step = _mm_set1_pd(4.0);
+	for (int i = 0; i < sse_size; i+=4)
+	{
+		__m128 t;
+		__m128i index = cl_resample_positions(pos, pos_step, offset01, offset23, t);
+		offset01 = _mm_add_pd(offset01, offset_step);
+		offset23 = _mm_add_pd(offset23, offset_step);
+
+		// Load the four neighbours of each output sample as one vector, then transpose them into s0..s3
+		__m128 s0 = _mm_loadu_ps(input + _mm_cvtsi128_si32(index) - 1);
+		__m128 s1 = _mm_loadu_ps(input + _mm_cvtsi128_si32(_mm_srli_si128(index, 4)) - 1);
+		__m128 s2 = _mm_loadu_ps(input + _mm_cvtsi128_si32(_mm_srli_si128(index, 8)) - 1);
+		__m128 s3 = _mm_loadu_ps(input + _mm_cvtsi128_si32(_mm_srli_si128(index, 12)) - 1);
+		_MM_TRANSPOSE4_PS(s0, s1, s2, s3);
+
+		// s1 + 0.5 * t * (s2 - s0 + t * (2*s0 - 5*s1 + 4*s2 - s3 + t * (3 * (s1 - s2) + s3 - s0)))
+		__m128 c3 = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(three, _mm_sub_ps(s1, s2)), s3), s0);
+		__m128 c2 = _mm_sub_ps(_mm_add_ps(_mm_sub_ps(_mm_mul_ps(two, s0), _mm_mul_ps(five, s1)), _mm_mul_ps(four, s2)), s3);
+		__m128 c1 = _mm_sub_ps(s2, s0);
+		__m128 result = _mm_add_ps(c1, _mm_mul_ps(t, _mm_add_ps(c2, _mm_mul_ps(t, c3))));
+		result = _mm_add_ps(s1, _mm_mul_ps(_mm_mul_ps(half, t), result));
+		_mm_storeu_ps(output+i, result);
+	}
+#else
+	const int sse_size = 0;
+#endif
+
+	for (int i = sse_size; i < size; i++)
+	{
+		double pos = position + i * step;
+		int index = int(pos);
+		float t = float(pos - index);
+		float s0 = input[index - 1];
+		float s1 = input[index];
+		float s2 = input[index + 1];
+		float s3 = input[index + 2];
+		output[i] = s1 + 0.5f * t * (s2 - s0 + t * (2.0f*s0 - 5.0f*s1 + 4.0f*s2 - s3 + t * (3.0f * (s1 - s2) + s3 - s0)));
+	}
+}
+
+void CL_SoundSSE::resample_polyphase(float *input, double position, double step, float *filter, int taps, int phases, float *output, int size)
+{
+	int first_tap = taps / 2 - 1;
+	for (int i = 0; i < size; i++)
+	{
+		double pos = position + i * step;
+		int index = int(pos);
+		double phase_position = (pos - index) * phases;
+		int phase = int(phase_position);
+		float t = float(phase_position - phase);
+
+		// Interpolate between the two nearest filter phases while applying them
+		float *coefficients0 = filter + phase * taps;
+		float *coefficients1 = coefficients0 + taps;
+		float *samples = input + index - first_tap;
+
+#ifndef CL_DISABLE_SSE2
+		__m128 t0 = _mm_set1_ps(t);
+		__m128 sum = _mm_setzero_ps();
+		for (int j = 0; j < taps; j+=4)
+		{
+			__m128 c0 = _mm_load_ps(coefficients0+j);
+			__m128 c1 = _mm_load_ps(coefficients1+j);
+			__m128 c = _mm_add_ps(c0, _mm_mul_ps(_mm_sub_ps(c1, c0), t0));
+			sum = _mm_add_ps(sum, _mm_mul_ps(c, _mm_loadu_ps(samples+j)));
+		}
+		sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+		sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1,1,1,1)));
+		_mm_store_ss(output+i, sum);
+#else
+		float sum = 0.0f;
+		for (int j = 0; j < taps; j++)
+			sum += (coefficients0[j] + (coefficients1[j] - coefficients0[j]) * t) * samples[j];
+		output[i] = sum;
+#endif
+	}
+}
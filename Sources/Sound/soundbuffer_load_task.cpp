@@ -0,0 +1,93 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#include "Sound/precomp.h"
+#include "API/Sound/soundbuffer_load_task.h"
+#include "API/Sound/SoundProviders/soundprovider_factory.h"
+#include "API/Core/IOData/virtual_directory.h"
+#include "API/Core/Resources/resource.h"
+#include "API/Core/System/exception.h"
+#include "API/Core/XML/dom_element.h"
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundBufferLoadTask_Impl Class:
+
+class CL_SoundBufferLoadTask_Impl
+{
+public:
+	CL_SoundBufferLoadTask_Impl() : streamed(false) { }
+
+	CL_String resource_id;
+	CL_String filename;
+	CL_String sound_format;
+	bool streamed;
+	CL_VirtualDirectory directory;
+	CL_SoundBuffer soundbuffer;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundBufferLoadTask Construction:
+
+CL_SoundBufferLoadTask::CL_SoundBufferLoadTask(const CL_String &resource_id)
+: impl(new CL_SoundBufferLoadTask_Impl)
+{
+	impl->resource_id = resource_id;
+}
+
+CL_SoundBufferLoadTask::~CL_SoundBufferLoadTask()
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundBufferLoadTask Attributes:
+
+CL_SoundBuffer CL_SoundBufferLoadTask::get_soundbuffer() const
+{
+	return impl->soundbuffer;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundBufferLoadTask Operations:
+
+void CL_SoundBufferLoadTask::prepare(CL_ResourceManager &resources)
+{
+	CL_Resource resource = resources.get_resource(impl->resource_id);
+	CL_DomElement &element = resource.get_element();
+	impl->filename = element.get_attribute("file");
+	impl->sound_format = element.get_attribute("format");
+	impl->streamed = (element.get_attribute("stream", "no") == "yes");
+	impl->directory = resources.get_directory(resource);
+}
+
+void CL_SoundBufferLoadTask::load()
+{
+	CL_SoundProvider *provider = CL_SoundProviderFactory::load(impl->filename, impl->streamed, impl->directory, impl->sound_format);
+	if (provider == 0)
+		throw CL_Exception("Unknown sample format");
+	impl->soundbuffer = CL_SoundBuffer(provider);
+}
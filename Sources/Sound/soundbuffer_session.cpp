@@ -30,8 +30,11 @@
 #include "API/Sound/soundbuffer_session.h"
 #include "API/Sound/SoundProviders/soundprovider_session.h"
 #include "API/Sound/soundfilter.h"
+#include "API/Sound/soundbus.h"
 #include "soundbuffer_session_impl.h"
 #include "soundoutput_impl.h"
+#include "soundbus_impl.h"
+#include "sound_command_queue.h"
 
 /////////////////////////////////////////////////////////////////////////////
 // CL_SoundBuffer_Session construction:
@@ -64,8 +67,7 @@ int CL_SoundBuffer_Session::get_position() const
 {
 	if (impl)
 	{
-		CL_MutexSection mutex_lock(&impl->mutex);
-		return impl->provider_session->get_position();
+		return impl->shared_position.get();
 	}
 	else
 	{
@@ -77,9 +79,8 @@ float CL_SoundBuffer_Session::get_position_relative() const
 {
 	if (impl)
 	{
-		CL_MutexSection mutex_lock(&impl->mutex);
-		int position = impl->provider_session->get_position();
-		int length = impl->provider_session->get_num_samples();
+		int position = impl->shared_position.get();
+		int length = impl->shared_length.get();
 		if (length == 0) return 1.0f;
 		return position / (float) length;
 	}
@@ -93,8 +94,7 @@ int CL_SoundBuffer_Session::get_length() const
 {
 	if (impl)
 	{
-		CL_MutexSection mutex_lock(&impl->mutex);
-		return impl->provider_session->get_num_samples();
+		return impl->shared_length.get();
 	}
 	else
 	{
@@ -106,7 +106,8 @@ int CL_SoundBuffer_Session::get_frequency() const
 {
 	if (impl)
 	{
-		return impl->frequency;
+		CL_MutexSection mutex_lock(&impl->mutex);
+		return impl->settings.frequency;
 	}
 	else
 	{
@@ -114,12 +115,25 @@ int CL_SoundBuffer_Session::get_frequency() const
 	}
 }
 
+CL_SoundResampling CL_SoundBuffer_Session::get_resampling() const
+{
+	if (impl)
+	{
+		CL_MutexSection mutex_lock(&impl->mutex);
+		return impl->settings.resampling;
+	}
+	else
+	{
+		return cl_resample_cubic;
+	}
+}
+
 float CL_SoundBuffer_Session::get_volume() const
 {
 	if (impl)
 	{
 		CL_MutexSection mutex_lock(&impl->mutex);
-		return impl->volume;
+		return impl->settings.volume;
 	}
 	else
 	{
@@ -132,7 +146,7 @@ float CL_SoundBuffer_Session::get_pan() const
 	if (impl)
 	{
 		CL_MutexSection mutex_lock(&impl->mutex);
-		return impl->pan;
+		return impl->settings.pan;
 	}
 	else
 	{
@@ -144,7 +158,8 @@ bool CL_SoundBuffer_Session::get_looping() const
 {
 	if (impl)
 	{
-		return impl->looping;
+		CL_MutexSection mutex_lock(&impl->mutex);
+		return impl->settings.looping;
 	}
 	else
 	{
@@ -152,12 +167,37 @@ bool CL_SoundBuffer_Session::get_looping() const
 	}
 }
 
-bool CL_SoundBuffer_Session::is_playing()
+bool CL_SoundBuffer_Session::get_volume_ramping() const
 {
 	if (impl)
 	{
 		CL_MutexSection mutex_lock(&impl->mutex);
-		return impl->playing;
+		return impl->settings.volume_ramping;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+CL_SoundBus CL_SoundBuffer_Session::get_bus() const
+{
+	if (impl)
+	{
+		CL_MutexSection mutex_lock(&impl->mutex);
+		return CL_SoundBus(impl->settings.bus);
+	}
+	else
+	{
+		return CL_SoundBus();
+	}
+}
+
+bool CL_SoundBuffer_Session::is_playing()
+{
+	if (impl)
+	{
+		return impl->shared_playing.get() != 0;
 	}
 	else
 	{
@@ -172,13 +212,11 @@ bool CL_SoundBuffer_Session::set_position(int new_pos)
 {
 	if (impl)
 	{
-		CL_MutexSection mutex_lock(&impl->mutex);
-		if (impl->provider_session->set_position(new_pos))
-		{
-			// instantly update position here?
-			return true;
-		}
-		return false;
+		if (new_pos < 0)
+			return false;
+		impl->shared_position.set(new_pos);
+		impl->output.impl->send_command(CL_SoundCommand(CL_SoundCommand::type_set_position, impl, new_pos));
+		return true;
 	}
 	else
 	{
@@ -190,13 +228,10 @@ bool CL_SoundBuffer_Session::set_end_position(int new_pos)
 {
 	if (impl)
 	{
-		CL_MutexSection mutex_lock(&impl->mutex);
-		if (impl->provider_session->set_end_position(new_pos))
-		{
-			// instantly update end position here?
-			return true;
-		}
-		return false;
+		if (new_pos < 0)
+			return false;
+		impl->output.impl->send_command(CL_SoundCommand(CL_SoundCommand::type_set_end_position, impl, new_pos));
+		return true;
 	}
 	else
 	{
@@ -220,33 +255,59 @@ bool CL_SoundBuffer_Session::set_position_relative(float new_pos)
 void CL_SoundBuffer_Session::set_volume(float new_volume)
 {
 	if (impl)
-		impl->volume = new_volume;
+	{
+		CL_MutexSection mutex_lock(&impl->mutex);
+		impl->settings.volume = new_volume;
+		impl->output.impl->send_command(CL_SoundCommand(CL_SoundCommand::type_set_volume, impl, 0, new_volume));
+	}
 }
 
 void CL_SoundBuffer_Session::set_frequency(int new_frequency)
 {
 	if (impl)
-		impl->frequency = new_frequency;
+	{
+		CL_MutexSection mutex_lock(&impl->mutex);
+		impl->settings.frequency = new_frequency;
+		impl->output.impl->send_command(CL_SoundCommand(CL_SoundCommand::type_set_frequency, impl, 0, new_frequency));
+	}
+}
+
+void CL_SoundBuffer_Session::set_resampling(CL_SoundResampling resampling)
+{
+	if (impl)
+	{
+		CL_MutexSection mutex_lock(&impl->mutex);
+		impl->settings.resampling = resampling;
+		impl->output.impl->send_command(CL_SoundCommand(CL_SoundCommand::type_set_resampling, impl, resampling));
+	}
 }
 
 void CL_SoundBuffer_Session::set_pan(float new_pan)
 {
 	if (impl)
-		impl->pan = new_pan;
+	{
+		CL_MutexSection mutex_lock(&impl->mutex);
+		impl->settings.pan = new_pan;
+		impl->output.impl->send_command(CL_SoundCommand(CL_SoundCommand::type_set_pan, impl, 0, new_pan));
+	}
 }
 
-void CL_SoundBuffer_Session::play()
+void CL_SoundBuffer_Session::set_volume_ramping(bool enable)
 {
 	if (impl)
 	{
 		CL_MutexSection mutex_lock(&impl->mutex);
-		if (impl->playing) return;
-		if (impl->provider_session->play())
-		{
-			impl->playing = true;
-			mutex_lock.unlock();
+		impl->settings.volume_ramping = enable;
+		impl->output.impl->send_command(CL_SoundCommand(CL_SoundCommand::type_set_volume_ramping, impl, enable ? 1 : 0));
+	}
+}
+
+void CL_SoundBuffer_Session::play()
+{
+	if (impl)
+	{
+		if (impl->shared_playing.compare_and_swap(0, 1))
 			impl->output.impl->play_session(*this);
-		}
 	}
 }
 
@@ -254,13 +315,8 @@ void CL_SoundBuffer_Session::stop()
 {
 	if (impl)
 	{
-		CL_MutexSection mutex_lock(&impl->mutex);
-		if (!impl->playing) return;
-		mutex_lock.unlock();
-		impl->output.impl->stop_session(*this);
-		mutex_lock.lock();
-		impl->playing = false;
-		impl->provider_session->stop();
+		if (impl->shared_playing.compare_and_swap(1, 0))
+			impl->output.impl->stop_session(*this);
 	}
 }
 
@@ -269,8 +325,8 @@ void CL_SoundBuffer_Session::set_looping(bool loop)
 	if (impl)
 	{
 		CL_MutexSection mutex_lock(&impl->mutex);
-		impl->looping = loop;
-		impl->provider_session->set_looping(loop);
+		impl->settings.looping = loop;
+		impl->output.impl->send_command(CL_SoundCommand(CL_SoundCommand::type_set_looping, impl, loop ? 1 : 0));
 	}
 }
 
@@ -278,8 +334,9 @@ void CL_SoundBuffer_Session::add_filter(CL_SoundFilter &filter)
 {
 	if (impl)
 	{
-		CL_MutexSection mutex_lock(&impl->mutex);
-		impl->filters.push_back(filter);
+		CL_SoundCommand command(CL_SoundCommand::type_add_filter, impl);
+		command.filter = filter;
+		impl->output.impl->send_command(command);
 	}
 }
 
@@ -287,14 +344,24 @@ void CL_SoundBuffer_Session::remove_filter(CL_SoundFilter &filter)
 {
 	if (impl)
 	{
+		CL_SoundCommand command(CL_SoundCommand::type_remove_filter, impl);
+		command.filter = filter;
+		impl->output.impl->send_command(command);
+	}
+}
+
+void CL_SoundBuffer_Session::set_bus(const CL_SoundBus &bus)
+{
+	if (impl)
+	{
+		if (bus.impl && bus.impl->output.lock() != impl->output.impl)
+			throw CL_Exception("Sound bus belongs to another sound output");
+
 		CL_MutexSection mutex_lock(&impl->mutex);
-		for (std::vector<CL_SoundFilter>::size_type i=0; i<impl->filters.size(); i++)
-		{
-			if (impl->filters[i] == filter)
-			{
-				impl->filters.erase(impl->filters.begin()+i);
-			}
-		}
+		impl->settings.bus = bus.impl;
+		CL_SoundCommand command(CL_SoundCommand::type_set_bus, impl);
+		command.bus = bus.impl;
+		impl->output.impl->send_command(command);
 	}
 }
 
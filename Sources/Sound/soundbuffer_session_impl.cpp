@@ -30,31 +30,53 @@
 #include "soundbuffer_session_impl.h"
 #include "soundbuffer_impl.h"
 #include "soundoutput_impl.h"
+#include "sound_sinc_filter.h"
+#include "sound_command_queue.h"
+#include "soundbus_impl.h"
 #include "API/Sound/sound_sse.h"
 #include "API/Sound/soundfilter.h"
 #include "API/Sound/SoundProviders/soundprovider.h"
 #include "API/Sound/SoundProviders/soundprovider_session.h"
 #include "API/Core/Text/logger.h"
+#include <cmath>
+#include <cstring>
 
 /////////////////////////////////////////////////////////////////////////////
 //! Construction:
 
 CL_SoundBuffer_Session_Impl::CL_SoundBuffer_Session_Impl(CL_SoundBuffer &soundbuffer, bool looping, CL_SoundOutput &output)
-: soundbuffer(soundbuffer), provider_session(0), output(output), volume(1.0f), pan(0.0f), looping(looping), playing(false)
+: soundbuffer(soundbuffer), output(output), provider_session(0), volume(1.0f), pan(0.0f), resampling(cl_resample_cubic), looping(looping), volume_ramping(false), playing(false)
 {
 	volume = soundbuffer.get_volume();
 	pan = soundbuffer.get_pan();
 	provider_session = soundbuffer.get_provider()->begin_session();
 	provider_session->set_looping(looping);
 	frequency = provider_session->get_frequency();
+	mixing_frequency = output.get_mixing_frequency();
+	get_channel_volume(last_channel_volume);
+
+	settings.volume = volume;
+	settings.frequency = frequency;
+	settings.pan = pan;
+	settings.resampling = resampling;
+	settings.looping = looping;
+	settings.volume_ramping = volume_ramping;
+	shared_position.set(provider_session->get_position());
+	shared_length.set(provider_session->get_num_samples());
 
 	num_buffer_samples = 16*1024;
 	num_buffer_channels = provider_session->get_num_channels();
 	buffer_position = 0.0;
 	buffer_samples_written = 0;
+	sinc_filter_speed = 0.0;
 
 	float_buffer_data = new float*[num_buffer_channels];
-	for (int i=0; i<num_buffer_channels; i++) float_buffer_data[i] = new float[num_buffer_samples];
+	for (int i=0; i<num_buffer_channels; i++)
+	{
+		float *data = new float[history_samples + num_buffer_samples + padding_samples];
+		CL_SoundSSE::set_float(data, history_samples + num_buffer_samples + padding_samples, 0.0f);
+		float_buffer_data[i] = data + history_samples;
+	}
 
 	float_buffer_data_offsetted.resize(num_buffer_channels);
 }
@@ -66,7 +88,7 @@ CL_SoundBuffer_Session_Impl::~CL_SoundBuffer_Session_Impl()
 		soundbuffer.get_provider()->end_session(provider_session);
 	}
 
-	for (int j=0; j < num_buffer_channels; ++j) delete[] float_buffer_data[j];
+	for (int j=0; j < num_buffer_channels; ++j) delete[] (float_buffer_data[j] - history_samples);
 	delete[] float_buffer_data;
 }
 
@@ -79,13 +101,106 @@ CL_SoundBuffer_Session_Impl::~CL_SoundBuffer_Session_Impl()
 
 bool CL_SoundBuffer_Session_Impl::mix_to(float **sample_data, float **temp_data, int num_samples, int num_channels)
 {
-	CL_MutexSection mutex_lock(&mutex);
 	get_data_in_mixer_frequency(num_samples, temp_data);
 	run_filters(temp_data, num_samples);
 	mix_channels(num_channels, num_samples, sample_data, temp_data);
+
+	shared_position.set(provider_session->get_position());
+	shared_length.set(provider_session->get_num_samples());
 	return playing;
 }
 
+void CL_SoundBuffer_Session_Impl::apply_command(const CL_SoundCommand &command)
+{
+	switch (command.type)
+	{
+	case CL_SoundCommand::type_play:
+		if (!playing)
+		{
+			playing = provider_session->play();
+			get_channel_volume(last_channel_volume);
+		}
+		shared_playing.set(playing ? 1 : 0);
+		break;
+
+	case CL_SoundCommand::type_stop:
+		if (playing)
+		{
+			playing = false;
+			provider_session->stop();
+		}
+		shared_playing.set(0);
+		break;
+
+	case CL_SoundCommand::type_set_position:
+	case CL_SoundCommand::type_set_end_position:
+		try
+		{
+			bool result;
+			if (command.type == CL_SoundCommand::type_set_position)
+				result = provider_session->set_position(command.int_value);
+			else
+				result = provider_session->set_end_position(command.int_value);
+			if (!result)
+				cl_log_event("mixer", "Sound provider session could not seek to %1", command.int_value);
+		}
+		catch (const CL_Exception &e)
+		{
+			cl_log_event("mixer", "Sound provider session could not seek to %1: %2", command.int_value, e.message);
+		}
+		shared_position.set(provider_session->get_position());
+		shared_length.set(provider_session->get_num_samples());
+		break;
+
+	case CL_SoundCommand::type_set_looping:
+		looping = (command.int_value != 0);
+		provider_session->set_looping(looping);
+		break;
+
+	case CL_SoundCommand::type_set_volume:
+		volume = command.float_value;
+		break;
+
+	case CL_SoundCommand::type_set_pan:
+		pan = command.float_value;
+		break;
+
+	case CL_SoundCommand::type_set_frequency:
+		frequency = command.float_value;
+		break;
+
+	case CL_SoundCommand::type_set_resampling:
+		resampling = CL_SoundResampling(command.int_value);
+		break;
+
+	case CL_SoundCommand::type_set_volume_ramping:
+		volume_ramping = (command.int_value != 0);
+		break;
+
+	case CL_SoundCommand::type_add_filter:
+		filters.push_back(command.filter);
+		break;
+
+	case CL_SoundCommand::type_remove_filter:
+		for (std::vector<CL_SoundFilter>::size_type i = 0; i < filters.size(); i++)
+		{
+			if (filters[i] == command.filter)
+			{
+				filters.erase(filters.begin() + i);
+				break;
+			}
+		}
+		break;
+
+	case CL_SoundCommand::type_set_bus:
+		bus = command.bus;
+		break;
+
+	default:
+		break;
+	}
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_SoundBuffer_Session_Impl implementation:
 
@@ -100,6 +215,10 @@ void CL_SoundBuffer_Session_Impl::get_data()
 
 	if (num_session_channels > 0)
 	{
+		// Keep the last samples of the previous fill in front of the buffer for interpolation:
+		for (int i = 0; i < num_session_channels; i++)
+			memmove(float_buffer_data[i] - history_samples, float_buffer_data[i] + buffer_samples_written - history_samples, sizeof(float) * history_samples);
+
 		// Copy stream data to working buffer:
 		int samples_left = num_buffer_samples;
 		while (samples_left > 0)
@@ -138,42 +257,65 @@ void CL_SoundBuffer_Session_Impl::get_data()
 		}
 
 		buffer_samples_written = num_buffer_samples - samples_left;
+
+		// A looping stream ending exactly at the end of the buffer must not be mistaken for the end of playback:
+		if (looping && samples_left == 0 && provider_session->eof())
+		{
+			if (provider_session->set_position(0))
+				provider_session->play();
+		}
+
+		// Silence after the written samples, read when interpolating past the end of the stream:
+		for (int i = 0; i < num_session_channels; i++)
+			CL_SoundSSE::set_float(float_buffer_data[i] + buffer_samples_written, padding_samples, 0.0f);
 	}
 }
 
 void CL_SoundBuffer_Session_Impl::get_data_in_mixer_frequency(int num_samples, float **temp_data)
 {
 	// Convert from session frequency to mixer frequency:
-	// This is done by copying data from the temporary session buffers (buffer_data) to
-	// the temporary mixing buffers (temp_data), and if buffer_data is exhausted, calling
+	// This is done by resampling blocks of data from the temporary session buffers (buffer_data)
+	// to the temporary mixing buffers (temp_data), and if buffer_data is exhausted, calling
 	// get_data() to fill it with new data from the soundprovider session object.
-	double speed = frequency / double(output.get_mixing_frequency());
-	int sample_count;
-	for (sample_count = 0; sample_count < num_samples; sample_count++)
+	double speed = frequency / double(mixing_frequency);
+	int samples_before, samples_after;
+	get_resampling_range(speed, samples_before, samples_after);
+
+	int sample_count = 0;
+	while (sample_count < num_samples)
 	{
-		if (buffer_position < buffer_samples_written)
+		// Samples past the end are only needed from the provider while the stream continues
+		bool end_of_data = provider_session->eof();
+		int available = end_of_data ? buffer_samples_written : buffer_samples_written - samples_after;
+		if (buffer_position < available)
 		{
-			for (int chan = 0; chan < num_buffer_channels; chan++)
+			int count = num_samples - sample_count;
+			if (speed > 0.0)
 			{
-				temp_data[chan][sample_count] = float_buffer_data[chan][int(buffer_position)];
+				double samples_left = ceil((available - buffer_position) / speed);
+				if (samples_left < count)
+					count = samples_left < 1.0 ? 1 : int(samples_left);
 			}
+
+			resample(speed, temp_data, sample_count, count);
+			buffer_position += count * speed;
+			sample_count += count;
 		}
 		else
 		{
-			if (provider_session->eof())
+			if (end_of_data)
 			{
 				playing = false;
 				break;
 			}
 
 			// Out of data, get more from provider:
+			int previous_samples_written = buffer_samples_written;
 			buffer_position -= buffer_samples_written;
 			get_data();
-			sample_count--;
-			continue;
+			if (buffer_samples_written == 0 && previous_samples_written == 0 && !provider_session->eof())
+				break;
 		}
-
-		buffer_position += speed;
 	}
 
 	// Clear the remaining samples (if any)
@@ -186,6 +328,70 @@ void CL_SoundBuffer_Session_Impl::get_data_in_mixer_frequency(int num_samples, f
 	}
 }
 
+void CL_SoundBuffer_Session_Impl::resample(double speed, float **temp_data, int offset, int count)
+{
+	// Resampling kernels expect a positive position, so address the buffers from the start of the history
+	double position = buffer_position + history_samples;
+	if (speed == 1.0 && position == floor(position))
+	{
+		int index = int(position) - history_samples;
+		for (int chan = 0; chan < num_buffer_channels; chan++)
+			memcpy(temp_data[chan] + offset, float_buffer_data[chan] + index, sizeof(float) * count);
+		return;
+	}
+
+	for (int chan = 0; chan < num_buffer_channels; chan++)
+	{
+		float *input = float_buffer_data[chan] - history_samples;
+		float *output = temp_data[chan] + offset;
+		switch (resampling)
+		{
+		case cl_resample_nearest:
+			CL_SoundSSE::resample_nearest(input, position, speed, output, count);
+			break;
+		case cl_resample_linear:
+			CL_SoundSSE::resample_linear(input, position, speed, output, count);
+			break;
+		case cl_resample_cubic:
+			CL_SoundSSE::resample_cubic(input, position, speed, output, count);
+			break;
+		case cl_resample_sinc:
+			CL_SoundSSE::resample_polyphase(input, position, speed, sinc_filter->coefficients, CL_SoundSincFilter::taps, CL_SoundSincFilter::phases, output, count);
+			break;
+		}
+	}
+}
+
+void CL_SoundBuffer_Session_Impl::get_resampling_range(double speed, int &samples_before, int &samples_after)
+{
+	samples_before = 0;
+	samples_after = 0;
+	if (speed == 1.0 && buffer_position == floor(buffer_position))
+		return;
+
+	switch (resampling)
+	{
+	case cl_resample_nearest:
+		break;
+	case cl_resample_linear:
+		samples_after = 1;
+		break;
+	case cl_resample_cubic:
+		samples_before = 1;
+		samples_after = 2;
+		break;
+	case cl_resample_sinc:
+		if (!sinc_filter || sinc_filter_speed != speed)
+		{
+			sinc_filter = CL_SoundSincFilter::get_filter(speed);
+			sinc_filter_speed = speed;
+		}
+		samples_before = CL_SoundSincFilter::taps / 2 - 1;
+		samples_after = CL_SoundSincFilter::taps / 2;
+		break;
+	}
+}
+
 void CL_SoundBuffer_Session_Impl::run_filters(float **temp_data, int num_samples)
 {
 	for (std::vector<CL_SoundFilter *>::size_type index_filter = 0; index_filter < filters.size(); index_filter++)
@@ -217,10 +423,21 @@ void CL_SoundBuffer_Session_Impl::mix_channels(int num_channels, int num_samples
 	float channel_volume[2];
 	get_channel_volume(channel_volume);
 
+	// Move from the volume of the previous fragment over this one, avoiding zipper noise:
+	bool ramp = volume_ramping && (channel_volume[0] != last_channel_volume[0] || channel_volume[1] != last_channel_volume[1]);
+
 	if (num_buffer_channels == 1)
 	{
 		// If its a mono stream, play it in left and right channels:
-		CL_SoundSSE::mix_one_to_many(temp_data[0], num_samples, sample_data, channel_volume, 2);
+		if (ramp)
+		{
+			for (int chan = 0; chan < 2; chan++)
+				CL_SoundSSE::mix_one_to_one_ramp(temp_data[0], num_samples, sample_data[chan], last_channel_volume[chan], channel_volume[chan]);
+		}
+		else
+		{
+			CL_SoundSSE::mix_one_to_many(temp_data[0], num_samples, sample_data, channel_volume, 2);
+		}
 	}
 	else
 	{
@@ -228,6 +445,14 @@ void CL_SoundBuffer_Session_Impl::mix_channels(int num_channels, int num_samples
 			num_channels = num_buffer_channels;
 
 		for (int chan = 0; chan < num_channels; chan++)
-			CL_SoundSSE::mix_one_to_one(temp_data[chan], num_samples, sample_data[chan], channel_volume[chan]);
+		{
+			if (ramp)
+				CL_SoundSSE::mix_one_to_one_ramp(temp_data[chan], num_samples, sample_data[chan], last_channel_volume[chan], channel_volume[chan]);
+			else
+				CL_SoundSSE::mix_one_to_one(temp_data[chan], num_samples, sample_data[chan], channel_volume[chan]);
+		}
 	}
+
+	last_channel_volume[0] = channel_volume[0];
+	last_channel_volume[1] = channel_volume[1];
 }
@@ -31,14 +31,19 @@
 #include <vector>
 #include "API/Core/System/sharedptr.h"
 #include "API/Core/System/mutex.h"
+#include "API/Core/System/interlocked_variable.h"
 #include "API/Sound/soundformat.h"
 #include "API/Sound/soundoutput.h"
 #include "API/Sound/soundbuffer.h"
+#include "API/Sound/soundbuffer_session.h"
 
 class CL_SoundFilter;
 class CL_SoundBuffer_Impl;
 class CL_SoundProvider_Session;
 class CL_SoundOutput_Impl;
+class CL_SoundSincFilter;
+class CL_SoundCommand;
+class CL_SoundBus_Impl;
 
 class CL_SoundBuffer_Session_Impl
 {
@@ -59,16 +64,45 @@ public:
 /// \{
 
 public:
+	/// \brief Session settings as last set through CL_SoundBuffer_Session
+	///
+	/// The mixer thread keeps its own copy, updated by commands at the start of each fragment.
+	struct Settings
+	{
+		float volume;
+		float frequency;
+		float pan;
+		CL_SoundResampling resampling;
+		bool looping;
+		bool volume_ramping;
+		CL_SharedPtr<CL_SoundBus_Impl> bus;
+	};
+
 	CL_SoundBuffer soundbuffer;
-	CL_SoundProvider_Session *provider_session;
 	CL_SoundOutput output;
+
+	/// \brief Guards settings between API callers. Never locked by the mixer thread.
+	mutable CL_Mutex mutex;
+	Settings settings;
+
+	/// \brief Playing state, provider position and provider length, as published by the mixer thread
+	CL_InterlockedVariable shared_playing;
+	CL_InterlockedVariable shared_position;
+	CL_InterlockedVariable shared_length;
+
+	// The following are only accessed by the mixer thread once the session has been created:
+	CL_SoundProvider_Session *provider_session;
 	float volume;
 	float frequency;
 	float pan;
+	CL_SoundResampling resampling;
 	bool looping;
+	bool volume_ramping;
 	bool playing;
 	std::vector<CL_SoundFilter> filters;
-	mutable CL_Mutex mutex;
+
+	/// \brief Bus the session is mixed into, or null for the output.
+	CL_SharedPtr<CL_SoundBus_Impl> bus;
 
 
 /// \}
@@ -78,6 +112,9 @@ public:
 public:
 	bool mix_to(float **sample_data, float **temp_data, int num_samples, int num_channels);
 
+	/// \brief Applies a command sent from CL_SoundBuffer_Session. Called by the mixer thread.
+	void apply_command(const CL_SoundCommand &command);
+
 /// \}
 /// \name Implementation
 /// \{
@@ -98,7 +135,25 @@ private:
 	/// \brief Fills temporary buffers with data from provider.
 	void get_data();
 
+	/// \brief Resamples 'count' samples from the temporary buffers into temp_data
+	void resample(double speed, float **temp_data, int offset, int count);
+
+	/// \brief Returns how many samples before and after a position the resampler reads
+	void get_resampling_range(double speed, int &samples_before, int &samples_after);
+
+	enum
+	{
+		/// \brief Samples kept before the start of the temporary buffers for interpolation.
+		history_samples = 16,
+
+		/// \brief Zeroed samples after the end of the temporary buffers for interpolation.
+		padding_samples = 16
+	};
+
 	/// \brief Temporary channel buffers containing sound data in provider frequency.
+	///
+	/// Each buffer is preceded by history_samples samples from the previous fill, and
+	/// followed by padding_samples samples of silence.
 	float **float_buffer_data;
 
 	std::vector<float*> float_buffer_data_offsetted;
@@ -114,6 +169,18 @@ private:
 
 	/// \brief Number of samples currently written to buffer_data.
 	int buffer_samples_written;
+
+	/// \brief Mixing frequency of the output, which does not change after construction.
+	int mixing_frequency;
+
+	/// \brief Channel volumes used at the end of the previous fragment, where volume ramps start.
+	float last_channel_volume[2];
+
+	/// \brief Coefficients used by cl_resample_sinc.
+	CL_SharedPtr<CL_SoundSincFilter> sinc_filter;
+
+	/// \brief Speed sinc_filter was selected for.
+	double sinc_filter_speed;
 /// \}
 };
 
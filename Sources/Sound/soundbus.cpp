@@ -0,0 +1,154 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#include "Sound/precomp.h"
+#include "API/Sound/soundbus.h"
+#include "API/Sound/soundoutput.h"
+#include "API/Sound/soundfilter.h"
+#include "soundbus_impl.h"
+#include "soundoutput_impl.h"
+#include "sound_command_queue.h"
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundBus construction:
+
+CL_SoundBus::CL_SoundBus()
+{
+}
+
+CL_SoundBus::CL_SoundBus(CL_SoundOutput &output)
+{
+	output.throw_if_null();
+	impl = CL_SharedPtr<CL_SoundBus_Impl>(new CL_SoundBus_Impl(output.impl, CL_SharedPtr<CL_SoundBus_Impl>()));
+	impl->send_command(CL_SoundCommand(CL_SoundCommand::type_add_bus, impl));
+}
+
+CL_SoundBus::CL_SoundBus(CL_SoundOutput &output, const CL_SoundBus &parent)
+{
+	output.throw_if_null();
+	if (parent.impl && parent.impl->output.lock() != output.impl)
+		throw CL_Exception("The parent bus belongs to another sound output");
+
+	impl = CL_SharedPtr<CL_SoundBus_Impl>(new CL_SoundBus_Impl(output.impl, parent.impl));
+	impl->send_command(CL_SoundCommand(CL_SoundCommand::type_add_bus, impl));
+}
+
+CL_SoundBus::CL_SoundBus(const CL_SharedPtr<CL_SoundBus_Impl> &impl)
+: impl(impl)
+{
+}
+
+CL_SoundBus::~CL_SoundBus()
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundBus attributes:
+
+void CL_SoundBus::throw_if_null() const
+{
+	if (!impl)
+		throw CL_Exception("CL_SoundBus is null");
+}
+
+CL_SoundBus CL_SoundBus::get_parent() const
+{
+	if (impl)
+		return CL_SoundBus(impl->parent);
+	else
+		return CL_SoundBus();
+}
+
+float CL_SoundBus::get_volume() const
+{
+	if (impl)
+	{
+		CL_MutexSection mutex_lock(&impl->mutex);
+		return impl->settings.volume;
+	}
+	else
+	{
+		return 0.0f;
+	}
+}
+
+float CL_SoundBus::get_pan() const
+{
+	if (impl)
+	{
+		CL_MutexSection mutex_lock(&impl->mutex);
+		return impl->settings.pan;
+	}
+	else
+	{
+		return 0.0f;
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundBus operations:
+
+void CL_SoundBus::set_volume(float new_volume)
+{
+	if (impl)
+	{
+		CL_MutexSection mutex_lock(&impl->mutex);
+		impl->settings.volume = new_volume;
+		impl->send_command(CL_SoundCommand(CL_SoundCommand::type_bus_set_volume, impl, new_volume));
+	}
+}
+
+void CL_SoundBus::set_pan(float new_pan)
+{
+	if (impl)
+	{
+		CL_MutexSection mutex_lock(&impl->mutex);
+		impl->settings.pan = new_pan;
+		impl->send_command(CL_SoundCommand(CL_SoundCommand::type_bus_set_pan, impl, new_pan));
+	}
+}
+
+void CL_SoundBus::add_filter(CL_SoundFilter &filter)
+{
+	if (impl)
+	{
+		CL_SoundCommand command(CL_SoundCommand::type_bus_add_filter, impl);
+		command.filter = filter;
+		impl->send_command(command);
+	}
+}
+
+void CL_SoundBus::remove_filter(CL_SoundFilter &filter)
+{
+	if (impl)
+	{
+		CL_SoundCommand command(CL_SoundCommand::type_bus_remove_filter, impl);
+		command.filter = filter;
+		impl->send_command(command);
+	}
+}
@@ -0,0 +1,164 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#include "Sound/precomp.h"
+#include "soundbus_impl.h"
+#include "soundoutput_impl.h"
+#include "sound_command_queue.h"
+#include "API/Sound/sound_sse.h"
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundBus_Impl construction:
+
+CL_SoundBus_Impl::CL_SoundBus_Impl(const CL_SharedPtr<CL_SoundOutput_Impl> &output, const CL_SharedPtr<CL_SoundBus_Impl> &parent)
+: output(output), parent(parent), depth(0), volume(1.0f), pan(0.0f), mix_buffer_size(0), has_input(false), mixer_index(0)
+{
+	if (parent)
+		depth = parent->depth + 1;
+
+	mix_buffers[0] = 0;
+	mix_buffers[1] = 0;
+	get_channel_volume(last_channel_volume);
+
+	settings.volume = volume;
+	settings.pan = pan;
+}
+
+CL_SoundBus_Impl::~CL_SoundBus_Impl()
+{
+	free_mix_buffers();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundBus_Impl operations:
+
+void CL_SoundBus_Impl::send_command(const CL_SoundCommand &command)
+{
+	CL_SharedPtr<CL_SoundOutput_Impl> output_impl = output.lock();
+	if (output_impl)
+		output_impl->send_command(command);
+}
+
+void CL_SoundBus_Impl::apply_command(const CL_SoundCommand &command)
+{
+	switch (command.type)
+	{
+	case CL_SoundCommand::type_bus_set_volume:
+		volume = command.float_value;
+		break;
+
+	case CL_SoundCommand::type_bus_set_pan:
+		pan = command.float_value;
+		break;
+
+	case CL_SoundCommand::type_bus_add_filter:
+		filters.push_back(command.filter);
+		break;
+
+	case CL_SoundCommand::type_bus_remove_filter:
+		for (std::vector<CL_SoundFilter>::size_type i = 0; i < filters.size(); i++)
+		{
+			if (filters[i] == command.filter)
+			{
+				filters.erase(filters.begin() + i);
+				break;
+			}
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+void CL_SoundBus_Impl::begin_fragment(int size)
+{
+	if (size != mix_buffer_size)
+	{
+		free_mix_buffers();
+		mix_buffers[0] = (float *) CL_SoundSSE::aligned_alloc(sizeof(float) * size);
+		mix_buffers[1] = (float *) CL_SoundSSE::aligned_alloc(sizeof(float) * size);
+		mix_buffer_size = size;
+	}
+
+	CL_SoundSSE::set_float(mix_buffers[0], mix_buffer_size, 0.0f);
+	CL_SoundSSE::set_float(mix_buffers[1], mix_buffer_size, 0.0f);
+	has_input = false;
+}
+
+void CL_SoundBus_Impl::run_filters()
+{
+	int size_filters = filters.size();
+	for (int i = 0; i < size_filters; i++)
+		filters[i].filter(mix_buffers, mix_buffer_size, 2);
+}
+
+void CL_SoundBus_Impl::mix_to(float **output_buffers)
+{
+	float channel_volume[2];
+	get_channel_volume(channel_volume);
+
+	for (int channel = 0; channel < 2; channel++)
+	{
+		if (channel_volume[channel] != last_channel_volume[channel])
+			CL_SoundSSE::mix_one_to_one_ramp(mix_buffers[channel], mix_buffer_size, output_buffers[channel], last_channel_volume[channel], channel_volume[channel]);
+		else if (channel_volume[channel] != 0.0f)
+			CL_SoundSSE::mix_one_to_one(mix_buffers[channel], mix_buffer_size, output_buffers[channel], channel_volume[channel]);
+		last_channel_volume[channel] = channel_volume[channel];
+	}
+}
+
+void CL_SoundBus_Impl::skip()
+{
+	get_channel_volume(last_channel_volume);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundBus_Impl implementation:
+
+void CL_SoundBus_Impl::get_channel_volume(float *channel_volume)
+{
+	float left_pan = 1-pan;
+	float right_pan = 1+pan;
+	if (left_pan < 0.0f) left_pan = 0.0f;
+	if (left_pan > 1.0f) left_pan = 1.0f;
+	if (right_pan < 0.0f) right_pan = 0.0f;
+	if (right_pan > 1.0f) right_pan = 1.0f;
+	if (volume < 0.0f) volume = 0.0f;
+	if (volume > 1.0f) volume = 1.0f;
+
+	channel_volume[0] = volume * left_pan;
+	channel_volume[1] = volume * right_pan;
+}
+
+void CL_SoundBus_Impl::free_mix_buffers()
+{
+	CL_SoundSSE::aligned_free(mix_buffers[0]); mix_buffers[0] = 0;
+	CL_SoundSSE::aligned_free(mix_buffers[1]); mix_buffers[1] = 0;
+	mix_buffer_size = 0;
+}
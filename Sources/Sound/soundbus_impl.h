@@ -0,0 +1,131 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#pragma once
+
+#include <vector>
+#include "API/Core/System/sharedptr.h"
+#include "API/Core/System/weakptr.h"
+#include "API/Core/System/mutex.h"
+#include "API/Sound/soundfilter.h"
+
+class CL_SoundOutput_Impl;
+class CL_SoundCommand;
+
+class CL_SoundBus_Impl
+{
+/// \name Construction
+/// \{
+
+public:
+	CL_SoundBus_Impl(const CL_SharedPtr<CL_SoundOutput_Impl> &output, const CL_SharedPtr<CL_SoundBus_Impl> &parent);
+
+	~CL_SoundBus_Impl();
+
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	/// \brief Bus settings as last set through CL_SoundBus
+	struct Settings
+	{
+		float volume;
+		float pan;
+	};
+
+	/// \brief Output the bus is mixed by. Weak, as the output keeps its buses alive.
+	CL_WeakPtr<CL_SoundOutput_Impl> output;
+
+	/// \brief Bus this bus is mixed into, or null for the output. Never changes after construction.
+	CL_SharedPtr<CL_SoundBus_Impl> parent;
+
+	/// \brief Number of parent buses. Never changes after construction.
+	int depth;
+
+	/// \brief Guards settings between API callers. Never locked by the mixer thread.
+	mutable CL_Mutex mutex;
+	Settings settings;
+
+	// The following are only accessed by the mixer thread once the bus has been created:
+	float volume;
+	float pan;
+	std::vector<CL_SoundFilter> filters;
+
+	/// \brief Stereo sub-mix of the current fragment.
+	float *mix_buffers[2];
+	int mix_buffer_size;
+
+	/// \brief True if a session or bus was mixed into this bus in the current fragment.
+	bool has_input;
+
+	/// \brief Position of the bus in the list of buses of the output, updated every fragment.
+	int mixer_index;
+
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	/// \brief Queues a change for the mixer thread of the output.
+	void send_command(const CL_SoundCommand &command);
+
+	/// \brief Applies a command sent from CL_SoundBus. Called by the mixer thread.
+	void apply_command(const CL_SoundCommand &command);
+
+	/// \brief Clears the sub-mix for a new fragment.
+	void begin_fragment(int size);
+
+	/// \brief Returns true if the bus has something to mix this fragment, including filter tails.
+	bool is_active() const { return has_input || !filters.empty(); }
+
+	/// \brief Runs the filters of the bus on the sub-mix.
+	void run_filters();
+
+	/// \brief Mixes the sub-mix into output_buffers with the volume and pan of the bus.
+	void mix_to(float **output_buffers);
+
+	/// \brief Skips mixing an inactive bus, so a later volume change ramps from the current volume.
+	void skip();
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	/// \brief Returns the volume of left and right channel
+	void get_channel_volume(float *channel_volume);
+
+	void free_mix_buffers();
+
+	/// \brief Channel volumes used at the end of the previous fragment, where volume ramps start.
+	float last_channel_volume[2];
+/// \}
+};
@@ -33,6 +33,7 @@
 #include "API/Sound/sound.h"
 #include "API/Core/System/thread.h"
 #include "soundoutput_impl.h"
+#include "Offline/soundoutput_offline.h"
 
 #ifdef WIN32
 #include "Win32/soundoutput_directsound.h"
@@ -65,6 +66,14 @@ CL_SoundOutput::CL_SoundOutput(int mixing_frequency, int latency)
 
 CL_SoundOutput::CL_SoundOutput(const CL_SoundOutput_Description &desc)
 {
+	if (desc.is_offline())
+	{
+		CL_SharedPtr<CL_SoundOutput_Impl> soundoutput_impl(new CL_SoundOutput_Offline(desc.get_mixing_frequency(), desc.get_mixing_latency(), desc.get_offline_speed(), desc.get_offline_filename()));
+		impl = soundoutput_impl;
+		CL_Sound::select_output(*this);
+		return;
+	}
+
 #ifdef WIN32
 	CL_SharedPtr<CL_SoundOutput_Impl> soundoutput_impl(new CL_SoundOutput_DirectSound(desc.get_mixing_frequency(), desc.get_mixing_latency()));
 	impl = soundoutput_impl;
@@ -147,6 +156,11 @@ float CL_SoundOutput::get_global_pan() const
 	return impl->pan;
 }
 
+CL_SoundOutput_Statistics CL_SoundOutput::get_statistics() const
+{
+	return impl->get_statistics();
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_SoundOutput operations:
 
@@ -181,6 +195,18 @@ void CL_SoundOutput::add_filter(CL_SoundFilter &filter)
 	}
 }
 
+void CL_SoundOutput::reset_statistics()
+{
+	if (impl)
+		impl->reset_statistics();
+}
+
+void CL_SoundOutput::render_fragments(int num_fragments)
+{
+	throw_if_null();
+	impl->render_fragments(num_fragments);
+}
+
 void CL_SoundOutput::remove_filter(CL_SoundFilter &filter)
 {
 	if (impl)
@@ -39,6 +39,12 @@ public:
 	int mixing_frequency;
 
 	int mixing_latency;
+
+	bool offline;
+
+	float offline_speed;
+
+	CL_String offline_filename;
 };
 
 /////////////////////////////////////////////////////////////////////////////
@@ -48,6 +54,8 @@ CL_SoundOutput_Description::CL_SoundOutput_Description() : impl(new CL_SoundOutp
 {
 	impl->mixing_frequency = 44100;
 	impl->mixing_latency = 50;
+	impl->offline = false;
+	impl->offline_speed = 0.0f;
 }
 
 CL_SoundOutput_Description::~CL_SoundOutput_Description()
@@ -67,6 +75,21 @@ int CL_SoundOutput_Description::get_mixing_latency() const
 	return impl->mixing_latency;
 }
 
+bool CL_SoundOutput_Description::is_offline() const
+{
+	return impl->offline;
+}
+
+float CL_SoundOutput_Description::get_offline_speed() const
+{
+	return impl->offline_speed;
+}
+
+CL_String CL_SoundOutput_Description::get_offline_filename() const
+{
+	return impl->offline_filename;
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_SoundOutput_Description operations:
 
@@ -80,5 +103,20 @@ void CL_SoundOutput_Description::set_mixing_latency(int latency)
 	impl->mixing_latency = latency;
 }
 
+void CL_SoundOutput_Description::set_offline(bool enable)
+{
+	impl->offline = enable;
+}
+
+void CL_SoundOutput_Description::set_offline_speed(float speed)
+{
+	impl->offline_speed = speed;
+}
+
+void CL_SoundOutput_Description::set_offline_filename(const CL_String &filename)
+{
+	impl->offline_filename = filename;
+}
+
 // CL_SoundOutput_Description implementation:
 /////////////////////////////////////////////////////////////////////////////
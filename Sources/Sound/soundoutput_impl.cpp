@@ -29,9 +29,11 @@
 #include "Sound/precomp.h"
 #include "soundoutput_impl.h"
 #include "soundbuffer_session_impl.h"
+#include "soundbus_impl.h"
 #include "API/Sound/soundfilter.h"
 #include <algorithm>
 #include "API/Sound/sound_sse.h"
+#include "API/Core/System/system.h"
 
 CL_Mutex CL_SoundOutput_Impl::singleton_mutex;
 CL_SoundOutput_Impl *CL_SoundOutput_Impl::instance = 0;
@@ -77,24 +79,47 @@ CL_SoundOutput_Impl::~CL_SoundOutput_Impl()
 
 void CL_SoundOutput_Impl::play_session(CL_SoundBuffer_Session &session)
 {
-	CL_MutexSection mutex_lock(&mutex);
-	sessions.push_back(session);
+	send_command(CL_SoundCommand(CL_SoundCommand::type_play, session.impl));
 }
 
 void CL_SoundOutput_Impl::stop_session(CL_SoundBuffer_Session &session)
 {
-	CL_MutexSection mutex_lock(&mutex);
+	send_command(CL_SoundCommand(CL_SoundCommand::type_stop, session.impl));
+}
+
+void CL_SoundOutput_Impl::send_command(const CL_SoundCommand &command)
+{
+	commands.push(command);
+}
+
+void CL_SoundOutput_Impl::render_fragments(int num_fragments)
+{
+	throw CL_Exception("Only offline sound outputs can render fragments on request");
+}
+
+CL_SoundOutput_Statistics CL_SoundOutput_Impl::get_statistics() const
+{
+	if (statistics_resets_requested.get() != statistics_resets_published.get())
+		return CL_SoundOutput_Statistics();
 
-	for (std::vector<CL_SoundBuffer_Session>::iterator it = sessions.begin(); it != sessions.end(); ++it)
+	// Retry if the mixer published new statistics while they were copied:
+	while (true)
 	{
-		if (session.impl.get() == it->impl.get())
+		int sequence = statistics_sequence.get();
+		if ((sequence & 1) == 0)
 		{
-			sessions.erase(it);
-			break;
+			CL_SoundOutput_Statistics result = published_statistics;
+			if (statistics_sequence.get() == sequence)
+				return result;
 		}
 	}
 }
 
+void CL_SoundOutput_Impl::reset_statistics()
+{
+	statistics_resets_requested.increment();
+}
+
 void CL_SoundOutput_Impl::start_mixer_thread()
 {
 	thread.start(this, &CL_SoundOutput_Impl::mixer_thread);
@@ -112,6 +137,7 @@ void CL_SoundOutput_Impl::stop_mixer_thread()
 
 void CL_SoundOutput_Impl::mix_fragment()
 {
+	apply_commands();
 	resize_mix_buffers();
 	clear_mix_buffers();
 	fill_mix_buffers();
@@ -121,6 +147,15 @@ void CL_SoundOutput_Impl::mix_fragment()
 	CL_SoundSSE::pack_float_stereo(mix_buffers, mix_buffer_size, stereo_buffer);
 }
 
+void CL_SoundOutput_Impl::render_fragment()
+{
+	cl_ubyte64 start_time = CL_System::get_microseconds();
+	mix_fragment();
+	update_statistics((int) (CL_System::get_microseconds() - start_time));
+
+	write_fragment(stereo_buffer);
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_SoundOutput_Impl implementation:
 
@@ -130,11 +165,8 @@ void CL_SoundOutput_Impl::mixer_thread()
     
 	while (if_continue_mixing())
 	{
-		// Mix some audio:
-		mix_fragment();
-
-		// Send mixed data to sound card:
-		write_fragment(stereo_buffer);
+		// Mix some audio and send it to the sound card:
+		render_fragment();
 
 		// Wait for sound card to want more:
 		wait();
@@ -175,6 +207,55 @@ void CL_SoundOutput_Impl::resize_mix_buffers()
 	}
 }
 
+void CL_SoundOutput_Impl::apply_commands()
+{
+	CL_SoundCommand command;
+	while (commands.pop(command))
+	{
+		if (!command.session)
+		{
+			if (command.type == CL_SoundCommand::type_add_bus)
+			{
+				// Keep the deepest buses first:
+				std::vector< CL_SharedPtr<CL_SoundBus_Impl> >::iterator it;
+				for (it = buses.begin(); it != buses.end(); ++it)
+				{
+					if ((*it)->depth < command.bus->depth)
+						break;
+				}
+				buses.insert(it, command.bus);
+			}
+			else
+			{
+				command.bus->apply_command(command);
+			}
+			continue;
+		}
+
+		CL_SoundBuffer_Session_Impl *session_impl = command.session.get();
+		bool was_playing = session_impl->playing;
+		session_impl->apply_command(command);
+
+		if (!was_playing && session_impl->playing)
+		{
+			CL_SoundBuffer_Session session;
+			session.impl = command.session;
+			sessions.push_back(session);
+		}
+		else if (was_playing && !session_impl->playing)
+		{
+			for (std::vector<CL_SoundBuffer_Session>::iterator it = sessions.begin(); it != sessions.end(); ++it)
+			{
+				if (it->impl.get() == session_impl)
+				{
+					sessions.erase(it);
+					break;
+				}
+			}
+		}
+	}
+}
+
 void CL_SoundOutput_Impl::clear_mix_buffers()
 {
 	// Clear channel mixing buffers:
@@ -182,21 +263,160 @@ void CL_SoundOutput_Impl::clear_mix_buffers()
 	CL_SoundSSE::set_float(mix_buffers[1], mix_buffer_size, 0.0f);
 }
 
+void CL_SoundOutput_Impl::prepare_buses()
+{
+	// Release buses only referenced by the output. Child buses come before their parents,
+	// so an unused branch is released in a single pass:
+	int num_buses = 0;
+	int size_buses = buses.size();
+	for (int i = 0; i < size_buses; i++)
+	{
+		if (buses[i].use_count() == 1)
+		{
+			buses[i].reset();
+		}
+		else
+		{
+			if (num_buses != i)
+				buses[num_buses] = buses[i];
+			buses[num_buses]->mixer_index = num_buses;
+			buses[num_buses]->begin_fragment(mix_buffer_size);
+			num_buses++;
+		}
+	}
+	buses.erase(buses.begin() + num_buses, buses.end());
+}
+
 void CL_SoundOutput_Impl::fill_mix_buffers()
 {
-	CL_MutexSection mutex_lock(&mutex);
-	std::vector< CL_SoundBuffer_Session > ended_sessions;
-	std::vector< CL_SoundBuffer_Session >::iterator it;
-	for (it = sessions.begin(); it != sessions.end(); ++it)
+	prepare_buses();
+
+	// Sessions are mixed one bus at a time:
+	std::stable_sort(sessions.begin(), sessions.end(), &CL_SoundOutput_Impl::compare_session_bus);
+
+	int size_sessions = sessions.size();
+	mix_sessions_playing.resize(size_sessions);
+
+	int begin = 0;
+	while (begin < size_sessions)
+	{
+		CL_SoundBus_Impl *bus = sessions[begin].impl->bus.get();
+		int end = begin + 1;
+		while (end < size_sessions && sessions[end].impl->bus.get() == bus)
+			end++;
+
+		// A filter object may be attached to several sessions, so sessions with filters are
+		// placed first and always mixed on this thread:
+		int num_serial = 0;
+		for (int i = begin; i < end; i++)
+		{
+			if (!sessions[i].impl->filters.empty())
+			{
+				std::swap(sessions[begin + num_serial], sessions[i]);
+				num_serial++;
+			}
+		}
+
+		if (bus)
+		{
+			mix_pool.mix(sessions, begin, end, num_serial, mix_sessions_playing, bus->mix_buffers, temp_buffers, mix_buffer_size, mixing_frequency);
+			bus->has_input = true;
+		}
+		else
+		{
+			mix_pool.mix(sessions, begin, end, num_serial, mix_sessions_playing, mix_buffers, temp_buffers, mix_buffer_size, mixing_frequency);
+		}
+
+		begin = end;
+	}
+
+	mix_buses();
+
+	// Release sessions that reached their end:
+	int num_playing = 0;
+	for (int i = 0; i < size_sessions; i++)
+	{
+		if (mix_sessions_playing[i])
+		{
+			if (num_playing != i)
+				sessions[num_playing] = sessions[i];
+			num_playing++;
+		}
+		else
+		{
+			sessions[i].impl->shared_playing.set(0);
+		}
+	}
+	sessions.erase(sessions.begin() + num_playing, sessions.end());
+}
+
+void CL_SoundOutput_Impl::mix_buses()
+{
+	// Buses at the same depth never feed each other, so a level is filtered as a whole
+	// before it is mixed into the level above it:
+	int size_buses = buses.size();
+	int begin = 0;
+	while (begin < size_buses)
 	{
-		CL_SoundBuffer_Session session = *it;
-		bool playing = session.impl->mix_to(mix_buffers, temp_buffers, mix_buffer_size, 2);
-		if (!playing) ended_sessions.push_back(session);
+		int depth = buses[begin]->depth;
+		int end = begin;
+		active_buses.clear();
+		while (end < size_buses && buses[end]->depth == depth)
+		{
+			CL_SoundBus_Impl *bus = buses[end].get();
+			if (bus->is_active())
+				active_buses.push_back(bus);
+			else
+				bus->skip();
+			end++;
+		}
+
+		mix_pool.run_bus_filters(active_buses, !has_shared_bus_filters(), mix_buffer_size, mixing_frequency);
+
+		int size_active = active_buses.size();
+		for (int i = 0; i < size_active; i++)
+		{
+			CL_SoundBus_Impl *bus = active_buses[i];
+			if (bus->parent)
+			{
+				bus->mix_to(bus->parent->mix_buffers);
+				bus->parent->has_input = true;
+			}
+			else
+			{
+				bus->mix_to(mix_buffers);
+			}
+		}
+
+		begin = end;
 	}
+	active_buses.clear();
+}
 
-	// Release any sessions pending for removal:
-	int size_ended_sessions = ended_sessions.size();
-	for (int i = 0; i < size_ended_sessions; i++) stop_session(ended_sessions[i]);
+bool CL_SoundOutput_Impl::has_shared_bus_filters() const
+{
+	int size_active = active_buses.size();
+	for (int i = 0; i < size_active; i++)
+	{
+		const std::vector<CL_SoundFilter> &filters_i = active_buses[i]->filters;
+		for (int j = i + 1; j < size_active; j++)
+		{
+			const std::vector<CL_SoundFilter> &filters_j = active_buses[j]->filters;
+			for (std::vector<CL_SoundFilter>::size_type a = 0; a < filters_i.size(); a++)
+			{
+				if (std::find(filters_j.begin(), filters_j.end(), filters_i[a]) != filters_j.end())
+					return true;
+			}
+		}
+	}
+	return false;
+}
+
+bool CL_SoundOutput_Impl::compare_session_bus(const CL_SoundBuffer_Session &a, const CL_SoundBuffer_Session &b)
+{
+	int index_a = a.impl->bus ? a.impl->bus->mixer_index : -1;
+	int index_b = b.impl->bus ? b.impl->bus->mixer_index : -1;
+	return index_a < index_b;
 }
 
 void CL_SoundOutput_Impl::filter_mix_buffers()
@@ -242,3 +462,33 @@ void CL_SoundOutput_Impl::clamp_mix_buffers()
 		}
 	}
 }
+
+void CL_SoundOutput_Impl::update_statistics(int mix_time)
+{
+	int fragment_time = (int) (mix_buffer_size * (cl_ubyte64) 1000000 / mixing_frequency);
+
+	int resets_requested = statistics_resets_requested.get();
+	bool reset = (resets_requested != statistics_resets_published.get());
+	if (reset)
+		statistics = CL_SoundOutput_Statistics();
+
+	statistics.fragment_size = mix_buffer_size;
+	if (statistics.num_fragments == 0 || mix_time < statistics.min_mix_time)
+		statistics.min_mix_time = mix_time;
+	if (mix_time > statistics.max_mix_time)
+		statistics.max_mix_time = mix_time;
+	if (mix_time > fragment_time)
+		statistics.num_late_fragments++;
+	statistics.last_mix_time = mix_time;
+	statistics.total_mix_time += mix_time;
+	statistics.num_fragments++;
+
+	// An odd sequence number tells readers the copy is being written:
+	statistics_sequence.increment();
+	published_statistics = statistics;
+	statistics_sequence.increment();
+
+	// Readers see zeroed statistics until the reset is published:
+	if (reset)
+		statistics_resets_published.set(resets_requested);
+}
@@ -35,10 +35,15 @@
 #include "API/Core/System/mutex.h"
 #include "API/Core/System/event.h"
 #include "API/Core/System/sharedptr.h"
+#include "API/Core/System/interlocked_variable.h"
+#include "API/Sound/soundoutput.h"
+#include "sound_mix_pool.h"
+#include "sound_command_queue.h"
 
 class CL_SoundFilter;
 class CL_SoundBuffer_Session_Impl;
 class CL_SoundBuffer_Session;
+class CL_SoundBus_Impl;
 
 class CL_SoundOutput_Impl
 {
@@ -72,8 +77,23 @@ public:
 
 	CL_Event stop_mixer;
 
+	/// \brief Sessions being mixed. Only accessed by the mixer thread.
 	std::vector< CL_SoundBuffer_Session > sessions;
 
+	/// \brief Whether each of the sessions is still playing after the current fragment
+	std::vector< char > mix_sessions_playing;
+
+	/// \brief Buses of the output, deepest first. Only accessed by the mixer thread.
+	std::vector< CL_SharedPtr<CL_SoundBus_Impl> > buses;
+
+	/// \brief Buses of the level currently being mixed by mix_buses()
+	std::vector< CL_SoundBus_Impl * > active_buses;
+
+	/// \brief Session changes waiting to be applied by the mixer thread
+	CL_SoundCommandQueue commands;
+
+	CL_SoundMixPool mix_pool;
+
 	mutable CL_Mutex mutex;
 
 	int mix_buffer_size;
@@ -84,6 +104,17 @@ public:
 
 	float *stereo_buffer;
 
+	/// \brief Mixing time measurements. Only accessed by the mixer thread.
+	CL_SoundOutput_Statistics statistics;
+
+	/// \brief Copy of statistics for other threads, complete whenever statistics_sequence is even
+	CL_SoundOutput_Statistics published_statistics;
+	CL_InterlockedVariable statistics_sequence;
+
+	/// \brief Counts reset_statistics() calls, and the ones the mixer has published
+	CL_InterlockedVariable statistics_resets_requested;
+	CL_InterlockedVariable statistics_resets_published;
+
 
 /// \}
 /// \name Operations
@@ -95,6 +126,18 @@ public:
 
 	void stop_session(CL_SoundBuffer_Session &session);
 
+	/// \brief Queues a session change for the mixer thread. Never waits for mixing to finish.
+	void send_command(const CL_SoundCommand &command);
+
+	/// \brief Mixes and writes fragments on the calling thread, for outputs without a mixer thread.
+	virtual void render_fragments(int num_fragments);
+
+	/// \brief Returns the statistics last published by the mixer. Never waits for the mixer.
+	CL_SoundOutput_Statistics get_statistics() const;
+
+	/// \brief Makes the mixer start its measurements over
+	void reset_statistics();
+
 protected:
 	/// \brief Called when we have no samples to play - and wants to tell the soundcard
 	/// \brief about this possible event.
@@ -124,6 +167,9 @@ protected:
 	/// \brief Mixes a single fragment and stores the result in stereo_buffer.
 	void mix_fragment();
 
+	/// \brief Mixes a single fragment, measures the time spent and writes it with write_fragment().
+	void render_fragment();
+
 /// \}
 /// \name Implementation
 /// \{
@@ -138,12 +184,27 @@ private:
 	/// \brief Ensures the mixing buffers match the fragment size
 	void resize_mix_buffers();
 
+	/// \brief Applies the queued session commands
+	void apply_commands();
+
 	/// \brief Clears the content of the mixing buffers
 	void clear_mix_buffers();
 
+	/// \brief Releases unused buses and clears the sub-mix of the others
+	void prepare_buses();
+
 	/// \brief Mixes soundbuffer sessions into the mixing buffers
 	void fill_mix_buffers();
 
+	/// \brief Filters the buses and mixes them into their parents, one level at a time
+	void mix_buses();
+
+	/// \brief Returns true if a filter object is attached to more than one of the active buses
+	bool has_shared_bus_filters() const;
+
+	/// \brief Orders sessions by the bus they are routed to, sessions without a bus first
+	static bool compare_session_bus(const CL_SoundBuffer_Session &a, const CL_SoundBuffer_Session &b);
+
 	/// \brief Applies filters to the mixing buffers
 	void filter_mix_buffers();
 
@@ -153,6 +214,9 @@ private:
 	/// \brief Clamp mixing buffer values to the -1 to 1 range
 	void clamp_mix_buffers();
 
+	/// \brief Adds the time spent mixing a fragment to the statistics
+	void update_statistics(int mix_time);
+
 	static CL_Mutex singleton_mutex;
 	static CL_SoundOutput_Impl *instance;
 /// \}
@@ -41,36 +41,23 @@
 CL_SqliteCommandProvider::CL_SqliteCommandProvider(CL_SqliteConnectionProvider *connection, const CL_StringRef &text)
 : connection(connection), text(text), vm(0), last_insert_rowid(-1)
 {
-	CL_String t = text;
-	if (t.empty() || t[t.length()-1] != ';')
-		t += ";";
-	const CL_String::char_type *tail = 0;
-	int result;
-	for (int i = 0; i < 1000; i++)
-	{
-		result = sqlite3_prepare(connection->db, t.data(), t.length()*sizeof(CL_String::char_type), &vm, (const char **) &tail);
-		if (result != SQLITE_BUSY)
-			break;
-		CL_System::sleep(1);
-	}
-	throw_if_failed(result);
+	if (this->text.empty() || this->text[this->text.length()-1] != ';')
+		this->text += ";";
+	vm = connection->prepare_statement(this->text);
 }
 
 CL_SqliteCommandProvider::~CL_SqliteCommandProvider()
 {
 	if (connection->active_reader && connection->active_reader->vm == vm)
 	{
+		// The reader hands the statement back to the connection when it closes:
+		connection->active_reader->command = 0;
+		connection->active_reader->command_text = text;
 		connection->active_reader->destroy_command = true;
 	}
 	else
 	{
-		int result = sqlite3_finalize(vm);
-		if (result != SQLITE_OK)
-		{
-			const char *err = sqlite3_errmsg(connection->db);
-			CL_StringRef8 error = (err == 0) ? "Unknown error" : err;
-			throw CL_Exception(CL_StringHelp::local8_to_text(error));
-		}
+		connection->release_statement(text, vm);
 	}
 }
 
@@ -87,6 +74,11 @@ int CL_SqliteCommandProvider::get_output_last_insert_rowid() const
 	return last_insert_rowid;
 }
 
+int CL_SqliteCommandProvider::get_batch_size() const
+{
+	return batch.size();
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_SqliteCommandProvider Operations:
 
@@ -94,24 +86,35 @@ void CL_SqliteCommandProvider::set_input_parameter_string(int index, const CL_St
 {
 	int result = sqlite3_bind_text(vm, index, value.data(), value.length(), SQLITE_TRANSIENT);
 	throw_if_failed(result);
+
+	Parameter &parameter = get_parameter(index);
+	parameter.type = SQLITE_TEXT;
+	parameter.text = value;
 }
 
 void CL_SqliteCommandProvider::set_input_parameter_bool(int index, bool value)
 {
-	int result = sqlite3_bind_int(vm, index, value ? 1 : 0);
-	throw_if_failed(result);
+	set_input_parameter_int(index, value ? 1 : 0);
 }
 
 void CL_SqliteCommandProvider::set_input_parameter_int(int index, int value)
 {
 	int result = sqlite3_bind_int(vm, index, value);
 	throw_if_failed(result);
+
+	Parameter &parameter = get_parameter(index);
+	parameter.type = SQLITE_INTEGER;
+	parameter.int_value = value;
 }
 
 void CL_SqliteCommandProvider::set_input_parameter_double(int index, double value)
 {
 	int result = sqlite3_bind_double(vm, index, value);
 	throw_if_failed(result);
+
+	Parameter &parameter = get_parameter(index);
+	parameter.type = SQLITE_FLOAT;
+	parameter.double_value = value;
 }
 
 void CL_SqliteCommandProvider::set_input_parameter_datetime(int index, const CL_DateTime &value)
@@ -123,6 +126,15 @@ void CL_SqliteCommandProvider::set_input_parameter_binary(int index, const CL_Da
 {
 	int result = sqlite3_bind_blob(vm, index, value.get_data(), value.get_size(), SQLITE_TRANSIENT);
 	throw_if_failed(result);
+
+	Parameter &parameter = get_parameter(index);
+	parameter.type = SQLITE_BLOB;
+	parameter.blob = value;
+}
+
+void CL_SqliteCommandProvider::add_batch()
+{
+	batch.push_back(parameters);
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -136,3 +148,66 @@ void CL_SqliteCommandProvider::throw_if_failed(int result) const
 		throw CL_Exception(CL_StringHelp::local8_to_text(error));
 	}
 }
+
+CL_SqliteCommandProvider::Parameter &CL_SqliteCommandProvider::get_parameter(int index)
+{
+	if (index < 1)
+		throw CL_Exception("Index out of range");
+	if (index > (int) parameters.size())
+		parameters.resize(index);
+	return parameters[index - 1];
+}
+
+void CL_SqliteCommandProvider::bind_row(const std::vector<Parameter> &row, sqlite3_destructor_type destructor)
+{
+	int size = row.size();
+	for (int i = 0; i < size; i++)
+	{
+		const Parameter &parameter = row[i];
+		int result;
+		switch (parameter.type)
+		{
+		case SQLITE_INTEGER:
+			result = sqlite3_bind_int(vm, i + 1, parameter.int_value);
+			break;
+		case SQLITE_FLOAT:
+			result = sqlite3_bind_double(vm, i + 1, parameter.double_value);
+			break;
+		case SQLITE_TEXT:
+			result = sqlite3_bind_text(vm, i + 1, parameter.text.data(), parameter.text.length(), destructor);
+			break;
+		case SQLITE_BLOB:
+			result = sqlite3_bind_blob(vm, i + 1, parameter.blob.get_data(), parameter.blob.get_size(), destructor);
+			break;
+		default:
+			result = sqlite3_bind_null(vm, i + 1);
+			break;
+		}
+		throw_if_failed(result);
+	}
+}
+
+void CL_SqliteCommandProvider::execute_batch_rows()
+{
+	// The rows stay alive until the current parameters are bound again, so their values are not copied:
+	CL_String8 error;
+	int size = batch.size();
+	for (int i = 0; i < size && error.empty(); i++)
+	{
+		bind_row(batch[i], SQLITE_STATIC);
+		int result = sqlite3_step(vm);
+		if (result == SQLITE_BUSY)
+			error = "Database Busy!";
+		else if (result != SQLITE_DONE && result != SQLITE_ROW)
+			error = sqlite3_errmsg(connection->db);
+		sqlite3_reset(vm);
+	}
+
+	batch.clear();
+	sqlite3_clear_bindings(vm);
+	bind_row(parameters, SQLITE_TRANSIENT);
+
+	if (!error.empty())
+		throw CL_Exception(CL_StringHelp::local8_to_text(error));
+	last_insert_rowid = sqlite3_last_insert_rowid(connection->db);
+}
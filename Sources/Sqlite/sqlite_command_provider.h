@@ -33,8 +33,10 @@
 #pragma once
 
 
+#include <vector>
 #include "sqlite3.h"
 #include "API/Database/db_command_provider.h"
+#include "API/Core/System/databuffer.h"
 
 class CL_SqliteConnectionProvider;
 
@@ -53,6 +55,7 @@ public:
 public:
 	int get_input_parameter_column(const CL_StringRef &name) const;
 	int get_output_last_insert_rowid() const;
+	int get_batch_size() const;
 /// \}
 
 /// \name Operations
@@ -64,18 +67,48 @@ public:
 	void set_input_parameter_double(int index, double value);
 	void set_input_parameter_datetime(int index, const CL_DateTime &value);
 	void set_input_parameter_binary(int index, const CL_DataBuffer &value);
+	void add_batch();
 /// \}
 
 /// \name Implementation
 /// \{
 private:
+	/// \brief Value of an input parameter, as bound to the statement
+	struct Parameter
+	{
+		Parameter() : type(SQLITE_NULL), int_value(0), double_value(0.0) { }
+
+		int type;
+		int int_value;
+		double double_value;
+		CL_String8 text;
+		CL_DataBuffer blob;
+	};
+
 	void throw_if_failed(int result) const;
 
+	/// \brief Returns the recorded value of an input parameter, adding it if needed
+	Parameter &get_parameter(int index);
+
+	/// \brief Binds a row of input parameter values to the statement
+	void bind_row(const std::vector<Parameter> &row, sqlite3_destructor_type destructor);
+
+	/// \brief Executes the statement for each row of the batch and clears the batch
+	void execute_batch_rows();
+
 	CL_SqliteConnectionProvider *connection;
 	CL_String text;
 	sqlite3_stmt *vm;
 	int last_insert_rowid;
 
+	/// \brief Current input parameter values, in the order of their index
+	std::vector<Parameter> parameters;
+
+	/// \brief Rows added with add_batch()
+	std::vector< std::vector<Parameter> > batch;
+
+	friend class CL_SqliteConnectionProvider;
+
 	friend class CL_SqliteReaderProvider;
 /// \}
 };
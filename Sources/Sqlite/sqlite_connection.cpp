@@ -48,5 +48,15 @@ CL_SqliteConnection::~CL_SqliteConnection()
 /////////////////////////////////////////////////////////////////////////////
 // CL_DBConnection Operations:
 
+void CL_SqliteConnection::set_busy_timeout(int milliseconds)
+{
+	static_cast<CL_SqliteConnectionProvider *>(get_provider())->set_busy_timeout(milliseconds);
+}
+
+void CL_SqliteConnection::set_statement_cache_size(int size)
+{
+	static_cast<CL_SqliteConnectionProvider *>(get_provider())->set_statement_cache_size(size);
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_DBConnection Implementation:
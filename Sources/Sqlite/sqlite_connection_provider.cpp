@@ -41,7 +41,7 @@
 // CL_SqliteConnectionProvider Construction:
 
 CL_SqliteConnectionProvider::CL_SqliteConnectionProvider(const CL_StringRef &db_filename)
-: active_transaction(0), active_reader(0), db(0)
+: active_transaction(0), active_reader(0), db(0), statement_cache_size(default_statement_cache_size)
 {
 	int result = sqlite3_open(CL_StringHelp::text_to_utf8(db_filename).c_str(), &db);
 	if (result != SQLITE_OK)
@@ -50,6 +50,9 @@ CL_SqliteConnectionProvider::CL_SqliteConnectionProvider(const CL_StringRef &db_
 			sqlite3_close(db);
 		throw CL_Exception("Unable to open database");
 	}
+
+	// Let sqlite sleep until a lock is released, instead of failing immediately with SQLITE_BUSY:
+	sqlite3_busy_timeout(db, default_busy_timeout);
 }
 
 CL_SqliteConnectionProvider::~CL_SqliteConnectionProvider()
@@ -59,6 +62,7 @@ CL_SqliteConnectionProvider::~CL_SqliteConnectionProvider()
 	if (active_transaction)
 		active_transaction->connection = 0;
 
+	trim_statement_cache(0);
 	sqlite3_close(db);
 }
 
@@ -69,6 +73,17 @@ CL_SqliteConnectionProvider::~CL_SqliteConnectionProvider()
 /////////////////////////////////////////////////////////////////////////////
 // CL_SqliteConnectionProvider Operations:
 
+void CL_SqliteConnectionProvider::set_busy_timeout(int milliseconds)
+{
+	sqlite3_busy_timeout(db, milliseconds);
+}
+
+void CL_SqliteConnectionProvider::set_statement_cache_size(int size)
+{
+	statement_cache_size = size;
+	trim_statement_cache(statement_cache_size);
+}
+
 CL_DBCommandProvider *CL_SqliteConnectionProvider::create_command(const CL_StringRef &text, CL_DBCommand::Type type)
 {
 	if (type != CL_DBCommand::sql_statement)
@@ -120,6 +135,36 @@ void CL_SqliteConnectionProvider::execute_non_query(CL_DBCommandProvider *comman
 	reader->close();
 }
 
+void CL_SqliteConnectionProvider::execute_batch(CL_DBCommandProvider *command)
+{
+	CL_SqliteCommandProvider *sqlite_command = dynamic_cast<CL_SqliteCommandProvider*>(command);
+	if (active_reader)
+		throw CL_Exception("Only one database reader may be active for a connection");
+	if (sqlite_command->batch.empty())
+		return;
+
+	// Writing all rows in one savepoint avoids a journal sync per row, also inside a transaction:
+	execute_sql("SAVEPOINT cl_batch");
+	try
+	{
+		sqlite_command->execute_batch_rows();
+	}
+	catch (const CL_Exception &)
+	{
+		try
+		{
+			execute_sql("ROLLBACK TO cl_batch");
+			execute_sql("RELEASE cl_batch");
+		}
+		catch (const CL_Exception &)
+		{
+			// Some errors roll back the whole transaction, and the savepoint with it.
+		}
+		throw;
+	}
+	execute_sql("RELEASE cl_batch");
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_SqliteConnectionProvider Implementation:
 
@@ -143,3 +188,61 @@ int CL_SqliteConnectionProvider::string_to_int(const CL_String &str, int offset,
 {
 	return CL_StringHelp::text_to_int(str.substr(offset, length));
 }
+
+sqlite3_stmt *CL_SqliteConnectionProvider::prepare_statement(const CL_String &text)
+{
+	std::map<CL_String, StatementCache::iterator>::iterator it = statement_cache_index.find(text);
+	if (it != statement_cache_index.end())
+	{
+		sqlite3_stmt *vm = it->second->vm;
+		statement_cache.erase(it->second);
+		statement_cache_index.erase(it);
+		return vm;
+	}
+
+	// sqlite3_prepare_v2 statements prepare themselves again if the schema changes while they are cached:
+	sqlite3_stmt *vm = 0;
+	int result = sqlite3_prepare_v2(db, text.data(), text.length()*sizeof(CL_String::char_type), &vm, 0);
+	if (result != SQLITE_OK)
+	{
+		CL_String8 error = sqlite3_errmsg(db);
+		throw CL_Exception(CL_StringHelp::local8_to_text(error));
+	}
+	return vm;
+}
+
+void CL_SqliteConnectionProvider::release_statement(const CL_String &text, sqlite3_stmt *vm)
+{
+	// Keep only one statement per text:
+	if (statement_cache_size <= 0 || statement_cache_index.find(text) != statement_cache_index.end())
+	{
+		sqlite3_finalize(vm);
+		return;
+	}
+
+	sqlite3_reset(vm);
+	sqlite3_clear_bindings(vm);
+
+	CachedStatement cached;
+	cached.text = text;
+	cached.vm = vm;
+	statement_cache.push_front(cached);
+	statement_cache_index[text] = statement_cache.begin();
+	trim_statement_cache(statement_cache_size);
+}
+
+void CL_SqliteConnectionProvider::trim_statement_cache(int size)
+{
+	while ((int) statement_cache.size() > size)
+	{
+		sqlite3_finalize(statement_cache.back().vm);
+		statement_cache_index.erase(statement_cache.back().text);
+		statement_cache.pop_back();
+	}
+}
+
+void CL_SqliteConnectionProvider::execute_sql(const CL_String &text)
+{
+	CL_UniquePtr<CL_DBCommandProvider> command(create_command(text, CL_DBCommand::sql_statement));
+	execute_non_query(command.get());
+}
@@ -33,6 +33,8 @@
 #pragma once
 
 
+#include <list>
+#include <map>
 #include "sqlite3.h"
 #include "API/Database/db_connection_provider.h"
 
@@ -57,12 +59,19 @@ public:
 /// \name Operations
 /// \{
 public:
+	/// \brief Sets how long to wait for a lock held by another connection before failing with "Database Busy!"
+	void set_busy_timeout(int milliseconds);
+
+	/// \brief Sets how many unused prepared statements are kept for reuse
+	void set_statement_cache_size(int size);
+
 	CL_DBCommandProvider *create_command(const CL_StringRef &text, CL_DBCommand::Type type);
 	CL_DBTransactionProvider *begin_transaction(CL_DBTransaction::Type type);
 	CL_DBReaderProvider *execute_reader(CL_DBCommandProvider *command);
 	CL_String execute_scalar_string(CL_DBCommandProvider *command);
 	int execute_scalar_int(CL_DBCommandProvider *command);
 	void execute_non_query(CL_DBCommandProvider *command);
+	void execute_batch(CL_DBCommandProvider *command);
 /// \}
 
 /// \name Implementation
@@ -73,10 +82,40 @@ private:
 	static CL_String int_to_string(int value, int length);
 	static int string_to_int(const CL_String &str, int offset, int length);
 
+	/// \brief Returns a prepared statement for the SQL text, reusing a cached statement when there is one
+	sqlite3_stmt *prepare_statement(const CL_String &text);
+
+	/// \brief Keeps a statement no longer used by a command for the next command with the same text
+	void release_statement(const CL_String &text, sqlite3_stmt *vm);
+
+	/// \brief Finalizes the least recently used statements until the cache holds at most size statements
+	void trim_statement_cache(int size);
+
+	/// \brief Executes a statement that returns no rows
+	void execute_sql(const CL_String &text);
+
+	enum
+	{
+		default_busy_timeout = 1000,
+		default_statement_cache_size = 16
+	};
+
+	struct CachedStatement
+	{
+		CL_String text;
+		sqlite3_stmt *vm;
+	};
+	typedef std::list<CachedStatement> StatementCache;
+
 	CL_SqliteTransactionProvider *active_transaction;
 	CL_SqliteReaderProvider *active_reader;
 	sqlite3 *db;
 
+	/// \brief Unused prepared statements, most recently used first
+	StatementCache statement_cache;
+	std::map<CL_String, StatementCache::iterator> statement_cache_index;
+	int statement_cache_size;
+
 	friend class CL_SqliteReaderProvider;
 	friend class CL_SqliteTransactionProvider;
 	friend class CL_SqliteCommandProvider;
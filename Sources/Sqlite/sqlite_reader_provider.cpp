@@ -136,38 +136,31 @@ bool CL_SqliteReaderProvider::retrieve_row()
 {
 	if (!finished)
 	{
-		for (int i=0; i<1000; i++)
+		// The busy handler of the connection has already waited for locks when this returns SQLITE_BUSY:
+		int result = sqlite3_step(vm);
+		switch (result)
 		{
-			int result = sqlite3_step(vm);
-			switch (result)
+		case SQLITE_BUSY:
+			throw CL_Exception("Database Busy!");
+		case SQLITE_ROW:
+			return true;
+		case SQLITE_DONE:
+			if (command)
+				command->last_insert_rowid = sqlite3_last_insert_rowid(connection->db);
+			finished = true;
+			return false;
+		case SQLITE_MISUSE:
+			finished = true;
+			throw CL_Exception("Database Misuse!");
+		default:
 			{
-			case SQLITE_BUSY:
-				CL_System::sleep(1);
-				break;
-			case SQLITE_ROW:
-				return true;
-			case SQLITE_DONE:
-				if (command)
-					command->last_insert_rowid = sqlite3_last_insert_rowid(connection->db);
-				finished = true;
-				return false;
-			case SQLITE_ERROR:
-				{
-					finished = true;
-					sqlite3_reset(vm);
-					const char *err = sqlite3_errmsg(connection->db);
-					CL_StringRef8 error = (err == 0) ? "Unknown database error!" : err;
-					throw CL_Exception(CL_StringHelp::local8_to_text(error));
-				}
-			case SQLITE_MISUSE:
-				finished = true;
-				throw CL_Exception("Database Misuse!");
-			default:
 				finished = true;
-				throw CL_Exception(cl_format("Unknown database result code: %1", result));
+				const char *err = sqlite3_errmsg(connection->db);
+				CL_String8 error = (err == 0) ? "Unknown database error!" : err;
+				sqlite3_reset(vm);
+				throw CL_Exception(CL_StringHelp::local8_to_text(error));
 			}
 		}
-		throw CL_Exception("Database Busy!");
 	}
 	else
 	{
@@ -175,6 +168,35 @@ bool CL_SqliteReaderProvider::retrieve_row()
 	}
 }
 
+int CL_SqliteReaderProvider::retrieve_rows(int max_rows, const std::vector<CL_DBColumnArray> &columns)
+{
+	// Rows are stepped one at a time, so the values are stored as each row becomes current:
+	int row;
+	for (row = 0; row < max_rows && retrieve_row(); row++)
+	{
+		for (size_t i = 0; i < columns.size(); i++)
+		{
+			const CL_DBColumnArray &column = columns[i];
+			switch (column.type)
+			{
+			case CL_DBColumnArray::type_int:
+				static_cast<int*>(column.values)[row] = get_column_int(column.index);
+				break;
+			case CL_DBColumnArray::type_double:
+				static_cast<double*>(column.values)[row] = get_column_double(column.index);
+				break;
+			case CL_DBColumnArray::type_string:
+				static_cast<CL_String*>(column.values)[row] = get_column_string(column.index);
+				break;
+			case CL_DBColumnArray::type_datetime:
+				static_cast<CL_DateTime*>(column.values)[row] = get_column_datetime(column.index);
+				break;
+			}
+		}
+	}
+	return row;
+}
+
 void CL_SqliteReaderProvider::close()
 {
 	if (!closed)
@@ -189,13 +211,10 @@ void CL_SqliteReaderProvider::close()
 
 		if (destroy_command)
 		{
-			int result = sqlite3_finalize(vm);
-			if (result != SQLITE_OK)
-			{
-				const char *err = sqlite3_errmsg(connection->db);
-				CL_StringRef8 error = (err == 0) ? "Unknown error" : err;
-				throw CL_Exception(CL_StringHelp::local8_to_text(error));
-			}
+			if (connection)
+				connection->release_statement(command_text, vm);
+			else
+				sqlite3_finalize(vm);
 		}
 	}
 }
@@ -70,6 +70,7 @@ public:
 /// \{
 public:
 	bool retrieve_row();
+	int retrieve_rows(int max_rows, const std::vector<CL_DBColumnArray> &columns);
 	void close();
 /// \}
 
@@ -83,6 +84,9 @@ private:
 	bool closed;
 	bool destroy_command;
 
+	/// \brief SQL text of the statement, set when the command was destroyed before the reader
+	CL_String command_text;
+
 	friend class CL_SqliteConnectionProvider;
 	friend class CL_SqliteCommandProvider;
 /// \}
@@ -34,6 +34,8 @@
 #include "API/Core/IOData/virtual_directory.h"
 #include "API/Core/Text/string_help.h"
 #include "API/Core/IOData/path_help.h"
+#include "API/Core/System/exception.h"
+#include "API/Sound/SoundProviders/soundprovider_buffered_session.h"
 #include "soundprovider_vorbis_impl.h"
 #include "soundprovider_vorbis_session.h"
 
@@ -48,7 +50,7 @@ CL_SoundProvider_Vorbis::CL_SoundProvider_Vorbis(
 {
 	CL_VirtualDirectory new_directory = directory;
 	CL_IODevice input = new_directory.open_file(filename, CL_File::open_existing, CL_File::access_read, CL_File::share_all);
-	impl->load(input);
+	impl->load(input, stream);
 }
 
 CL_SoundProvider_Vorbis::CL_SoundProvider_Vorbis(
@@ -60,26 +62,42 @@ CL_SoundProvider_Vorbis::CL_SoundProvider_Vorbis(
 	CL_VirtualFileSystem vfs(path);
 	CL_VirtualDirectory dir = vfs.get_root_directory();
 	CL_IODevice input = dir.open_file(filename, CL_File::open_existing, CL_File::access_read, CL_File::share_all);
-	impl->load(input);
+	impl->load(input, stream);
 }
 
 CL_SoundProvider_Vorbis::CL_SoundProvider_Vorbis(
 	CL_IODevice &file, bool stream)
 : impl(new CL_SoundProvider_Vorbis_Impl)
 {
-	impl->load(file);
+	impl->load(file, stream);
 }
 
 CL_SoundProvider_Vorbis::~CL_SoundProvider_Vorbis()
 {
 }
 
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundProvider_Vorbis attributes:
+
+int CL_SoundProvider_Vorbis::get_num_underruns() const
+{
+	return impl->num_underruns.get();
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_SoundProvider_Vorbis operations:
 
+void CL_SoundProvider_Vorbis::set_stream_buffer_size(int samples)
+{
+	impl->stream_buffer_size = samples;
+}
+
 CL_SoundProvider_Session *CL_SoundProvider_Vorbis::begin_session()
 {
-	return new CL_SoundProvider_Vorbis_Session(*this);
+	CL_SoundProvider_Session *session = new CL_SoundProvider_Vorbis_Session(*this);
+	if (impl->stream)
+		session = new CL_SoundProvider_Buffered_Session(session, impl->stream_buffer_size, &impl->num_underruns);
+	return session;
 }
 
 void CL_SoundProvider_Vorbis::end_session(CL_SoundProvider_Session *session)
@@ -90,8 +108,22 @@ void CL_SoundProvider_Vorbis::end_session(CL_SoundProvider_Session *session)
 /////////////////////////////////////////////////////////////////////////////
 // CL_SoundProvider_Vorbis implementation:
 
-void CL_SoundProvider_Vorbis_Impl::load(CL_IODevice &input)
+void CL_SoundProvider_Vorbis_Impl::load(CL_IODevice &input, bool stream_from_file)
 {
+	if (stream_from_file)
+	{
+		// Devices that cannot be duplicated are loaded to memory instead:
+		try
+		{
+			file = input.duplicate();
+			stream = true;
+			return;
+		}
+		catch (const CL_Exception &)
+		{
+		}
+	}
+
 	int size = input.get_size();
 	buffer = CL_DataBuffer(size);
 	int bytes_read = input.read(buffer.get_data(), buffer.get_size());
@@ -32,17 +32,35 @@
 #include "API/Sound/soundformat.h"
 #include "API/Core/System/databuffer.h"
 #include "API/Core/IOData/virtual_directory.h"
+#include "API/Core/IOData/iodevice.h"
+#include "API/Core/System/interlocked_variable.h"
 #include <string>
 
 class CL_SoundProvider_Vorbis_Impl
 {
+/// \name Construction
+/// \{
+public:
+	CL_SoundProvider_Vorbis_Impl() : stream(false), stream_buffer_size(65536) { }
+
+/// \}
 /// \name Attributes
 /// \{
 public:
-	void load(CL_IODevice &input);
+	void load(CL_IODevice &input, bool stream);
 
 public:
 	CL_DataBuffer buffer;
+
+	/// \brief True if sessions read the compressed data from file instead of from buffer.
+	bool stream;
+
+	/// \brief Device each streamed session duplicates, so every session has its own read position.
+	CL_IODevice file;
+
+	int stream_buffer_size;
+
+	CL_InterlockedVariable num_underruns;
 /// \}
 };
 
@@ -41,7 +41,10 @@
 CL_SoundProvider_Vorbis_Session::CL_SoundProvider_Vorbis_Session(CL_SoundProvider_Vorbis &source) :
 	source(source), num_samples(0), position(0), input(0), stream_eof(false)
 {
-	input = new CL_IODevice_Memory(source.impl->buffer);
+	if (source.impl->stream)
+		input = new CL_IODevice(source.impl->file.duplicate());
+	else
+		input = new CL_IODevice_Memory(source.impl->buffer);
 
 	ogg_sync_init(&oy); /* Now we can read pages */
 
@@ -238,6 +241,7 @@ bool CL_SoundProvider_Vorbis_Session::set_position(int pos)
 
 	input->seek(0, CL_IODevice::seek_set);
 	stream_eof = false;
+	position = 0;
 	return true;
 }
 
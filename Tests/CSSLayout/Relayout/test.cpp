@@ -0,0 +1,243 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include "test.h"
+
+// This is the Program class that is called by CL_ClanApplication
+class Program
+{
+public:
+	static int main(const std::vector<CL_String> &args)
+	{
+		// Initialize ClanLib base components
+		CL_SetupCore setup_core;
+		CL_SetupDisplay setup_display;
+		CL_SetupGL setup_gl;
+
+		// Start the Application
+		TestApp app;
+		int retval = app.main(args);
+		return retval;
+	}
+};
+
+// Instantiate CL_ClanApplication, informing it where the Program is located
+CL_ClanApplication app(&Program::main);
+
+int TestApp::main(const std::vector<CL_String> &args)
+{
+	// Create a console window for text-output if not available
+	CL_ConsoleWindow console("Console");
+
+	try
+	{
+		CL_DisplayWindow window("CSS Relayout Test", 640, 480);
+		CL_GraphicContext &gc = window.get_gc();
+
+		CL_Console::write_line("ClanLib Test Suite:");
+		CL_Console::write_line("-------------------");
+		CL_Console::write_line("Directory: API/CSSLayout");
+		CL_Console::write_line("  Class: CL_CSSLayout");
+
+		test_intrinsic_size(gc);
+		test_root_element(gc);
+		test_clean_sibling(gc);
+
+		CL_Console::write_line("All Tests Complete");
+		console.display_close_message();
+	}
+	catch(CL_Exception error)
+	{
+		CL_Console::write_line("Exception caught:");
+		CL_Console::write_line(error.message);
+		console.display_close_message();
+		return -1;
+	}
+
+	return 0;
+}
+
+void TestApp::fail()
+{
+	throw CL_Exception("Failed Test");
+}
+
+void TestApp::test_intrinsic_size(CL_GraphicContext &gc)
+{
+	CL_Console::write_line("   Function: layout() after changing the intrinsic size of an object");
+
+	CL_Rect viewport(0, 0, 640, 480);
+	CL_CSSLayout layout;
+	CL_CSSLayoutElement root = layout.create_element("html");
+	root.apply_properties("display: block");
+	layout.set_root_element(root);
+
+	TestComponent component;
+	CL_CSSLayoutObject object = create_object(root, &component);
+	object.set_intrinsic_width(100);
+	object.set_intrinsic_height(100);
+
+	layout.layout(gc, viewport);
+	check_geometry(component, 100, 100);
+
+	// Nothing changed, so the layout pass should be skipped:
+	int num_updates = component.num_updates;
+	layout.layout(gc, viewport);
+	if (component.num_updates != num_updates)
+		fail();
+
+	object.set_intrinsic_height(40);
+	layout.layout(gc, viewport);
+	check_geometry(component, 100, 40);
+
+	object.set_intrinsic_width(60);
+	layout.layout(gc, viewport);
+	check_geometry(component, 60, 40);
+
+	// Without an intrinsic height the ratio decides it:
+	object.set_no_intrinsic_height();
+	object.set_intrinsic_ratio(0.5f);
+	layout.layout(gc, viewport);
+	check_geometry(component, 60, 30);
+
+	object.set_no_intrinsic_ratio();
+	object.set_intrinsic_height(10);
+	layout.layout(gc, viewport);
+	check_geometry(component, 60, 10);
+
+	// Replacing the component must lay out the new one:
+	TestComponent component2;
+	object.set_component(&component2);
+	layout.layout(gc, viewport);
+	check_geometry(component2, 60, 10);
+}
+
+void TestApp::test_root_element(CL_GraphicContext &gc)
+{
+	CL_Console::write_line("   Function: layout() after replacing the root element");
+
+	CL_Rect viewport(0, 0, 640, 480);
+	CL_CSSLayout layout;
+	CL_CSSLayoutElement root = layout.create_element("html");
+	root.apply_properties("display: block");
+	layout.set_root_element(root);
+
+	TestComponent component;
+	CL_CSSLayoutObject object = create_object(root, &component);
+	object.set_intrinsic_width(100);
+	object.set_intrinsic_height(100);
+	layout.layout(gc, viewport);
+	check_geometry(component, 100, 100);
+
+	CL_CSSLayoutElement root2 = layout.create_element("html");
+	root2.apply_properties("display: block; padding-top: 20px");
+	TestComponent component2;
+	CL_CSSLayoutObject object2 = create_object(root2, &component2);
+	object2.set_intrinsic_width(30);
+	object2.set_intrinsic_height(20);
+
+	layout.set_root_element(root2);
+	layout.layout(gc, viewport);
+	check_geometry(component2, 30, 20);
+	if (component2.geometry.top != 20)
+		fail();
+}
+
+void TestApp::test_clean_sibling(CL_GraphicContext &gc)
+{
+	CL_Console::write_line("   Function: layout() after changing one of two blocks");
+
+	CL_Rect viewport(0, 0, 640, 480);
+	CL_CSSLayout layout;
+	CL_CSSLayoutElement root = layout.create_element("html");
+	root.apply_properties("display: block");
+	layout.set_root_element(root);
+
+	CL_CSSLayoutElement first = root.create_element("div");
+	first.apply_properties("display: block");
+	TestComponent component;
+	CL_CSSLayoutObject object = create_object(first, &component);
+	object.set_intrinsic_width(100);
+	object.set_intrinsic_height(100);
+
+	CL_CSSLayoutElement second = root.create_element("div");
+	second.apply_properties("display: block");
+	TestComponent component2;
+	CL_CSSLayoutObject object2 = create_object(second, &component2);
+	object2.set_intrinsic_width(50);
+	object2.set_intrinsic_height(50);
+
+	layout.layout(gc, viewport);
+	check_geometry(component2, 50, 50);
+	if (component2.geometry.top != 100)
+		fail();
+
+	// The second block keeps its layout nodes, but must still move up:
+	object.set_intrinsic_height(40);
+	layout.layout(gc, viewport);
+	check_geometry(component, 100, 40);
+	check_geometry(component2, 50, 50);
+	if (component2.geometry.top != 40)
+		fail();
+
+	second.apply_properties("padding-top: 10px");
+	layout.layout(gc, viewport);
+	check_geometry(component2, 50, 50);
+	if (component2.geometry.top != 50)
+		fail();
+
+	// Hiding the first block removes its layout node while the second one is reused:
+	first.apply_properties("display: none");
+	layout.layout(gc, viewport);
+	if (component2.geometry.top != 10)
+		fail();
+
+	// A new viewport size reuses all layout nodes:
+	layout.layout(gc, CL_Rect(0, 0, 320, 240));
+	check_geometry(component2, 50, 50);
+	if (component2.geometry.top != 10)
+		fail();
+}
+
+CL_CSSLayoutObject TestApp::create_object(CL_CSSLayoutElement &parent, TestComponent *component)
+{
+	CL_CSSLayoutObject object = parent.create_object();
+	object.apply_properties("display: block");
+	object.set_component(component);
+	return object;
+}
+
+void TestApp::check_geometry(const TestComponent &component, int width, int height)
+{
+	if (component.num_updates == 0 || component.geometry.get_width() != width || component.geometry.get_height() != height)
+	{
+		CL_Console::write_line("Got %1x%2, expected %3x%4", component.geometry.get_width(), component.geometry.get_height(), width, height);
+		fail();
+	}
+}
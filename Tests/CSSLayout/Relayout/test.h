@@ -0,0 +1,60 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include <ClanLib/core.h>
+#include <ClanLib/application.h>
+#include <ClanLib/display.h>
+#include <ClanLib/gl.h>
+#include <ClanLib/csslayout.h>
+
+class TestComponent
+{
+public:
+	TestComponent() : num_updates(0) { }
+
+	void set_geometry(const CL_Rect &new_geometry) { geometry = new_geometry; num_updates++; }
+
+	CL_Rect geometry;
+	int num_updates;
+};
+
+class TestApp
+{
+public:
+	virtual int main(const std::vector<CL_String> &args);
+
+private:
+	void test_intrinsic_size(CL_GraphicContext &gc);
+	void test_root_element(CL_GraphicContext &gc);
+	void test_clean_sibling(CL_GraphicContext &gc);
+
+	static CL_CSSLayoutObject create_object(CL_CSSLayoutElement &parent, TestComponent *component);
+	static void check_geometry(const TestComponent &component, int width, int height);
+	static void fail();
+};
@@ -0,0 +1,185 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include "test.h"
+
+// This is the Program class that is called by CL_ClanApplication
+class Program
+{
+public:
+	static int main(const std::vector<CL_String> &args)
+	{
+		// Initialize ClanLib base components
+		CL_SetupCore setup_core;
+
+		// Start the Application
+		TestApp app;
+		int retval = app.main(args);
+		return retval;
+	}
+};
+
+// Instantiate CL_ClanApplication, informing it where the Program is located
+CL_ClanApplication app(&Program::main);
+
+int TestApp::main(const std::vector<CL_String> &args)
+{
+	// Create a console window for text-output if not available
+	CL_ConsoleWindow console("Console");
+
+	try
+	{
+		CL_Console::write_line("ClanLib Test Suite:");
+		CL_Console::write_line("-------------------");
+		CL_Console::write_line("Directory: API/CSSLayout");
+		CL_Console::write_line("  Class: CL_CSSDocument2");
+
+		test_selectors();
+
+		CL_Console::write_line("All Tests Complete");
+		console.display_close_message();
+	}
+	catch(CL_Exception error)
+	{
+		CL_Console::write_line("Exception caught:");
+		CL_Console::write_line(error.message);
+		console.display_close_message();
+		return -1;
+	}
+
+	return 0;
+}
+
+void TestApp::fail()
+{
+	throw CL_Exception("Failed Test");
+}
+
+void TestApp::test_selectors()
+{
+	CL_Console::write_line("   Function: select() with and without the selector index");
+
+	// Rules keyed on ids, classes, element names and nothing, with combinators, attributes and pseudo elements:
+	CL_String stylesheet =
+		"* { margin: 1px }\n"
+		"div { color: red }\n"
+		"DIV.note { color: blue }\n"
+		".note { padding: 2px }\n"
+		".note.warning { border-width: 3px }\n"
+		"#main { width: 100px }\n"
+		"div#main.note { height: 50px }\n"
+		"body div { font-size: 10px }\n"
+		"section > p { text-indent: 4px }\n"
+		"section p.note { text-indent: 5px }\n"
+		"#main span, .warning span { font-weight: bold }\n"
+		"[lang] { font-style: italic }\n"
+		"p[title=\"x\"] { line-height: 2 }\n"
+		"p + span { color: green }\n"
+		"*.warning { color: orange !important }\n"
+		"p:first-child { margin-top: 0 }\n"
+		"p::before { content: \"a\" }\n"
+		"#missing div, .missing, nothing { color: black }\n"
+		"div { color: purple }\n";
+
+	CL_String html =
+		"<html><body>"
+		"<div id=\"main\" class=\"note\"><span>a</span><p class=\"Note warning\" title=\"x\">b</p><span lang=\"en\">c</span></div>"
+		"<section><p>d</p><div><p class=\"note\">e</p></div><p class=\"warning\"><span>f</span></p></section>"
+		"<div class=\"note warning note\"><div id=\"main\"><span/></div></div>"
+		"<p title=\"y\"/><span/>"
+		"</body></html>";
+
+	CL_DataBuffer html_data(html.data(), html.length());
+	CL_IODevice_Memory html_device(html_data);
+	CL_DomDocument dom(html_device);
+
+	CL_CSSDocument2 indexed = create_document(stylesheet, true);
+	CL_CSSDocument2 unindexed = create_document(stylesheet, false);
+
+	// The second pass runs from the cached candidate lists:
+	for (int pass = 0; pass < 2; pass++)
+	{
+		int num_elements = 0;
+		int num_properties = 0;
+		compare_selection(indexed, unindexed, dom.get_document_element(), num_elements, num_properties);
+		if (num_elements != 17 || num_properties == 0)
+			fail();
+	}
+
+	// Spot check a few results:
+	CL_DomElement main = dom.get_document_element().get_first_child_element().get_first_child_element();
+	CL_String main_properties = to_string(indexed.select(main));
+	if (main_properties.find("width:100px") == CL_String::npos || main_properties.find("height:50px") == CL_String::npos)
+		fail();
+	if (main_properties.find("color:blue") == CL_String::npos || main_properties.find("color:purple") == CL_String::npos)
+		fail();
+}
+
+void TestApp::compare_selection(CL_CSSDocument2 &indexed, CL_CSSDocument2 &unindexed, const CL_DomElement &element, int &num_elements, int &num_properties)
+{
+	const char *pseudo_elements[] = { "", "before" };
+	for (int i = 0; i < 2; i++)
+	{
+		CL_String result = to_string(indexed.select(element, pseudo_elements[i]));
+		if (result != to_string(unindexed.select(element, pseudo_elements[i])))
+		{
+			CL_Console::write_line("Selection differs for <%1> %2: %3", element.get_tag_name(), pseudo_elements[i], result);
+			fail();
+		}
+		num_properties += indexed.select(element, pseudo_elements[i]).size();
+	}
+	num_elements++;
+
+	for (CL_DomElement child = element.get_first_child_element(); !child.is_null(); child = child.get_next_sibling_element())
+		compare_selection(indexed, unindexed, child, num_elements, num_properties);
+}
+
+CL_CSSDocument2 TestApp::create_document(const CL_String &stylesheet, bool index_enabled)
+{
+	CL_DataBuffer data(stylesheet.data(), stylesheet.length());
+	CL_IODevice_Memory device(data);
+	CL_CSSDocument2 document;
+	document.set_selector_index_enabled(index_enabled);
+	document.add_sheet(device);
+	return document;
+}
+
+CL_String TestApp::to_string(const CL_CSSPropertyList2 &properties)
+{
+	CL_String result;
+	for (size_t i = 0; i < properties.size(); i++)
+	{
+		result += properties[i].get_name() + ":";
+		const std::vector<CL_CSSToken> &tokens = properties[i].get_value_tokens();
+		for (size_t j = 0; j < tokens.size(); j++)
+			result += tokens[j].value + tokens[j].dimension;
+		result += properties[i].is_important() ? "!;" : ";";
+	}
+	return result;
+}
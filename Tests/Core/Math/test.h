@@ -88,6 +88,7 @@ private:
 	void test_line_segment2();
 	void test_line_segment3();
 	void test_triangle();
+	void test_region();
 	void test_matrix_mat2();
 	void test_matrix_mat3();
 	void test_matrix_mat4();
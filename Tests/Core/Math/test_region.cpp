@@ -0,0 +1,173 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+**    (if your name is missing here, please add it)
+*/
+
+#include "test.h"
+
+namespace
+{
+	const int region_size = 64;
+
+	void paint(std::vector<bool> &pixels, const CL_Rect &rect, bool value)
+	{
+		for (int y = cl_max(rect.top, 0); y < cl_min(rect.bottom, region_size); y++)
+			for (int x = cl_max(rect.left, 0); x < cl_min(rect.right, region_size); x++)
+				pixels[x + y * region_size] = value;
+	}
+
+	bool matches(const CL_Region &region, const std::vector<bool> &pixels)
+	{
+		std::vector<bool> region_pixels(pixels.size(), false);
+		const std::vector<CL_Rect> &rects = region.get_rects();
+		for (size_t i = 0; i < rects.size(); i++)
+		{
+			// Rects must be disjoint
+			for (size_t j = i + 1; j < rects.size(); j++)
+			{
+				if (rects[i].is_overlapped(rects[j]))
+					return false;
+			}
+			paint(region_pixels, rects[i], true);
+		}
+		return region_pixels == pixels;
+	}
+
+	CL_Rect random_rect()
+	{
+		int x = rand() % region_size;
+		int y = rand() % region_size;
+		return CL_Rect(x, y, CL_Size(1 + rand() % 24, 1 + rand() % 24));
+	}
+}
+
+void TestApp::test_region()
+{
+	CL_Console::write_line(" Header: region.h");
+	CL_Console::write_line("  Class: CL_Region");
+
+	CL_Console::write_line("   Function: void unite(const CL_Rect &rect)");
+	{
+		CL_Region region;
+		region.unite(CL_Rect(0, 0, 10, 10));
+		region.unite(CL_Rect(10, 0, 20, 10));
+		if (region.get_rects().size() != 1 || region.get_rects()[0] != CL_Rect(0, 0, 20, 10))
+			fail();
+
+		region.unite(CL_Rect(0, 10, 20, 20));
+		if (region.get_rects().size() != 1 || region.get_bounds() != CL_Rect(0, 0, 20, 20))
+			fail();
+
+		region.unite(CL_Rect(5, 5, 25, 15));
+		if (region.get_area() != 20*20 + 5*10)
+			fail();
+		if (!region.contains(CL_Point(24, 14)) || region.contains(CL_Point(24, 15)))
+			fail();
+	}
+
+	CL_Console::write_line("   Function: void subtract(const CL_Rect &rect)");
+	{
+		CL_Region region(CL_Rect(0, 0, 30, 30));
+		region.subtract(CL_Rect(10, 10, 20, 20));
+		if (region.get_rects().size() != 4 || region.get_area() != 30*30 - 10*10)
+			fail();
+		if (region.is_overlapped(CL_Rect(12, 12, 18, 18)) || !region.is_overlapped(CL_Rect(5, 5, 11, 11)))
+			fail();
+
+		region.subtract(CL_Rect(0, 0, 30, 30));
+		if (!region.is_empty())
+			fail();
+	}
+
+	CL_Console::write_line("   Function: void intersect(const CL_Rect &rect)");
+	{
+		CL_Region region(CL_Rect(0, 0, 30, 30));
+		region.unite(CL_Rect(40, 0, 50, 10));
+		region.intersect(CL_Rect(20, 5, 45, 25));
+		if (region.get_area() != 10*20 + 5*5)
+			fail();
+	}
+
+	CL_Console::write_line("   Random operations against a pixel mask");
+	{
+		srand(1234);
+		for (int test = 0; test < 200; test++)
+		{
+			CL_Region region;
+			std::vector<bool> pixels(region_size * region_size, false);
+			for (int op = 0; op < 12; op++)
+			{
+				CL_Rect rect = random_rect();
+				switch (rand() % 3)
+				{
+				case 0:
+					region.unite(rect);
+					paint(pixels, rect, true);
+					break;
+				case 1:
+					region.subtract(rect);
+					paint(pixels, rect, false);
+					break;
+				default:
+					{
+						CL_Region other(rect);
+						other.unite(random_rect());
+						std::vector<bool> other_pixels(pixels.size(), false);
+						for (size_t i = 0; i < other.get_rects().size(); i++)
+							paint(other_pixels, other.get_rects()[i], true);
+						region.unite(other);
+						for (size_t i = 0; i < pixels.size(); i++)
+							pixels[i] = pixels[i] || other_pixels[i];
+					}
+					break;
+				}
+				region.intersect(CL_Rect(0, 0, region_size, region_size));
+				if (!matches(region, pixels))
+					fail();
+			}
+		}
+	}
+
+	CL_Console::write_line("   Function: std::vector<CL_Rect> get_merged_rects(int rect_cost)");
+	{
+		CL_Region region(CL_Rect(0, 0, 10, 10));
+		region.unite(CL_Rect(12, 0, 22, 10));
+		region.unite(CL_Rect(200, 200, 210, 210));
+
+		std::vector<CL_Rect> rects = region.get_merged_rects(100);
+		if (rects.size() != 2 || rects[0] != CL_Rect(0, 0, 22, 10))
+			fail();
+
+		rects = region.get_merged_rects(0);
+		if (rects.size() != 3)
+			fail();
+
+		rects = region.get_merged_rects(1000000);
+		if (rects.size() != 1 || rects[0] != region.get_bounds())
+			fail();
+	}
+}
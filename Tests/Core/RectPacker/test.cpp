@@ -1,4 +1,88 @@
 #include <ClanLib/core.h>
+#include <cstdlib>
+
+static const char *algorithm_names[] = { "guillotine", "skyline", "max_rects" };
+
+static bool is_packing_valid(const std::vector<CL_RectPacker::AllocatedRect> &allocations, const CL_Size &group_size)
+{
+	for (size_t i = 0; i < allocations.size(); i++)
+	{
+		const CL_Rect &rect = allocations[i].rect;
+		if (rect.left < 0 || rect.top < 0 || rect.right > group_size.width || rect.bottom > group_size.height)
+			return false;
+
+		for (size_t j = i + 1; j < allocations.size(); j++)
+		{
+			if (allocations[i].group_index == allocations[j].group_index && rect.is_overlapped(allocations[j].rect))
+				return false;
+		}
+	}
+	return true;
+}
+
+static void test_packing_algorithm(CL_RectPacker::PackingAlgorithm algorithm)
+{
+	std::cout << std::endl << "Testing " << algorithm_names[algorithm] << ":" << std::endl;
+
+	const CL_Size group_size(128, 128);
+	CL_RectPacker packer(group_size, CL_RectPacker::search_previous_groups, algorithm);
+
+	srand(1);
+	std::vector<CL_Size> sizes;
+	for (int i = 0; i < 300; i++)
+		sizes.push_back(CL_Size(1 + rand() % 32, 1 + rand() % 32));
+
+	std::vector<CL_RectPacker::AllocatedRect> allocations;
+	for (size_t i = 0; i < sizes.size(); i++)
+		allocations.push_back(packer.add(sizes[i]));
+	std::cout << (is_packing_valid(allocations, group_size) ? "Expected: " : "Did not expect: ") << "Rects do not overlap, in " << packer.get_group_count() << " groups" << std::endl;
+
+	// Rects added after removing others must not overlap the remaining ones:
+	std::vector<CL_RectPacker::AllocatedRect> remaining;
+	for (size_t i = 0; i < allocations.size(); i++)
+	{
+		if (i % 2)
+			packer.remove(allocations[i]);
+		else
+			remaining.push_back(allocations[i]);
+	}
+	for (int i = 0; i < 50; i++)
+		remaining.push_back(packer.add(CL_Size(1 + rand() % 32, 1 + rand() % 32)));
+	bool counted = (packer.get_total_rect_count() == (int) remaining.size());
+	std::cout << (is_packing_valid(remaining, group_size) && counted ? "Expected: " : "Did not expect: ") << "Rects added after removal do not overlap" << std::endl;
+
+	// Removing every rect in reverse order frees all the space again:
+	for (size_t i = remaining.size(); i > 0; i--)
+		packer.remove(remaining[i - 1]);
+	int group_count = packer.get_group_count();
+	allocations.clear();
+	for (size_t i = 0; i < sizes.size(); i++)
+		allocations.push_back(packer.add(sizes[i]));
+	bool reused = (packer.get_group_count() == group_count);
+	std::cout << (is_packing_valid(allocations, group_size) && reused ? "Expected: " : "Did not expect: ") << "Removed space reused" << std::endl;
+
+	// Batches are packed largest first, but returned in the order given:
+	packer.clear();
+	std::vector<CL_RectPacker::AllocatedRect> batch = packer.add(sizes);
+	bool in_order = true;
+	for (size_t i = 0; i < sizes.size(); i++)
+	{
+		if (batch[i].rect.get_size() != sizes[i])
+			in_order = false;
+	}
+	std::cout << (is_packing_valid(batch, group_size) && in_order ? "Expected: " : "Did not expect: ") << "Batch packed in " << packer.get_group_count() << " groups" << std::endl;
+
+	try
+	{
+		packer.remove(allocations[1]);
+		packer.remove(allocations[1]);
+		std::cout << "Did not expect: Removing twice OK" << std::endl;
+	}
+	catch (CL_Exception &e)
+	{
+		std::cout << "Expected: " << e.message.c_str() << std::endl;
+	}
+}
 
 int main(void)
 {
@@ -96,6 +180,10 @@ int main(void)
 	{
 		std::cout << "Expected: " << e.message.c_str() << std::endl;		
 	}
+
+	test_packing_algorithm(CL_RectPacker::guillotine);
+	test_packing_algorithm(CL_RectPacker::skyline);
+	test_packing_algorithm(CL_RectPacker::max_rects);
 	return 0;
 }
 
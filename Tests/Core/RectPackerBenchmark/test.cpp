@@ -0,0 +1,170 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include "test.h"
+
+// This is the Program class that is called by CL_ClanApplication
+class Program
+{
+public:
+	static int main(const std::vector<CL_String> &args)
+	{
+		// Initialize ClanLib base components
+		CL_SetupCore setup_core;
+
+		// Start the Application
+		TestApp app;
+		int retval = app.main(args);
+		return retval;
+	}
+};
+
+// Instantiate CL_ClanApplication, informing it where the Program is located
+CL_ClanApplication app(&Program::main);
+
+int TestApp::main(const std::vector<CL_String> &args)
+{
+	// Create a console window for text-output if not available
+	CL_ConsoleWindow console("Console");
+
+	try
+	{
+		CL_Console::write_line("ClanLib Test Suite:");
+		CL_Console::write_line("-------------------");
+		CL_Console::write_line("For CL_RectPacker occupancy and performance");
+		CL_Console::write_line("Usage: test [directory...]");
+
+		std::vector<CL_String> paths(args.begin() + 1, args.end());
+		if (paths.empty())
+		{
+			paths.push_back("../../../Resources");
+			paths.push_back("../../../Examples");
+		}
+		for (size_t i = 0; i < paths.size(); i++)
+			scan_images(paths[i]);
+
+		// Skip images that would need a group of their own:
+		group_size = CL_Size(512, 512);
+		std::vector<CL_Size> fitting_sizes;
+		for (size_t i = 0; i < sizes.size(); i++)
+		{
+			if (sizes[i].width <= group_size.width && sizes[i].height <= group_size.height)
+				fitting_sizes.push_back(sizes[i]);
+		}
+		sizes.swap(fitting_sizes);
+		if (sizes.empty())
+			throw CL_Exception("No PNG images found");
+
+		CL_Console::write_line("Images: %1, group size: %2x%3", (int) sizes.size(), group_size.width, group_size.height);
+		CL_Console::write_line("algorithm mode groups occupancy time_us");
+		const CL_RectPacker::PackingAlgorithm algorithms[] = { CL_RectPacker::guillotine, CL_RectPacker::skyline, CL_RectPacker::max_rects };
+		for (int i = 0; i < sizeof(algorithms) / sizeof(CL_RectPacker::PackingAlgorithm); i++)
+		{
+			run_benchmark(algorithms[i], false);
+			run_benchmark(algorithms[i], true);
+		}
+
+		CL_Console::write_line("All Tests Complete");
+		console.display_close_message();
+	}
+	catch(CL_Exception error)
+	{
+		CL_Console::write_line("Exception caught:");
+		CL_Console::write_line(error.message);
+		console.display_close_message();
+		return -1;
+	}
+
+	return 0;
+}
+
+void TestApp::scan_images(const CL_String &path)
+{
+	CL_DirectoryScanner scanner;
+	if (!scanner.scan(path))
+		return;
+
+	while (scanner.next())
+	{
+		CL_String name = scanner.get_name();
+		if (scanner.is_directory())
+		{
+			if (name != "." && name != "..")
+				scan_images(scanner.get_pathname());
+		}
+		else if (CL_StringHelp::compare(CL_PathHelp::get_extension(name), "png", true) == 0)
+		{
+			CL_Size size;
+			if (read_png_size(scanner.get_pathname(), size))
+				sizes.push_back(size);
+		}
+	}
+}
+
+bool TestApp::read_png_size(const CL_String &filename, CL_Size &out_size)
+{
+	// The IHDR chunk always comes first, with width and height stored big endian at offset 16:
+	CL_File file(filename);
+	file.set_big_endian_mode();
+	unsigned char signature[16];
+	if (file.read(signature, 16) != 16 || signature[1] != 'P' || signature[2] != 'N' || signature[3] != 'G')
+		return false;
+	out_size.width = file.read_uint32();
+	out_size.height = file.read_uint32();
+	return out_size.width > 0 && out_size.height > 0;
+}
+
+void TestApp::run_benchmark(CL_RectPacker::PackingAlgorithm algorithm, bool batch)
+{
+	const char *algorithm_names[] = { "guillotine", "skyline", "max_rects" };
+
+	CL_RectPacker packer(group_size, CL_RectPacker::search_previous_groups, algorithm);
+
+	cl_ubyte64 start_time = CL_System::get_microseconds();
+	if (batch)
+	{
+		packer.add(sizes);
+	}
+	else
+	{
+		for (size_t i = 0; i < sizes.size(); i++)
+			packer.add(sizes[i]);
+	}
+	cl_ubyte64 end_time = CL_System::get_microseconds();
+
+	double used_area = 0.0;
+	for (size_t i = 0; i < sizes.size(); i++)
+		used_area += sizes[i].width * (double) sizes[i].height;
+	double total_area = packer.get_group_count() * group_size.width * (double) group_size.height;
+
+	CL_Console::write_line("%1 %2 %3 %4 %5",
+		algorithm_names[algorithm], batch ? "batch" : "online",
+		packer.get_group_count(), CL_StringHelp::double_to_text(used_area / total_area, 3),
+		(int) (end_time - start_time));
+}
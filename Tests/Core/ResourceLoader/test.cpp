@@ -0,0 +1,252 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include "test.h"
+#include <new>
+
+// This is the Program class that is called by CL_ClanApplication
+class Program
+{
+public:
+	static int main(const std::vector<CL_String> &args)
+	{
+		// Initialize ClanLib base components
+		CL_SetupCore setup_core;
+
+		// Start the Application
+		TestApp app;
+		int retval = app.main(args);
+		return retval;
+	}
+};
+
+// Instantiate CL_ClanApplication, informing it where the Program is located
+CL_ClanApplication app(&Program::main);
+
+class TestTask : public CL_ResourceLoadTask
+{
+public:
+	enum Failure
+	{
+		no_failure,
+		fail_load,
+		fail_finish,
+		fail_finish_bad_alloc
+	};
+
+	TestTask(Failure failure = no_failure, int finish_time = 0)
+	: failure(failure), finish_time(finish_time), loaded(false), finished(false), block_load(false), event_loading(true, false), event_release(true, false)
+	{
+	}
+
+	void load()
+	{
+		event_loading.set();
+		if (block_load)
+			event_release.wait();
+		if (failure == fail_load)
+			throw CL_Exception("load failed");
+		loaded = true;
+	}
+
+	void finish()
+	{
+		if (finish_time > 0)
+			CL_System::sleep(finish_time);
+		if (failure == fail_finish)
+			throw CL_Exception("finish failed");
+		if (failure == fail_finish_bad_alloc)
+			throw std::bad_alloc();
+		finished = true;
+	}
+
+	Failure failure;
+	int finish_time;
+	bool loaded;
+	bool finished;
+
+	/// \brief Makes load() wait for event_release, so the task stays in the loading state
+	bool block_load;
+	CL_Event event_loading;
+	CL_Event event_release;
+};
+
+int TestApp::main(const std::vector<CL_String> &args)
+{
+	// Create a console window for text-output if not available
+	CL_ConsoleWindow console("Console");
+
+	try
+	{
+		CL_Console::write_line("ClanLib Test Suite:");
+		CL_Console::write_line("-------------------");
+		CL_Console::write_line("Directory: API/Core/Resources");
+		CL_Console::write_line(" Header: resource_loader.h");
+		CL_Console::write_line("  Class: CL_ResourceLoader");
+
+		test_success();
+		test_failure();
+		test_cancel();
+		test_time_budget();
+
+		CL_Console::write_line("All Tests Complete");
+		console.display_close_message();
+	}
+	catch(CL_Exception error)
+	{
+		CL_Console::write_line("Exception caught:");
+		CL_Console::write_line(error.message);
+		console.display_close_message();
+		return -1;
+	}
+
+	return 0;
+}
+
+void TestApp::fail()
+{
+	throw CL_Exception("Failed Test");
+}
+
+void TestApp::wait_completed(CL_ResourceLoader &loader, int count)
+{
+	for (int i = 0; i < 500 && loader.get_completed_count() < count; i++)
+		CL_System::sleep(10);
+	if (loader.get_completed_count() != count)
+		fail();
+}
+
+void TestApp::test_success()
+{
+	CL_Console::write_line("   Function: queue() and process_completed()");
+
+	CL_ResourceLoader loader(CL_ResourceManager(), 2);
+	CL_SharedPtr<TestTask> task(new TestTask);
+	CL_ResourceLoadHandle handle = loader.queue(task);
+
+	wait_completed(loader, 1);
+	if (handle.get_status() != CL_ResourceLoadHandle::status_loaded || !task->loaded || task->finished)
+		fail();
+
+	if (loader.process_completed() != 1)
+		fail();
+	if (handle.get_status() != CL_ResourceLoadHandle::status_finished || !task->finished)
+		fail();
+	if (!handle.wait(0) || loader.get_pending_count() != 0 || loader.get_completed_count() != 0)
+		fail();
+}
+
+void TestApp::test_failure()
+{
+	CL_Console::write_line("   Function: failing load() and finish()");
+
+	CL_ResourceLoader loader(CL_ResourceManager(), 2);
+
+	CL_ResourceLoadHandle load_handle = loader.queue(CL_SharedPtr<TestTask>(new TestTask(TestTask::fail_load)));
+	if (!load_handle.wait(5000))
+		fail();
+	if (load_handle.get_status() != CL_ResourceLoadHandle::status_failed || load_handle.get_error_message() != "load failed")
+		fail();
+
+	CL_ResourceLoadHandle finish_handle = loader.queue(CL_SharedPtr<TestTask>(new TestTask(TestTask::fail_finish)));
+	CL_ResourceLoadHandle bad_alloc_handle = loader.queue(CL_SharedPtr<TestTask>(new TestTask(TestTask::fail_finish_bad_alloc)));
+	wait_completed(loader, 2);
+	if (loader.process_completed() != 2)
+		fail();
+	if (finish_handle.get_status() != CL_ResourceLoadHandle::status_failed || finish_handle.get_error_message() != "finish failed")
+		fail();
+
+	// Exceptions not derived from CL_Exception must still complete the handle:
+	if (bad_alloc_handle.get_status() != CL_ResourceLoadHandle::status_failed || !bad_alloc_handle.wait(0))
+		fail();
+}
+
+void TestApp::test_cancel()
+{
+	CL_Console::write_line("   Function: cancel()");
+
+	// A single worker is kept busy by the blocking task, so the second task stays queued:
+	CL_ResourceLoader loader(CL_ResourceManager(), 1);
+	CL_SharedPtr<TestTask> blocking_task(new TestTask);
+	blocking_task->block_load = true;
+	CL_ResourceLoadHandle blocking_handle = loader.queue(blocking_task);
+	if (!blocking_task->event_loading.wait(5000))
+		fail();
+	CL_SharedPtr<TestTask> queued_task(new TestTask);
+	CL_ResourceLoadHandle queued_handle = loader.queue(queued_task);
+
+	queued_handle.cancel();
+	if (queued_handle.get_status() != CL_ResourceLoadHandle::status_cancelled || !queued_handle.wait(0))
+		fail();
+
+	// A task being loaded is cancelled once load() returns, and finish() is not called:
+	blocking_handle.cancel();
+	blocking_task->event_release.set();
+	if (!blocking_handle.wait(5000))
+		fail();
+	if (blocking_handle.get_status() != CL_ResourceLoadHandle::status_cancelled)
+		fail();
+
+	// A loaded task is removed from the completed list:
+	CL_SharedPtr<TestTask> loaded_task(new TestTask);
+	CL_ResourceLoadHandle loaded_handle = loader.queue(loaded_task);
+	wait_completed(loader, 1);
+	loaded_handle.cancel();
+	if (loaded_handle.get_status() != CL_ResourceLoadHandle::status_cancelled || loader.get_completed_count() != 0)
+		fail();
+	if (loader.process_completed() != 0 || loaded_task->finished || queued_task->loaded || blocking_task->finished)
+		fail();
+}
+
+void TestApp::test_time_budget()
+{
+	CL_Console::write_line("   Function: process_completed() with a time budget");
+
+	const int num_tasks = 5;
+	CL_ResourceLoader loader(CL_ResourceManager(), 2);
+	std::vector<CL_ResourceLoadHandle> handles;
+	for (int i = 0; i < num_tasks; i++)
+		handles.push_back(loader.queue(CL_SharedPtr<TestTask>(new TestTask(TestTask::no_failure, 20))));
+	wait_completed(loader, num_tasks);
+
+	// Each finish() takes 20 ms, so a 30 ms budget stops after the second one:
+	int finished_count = loader.process_completed(30);
+	if (finished_count < 1 || finished_count >= num_tasks)
+		fail();
+	if (loader.get_completed_count() != num_tasks - finished_count)
+		fail();
+
+	if (loader.process_completed() != num_tasks - finished_count)
+		fail();
+	for (int i = 0; i < num_tasks; i++)
+	{
+		if (handles[i].get_status() != CL_ResourceLoadHandle::status_finished)
+			fail();
+	}
+}
@@ -66,5 +66,42 @@ void TestApp::test_resources(void)
 		CL_Console::write_line(CL_String("magic = ") + CL_StringHelp::int_to_text(magic) );
 	}
 
+	CL_Console::write_line(" Header: resource_manager.h");
+	CL_Console::write_line("  Class: CL_ResourceManager");
+
+	CL_Console::write_line("   Function: add_resources() and remove_resources()");
+	{
+		CL_ResourceManager layered;
+		CL_ResourceManager layer1;
+		CL_ResourceManager layer2;
+		layer1.create_resource("Layer/first", "string");
+		layered.add_resources(layer1);
+		layered.add_resources(resources);
+		if (!layered.resource_exists("Layer/first")) fail();
+		if (!layered.resource_exists("Configuration/name")) fail();
+		if (layered.resource_exists("Layer/second")) fail();
+
+		layered.add_resources(layer2);
+		layer2.create_resource("Layer/second", "string");
+		if (!layered.resource_exists("Layer/second")) fail();
+		if (!(layered.get_resource("Layer/second").get_manager() == layer2)) fail();
+
+		layered.remove_resources(layer2);
+		if (layered.resource_exists("Layer/second")) fail();
+	}
+
+	CL_Console::write_line("   Function: save_compiled() and load_compiled()");
+	{
+		CL_DataBuffer buffer;
+		CL_IODevice_Memory compiled(buffer);
+		resources.save_compiled(compiled);
+		compiled.seek(0);
+
+		CL_ResourceManager loaded;
+		loaded.load_compiled(compiled);
+		if (loaded.get_resource_names() != resources.get_resource_names()) fail();
+		if (loaded.get_integer_resource("Configuration/width", 0) != config_width) fail();
+		if (loaded.get_resource("Classes/Mage").get_element().get_attribute("magic") != "200") fail();
+	}
 }
 
@@ -0,0 +1,165 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include "test.h"
+#include <new>
+#include <cstdlib>
+
+// Counts heap allocations made by the test program, to check that invoke does not allocate.
+static int allocation_count = 0;
+
+void *operator new(size_t size)
+{
+	allocation_count++;
+	void *p = malloc(size ? size : 1);
+	if (p == 0)
+		throw std::bad_alloc();
+	return p;
+}
+
+void operator delete(void *p) throw()
+{
+	free(p);
+}
+
+class SignalCheck
+{
+public:
+	SignalCheck() : calls_a(0), calls_b(0), calls_c(0), sum(0), signal_owner(0) { }
+
+	void on_a(int value) { calls_a++; sum += value; }
+	void on_b(int value) { calls_b++; sum += value; }
+	void on_c(int value) { calls_c++; sum += value; }
+
+	void on_destroy_b(int value) { calls_a++; slot_b.destroy(); }
+	void on_connect_c(int value) { calls_a++; slot_c = sig.connect(this, &SignalCheck::on_c); }
+	void on_delete_owner(int value) { calls_a++; delete signal_owner; signal_owner = 0; }
+
+	int calls_a, calls_b, calls_c;
+	int sum;
+	CL_Signal_v1<int> sig;
+	CL_Slot slot_b, slot_c;
+	CL_Signal_v1<int> *signal_owner;
+};
+
+void TestApp::test_signal()
+{
+	CL_Console::write_line(" Header: signal_v1.h");
+	CL_Console::write_line("  Class: CL_Signal_v1");
+
+	CL_Console::write_line("   Function: invoke() with inline and overflow slots");
+	{
+		SignalCheck check;
+		CL_Slot slot_a = check.sig.connect(&check, &SignalCheck::on_a);
+		check.sig.invoke(1);
+		if (check.calls_a != 1 || check.sum != 1)
+			fail();
+		CL_Slot slot_b = check.sig.connect(&check, &SignalCheck::on_b);
+		CL_Slot slot_c = check.sig.connect(&check, &SignalCheck::on_c);
+		check.sig.invoke(2);
+		if (check.calls_a != 2 || check.calls_b != 1 || check.calls_c != 1 || check.sum != 7)
+			fail();
+	}
+
+	CL_Console::write_line("   Function: CL_Slot::destroy() and disable()");
+	{
+		SignalCheck check;
+		CL_Slot slot_a = check.sig.connect(&check, &SignalCheck::on_a);
+		CL_Slot slot_b = check.sig.connect(&check, &SignalCheck::on_b);
+		CL_Slot slot_c = check.sig.connect(&check, &SignalCheck::on_c);
+		slot_a.destroy();
+		slot_c.disable();
+		check.sig.invoke(1);
+		if (check.calls_a != 0 || check.calls_b != 1 || check.calls_c != 0)
+			fail();
+		slot_c.enable();
+		CL_Slot slot_d = check.sig.connect(&check, &SignalCheck::on_c); // Removes the destroyed slot
+		check.sig.invoke(1);
+		if (check.calls_a != 0 || check.calls_b != 2 || check.calls_c != 2)
+			fail();
+	}
+
+	CL_Console::write_line("   Function: invoke() with a slot destroying a later slot");
+	{
+		SignalCheck check;
+		CL_Slot slot_a = check.sig.connect(&check, &SignalCheck::on_destroy_b);
+		check.slot_b = check.sig.connect(&check, &SignalCheck::on_b);
+		check.sig.invoke(1);
+		if (check.calls_a != 1 || check.calls_b != 0)
+			fail();
+	}
+
+	CL_Console::write_line("   Function: invoke() with a slot connecting a new slot");
+	{
+		SignalCheck check;
+		CL_Slot slot_a = check.sig.connect(&check, &SignalCheck::on_connect_c);
+		CL_Slot slot_b = check.sig.connect(&check, &SignalCheck::on_b);
+		check.sig.invoke(1);
+		if (check.calls_a != 1 || check.calls_b != 1 || check.calls_c != 0)
+			fail();
+		slot_a.destroy();
+		check.sig.invoke(1);
+		if (check.calls_a != 1 || check.calls_b != 2 || check.calls_c != 1)
+			fail();
+	}
+
+	CL_Console::write_line("   Function: invoke() with a slot deleting the signal");
+	{
+		SignalCheck check;
+		check.signal_owner = new CL_Signal_v1<int>;
+		CL_Slot slot_a = check.signal_owner->connect(&check, &SignalCheck::on_delete_owner);
+		CL_Slot slot_b = check.signal_owner->connect(&check, &SignalCheck::on_b);
+		CL_Signal_v1<int> *signal = check.signal_owner;
+		signal->invoke(1);
+		if (check.signal_owner != 0 || check.calls_a != 1 || check.calls_b != 1)
+			fail();
+	}
+
+	CL_Console::write_line("   Function: invoke() does not allocate memory");
+	{
+		SignalCheck check;
+		CL_Slot slot_a = check.sig.connect(&check, &SignalCheck::on_a);
+		CL_Slot slot_b = check.sig.connect(&check, &SignalCheck::on_b);
+		CL_Slot slot_c = check.sig.connect(&check, &SignalCheck::on_c);
+
+		const int iterations = 1000000;
+		unsigned int start_time = CL_System::get_time();
+		int allocations_before = allocation_count;
+		for (int i = 0; i < iterations; i++)
+			check.sig.invoke(i);
+		int allocations = allocation_count - allocations_before;
+		unsigned int end_time = CL_System::get_time();
+		if (allocations != 0)
+			fail();
+		if (check.calls_a != iterations || check.calls_c != iterations)
+			fail();
+
+		CL_Console::write_line("    %1 invokes with 3 slots took %2 ms", iterations, (int)(end_time - start_time));
+	}
+}
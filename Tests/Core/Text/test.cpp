@@ -71,6 +71,8 @@ int TestApp::main(const std::vector<CL_String> &args)
 		CL_Console::write_line(" - %1", test_stringref());
 		
 		test_string();
+		test_string_move();
+		test_string_format();
 
 		CL_Console::write_line("All Tests Complete");
 		console.display_close_message();
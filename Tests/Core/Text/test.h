@@ -57,6 +57,21 @@
 
 extern int g_bConstructor;
 extern int g_bDestructor;
+extern int g_allocation_count;
+extern size_t g_allocation_bytes;
+
+class AllocationCounter
+{
+public:
+	AllocationCounter() : start_count(g_allocation_count), start_bytes(g_allocation_bytes) { }
+
+	int get_count() const { return g_allocation_count - start_count; }
+	size_t get_bytes() const { return g_allocation_bytes - start_bytes; }
+
+private:
+	int start_count;
+	size_t start_bytes;
+};
 
 class MyClass
 {
@@ -74,6 +89,8 @@ private:
 	CL_StringRef test_stringref();
 	CL_String str;
 	void test_string();
+	void test_string_move();
+	void test_string_format();
 
 	void fail();
 };
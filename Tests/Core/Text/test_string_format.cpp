@@ -0,0 +1,206 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include "test.h"
+#include <cstdio>
+
+static CL_String printf_text(const char *format, double value, int num_decimals)
+{
+	char buffer[512];
+#ifdef WIN32
+	_snprintf(buffer, 511, format, num_decimals, value);
+#else
+	snprintf(buffer, 511, format, num_decimals, value);
+#endif
+	buffer[511] = 0;
+	return buffer;
+}
+
+void TestApp::test_string_format()
+{
+	CL_Console::write_line(" Header: string_format_buffer.h");
+	CL_Console::write_line("  Class: CL_StringFormatBuffer");
+
+	CL_Console::write_line("   Function: append(int) and append(long long)");
+	{
+		CL_StringFormatBuffer buffer;
+		buffer.append(0); buffer.append_char(' ');
+		buffer.append(-7); buffer.append_char(' ');
+		buffer.append(2147483647); buffer.append_char(' ');
+		buffer.append((int) 0x80000000); buffer.append_char(' ');
+		buffer.append(4294967295u); buffer.append_char(' ');
+		buffer.append(-9223372036854775807LL - 1); buffer.append_char(' ');
+		buffer.append(18446744073709551615ULL); buffer.append_char(' ');
+		buffer.append(42, 5); buffer.append_char(' ');
+		buffer.append(-42, 5);
+		if (CL_StringRef(buffer.c_str()) != "0 -7 2147483647 -2147483648 4294967295 -9223372036854775808 18446744073709551615 00042 -00042") fail();
+		if (buffer.length() != (int) buffer.get_text().length()) fail();
+
+		if (CL_StringHelp::ll_to_text(10000000000LL) != "10000000000") fail();
+		if (CL_StringHelp::ull_to_text(10000000000ULL) != "10000000000") fail();
+	}
+
+	CL_Console::write_line("   Function: append(double)");
+	{
+		const double values[] = { 0.0, -0.0, 1.0, -1.5, 0.5, 2.5, 0.125, 1.005, 3.14159265358979, -2.0000005, 123456.789, 1e-7, -1e-7, 999999.9999999, 1e14, 1e20, 1.7e308 };
+		for (int decimals = 0; decimals <= 12; decimals++)
+		{
+			for (int i = 0; i < (int) (sizeof(values) / sizeof(values[0])); i++)
+			{
+				CL_StringFormatBuffer buffer;
+				buffer.append(values[i], decimals);
+				if (CL_String(buffer.get_text()) != printf_text("%.*f", values[i], decimals)) fail();
+			}
+		}
+
+		unsigned int seed = 1;
+		for (int i = 0; i < 100000; i++)
+		{
+			seed = seed * 1103515245 + 12345;
+			double value = ((int) (seed >> 8) - (1 << 23)) / 1024.0;
+			int decimals = (seed >> 4) % 8;
+			CL_StringFormatBuffer buffer;
+			buffer.append(value, decimals);
+			if (CL_String(buffer.get_text()) != printf_text("%.*f", value, decimals)) fail();
+		}
+
+		if (CL_StringHelp::float_to_text(1.25f) != "1.250000") fail();
+		if (CL_StringHelp::double_to_text(-2.5, 2) != "-2.50") fail();
+	}
+
+	CL_Console::write_line("   Function: CL_StringFormatBuffer(char *, int)");
+	{
+		char memory[8];
+		CL_StringFormatBuffer buffer(memory, 8);
+		buffer.append("1234");
+		if (buffer.is_truncated()) fail();
+		buffer.append(567890);
+		if (!buffer.is_truncated()) fail();
+		if (CL_StringRef(memory) != "1234567") fail();
+		buffer.clear();
+		if (buffer.is_truncated() || buffer.length() != 0 || memory[0] != 0) fail();
+	}
+
+	CL_Console::write_line("   Function: append beyond local storage");
+	{
+		CL_StringFormatBuffer buffer;
+		for (int i = 0; i < 1000; i++)
+			buffer.append(i);
+		CL_String expected;
+		for (int i = 0; i < 1000; i++)
+			expected += CL_StringHelp::int_to_text(i);
+		if (CL_String(buffer.get_text()) != expected) fail();
+	}
+
+	CL_Console::write_line("  Function: cl_format_to");
+	{
+		CL_StringFormatBuffer buffer;
+		cl_format_to(buffer, "%1 + %2 = %3%%, %4 %0 %9 %", 1, 2.5f, CL_String("three"), "four");
+		if (CL_StringRef(buffer.c_str()) != "1 + 2.500000 = three%, four %0 %9 %") fail();
+
+		buffer.clear();
+		cl_format_to(buffer, "%2%1%%%2", 'a', (unsigned int) 7);
+		if (CL_StringRef(buffer.c_str()) != "797%7") fail();
+	}
+
+	CL_Console::write_line("  Class: CL_StringFormatPattern");
+	{
+		CL_StringFormatPattern pattern("[%1] %2%% of %3 (%4)");
+		CL_StringFormatBuffer buffer;
+		cl_format_to(buffer, pattern, "load", 75, 4096ULL);
+		if (CL_StringRef(buffer.c_str()) != "[load] 75% of 4096 (%4)") fail();
+
+		buffer.clear();
+		cl_format_to(buffer, pattern, "x", "y", "z", "w");
+		if (CL_StringRef(buffer.c_str()) != "[x] y% of z (w)") fail();
+	}
+
+	CL_Console::write_line("  Function: cl_format");
+	{
+		if (cl_format("%1-%2-%3-%4-%5-%6-%7", 1, 2, 3, 4, 5, 6, 7) != "1-2-3-4-5-6-7") fail();
+		if (cl_format("%1", CL_StringRef("ref")) != "ref") fail();
+
+		CL_StringFormat format("%1 of %2 at %3");
+		format.set_arg(1, 5, 3);
+		format.set_arg(2, "ten");
+		format.set_arg(3, 0.5);
+		if (format.get_result() != "005 of ten at 0.500000") fail();
+	}
+
+	CL_Console::write_line("  Function: repeated arguments");
+	{
+		// cl_format and CL_StringFormat both replace every occurrence
+		if (cl_format("%1 %2 %1%1 %3", "a", 22, "ccc") != "a 22 aa ccc") fail();
+		if (cl_format("%2%% %1 %2", "x", "y") != "y% x y") fail();
+
+		CL_StringFormat format("%1 %2 %1%1 %3");
+		format.set_arg(1, "a");
+		format.set_arg(2, 22);
+		format.set_arg(3, "ccc");
+		if (format.get_result() != "a 22 aa ccc") fail();
+		format.set_arg(1, "long");
+		if (format.get_result() != "long 22 longlong ccc") fail();
+
+		CL_StringFormat format2("%2%% %1 %2");
+		format2.set_arg(1, "x");
+		format2.set_arg(2, "y");
+		if (format2.get_result() != "y% x y") fail();
+	}
+
+	CL_Console::write_line("   Benchmark: allocations per formatted line");
+	{
+		const int count = 100000;
+		CL_String name("connection");
+		CL_StringFormatPattern pattern("%1 %2 sent %3 bytes in %4 ms");
+
+		AllocationCounter cl_format_counter;
+		unsigned int checksum = 0;
+		CL_String result;
+		for (int i = 0; i < count; i++)
+		{
+			result = cl_format("%1 %2 sent %3 bytes in %4 ms", name, i, i * 13, i * 0.25);
+			checksum += result.length();
+		}
+		CL_Console::write_line("     cl_format: %1 allocations", cl_format_counter.get_count());
+
+		AllocationCounter format_to_counter;
+		unsigned int checksum_to = 0;
+		for (int i = 0; i < count; i++)
+		{
+			CL_StringFormatBuffer buffer;
+			cl_format_to(buffer, pattern, name, i, i * 13, i * 0.25);
+			checksum_to += buffer.length();
+		}
+		int format_to_allocations = format_to_counter.get_count();
+		CL_Console::write_line("     cl_format_to: %1 allocations", format_to_allocations);
+
+		if (checksum != checksum_to) fail();
+		if (format_to_allocations != 0) fail();
+	}
+}
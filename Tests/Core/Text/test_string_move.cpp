@@ -0,0 +1,165 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include "test.h"
+#include <new>
+#include <cstdlib>
+
+// Counts heap allocations and bytes requested by the test program, to compare copies against moves.
+int g_allocation_count = 0;
+size_t g_allocation_bytes = 0;
+
+void *operator new(size_t size)
+{
+	g_allocation_count++;
+	g_allocation_bytes += size;
+	void *p = malloc(size ? size : 1);
+	if (p == 0)
+		throw std::bad_alloc();
+	return p;
+}
+
+void operator delete(void *p) throw()
+{
+	free(p);
+}
+
+static CL_String make_long_string(int index)
+{
+	CL_String str(100, 'x');
+	str += CL_StringHelp::int_to_text(index);
+	return str;
+}
+
+static void write_counts(const char *name, const AllocationCounter &counter)
+{
+	CL_Console::write_line("     %1: %2 allocations, %3 bytes", name, counter.get_count(), (int) counter.get_bytes());
+}
+
+void TestApp::test_string_move()
+{
+	CL_Console::write_line(" Header: string8.h");
+	CL_Console::write_line("  Class: CL_String8");
+
+#ifdef CL_HAS_RVALUE_REFERENCES
+	CL_Console::write_line("   Function: CL_String8(CL_String8 &&)");
+	{
+		CL_String source = make_long_string(1);
+		const char *buffer = source.data();
+		CL_String dest(cl_move(source));
+		if (dest.data() != buffer) fail();
+		if (dest != make_long_string(1)) fail();
+		if (!source.empty()) fail();
+		source = "reused";
+		if (source != "reused") fail();
+
+		CL_String short_source("short");
+		CL_String short_dest(cl_move(short_source));
+		if (short_dest != "short") fail();
+		if (!short_source.empty()) fail();
+	}
+
+	CL_Console::write_line("   Function: operator =(CL_String8 &&)");
+	{
+		CL_String source = make_long_string(2);
+		CL_String dest = make_long_string(3);
+		const char *buffer = source.data();
+		dest = cl_move(source);
+		if (dest.data() != buffer) fail();
+		if (dest != make_long_string(2)) fail();
+		if (!source.empty()) fail();
+
+		dest = CL_String("short");
+		if (dest != "short") fail();
+	}
+
+	CL_Console::write_line("   Function: operator+(CL_String8 &&, ...)");
+	{
+		CL_String str = make_long_string(4) + "a" + CL_String("b") + 'c';
+		if (str != make_long_string(4) + CL_String("abc")) fail();
+	}
+
+	CL_Console::write_line(" Header: string_ref8.h");
+	CL_Console::write_line("  Class: CL_StringRef8");
+
+	CL_Console::write_line("   Function: CL_StringRef8(CL_StringRef8 &&)");
+	{
+		CL_String str = make_long_string(5);
+		CL_StringRef source(str.data(), str.length(), false);
+		const char *terminated = source.c_str();
+		CL_StringRef dest(cl_move(source));
+		if (dest.c_str() != terminated) fail();
+		if (dest != str) fail();
+		if (!source.empty()) fail();
+	}
+#endif
+
+	CL_Console::write_line("   Benchmark: copies compared to moves");
+	{
+		const int count = 10000;
+
+		CL_String prefix = make_long_string(0);
+		std::vector<CL_String> copied;
+		AllocationCounter copy_counter;
+		for (int i = 0; i < count; i++)
+		{
+			CL_String item = prefix;
+			item += "-";
+			item += CL_StringHelp::int_to_text(i);
+			copied.push_back(item);
+		}
+		std::vector<CL_String> copied_result = copied;
+		write_counts("copy", copy_counter);
+
+		std::vector<CL_String> moved;
+		AllocationCounter move_counter;
+		for (int i = 0; i < count; i++)
+		{
+			CL_String item = prefix;
+			item += "-";
+			item += CL_StringHelp::int_to_text(i);
+			moved.push_back(cl_move(item));
+		}
+		std::vector<CL_String> moved_result(cl_move(moved));
+		write_counts("move", move_counter);
+
+		if (copied_result != moved_result) fail();
+#ifdef CL_HAS_RVALUE_REFERENCES
+		if (move_counter.get_bytes() >= copy_counter.get_bytes()) fail();
+#endif
+
+		AllocationCounter concat_counter;
+		for (int i = 0; i < count; i++)
+		{
+			CL_String str = prefix + "-" + CL_StringHelp::int_to_text(i) + "-" + prefix;
+			if (str.length() < prefix.length() * 2) fail();
+		}
+		write_counts("concatenation", concat_counter);
+	}
+}
@@ -24,6 +24,72 @@ void TestXMLFile(const CL_String &filename)
 	CL_Console::write_line("");
 }
 
+void TestXMLReader(const CL_String &filename)
+{
+	try
+	{
+		CL_Console::write_line("%1 (CL_XMLReader)", filename);
+
+		CL_File file(filename, CL_File::open_existing, CL_File::access_read);
+		CL_XMLReader reader(file);
+		while (reader.read())
+		{
+			if (reader.is_element_begin() && reader.get_depth() == 0)
+			{
+				CL_Console::write_line(reader.get_attribute("letters"));
+				break;
+			}
+		}
+	}
+	catch(CL_Exception error)
+	{
+		CL_Console::write_line("Exception caught:");
+		CL_Console::write_line(error.message);
+	}
+	CL_Console::write_line("");
+}
+
+bool TestXMLReaderLineNumbers(CL_XMLReader &reader)
+{
+	// Element "e<N>" begins on line N:
+	while (reader.read())
+	{
+		if (reader.is_element_begin() && reader.get_depth() == 1)
+		{
+			int line = CL_StringHelp::text_to_int(reader.get_name().substr(1));
+			if (reader.get_line_number() != line)
+				return false;
+		}
+	}
+	return true;
+}
+
+void TestXMLReaderLineNumbers()
+{
+	CL_Console::write_line("Line numbers (CL_XMLReader)");
+
+	CL_String text = "<root>\n";
+	for (int line = 2; line < 2000; line += 2 + line % 3)
+	{
+		text += cl_format("<e%1 value=\"%2\">text\n</e%1>\n", line, line);
+		for (int i = 0; i < line % 3; i++)
+			text += "\n";
+	}
+	text += "</root>\n";
+
+	CL_XMLReader memory_reader(text.data(), text.length());
+	bool memory_ok = TestXMLReaderLineNumbers(memory_reader);
+
+	// A small buffer discards data before the current token many times:
+	CL_DataBuffer data(text.data(), text.length());
+	CL_IODevice_Memory device(data);
+	CL_XMLReader stream_reader(device, 256);
+	bool stream_ok = TestXMLReaderLineNumbers(stream_reader);
+
+	CL_Console::write_line(memory_ok && stream_ok ? "Line numbers match" : "Line numbers do not match");
+	CL_Console::write_line("");
+}
+
 int main(int, char**)
 {
 	CL_SetupCore setup_core;
@@ -35,5 +101,12 @@ int main(int, char**)
 	TestXMLFile("test-notepad-unicode.xml");
 	TestXMLFile("test-notepad-ansi.xml");
 
+	TestXMLReader("test-emeditor-utf8-withoutsignature.xml");
+	TestXMLReader("test-emeditor-utf8-withsignature.xml");
+	TestXMLReader("test-notepad-utf8.xml");
+	TestXMLReader("test-notepad-unicode.xml");
+
+	TestXMLReaderLineNumbers();
+
 	return 0;
 }
@@ -1,12 +1,8 @@
 
 #include <ClanLib/core.h>
 
-void evaluate(const CL_String &xpath, const CL_DomDocument &document)
+void write_result(const CL_XPathObject &result)
 {
-	CL_Console::write_line(L"Evaluating XPath '%1'", xpath);
-
-	CL_XPathEvaluator evaluator;
-	CL_XPathObject result = evaluator.evaluate(xpath, document);
 	switch (result.get_type())
 	{
 	case CL_XPathObject::type_null:
@@ -38,6 +34,26 @@ void evaluate(const CL_String &xpath, const CL_DomDocument &document)
 	CL_Console::write_line("");
 }
 
+void evaluate(const CL_String &xpath, const CL_DomDocument &document)
+{
+	CL_Console::write_line(L"Evaluating XPath '%1'", xpath);
+
+	CL_XPathEvaluator evaluator;
+	write_result(evaluator.evaluate(xpath, document));
+}
+
+void evaluate_compiled(const CL_String &xpath, const CL_DomDocument &document)
+{
+	CL_XPathEvaluator evaluator;
+	CL_XPathExpression expression = evaluator.compile(xpath);
+	CL_Console::write_line(L"Evaluating compiled XPath '%1' (simple path: %2)", expression.get_text(), expression.is_simple_path() ? "yes" : "no");
+
+	CL_XPathObject result;
+	for (int i = 0; i < 1000; i++)
+		result = evaluator.evaluate(expression, document);
+	write_result(result);
+}
+
 int main(int, char**)
 {
 	CL_SetupCore setup_core;
@@ -51,6 +67,8 @@ int main(int, char**)
 // 		evaluate("root/child/child[2]/following::*", document);
 // 		evaluate("root/child/child[2]/childchild[2]/preceding::*", document);
 		evaluate("//child/attribute::type", document);
+		evaluate_compiled("/root/child/childchild", document);
+		evaluate_compiled("root/child[@foo]/childchild", document);
 
 // 		evaluate("6 mod 4", document);
 // 		evaluate("/root/child/childchild", document);
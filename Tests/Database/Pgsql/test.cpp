@@ -0,0 +1,192 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include "test.h"
+
+// This is the Program class that is called by CL_ClanApplication
+class Program
+{
+public:
+	static int main(const std::vector<CL_String> &args)
+	{
+		// Initialize ClanLib base components
+		CL_SetupCore setup_core;
+
+		// Start the Application
+		TestApp app;
+		int retval = app.main(args);
+		return retval;
+	}
+};
+
+// Instantiate CL_ClanApplication, informing it where the Program is located
+CL_ClanApplication app(&Program::main);
+
+int TestApp::main(const std::vector<CL_String> &args)
+{
+	// Create a console window for text-output if not available
+	CL_ConsoleWindow console("Console");
+
+	try
+	{
+		CL_Console::write_line("ClanLib Test Suite:");
+		CL_Console::write_line("-------------------");
+		CL_Console::write_line("For clanPgsql binary results and columnar fetch");
+
+		// Connects to the local server with the libpq defaults, unless a connection string is given:
+		CL_String connection_string;
+		if (args.size() > 1)
+			connection_string = args[1];
+
+		CL_PgsqlConnection db(connection_string);
+		CL_DBCommand create = db.create_command(
+			"CREATE TEMPORARY TABLE report (id INTEGER, amount BIGINT, price DOUBLE PRECISION, active BOOLEAN, "
+			"name VARCHAR(40), created TIMESTAMP, day DATE, data BYTEA, total NUMERIC(10,2))");
+		db.execute_non_query(create);
+
+		CL_DBCommand insert = db.create_command(
+			"INSERT INTO report SELECT i, i * 1000000000::BIGINT, i * 0.5, i % 2 = 0, 'row ' || i, "
+			"TIMESTAMP '2012-05-06 07:08:09' + i * INTERVAL '1 day', DATE '2012-05-06' + i, '\\x0102'::BYTEA, i * 1.25 "
+			"FROM generate_series(1, 1000) AS i");
+		db.execute_non_query(insert);
+
+		test_binary_results(db);
+		test_retrieve_rows(db);
+
+		CL_Console::write_line("All Tests Complete");
+		console.display_close_message();
+	}
+	catch(CL_Exception error)
+	{
+		CL_Console::write_line("Exception caught:");
+		CL_Console::write_line(error.message);
+		console.display_close_message();
+		return -1;
+	}
+
+	return 0;
+}
+
+void TestApp::fail()
+{
+	throw CL_Exception("Failed Test");
+}
+
+void TestApp::test_binary_results(CL_PgsqlConnection &db)
+{
+	CL_Console::write_line("   Function: set_binary_results()");
+
+	// Both formats must give the same values:
+	for (int binary = 0; binary < 2; binary++)
+	{
+		db.set_binary_results(binary != 0);
+
+		CL_DBCommand command = db.create_command("SELECT id, amount, price, active, name, created, day, data FROM report WHERE id = ?");
+		command.set_input_parameter_int(1, 3);
+		CL_DBReader reader = db.execute_reader(command);
+		if (!reader.retrieve_row())
+			fail();
+
+		if (reader.get_column_int("id") != 3 || reader.get_column_string("amount") != "3000000000")
+			fail();
+		if (reader.get_column_double("price") != 1.5 || reader.get_column_string("price") != "1.5")
+			fail();
+		if (reader.get_column_bool("active") || reader.get_column_string("active") != "f")
+			fail();
+		if (reader.get_column_string("name") != "row 3")
+			fail();
+		if (reader.get_column_datetime("created") != CL_DateTime(2012, 5, 9, 7, 8, 9))
+			fail();
+		if (reader.get_column_string("created") != "2012-05-09 07:08:09")
+			fail();
+		if (reader.get_column_datetime("day") != CL_DateTime(2012, 5, 9) || reader.get_column_string("day") != "2012-05-09")
+			fail();
+
+		CL_DataBuffer data = reader.get_column_binary("data");
+		if (data.get_size() != 2 || data.get_data()[0] != 1 || data.get_data()[1] != 2)
+			fail();
+		reader.close();
+
+		// Numeric columns have no binary decoder, so their statements stay in text format:
+		CL_DBCommand numeric = db.create_command("SELECT id, total FROM report WHERE id = ?");
+		numeric.set_input_parameter_int(1, 3);
+		reader = db.execute_reader(numeric);
+		if (!reader.retrieve_row() || reader.get_column_string(1) != "3.75" || reader.get_column_double(1) != 3.75)
+			fail();
+		reader.close();
+	}
+}
+
+void TestApp::test_retrieve_rows(CL_PgsqlConnection &db)
+{
+	CL_Console::write_line("   Function: retrieve_rows()");
+
+	const int max_rows = 128;
+	int ids[max_rows];
+	double prices[max_rows];
+	CL_String names[max_rows];
+	CL_DateTime days[max_rows];
+
+	for (int binary = 0; binary < 2; binary++)
+	{
+		db.set_binary_results(binary != 0);
+
+		CL_DBCommand command = db.create_command("SELECT id, price, name, day FROM report ORDER BY id");
+		cl_ubyte64 start_time = CL_System::get_microseconds();
+		CL_DBReader reader = db.execute_reader(command);
+		reader.bind_column("id", ids);
+		reader.bind_column("price", prices);
+		reader.bind_column("name", names);
+		reader.bind_column("day", days);
+
+		int total = 0;
+		while (true)
+		{
+			int count = reader.retrieve_rows(max_rows);
+			if (count == 0)
+				break;
+			for (int i = 0; i < count; i++)
+			{
+				int id = total + i + 1;
+				if (ids[i] != id || prices[i] != id * 0.5 || names[i] != cl_format("row %1", id))
+					fail();
+			}
+			if (days[0].get_year() != 2012)
+				fail();
+			total += count;
+		}
+		reader.close();
+		int fetch_time = (int) (CL_System::get_microseconds() - start_time);
+		CL_Console::write_line("      %1 rows in %2 ms (%3 format)", total, fetch_time / 1000, binary ? "binary" : "text");
+
+		if (total != 1000)
+			fail();
+	}
+	db.set_binary_results(false);
+}
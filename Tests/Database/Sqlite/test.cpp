@@ -0,0 +1,319 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include "test.h"
+
+// This is the Program class that is called by CL_ClanApplication
+class Program
+{
+public:
+	static int main(const std::vector<CL_String> &args)
+	{
+		// Initialize ClanLib base components
+		CL_SetupCore setup_core;
+
+		// Start the Application
+		TestApp app;
+		int retval = app.main(args);
+		return retval;
+	}
+};
+
+// Instantiate CL_ClanApplication, informing it where the Program is located
+CL_ClanApplication app(&Program::main);
+
+int TestApp::main(const std::vector<CL_String> &args)
+{
+	// Create a console window for text-output if not available
+	CL_ConsoleWindow console("Console");
+
+	try
+	{
+		CL_Console::write_line("ClanLib Test Suite:");
+		CL_Console::write_line("-------------------");
+		CL_Console::write_line("For clanSqlite prepared statements and batches");
+
+		const CL_String filename = "test.sqlite3";
+		if (CL_FileHelp::file_exists(filename))
+			CL_FileHelp::delete_file(filename);
+
+		{
+			CL_SqliteConnection db(filename);
+			CL_DBCommand create = db.create_command("CREATE TABLE telemetry (id INTEGER PRIMARY KEY, name TEXT, value DOUBLE, data BLOB)");
+			db.execute_non_query(create);
+
+			test_statement_cache(db);
+			test_batch(db);
+			test_batch_failure(db);
+			test_retrieve_rows(db);
+		}
+		test_busy_timeout(filename);
+
+		CL_FileHelp::delete_file(filename);
+
+		CL_Console::write_line("All Tests Complete");
+		console.display_close_message();
+	}
+	catch(CL_Exception error)
+	{
+		CL_Console::write_line("Exception caught:");
+		CL_Console::write_line(error.message);
+		console.display_close_message();
+		return -1;
+	}
+
+	return 0;
+}
+
+void TestApp::fail()
+{
+	throw CL_Exception("Failed Test");
+}
+
+int TestApp::count_rows(CL_SqliteConnection &db)
+{
+	CL_DBCommand command = db.create_command("SELECT COUNT(*) FROM telemetry");
+	return db.execute_scalar_int(command);
+}
+
+void TestApp::test_statement_cache(CL_SqliteConnection &db)
+{
+	CL_Console::write_line("   Function: set_statement_cache_size()");
+
+	// A command created again with the same text reuses the cached statement, without its old parameters:
+	for (int i = 0; i < 100; i++)
+	{
+		CL_DBCommand command = db.create_command("INSERT INTO telemetry (name, value) VALUES (?1, ?2)");
+		if (i % 2 == 0)
+			command.set_input_parameter_string(1, "cached");
+		command.set_input_parameter_double(2, i);
+		db.execute_non_query(command);
+	}
+	CL_DBCommand count_null = db.create_command("SELECT COUNT(*) FROM telemetry WHERE name IS NULL");
+	if (db.execute_scalar_int(count_null) != 50)
+		fail();
+
+	// Two commands with the same text may be used at the same time:
+	CL_DBCommand first = db.create_command("SELECT value FROM telemetry WHERE value = ?1");
+	CL_DBCommand second = db.create_command("SELECT value FROM telemetry WHERE value = ?1");
+	first.set_input_parameter_int(1, 3);
+	second.set_input_parameter_int(1, 4);
+	if (db.execute_scalar_int(first) != 3 || db.execute_scalar_int(second) != 4)
+		fail();
+
+	// A command destroyed while its reader is still open:
+	{
+		CL_DBReader reader;
+		{
+			CL_DBCommand command = db.create_command("SELECT value FROM telemetry ORDER BY value");
+			reader = db.execute_reader(command);
+		}
+		if (!reader.retrieve_row() || reader.get_column_int(0) != 0)
+			fail();
+		reader.close();
+	}
+	CL_DBCommand after_reader = db.create_command("SELECT value FROM telemetry ORDER BY value");
+	if (db.execute_scalar_int(after_reader) != 0)
+		fail();
+
+	db.set_statement_cache_size(0);
+	CL_DBCommand uncached = db.create_command("SELECT COUNT(*) FROM telemetry");
+	if (db.execute_scalar_int(uncached) != 100)
+		fail();
+	db.set_statement_cache_size(16);
+
+	CL_DBCommand clear = db.create_command("DELETE FROM telemetry");
+	db.execute_non_query(clear);
+}
+
+void TestApp::test_batch(CL_SqliteConnection &db)
+{
+	CL_Console::write_line("   Function: execute_batch()");
+
+	const int num_rows = 10000;
+	CL_DBCommand command = db.create_command("INSERT INTO telemetry (name, value, data) VALUES (?1, ?2, ?3)");
+	command.set_input_parameter_binary(3, CL_DataBuffer("blob", 4));
+	for (int i = 0; i < num_rows; i++)
+	{
+		command.set_input_parameter_string(1, cl_format("sensor %1", i % 10));
+		command.set_input_parameter_double(2, i * 0.5);
+		command.add_batch();
+	}
+	if (command.get_batch_size() != num_rows)
+		fail();
+
+	cl_ubyte64 start_time = CL_System::get_microseconds();
+	db.execute_batch(command);
+	int batch_time = (int) (CL_System::get_microseconds() - start_time);
+	CL_Console::write_line("      %1 rows in %2 ms", num_rows, batch_time / 1000);
+
+	if (command.get_batch_size() != 0)
+		fail();
+	if (count_rows(db) != num_rows)
+		fail();
+
+	CL_DBCommand check = db.create_command("SELECT name, value, data FROM telemetry WHERE id = ?1");
+	check.set_input_parameter_int(1, command.get_output_last_insert_rowid());
+	CL_DBReader reader = db.execute_reader(check);
+	if (!reader.retrieve_row())
+		fail();
+	if (reader.get_column_string(0) != "sensor 9" || reader.get_column_double(1) != (num_rows - 1) * 0.5 || reader.get_column_binary(2).get_size() != 4)
+		fail();
+	reader.close();
+
+	// The command can still be executed on its own with the last parameters:
+	db.execute_non_query(command);
+	if (count_rows(db) != num_rows + 1)
+		fail();
+
+	// Batches inside a transaction are undone with it:
+	{
+		CL_DBTransaction transaction = db.begin_transaction();
+		command.add_batch();
+		command.add_batch();
+		db.execute_batch(command);
+		if (count_rows(db) != num_rows + 3)
+			fail();
+		transaction.rollback();
+	}
+	if (count_rows(db) != num_rows + 1)
+		fail();
+
+	CL_DBCommand clear = db.create_command("DELETE FROM telemetry");
+	db.execute_non_query(clear);
+}
+
+void TestApp::test_batch_failure(CL_SqliteConnection &db)
+{
+	CL_Console::write_line("   Function: execute_batch() failing");
+
+	// The second row violates the primary key, so none of the rows may be written:
+	CL_DBCommand command = db.create_command("INSERT INTO telemetry (id, name) VALUES (?1, ?2)");
+	command.set_input_parameter_string(2, "duplicate");
+	command.set_input_parameter_int(1, 1);
+	command.add_batch();
+	command.add_batch();
+	command.set_input_parameter_int(1, 2);
+	command.add_batch();
+
+	bool failed = false;
+	try
+	{
+		db.execute_batch(command);
+	}
+	catch (CL_Exception &)
+	{
+		failed = true;
+	}
+	if (!failed || command.get_batch_size() != 0)
+		fail();
+	if (count_rows(db) != 0)
+		fail();
+}
+
+void TestApp::test_retrieve_rows(CL_SqliteConnection &db)
+{
+	CL_Console::write_line("   Function: retrieve_rows()");
+
+	const int num_rows = 250;
+	CL_DBCommand insert = db.create_command("INSERT INTO telemetry (id, name, value) VALUES (?1, ?2, ?3)");
+	for (int i = 0; i < num_rows; i++)
+	{
+		insert.set_input_parameter_int(1, i + 1);
+		insert.set_input_parameter_string(2, cl_format("sensor %1", i));
+		insert.set_input_parameter_double(3, i * 0.25);
+		insert.add_batch();
+	}
+	db.execute_batch(insert);
+
+	const int max_rows = 64;
+	int ids[max_rows];
+	double values[max_rows];
+	CL_String names[max_rows];
+
+	CL_DBCommand select = db.create_command("SELECT id, name, value FROM telemetry ORDER BY id");
+	CL_DBReader reader = db.execute_reader(select);
+	reader.bind_column(0, ids);
+	reader.bind_column("name", names);
+	reader.bind_column(2, values);
+
+	int total = 0;
+	while (true)
+	{
+		int count = reader.retrieve_rows(max_rows);
+		if (count == 0)
+			break;
+		for (int i = 0; i < count; i++)
+		{
+			if (ids[i] != total + i + 1 || names[i] != cl_format("sensor %1", total + i) || values[i] != (total + i) * 0.25)
+				fail();
+		}
+
+		// The last row retrieved is the current row, as long as the result was not exhausted:
+		if (count == max_rows && reader.get_column_int(0) != ids[count - 1])
+			fail();
+		total += count;
+	}
+	if (total != num_rows)
+		fail();
+	reader.close();
+
+	CL_DBCommand clear = db.create_command("DELETE FROM telemetry");
+	db.execute_non_query(clear);
+}
+
+void TestApp::test_busy_timeout(const CL_String &filename)
+{
+	CL_Console::write_line("   Function: set_busy_timeout()");
+
+	CL_SqliteConnection db1(filename);
+	CL_SqliteConnection db2(filename);
+	db2.set_busy_timeout(200);
+
+	CL_DBTransaction transaction = db1.begin_transaction(CL_DBTransaction::exclusive);
+
+	cl_ubyte64 start_time = CL_System::get_microseconds();
+	bool busy = false;
+	try
+	{
+		CL_DBCommand command = db2.create_command("INSERT INTO telemetry (name) VALUES ('blocked')");
+		db2.execute_non_query(command);
+	}
+	catch (CL_Exception &)
+	{
+		busy = true;
+	}
+	int wait_time = (int) ((CL_System::get_microseconds() - start_time) / 1000);
+	if (!busy || wait_time < 150)
+		fail();
+
+	transaction.commit();
+	CL_DBCommand command = db2.create_command("INSERT INTO telemetry (name) VALUES ('unblocked')");
+	db2.execute_non_query(command);
+}
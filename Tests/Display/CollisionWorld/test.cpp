@@ -0,0 +1,274 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include "test.h"
+
+// This is the Program class that is called by CL_ClanApplication
+class Program
+{
+public:
+	static int main(const std::vector<CL_String> &args)
+	{
+		// Initialize ClanLib base components
+		CL_SetupCore setup_core;
+
+		// Start the Application
+		TestApp app;
+		int retval = app.main(args);
+		return retval;
+	}
+};
+
+// Instantiate CL_ClanApplication, informing it where the Program is located
+CL_ClanApplication app(&Program::main);
+
+int TestApp::main(const std::vector<CL_String> &args)
+{
+	// Create a console window for text-output if not available
+	CL_ConsoleWindow console("Console");
+
+	try
+	{
+		CL_Console::write_line("ClanLib Test Suite:");
+		CL_Console::write_line("-------------------");
+		CL_Console::write_line("For CL_CollisionWorld");
+
+		srand(1);
+		test_pairs(500, 0);
+		test_pairs(500, 3);
+		test_remove_and_query();
+
+		CL_Console::write_line("outlines step_us brute_force_us candidate_pairs collisions");
+		const int outline_counts[] = { 100, 1000, 4000 };
+		for (int i = 0; i < sizeof(outline_counts) / sizeof(int); i++)
+			run_benchmark(outline_counts[i]);
+
+		CL_Console::write_line("All Tests Complete");
+		console.display_close_message();
+	}
+	catch(CL_Exception error)
+	{
+		CL_Console::write_line("Exception caught:");
+		CL_Console::write_line(error.message);
+		console.display_close_message();
+		return -1;
+	}
+
+	return 0;
+}
+
+void TestApp::fail()
+{
+	throw CL_Exception("Failed Test");
+}
+
+void TestApp::test_pairs(int num_outlines, int max_threads)
+{
+	CL_Console::write_line("   Function: step(), with %1 extra threads", max_threads);
+
+	const float area_size = 500.0f;
+
+	CL_CollisionWorld world;
+	world.set_max_threads(max_threads);
+
+	std::vector<CL_CollisionOutline> outlines;
+	std::vector<int> ids;
+	for (int i = 0; i < num_outlines; i++)
+	{
+		outlines.push_back(create_square(4.0f + rand() % 12));
+		outlines.back().set_translation(rand() % (int) area_size, rand() % (int) area_size);
+		if (i % 3 == 0)
+			outlines.back().enable_collision_info(true, true);
+		ids.push_back(world.add(outlines.back()));
+	}
+
+	// The colliding pairs must be the same as when testing every pair, also after the outlines moved:
+	for (int frame = 0; frame < 5; frame++)
+	{
+		move_outlines(outlines, area_size);
+
+		const std::vector<CL_CollisionPair> &collisions = world.step();
+		if (to_pair_set(collisions) != find_pairs_brute_force(world, ids))
+			fail();
+		if (world.get_candidate_pairs().size() < collisions.size())
+			fail();
+
+		for (size_t i = 0; i < collisions.size(); i++)
+		{
+			if (collisions[i].id1 >= collisions[i].id2)
+				fail();
+			bool collects_info = (collisions[i].id1 % 3 == 0);
+			if (collects_info == collisions[i].collision_info.empty())
+				fail();
+		}
+	}
+}
+
+void TestApp::test_remove_and_query()
+{
+	CL_Console::write_line("   Function: remove() and query()");
+
+	CL_CollisionWorld world;
+	CL_CollisionOutline outline1 = create_square(10.0f);
+	CL_CollisionOutline outline2 = create_square(10.0f);
+	outline1.set_translation(100.0f, 100.0f);
+	outline2.set_translation(105.0f, 105.0f);
+
+	int id1 = world.add(outline1);
+	int id2 = world.add(outline2);
+	if (world.step().size() != 1)
+		fail();
+
+	// Outlines are shared with the world:
+	outline2.set_translation(300.0f, 300.0f);
+	if (!world.step().empty())
+		fail();
+
+	std::vector<int> ids = world.query(CL_Rectf(290.0f, 290.0f, 310.0f, 310.0f));
+	if (ids.size() != 1 || ids[0] != id2)
+		fail();
+
+	// Removed ids are reused:
+	world.remove(id1);
+	if (world.get_outline_count() != 1)
+		fail();
+	if (world.add(outline1) != id1)
+		fail();
+
+	bool caught = false;
+	try
+	{
+		world.remove(5);
+	}
+	catch (CL_Exception)
+	{
+		caught = true;
+	}
+	if (!caught)
+		fail();
+
+	world.clear();
+	if (world.get_outline_count() != 0 || !world.query(CL_Rectf(0.0f, 0.0f, 1000.0f, 1000.0f)).empty())
+		fail();
+}
+
+void TestApp::run_benchmark(int num_outlines)
+{
+	const int num_frames = 10;
+
+	// Keep the density of the scene the same for every outline count:
+	float area_size = 20.0f * sqrt((float) num_outlines);
+
+	CL_CollisionWorld world;
+	std::vector<CL_CollisionOutline> outlines;
+	std::vector<int> ids;
+	for (int i = 0; i < num_outlines; i++)
+	{
+		outlines.push_back(create_square(4.0f + rand() % 12));
+		outlines.back().set_translation(rand() % (int) area_size, rand() % (int) area_size);
+		ids.push_back(world.add(outlines.back()));
+	}
+
+	cl_ubyte64 step_time = 0;
+	cl_ubyte64 brute_force_time = 0;
+	int num_candidate_pairs = 0;
+	int num_collisions = 0;
+	for (int frame = 0; frame < num_frames; frame++)
+	{
+		move_outlines(outlines, area_size);
+
+		cl_ubyte64 start_time = CL_System::get_microseconds();
+		num_collisions += world.step().size();
+		step_time += CL_System::get_microseconds() - start_time;
+		num_candidate_pairs += world.get_candidate_pairs().size();
+
+		start_time = CL_System::get_microseconds();
+		find_pairs_brute_force(world, ids);
+		brute_force_time += CL_System::get_microseconds() - start_time;
+	}
+
+	CL_Console::write_line("%1 %2 %3 %4 %5", num_outlines,
+		(int) (step_time / num_frames), (int) (brute_force_time / num_frames),
+		num_candidate_pairs / num_frames, num_collisions / num_frames);
+}
+
+CL_CollisionOutline TestApp::create_square(float size)
+{
+	CL_Contour contour;
+	contour.get_points().push_back(CL_Pointf(0.0f, 0.0f));
+	contour.get_points().push_back(CL_Pointf(size, 0.0f));
+	contour.get_points().push_back(CL_Pointf(size, size));
+	contour.get_points().push_back(CL_Pointf(0.0f, size));
+
+	CL_CollisionOutline outline(std::vector<CL_Contour>(1, contour), (int) size, (int) size);
+	outline.calculate_radius();
+	outline.calculate_sub_circles();
+	return outline;
+}
+
+void TestApp::move_outlines(std::vector<CL_CollisionOutline> &outlines, float area_size)
+{
+	for (size_t i = 0; i < outlines.size(); i++)
+	{
+		CL_Pointf position = outlines[i].get_translation();
+		position.x += (rand() % 21) - 10.0f;
+		position.y += (rand() % 21) - 10.0f;
+		if (position.x < 0.0f || position.x > area_size)
+			position.x = rand() % (int) area_size;
+		if (position.y < 0.0f || position.y > area_size)
+			position.y = rand() % (int) area_size;
+		outlines[i].set_translation(position.x, position.y);
+		outlines[i].rotate(CL_Angle((float) (rand() % 10), cl_degrees));
+	}
+}
+
+TestApp::PairSet TestApp::find_pairs_brute_force(CL_CollisionWorld &world, const std::vector<int> &ids)
+{
+	PairSet pairs;
+	std::vector<CL_CollidingContours> collision_info;
+	for (size_t i = 0; i < ids.size(); i++)
+	{
+		for (size_t j = i + 1; j < ids.size(); j++)
+		{
+			int id1 = cl_min(ids[i], ids[j]);
+			int id2 = cl_max(ids[i], ids[j]);
+			if (world.get_outline(id1).collide(world.get_outline(id2), collision_info))
+				pairs.insert(std::pair<int, int>(id1, id2));
+		}
+	}
+	return pairs;
+}
+
+TestApp::PairSet TestApp::to_pair_set(const std::vector<CL_CollisionPair> &pairs)
+{
+	PairSet pair_set;
+	for (size_t i = 0; i < pairs.size(); i++)
+		pair_set.insert(std::pair<int, int>(pairs[i].id1, pairs[i].id2));
+	return pair_set;
+}
@@ -0,0 +1,231 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include <ClanLib/core.h>
+#include <ClanLib/gui.h>
+#include <ClanLib/application.h>
+#include <ClanLib/display.h>
+#include <ClanLib/gl.h>
+#include <cmath>
+
+// Fills its area with a solid color
+class FilledComponent : public CL_GUIComponent
+{
+public:
+	FilledComponent(CL_GUIComponent *parent, const CL_Rect &geometry, CL_Colorf color) : CL_GUIComponent(parent), color(color)
+	{
+		set_geometry(geometry);
+		func_render().set(this, &FilledComponent::on_render);
+	}
+
+	void on_render(CL_GraphicContext &gc, const CL_Rect &clip_rect)
+	{
+		CL_Draw::fill(gc, CL_Rect(get_size()), color);
+	}
+
+	CL_Colorf color;
+};
+
+// Fills its area with a solid color, clipped to a part of it with push_cliprect
+class ClippedComponent : public FilledComponent
+{
+public:
+	ClippedComponent(CL_GUIComponent *parent, const CL_Rect &geometry, CL_Colorf color, const CL_Rect &clip) : FilledComponent(parent, geometry, color), clip(clip)
+	{
+		func_render().set(this, &ClippedComponent::on_render);
+	}
+
+	void on_render(CL_GraphicContext &gc, const CL_Rect &clip_rect)
+	{
+		push_cliprect(gc, clip);
+		CL_Draw::fill(gc, CL_Rect(get_size()), color);
+		pop_cliprect(gc);
+	}
+
+	CL_Rect clip;
+};
+
+// Rendered after the cached component and checks the colors its cache image put on screen
+class ProbeComponent : public CL_GUIComponent
+{
+public:
+	ProbeComponent(CL_GUIComponent *parent) : CL_GUIComponent(parent), num_checks(0), num_failures(0)
+	{
+		set_geometry(CL_Rect(parent->get_size()));
+		func_render().set(this, &ProbeComponent::on_render);
+	}
+
+	/// \brief Expects color at point, in coordinates of component
+	void add_check(CL_GUIComponent *component, const CL_Point &point, CL_Colorf color, const CL_String &description)
+	{
+		Check check = { component, point, color, description };
+		checks.push_back(check);
+	}
+
+	void on_render(CL_GraphicContext &gc, const CL_Rect &clip_rect)
+	{
+		num_checks++;
+		for (size_t i = 0; i < checks.size(); i++)
+		{
+			CL_Point point = checks[i].component->component_to_window_coords(checks[i].point);
+			CL_PixelBuffer pixels = gc.get_pixeldata(CL_Rect(point, CL_Size(1, 1)));
+			CL_Colorf color = pixels.get_pixel(0, 0);
+			CL_Colorf expected = checks[i].color;
+
+			if (fabs(color.r - expected.r) > 0.1f || fabs(color.g - expected.g) > 0.1f || fabs(color.b - expected.b) > 0.1f)
+			{
+				num_failures++;
+				CL_Console::write_line("Check %1: %2 failed at %3,%4 (found %5,%6,%7)", num_checks, checks[i].description, point.x, point.y, color.r, color.g, color.b);
+			}
+		}
+		CL_Console::write_line("Check %1 done", num_checks);
+	}
+
+	struct Check
+	{
+		CL_GUIComponent *component;
+		CL_Point point;
+		CL_Colorf color;
+		CL_String description;
+	};
+
+	std::vector<Check> checks;
+	int num_checks;
+	int num_failures;
+};
+
+class App
+{
+public:
+	int main(const std::vector<CL_String> &args)
+	{
+		CL_ConsoleWindow console("Console");
+
+		try
+		{
+			CL_Console::write_line("ClanLib Test Suite:");
+			CL_Console::write_line("-------------------");
+			CL_Console::write_line("Directory: API/GUI");
+			CL_Console::write_line("  Class: CL_GUIComponent");
+			CL_Console::write_line("   Function: set_render_cache() inside a translated parent, with clipping children");
+
+			CL_ResourceManager resources("../../../Resources/GUIThemeAero/resources.xml");
+
+			CL_GUIWindowManagerSystem wm;
+
+			CL_GUIThemeDefault theme;
+			theme.set_resources(resources);
+
+			CL_GUIManager gui;
+			gui.set_window_manager(wm);
+			gui.set_theme(theme);
+			gui.set_css_document("../../../Resources/GUIThemeAero/theme.css");
+
+			CL_DisplayWindowDescription desc;
+			desc.set_title("Render Cache");
+			desc.set_size(CL_Size(400, 300), true);
+			CL_GUIComponent root(&gui, desc);
+			root.func_render().set(this, &App::on_render_root);
+
+			// The cache is rebuilt while the modelview holds the translations of both ancestors
+			FilledComponent outer(&root, CL_Rect(40, 30, 360, 270), CL_Colorf::green);
+			FilledComponent parent(&outer, CL_Rect(60, 50, 260, 190), CL_Colorf::blue);
+			FilledComponent cached(&parent, CL_Rect(20, 20, 100, 100), CL_Colorf::red);
+			cached.set_render_cache(true);
+
+			// Clips set up inside the cached subtree must land at the same place in the cache texture
+			ClippedComponent clipped(&cached, CL_Rect(10, 10, 70, 70), CL_Colorf::yellow, CL_Rect(0, 0, 20, 20));
+
+			ProbeComponent probe(&parent);
+			probe.add_check(&cached, CL_Point(75, 75), CL_Colorf::red, "cache image position");
+			probe.add_check(&clipped, CL_Point(10, 10), CL_Colorf::yellow, "inside child clip");
+			probe.add_check(&clipped, CL_Point(40, 40), CL_Colorf::red, "outside child clip");
+			this->gui = &gui;
+			this->cached = &cached;
+			this->probe = &probe;
+
+			// Invalidate the cache repeatedly so it is rebuilt in the middle of a frame
+			CL_Timer timer;
+			timer.func_expired().set(this, &App::on_timer);
+			timer.start(100);
+
+			gui.exec();
+
+			if (probe.num_failures > 0)
+				throw CL_Exception("Failed Test");
+
+			CL_Console::write_line("All Tests Complete");
+			console.display_close_message();
+		}
+		catch (CL_Exception e)
+		{
+			CL_Console::write_line(e.message);
+			console.display_close_message();
+			return -1;
+		}
+
+		return 0;
+	}
+
+	void on_render_root(CL_GraphicContext &gc, const CL_Rect &clip_rect)
+	{
+		CL_Draw::fill(gc, clip_rect, CL_Colorf::black);
+	}
+
+	void on_timer()
+	{
+		if (probe->num_checks >= 20)
+			gui->exit_with_code(0);
+		else
+			cached->request_repaint();
+	}
+
+	CL_GUIManager *gui;
+	CL_GUIComponent *cached;
+	ProbeComponent *probe;
+};
+
+// This is the Program class that is called by CL_ClanApplication
+class Program
+{
+public:
+	static int main(const std::vector<CL_String> &args)
+	{
+		CL_SetupCore setup_core;
+		CL_SetupDisplay setup_display;
+		CL_SetupGL setup_gl;
+
+		// Start the Application
+		App app;
+		return app.main(args);
+	}
+};
+
+// Instantiate CL_ClanApplication, informing it where the Program is located
+CL_ClanApplication app(&Program::main);
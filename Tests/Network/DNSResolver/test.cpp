@@ -0,0 +1,258 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#include <ClanLib/core.h>
+#include <ClanLib/network.h>
+#include <map>
+
+// Minimal DNS server answering A queries for a few fixed names on the loopback interface.
+class StubDNSServer
+{
+public:
+	StubDNSServer()
+	: socket(CL_SocketName("127.0.0.1", "4563")), spoof_socket(CL_SocketName("127.0.0.1", "4564"))
+	{
+		thread.start(this, &StubDNSServer::thread_main);
+	}
+
+	~StubDNSServer()
+	{
+		event_stop.set();
+		thread.join();
+	}
+
+	int get_query_count(const CL_String &name)
+	{
+		CL_MutexSection mutex_lock(&mutex);
+		return query_counts[name];
+	}
+
+	std::vector<int> get_query_ids()
+	{
+		CL_MutexSection mutex_lock(&mutex);
+		return query_ids;
+	}
+
+private:
+	void thread_main()
+	{
+		CL_DataBuffer buffer(64*1024);
+		while (true)
+		{
+			CL_Event event_read = socket.get_read_event();
+			if (CL_Event::wait(event_stop, event_read) != 1)
+				break;
+
+			CL_UDPDatagram datagram(buffer.get_data(), buffer.get_size());
+			while (socket.receive(&datagram, 1) == 1)
+			{
+				CL_DNSPacket query(CL_DataBuffer(buffer.get_data(), datagram.length));
+				CL_String name = query.get_question_name(0);
+
+				CL_MutexSection mutex_lock(&mutex);
+				query_counts[name]++;
+				query_ids.push_back(query.get_query_id());
+				mutex_lock.unlock();
+
+				std::vector<unsigned char> response;
+				if (name == "backend.test" || name == "spoofed.test")
+					response = create_response(datagram, 0, 300, 10);
+				else if (name == "short.test")
+					response = create_response(datagram, 0, 1, 20);
+				else if (name == "missing.test")
+					response = create_response(datagram, 3, 60, 0);
+				else if (name == "mismatch.test")
+					response = create_response(datagram, 0, 300, 30);
+				else
+					continue;
+
+				// Answer with a question type other than the one asked for:
+				if (name == "mismatch.test")
+					response[datagram.length - 3] = 28;
+
+				CL_UDPDatagram reply(&response[0], response.size(), datagram.get_address());
+				if (name == "spoofed.test")
+					spoof_socket.send(&reply, 1);
+				else
+					socket.send(&reply, 1);
+			}
+		}
+	}
+
+	// Creates a response with one A record, or a name error with an SOA record if rcode is not 0.
+	std::vector<unsigned char> create_response(const CL_UDPDatagram &query, int rcode, int ttl, int address)
+	{
+		const unsigned char *q = (const unsigned char *) query.data;
+		std::vector<unsigned char> d(q, q + query.length);
+		d[2] = 0x81;
+		d[3] = 0x80 | rcode;
+		d[7] = (rcode == 0) ? 1 : 0;
+		d[9] = (rcode == 0) ? 0 : 1;
+
+		if (rcode == 0)
+		{
+			unsigned char record[] = { 0xc0, 0x0c, 0, 1, 0, 1, 0, 0, 0, 0, 0, 4, 10, 0, 0, 0 };
+			write_u32(record + 6, ttl);
+			record[15] = address;
+			d.insert(d.end(), record, record + sizeof(record));
+		}
+		else
+		{
+			// SOA with the zone name compressed to the question, and empty mname and rname:
+			unsigned char record[] = { 0xc0, 0x0c, 0, 6, 0, 1, 0, 0, 0, 0, 0, 22, 0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1 };
+			write_u32(record + 6, ttl);
+			write_u32(record + 30, 1);
+			d.insert(d.end(), record, record + sizeof(record));
+		}
+		return d;
+	}
+
+	static void write_u32(unsigned char *d, unsigned int value)
+	{
+		d[0] = value >> 24;
+		d[1] = value >> 16;
+		d[2] = value >> 8;
+		d[3] = value;
+	}
+
+	CL_UDPSocket socket;
+	CL_UDPSocket spoof_socket;
+	CL_Thread thread;
+	CL_Event event_stop;
+	CL_Mutex mutex;
+	std::map<CL_String, int> query_counts;
+	std::vector<int> query_ids;
+};
+
+class DNSResolverTest
+{
+public:
+	int run()
+	{
+		StubDNSServer server;
+		std::vector<CL_SocketName> dns_servers;
+		dns_servers.push_back(CL_SocketName("127.0.0.1", "4563"));
+		CL_DNSResolver resolver(dns_servers);
+
+		// Asynchronous lookup completing through the done event:
+		CL_DNSLookup lookup = resolver.lookup_resource_async("backend.test", "A", 2000);
+		CL_Event done_event = lookup.get_done_event();
+		if (CL_Event::wait(done_event, 2000) != 0)
+			return fail("Asynchronous lookup did not complete");
+		if (lookup.is_failed() || lookup.is_cached())
+			return fail("Asynchronous lookup failed: " + lookup.get_error_message());
+		if (lookup.get_records().size() != 1 || lookup.get_records()[0].get_a_address_str() != "10.0.0.10")
+			return fail("Asynchronous lookup returned the wrong address");
+
+		// Cached answer:
+		lookup = resolver.lookup_resource_async("BACKEND.test", "A", 2000);
+		if (!lookup.is_done() || !lookup.is_cached() || lookup.is_failed())
+			return fail("Second lookup was not answered from the cache");
+		std::vector<CL_DNSResourceRecord> records = resolver.lookup_resource("backend.test", "A", 2000);
+		if (records.size() != 1 || server.get_query_count("backend.test") != 1)
+			return fail("Blocking lookup did not use the cache");
+
+		// TTL expiry:
+		resolver.lookup_resource("short.test", "A", 2000);
+		resolver.lookup_resource("short.test", "A", 2000);
+		if (server.get_query_count("short.test") != 1)
+			return fail("Answer with a one second TTL was not cached");
+		CL_System::sleep(1100);
+		resolver.lookup_resource("short.test", "A", 2000);
+		if (server.get_query_count("short.test") != 2)
+			return fail("Answer was not removed from the cache when its TTL expired");
+
+		// Negative caching, using the minimum field of the SOA record:
+		lookup = resolver.lookup_resource_async("missing.test", "A", 2000);
+		lookup.wait();
+		if (!lookup.is_failed())
+			return fail("Lookup of a missing name did not fail");
+		lookup = resolver.lookup_resource_async("missing.test", "A", 2000);
+		if (!lookup.is_cached() || !lookup.is_failed() || server.get_query_count("missing.test") != 1)
+			return fail("Name error was not cached");
+		CL_System::sleep(1100);
+		lookup = resolver.lookup_resource_async("missing.test", "A", 2000);
+		lookup.wait();
+		if (lookup.is_cached() || server.get_query_count("missing.test") != 2)
+			return fail("Name error was not removed from the cache after the SOA minimum TTL");
+
+		// Timeouts are not cached:
+		lookup = resolver.lookup_resource_async("silent.test", "A", 300);
+		if (!lookup.wait(2000) || !lookup.is_failed())
+			return fail("Lookup did not time out");
+		lookup = resolver.lookup_resource_async("silent.test", "A", 300);
+		if (lookup.is_done())
+			return fail("Timed out lookup was cached");
+		lookup.wait();
+
+		// Answers from another address or for another question are dropped:
+		lookup = resolver.lookup_resource_async("spoofed.test", "A", 500);
+		if (!lookup.wait(2000) || !lookup.is_failed() || server.get_query_count("spoofed.test") == 0)
+			return fail("Answer from another address was accepted");
+		lookup = resolver.lookup_resource_async("mismatch.test", "A", 500);
+		if (!lookup.wait(2000) || !lookup.is_failed() || server.get_query_count("mismatch.test") == 0)
+			return fail("Answer to another question was accepted");
+
+		// Query ids must not be predictable:
+		std::vector<int> query_ids = server.get_query_ids();
+		int num_sequential = 0;
+		for (size_t i = 1; i < query_ids.size(); i++)
+		{
+			if (query_ids[i] == ((query_ids[i - 1] + 1) & 0xffff))
+				num_sequential++;
+		}
+		if (query_ids.size() < 5 || num_sequential == (int)query_ids.size() - 1)
+			return fail("Query ids are sequential");
+
+		CL_Console::write_line("DNS resolver test passed");
+		return 0;
+	}
+
+private:
+	int fail(const CL_String &message)
+	{
+		CL_Console::write_line("Fail: %1", message);
+		return 1;
+	}
+};
+
+int main(int argc, char**argv)
+{
+	CL_SetupCore setup_core;
+	CL_SetupNetwork setup_network;
+	try
+	{
+		DNSResolverTest test;
+		return test.run();
+	}
+	catch (CL_Exception e)
+	{
+		CL_Console::write_line(e.message);
+		return 1;
+	}
+}
@@ -0,0 +1,286 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#include <ClanLib/core.h>
+#include <ClanLib/network.h>
+#include <algorithm>
+
+// Forwards datagrams between the client and the server, and can deliver one server packet late.
+class ReorderRelay
+{
+public:
+	ReorderRelay(const CL_String &port, const CL_String &server_port)
+	: socket(CL_SocketName("127.0.0.1", port)), server_name("127.0.0.1", server_port), client_known(false), packet_held(false)
+	{
+	}
+
+	/// \brief Holds back the next server packet containing hold_event until a packet containing release_event was forwarded.
+	void reorder(const CL_String &hold_event, const CL_String &release_event)
+	{
+		hold_name = hold_event;
+		release_name = release_event;
+	}
+
+	bool is_packet_held() const { return packet_held; }
+
+	void process()
+	{
+		CL_Event read_event = socket.get_read_event();
+		while (read_event.wait(0))
+		{
+			CL_SocketName from;
+			int bytes = socket.receive(buffer, max_datagram_size, from);
+			if (bytes <= 0)
+				continue;
+
+			if (from.get_port() != server_name.get_port())
+			{
+				client_name = from;
+				client_known = true;
+				socket.send(buffer, bytes, server_name);
+			}
+			else if (client_known)
+			{
+				if (!hold_name.empty() && contains(buffer, bytes, hold_name))
+				{
+					held_packet = CL_DataBuffer(buffer, bytes);
+					packet_held = true;
+					hold_name.clear();
+					continue;
+				}
+
+				socket.send(buffer, bytes, client_name);
+				if (packet_held && contains(buffer, bytes, release_name))
+				{
+					socket.send(held_packet.get_data(), held_packet.get_size(), client_name);
+					packet_held = false;
+				}
+			}
+		}
+	}
+
+private:
+	static bool contains(const char *data, int size, const CL_String &text)
+	{
+		return std::search(data, data + size, text.begin(), text.end()) != data + size;
+	}
+
+	enum { max_datagram_size = 1500 };
+
+	CL_UDPSocket socket;
+	CL_SocketName server_name;
+	CL_SocketName client_name;
+	bool client_known;
+	CL_String hold_name;
+	CL_String release_name;
+	CL_DataBuffer held_packet;
+	bool packet_held;
+	char buffer[max_datagram_size];
+};
+
+// Runs a server and a client over the loopback interface and checks the UDP delivery modes.
+// The client talks to the server through a relay, so packets can be delivered out of order.
+class UDPTest
+{
+public:
+	UDPTest()
+	: server_connected(0), server_disconnected(0), client_connected(false),
+	  next_reliable(0), reliable_in_order(true), last_position(-1), positions_in_order(true), positions_received(0),
+	  enemy_position(-1), player_position(-1), server_connection(0), relay("4560", "4559")
+	{
+		slots.connect(server.sig_client_connected(), this, &UDPTest::on_server_connected);
+		slots.connect(server.sig_client_disconnected(), this, &UDPTest::on_server_disconnected);
+		slots.connect(server.sig_event_received(), this, &UDPTest::on_server_event);
+		slots.connect(client.sig_connected(), this, &UDPTest::on_client_connected);
+		slots.connect(client.sig_event_received(), this, &UDPTest::on_client_event);
+
+		server.set_delivery_mode("position", CL_NetGameEvent::unreliable_sequenced);
+		client.set_delivery_mode("position", CL_NetGameEvent::unreliable_sequenced);
+		server.set_delivery_mode("enemy-pos", CL_NetGameEvent::unreliable_sequenced);
+		server.set_delivery_mode("player-pos", CL_NetGameEvent::unreliable_sequenced);
+	}
+
+	int run()
+	{
+		server.start_udp("4559");
+		client.connect_udp("127.0.0.1", "4560");
+
+		if (!wait_until(&UDPTest::is_connected))
+			return fail("Client did not connect");
+
+		for (int i = 0; i < reliable_count; i++)
+			client.send_event(CL_NetGameEvent("reliable", i, CL_String(i % 50, 'x')));
+
+		if (!wait_until(&UDPTest::is_reliable_received))
+			return fail(cl_format("Received %1 of %2 reliable events", next_reliable, (int)reliable_count));
+		if (!reliable_in_order)
+			return fail("Reliable events arrived out of order");
+
+		for (int i = 0; i < position_count; i++)
+			server.send_event(CL_NetGameEvent("position", i));
+
+		if (!wait_until(&UDPTest::is_last_position_received))
+			return fail("Last sequenced event did not arrive");
+		if (!positions_in_order)
+			return fail("Sequenced events arrived out of order");
+
+		// An older event of one name arriving after a newer event of another name must still be delivered
+		relay.reorder("enemy-pos", "player-pos");
+		server.send_event(CL_NetGameEvent("enemy-pos", 1));
+		if (!wait_until(&UDPTest::is_packet_held))
+			return fail("Relay did not catch the enemy-pos event");
+		server.send_event(CL_NetGameEvent("player-pos", 2));
+		if (!wait_until(&UDPTest::are_both_positions_received))
+			return fail(cl_format("Interleaved sequenced events: enemy-pos %1, player-pos %2", enemy_position, player_position));
+
+		int rtt = server_connection ? server_connection->get_round_trip_time() : -1;
+		if (rtt < 0)
+			return fail("No round trip time measured");
+		CL_Console::write_line("Round trip time: %1 ms, %2 of %3 sequenced events received", rtt, positions_received, (int)position_count);
+
+		client.disconnect();
+		if (!wait_until(&UDPTest::is_disconnected))
+			return fail("Server did not notice the disconnect");
+
+		server.stop();
+		CL_Console::write_line("NetGame UDP transport test passed");
+		return 0;
+	}
+
+private:
+	bool wait_until(bool (UDPTest::*condition)() const)
+	{
+		unsigned int start_time = CL_System::get_time();
+		while (!(this->*condition)())
+		{
+			if (CL_System::get_time() - start_time > 5000)
+				return false;
+
+			relay.process();
+			server.process_events();
+			client.process_events();
+			CL_System::sleep(1);
+		}
+		return true;
+	}
+
+	bool is_connected() const { return client_connected && server_connected == 1; }
+	bool is_reliable_received() const { return next_reliable == reliable_count; }
+	bool is_last_position_received() const { return last_position == position_count - 1; }
+	bool is_packet_held() const { return relay.is_packet_held(); }
+	bool are_both_positions_received() const { return enemy_position == 1 && player_position == 2; }
+	bool is_disconnected() const { return server_disconnected == 1; }
+
+	int fail(const CL_String &message)
+	{
+		CL_Console::write_line("Fail: %1", message);
+		return 1;
+	}
+
+	void on_server_connected(CL_NetGameConnection *connection)
+	{
+		server_connected++;
+		server_connection = connection;
+	}
+
+	void on_server_disconnected(CL_NetGameConnection *connection)
+	{
+		server_disconnected++;
+		server_connection = 0;
+	}
+
+	void on_client_connected()
+	{
+		client_connected = true;
+	}
+
+	void on_server_event(CL_NetGameConnection *connection, const CL_NetGameEvent &e)
+	{
+		if (e.get_name() == "reliable")
+		{
+			if (e.get_argument(0).to_integer() != next_reliable)
+				reliable_in_order = false;
+			next_reliable++;
+		}
+	}
+
+	void on_client_event(const CL_NetGameEvent &e)
+	{
+		if (e.get_name() == "position")
+		{
+			int position = e.get_argument(0).to_integer();
+			if (position <= last_position)
+				positions_in_order = false;
+			last_position = position;
+			positions_received++;
+		}
+		else if (e.get_name() == "enemy-pos")
+		{
+			enemy_position = e.get_argument(0).to_integer();
+		}
+		else if (e.get_name() == "player-pos")
+		{
+			player_position = e.get_argument(0).to_integer();
+		}
+	}
+
+	enum { reliable_count = 2000, position_count = 500 };
+
+	CL_NetGameServer server;
+	CL_NetGameClient client;
+	CL_SlotContainer slots;
+
+	int server_connected;
+	int server_disconnected;
+	bool client_connected;
+	int next_reliable;
+	bool reliable_in_order;
+	int last_position;
+	bool positions_in_order;
+	int positions_received;
+	int enemy_position;
+	int player_position;
+	CL_NetGameConnection *server_connection;
+	ReorderRelay relay;
+};
+
+int main(int argc, char**argv)
+{
+	CL_SetupCore setup_core;
+	CL_SetupNetwork setup_network;
+	try
+	{
+		UDPTest test;
+		return test.run();
+	}
+	catch (CL_Exception e)
+	{
+		CL_Console::write_line(e.message);
+		return 1;
+	}
+}
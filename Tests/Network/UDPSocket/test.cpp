@@ -0,0 +1,123 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#include <ClanLib/core.h>
+#include <ClanLib/network.h>
+
+// Sends a batch of datagrams over the loopback interface and receives them with a batched receive.
+class UDPSocketTest
+{
+public:
+	UDPSocketTest()
+	: sender(CL_SocketName("127.0.0.1", "4560")), receiver(CL_SocketName("127.0.0.1", "4561"))
+	{
+	}
+
+	int run()
+	{
+		CL_DataBuffer send_data(datagram_count * 16);
+		CL_UDPDatagram send_datagrams[datagram_count];
+		CL_SocketName destination("127.0.0.1", "4561");
+		for (int i = 0; i < datagram_count; i++)
+		{
+			char *data = send_data.get_data() + i * 16;
+			int length = 1 + i % 16;
+			for (int j = 0; j < length; j++)
+				data[j] = (char) i;
+			send_datagrams[i] = CL_UDPDatagram(data, length, destination);
+		}
+
+		int sent = sender.send(send_datagrams, datagram_count);
+		if (sent != datagram_count)
+			return fail(cl_format("Sent %1 of %2 datagrams", sent, (int)datagram_count));
+
+		// Receive buffers are smaller than the longest datagram to check truncation
+		CL_DataBuffer receive_data(datagram_count * 8);
+		CL_UDPDatagram receive_datagrams[datagram_count];
+		for (int i = 0; i < datagram_count; i++)
+			receive_datagrams[i] = CL_UDPDatagram(receive_data.get_data() + i * 8, 8);
+
+		int received = 0;
+		unsigned int start_time = CL_System::get_time();
+		while (received < datagram_count && CL_System::get_time() - start_time < 5000)
+		{
+			receiver.get_read_event().wait(100);
+			received += receiver.receive(receive_datagrams + received, datagram_count - received);
+		}
+		if (received != datagram_count)
+			return fail(cl_format("Received %1 of %2 datagrams", received, (int)datagram_count));
+
+		for (int i = 0; i < datagram_count; i++)
+		{
+			const CL_UDPDatagram &datagram = receive_datagrams[i];
+			int length = 1 + i % 16;
+			if (datagram.truncated != (length > 8))
+				return fail(cl_format("Datagram %1 has the wrong truncated flag", i));
+			if (!datagram.truncated && datagram.length != length)
+				return fail(cl_format("Datagram %1 has length %2, expected %3", i, datagram.length, length));
+			if (((unsigned char *) datagram.data)[0] != (unsigned char) i)
+				return fail(cl_format("Datagram %1 has the wrong contents", i));
+			if (datagram.port != 4560 || datagram.get_address().get_port() != "4560")
+				return fail(cl_format("Datagram %1 has the wrong source port", i));
+		}
+
+		if (receiver.receive(receive_datagrams, datagram_count) != 0)
+			return fail("Receive did not return 0 on an empty socket");
+
+		CL_Console::write_line("UDP socket batch test passed");
+		return 0;
+	}
+
+private:
+	int fail(const CL_String &message)
+	{
+		CL_Console::write_line("Fail: %1", message);
+		return 1;
+	}
+
+	enum { datagram_count = 200 };
+
+	CL_UDPSocket sender;
+	CL_UDPSocket receiver;
+};
+
+int main(int argc, char**argv)
+{
+	CL_SetupCore setup_core;
+	CL_SetupNetwork setup_network;
+	try
+	{
+		UDPSocketTest test;
+		return test.run();
+	}
+	catch (CL_Exception e)
+	{
+		CL_Console::write_line(e.message);
+		return 1;
+	}
+}
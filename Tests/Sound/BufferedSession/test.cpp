@@ -0,0 +1,185 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include "test.h"
+
+// This is the Program class that is called by CL_ClanApplication
+class Program
+{
+public:
+	static int main(const std::vector<CL_String> &args)
+	{
+		// Initialize ClanLib base components
+		CL_SetupCore setup_core;
+		CL_SetupSound setup_sound;
+
+		// Start the Application
+		TestApp app;
+		int retval = app.main(args);
+		return retval;
+	}
+};
+
+// Instantiate CL_ClanApplication, informing it where the Program is located
+CL_ClanApplication app(&Program::main);
+
+int TestApp::main(const std::vector<CL_String> &args)
+{
+	// Create a console window for text-output if not available
+	CL_ConsoleWindow console("Console");
+
+	try
+	{
+		CL_Console::write_line("ClanLib Test Suite:");
+		CL_Console::write_line("-------------------");
+		CL_Console::write_line("Directory: API/Sound/SoundProviders");
+		CL_Console::write_line("  Class: CL_SoundProvider_Buffered_Session");
+
+		CL_SoundOutput_Description desc;
+		desc.set_mixing_frequency(mixing_frequency);
+		desc.set_mixing_latency(20);
+		desc.set_offline(true);
+		CL_SoundOutput output(desc);
+
+		CountingState state;
+		CL_SoundBuffer buffer(new CountingProvider(&state, length, buffer_samples));
+		CL_SoundBuffer_Session session = buffer.prepare(false, &output);
+		session.set_resampling(cl_resample_linear);
+		CL_SoundFilter capture(new CaptureFilterProvider(&positions));
+		session.add_filter(capture);
+
+		CL_Console::write_line("   Function: play() starts decoding");
+		CL_System::sleep(50);
+		if (state.num_play_calls.get() != 0)
+			fail();
+		session.play();
+		output.render_fragments(1);
+		for (int i = 0; i < 100 && state.num_play_calls.get() == 0; i++)
+			CL_System::sleep(10);
+		if (state.num_play_calls.get() != 1)
+			fail();
+
+		CL_Console::write_line("   Function: read through the ring");
+		render_until(output, 100000);
+		int start = find(1);
+		check_continuous(start, 1, 100000);
+		if (state.underrun_counter.get() != 0)
+			fail();
+
+		// Seeks apply once the mixer has played what it already read, so the targets are
+		// chosen ahead of anything the mixer could still reach without seeking
+		CL_Console::write_line("   Function: seeking");
+		session.set_position(150000);
+		render_until(output, 160000);
+		start = find(150001, start);
+		check_continuous(start, 150001, 10000);
+		if (state.underrun_counter.get() != 0)
+			fail();
+
+		CL_Console::write_line("   Function: looping");
+		session.set_looping(true);
+		session.set_position(length - 5000);
+		render_until(output, 20000);
+		start = find(length - 4999, start);
+		check_continuous(start, length - 4999, 5000);
+		if (positions[start + 5000] != 1)
+			fail();
+		check_continuous(start + 5000, 1, 20000);
+		if (state.underrun_counter.get() != 0)
+			fail();
+
+		CL_Console::write_line("   Function: underrun counters");
+		state.decode_delay.set(20);
+		output.render_fragments(100);
+		if (state.underrun_counter.get() == 0 || state.buffered_session->get_num_underruns() != state.underrun_counter.get())
+			fail();
+		if (state.buffered_session->get_num_underrun_samples() < state.buffered_session->get_num_underruns())
+			fail();
+
+		state.decode_delay.set(0);
+		session.stop();
+		output.render_fragments(1);
+
+		CL_Console::write_line("All Tests Complete");
+		console.display_close_message();
+	}
+	catch(CL_Exception error)
+	{
+		CL_Console::write_line("Exception caught:");
+		CL_Console::write_line(error.message);
+		console.display_close_message();
+		return -1;
+	}
+
+	return 0;
+}
+
+void TestApp::fail()
+{
+	throw CL_Exception("Failed Test");
+}
+
+void TestApp::render_until(CL_SoundOutput &output, int position)
+{
+	// Render slowly enough for the decoder to keep the ring filled
+	for (int i = 0; i < 10000; i++)
+	{
+		if (!positions.empty() && positions.back() >= position && positions.back() < position + 4096)
+			return;
+		output.render_fragments(1);
+		CL_System::sleep(1);
+	}
+	fail();
+}
+
+void TestApp::check_continuous(int start, int first_position, int count)
+{
+	if (start + count > (int)positions.size())
+		fail();
+
+	for (int i = 0; i < count; i++)
+	{
+		if (positions[start + i] != first_position + i)
+		{
+			CL_Console::write_line("Sample %1 plays position %2, expected %3", start + i, positions[start + i], first_position + i);
+			fail();
+		}
+	}
+}
+
+int TestApp::find(int position, int start)
+{
+	for (int i = start; i < (int)positions.size(); i++)
+	{
+		if (positions[i] == position)
+			return i;
+	}
+	fail();
+	return 0;
+}
@@ -0,0 +1,137 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include <ClanLib/core.h>
+#include <ClanLib/application.h>
+#include <ClanLib/sound.h>
+
+// Shared between the test and the sessions it creates
+class CountingState
+{
+public:
+	CountingState() : buffered_session(0) { }
+
+	CL_InterlockedVariable num_play_calls;
+	CL_InterlockedVariable decode_delay;
+	CL_InterlockedVariable underrun_counter;
+	CL_SoundProvider_Buffered_Session *buffered_session;
+};
+
+// Mono session whose samples count the position, so gaps and jumps are easy to find
+class CountingSession : public CL_SoundProvider_Session
+{
+public:
+	CountingSession(CountingState *state, int length) : state(state), length(length), position(0) { }
+
+	int get_num_samples() const { return length; }
+	int get_frequency() const { return 44100; }
+	int get_position() const { return position; }
+	int get_num_channels() const { return 1; }
+
+	bool eof() const { return position >= length; }
+	void stop() { }
+	bool play() { state->num_play_calls.increment(); return true; }
+	bool set_position(int pos) { position = pos; return true; }
+	bool set_end_position(int pos) { return false; }
+
+	int get_data(float **data_ptr, int data_requested)
+	{
+		if (state->decode_delay.get() > 0)
+			CL_System::sleep(state->decode_delay.get());
+
+		int count = length - position;
+		if (count > data_requested)
+			count = data_requested;
+		for (int i = 0; i < count; i++)
+			data_ptr[0][i] = (position + i + 1) / 65536.0f;
+		position += count;
+		return count;
+	}
+
+private:
+	CountingState *state;
+	int length;
+	int position;
+};
+
+class CountingProvider : public CL_SoundProvider
+{
+public:
+	CountingProvider(CountingState *state, int length, int buffer_samples) : state(state), length(length), buffer_samples(buffer_samples) { }
+
+	CL_SoundProvider_Session *begin_session()
+	{
+		state->buffered_session = new CL_SoundProvider_Buffered_Session(new CountingSession(state, length), buffer_samples, &state->underrun_counter);
+		return state->buffered_session;
+	}
+
+	void end_session(CL_SoundProvider_Session *session)
+	{
+		delete session;
+	}
+
+private:
+	CountingState *state;
+	int length;
+	int buffer_samples;
+};
+
+// Records the position counted by each sample a session plays, 0 for silence
+class CaptureFilterProvider : public CL_SoundFilterProvider
+{
+public:
+	CaptureFilterProvider(std::vector<int> *positions) : positions(positions) { }
+
+	void destroy() { delete this; }
+
+	void filter(float **sample_data, int num_samples, int channels)
+	{
+		for (int i = 0; i < num_samples; i++)
+			positions->push_back(int(sample_data[0][i] * 65536.0f + 0.5f));
+	}
+
+private:
+	std::vector<int> *positions;
+};
+
+class TestApp
+{
+public:
+	virtual int main(const std::vector<CL_String> &args);
+
+private:
+	enum { length = 200000, buffer_samples = 32768, mixing_frequency = 44100 };
+
+	void render_until(CL_SoundOutput &output, int position);
+	void check_continuous(int start, int first_position, int count);
+	int find(int position, int start = 0);
+	static void fail();
+
+	std::vector<int> positions;
+};
@@ -0,0 +1,185 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include "test.h"
+
+// This is the Program class that is called by CL_ClanApplication
+class Program
+{
+public:
+	static int main(const std::vector<CL_String> &args)
+	{
+		// Initialize ClanLib base components
+		CL_SetupCore setup_core;
+		CL_SetupSound setup_sound;
+
+		// Start the Application
+		TestApp app;
+		int retval = app.main(args);
+		return retval;
+	}
+};
+
+// Instantiate CL_ClanApplication, informing it where the Program is located
+CL_ClanApplication app(&Program::main);
+
+int TestApp::main(const std::vector<CL_String> &args)
+{
+	// Create a console window for text-output if not available
+	CL_ConsoleWindow console("Console");
+
+	try
+	{
+		CL_Console::write_line("ClanLib Test Suite:");
+		CL_Console::write_line("-------------------");
+		CL_Console::write_line("Directory: API/Sound");
+		CL_Console::write_line("  Class: CL_SoundBuffer_Session");
+
+		CL_Console::write_line("   Function: more changes than the command queue holds, rendered on request");
+		test_render_on_request();
+
+		CL_Console::write_line("   Function: more changes than the command queue holds, with a mixer thread");
+		test_mixer_thread();
+
+		CL_Console::write_line("All Tests Complete");
+		console.display_close_message();
+	}
+	catch(CL_Exception error)
+	{
+		CL_Console::write_line("Exception caught:");
+		CL_Console::write_line(error.message);
+		console.display_close_message();
+		return -1;
+	}
+
+	return 0;
+}
+
+void TestApp::fail()
+{
+	throw CL_Exception("Failed Test");
+}
+
+void TestApp::test_render_on_request()
+{
+	CL_SoundOutput_Description desc;
+	desc.set_mixing_frequency(mixing_frequency);
+	desc.set_offline(true);
+	CL_SoundOutput output(desc);
+
+	CL_InterlockedVariable last_sample;
+	CL_SoundFilter capture(new LastSampleFilterProvider(&last_sample));
+	output.add_filter(capture);
+
+	CL_SoundBuffer buffer = create_constant();
+	CL_SoundBuffer_Session session = buffer.prepare(true, &output);
+	session.set_volume_ramping(false);
+
+	// Nothing renders until the first call, so everything here stays queued
+	session.play();
+	set_volumes(session, 1.0f);
+	output.render_fragments(1);
+	int full_volume = last_sample.get();
+	if (!session.is_playing() || full_volume == 0)
+		fail();
+
+	// No mixer drains the queue here, so every change must be queued without waiting
+	set_volumes(session, 0.25f);
+	output.render_fragments(1);
+	if (!is_near(last_sample.get(), full_volume / 4))
+		fail();
+
+	// Commands still arrive in order once the queue has overflowed
+	set_volumes(session, 0.5f);
+	session.stop();
+	session.play();
+	session.set_volume(0.75f);
+	output.render_fragments(1);
+	if (!session.is_playing() || !is_near(last_sample.get(), full_volume * 3 / 4))
+		fail();
+
+	// Let the mixer release the session so the next test can create an output
+	session.stop();
+	output.render_fragments(1);
+}
+
+void TestApp::test_mixer_thread()
+{
+	CL_SoundOutput_Description desc;
+	desc.set_mixing_frequency(mixing_frequency);
+	desc.set_offline(true);
+	desc.set_offline_speed(20.0f);
+	CL_SoundOutput output(desc);
+
+	CL_InterlockedVariable last_sample;
+	CL_SoundFilter capture(new LastSampleFilterProvider(&last_sample));
+	output.add_filter(capture);
+
+	CL_SoundBuffer buffer = create_constant();
+	CL_SoundBuffer_Session session = buffer.prepare(true, &output);
+	session.set_volume_ramping(false);
+	session.set_volume(1.0f);
+	session.play();
+
+	int full_volume = 0;
+	for (int i = 0; i < 500 && full_volume == 0; i++)
+	{
+		CL_System::sleep(10);
+		full_volume = last_sample.get();
+	}
+	if (full_volume == 0)
+		fail();
+
+	set_volumes(session, 0.25f);
+	for (int i = 0; i < 500 && !is_near(last_sample.get(), full_volume / 4); i++)
+		CL_System::sleep(10);
+	if (!is_near(last_sample.get(), full_volume / 4))
+		fail();
+
+	session.stop();
+}
+
+void TestApp::set_volumes(CL_SoundBuffer_Session &session, float final_volume)
+{
+	for (int i = 0; i < num_commands; i++)
+		session.set_volume(i / float(num_commands));
+	session.set_volume(final_volume);
+}
+
+bool TestApp::is_near(int value, int expected)
+{
+	int difference = value - expected;
+	return difference >= -10 && difference <= 10;
+}
+
+CL_SoundBuffer TestApp::create_constant()
+{
+	std::vector<short> data(buffer_length, 16384);
+	return CL_SoundBuffer(new CL_SoundProvider_Raw(&data[0], buffer_length, 2, false, mixing_frequency));
+}
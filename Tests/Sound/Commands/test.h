@@ -0,0 +1,66 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include <ClanLib/core.h>
+#include <ClanLib/application.h>
+#include <ClanLib/sound.h>
+
+// Remembers the last value mixed into the left channel
+class LastSampleFilterProvider : public CL_SoundFilterProvider
+{
+public:
+	LastSampleFilterProvider(CL_InterlockedVariable *last_sample) : last_sample(last_sample) { }
+
+	void destroy() { delete this; }
+
+	void filter(float **sample_data, int num_samples, int channels)
+	{
+		if (num_samples > 0)
+			last_sample->set((int) (sample_data[0][num_samples - 1] * 1000000.0f));
+	}
+
+private:
+	CL_InterlockedVariable *last_sample;
+};
+
+class TestApp
+{
+public:
+	virtual int main(const std::vector<CL_String> &args);
+
+private:
+	enum { num_commands = 20000, buffer_length = 4096, mixing_frequency = 44100 };
+
+	void test_render_on_request();
+	void test_mixer_thread();
+	static CL_SoundBuffer create_constant();
+	static void set_volumes(CL_SoundBuffer_Session &session, float final_volume);
+	static bool is_near(int value, int expected);
+	static void fail();
+};
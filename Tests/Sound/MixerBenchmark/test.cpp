@@ -0,0 +1,197 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include "test.h"
+
+// This is the Program class that is called by CL_ClanApplication
+class Program
+{
+public:
+	static int main(const std::vector<CL_String> &args)
+	{
+		// Initialize ClanLib base components
+		CL_SetupCore setup_core;
+		CL_SetupSound setup_sound;
+
+		// Start the Application
+		TestApp app;
+		int retval = app.main(args);
+		return retval;
+	}
+};
+
+// Instantiate CL_ClanApplication, informing it where the Program is located
+CL_ClanApplication app(&Program::main);
+
+int TestApp::main(const std::vector<CL_String> &args)
+{
+	// Create a console window for text-output if not available
+	CL_ConsoleWindow console("Console");
+
+	try
+	{
+		CL_Console::write_line("ClanLib Test Suite:");
+		CL_Console::write_line("-------------------");
+		CL_Console::write_line("For clanSound mixer performance");
+		CL_Console::write_line("Usage: test [output.wav]");
+
+		// Render without a sound card, only when asked to by render_fragments():
+		CL_SoundOutput_Description desc;
+		desc.set_mixing_frequency(44100);
+		desc.set_mixing_latency(20);
+		desc.set_offline(true);
+		if (args.size() > 1)
+			desc.set_offline_filename(args[1]);
+		CL_SoundOutput output(desc);
+
+		CL_SoundBuffer buffer = create_tone(tone_frequency, tone_length);
+
+		test_rendering(output, buffer);
+
+		const Scenario scenarios[] =
+		{
+			{ "nearest", cl_resample_nearest, false, false },
+			{ "linear", cl_resample_linear, false, false },
+			{ "cubic", cl_resample_cubic, false, false },
+			{ "sinc", cl_resample_sinc, false, false },
+			{ "linear + echo", cl_resample_linear, true, false },
+			{ "linear + bus echo", cl_resample_linear, false, true }
+		};
+		const int voices[] = { 1, 16, 64, 256 };
+
+		CL_Console::write_line("Fragment size: %1 samples (%2 us)", output.get_statistics().fragment_size, output.get_statistics().fragment_size * 1000000 / output.get_mixing_frequency());
+		CL_Console::write_line("scenario voices avg_us min_us max_us realtime_x");
+		for (int i = 0; i < sizeof(scenarios) / sizeof(Scenario); i++)
+		{
+			for (int j = 0; j < sizeof(voices) / sizeof(int); j++)
+				run_benchmark(output, buffer, scenarios[i], voices[j]);
+		}
+
+		CL_Console::write_line("All Tests Complete");
+		console.display_close_message();
+	}
+	catch(CL_Exception error)
+	{
+		CL_Console::write_line("Exception caught:");
+		CL_Console::write_line(error.message);
+		console.display_close_message();
+		return -1;
+	}
+
+	return 0;
+}
+
+void TestApp::fail()
+{
+	throw CL_Exception("Failed Test");
+}
+
+void TestApp::test_rendering(CL_SoundOutput &output, CL_SoundBuffer &buffer)
+{
+	CL_Console::write_line("   Function: render_fragments()");
+
+	output.reset_statistics();
+	if (output.get_statistics().num_fragments != 0)
+		fail();
+	output.render_fragments(5);
+	CL_SoundOutput_Statistics statistics = output.get_statistics();
+	if (statistics.num_fragments != 5)
+		fail();
+	if (statistics.fragment_size <= 0)
+		fail();
+	if (statistics.min_mix_time > statistics.max_mix_time)
+		fail();
+
+	// A session started before rendering plays from the first fragment, and ends on the fragment its data runs out:
+	CL_SoundBuffer_Session session = buffer.prepare(false, &output);
+	session.play();
+	int fragments_needed = (tone_length * output.get_mixing_frequency() / tone_frequency + statistics.fragment_size - 1) / statistics.fragment_size;
+	output.render_fragments(1);
+	if (!session.is_playing())
+		fail();
+	output.render_fragments(fragments_needed);
+	if (session.is_playing())
+		fail();
+}
+
+void TestApp::run_benchmark(CL_SoundOutput &output, CL_SoundBuffer &buffer, const Scenario &scenario, int num_voices)
+{
+	const int num_fragments = 100;
+
+	CL_EchoFilter echo_filter;
+	CL_SoundBus bus;
+	if (scenario.bus_echo_filter)
+	{
+		// The echo runs once on the sum of all voices:
+		bus = CL_SoundBus(output);
+		bus.add_filter(echo_filter);
+	}
+
+	std::vector<CL_SoundBuffer_Session> sessions;
+	for (int i = 0; i < num_voices; i++)
+	{
+		CL_SoundBuffer_Session session = buffer.prepare(true, &output);
+		session.set_resampling(scenario.resampling);
+		session.set_frequency(tone_frequency + (i % 17) * 1000);
+		session.set_pan((i % 5) * 0.5f - 1.0f);
+		session.set_volume(1.0f / num_voices);
+		if (scenario.echo_filter)
+			session.add_filter(echo_filter);
+		if (!bus.is_null())
+			session.set_bus(bus);
+		session.play();
+		sessions.push_back(session);
+	}
+
+	// Let the mixer settle before measuring:
+	output.render_fragments(2);
+	output.reset_statistics();
+	output.render_fragments(num_fragments);
+	CL_SoundOutput_Statistics statistics = output.get_statistics();
+
+	for (size_t i = 0; i < sessions.size(); i++)
+		sessions[i].stop();
+	output.render_fragments(1);
+
+	double average = statistics.total_mix_time / (double) statistics.num_fragments;
+	double fragment_time = statistics.fragment_size * 1000000.0 / output.get_mixing_frequency();
+	CL_Console::write_line("%1 %2 %3 %4 %5 %6",
+		scenario.name, num_voices,
+		(int) average, statistics.min_mix_time, statistics.max_mix_time,
+		average > 0.0 ? (int) (fragment_time / average) : 0);
+}
+
+CL_SoundBuffer TestApp::create_tone(int frequency, int length)
+{
+	std::vector<unsigned char> data(length);
+	for (int i = 0; i < length; i++)
+		data[i] = (unsigned char) (128 + 100 * sin(i * 440.0 * 2.0 * 3.14159265 / frequency));
+
+	return CL_SoundBuffer(new CL_SoundProvider_Raw(&data[0], length, 1, false, frequency));
+}
@@ -0,0 +1,145 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include "test.h"
+
+// This is the Program class that is called by CL_ClanApplication
+class Program
+{
+public:
+	static int main(const std::vector<CL_String> &args)
+	{
+		// Initialize ClanLib base components
+		CL_SetupCore setup_core;
+		CL_SetupSound setup_sound;
+
+		// Start the Application
+		TestApp app;
+		int retval = app.main(args);
+		return retval;
+	}
+};
+
+// Instantiate CL_ClanApplication, informing it where the Program is located
+CL_ClanApplication app(&Program::main);
+
+int TestApp::main(const std::vector<CL_String> &args)
+{
+	// Create a console window for text-output if not available
+	CL_ConsoleWindow console("Console");
+
+	try
+	{
+		CL_Console::write_line("ClanLib Test Suite:");
+		CL_Console::write_line("-------------------");
+		CL_Console::write_line("Directory: API/Sound");
+		CL_Console::write_line("  Class: CL_SoundBuffer_Session");
+		CL_Console::write_line("   Function: resampling across buffer refills");
+
+		CL_SoundOutput_Description desc;
+		desc.set_mixing_frequency(mixing_frequency);
+		desc.set_mixing_latency(20);
+		desc.set_offline(true);
+		CL_SoundOutput output(desc);
+
+		CL_SoundBuffer buffer = create_ramp();
+
+		test_ramp(output, buffer, cl_resample_linear, source_frequency);
+		test_ramp(output, buffer, cl_resample_linear, source_frequency * 3 / 2);
+		test_ramp(output, buffer, cl_resample_cubic, source_frequency);
+		test_ramp(output, buffer, cl_resample_cubic, source_frequency * 3 / 2);
+
+		CL_Console::write_line("All Tests Complete");
+		console.display_close_message();
+	}
+	catch(CL_Exception error)
+	{
+		CL_Console::write_line("Exception caught:");
+		CL_Console::write_line(error.message);
+		console.display_close_message();
+		return -1;
+	}
+
+	return 0;
+}
+
+void TestApp::fail()
+{
+	throw CL_Exception("Failed Test");
+}
+
+void TestApp::test_ramp(CL_SoundOutput &output, CL_SoundBuffer &buffer, CL_SoundResampling resampling, int frequency)
+{
+	std::vector<float> samples;
+	CL_SoundFilter capture(new CaptureFilterProvider(&samples));
+
+	CL_SoundBuffer_Session session = buffer.prepare(false, &output);
+	session.set_resampling(resampling);
+	session.set_frequency(frequency);
+	session.add_filter(capture);
+	session.play();
+
+	// The session buffer is refilled several times before the ramp ends
+	double speed = frequency / double(mixing_frequency);
+	int num_output_samples = int((ramp_length - 1) / speed);
+	for (int i = 0; i < 1000 && session.is_playing(); i++)
+		output.render_fragments(1);
+
+	if (session.is_playing() || (int)samples.size() < num_output_samples)
+		fail();
+
+	// Linear and cubic interpolation reproduce a ramp exactly, so every step must be the same.
+	// The first samples interpolate against the silence before the start and are skipped.
+	float expected_step = float(speed / 32768.0);
+	for (int i = 3; i < num_output_samples - 3; i++)
+	{
+		float step = samples[i + 1] - samples[i];
+		if (step < expected_step * 0.99f || step > expected_step * 1.01f)
+		{
+			CL_Console::write_line("Sample %1 steps by %2, expected %3", i, step, expected_step);
+			fail();
+		}
+	}
+
+	// Nothing is played after the end of the ramp
+	for (size_t i = num_output_samples + 3; i < samples.size(); i++)
+	{
+		if (samples[i] != 0.0f)
+			fail();
+	}
+}
+
+CL_SoundBuffer TestApp::create_ramp()
+{
+	std::vector<short> data(ramp_length);
+	for (int i = 0; i < ramp_length; i++)
+		data[i] = (short) (i - ramp_length / 2);
+
+	return CL_SoundBuffer(new CL_SoundProvider_Raw(&data[0], ramp_length, 2, false, source_frequency));
+}
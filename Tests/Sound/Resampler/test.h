@@ -0,0 +1,62 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include <ClanLib/core.h>
+#include <ClanLib/application.h>
+#include <ClanLib/sound.h>
+
+// Records everything a session produces after resampling
+class CaptureFilterProvider : public CL_SoundFilterProvider
+{
+public:
+	CaptureFilterProvider(std::vector<float> *samples) : samples(samples) { }
+
+	void destroy() { delete this; }
+
+	void filter(float **sample_data, int num_samples, int channels)
+	{
+		samples->insert(samples->end(), sample_data[0], sample_data[0] + num_samples);
+	}
+
+private:
+	std::vector<float> *samples;
+};
+
+class TestApp
+{
+public:
+	virtual int main(const std::vector<CL_String> &args);
+
+private:
+	enum { ramp_length = 60000, source_frequency = 44100, mixing_frequency = 48000 };
+
+	void test_ramp(CL_SoundOutput &output, CL_SoundBuffer &buffer, CL_SoundResampling resampling, int frequency);
+	static CL_SoundBuffer create_ramp();
+	static void fail();
+};
@@ -203,6 +203,12 @@ void TestApp::do_test()
 	CL_SoundSSE::multiply_float(out2_float_buffer1, data_size, 0.34f);
 	check_float(out_float_buffer1, out2_float_buffer1, data_size);
 
+	memcpy(out_float_buffer1, in_float_buffer1, sizeof(out_float_buffer1));
+	multiply_float_ramp(out_float_buffer1, data_size - 1, 0.34f, 0.0005f);
+	memcpy(out2_float_buffer1, in_float_buffer1, sizeof(out2_float_buffer1));
+	CL_SoundSSE::multiply_float_ramp(out2_float_buffer1, data_size - 1, 0.34f, 0.0005f);
+	check_float(out_float_buffer1, out2_float_buffer1, data_size);
+
 	memcpy(out_float_buffer1, in_float_buffer1, sizeof(out_float_buffer1));
 	set_float(out_float_buffer1, data_size, 0.34f);
 	memcpy(out2_float_buffer1, in_float_buffer1, sizeof(out2_float_buffer1));
@@ -215,6 +221,12 @@ void TestApp::do_test()
 	CL_SoundSSE::mix_one_to_one(in_float_buffer1, data_size, out2_float_buffer1, 0.34f);
 	check_float(out_float_buffer1, out2_float_buffer1, data_size);
 
+	memcpy(out_float_buffer1, in_float_buffer1, sizeof(out_float_buffer1));
+	mix_one_to_one_ramp(in_float_buffer1, data_size - 1, out_float_buffer1, 0.34f, 0.82f);
+	memcpy(out2_float_buffer1, in_float_buffer1, sizeof(out2_float_buffer1));
+	CL_SoundSSE::mix_one_to_one_ramp(in_float_buffer1, data_size - 1, out2_float_buffer1, 0.34f, 0.82f);
+	check_float(out_float_buffer1, out2_float_buffer1, data_size);
+
 	float volumes[2] = {0.34f, 0.82f};
 	memcpy(out_float_buffer1, in_float_buffer1, sizeof(out_float_buffer1));
 	memcpy(out_float_buffer2, in_float_buffer2, sizeof(out_float_buffer2));
@@ -231,6 +243,37 @@ void TestApp::do_test()
 	CL_SoundSSE::mix_many_to_one(in_float, volumes, 2, data_size, out2_float_buffer1);
 	check_float(out_float_buffer1, out2_float_buffer1, data_size);
 
+	memcpy(out_float_buffer1, in_float_buffer1, sizeof(out_float_buffer1));
+	memcpy(out_float_buffer2, in_float_buffer2, sizeof(out_float_buffer2));
+	feedback_delay(out_float_buffer1, out_float_buffer2, data_size - 1, 0.5f);
+	memcpy(out2_float_buffer1, in_float_buffer1, sizeof(out2_float_buffer1));
+	memcpy(out2_float_buffer2, in_float_buffer2, sizeof(out2_float_buffer2));
+	CL_SoundSSE::feedback_delay(out2_float_buffer1, out2_float_buffer2, data_size - 1, 0.5f);
+	check_float(out_float_buffer1, out2_float_buffer1, data_size);
+	check_float(out_float_buffer2, out2_float_buffer2, data_size);
+
+	// Resampling reads up to 8 samples around each position, so stay clear of the buffer edges
+	const int resample_size = 501;
+	const double resample_position = 8.25;
+	const double resample_step = 0.731;
+
+	resample_linear(in_float_buffer1, resample_position, resample_step, out_float_buffer1, resample_size);
+	CL_SoundSSE::resample_linear(in_float_buffer1, resample_position, resample_step, out2_float_buffer1, resample_size);
+	check_float(out_float_buffer1, out2_float_buffer1, resample_size);
+
+	resample_cubic(in_float_buffer1, resample_position, resample_step, out_float_buffer1, resample_size);
+	CL_SoundSSE::resample_cubic(in_float_buffer1, resample_position, resample_step, out2_float_buffer1, resample_size);
+	check_float(out_float_buffer1, out2_float_buffer1, resample_size);
+
+	const int taps = 16;
+	const int phases = 8;
+	float *filter = (float *) CL_SoundSSE::aligned_alloc(sizeof(float) * taps * (phases + 1));
+	for (int cnt = 0; cnt < taps * (phases + 1); cnt++)
+		filter[cnt] = in_float_buffer2[cnt] / taps;
+	resample_polyphase(in_float_buffer1, resample_position, resample_step, filter, taps, phases, out_float_buffer1, resample_size);
+	CL_SoundSSE::resample_polyphase(in_float_buffer1, resample_position, resample_step, filter, taps, phases, out2_float_buffer1, resample_size);
+	CL_SoundSSE::aligned_free(filter);
+	check_float(out_float_buffer1, out2_float_buffer1, resample_size);
 }
 
 void TestApp::check_float(float *aptr, float *bptr, int num)
@@ -351,6 +394,12 @@ void TestApp::multiply_float(float *channel, int size, float volume)
 		channel[i] *= volume;
 }
 
+void TestApp::multiply_float_ramp(float *channel, int size, float start_volume, float volume_step)
+{
+	for (int i = 0; i < size; i++)
+		channel[i] *= start_volume + i * volume_step;
+}
+
 void TestApp::set_float(float *channel, int size, float value)
 {
 	const int sse_size = 0;
@@ -369,6 +418,15 @@ void TestApp::mix_one_to_one(float *input, int size, float *output, float volume
 	}
 }
 
+void TestApp::mix_one_to_one_ramp(float *input, int size, float *output, float start_volume, float end_volume)
+{
+	float volume_step = (end_volume - start_volume) / size;
+	for (int i = 0; i < size; i++)
+	{
+		output[i] += input[i] * (start_volume + (i + 1) * volume_step);
+	}
+}
+
 void TestApp::mix_one_to_many(float *input, int size, float **output, float *volume, int channels)
 {
 	const int sse_size = 0;
@@ -398,6 +456,15 @@ void TestApp::mix_many_to_one(float **input, float *volume, int channels, int si
 	}
 }
 
+void TestApp::feedback_delay(float *channel, float *delay, int size, float feedback)
+{
+	for (int i = 0; i < size; i++)
+	{
+		delay[i] = delay[i] * feedback + channel[i];
+		channel[i] = delay[i];
+	}
+}
+
 void TestApp::unpack_float_stereo(float *input, int size, float *output[2])
 {
 	const int sse_size = 0;
@@ -417,3 +484,51 @@ void TestApp::unpack_float_mono(float *input, int size, float *output)
 	if(sse_size < size)
 		memcpy(output, input, (size-sse_size)*sizeof(float));
 }
+
+void TestApp::resample_linear(float *input, double position, double step, float *output, int size)
+{
+	for (int i = 0; i < size; i++)
+	{
+		double pos = position + i * step;
+		int index = int(pos);
+		float t = float(pos - index);
+		output[i] = input[index] * (1.0f - t) + input[index + 1] * t;
+	}
+}
+
+void TestApp::resample_cubic(float *input, double position, double step, float *output, int size)
+{
+	for (int i = 0; i < size; i++)
+	{
+		double pos = position + i * step;
+		int index = int(pos);
+		float t = float(pos - index);
+		float p0 = input[index - 1];
+		float p1 = input[index];
+		float p2 = input[index + 1];
+		float p3 = input[index + 2];
+		float a = -0.5f*p0 + 1.5f*p1 - 1.5f*p2 + 0.5f*p3;
+		float b = p0 - 2.5f*p1 + 2.0f*p2 - 0.5f*p3;
+		float c = -0.5f*p0 + 0.5f*p2;
+		output[i] = ((a * t + b) * t + c) * t + p1;
+	}
+}
+
+void TestApp::resample_polyphase(float *input, double position, double step, float *filter, int taps, int phases, float *output, int size)
+{
+	for (int i = 0; i < size; i++)
+	{
+		double pos = position + i * step;
+		int index = int(pos);
+		double phase_position = (pos - index) * phases;
+		int phase = int(phase_position);
+		float t = float(phase_position - phase);
+		float sum = 0.0f;
+		for (int j = 0; j < taps; j++)
+		{
+			float coefficient = filter[phase * taps + j] * (1.0f - t) + filter[(phase + 1) * taps + j] * t;
+			sum += coefficient * input[index - taps / 2 + 1 + j];
+		}
+		output[i] = sum;
+	}
+}
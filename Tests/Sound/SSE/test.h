@@ -50,10 +50,16 @@ private:
 	static void pack_float_stereo(float *input[2], int size, float *output);
 	static void copy_float(float *input, int size, float *output);
 	static void multiply_float(float *channel, int size, float volume);
+	static void multiply_float_ramp(float *channel, int size, float start_volume, float volume_step);
 	static void set_float(float *channel, int size, float value);
 	static void mix_one_to_one(float *input, int size, float *output, float volume);
+	static void mix_one_to_one_ramp(float *input, int size, float *output, float start_volume, float end_volume);
 	static void mix_one_to_many(float *input, int size, float **output, float *volume, int channels);
 	static void mix_many_to_one(float **input, float *volume, int channels, int size, float *output);
+	static void feedback_delay(float *channel, float *delay, int size, float feedback);
+	static void resample_linear(float *input, double position, double step, float *output, int size);
+	static void resample_cubic(float *input, double position, double step, float *output, int size);
+	static void resample_polyphase(float *input, double position, double step, float *filter, int taps, int phases, float *output, int size);
 
 	void check_16(short *aptr, short *bptr, int num);
 	void check_float(float *aptr, float *bptr, int num);